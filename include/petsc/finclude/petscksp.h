@@ -30,6 +30,7 @@
 #define KSPPIPECG 'pipecg'
 #define KSPPIPECGRR 'pipecgrr'
 #define KSPPIPELCG 'pipelcg'
+#define KSPCACG 'cacg'
 #define KSPCGNE 'cgne'
 #define KSPNASH 'nash'
 #define KSPSTCG 'stcg'
@@ -42,6 +43,7 @@
 #define KSPLGMRES 'lgmres'
 #define KSPDGMRES 'dgmres'
 #define KSPPGMRES 'pgmres'
+#define KSPCAGMRES 'cagmres'
 #define KSPTCQMR 'tcqmr'
 #define KSPBCGS 'bcgs'
 #define KSPIBCGS 'ibcgs'
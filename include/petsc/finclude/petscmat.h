@@ -113,6 +113,9 @@
 #define MATBAIJ            'baij'
 #define MATSEQBAIJ         'seqbaij'
 #define MATMPIBAIJ         'mpibaij'
+#define MATVBAIJ           'vbaij'
+#define MATSEQVBAIJ        'seqvbaij'
+#define MATMPIVBAIJ        'mpivbaij'
 #define MATMPIADJ          'mpiadj'
 #define MATSBAIJ           'sbaij'
 #define MATSEQSBAIJ        'seqsbaij'
@@ -20,6 +20,7 @@ struct _KSPOps {
                                                           calculates the residual in a
                                                           user-provided area.  */
   PetscErrorCode (*solve)(KSP);                        /* actual solver */
+  PetscErrorCode (*matsolve)(KSP,Mat,Mat);             /* solves with the columns of a dense matrix as right hand sides */
   PetscErrorCode (*setup)(KSP);
   PetscErrorCode (*setfromoptions)(PetscOptionItems*,KSP);
   PetscErrorCode (*publishoptions)(KSP);
@@ -185,6 +186,8 @@ PETSC_STATIC_INLINE PetscErrorCode KSPLogResidualHistory(KSP ksp,PetscReal norm)
 }
 
 PETSC_INTERN PetscErrorCode KSPSetUpNorms_Private(KSP,PetscBool,KSPNormType*,PCSide*);
+PETSC_INTERN PetscErrorCode KSPConvergedDefaultRHSNormBegin_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPConvergedDefaultRHSNormEnd_Private(KSP);
 
 PETSC_INTERN PetscErrorCode KSPPlotEigenContours_Private(KSP,PetscInt,const PetscReal*,const PetscReal*);
 
@@ -339,9 +342,11 @@ PETSC_EXTERN PetscLogEvent KSP_Solve_FS_S;
 PETSC_EXTERN PetscLogEvent KSP_Solve_FS_L;
 PETSC_EXTERN PetscLogEvent KSP_Solve_FS_U;
 PETSC_EXTERN PetscLogEvent KSP_SolveTranspose;
+PETSC_EXTERN PetscLogEvent KSP_MatSolve;
 
 PETSC_INTERN PetscErrorCode MatGetSchurComplement_Basic(Mat,IS,IS,IS,IS,MatReuse,Mat*,MatSchurComplementAinvType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode PCPreSolveChangeRHS(PC,PetscBool*);
+PETSC_INTERN PetscErrorCode KSPMatSolveConverged_Private(KSP,Mat,PetscInt,PetscInt,const PetscReal[],PetscReal[],KSPConvergedReason[],PetscInt*);
 
 /*MC
    KSPCheckDot - Checks if the result of a dot product used by the corresponding KSP contains Inf or NaN. These indicate that the previous 
@@ -364,6 +364,10 @@ PETSC_INTERN PetscErrorCode MatStashScatterBegin_Private(Mat,MatStash*,PetscInt*
 PETSC_INTERN PetscErrorCode MatStashScatterGetMesg_Private(MatStash*,PetscMPIInt*,PetscInt**,PetscInt**,PetscScalar**,PetscInt*);
 PETSC_INTERN PetscErrorCode MatGetInfo_External(Mat,MatInfoType,MatInfo*);
 
+/* entries set with MatSetValues() into an AIJ matrix that was not preallocated, see MatSetUpHash_Private() */
+typedef struct _n_MatHash *MatHash;
+PETSC_INTERN PetscErrorCode MatSetUpHash_Private(Mat);
+
 typedef struct {
   PetscInt   dim;
   PetscInt   dims[4];
@@ -380,6 +384,40 @@ typedef struct {
 } Mat_CompressedRow;
 PETSC_EXTERN PetscErrorCode MatCheckCompressedRow(Mat,PetscInt,Mat_CompressedRow*,PetscInt*,PetscInt,PetscReal);
 
+/* Info about using compressed column indices: each row stores its smallest column and 8 or 16 bit offsets from it */
+typedef struct {
+  PetscBool        use;                     /* indicates the compressed indices have been computed and will be used */
+  PetscInt         width;                   /* bytes per offset, 1 or 2 */
+  PetscInt         *base;                   /* smallest column of each row */
+  unsigned char    *j8;                     /* offsets from base, stored like the column indices, when width is 1 */
+  unsigned short   *j16;                    /* offsets from base when width is 2 */
+  PetscInt         saved;                   /* bytes fewer read by MatMult() than with the column indices */
+} Mat_CompressedIndices;
+PETSC_EXTERN PetscErrorCode MatCheckCompressedIndices(Mat,Mat_CompressedIndices*,const PetscInt*,const PetscInt*,PetscInt);
+PETSC_EXTERN PetscErrorCode MatDestroyCompressedIndices(Mat_CompressedIndices*);
+
+/* Info about level scheduled triangular solves: the rows of each sweep of MatSolve() of a factor are grouped in levels
+   whose rows only depend on rows of earlier levels, and stored in level order with a copy of their entries */
+typedef struct {
+  PetscBool        use;                     /* indicates the levels have been computed and will be used */
+  PetscInt         nthreads;                /* number of OpenMP threads sharing the rows of each level */
+  PetscInt         nrows[2];                /* number of rows of the forward (0) and backward (1) sweeps */
+  PetscInt         nlevels[2];              /* number of levels of each sweep */
+  PetscInt         *level[2];               /* level l of sweep s is rows level[s][l] to level[s][l+1]-1 of the level ordering */
+  PetscInt         *row[2];                 /* row of the factor of each row of the level ordering */
+  PetscInt         *i[2];                   /* entries of the rows of the level ordering, the inverse of the diagonal last if diag[s] */
+  PetscInt         *j[2];
+  MatScalar        *a[2];
+  PetscInt         *pos[2];                 /* position of each entry in the values of the factor */
+  PetscBool        diag[2];                 /* the rows end with the inverse of their diagonal entry */
+  PetscBool        negate[2];               /* a[] holds the negated values of the factor */
+} Mat_SolveLevels;
+PETSC_EXTERN PetscErrorCode MatSolveLevelsSetUp(Mat,Mat_SolveLevels*,PetscInt,PetscInt,const PetscInt*,const PetscInt*,const PetscInt*,const PetscInt*,PetscBool,PetscBool);
+PETSC_EXTERN PetscErrorCode MatSolveLevelsSetValues(Mat_SolveLevels*,const MatScalar*);
+PETSC_EXTERN PetscErrorCode MatSolveLevelsSweep(Mat_SolveLevels*,PetscInt,PetscScalar*);
+PETSC_EXTERN PetscErrorCode MatSolveLevelsView(Mat_SolveLevels*,PetscViewer);
+PETSC_EXTERN PetscErrorCode MatDestroySolveLevels(Mat_SolveLevels*);
+
 typedef struct { /* used by MatCreateRedundantMatrix() for reusing matredundant */
   PetscInt     nzlocal,nsends,nrecvs;
   PetscMPIInt  *send_rank,*recv_rank;
@@ -412,6 +450,7 @@ struct _p_Mat {
   MatInfo                info;             /* matrix information */
   InsertMode             insertmode;       /* have values been inserted in matrix or added? */
   MatStash               stash,bstash;     /* used for assembling off-proc mat emements */
+  MatHash                hash;             /* collects the entries until the first final assembly computes the preallocation */
   MatNullSpace           nullsp;           /* null space (operator is singular) */
   MatNullSpace           transnullsp;      /* null space of transpose of operator */
   MatNullSpace           nearnullsp;       /* near null space to be used by multigrid methods */
@@ -1668,6 +1707,8 @@ PETSC_EXTERN PetscLogEvent MAT_MultAdd;
 PETSC_EXTERN PetscLogEvent MAT_MultTranspose;
 PETSC_EXTERN PetscLogEvent MAT_MultTransposeConstrained;
 PETSC_EXTERN PetscLogEvent MAT_MultTransposeAdd;
+PETSC_EXTERN PetscLogEvent MAT_MultHaloWait;
+PETSC_EXTERN PetscLogEvent MAT_MultOffDiag;
 PETSC_EXTERN PetscLogEvent MAT_Solve;
 PETSC_EXTERN PetscLogEvent MAT_Solves;
 PETSC_EXTERN PetscLogEvent MAT_SolveAdd;
@@ -1722,6 +1763,8 @@ PETSC_EXTERN PetscLogEvent MAT_GetBrowsOfAcols;
 PETSC_EXTERN PetscLogEvent MAT_GetBrowsOfAocols;
 PETSC_EXTERN PetscLogEvent MAT_PtAPSymbolic;
 PETSC_EXTERN PetscLogEvent MAT_PtAPNumeric;
+PETSC_EXTERN PetscLogEvent MAT_PtAPNumericComm;
+PETSC_EXTERN PetscLogEvent MAT_PtAPNumericLocal;
 PETSC_EXTERN PetscLogEvent MAT_Seqstompinum;
 PETSC_EXTERN PetscLogEvent MAT_Seqstompisym;
 PETSC_EXTERN PetscLogEvent MAT_Seqstompi;
@@ -1744,6 +1787,8 @@ PETSC_EXTERN PetscLogEvent MATMFFD_Mult;
 PETSC_EXTERN PetscLogEvent MAT_GetMultiProcBlock;
 PETSC_EXTERN PetscLogEvent MAT_CUSPARSECopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_SetValuesBatch;
+PETSC_EXTERN PetscLogEvent MAT_PreallCOO;
+PETSC_EXTERN PetscLogEvent MAT_SetVCOO;
 PETSC_EXTERN PetscLogEvent MAT_ViennaCLCopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_DenseCopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_DenseCopyFromGPU;
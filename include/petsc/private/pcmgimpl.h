@@ -31,6 +31,8 @@ typedef struct {
   PetscLogEvent eventsmoothsolve;
   PetscLogEvent eventresidual;
   PetscLogEvent eventinterprestrict;
+  Mat           B,X,R;                         /* right hand sides, solutions and residuals of PCMatApply() */
+  Mat           AX,IX;                         /* products of X by A and of the coarser X by the interpolation */
 } PC_MG_Levels;
 
 /*
@@ -941,6 +941,11 @@ PETSC_EXTERN PetscLogEvent PETSC_BuildTwoSided;
 PETSC_EXTERN PetscLogEvent PETSC_BuildTwoSidedF;
 PETSC_EXTERN PetscBool     use_gpu_aware_mpi;
 
+PETSC_EXTERN PetscErrorCode PetscMallocViewAddFunction_Private(PetscErrorCode (*)(FILE*,PetscMPIInt));
+PETSC_INTERN PetscErrorCode PetscMallocHugePageView_Private(FILE*,PetscMPIInt);
+PETSC_INTERN PetscErrorCode PetscMallocPoolView_Private(FILE*,PetscMPIInt);
+PETSC_INTERN PetscErrorCode PetscMallocSetDebugBase_Private(PetscErrorCode (*)(size_t,PetscBool,int,const char[],const char[],void**),PetscErrorCode (*)(void*,int,const char[],const char[]),PetscErrorCode (*)(size_t,int,const char[],const char[],void**));
+
 #if defined(PETSC_HAVE_ADIOS)
 PETSC_EXTERN int64_t Petsc_adios_group;
 #endif
@@ -44,6 +44,10 @@ struct _PetscSFOps {
   PetscErrorCode (*FetchAndOpBegin)(PetscSF,MPI_Datatype,PetscMemType,void*,PetscMemType,const void*,void*,MPI_Op);
   PetscErrorCode (*FetchAndOpEnd)  (PetscSF,MPI_Datatype,void*,const void*,void*,MPI_Op);
   PetscErrorCode (*BcastToZero)    (PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,      void*); /* For interal use only */
+  PetscErrorCode (*BcastAndOpBeginMultiple)(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op); /* Several host arrays at once, optional */
+  PetscErrorCode (*BcastAndOpEndMultiple)  (PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+  PetscErrorCode (*ReduceBeginMultiple)    (PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
+  PetscErrorCode (*ReduceEndMultiple)      (PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op);
   PetscErrorCode (*GetRootRanks)(PetscSF,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**,const PetscInt**);
   PetscErrorCode (*GetLeafRanks)(PetscSF,PetscInt*,const PetscMPIInt**,const PetscInt**,const PetscInt**);
   PetscErrorCode (*CreateLocalSF)(PetscSF,PetscSF*);
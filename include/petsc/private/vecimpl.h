@@ -96,6 +96,10 @@ struct _VecOps {
   PetscErrorCode (*bindtocpu)(Vec,PetscBool);
   PetscErrorCode (*getarraywrite)(Vec,PetscScalar**);
   PetscErrorCode (*restorearraywrite)(Vec,PetscScalar**);
+  PetscErrorCode (*axpynorm)(Vec,PetscScalar,Vec,PetscReal*);
+  PetscErrorCode (*maxpynorm)(Vec,PetscInt,const PetscScalar*,Vec*,PetscReal*);
+  PetscErrorCode (*maxpymdot)(Vec,PetscInt,const PetscScalar*,Vec*,PetscScalar*);
+  PetscErrorCode (*waxpydot)(Vec,PetscScalar,Vec,Vec,Vec,PetscScalar*,PetscReal*);
 };
 
 /*
@@ -166,6 +170,10 @@ PETSC_EXTERN PetscLogEvent VEC_AXPY;
 PETSC_EXTERN PetscLogEvent VEC_AYPX;
 PETSC_EXTERN PetscLogEvent VEC_WAXPY;
 PETSC_EXTERN PetscLogEvent VEC_MAXPY;
+PETSC_EXTERN PetscLogEvent VEC_AXPYNorm;
+PETSC_EXTERN PetscLogEvent VEC_MAXPYNorm;
+PETSC_EXTERN PetscLogEvent VEC_MAXPYMDot;
+PETSC_EXTERN PetscLogEvent VEC_WAXPYDot;
 PETSC_EXTERN PetscLogEvent VEC_AssemblyEnd;
 PETSC_EXTERN PetscLogEvent VEC_PointwiseMult;
 PETSC_EXTERN PetscLogEvent VEC_SetValues;
@@ -224,6 +232,12 @@ PETSC_EXTERN PetscErrorCode VecLoad_Default(Vec, PetscViewer);
 
 PETSC_EXTERN PetscInt  NormIds[7];  /* map from NormType to IDs used to cache/retreive values of norms */
 
+PETSC_INTERN PetscBool VecMDotUseGEMV;   /* -vec_mdot_use_gemv, read by VecInitializePackage() and VecSetFromOptions() */
+PETSC_INTERN PetscBool VecMAXPYUseGEMV;  /* -vec_maxpy_use_gemv */
+
+PETSC_INTERN PetscErrorCode VecPoolPush_Private(Vec,PetscBool*);
+PETSC_INTERN PetscErrorCode VecPoolPop_Private(Vec,Vec*,PetscBool*);
+
 PETSC_INTERN PetscErrorCode VecStashCreate_Private(MPI_Comm,PetscInt,VecStash*);
 PETSC_INTERN PetscErrorCode VecStashDestroy_Private(VecStash*);
 PETSC_EXTERN PetscErrorCode VecStashExpand_Private(VecStash*,PetscInt);
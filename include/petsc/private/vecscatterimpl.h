@@ -293,6 +293,8 @@ typedef struct _VecScatterOps *VecScatterOps;
 struct _VecScatterOps {
   PetscErrorCode (*begin)(VecScatter,Vec,Vec,InsertMode,ScatterMode);
   PetscErrorCode (*end)(VecScatter,Vec,Vec,InsertMode,ScatterMode);
+  PetscErrorCode (*beginmultiple)(VecScatter,PetscInt,Vec*,Vec*,InsertMode,ScatterMode); /* optional, the same scatter on several pairs of vectors */
+  PetscErrorCode (*endmultiple)(VecScatter,PetscInt,Vec*,Vec*,InsertMode,ScatterMode);
   PetscErrorCode (*copy)(VecScatter,VecScatter);
   PetscErrorCode (*destroy)(VecScatter);
   PetscErrorCode (*setup)(VecScatter);
@@ -37,6 +37,7 @@ typedef const char* KSPType;
 #define KSPPIPECGRR   "pipecgrr"
 #define KSPPIPELCG     "pipelcg"
 #define KSPPIPEPRCG    "pipeprcg"
+#define KSPCACG       "cacg"
 #define   KSPCGNE       "cgne"
 #define   KSPNASH       "nash"
 #define   KSPSTCG       "stcg"
@@ -52,6 +53,7 @@ typedef const char* KSPType;
 #define   KSPLGMRES     "lgmres"
 #define   KSPDGMRES     "dgmres"
 #define   KSPPGMRES     "pgmres"
+#define   KSPCAGMRES    "cagmres"
 #define KSPTCQMR      "tcqmr"
 #define KSPBCGS       "bcgs"
 #define   KSPIBCGS      "ibcgs"
@@ -90,6 +92,7 @@ PETSC_EXTERN PetscErrorCode KSPSetUp(KSP);
 PETSC_EXTERN PetscErrorCode KSPSetUpOnBlocks(KSP);
 PETSC_EXTERN PetscErrorCode KSPSolve(KSP,Vec,Vec);
 PETSC_EXTERN PetscErrorCode KSPSolveTranspose(KSP,Vec,Vec);
+PETSC_EXTERN PetscErrorCode KSPMatSolve(KSP,Mat,Mat);
 PETSC_EXTERN PetscErrorCode KSPReset(KSP);
 PETSC_EXTERN PetscErrorCode KSPResetViewers(KSP);
 PETSC_EXTERN PetscErrorCode KSPDestroy(KSP*);
@@ -214,12 +217,16 @@ PETSC_EXTERN PetscErrorCode KSPGMRESSetOrthogonalization(KSP,PetscErrorCode (*)(
 PETSC_EXTERN PetscErrorCode KSPGMRESGetOrthogonalization(KSP,PetscErrorCode (**)(KSP,PetscInt));
 PETSC_EXTERN PetscErrorCode KSPGMRESModifiedGramSchmidtOrthogonalization(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization(KSP,PetscInt);
 
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetAugDim(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetConstant(KSP);
 
 PETSC_EXTERN PetscErrorCode KSPPIPEFGMRESSetShift(KSP,PetscScalar);
 
+PETSC_EXTERN PetscErrorCode KSPCAGMRESSetSteps(KSP,PetscInt);
+
 PETSC_EXTERN PetscErrorCode KSPGCRSetRestart(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPGCRGetRestart(KSP,PetscInt*);
 PETSC_EXTERN PetscErrorCode KSPGCRSetModifyPC(KSP,PetscErrorCode (*)(KSP,PetscInt,PetscReal,void*),void*,PetscErrorCode(*)(void*));
@@ -639,6 +646,7 @@ PETSC_EXTERN const char *const KSPCGTypes[];
 
 PETSC_EXTERN PetscErrorCode KSPCGSetType(KSP,KSPCGType);
 PETSC_EXTERN PetscErrorCode KSPCGUseSingleReduction(KSP,PetscBool );
+PETSC_EXTERN PetscErrorCode KSPCACGSetSteps(KSP,PetscInt);
 
 PETSC_EXTERN PetscErrorCode KSPCGSetRadius(KSP,PetscReal);
 PETSC_EXTERN PetscErrorCode KSPCGGetNormD(KSP,PetscReal*);
@@ -44,6 +44,7 @@ PETSC_EXTERN PetscErrorCode PCGetFailedReason(PC,PCFailedReason*);
 PETSC_DEPRECATED_FUNCTION("Use PCGetFailedReason() (since version 3.11)") PETSC_STATIC_INLINE PetscErrorCode PCGetSetUpFailedReason(PC pc,PCFailedReason *reason) {return PCGetFailedReason(pc,reason);}
 PETSC_EXTERN PetscErrorCode PCSetUpOnBlocks(PC);
 PETSC_EXTERN PetscErrorCode PCApply(PC,Vec,Vec);
+PETSC_EXTERN PetscErrorCode PCMatApply(PC,Mat,Mat);
 PETSC_EXTERN PetscErrorCode PCApplySymmetricLeft(PC,Vec,Vec);
 PETSC_EXTERN PetscErrorCode PCApplySymmetricRight(PC,Vec,Vec);
 PETSC_EXTERN PetscErrorCode PCApplyBAorAB(PC,PCSide,Vec,Vec,Vec);
@@ -171,6 +172,7 @@ PETSC_EXTERN PetscErrorCode PCFactorSetPivotInBlocks(PC,PetscBool);
 PETSC_EXTERN PetscErrorCode PCFactorSetLevels(PC,PetscInt);
 PETSC_EXTERN PetscErrorCode PCFactorGetLevels(PC,PetscInt*);
 PETSC_EXTERN PetscErrorCode PCFactorSetDropTolerance(PC,PetscReal,PetscReal,PetscInt);
+PETSC_EXTERN PetscErrorCode PCFactorSetILUIterative(PC,PetscBool,PetscInt,PetscInt);
 PETSC_EXTERN PetscErrorCode PCFactorGetZeroPivot(PC,PetscReal*);
 PETSC_EXTERN PetscErrorCode PCFactorGetShiftAmount(PC,PetscReal*);
 PETSC_EXTERN PetscErrorCode PCFactorGetShiftType(PC,MatFactorShiftType*);
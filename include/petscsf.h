@@ -25,6 +25,7 @@ typedef const char *PetscSFType;
 #define PETSCSFGATHER     "gather"
 #define PETSCSFALLTOALL   "alltoall"
 #define PETSCSFWINDOW     "window"
+#define PETSCSFHIERARCHICAL "hierarchical"
 
 /*E
    PetscSFPattern - Pattern of the PetscSF graph
@@ -130,6 +131,11 @@ PETSC_EXTERN PetscErrorCode PetscSFReduceBegin(PetscSF,MPI_Datatype,const void*,
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
 PETSC_EXTERN PetscErrorCode PetscSFReduceEnd(PetscSF,MPI_Datatype,const void*,void*,MPI_Op)
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2);
+/* The same on several arrays at once, with one message per neighbor */
+PETSC_EXTERN PetscErrorCode PetscSFBcastAndOpBeginMultiple(PetscSF,MPI_Datatype,PetscInt,const void*const[],void*const[],MPI_Op);
+PETSC_EXTERN PetscErrorCode PetscSFBcastAndOpEndMultiple(PetscSF,MPI_Datatype,PetscInt,const void*const[],void*const[],MPI_Op);
+PETSC_EXTERN PetscErrorCode PetscSFReduceBeginMultiple(PetscSF,MPI_Datatype,PetscInt,const void*const[],void*const[],MPI_Op);
+PETSC_EXTERN PetscErrorCode PetscSFReduceEndMultiple(PetscSF,MPI_Datatype,PetscInt,const void*const[],void*const[],MPI_Op);
 /* Atomically modifies (using provided operation) rootdata using leafdata from each leaf, value at root at time of modification is returned in leafupdate. */
 PETSC_EXTERN PetscErrorCode PetscSFFetchAndOpBegin(PetscSF,MPI_Datatype,void*,const void*,void*,MPI_Op)
   PetscAttrMPIPointerWithType(3,2) PetscAttrMPIPointerWithType(4,2) PetscAttrMPIPointerWithType(5,2);
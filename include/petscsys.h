@@ -1207,6 +1207,24 @@ PETSC_EXTERN PetscErrorCode PetscMallocClear(void);
 */
 PETSC_EXTERN PetscErrorCode PetscMallocSetDRAM(void);
 PETSC_EXTERN PetscErrorCode PetscMallocResetDRAM(void);
+
+/*E
+    PetscMallocHugePageType - How PetscMalloc() maps the large arrays allocated between PetscMallocPushHugePage() and PetscMallocPopHugePage()
+
+    Level: developer
+
+.seealso: PetscMallocSetHugePage()
+E*/
+typedef enum {PETSC_MALLOC_HUGEPAGE_NONE,PETSC_MALLOC_HUGEPAGE_THP,PETSC_MALLOC_HUGEPAGE_HUGETLB} PetscMallocHugePageType;
+PETSC_EXTERN const char *const PetscMallocHugePageTypes[];
+PETSC_EXTERN PetscErrorCode PetscMallocSetHugePage(PetscMallocHugePageType,size_t);
+PETSC_EXTERN PetscErrorCode PetscMallocPushHugePage(void);
+PETSC_EXTERN PetscErrorCode PetscMallocPopHugePage(void);
+PETSC_EXTERN PetscErrorCode PetscMallocPool(size_t,PetscBool,int,const char[],const char[],void**);
+PETSC_EXTERN PetscErrorCode PetscFreePool(void*,int,const char[],const char[]);
+PETSC_EXTERN PetscErrorCode PetscReallocPool(size_t,int,const char[],const char[],void**);
+PETSC_EXTERN PetscErrorCode PetscMallocSetPool(size_t);
+PETSC_EXTERN PetscErrorCode PetscMallocPoolTrim(void);
 #if defined(PETSC_HAVE_CUDA)
 PETSC_EXTERN PetscErrorCode PetscMallocSetCUDAHost(void);
 PETSC_EXTERN PetscErrorCode PetscMallocResetCUDAHost(void);
@@ -248,6 +248,10 @@ PETSC_EXTERN PetscErrorCode VecSwap(Vec,Vec);
 PETSC_EXTERN PetscErrorCode VecAXPY(Vec,PetscScalar,Vec);
 PETSC_EXTERN PetscErrorCode VecAXPBY(Vec,PetscScalar,PetscScalar,Vec);
 PETSC_EXTERN PetscErrorCode VecMAXPY(Vec,PetscInt,const PetscScalar[],Vec[]);
+PETSC_EXTERN PetscErrorCode VecMAXPYNorm(Vec,PetscInt,const PetscScalar[],Vec[],PetscReal*);
+PETSC_EXTERN PetscErrorCode VecMAXPYMDot(Vec,PetscInt,const PetscScalar[],Vec[],PetscScalar[]);
+PETSC_EXTERN PetscErrorCode VecAXPYNorm(Vec,PetscScalar,Vec,PetscReal*);
+PETSC_EXTERN PetscErrorCode VecWAXPYDot(Vec,PetscScalar,Vec,Vec,Vec,PetscScalar*,PetscReal*);
 PETSC_EXTERN PetscErrorCode VecAYPX(Vec,PetscScalar,Vec);
 PETSC_EXTERN PetscErrorCode VecWAXPY(Vec,PetscScalar,Vec,Vec);
 PETSC_EXTERN PetscErrorCode VecAXPBYPCZ(Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec);
@@ -267,6 +271,8 @@ PETSC_EXTERN PetscErrorCode VecAbs(Vec);
 PETSC_EXTERN PetscErrorCode VecDuplicate(Vec,Vec*);
 PETSC_EXTERN PetscErrorCode VecDuplicateVecs(Vec,PetscInt,Vec*[]);
 PETSC_EXTERN PetscErrorCode VecDestroyVecs(PetscInt, Vec*[]);
+PETSC_EXTERN PetscErrorCode VecPoolSetMaximum(PetscInt);
+PETSC_EXTERN PetscErrorCode VecPoolClear(void);
 PETSC_EXTERN PetscErrorCode VecStrideNormAll(Vec,NormType,PetscReal[]);
 PETSC_EXTERN PetscErrorCode VecStrideMaxAll(Vec,PetscInt [],PetscReal []);
 PETSC_EXTERN PetscErrorCode VecStrideMinAll(Vec,PetscInt [],PetscReal []);
@@ -340,6 +346,8 @@ PETSC_EXTERN PetscErrorCode VecRegister(const char[],PetscErrorCode (*)(Vec));
 
 PETSC_EXTERN PetscErrorCode VecScatterBegin(VecScatter,Vec,Vec,InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecScatterEnd(VecScatter,Vec,Vec,InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecScatterBeginMultiple(VecScatter,PetscInt,Vec[],Vec[],InsertMode,ScatterMode);
+PETSC_EXTERN PetscErrorCode VecScatterEndMultiple(VecScatter,PetscInt,Vec[],Vec[],InsertMode,ScatterMode);
 PETSC_EXTERN PetscErrorCode VecScatterDestroy(VecScatter*);
 PETSC_EXTERN PetscErrorCode VecScatterSetUp(VecScatter);
 PETSC_EXTERN PetscErrorCode VecScatterCopy(VecScatter,VecScatter *);
@@ -453,6 +461,13 @@ PETSC_EXTERN PetscErrorCode VecMDotEnd(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode VecMTDotBegin(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode VecMTDotEnd(Vec,PetscInt,const Vec[],PetscScalar[]);
 PETSC_EXTERN PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionProgress(MPI_Comm,PetscBool*);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionSumBegin(MPI_Comm,PetscInt,const PetscScalar[]);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionSumEnd(MPI_Comm,PetscInt,PetscScalar[]);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionMaxBegin(MPI_Comm,PetscInt,const PetscReal[]);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionMaxEnd(MPI_Comm,PetscInt,PetscReal[]);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionMinBegin(MPI_Comm,PetscInt,const PetscReal[]);
+PETSC_EXTERN PetscErrorCode PetscCommSplitReductionMinEnd(MPI_Comm,PetscInt,PetscReal[]);
 
 PETSC_EXTERN PetscErrorCode VecBindToCPU(Vec,PetscBool);
 PETSC_DEPRECATED_FUNCTION("Use VecBindToCPU (since v3.13)") PETSC_STATIC_INLINE PetscErrorCode VecPinToCPU(Vec v,PetscBool flg) {return VecBindToCPU(v,flg);}
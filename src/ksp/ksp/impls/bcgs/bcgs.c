@@ -25,7 +25,7 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 {
   PetscErrorCode ierr;
   PetscInt       i;
-  PetscScalar    rho,rhoold,alpha,beta,omega,omegaold,d1;
+  PetscScalar    rho,rhonext = 0.0,rhoold,alpha,beta,omega,omegaold,d1;
   Vec            X,B,V,P,R,RP,T,S;
   PetscReal      dp    = 0.0,d2;
   KSP_BCGS       *bcgs = (KSP_BCGS*)ksp->data;
@@ -82,7 +82,10 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 
   i=0;
   do {
-    ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);       /*   rho <- (r,rp)      */
+    if (i) rho = rhonext;                         /*   computed with the update of r */
+    else {
+      ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);     /*   rho <- (r,rp)      */
+    }
     beta = (rho/rhoold) * (alpha/omegaold);
     ierr = VecAXPBYPCZ(P,1.0,-omegaold*beta,beta,R,V);CHKERRQ(ierr);  /* p <- r - omega * beta* v + beta * p */
     ierr = KSP_PCApplyBAorAB(ksp,P,V,T);CHKERRQ(ierr);  /*   v <- K p           */
@@ -119,10 +122,12 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     }
     omega = d1 / d2;                               /*   w <- (t's) / (t't) */
     ierr  = VecAXPBYPCZ(X,alpha,omega,1.0,P,S);CHKERRQ(ierr); /* x <- alpha * p + omega * s + x */
-    ierr  = VecWAXPY(R,-omega,T,S);CHKERRQ(ierr);     /*   r <- s - w t       */
+    /* r <- s - w t, with (r,rp) for the next iteration and the norm of r in the same reduction */
     if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+      ierr = VecWAXPYDot(R,-omega,T,S,RP,&rhonext,&dp);CHKERRQ(ierr);
       KSPCheckNorm(ksp,dp);
+    } else {
+      ierr = VecWAXPYDot(R,-omega,T,S,RP,&rhonext,NULL);CHKERRQ(ierr);
     }
 
     rhoold   = rho;
@@ -0,0 +1,565 @@
+/*
+    This file implements CA-CG (a communication-avoiding s-step preconditioned conjugate gradient method)
+
+    Each outer iteration computes the 2s+1 vectors Y = [p, ..., (MA)^s p, z, ..., (MA)^{s-1} z] of a basis of the Krylov
+    spaces of the search direction p and of the preconditioned residual z, together with Yt = M^{-1} Y, and the Gram
+    matrix Yt^H Y with a single reduction. The next s iterations of CG then only update the coefficients of x, r, z and p
+    in this basis, their inner products being computed with the Gram matrix.
+*/
+#include <petsc/private/kspimpl.h>          /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+#define CACG_DEFAULT_S 4
+
+typedef struct {
+  PetscInt    s;                 /* number of iterations of each outer iteration */
+  PetscBool   newton;            /* use the Newton basis once Ritz values are available, otherwise the monomial basis */
+  PetscBool   monitorbasis;      /* print the estimated condition number of the basis of each outer iteration */
+  PetscReal   condtol;           /* use fewer iterations of an outer iteration if the estimated condition number of its basis is larger */
+  PetscInt    nshifts;           /* number of Leja ordered Ritz values, 0 until they are computed */
+  PetscInt    nlanczos;          /* number of CG coefficients collected for the shifts */
+  PetscReal   *shift;            /* the shifts of the Newton basis */
+  Vec         *Y,*Yt,*spare;     /* the basis, its image by the inverse of the preconditioner and the next p, pt, z and r */
+  PetscScalar *G,*N,*B,*R;       /* the Gram matrix Yt^H Y, the Gram matrix of the norm, the change of basis matrix, and a work matrix */
+  PetscScalar *pc,*rc,*ec,*bp;   /* the coefficients of p, r and of the update of x in the basis, and B pc */
+  PetscReal   *d,*e,*work;       /* the Lanczos tridiagonal matrix of the first s iterations */
+} KSP_CACG;
+
+/*
+     KSPSetUp_CACG - Sets up the workspace needed by the CACG method.
+
+      This is called once, usually automatically by KSPSolve() or KSPSetUp()
+     but can be called directly by KSPSetUp()
+*/
+static PetscErrorCode KSPSetUp_CACG(KSP ksp)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscInt       n = 2*cacg->s+1,i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* get work vectors needed by CACG, the basis and its image by the inverse of the preconditioner and 4 more */
+  ierr = KSPSetWorkVecs(ksp,2*n+4);CHKERRQ(ierr);
+  ierr = PetscFree3(cacg->Y,cacg->Yt,cacg->spare);CHKERRQ(ierr);
+  ierr = PetscFree4(cacg->G,cacg->N,cacg->B,cacg->R);CHKERRQ(ierr);
+  ierr = PetscFree4(cacg->pc,cacg->rc,cacg->ec,cacg->bp);CHKERRQ(ierr);
+  ierr = PetscFree4(cacg->shift,cacg->d,cacg->e,cacg->work);CHKERRQ(ierr);
+  ierr = PetscMalloc3(n,&cacg->Y,n,&cacg->Yt,4,&cacg->spare);CHKERRQ(ierr);
+  ierr = PetscMalloc4(n*n,&cacg->G,n*n,&cacg->N,n*n,&cacg->B,n*n,&cacg->R);CHKERRQ(ierr);
+  ierr = PetscMalloc4(n,&cacg->pc,n,&cacg->rc,n,&cacg->ec,n,&cacg->bp);CHKERRQ(ierr);
+  ierr = PetscMalloc4(cacg->s,&cacg->shift,cacg->s,&cacg->d,cacg->s,&cacg->e,n,&cacg->work);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(2*n+4)*sizeof(Vec)+(4*n*n+4*n)*sizeof(PetscScalar)+(3*cacg->s+n)*sizeof(PetscReal));CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    cacg->Y[i]  = ksp->work[i];
+    cacg->Yt[i] = ksp->work[n+i];
+  }
+  for (i=0; i<4; i++) cacg->spare[i] = ksp->work[2*n+i];
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCACGComputeShifts - Computes the shifts of the Newton basis, the Ritz values of the Lanczos tridiagonal matrix of the
+    first s iterations built from their CG coefficients alpha (in d) and beta (in e), in modified Leja order: the first
+    shift is the Ritz value of largest magnitude, each following one maximizes the product of its distances to the shifts
+    already taken.
+*/
+static PetscErrorCode KSPCACGComputeShifts(KSP ksp,PetscInt n)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,best;
+  PetscReal      *ritz = cacg->work,*off = cacg->work+n,logcap,bestcap = 0.0,tmp;
+  PetscBLASInt   bn,one = 1,info;
+
+  PetscFunctionBegin;
+  for (k=0; k<n; k++) {
+    ritz[k] = 1.0/cacg->d[k] + (k ? cacg->e[k-1]/cacg->d[k-1] : 0.0);
+    off[k]  = PetscSqrtReal(PetscAbsReal(cacg->e[k]))/cacg->d[k];
+  }
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKsteqr",LAPACKREALsteqr_("N",&bn,ritz,off,NULL,&one,NULL,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+  for (k=0; k<n; k++) {
+    best = k;
+    for (i=k; i<n; i++) {
+      if (!k) logcap = PetscLogReal(PetscAbsReal(ritz[i]));
+      else {
+        logcap = 0.0;
+        for (j=0; j<k; j++) logcap += PetscLogReal(PetscAbsReal(ritz[i] - cacg->shift[j]));
+      }
+      if (i == k || logcap > bestcap) {best = i; bestcap = logcap;}
+    }
+    cacg->shift[k] = ritz[best];
+    tmp            = ritz[best];
+    ritz[best]     = ritz[k];
+    ritz[k]        = tmp;
+  }
+  cacg->nshifts = n;
+  ierr = PetscInfo2(ksp,"Computed %D shifts for the Newton basis, the largest %g\n",n,(double)cacg->shift[0]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCACGBasisCondition - Estimates the condition number of the part of the basis used by m iterations, the vectors
+    p, ..., (MA)^m p and z, ..., (MA)^{m-1} z, from the Cholesky factor of their equilibrated Gram matrix, as the ratio of its
+    largest to its smallest diagonal entry. When z = p only the first block is used. Returns PETSC_MAX_REAL if the vectors
+    are numerically linearly dependent.
+*/
+static PetscErrorCode KSPCACGBasisCondition(KSP ksp,PetscInt m,PetscBool zisp,PetscReal *cond)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscInt       s = cacg->s,n = 2*s+1,nb = zisp ? m+1 : 2*m+1,r,c,cr,cc;
+  PetscScalar    *R = cacg->R;
+  PetscReal      dmin = 1.0,dmax = 1.0,*scale = cacg->work;
+  PetscBLASInt   bn,info = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *cond = PETSC_MAX_REAL;
+  /* column c of the part of the basis is column c of the first block for c <= m, and of the second block otherwise */
+  for (c=0; c<nb; c++) {
+    cc       = c <= m ? c : s+c-m;
+    scale[c] = PetscSqrtReal(PetscAbsScalar(cacg->G[cc*n+cc]));
+    if (scale[c] == 0.0) PetscFunctionReturn(0);
+  }
+  for (c=0; c<nb; c++) {
+    cc = c <= m ? c : s+c-m;
+    for (r=0; r<=c; r++) {
+      cr        = r <= m ? r : s+r-m;
+      R[c*nb+r] = cacg->G[cc*n+cr]/(scale[r]*scale[c]);
+    }
+  }
+  ierr = PetscBLASIntCast(nb,&bn);CHKERRQ(ierr);
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bn,R,&bn,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+  if (info) PetscFunctionReturn(0);
+  for (c=0; c<nb; c++) {
+    dmin = PetscMin(dmin,PetscAbsScalar(R[c*nb+c]));
+    dmax = PetscMax(dmax,PetscAbsScalar(R[c*nb+c]));
+  }
+  *cond = dmax/dmin;
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCACGMonitorBasis - Prints the estimated condition number of the part of the basis used by the ns iterations of an outer iteration
+*/
+static PetscErrorCode KSPCACGMonitorBasis(KSP ksp,PetscInt ns,PetscReal cond)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscViewer    viewer = PETSC_VIEWER_STDOUT_(PetscObjectComm((PetscObject)ksp));
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscViewerASCIIAddTab(viewer,((PetscObject)ksp)->tablevel);CHKERRQ(ierr);
+  if (cond == PETSC_MAX_REAL) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  CA-CG %s basis from iteration %D: numerically rank deficient",cacg->nshifts ? "Newton" : "monomial",ksp->its);CHKERRQ(ierr);
+  } else {
+    ierr = PetscViewerASCIIPrintf(viewer,"  CA-CG %s basis from iteration %D: estimated condition number %.1e",cacg->nshifts ? "Newton" : "monomial",ksp->its,(double)cond);CHKERRQ(ierr);
+  }
+  ierr = PetscViewerASCIIUseTabs(viewer,PETSC_FALSE);CHKERRQ(ierr);
+  if (ns < cacg->s) {ierr = PetscViewerASCIIPrintf(viewer,", %D of %D iterations",ns,cacg->s);CHKERRQ(ierr);}
+  ierr = PetscViewerASCIIPrintf(viewer,"\n");CHKERRQ(ierr);
+  ierr = PetscViewerASCIIUseTabs(viewer,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = PetscViewerASCIISubtractTab(viewer,((PetscObject)ksp)->tablevel);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* the inner product x^H G y of coefficient vectors, with G stored by columns */
+PETSC_STATIC_INLINE PetscScalar KSPCACGDot_Private(PetscInt n,const PetscScalar *G,const PetscScalar *x,const PetscScalar *y)
+{
+  PetscScalar sum = 0.0,t;
+  PetscInt    r,c;
+
+  for (c=0; c<n; c++) {
+    t = 0.0;
+    for (r=0; r<n; r++) t += PetscConj(x[r])*G[c*n+r];
+    sum += t*y[c];
+  }
+  return sum;
+}
+
+/*
+ KSPSolve_CACG - This routine actually applies the communication-avoiding conjugate gradient method
+
+ Input Parameter:
+ .     ksp - the Krylov space object that was set to use conjugate gradient, by, for
+             example, KSPCreate(MPI_Comm,KSP *ksp); KSPSetType(ksp,KSPCACG);
+*/
+static PetscErrorCode KSPSolve_CACG(KSP ksp)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       s = cacg->s,n = 2*s+1,i,j,k,ns;
+  PetscScalar    alpha,beta,gamma,gammanew,delta,*G = cacg->G,*N = cacg->N,*B = cacg->B;
+  PetscScalar    *pc = cacg->pc,*rc = cacg->rc,*ec = cacg->ec,*bp = cacg->bp;
+  PetscReal      dp = 0.0,theta,gamma0 = 0.0,tdp = 0.0,cond;
+  Vec            X,Bv,*Y = cacg->Y,*Yt = cacg->Yt,*spare = cacg->spare,tmp;
+  Mat            Amat,Pmat;
+  PetscBool      diagonalscale,lanczos,restart = PETSC_TRUE;
+
+  PetscFunctionBegin;
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+
+  X    = ksp->vec_sol;
+  Bv   = ksp->vec_rhs;
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+
+  /* r is the first vector of the second block of Yt, z of Y, and the search direction p = z, pt = r start the first blocks */
+  ksp->its = 0;
+  if (!ksp->guess_zero) {
+    ierr = KSP_MatMult(ksp,Amat,X,Yt[s+1]);CHKERRQ(ierr);        /*     r <- b - Ax     */
+    ierr = VecAYPX(Yt[s+1],-1.0,Bv);CHKERRQ(ierr);
+  } else {
+    ierr = VecCopy(Bv,Yt[s+1]);CHKERRQ(ierr);                    /*     r <- b (x is 0) */
+  }
+  ierr = KSP_PCApply(ksp,Yt[s+1],Y[s+1]);CHKERRQ(ierr);          /*     z <- Br         */
+  ierr = VecCopy(Y[s+1],Y[0]);CHKERRQ(ierr);
+  ierr = VecCopy(Yt[s+1],Yt[0]);CHKERRQ(ierr);
+
+  /* the change of basis matrix, B(:,k) holds the coefficients of M A Y(:,k) for the columns but the last of each block */
+  cacg->nshifts  = 0;
+  cacg->nlanczos = 0;
+  ierr = PetscArrayzero(B,n*n);CHKERRQ(ierr);
+  for (k=0; k<s; k++) B[k*n+k+1] = 1.0;
+  for (k=s+1; k<2*s; k++) B[k*n+k+1] = 1.0;
+
+  for (i=0; !ksp->reason; i++) {
+    /* the matrix powers kernel, both blocks: yt_{k+1} = A y_k - theta_k yt_k and y_{k+1} = M A y_k - theta_k y_k */
+    for (k=0; k<2*s; k++) {
+      if (k == s) continue;
+      theta = 0.0;
+      if (k < s && k < cacg->nshifts) theta = cacg->shift[k];
+      if (k > s && k-s-1 < cacg->nshifts) theta = cacg->shift[k-s-1];
+      ierr = KSP_MatMult(ksp,Amat,Y[k],Yt[k+1]);CHKERRQ(ierr);
+      ierr = KSP_PCApply(ksp,Yt[k+1],Y[k+1]);CHKERRQ(ierr);
+      if (theta != 0.0) {
+        ierr = VecAXPY(Yt[k+1],-theta,Yt[k]);CHKERRQ(ierr);
+        ierr = VecAXPY(Y[k+1],-theta,Y[k]);CHKERRQ(ierr);
+      }
+      B[k*n+k] = theta;
+    }
+
+    /* the only reduction of the s iterations: the Gram matrix of the basis, and the one of the norm */
+    for (k=0; k<n; k++) {
+      ierr = VecMDotBegin(Y[k],n,Yt,G+k*n);CHKERRQ(ierr);
+      if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {ierr = VecMDotBegin(Yt[k],n,Yt,N+k*n);CHKERRQ(ierr);}
+      else if (ksp->normtype == KSP_NORM_PRECONDITIONED) {ierr = VecMDotBegin(Y[k],n,Y,N+k*n);CHKERRQ(ierr);}
+    }
+    if (!i) {ierr = KSPConvergedDefaultRHSNormBegin_Private(ksp);CHKERRQ(ierr);}
+    ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)X));CHKERRQ(ierr);
+    for (k=0; k<n; k++) {
+      ierr = VecMDotEnd(Y[k],n,Yt,G+k*n);CHKERRQ(ierr);
+      if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {ierr = VecMDotEnd(Yt[k],n,Yt,N+k*n);CHKERRQ(ierr);}
+      else if (ksp->normtype == KSP_NORM_PRECONDITIONED) {ierr = VecMDotEnd(Y[k],n,Y,N+k*n);CHKERRQ(ierr);}
+    }
+    if (!i) {ierr = KSPConvergedDefaultRHSNormEnd_Private(ksp);CHKERRQ(ierr);}
+    if (ksp->normtype == KSP_NORM_NATURAL) N = G;
+
+    /* the coefficients of p, r and of the update of x */
+    ierr    = PetscArrayzero(pc,n);CHKERRQ(ierr);
+    ierr    = PetscArrayzero(rc,n);CHKERRQ(ierr);
+    ierr    = PetscArrayzero(ec,n);CHKERRQ(ierr);
+    pc[0]   = 1.0;
+    rc[s+1] = 1.0;
+    gamma   = G[(s+1)*n+s+1];                                    /*     gamma <- r'z    */
+    KSPCheckDot(ksp,gamma);
+    if (!i) {
+      gamma0 = PetscAbsScalar(gamma);
+      if (ksp->normtype != KSP_NORM_NONE) dp = PetscSqrtReal(PetscAbsScalar(N[(s+1)*n+s+1]));
+      ierr       = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+      ierr       = KSPMonitor(ksp,0,dp);CHKERRQ(ierr);
+      ksp->rnorm = dp;
+      ierr       = (*ksp->converged)(ksp,0,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (ksp->reason) break;
+    }
+
+    /* fewer iterations when the part of the basis they use is too ill conditioned for their coefficients to be accurate,
+       z = p in the first outer iteration and after a restart so the basis is then only its first block */
+    ns   = s;
+    ierr = KSPCACGBasisCondition(ksp,ns,restart,&cond);CHKERRQ(ierr);
+    while (ns > 1 && cond > cacg->condtol) {
+      ns--;
+      ierr = KSPCACGBasisCondition(ksp,ns,restart,&cond);CHKERRQ(ierr);
+    }
+    if (ns < s) {ierr = PetscInfo3(ksp,"Only %D of %D iterations from iteration %D, the basis is ill conditioned\n",ns,s,ksp->its);CHKERRQ(ierr);}
+    if (cacg->monitorbasis) {ierr = KSPCACGMonitorBasis(ksp,ns,cond);CHKERRQ(ierr);}
+    restart = PETSC_FALSE;
+
+    /* ns iterations of CG on the coefficients, the Lanczos matrix of the first s ones gives the shifts of the Newton basis */
+    lanczos = (cacg->newton && !cacg->nshifts) ? PETSC_TRUE : PETSC_FALSE;
+    for (j=0; j<ns; j++) {
+      if (gamma == 0.0) {
+        ksp->reason = KSP_CONVERGED_ATOL;
+        ierr        = PetscInfo(ksp,"converged due to gamma = 0\n");CHKERRQ(ierr);
+        break;
+      }
+      for (k=0; k<n; k++) bp[k] = B[k*n+k]*pc[k] + (k ? B[(k-1)*n+k]*pc[k-1] : 0.0);  /*     A p    */
+      delta = KSPCACGDot_Private(n,G,pc,bp);                                           /*     p'Ap   */
+      KSPCheckDot(ksp,delta);
+      if (PetscRealPart(delta) <= 0.0 && PetscAbsScalar(gamma) <= PETSC_MACHINE_EPSILON*gamma0) {
+        /* the residual is at the level of rounding errors, so is p'Ap computed in the basis */
+        ksp->reason = KSP_CONVERGED_ATOL;
+        ierr        = PetscInfo(ksp,"converged due to gamma = 0 up to rounding errors\n");CHKERRQ(ierr);
+        break;
+      } else if (PetscRealPart(delta) <= 0.0) {
+        if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite matrix, delta %g",(double)PetscRealPart(delta));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+        ierr        = PetscInfo(ksp,"diverging due to indefinite or negative definite matrix\n");CHKERRQ(ierr);
+        break;
+      }
+      alpha = gamma/delta;
+      for (k=0; k<n; k++) {
+        ec[k] += alpha*pc[k];                                    /*     x <- x + alpha p   */
+        rc[k] -= alpha*bp[k];                                    /*     r <- r - alpha Ap  */
+      }
+      gammanew = KSPCACGDot_Private(n,G,rc,rc);
+      KSPCheckDot(ksp,gammanew);
+      if (PetscRealPart(gammanew) < 0.0 && PetscAbsScalar(gammanew) <= PETSC_MACHINE_EPSILON*gamma0) {
+        /* r'z computed in the basis is only accurate up to rounding errors relative to its initial value */
+        ksp->its++;
+        ksp->reason = KSP_CONVERGED_ATOL;
+        ierr        = PetscInfo(ksp,"converged due to gamma = 0 up to rounding errors\n");CHKERRQ(ierr);
+        j++;
+        break;
+      } else if (PetscRealPart(gammanew) < 0.0) {
+        if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Diverged due to indefinite preconditioner, gamma %g",(double)PetscRealPart(gammanew));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_PC;
+        ierr        = PetscInfo(ksp,"diverging due to indefinite preconditioner\n");CHKERRQ(ierr);
+        break;
+      }
+      beta = gammanew/gamma;
+      if (lanczos && cacg->nlanczos < s) {
+        cacg->d[cacg->nlanczos] = PetscRealPart(alpha);
+        cacg->e[cacg->nlanczos] = PetscRealPart(beta);
+        cacg->nlanczos++;
+      }
+      for (k=0; k<n; k++) pc[k] = rc[k] + beta*pc[k];           /*     p <- r + beta p    */
+      gamma = gammanew;
+
+      ksp->its++;
+      if (ksp->normtype == KSP_NORM_NATURAL) dp = PetscSqrtReal(PetscAbsScalar(gamma));
+      else if (ksp->normtype != KSP_NORM_NONE) dp = PetscSqrtReal(PetscAbsScalar(KSPCACGDot_Private(n,N,rc,rc)));
+      ksp->rnorm = dp;
+      ierr = KSPLogResidualHistory(ksp,dp);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,ksp->its,dp);CHKERRQ(ierr);
+      ierr = (*ksp->converged)(ksp,ksp->its,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (!ksp->reason && ksp->its >= ksp->max_it) ksp->reason = KSP_DIVERGED_ITS;
+      if (ksp->reason) {j++; break;}
+    }
+
+    /* recover x, and p, pt, r and z for the next outer iteration */
+    ierr = VecMAXPY(X,n,ec,Y);CHKERRQ(ierr);
+    if (ksp->reason > 0 && ksp->normtype != KSP_NORM_NONE) {
+      /* the residual updated in the basis drifts from the true residual, more so for large s: check the true one before
+         accepting convergence, and otherwise restart from it */
+      ierr = KSP_MatMult(ksp,Amat,X,Yt[s+1]);CHKERRQ(ierr);      /*     r <- b - Ax     */
+      ierr = VecAYPX(Yt[s+1],-1.0,Bv);CHKERRQ(ierr);
+      ierr = KSP_PCApply(ksp,Yt[s+1],Y[s+1]);CHKERRQ(ierr);        /*     z <- Br         */
+      if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
+        ierr = VecNorm(Yt[s+1],NORM_2,&tdp);CHKERRQ(ierr);
+      } else if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+        ierr = VecNorm(Y[s+1],NORM_2,&tdp);CHKERRQ(ierr);
+      } else {
+        ierr = VecDot(Y[s+1],Yt[s+1],&gamma);CHKERRQ(ierr);
+        KSPCheckDot(ksp,gamma);
+        tdp  = PetscSqrtReal(PetscAbsScalar(gamma));
+      }
+      ksp->reason = KSP_CONVERGED_ITERATING;
+      ksp->rnorm  = tdp;
+      ierr = (*ksp->converged)(ksp,ksp->its,tdp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+      if (!ksp->reason) {
+        ierr = PetscInfo3(ksp,"Residual norm %g in the basis but %g for the true residual at iteration %D, restarting\n",(double)dp,(double)tdp,ksp->its);CHKERRQ(ierr);
+        if (ksp->its >= ksp->max_it) {
+          ksp->reason = KSP_DIVERGED_ITS;
+          break;
+        }
+        ierr    = VecCopy(Y[s+1],Y[0]);CHKERRQ(ierr);
+        ierr    = VecCopy(Yt[s+1],Yt[0]);CHKERRQ(ierr);
+        restart = PETSC_TRUE;
+        if (!cacg->nshifts) cacg->nlanczos = 0;
+        continue;
+      }
+    }
+    if (ksp->reason) break;
+    ierr = VecZeroEntries(spare[0]);CHKERRQ(ierr);
+    ierr = VecZeroEntries(spare[1]);CHKERRQ(ierr);
+    ierr = VecZeroEntries(spare[2]);CHKERRQ(ierr);
+    ierr = VecZeroEntries(spare[3]);CHKERRQ(ierr);
+    ierr = VecMAXPY(spare[0],n,pc,Y);CHKERRQ(ierr);
+    ierr = VecMAXPY(spare[1],n,pc,Yt);CHKERRQ(ierr);
+    ierr = VecMAXPY(spare[2],n,rc,Y);CHKERRQ(ierr);
+    ierr = VecMAXPY(spare[3],n,rc,Yt);CHKERRQ(ierr);
+    tmp = Y[0];    Y[0]    = spare[0]; spare[0] = tmp;
+    tmp = Yt[0];   Yt[0]   = spare[1]; spare[1] = tmp;
+    tmp = Y[s+1];  Y[s+1]  = spare[2]; spare[2] = tmp;
+    tmp = Yt[s+1]; Yt[s+1] = spare[3]; spare[3] = tmp;
+
+    if (lanczos && cacg->nlanczos == s) {ierr = KSPCACGComputeShifts(ksp,s);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_CACG(KSP ksp)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(cacg->Y,cacg->Yt,cacg->spare);CHKERRQ(ierr);
+  ierr = PetscFree4(cacg->G,cacg->N,cacg->B,cacg->R);CHKERRQ(ierr);
+  ierr = PetscFree4(cacg->pc,cacg->rc,cacg->ec,cacg->bp);CHKERRQ(ierr);
+  ierr = PetscFree4(cacg->shift,cacg->d,cacg->e,cacg->work);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_CACG(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_CACG(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroyDefault(ksp);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPCACGSetSteps_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_CACG(KSP ksp,PetscViewer viewer)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  s=%D, using the %s basis\n",cacg->s,cacg->newton ? "Newton" : "monomial");CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_CACG(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_CACG       *cacg = (KSP_CACG*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       s;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP CACG Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_cacg_s","Number of iterations between reductions","KSPCACGSetSteps",cacg->s,&s,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPCACGSetSteps(ksp,s);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-ksp_cacg_newton","Use the Newton basis with Leja ordered Ritz values as shifts","None",cacg->newton,&cacg->newton,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-ksp_cacg_monitor_basis","Print the estimated condition number of the basis of each outer iteration","None",cacg->monitorbasis,&cacg->monitorbasis,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPCACGSetSteps_CACG(KSP ksp,PetscInt s)
+{
+  KSP_CACG *cacg = (KSP_CACG*)ksp->data;
+
+  PetscFunctionBegin;
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of steps %D must be positive",s);
+  if (ksp->setupstage && cacg->s != s) ksp->setupstage = KSP_SETUP_NEW;
+  cacg->s = s;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPCACGSetSteps - Sets the number of iterations that KSPCACG performs between two reductions
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  s - the number of steps
+
+   Options Database:
+.  -ksp_cacg_s <s>
+
+   Notes:
+   The default is 4. Each outer iteration applies the operator and the preconditioner 2 s - 1 times and needs 4 s + 6 work
+   vectors. Larger values save more reductions but make the basis more ill conditioned, outer iterations whose basis is
+   too ill conditioned then perform fewer iterations, see -ksp_cacg_monitor_basis, and the residual computed in the basis
+   drifts further from the true residual.
+
+   Level: intermediate
+
+.seealso: KSPCACG, KSPCAGMRESSetSteps()
+@*/
+PetscErrorCode KSPCACGSetSteps(KSP ksp,PetscInt s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,s,2);
+  ierr = PetscTryMethod(ksp,"KSPCACGSetSteps_C",(KSP,PetscInt),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   KSPCACG - Communication-avoiding s-step preconditioned conjugate gradient method.
+
+   Options Database Keys:
++   -ksp_cacg_s <s> - the number of iterations between reductions
+.   -ksp_cacg_newton <true,false> - use the Newton basis, with the Ritz values of the first s iterations as shifts, instead of the monomial basis
+-   -ksp_cacg_monitor_basis - print the estimated condition number of the basis of each outer iteration
+
+   Level: intermediate
+
+   Notes:
+   This method has a single reduction every s iterations, compared to 2 per iteration for KSPCG: the operator and the
+   preconditioner are applied 2 s - 1 times in a row to compute a basis of the Krylov spaces of the search direction and
+   of the preconditioned residual, then a single reduction computes the Gram matrix of this basis, from which the next s
+   iterations are computed without any global communication. The iterates are those of KSPCG in exact arithmetic and the
+   residual norm of every iteration is available to the convergence test.
+
+   The first s iterations use the monomial basis, the next ones the Newton basis whose shifts are the Ritz values of these
+   first iterations in Leja order, which keeps the basis much better conditioned. An outer iteration whose basis has an
+   estimated condition number larger than the fourth root of the inverse of the machine epsilon performs only as many
+   iterations as its well conditioned leading vectors allow. Since the residual is updated in the basis, the true residual
+   is computed when the convergence test is satisfied, and the method restarts from it if it has not converged. Both the
+   operator and the preconditioner must be symmetric (Hermitian) positive definite.
+
+   Reference:
+   E. Carson, Communication-avoiding Krylov subspace methods in theory and practice, PhD thesis, University of California,
+   Berkeley, 2015.
+
+.seealso: KSPCreate(), KSPSetType(), KSPCG, KSPPIPECG, KSPGROPPCG, KSPCAGMRES, KSPCACGSetSteps()
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_CACG(KSP ksp)
+{
+  KSP_CACG       *cacg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&cacg);CHKERRQ(ierr);
+  cacg->s       = CACG_DEFAULT_S;
+  cacg->newton  = PETSC_TRUE;
+  cacg->condtol = PetscPowReal(PETSC_MACHINE_EPSILON,-0.25);
+  ksp->data     = (void*)cacg;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NATURAL,PC_LEFT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->setup          = KSPSetUp_CACG;
+  ksp->ops->solve          = KSPSolve_CACG;
+  ksp->ops->reset          = KSPReset_CACG;
+  ksp->ops->destroy        = KSPDestroy_CACG;
+  ksp->ops->view           = KSPView_CACG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_CACG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPCACGSetSteps_C",KSPCACGSetSteps_CACG);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
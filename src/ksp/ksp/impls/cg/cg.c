@@ -42,6 +42,7 @@
     data used during the optional Lanczo process used to compute eigenvalues
 */
 #include <../src/ksp/ksp/impls/cg/cgimpl.h>       /*I "petscksp.h" I*/
+#include <petsc/private/pcimpl.h>
 extern PetscErrorCode KSPComputeExtremeSingularValues_CG(KSP,PetscReal*,PetscReal*);
 extern PetscErrorCode KSPComputeEigenvalues_CG(KSP,PetscInt,PetscReal*,PetscReal*,PetscInt*);
 
@@ -101,7 +102,7 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
   Vec            X,B,Z,R,P,W;
   KSP_CG         *cg;
   Mat            Amat,Pmat;
-  PetscBool      diagonalscale;
+  PetscBool      diagonalscale,betavalid;
 
   PetscFunctionBegin;
   ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
@@ -205,20 +206,32 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     a = beta/dpi;                                              /*     a = beta/p'w                     */
     if (eigs) d[i] = PetscSqrtReal(PetscAbsScalar(b))*e[i] + 1.0/a;
     ierr = VecAXPY(X,a,P);CHKERRQ(ierr);                       /*     x <- x + ap                      */
-    ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                      /*     r <- r - aw                      */
+    betavalid = PETSC_FALSE;
     if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i+2) {
+      ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                    /*     r <- r - aw                      */
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
-      ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- z'*z                       */
+      if (cg->type == KSP_CG_HERMITIAN) {
+        /* the next beta is computed with the norm, in a single reduction */
+        ierr = VecDotNorm2(R,Z,&beta,&dp);CHKERRQ(ierr);       /*     beta <- z'*r, dp <- z'*z         */
+        beta = PetscConj(beta);
+        dp   = PetscSqrtReal(dp);
+        KSPCheckDot(ksp,beta);
+        betavalid = PETSC_TRUE;
+      } else {
+        ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);            /*     dp <- z'*z                       */
+      }
       KSPCheckNorm(ksp,dp);
     } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- r'*r                       */
+      ierr = VecAXPYNorm(R,-a,W,&dp);CHKERRQ(ierr);            /*     r <- r - aw, dp <- r'*r          */
       KSPCheckNorm(ksp,dp);
     } else if (ksp->normtype == KSP_NORM_NATURAL) {
+      ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                    /*     r <- r - aw                      */
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
       ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*     beta <- r'*z                     */
       KSPCheckDot(ksp,beta);
       dp = PetscSqrtReal(PetscAbsScalar(beta));
     } else {
+      ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                    /*     r <- r - aw                      */
       dp = 0.0;
     }
     ksp->rnorm = dp;
@@ -231,7 +244,7 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     if ((ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) || (ksp->chknorm >= i+2)) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
     }
-    if ((ksp->normtype != KSP_NORM_NATURAL) || (ksp->chknorm >= i+2)) {
+    if (((ksp->normtype != KSP_NORM_NATURAL) || (ksp->chknorm >= i+2)) && !betavalid) {
       ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*     beta <- z'*r                     */
       KSPCheckDot(ksp,beta);
     }
@@ -419,6 +432,166 @@ static PetscErrorCode KSPSolve_CG_SingleReduction(KSP ksp)
   PetscFunctionReturn(0);
 }
 
+/*
+     KSPMatSolveDots_CG - Computes beta <- z'*r and the residual norm of each column of R and Z in a single reduction
+*/
+static PetscErrorCode KSPMatSolveDots_CG(KSP ksp,Mat R,Mat Z,PetscScalar *dots,PetscScalar *beta,PetscReal *dp)
+{
+  PetscErrorCode    ierr;
+  KSP_CG            *cg = (KSP_CG*)ksp->data;
+  PetscInt          m,N,i,j,ldr,ldz;
+  const PetscScalar *ra,*za,*r,*z;
+  PetscScalar       zr,nrm;
+
+  PetscFunctionBegin;
+  ierr = MatGetLocalSize(R,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(R,NULL,&N);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(R,&ldr);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(Z,&ldz);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(R,&ra);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(Z,&za);CHKERRQ(ierr);
+  for (j=0; j<N; j++) {
+    r  = ra + j*ldr;
+    z  = za + j*ldz;
+    zr = nrm = 0.0;
+    if (cg->type == KSP_CG_HERMITIAN) for (i=0; i<m; i++) zr += z[i]*PetscConj(r[i]);
+    else for (i=0; i<m; i++) zr += z[i]*r[i];
+    if (ksp->normtype == KSP_NORM_PRECONDITIONED) for (i=0; i<m; i++) nrm += z[i]*PetscConj(z[i]);
+    else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) for (i=0; i<m; i++) nrm += r[i]*PetscConj(r[i]);
+    dots[2*j]   = zr;
+    dots[2*j+1] = nrm;
+  }
+  ierr = MatDenseRestoreArrayRead(R,&ra);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(Z,&za);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(dots,dots+2*N,2*N,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  for (j=0; j<N; j++) {
+    beta[j] = dots[2*N+2*j];                                   /*     beta <- z'*r                     */
+    if (ksp->normtype == KSP_NORM_NATURAL) dp[j] = PetscSqrtReal(PetscAbsScalar(beta[j]));
+    else dp[j] = PetscSqrtReal(PetscRealPart(dots[2*N+2*j+1]));
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+     KSPMatSolve_CG - Runs CG on all the columns of B at once. Each column has its own coefficients and convergence test, as
+     in KSPSolve_CG(), but the products by the operator, the preconditioner applications and the inner products of an iteration
+     are done for the whole block, with MatMatMult(), PCMatApply() and a single reduction.
+*/
+static PetscErrorCode KSPMatSolve_CG(KSP ksp,Mat B,Mat X)
+{
+  PetscErrorCode     ierr;
+  KSP_CG             *cg = (KSP_CG*)ksp->data;
+  Mat                Amat,Pmat,R,Z,P,W = NULL;
+  PetscInt           m,N,i,j,k,ldx,ldr,ldz,ldp,ldw,active;
+  PetscScalar        *dots,*beta,*betaold,*dpi,*dpiold,*xa,*ra,*pa,*x,*r,*p,a,b;
+  const PetscScalar  *za,*wa,*z,*w;
+  PetscReal          *dp,*dp0;
+  KSPConvergedReason *reason;
+
+  PetscFunctionBegin;
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(B,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(B,NULL,&N);CHKERRQ(ierr);
+  ierr = PetscMalloc7(4*N,&dots,N,&beta,N,&betaold,2*N,&dpi,N,&dp,N,&dp0,N,&reason);CHKERRQ(ierr);
+  dpiold = dpi + N;
+  ierr = MatDuplicate(B,MAT_COPY_VALUES,&R);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&Z);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&P);CHKERRQ(ierr);
+
+  ksp->its = 0;
+  if (!ksp->guess_zero) {
+    ierr = PCMatProduct_Private(Amat,X,MATPRODUCT_AB,&W);CHKERRQ(ierr); /*    r <- b - Ax                       */
+    ierr = MatAXPY(R,-1.0,W,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  }
+  ierr = PCMatApply(ksp->pc,R,Z);CHKERRQ(ierr);                        /*    z <- Br                           */
+  ierr = KSPMatSolveDots_CG(ksp,R,Z,dots,beta,dp);CHKERRQ(ierr);
+  ierr = KSPMatSolveConverged_Private(ksp,B,0,N,dp,dp0,reason,&active);CHKERRQ(ierr);
+
+  for (i=0; active; i++) {
+    for (j=0; j<N; j++) {
+      if (reason[j]) continue;
+      if (beta[j] == 0.0) reason[j] = KSP_CONVERGED_ATOL;
+#if !defined(PETSC_USE_COMPLEX)
+      else if (i && beta[j]*betaold[j] < 0.0) reason[j] = KSP_DIVERGED_INDEFINITE_PC;
+#endif
+    }
+    ierr = MatDenseGetLDA(Z,&ldz);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(P,&ldp);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(Z,&za);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(P,&pa);CHKERRQ(ierr);
+    for (j=0; j<N; j++) {
+      if (reason[j]) continue;
+      z = za + j*ldz;
+      p = pa + j*ldp;
+      b = i ? beta[j]/betaold[j] : 0.0;
+      for (k=0; k<m; k++) p[k] = z[k] + b*p[k];                       /*     p <- z + b* p                    */
+      betaold[j] = beta[j];
+    }
+    ierr = MatDenseRestoreArrayRead(Z,&za);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(P,&pa);CHKERRQ(ierr);
+
+    ierr = PCMatProduct_Private(Amat,P,MATPRODUCT_AB,&W);CHKERRQ(ierr); /*     w <- Ap                          */
+    ierr = MatDenseGetLDA(W,&ldw);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(W,&wa);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(P,(const PetscScalar**)&pa);CHKERRQ(ierr);
+    for (j=0; j<N; j++) {
+      w = wa + j*ldw;
+      p = pa + j*ldp;
+      a = 0.0;
+      if (cg->type == KSP_CG_HERMITIAN) for (k=0; k<m; k++) a += p[k]*PetscConj(w[k]);
+      else for (k=0; k<m; k++) a += p[k]*w[k];
+      dots[j] = a;
+    }
+    ierr = MatDenseRestoreArrayRead(P,(const PetscScalar**)&pa);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(dots,dpi,N,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr); /* dpi <- p'w */
+    active = 0;
+    for (j=0; j<N; j++) {
+      if (reason[j]) continue;
+      if (dpi[j] == 0.0 || (i && PetscSign(PetscRealPart(dpi[j]))*PetscSign(PetscRealPart(dpiold[j])) < 0.0)) reason[j] = KSP_DIVERGED_INDEFINITE_MAT;
+      else active++;
+      dpiold[j] = dpi[j];
+    }
+    if (!active) {
+      ierr = MatDenseRestoreArrayRead(W,&wa);CHKERRQ(ierr);
+      ierr = KSPMatSolveConverged_Private(ksp,B,i+1,N,dp,dp0,reason,&active);CHKERRQ(ierr);
+      break;
+    }
+
+    ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(R,&ldr);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(X,&xa);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(R,&ra);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(P,(const PetscScalar**)&pa);CHKERRQ(ierr);
+    for (j=0; j<N; j++) {
+      if (reason[j]) continue;
+      x = xa + j*ldx;
+      r = ra + j*ldr;
+      p = pa + j*ldp;
+      w = wa + j*ldw;
+      a = beta[j]/dpi[j];                                             /*     a = beta/p'w                     */
+      for (k=0; k<m; k++) {
+        x[k] += a*p[k];                                               /*     x <- x + ap                      */
+        r[k] -= a*w[k];                                               /*     r <- r - aw                      */
+      }
+    }
+    ierr = MatDenseRestoreArrayRead(P,(const PetscScalar**)&pa);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(R,&ra);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(X,&xa);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(W,&wa);CHKERRQ(ierr);
+
+    ierr = PCMatApply(ksp->pc,R,Z);CHKERRQ(ierr);                      /*     z <- Br                          */
+    ierr = KSPMatSolveDots_CG(ksp,R,Z,dots,beta,dp);CHKERRQ(ierr);
+    ierr = KSPMatSolveConverged_Private(ksp,B,i+1,N,dp,dp0,reason,&active);CHKERRQ(ierr);
+  }
+
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  ierr = MatDestroy(&Z);CHKERRQ(ierr);
+  ierr = MatDestroy(&P);CHKERRQ(ierr);
+  ierr = MatDestroy(&W);CHKERRQ(ierr);
+  ierr = PetscFree7(dots,beta,betaold,dpi,dp,dp0,reason);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
      KSPDestroy_CG - Frees resources allocated in KSPSetup_CG and clears function
                      compositions from KSPCreate_CG. If adding your own KSP implementation,
@@ -593,6 +766,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_CG(KSP ksp)
   */
   ksp->ops->setup          = KSPSetUp_CG;
   ksp->ops->solve          = KSPSolve_CG;
+  ksp->ops->matsolve       = KSPMatSolve_CG;
   ksp->ops->destroy        = KSPDestroy_CG;
   ksp->ops->view           = KSPView_CG;
   ksp->ops->setfromoptions = KSPSetFromOptions_CG;
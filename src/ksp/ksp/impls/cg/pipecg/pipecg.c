@@ -65,21 +65,27 @@ static PetscErrorCode  KSPSolve_PIPECG(KSP ksp)
   switch (ksp->normtype) {
   case KSP_NORM_PRECONDITIONED:
     ierr = VecNormBegin(U,NORM_2,&dp);CHKERRQ(ierr);                /*     dp <- u'*u = e'*A'*B'*B*A'*e'     */
+    ierr = KSPConvergedDefaultRHSNormBegin_Private(ksp);CHKERRQ(ierr);
     ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)U));CHKERRQ(ierr);
     ierr = KSP_MatMult(ksp,Amat,U,W);CHKERRQ(ierr);              /*     w <- Au   */
     ierr = VecNormEnd(U,NORM_2,&dp);CHKERRQ(ierr);
+    ierr = KSPConvergedDefaultRHSNormEnd_Private(ksp);CHKERRQ(ierr);
     break;
   case KSP_NORM_UNPRECONDITIONED:
     ierr = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);                /*     dp <- r'*r = e'*A'*A*e            */
+    ierr = KSPConvergedDefaultRHSNormBegin_Private(ksp);CHKERRQ(ierr);
     ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R));CHKERRQ(ierr);
     ierr = KSP_MatMult(ksp,Amat,U,W);CHKERRQ(ierr);              /*     w <- Au   */
     ierr = VecNormEnd(R,NORM_2,&dp);CHKERRQ(ierr);
+    ierr = KSPConvergedDefaultRHSNormEnd_Private(ksp);CHKERRQ(ierr);
     break;
   case KSP_NORM_NATURAL:
     ierr = VecDotBegin(R,U,&gamma);CHKERRQ(ierr);                  /*     gamma <- u'*r       */
+    ierr = KSPConvergedDefaultRHSNormBegin_Private(ksp);CHKERRQ(ierr);
     ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R));CHKERRQ(ierr);
     ierr = KSP_MatMult(ksp,Amat,U,W);CHKERRQ(ierr);              /*     w <- Au   */
     ierr = VecDotEnd(R,U,&gamma);CHKERRQ(ierr);
+    ierr = KSPConvergedDefaultRHSNormEnd_Private(ksp);CHKERRQ(ierr);
     KSPCheckDot(ksp,gamma);
     dp = PetscSqrtReal(PetscAbsScalar(gamma));                  /*     dp <- r'*u = r'*B*r = e'*A'*B*A*e */
     break;
@@ -109,6 +115,7 @@ static PetscErrorCode  KSPSolve_PIPECG(KSP ksp)
     ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)R));CHKERRQ(ierr);
 
     ierr = KSP_PCApply(ksp,W,M);CHKERRQ(ierr);           /*   m <- Bw       */
+    ierr = PetscCommSplitReductionProgress(PetscObjectComm((PetscObject)R),NULL);CHKERRQ(ierr);
     ierr = KSP_MatMult(ksp,Amat,M,N);CHKERRQ(ierr);      /*   n <- Am       */
 
     if (i > 0 && ksp->normtype == KSP_NORM_UNPRECONDITIONED) {
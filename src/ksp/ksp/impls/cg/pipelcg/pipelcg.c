@@ -118,6 +118,21 @@ static PetscErrorCode MPIPetsc_Iallreduce(void *sendbuf,void *recvbuf,PetscMPIIn
   PetscFunctionReturn(0);
 }
 
+/* Lets MPI progress the reductions still in the pipeline at iteration it, those with requests it-l+1 to it */
+static PetscErrorCode KSPPIPELCGProgress_Private(KSP ksp,PetscInt it)
+{
+  KSP_CG_PIPE_L  *plcg = (KSP_CG_PIPE_L*)ksp->data;
+  PetscInt       l = plcg->l,first = PetscMax(it-l+1,0),last = PetscMin(it,ksp->max_it);
+  PetscMPIInt    n,flag;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (last < first) PetscFunctionReturn(0);
+  ierr = PetscMPIIntCast(last-first+1,&n);CHKERRQ(ierr);
+  ierr = MPI_Testall(n,&req(first),&flag,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode KSPView_PIPELCG(KSP ksp,PetscViewer viewer)
 {
   KSP_CG_PIPE_L  *plcg = (KSP_CG_PIPE_L*)ksp->data;
@@ -171,6 +186,7 @@ static PetscErrorCode KSPSolve_InnerLoop_PIPELCG(KSP ksp)
     if (it < l) {
       /* SpMV and Sigma-shift and Prec */
       ierr = MatMult(A,Z[l-it],U[0]);CHKERRQ(ierr);
+      ierr = KSPPIPELCGProgress_Private(ksp,it);CHKERRQ(ierr);
       ierr = VecAXPY(U[0],-sigma(it),U[1]);CHKERRQ(ierr);
       ierr = KSP_PCApply(ksp,U[0],Z[l-it-1]);CHKERRQ(ierr);
       if (it < l-1) {
@@ -185,6 +201,7 @@ static PetscErrorCode KSPSolve_InnerLoop_PIPELCG(KSP ksp)
       Z[0] = temp;
       /* SpMV and Prec */
       ierr = MatMult(A,Z[1],U[0]);CHKERRQ(ierr);
+      ierr = KSPPIPELCGProgress_Private(ksp,it);CHKERRQ(ierr);
       ierr = KSP_PCApply(ksp,U[0],Z[0]);CHKERRQ(ierr);
     }
 
@@ -7,6 +7,7 @@
     given for correct computation of inner products.
 */
 #include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+#include <petsc/private/vecimpl.h>
 
 /*@C
      KSPGMRESModifiedGramSchmidtOrthogonalization -  This is the basic orthogonalization routine
@@ -51,3 +52,133 @@ PetscErrorCode  KSPGMRESModifiedGramSchmidtOrthogonalization(KSP ksp,PetscInt it
 }
 
 
+
+/*
+    KSPGMRESLowSyncDots_Private - Computes with a single reduction the inner products lhh of the new direction with the
+    Krylov vectors, the inner products of the last Krylov vector with itself and the previous ones, which complete the
+    column it of the Gram matrix of the Krylov vectors, and the norm of the new direction.
+*/
+PetscErrorCode KSPGMRESLowSyncDots_Private(KSP ksp,PetscInt it,PetscScalar *lhh,PetscReal *wnrm)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode ierr;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  if (!gmres->orthoggram) {
+    ierr = PetscMalloc1((gmres->max_k + 1)*(gmres->max_k + 1),&gmres->orthoggram);CHKERRQ(ierr);
+  }
+  ierr = VecMDotBegin(VEC_VV(it+1),it+1,&VEC_VV(0),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  ierr = VecMDotBegin(VEC_VV(it),it+1,&VEC_VV(0),GRAM(0,it));CHKERRQ(ierr); /* <v,vlast> */
+  ierr = VecNormBegin(VEC_VV(it+1),NORM_2,wnrm);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(it+1)));CHKERRQ(ierr);
+  ierr = VecMDotEnd(VEC_VV(it+1),it+1,&VEC_VV(0),lhh);CHKERRQ(ierr);
+  ierr = VecMDotEnd(VEC_VV(it),it+1,&VEC_VV(0),GRAM(0,it));CHKERRQ(ierr);
+  ierr = VecNormEnd(VEC_VV(it+1),NORM_2,wnrm);CHKERRQ(ierr);
+  for (j=0; j<=it; j++) KSPCheckDot(ksp,lhh[j]);
+  KSPCheckNorm(ksp,*wnrm);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPGMRESLowSyncUpdate_Private - Subtracts the projection on the Krylov vectors with the coefficients in the column it of
+    the Hessenberg matrix from the new direction, whose inner products with the Krylov vectors are lhh. The norm of the
+    result follows from them and from the Gram matrix, the exact norms of the Krylov vectors keeping its rounding errors
+    from growing, and is cached in the vector so the normalization that follows in the GMRES cycle does not communicate.
+    If it suffers from too much cancellation, the direction is orthogonalized once more with classical Gram-Schmidt and its
+    norm computed explicitly.
+*/
+PetscErrorCode KSPGMRESLowSyncUpdate_Private(KSP ksp,PetscInt it,PetscScalar *lhh,PetscReal wnrm)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode ierr;
+  PetscInt       i,j;
+  PetscScalar    *hh = HH(0,it),*hes = HES(0,it);
+  PetscReal      nrm2 = wnrm*wnrm;
+
+  PetscFunctionBegin;
+  /* |vnew - V h|^2 = |vnew|^2 - 2 Re(h^H V^H vnew) + h^H V^H V h */
+  for (i=0; i<=it; i++) {
+    nrm2 += PetscRealPart(*GRAM(i,i))*PetscRealPart(PetscConj(hes[i])*hes[i]) - 2.0*PetscRealPart(PetscConj(hes[i])*lhh[i]);
+    for (j=i+1; j<=it; j++) nrm2 += 2.0*PetscRealPart(PetscConj(hes[i])*(*GRAM(i,j))*hes[j]);
+  }
+  for (j=0; j<=it; j++) {
+    hh[j]  = hes[j];
+    lhh[j] = -hes[j];
+  }
+  ierr = VecMAXPY(VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
+  if (nrm2 > PetscSqrtReal(PETSC_MACHINE_EPSILON)*wnrm*wnrm) {
+    ierr = PetscObjectComposedDataSetReal((PetscObject)VEC_VV(it+1),NormIds[NORM_2],PetscSqrtReal(nrm2));CHKERRQ(ierr);
+  } else {
+    ierr = PetscInfo2(ksp,"Performing iterative refinement wnorm %g computed norm squared %g\n",(double)wnrm,(double)nrm2);CHKERRQ(ierr);
+    ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+    for (j=0; j<=it; j++) {
+      KSPCheckDot(ksp,lhh[j]);
+      hh[j]  += lhh[j];
+      hes[j] += lhh[j];
+      lhh[j]  = -lhh[j];
+    }
+    ierr = VecMAXPYNorm(VEC_VV(it+1),it+1,lhh,&VEC_VV(0),&wnrm);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+     KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization -  This is the orthogonalization routine using modified Gram-Schmidt
+                in its inverse compact WY form, with a single reduction per iteration.
+
+     Collective on ksp
+
+  Input Parameters:
++   ksp - KSP object, must be associated with GMRES, FGMRES, or LGMRES Krylov method
+-   its - one less then the current GMRES restart iteration, i.e. the size of the Krylov space
+
+   Options Database Keys:
+.  -ksp_gmres_lowsyncmodifiedgramschmidt - Activates KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization()
+
+   Notes:
+   The successive projections of modified Gram-Schmidt are the projection I - V (I + L)^{-1} V^H, where L is the strictly
+   lower triangular part of the Gram matrix V^H V of the Krylov vectors. The reduction that computes the inner products of
+   the new direction with the Krylov vectors also computes the last column of V^H V and the norm of the new direction; the
+   norm of the orthogonalized direction follows from them, so the normalization does not need another reduction.
+
+   Level: intermediate
+
+   References:
+.   1. - K. Swirydowicz, J. Langou, S. Ananthan, U. Yang and S. Thomas, Low synchronization Gram-Schmidt and generalized
+         minimal residual algorithms, Numerical Linear Algebra with Applications, 2020.
+
+.seealso:  KSPGMRESSetOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization(),
+           KSPGMRESGetOrthogonalization()
+
+@*/
+PetscErrorCode  KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization(KSP ksp,PetscInt it)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode ierr;
+  PetscInt       i,j;
+  PetscScalar    *lhh,*hes;
+  PetscReal      wnrm;
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+  if (!gmres->orthogwork) {
+    ierr = PetscMalloc1(gmres->max_k + 2,&gmres->orthogwork);CHKERRQ(ierr);
+  }
+  lhh  = gmres->orthogwork;
+  hes  = HES(0,it);
+  ierr = KSPGMRESLowSyncDots_Private(ksp,it,lhh,&wnrm);CHKERRQ(ierr);
+  if (ksp->reason) {
+    ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  /* the coefficients of modified Gram-Schmidt solve (I + L) h = V^H vnew, with L(i,j) = <v_j,v_i> */
+  for (i=0; i<=it; i++) {
+    hes[i] = lhh[i];
+    for (j=0; j<i; j++) hes[i] -= PetscConj(*GRAM(j,i))*hes[j];
+  }
+  ierr = KSPGMRESLowSyncUpdate_Private(ksp,it,lhh,wnrm);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
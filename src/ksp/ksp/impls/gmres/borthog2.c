@@ -67,16 +67,23 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
     KSPCheckDot(ksp,lhh[j]);
     lhh[j] = -lhh[j];
   }
+  /* note lhh[j] is -<v,vnew> , hence the subtraction */
+  for (j=0; j<=it; j++) {
+    hh[j]  -= lhh[j];     /* hh += <v,vnew> */
+    hes[j] -= lhh[j];     /* hes += <v,vnew> */
+  }
 
   /*
          This is really a matrix vector product:
          [h[0],h[1],...]*[ v[0]; v[1]; ...] subtracted from v[it+1].
+     It is fused with the reduction that follows it: the inner products of the refinement, or else the norm
+     of the new direction that the refinement test needs. That norm is cached in v[it+1], so the
+     normalization that follows the orthogonalization in the GMRES cycle does not communicate.
   */
-  ierr = VecMAXPY(VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
-  /* note lhh[j] is -<v,vnew> , hence the subtraction */
-  for (j=0; j<=it; j++) {
-    hh[j]  -= lhh[j];     /* hh += <v,vnew> */
-    hes[j] -= lhh[j];     /* hes += <v,vnew> */
+  if (refine) {
+    ierr = VecMAXPYMDot(VEC_VV(it+1),it+1,lhh,&VEC_VV(0),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  } else {
+    ierr = VecMAXPYNorm(VEC_VV(it+1),it+1,lhh,&VEC_VV(0),&wnrm);CHKERRQ(ierr);
   }
 
   /*
@@ -88,17 +95,16 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
     for (j=0; j<=it; j++) hnrm +=  PetscRealPart(lhh[j] * PetscConj(lhh[j]));
 
     hnrm = PetscSqrtReal(hnrm);
-    ierr = VecNorm(VEC_VV(it+1),NORM_2, &wnrm);CHKERRQ(ierr);
     if (wnrm < hnrm) {
       refine = PETSC_TRUE;
       ierr   = PetscInfo2(ksp,"Performing iterative refinement wnorm %g hnorm %g\n",(double)wnrm,(double)hnrm);CHKERRQ(ierr);
+      ierr   = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
     }
   }
 
   if (refine) {
-    ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
     for (j=0; j<=it; j++) lhh[j] = -lhh[j];
-    ierr = VecMAXPY(VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
+    ierr = VecMAXPYNorm(VEC_VV(it+1),it+1,lhh,&VEC_VV(0),&wnrm);CHKERRQ(ierr);
     /* note lhh[j] is -<v,vnew> , hence the subtraction */
     for (j=0; j<=it; j++) {
       hh[j]  -= lhh[j];     /* hh += <v,vnew> */
@@ -116,3 +122,66 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
 
 
 
+
+/*@C
+     KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization -  This is the orthogonalization routine using classical Gram-Schmidt
+                with one step of iterative refinement, with a single reduction per iteration
+
+     Collective on ksp
+
+  Input Parameters:
++   ksp - KSP object, must be associated with GMRES, FGMRES, or LGMRES Krylov method
+-   its - one less then the current GMRES restart iteration, i.e. the size of the Krylov space
+
+   Options Database Keys:
+.  -ksp_gmres_lowsyncclassicalgramschmidt - Activates KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization()
+
+   Notes:
+   The inner products of the refinement step V^H (I - V V^H) vnew = V^H vnew - V^H V (V^H vnew) are computed from the Gram
+   matrix V^H V of the Krylov vectors, whose last column is computed in the same reduction as the inner products of the new
+   direction with the Krylov vectors and its norm. The norm of the orthogonalized direction follows from them, so the
+   normalization does not need another reduction. When the norm suffers from too much cancellation, a second
+   classical Gram-Schmidt step is done explicitly.
+
+   Level: intermediate
+
+   References:
+.   1. - K. Swirydowicz, J. Langou, S. Ananthan, U. Yang and S. Thomas, Low synchronization Gram-Schmidt and generalized
+         minimal residual algorithms, Numerical Linear Algebra with Applications, 2020.
+
+.seealso:  KSPGMRESSetOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization(),
+           KSPGMRESGetOrthogonalization()
+
+@*/
+PetscErrorCode  KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt it)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode ierr;
+  PetscInt       i,j;
+  PetscScalar    *lhh,*hes,sum;
+  PetscReal      wnrm;
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+  if (!gmres->orthogwork) {
+    ierr = PetscMalloc1(gmres->max_k + 2,&gmres->orthogwork);CHKERRQ(ierr);
+  }
+  lhh  = gmres->orthogwork;
+  hes  = HES(0,it);
+  ierr = KSPGMRESLowSyncDots_Private(ksp,it,lhh,&wnrm);CHKERRQ(ierr);
+  if (ksp->reason) {
+    ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  /* the coefficients of both steps h = (2 I - V^H V) V^H vnew, with the Gram matrix of unit diagonal */
+  for (i=0; i<=it; i++) {
+    sum = lhh[i];
+    for (j=0; j<i; j++)     sum -= PetscConj(*GRAM(j,i))*lhh[j];
+    for (j=i+1; j<=it; j++) sum -= *GRAM(i,j)*lhh[j];
+    hes[i] = sum;
+  }
+  ierr = KSPGMRESLowSyncUpdate_Private(ksp,it,lhh,wnrm);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
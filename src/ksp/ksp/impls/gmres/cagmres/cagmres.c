@@ -0,0 +1,807 @@
+/*
+    This file implements CA-GMRES (a communication-avoiding s-step Generalized Minimal Residual method)
+
+    Each block of s iterations computes s new basis vectors with the matrix powers kernel w_{k+1} = (A - theta_k) w_k, starting
+    from the last orthonormal basis vector, then orthogonalizes the whole block against the previous basis vectors and
+    within itself with a single reduction (block classical Gram-Schmidt followed by a Cholesky QR of the block). The s new
+    columns of the Hessenberg matrix are recovered from the triangular factors and the change of basis matrix, so the
+    least squares problem, the residual estimates and the solution are exactly those of KSPGMRES.
+*/
+
+#include <../src/ksp/ksp/impls/gmres/cagmres/cagmresimpl.h>       /*I  "petscksp.h"  I*/
+#include <petscblaslapack.h>
+#define CAGMRES_DELTA_DIRECTIONS 10
+#define CAGMRES_DEFAULT_MAXK     30
+#define CAGMRES_DEFAULT_S        5
+
+static PetscErrorCode KSPCAGMRESUpdateHessenberg(KSP,PetscInt,PetscBool,PetscReal*);
+static PetscErrorCode KSPCAGMRESBuildSoln(PetscScalar*,Vec,Vec,KSP,PetscInt);
+
+/* dense blocks stored by columns, see KSPSetUp_CAGMRES() for their sizes */
+#define DOTS(d,r,c) ((d)[(c)*(cagmres->max_k+2)+(r)])
+#define CTOT(r,c)   (cagmres->ctot[(c)*(cagmres->max_k+2)+(r)])
+#define HNEW(r,c)   (cagmres->hnew[(c)*(cagmres->max_k+2)+(r)])
+#define GRAM(r,c)   (cagmres->gram[(c)*cagmres->s+(r)])
+#define CHOL(r,c)   (cagmres->chol[(c)*cagmres->s+(r)])
+#define BCH(r,c)    (cagmres->bchange[(c)*(cagmres->s+1)+(r)])
+
+static PetscErrorCode KSPSetUp_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscInt       ld,s = cagmres->s;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetUp_GMRES(ksp);CHKERRQ(ierr);
+
+  /* the restart may have changed since the last setup */
+  ierr = PetscFree5(cagmres->dots,cagmres->dots2,cagmres->ctot,cagmres->hnew,cagmres->bchange);CHKERRQ(ierr);
+  ierr = PetscFree5(cagmres->gram,cagmres->chol,cagmres->scale,cagmres->shift,cagmres->shifti);CHKERRQ(ierr);
+  ld   = cagmres->max_k + 2;
+  ierr = PetscMalloc5(ld*s,&cagmres->dots,ld*s,&cagmres->dots2,ld*s,&cagmres->ctot,ld*s,&cagmres->hnew,(s+1)*s,&cagmres->bchange);CHKERRQ(ierr);
+  ierr = PetscMalloc5(s*s,&cagmres->gram,s*s,&cagmres->chol,s,&cagmres->scale,s,&cagmres->shift,s,&cagmres->shifti);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(4*ld*s + (s+1)*s + 2*s*s + s)*sizeof(PetscScalar) + 2*s*sizeof(PetscReal));CHKERRQ(ierr);
+  if (!cagmres->orthogwork) {
+    ierr = PetscMalloc1(cagmres->max_k + 2,&cagmres->orthogwork);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,(cagmres->max_k + 2)*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  cagmres->nshifts = 0;
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCAGMRESComputeShifts - Computes the shifts of the Newton basis, the Ritz values of the leading n by n block of the
+    Hessenberg matrix in modified Leja order.
+
+    The first shift is the Ritz value of largest modulus, each following one maximizes the product of its distances to the
+    shifts already taken. With real scalars the two values of a complex conjugate pair are kept together, the one with
+    positive imaginary part first, so that the basis can be computed in real arithmetic.
+*/
+static PetscErrorCode KSPCAGMRESComputeShifts(KSP ksp,PetscInt n)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+#if defined(PETSC_HAVE_ESSL)
+
+  PetscFunctionBegin;
+  ierr = PetscInfo(ksp,"The Newton basis is not available with ESSL, using the monomial basis\n");CHKERRQ(ierr);
+  cagmres->newton = PETSC_FALSE;
+  PetscFunctionReturn(0);
+#else
+  PetscInt       i,j,k,best;
+  PetscScalar    *H,*work,sdummy = 0;
+  PetscReal      *wr,*wi,logcap,bestcap = 0.0;
+  PetscBool      *used;
+  PetscBLASInt   bn,lwork,idummy = 1,lierr;
+#if defined(PETSC_USE_COMPLEX)
+  PetscScalar    *eigs;
+  PetscReal      *rwork;
+#endif
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(5*n,&lwork);CHKERRQ(ierr);
+  ierr = PetscMalloc5(n*n,&H,5*n,&work,n,&wr,n,&wi,n,&used);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {
+    for (i=0; i<n; i++) H[j*n+i] = *HES(i,j);
+  }
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+#if !defined(PETSC_USE_COMPLEX)
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","N",&bn,H,&bn,wr,wi,&sdummy,&idummy,&sdummy,&idummy,work,&lwork,&lierr));
+#else
+  ierr = PetscMalloc2(n,&eigs,2*n,&rwork);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","N",&bn,H,&bn,eigs,&sdummy,&idummy,&sdummy,&idummy,work,&lwork,rwork,&lierr));
+  for (i=0; i<n; i++) {
+    wr[i] = PetscRealPart(eigs[i]);
+    wi[i] = PetscImaginaryPart(eigs[i]);
+  }
+  ierr = PetscFree2(eigs,rwork);CHKERRQ(ierr);
+#endif
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (lierr) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)lierr);
+
+  for (i=0; i<n; i++) used[i] = PETSC_FALSE;
+  for (k=0; k<n;) {
+    best = -1;
+    for (i=0; i<n; i++) {
+      if (used[i]) continue;
+#if !defined(PETSC_USE_COMPLEX)
+      if (wi[i] < 0.0) continue; /* taken together with its conjugate */
+#endif
+      if (!k) logcap = PetscLogReal(PetscSqrtReal(wr[i]*wr[i] + wi[i]*wi[i]));
+      else {
+        logcap = 0.0;
+        for (j=0; j<k; j++) {
+          PetscReal dr = wr[i] - PetscRealPart(cagmres->shift[j]),di = wi[i] - cagmres->shifti[j];
+          logcap += PetscLogReal(PetscSqrtReal(dr*dr + di*di));
+        }
+      }
+      if (best < 0 || logcap > bestcap) {best = i; bestcap = logcap;}
+    }
+    if (best < 0) break;
+    used[best] = PETSC_TRUE;
+#if !defined(PETSC_USE_COMPLEX)
+    cagmres->shift[k]  = wr[best];
+    cagmres->shifti[k] = wi[best];
+    k++;
+    if (wi[best] > 0.0) {
+      if (k < n) {
+        cagmres->shift[k]  = wr[best];
+        cagmres->shifti[k] = -wi[best];
+        k++;
+      } else cagmres->shifti[k-1] = 0.0; /* no room for the conjugate, only the real part is used */
+    }
+#else
+    cagmres->shift[k]  = PetscCMPLX(wr[best],wi[best]);
+    cagmres->shifti[k] = wi[best];
+    k++;
+#endif
+  }
+  cagmres->nshifts = k;
+  ierr = PetscFree5(H,work,wr,wi,used);CHKERRQ(ierr);
+  ierr = PetscInfo1(ksp,"Computed %D shifts for the Newton basis\n",cagmres->nshifts);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+#endif
+}
+
+/*
+    KSPCAGMRESMatrixPowers - Computes the sb vectors w_{k+1} = (A - theta_k) w_k following w_0 = VEC_VV(it) into
+    VEC_VV(it+1), ..., VEC_VV(it+sb), and the change of basis matrix T such that A [w_0 ... w_{sb-1}] = [w_0 ... w_sb] T.
+
+    Without shifts this is the monomial basis. With real scalars a complex conjugate pair a +- ib uses the real recurrence
+    w_{k+2} = (A - a) w_{k+1} + b^2 w_k for its second vector.
+*/
+static PetscErrorCode KSPCAGMRESMatrixPowers(KSP ksp,PetscInt it,PetscInt sb)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       k;
+#if !defined(PETSC_USE_COMPLEX)
+  PetscBool      second = PETSC_FALSE;
+#endif
+
+  PetscFunctionBegin;
+  ierr = PetscArrayzero(cagmres->bchange,(cagmres->s+1)*cagmres->s);CHKERRQ(ierr);
+  for (k=0; k<sb; k++) {
+    ierr        = KSP_PCApplyBAorAB(ksp,VEC_VV(it+k),VEC_VV(it+k+1),VEC_TEMP_MATOP);CHKERRQ(ierr);
+    BCH(k+1,k) = 1.0;
+    if (k >= cagmres->nshifts) continue;
+#if !defined(PETSC_USE_COMPLEX)
+    if (second) {
+      PetscScalar alpha[2];
+
+      alpha[0]   = cagmres->shifti[k]*cagmres->shifti[k];
+      alpha[1]   = -cagmres->shift[k];
+      ierr       = VecMAXPY(VEC_VV(it+k+1),2,alpha,&VEC_VV(it+k-1));CHKERRQ(ierr);
+      BCH(k-1,k) = -alpha[0];
+      BCH(k,k)   = cagmres->shift[k];
+      second     = PETSC_FALSE;
+      continue;
+    }
+    second = (cagmres->shifti[k] > 0.0 && k+1 < sb && k+1 < cagmres->nshifts) ? PETSC_TRUE : PETSC_FALSE;
+#endif
+    ierr     = VecAXPY(VEC_VV(it+k+1),-cagmres->shift[k],VEC_VV(it+k));CHKERRQ(ierr);
+    BCH(k,k) = cagmres->shift[k];
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCAGMRESCholesky - Computes the Cholesky factor R of the Gram matrix of the block projected out of the nq previous
+    basis vectors, G = W^H W - C^H C, from the results of a reduction. The Gram matrix is equilibrated first, the condition
+    number of the block is then estimated by the ratio of the largest to the smallest diagonal entry of its factor.
+
+    Output Parameters:
++   p    - the number of leading columns of the block that could be factored, or that were accepted with truncate
+-   cond - the estimated condition number of these columns
+*/
+static PetscErrorCode KSPCAGMRESCholesky(KSP ksp,PetscInt nq,PetscInt sb,const PetscScalar *dots,PetscBool truncate,PetscInt *p,PetscReal *cond)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       r,c,i,np = sb;
+  PetscScalar    g;
+  PetscReal      dmin = 1.0,dmax = 1.0,d;
+  PetscBLASInt   bp,bs,info = 0;
+
+  PetscFunctionBegin;
+  for (c=0; c<sb; c++) {
+    for (r=0; r<=c; r++) {
+      g = DOTS(dots,nq+r,c);
+      for (i=0; i<nq; i++) g -= PetscConj(DOTS(dots,i,r))*DOTS(dots,i,c);
+      GRAM(r,c) = g;
+    }
+  }
+  for (c=0; c<sb; c++) {
+    d = PetscRealPart(GRAM(c,c));
+    if (!(d > 0.0) || PetscIsInfOrNanReal(d)) {np = c; break;}
+    cagmres->scale[c] = PetscSqrtReal(d);
+  }
+  ierr = PetscBLASIntCast(cagmres->s,&bs);CHKERRQ(ierr);
+  while (np) {
+    for (c=0; c<np; c++) {
+      for (r=0; r<=c; r++) CHOL(r,c) = GRAM(r,c)/(cagmres->scale[r]*cagmres->scale[c]);
+    }
+    ierr = PetscBLASIntCast(np,&bp);CHKERRQ(ierr);
+    ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+    PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("U",&bp,cagmres->chol,&bs,&info));
+    ierr = PetscFPTrapPop();CHKERRQ(ierr);
+    if (info < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine %d",(int)info);
+    if (!info) break;
+    np = info - 1; /* the leading minor of order info is not positive definite */
+  }
+  for (c=0; c<np; c++) {
+    d = PetscAbsScalar(CHOL(c,c));
+    if (truncate && 1.0/d > cagmres->condtol) {np = c; break;}
+    dmin = PetscMin(dmin,d);
+    dmax = PetscMax(dmax,d);
+  }
+  for (c=0; c<np; c++) {
+    for (r=0; r<=c; r++) CHOL(r,c) *= cagmres->scale[c];
+  }
+  *p    = np;
+  *cond = np ? dmax/dmin : PETSC_MAX_REAL;
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCAGMRESBlockOrthogonalize - Orthonormalizes the block W = [VEC_VV(it+1) ... VEC_VV(it+sb)] against the basis
+    Q = [VEC_VV(0) ... VEC_VV(it)] and within itself, in place, and computes the new columns it, ..., it+nb-1 of the
+    Hessenberg matrix.
+
+    The products [Q W]^H w_c of all the columns are computed with a single reduction, then W - Q C = Q_W R is obtained from
+    the Cholesky factor of W^H W - C^H C. If the factorization fails or the block is ill conditioned, the block is projected
+    explicitly and orthogonalized again with a second reduction, and only its columns that are well enough conditioned
+    are kept. Writing the block as [Q Q_W] Rb, the relation A [w_0 ... w_{nb-1}] = [w_0 ... w_nb] T gives
+    A [q_it ... q_{it+nb-1}] = [Q Q_W] (Rb T - [H B; 0]) U^{-1}, where H is the Hessenberg matrix computed so far, B the
+    coefficients of the block in its first it basis vectors and U the upper triangular coefficients in the others.
+*/
+static PetscErrorCode KSPCAGMRESBlockOrthogonalize(KSP ksp,PetscInt it,PetscInt sb,PetscInt *nb)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       nq = it+1,r,c,k,b,p;
+  PetscScalar    *work = cagmres->orthogwork,*csub = cagmres->dots,t,u;
+  PetscReal      cond;
+  PetscBool      reorth;
+  Vec            *V = &VEC_VV(0);
+
+  PetscFunctionBegin;
+  for (c=0; c<sb; c++) {ierr = VecMDotBegin(V[nq+c],nq+c+1,V,&DOTS(cagmres->dots,0,c));CHKERRQ(ierr);}
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)V[0]));CHKERRQ(ierr);
+  for (c=0; c<sb; c++) {ierr = VecMDotEnd(V[nq+c],nq+c+1,V,&DOTS(cagmres->dots,0,c));CHKERRQ(ierr);}
+  ierr = KSPCAGMRESCholesky(ksp,nq,sb,cagmres->dots,PETSC_FALSE,&p,&cond);CHKERRQ(ierr);
+  for (c=0; c<sb; c++) {
+    for (r=0; r<nq; r++) CTOT(r,c) = DOTS(cagmres->dots,r,c);
+  }
+
+  reorth = (p < sb || cond > cagmres->condtol) ? PETSC_TRUE : PETSC_FALSE;
+  if (reorth) {
+    for (c=0; c<sb; c++) {
+      for (r=0; r<nq; r++) work[r] = -DOTS(cagmres->dots,r,c);
+      ierr = VecMAXPY(V[nq+c],nq,work,V);CHKERRQ(ierr);
+    }
+    for (c=0; c<sb; c++) {ierr = VecMDotBegin(V[nq+c],nq+c+1,V,&DOTS(cagmres->dots2,0,c));CHKERRQ(ierr);}
+    ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)V[0]));CHKERRQ(ierr);
+    for (c=0; c<sb; c++) {ierr = VecMDotEnd(V[nq+c],nq+c+1,V,&DOTS(cagmres->dots2,0,c));CHKERRQ(ierr);}
+    ierr = KSPCAGMRESCholesky(ksp,nq,sb,cagmres->dots2,PETSC_TRUE,&p,&cond);CHKERRQ(ierr);
+    for (c=0; c<sb; c++) {
+      for (r=0; r<nq; r++) CTOT(r,c) += DOTS(cagmres->dots2,r,c);
+    }
+    csub = cagmres->dots2;
+  }
+  if (cagmres->monitorbasis) {
+    PetscViewer viewer = PETSC_VIEWER_STDOUT_(PetscObjectComm((PetscObject)ksp));
+
+    ierr = PetscViewerASCIIAddTab(viewer,((PetscObject)ksp)->tablevel);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  CA-GMRES %s basis from iteration %D: %D of %D vectors kept, estimated condition number %.1e%s\n",cagmres->nshifts ? "Newton" : "monomial",ksp->its,p,sb,(double)cond,reorth ? " after reorthogonalization" : "");CHKERRQ(ierr);
+    ierr = PetscViewerASCIISubtractTab(viewer,((PetscObject)ksp)->tablevel);CHKERRQ(ierr);
+  }
+
+  /* the orthonormal basis of the block in place, q_{nq+c} = (w_c - Q csub(:,c) - sum_{r<c} q_{nq+r} R(r,c))/R(c,c) */
+  for (c=0; c<p; c++) {
+    for (r=0; r<nq; r++) work[r] = -DOTS(csub,r,c);
+    for (r=0; r<c; r++) work[nq+r] = -CHOL(r,c);
+    ierr = VecMAXPY(V[nq+c],nq+c,work,V);CHKERRQ(ierr);
+    ierr = VecScale(V[nq+c],1.0/CHOL(c,c));CHKERRQ(ierr);
+  }
+  /* no column could be kept, A q_it is in the span of the basis: the single new column has a zero subdiagonal entry */
+  if (!p) CHOL(0,0) = 0.0;
+  *nb = p ? p : 1;
+
+  for (c=0; c<*nb; c++) {
+    ierr = PetscArrayzero(&HNEW(0,c),nq+c+1);CHKERRQ(ierr);
+    /* column c of Rb T */
+    for (k=PetscMax(c-1,0); k<=c+1; k++) {
+      t = BCH(k,c);
+      if (t == 0.0) continue;
+      if (!k) HNEW(it,c) += t;
+      else {
+        for (r=0; r<nq; r++) HNEW(r,c) += t*CTOT(r,k-1);
+        for (r=0; r<k; r++) HNEW(nq+r,c) += t*CHOL(r,k-1);
+      }
+    }
+    /* minus column c of H B */
+    if (c) {
+      for (b=0; b<it; b++) {
+        t = CTOT(b,c-1);
+        for (r=0; r<=b+1; r++) HNEW(r,c) -= *HES(r,b)*t;
+      }
+    }
+    /* times U^{-1} */
+    for (k=0; k<c; k++) {
+      u = k ? CHOL(k-1,c-1) : CTOT(it,c-1);
+      for (r=0; r<=it+k+1; r++) HNEW(r,c) -= HNEW(r,k)*u;
+    }
+    u = c ? CHOL(c-1,c-1) : 1.0;
+    for (r=0; r<nq+c+1; r++) {
+      HNEW(r,c) /= u;
+      *HH(r,it+c)  = HNEW(r,c);
+      *HES(r,it+c) = HNEW(r,c);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCAGMRESCycle - Runs CA-GMRES until convergence or the restart. On entry VEC_VV(0) is the initial residual.
+
+    Output Parameter:
+.   itcount - number of iterations used
+*/
+static PetscErrorCode KSPCAGMRESCycle(PetscInt *itcount,KSP ksp)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)(ksp->data);
+  PetscReal      res_norm,res,hapbnd,tt;
+  PetscErrorCode ierr;
+  PetscInt       it = 0,max_k = cagmres->max_k,sb,nb = 0,c;
+  PetscBool      hapend = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  ierr   = VecNormalize(VEC_VV(0),&res_norm);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,res_norm);
+  res    = res_norm;
+  *RS(0) = res_norm;
+
+  /* check for the convergence */
+  ierr        = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm  = res;
+  ierr        = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  cagmres->it = (it - 1);
+  ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    ierr        = PetscInfo(ksp,"Converged due to zero residual norm on entry\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  while (!ksp->reason && it < max_k && ksp->its < ksp->max_it) {
+    sb = PetscMin(cagmres->s,PetscMin(max_k - it,ksp->max_it - ksp->its));
+    while (cagmres->vv_allocated <= it + sb + VEC_OFFSET) {
+      ierr = KSPGMRESGetNewVectors(ksp,cagmres->vv_allocated - VEC_OFFSET);CHKERRQ(ierr);
+    }
+    ierr = KSPCAGMRESMatrixPowers(ksp,it,sb);CHKERRQ(ierr);
+    ierr = KSPCAGMRESBlockOrthogonalize(ksp,it,sb,&nb);CHKERRQ(ierr);
+
+    /* the least squares problem is updated one column at a time, exactly as in GMRES */
+    for (c=0; c<nb; c++) {
+      if (it) {
+        ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+        ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+      }
+      cagmres->it = (it - 1);
+
+      /* check for the happy breakdown */
+      tt     = PetscAbsScalar(*HH(it+1,it));
+      hapbnd = PetscAbsScalar(tt / *RS(it));
+      if (hapbnd > cagmres->haptol) hapbnd = cagmres->haptol;
+      if (tt < hapbnd) {
+        ierr   = PetscInfo2(ksp,"Detected happy breakdown, current hapbnd = %14.12e tt = %14.12e\n",(double)hapbnd,(double)tt);CHKERRQ(ierr);
+        hapend = PETSC_TRUE;
+      }
+      ierr = KSPCAGMRESUpdateHessenberg(ksp,it,hapend,&res);CHKERRQ(ierr);
+
+      it++;
+      cagmres->it = (it-1);   /* For converged */
+      ksp->its++;
+      ksp->rnorm  = res;
+      if (ksp->reason) break;
+
+      ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+
+      /* Catch error in happy breakdown and signal convergence and break from loop */
+      if (hapend) {
+        if (ksp->normtype == KSP_NORM_NONE) { /* convergence test was skipped in this case */
+          ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+        } else if (!ksp->reason) {
+          if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the happy break down, but convergence was not indicated. Residual norm = %g",(double)res);
+          else ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        }
+      }
+      if (ksp->reason) break;
+    }
+    /* the Ritz values of the first s iterations give the shifts of the Newton basis */
+    if (!ksp->reason && cagmres->newton && !cagmres->nshifts && it >= cagmres->s) {
+      ierr = KSPCAGMRESComputeShifts(ksp,cagmres->s);CHKERRQ(ierr);
+    }
+  }
+
+  /* Monitor if we know that we will not return for a restart */
+  if (it && (ksp->reason || ksp->its >= ksp->max_it)) {
+    ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  }
+
+  if (itcount) *itcount = it;
+
+  /* Form the solution (or the solution so far) */
+  ierr = KSPCAGMRESBuildSoln(RS(0),ksp->vec_sol,ksp->vec_sol,ksp,it-1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_CAGMRES(KSP ksp)
+{
+  PetscErrorCode ierr;
+  PetscInt       its,itcount;
+  KSP_CAGMRES    *cagmres   = (KSP_CAGMRES*)ksp->data;
+  PetscBool      guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  if (ksp->calc_sings && !cagmres->Rsvd) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ORDER,"Must call KSPSetComputeSingularValues() before KSPSetUp() is called");
+  ierr     = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr     = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+  /* the operator may have changed since the last solve, the shifts are computed again */
+  cagmres->nshifts = 0;
+  itcount          = 0;
+  ksp->reason      = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    ierr     = KSPInitialResidual(ksp,ksp->vec_sol,VEC_TEMP,VEC_TEMP_MATOP,VEC_VV(0),ksp->vec_rhs);CHKERRQ(ierr);
+    ierr     = KSPCAGMRESCycle(&its,ksp);CHKERRQ(ierr);
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree5(cagmres->dots,cagmres->dots2,cagmres->ctot,cagmres->hnew,cagmres->bchange);CHKERRQ(ierr);
+  ierr = PetscFree5(cagmres->gram,cagmres->chol,cagmres->scale,cagmres->shift,cagmres->shifti);CHKERRQ(ierr);
+  cagmres->nshifts = 0;
+  ierr = KSPReset_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_CAGMRES(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPReset_CAGMRES(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroy_GMRES(ksp);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPCAGMRESSetSteps_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    KSPCAGMRESBuildSoln - create the solution from the starting vector and the
+                          current iterates.
+
+    Input parameters:
+        nrs - work area of size it + 1.
+        vguess  - index of initial guess
+        vdest - index of result.  Note that vguess may == vdest (replace
+                guess with the solution).
+        it - HH upper triangular part is a block of size (it+1) x (it+1)
+
+     This is an internal routine that knows about the CAGMRES internals.
+ */
+static PetscErrorCode KSPCAGMRESBuildSoln(PetscScalar *nrs,Vec vguess,Vec vdest,KSP ksp,PetscInt it)
+{
+  PetscScalar    tt;
+  PetscErrorCode ierr;
+  PetscInt       k,j;
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)(ksp->data);
+
+  PetscFunctionBegin;
+  if (it < 0) {                                 /* no cagmres steps have been performed */
+    ierr = VecCopy(vguess,vdest);CHKERRQ(ierr); /* VecCopy() is smart, exits immediately if vguess == vdest */
+    PetscFunctionReturn(0);
+  }
+  if (*HH(it,it) == 0.0) {
+    if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the break down in CAGMRES; HH(it,it) = 0");
+    else ksp->reason = KSP_DIVERGED_BREAKDOWN;
+
+    ierr = PetscInfo2(ksp,"Likely your matrix or preconditioner is singular. HH(it,it) is identically zero; it = %D RS(it) = %g\n",it,(double)PetscAbsScalar(*RS(it)));CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  /* solve the upper triangular system - RS is the right side and HH is
+     the upper triangular matrix  - put soln in nrs */
+  nrs[it] = *RS(it) / *HH(it,it);
+  for (k=it-1; k>=0; k--) {
+    tt = *RS(k);
+    for (j=k+1; j<=it; j++) tt -= *HH(k,j) * nrs[j];
+    nrs[k] = tt / *HH(k,k);
+  }
+
+  /* Accumulate the correction to the solution of the preconditioned problem in TEMP */
+  ierr = VecZeroEntries(VEC_TEMP);CHKERRQ(ierr);
+  ierr = VecMAXPY(VEC_TEMP,it+1,nrs,&VEC_VV(0));CHKERRQ(ierr);
+  ierr = KSPUnwindPreconditioner(ksp,VEC_TEMP,VEC_TEMP_MATOP);CHKERRQ(ierr);
+  /* add solution to previous solution */
+  if (vdest == vguess) {
+    ierr = VecAXPY(vdest,1.0,VEC_TEMP);CHKERRQ(ierr);
+  } else {
+    ierr = VecWAXPY(vdest,1.0,VEC_TEMP,vguess);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Do the scalar work for the orthogonalization.  Return new residual norm.
+ */
+static PetscErrorCode KSPCAGMRESUpdateHessenberg(KSP ksp,PetscInt it,PetscBool hapend,PetscReal *res)
+{
+  PetscScalar *hh,*cc,*ss,tt;
+  PetscInt    j;
+  KSP_CAGMRES *cagmres = (KSP_CAGMRES*)(ksp->data);
+
+  PetscFunctionBegin;
+  hh = HH(0,it);
+  cc = CC(0);
+  ss = SS(0);
+
+  /* Apply all the previously computed plane rotations to the new column
+     of the Hessenberg matrix */
+  for (j=1; j<=it; j++) {
+    tt  = *hh;
+    *hh = PetscConj(*cc) * tt + *ss * *(hh+1);
+    hh++;
+    *hh = *cc++ * *hh - (*ss++ * tt);
+  }
+
+  /*
+    compute the new plane rotation, and apply it to:
+     1) the right-hand-side of the Hessenberg system
+     2) the new column of the Hessenberg matrix
+    thus obtaining the updated value of the residual
+  */
+  if (!hapend) {
+    tt = PetscSqrtScalar(PetscConj(*hh) * *hh + PetscConj(*(hh+1)) * *(hh+1));
+    if (tt == 0.0) {
+      if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"tt == 0.0");
+      else {
+        ksp->reason = KSP_DIVERGED_NULL;
+        PetscFunctionReturn(0);
+      }
+    }
+    *cc       = *hh / tt;
+    *ss       = *(hh+1) / tt;
+    *RS(it+1) = -(*ss * *RS(it));
+    *RS(it)   = PetscConj(*cc) * *RS(it);
+    *hh       = PetscConj(*cc) * *hh + *ss * *(hh+1);
+    *res      = PetscAbsScalar(*RS(it+1));
+  } else {
+    /* happy breakdown: HH(it+1, it) = 0, the residual of the least squares problem is zero */
+    *res = 0.0;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBuildSolution_CAGMRES(KSP ksp,Vec ptr,Vec *result)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!cagmres->sol_temp) {
+      ierr = VecDuplicate(ksp->vec_sol,&cagmres->sol_temp);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)cagmres->sol_temp);CHKERRQ(ierr);
+    }
+    ptr = cagmres->sol_temp;
+  }
+  if (!cagmres->nrs) {
+    /* allocate the work area */
+    ierr = PetscMalloc1(cagmres->max_k,&cagmres->nrs);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,cagmres->max_k*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+
+  ierr = KSPCAGMRESBuildSoln(cagmres->nrs,ksp->vec_sol,ptr,ksp,cagmres->it);CHKERRQ(ierr);
+  if (result) *result = ptr;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_CAGMRES(KSP ksp,PetscViewer viewer)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, s=%D, using the %s basis and block Cholesky QR orthogonalization\n",cagmres->max_k,cagmres->s,cagmres->newton ? "Newton" : "monomial");CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  happy breakdown tolerance %g\n",(double)cagmres->haptol);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer,"restart %D s %D",cagmres->max_k,cagmres->s);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_CAGMRES(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       s,restart;
+  PetscReal      haptol;
+  PetscBool      flg;
+
+  PetscFunctionBegin;
+  /* only the GMRES options that apply to CA-GMRES, the orthogonalization is always the block Cholesky QR */
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP CAGMRES Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_gmres_restart","Number of Krylov search directions","KSPGMRESSetRestart",cagmres->max_k,&restart,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGMRESSetRestart(ksp,restart);CHKERRQ(ierr);}
+  ierr = PetscOptionsReal("-ksp_gmres_haptol","Tolerance for exact convergence (happy ending)","KSPGMRESSetHapTol",cagmres->haptol,&haptol,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGMRESSetHapTol(ksp,haptol);CHKERRQ(ierr);}
+  flg  = PETSC_FALSE;
+  ierr = PetscOptionsBool("-ksp_gmres_preallocate","Preallocate Krylov vectors","KSPGMRESSetPreAllocateVectors",flg,&flg,NULL);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGMRESSetPreAllocateVectors(ksp);CHKERRQ(ierr);}
+  ierr = PetscOptionsInt("-ksp_cagmres_s","Number of basis vectors computed before each block orthogonalization","KSPCAGMRESSetSteps",cagmres->s,&s,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPCAGMRESSetSteps(ksp,s);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-ksp_cagmres_newton","Use the Newton basis with Leja ordered Ritz values as shifts","None",cagmres->newton,&cagmres->newton,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-ksp_cagmres_monitor_basis","Print the estimated condition number of each block of the basis","None",cagmres->monitorbasis,&cagmres->monitorbasis,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPCAGMRESSetSteps_CAGMRES(KSP ksp,PetscInt s)
+{
+  KSP_CAGMRES    *cagmres = (KSP_CAGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of steps %D must be positive",s);
+  if (!ksp->setupstage) {
+    cagmres->s = s;
+  } else if (cagmres->s != s) {
+    cagmres->s      = s;
+    ksp->setupstage = KSP_SETUP_NEW;
+    /* free the data structures, then create them again */
+    ierr = KSPReset_CAGMRES(ksp);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPCAGMRESSetSteps - Sets the number of basis vectors that KSPCAGMRES computes with the matrix powers kernel before
+   each block orthogonalization
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  s - the number of steps
+
+   Options Database:
+.  -ksp_cagmres_s <s>
+
+   Notes:
+   The default is 5. A block of s iterations needs one global reduction, or two when it has to be orthogonalized again,
+   instead of about 2 s for KSPGMRES. Larger values save more reductions but make the basis more ill conditioned, blocks
+   that cannot be orthogonalized accurately are shortened, see -ksp_cagmres_monitor_basis. The number of steps of each
+   block is also limited by the restart, see KSPGMRESSetRestart().
+
+   Level: intermediate
+
+.seealso: KSPCAGMRES, KSPGMRESSetRestart(), KSPCACGSetSteps()
+@*/
+PetscErrorCode KSPCAGMRESSetSteps(KSP ksp,PetscInt s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,s,2);
+  ierr = PetscTryMethod(ksp,"KSPCAGMRESSetSteps_C",(KSP,PetscInt),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+     KSPCAGMRES - Implements the communication-avoiding s-step Generalized Minimal Residual method.
+
+   Options Database Keys:
++   -ksp_gmres_restart <restart> - the number of Krylov directions to orthogonalize against
+.   -ksp_gmres_haptol <tol> - sets the tolerance for "happy ending" (exact convergence)
+.   -ksp_gmres_preallocate - preallocate all the Krylov search directions initially (otherwise groups of
+                             vectors are allocated as needed)
+.   -ksp_cagmres_s <s> - the number of basis vectors computed before each block orthogonalization
+.   -ksp_cagmres_newton <true,false> - use the Newton basis, with the Ritz values of the first s iterations as shifts, instead of the monomial basis
+-   -ksp_cagmres_monitor_basis - print the estimated condition number of each block of the basis
+
+   Level: intermediate
+
+   Notes:
+   Each block of s iterations applies the preconditioned operator s times in a row to compute the next s basis vectors,
+   then orthogonalizes them against the previous basis vectors and within the block with a single global reduction (block
+   classical Gram-Schmidt followed by Cholesky QR), so it needs about 2 s times fewer reductions than KSPGMRES. The
+   iterates are those of KSPGMRES in exact arithmetic, and the convergence test and monitors still see every iteration.
+
+   The first s iterations use the monomial basis, the next ones the Newton basis whose shifts are the Ritz values of these
+   first iterations in Leja order, which keeps the basis much better conditioned. A block whose Cholesky factorization
+   fails or whose estimated condition number is too large is orthogonalized again with a second reduction and, if needed,
+   shortened to its well conditioned leading vectors. -ksp_cagmres_monitor_basis prints what happens to each block.
+
+   Reference:
+   M. Hoemmen, Communication-avoiding Krylov subspace methods, PhD thesis, University of California, Berkeley, 2010.
+
+   Developer Notes:
+    This object is subclassed off of KSPGMRES
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPPGMRES, KSPCACG,
+           KSPCAGMRESSetSteps(), KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors()
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_CAGMRES(KSP ksp)
+{
+  KSP_CAGMRES    *cagmres;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNewLog(ksp,&cagmres);CHKERRQ(ierr);
+
+  ksp->data                              = (void*)cagmres;
+  ksp->ops->buildsolution                = KSPBuildSolution_CAGMRES;
+  ksp->ops->setup                        = KSPSetUp_CAGMRES;
+  ksp->ops->solve                        = KSPSolve_CAGMRES;
+  ksp->ops->reset                        = KSPReset_CAGMRES;
+  ksp->ops->destroy                      = KSPDestroy_CAGMRES;
+  ksp->ops->view                         = KSPView_CAGMRES;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_CAGMRES;
+  ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_GMRES;
+  ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_GMRES;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_RIGHT,1);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetPreAllocateVectors_C",KSPGMRESSetPreAllocateVectors_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",KSPGMRESGetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetHapTol_C",KSPGMRESSetHapTol_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPCAGMRESSetSteps_C",KSPCAGMRESSetSteps_CAGMRES);CHKERRQ(ierr);
+
+  cagmres->nextra_vecs    = 1;
+  cagmres->haptol         = 1.0e-30;
+  cagmres->q_preallocate  = 0;
+  cagmres->delta_allocate = CAGMRES_DELTA_DIRECTIONS;
+  cagmres->orthog         = NULL;
+  cagmres->nrs            = NULL;
+  cagmres->sol_temp       = NULL;
+  cagmres->max_k          = CAGMRES_DEFAULT_MAXK;
+  cagmres->Rsvd           = NULL;
+  cagmres->orthogwork     = NULL;
+  cagmres->cgstype        = KSP_GMRES_CGS_REFINE_NEVER;
+  cagmres->s              = CAGMRES_DEFAULT_S;
+  cagmres->newton         = PETSC_TRUE;
+  cagmres->monitorbasis   = PETSC_FALSE;
+  cagmres->condtol        = PetscPowReal(PETSC_MACHINE_EPSILON,-0.25);
+  PetscFunctionReturn(0);
+}
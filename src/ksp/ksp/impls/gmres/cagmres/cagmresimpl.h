@@ -0,0 +1,42 @@
+#if !defined(__CAGMRES)
+#define __CAGMRES
+
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+
+typedef struct {
+  KSPGMRESHEADER
+
+  /* communication-avoiding part */
+  PetscInt    s;                   /* number of basis vectors computed with the matrix powers kernel before each block orthogonalization */
+  PetscBool   newton;              /* use the Newton basis once Ritz values are available, otherwise the monomial basis */
+  PetscBool   monitorbasis;        /* print the estimated condition number of each block of the basis */
+  PetscInt    nshifts;             /* number of Leja ordered Ritz values, 0 until they are computed */
+  PetscScalar *shift;              /* the shifts of the Newton basis */
+  PetscReal   *shifti;             /* imaginary parts of the shifts, complex conjugate pairs are consecutive (real scalars only) */
+  PetscScalar *dots,*dots2;        /* the results of the single reduction of each orthogonalization pass */
+  PetscScalar *ctot;               /* the coefficients of the block in the previous basis vectors */
+  PetscScalar *gram,*chol;         /* the Gram matrix of the block and its Cholesky factor */
+  PetscReal   *scale;              /* the norms of the columns of the block, used to equilibrate its Gram matrix */
+  PetscScalar *bchange;            /* the change of basis matrix of the matrix powers kernel */
+  PetscScalar *hnew;               /* the new columns of the Hessenberg matrix */
+  PetscReal   condtol;             /* reorthogonalize the block if its estimated condition number is larger */
+} KSP_CAGMRES;
+
+#define HH(a,b)  (cagmres->hh_origin + (b)*(cagmres->max_k+2)+(a))
+/* HH will be size (max_k+2)*(max_k+1)  -  think of HH as
+   being stored columnwise for access purposes. */
+#define HES(a,b) (cagmres->hes_origin + (b)*(cagmres->max_k+1)+(a))
+/* HES will be size (max_k + 1) * (max_k + 1) -
+   again, think of HES as being stored columnwise */
+#define CC(a)    (cagmres->cc_origin + (a)) /* CC will be length (max_k+1) - cosines */
+#define SS(a)    (cagmres->ss_origin + (a)) /* SS will be length (max_k+1) - sines */
+#define RS(a)    (cagmres->rs_origin + (a)) /* RS will be length (max_k+2) - rt side */
+
+/* vector names */
+#define VEC_OFFSET     2
+#define VEC_TEMP       cagmres->vecs[0]               /* work space */
+#define VEC_TEMP_MATOP cagmres->vecs[1]               /* work space */
+#define VEC_VV(i)      cagmres->vecs[VEC_OFFSET+i]    /* use to access
+                                                         othog basis vectors */
+#endif
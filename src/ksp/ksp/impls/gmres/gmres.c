@@ -29,6 +29,7 @@
  */
 
 #include <../src/ksp/ksp/impls/gmres/gmresimpl.h>       /*I  "petscksp.h"  I*/
+#include <petsc/private/pcimpl.h>
 #define GMRES_DELTA_DIRECTIONS 10
 #define GMRES_DEFAULT_MAXK     30
 static PetscErrorCode KSPGMRESUpdateHessenberg(KSP,PetscInt,PetscBool,PetscReal*);
@@ -263,6 +264,239 @@ PetscErrorCode KSPSolve_GMRES(KSP ksp)
   PetscFunctionReturn(0);
 }
 
+/*
+     KSPMatSolveNorms_GMRES - Computes the 2-norm of each column of V in a single reduction
+*/
+static PetscErrorCode KSPMatSolveNorms_GMRES(KSP ksp,Mat V,PetscScalar *dots,PetscReal *nrm)
+{
+  PetscErrorCode    ierr;
+  PetscInt          m,N,i,j,ldv;
+  const PetscScalar *va,*v;
+
+  PetscFunctionBegin;
+  ierr = MatGetLocalSize(V,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(V,NULL,&N);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(V,&ldv);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(V,&va);CHKERRQ(ierr);
+  for (j=0; j<N; j++) {
+    v       = va + j*ldv;
+    dots[j] = 0.0;
+    for (i=0; i<m; i++) dots[j] += v[i]*PetscConj(v[i]);
+  }
+  ierr = MatDenseRestoreArrayRead(V,&va);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(dots,dots+N,N,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  for (j=0; j<N; j++) nrm[j] = PetscSqrtReal(PetscRealPart(dots[N+j]));
+  PetscFunctionReturn(0);
+}
+
+/*
+     KSPMatSolve_GMRES - Runs restarted GMRES on all the columns of B at once. Each column has its own Krylov basis, Hessenberg
+     matrix and convergence test, as in KSPSolve_GMRES(), but an iteration multiplies the whole block by the operator and the
+     preconditioner, with MatMatMult() and PCMatApply(), and orthogonalizes all the columns with classical Gram-Schmidt in one
+     reduction per pass. The orthogonalization routine of KSPGMRESSetOrthogonalization() is not used; a second pass is done
+     unless the refinement type of KSPGMRESSetCGSRefinementType() is KSP_GMRES_CGS_REFINE_NEVER.
+*/
+static PetscErrorCode KSPMatSolve_GMRES(KSP ksp,Mat B,Mat X)
+{
+  PetscErrorCode     ierr;
+  KSP_GMRES          *gmres = (KSP_GMRES*)ksp->data;
+  PetscInt           max_k = gmres->max_k,ldh = gmres->max_k+1,m,N,i,j,k,l,pass,npass,active,*nk,*ldv,ldt,ldx;
+  Mat                Amat,Pmat,*V,T,C,W = NULL;
+  PetscScalar        **va,*hh,*cc,*ss,*g,*dots,*y,*ta,*xa,*h,*c,*s,*gj,*v,*w,*t,tt;
+  PetscReal          *res,*res0,hapbnd,nrm;
+  KSPConvergedReason *reason;
+  PetscBool          first = PETSC_TRUE,happy;
+  MPI_Comm           comm;
+
+  PetscFunctionBegin;
+  if (ksp->pc_side == PC_SYMMETRIC) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"KSPMatSolve() with GMRES does not support symmetric preconditioning");
+  ierr  = PetscObjectGetComm((PetscObject)ksp,&comm);CHKERRQ(ierr);
+  ierr  = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr  = MatGetLocalSize(B,&m,NULL);CHKERRQ(ierr);
+  ierr  = MatGetSize(B,NULL,&N);CHKERRQ(ierr);
+  ierr  = PetscMalloc6(N*ldh*max_k,&hh,N*max_k,&cc,N*max_k,&ss,N*ldh,&g,2*N*ldh,&dots,ldh,&y);CHKERRQ(ierr);
+  ierr  = PetscMalloc6(ldh,&V,ldh,&va,ldh,&ldv,N,&nk,2*N,&res,N,&reason);CHKERRQ(ierr);
+  res0  = res + N;
+  for (i=0; i<=max_k; i++) {ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&V[i]);CHKERRQ(ierr);}
+  ierr  = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&T);CHKERRQ(ierr);
+  npass = gmres->cgstype == KSP_GMRES_CGS_REFINE_NEVER ? 1 : 2;
+
+  ksp->its = 0;
+  do {
+    /* v_0 <- B^{-1}(b - A x) with left preconditioning, b - A x with right preconditioning */
+    ierr = MatCopy(B,T,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    if (!first || !ksp->guess_zero) {
+      ierr = PCMatProduct_Private(Amat,X,MATPRODUCT_AB,&W);CHKERRQ(ierr);
+      ierr = MatAXPY(T,-1.0,W,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    }
+    if (ksp->pc_side == PC_LEFT) {ierr = PCMatApply(ksp->pc,T,V[0]);CHKERRQ(ierr);}
+    else {ierr = MatCopy(T,V[0],SAME_NONZERO_PATTERN);CHKERRQ(ierr);}
+    ierr = KSPMatSolveNorms_GMRES(ksp,V[0],dots,res);CHKERRQ(ierr);
+    if (first) {
+      ierr = KSPMatSolveConverged_Private(ksp,B,0,N,res,res0,reason,&active);CHKERRQ(ierr);
+      if (!active) break;
+    }
+
+    /* the columns still iterating start a new Krylov space */
+    ierr   = MatDenseGetLDA(V[0],&ldv[0]);CHKERRQ(ierr);
+    ierr   = MatDenseGetArray(V[0],&va[0]);CHKERRQ(ierr);
+    active = 0;
+    for (j=0; j<N; j++) {
+      nk[j] = 0;
+      if (reason[j]) continue;
+      if (res[j] == 0.0) {
+        reason[j] = KSP_CONVERGED_ATOL;
+        continue;
+      }
+      g[j*ldh] = res[j];
+      v        = va[0] + j*ldv[0];
+      for (l=0; l<m; l++) v[l] /= res[j];
+      active++;
+    }
+    ierr = MatDenseRestoreArray(V[0],&va[0]);CHKERRQ(ierr);
+    if (!active) {
+      ierr = KSPMatSolveConverged_Private(ksp,B,ksp->its,N,res,res0,reason,&active);CHKERRQ(ierr);
+      break;
+    }
+
+    for (k=0; k<max_k && active; k++) {
+      if (ksp->pc_side == PC_LEFT) {
+        ierr = PCMatProduct_Private(Amat,V[k],MATPRODUCT_AB,&W);CHKERRQ(ierr);
+        ierr = PCMatApply(ksp->pc,W,V[k+1]);CHKERRQ(ierr);
+      } else {
+        ierr = PCMatApply(ksp->pc,V[k],T);CHKERRQ(ierr);
+        ierr = PCMatProduct_Private(Amat,T,MATPRODUCT_AB,&W);CHKERRQ(ierr);
+        ierr = MatCopy(W,V[k+1],SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+      }
+
+      /* classical Gram-Schmidt of v_{k+1} against v_0 .. v_k, the inner products of all the columns in one reduction */
+      for (i=0; i<=k+1; i++) {
+        ierr = MatDenseGetLDA(V[i],&ldv[i]);CHKERRQ(ierr);
+        ierr = MatDenseGetArray(V[i],&va[i]);CHKERRQ(ierr);
+      }
+      for (pass=0; pass<npass; pass++) {
+        for (j=0; j<N; j++) {
+          w = va[k+1] + j*ldv[k+1];
+          for (i=0; i<=k; i++) {
+            v  = va[i] + j*ldv[i];
+            tt = 0.0;
+            if (!reason[j]) for (l=0; l<m; l++) tt += w[l]*PetscConj(v[l]);
+            dots[j*(k+1)+i] = tt;
+          }
+        }
+        ierr = MPIU_Allreduce(dots,dots+N*(k+1),N*(k+1),MPIU_SCALAR,MPIU_SUM,comm);CHKERRQ(ierr);
+        for (j=0; j<N; j++) {
+          if (reason[j]) continue;
+          w = va[k+1] + j*ldv[k+1];
+          h = hh + (j*max_k+k)*ldh;
+          for (i=0; i<=k; i++) {
+            tt   = dots[N*(k+1)+j*(k+1)+i];
+            h[i] = pass ? h[i] + tt : tt;
+            v    = va[i] + j*ldv[i];
+            for (l=0; l<m; l++) w[l] -= tt*v[l];
+          }
+        }
+      }
+      for (j=0; j<N; j++) {
+        w       = va[k+1] + j*ldv[k+1];
+        dots[j] = 0.0;
+        if (!reason[j]) for (l=0; l<m; l++) dots[j] += w[l]*PetscConj(w[l]);
+      }
+      ierr = MPIU_Allreduce(dots,dots+N,N,MPIU_SCALAR,MPIU_SUM,comm);CHKERRQ(ierr);
+
+      for (j=0; j<N; j++) {
+        if (reason[j]) continue;
+        w      = va[k+1] + j*ldv[k+1];
+        h      = hh + (j*max_k+k)*ldh;
+        c      = cc + j*max_k;
+        s      = ss + j*max_k;
+        gj     = g + j*ldh;
+        nrm    = PetscSqrtReal(PetscRealPart(dots[N+j]));
+        h[k+1] = nrm;
+        if (nrm != 0.0) for (l=0; l<m; l++) w[l] /= nrm;
+
+        /* check for the happy breakdown */
+        hapbnd = PetscMin(PetscAbsScalar(nrm/gj[k]),gmres->haptol);
+        happy  = (PetscBool)(nrm < hapbnd);
+
+        /* apply the previous plane rotations to the new column of the Hessenberg matrix, then the new one */
+        for (i=0; i<k; i++) {
+          tt     = h[i];
+          h[i]   = PetscConj(c[i])*tt + s[i]*h[i+1];
+          h[i+1] = c[i]*h[i+1] - s[i]*tt;
+        }
+        if (happy) {
+          res[j] = 0.0;
+          if (ksp->normtype == KSP_NORM_NONE) reason[j] = KSP_CONVERGED_HAPPY_BREAKDOWN;
+        } else {
+          tt = PetscSqrtScalar(PetscConj(h[k])*h[k] + PetscConj(h[k+1])*h[k+1]);
+          if (tt == 0.0) {
+            reason[j] = KSP_DIVERGED_NULL;
+            continue;
+          }
+          c[k]    = h[k]/tt;
+          s[k]    = h[k+1]/tt;
+          gj[k+1] = -(s[k]*gj[k]);
+          gj[k]   = PetscConj(c[k])*gj[k];
+          h[k]    = PetscConj(c[k])*h[k] + s[k]*h[k+1];
+          res[j]  = PetscAbsScalar(gj[k+1]);
+        }
+        nk[j] = k+1;
+      }
+      for (i=0; i<=k+1; i++) {ierr = MatDenseRestoreArray(V[i],&va[i]);CHKERRQ(ierr);}
+      ksp->its++;
+      ierr = KSPMatSolveConverged_Private(ksp,B,ksp->its,N,res,res0,reason,&active);CHKERRQ(ierr);
+    }
+
+    /* x <- x + V y, or x + B^{-1} V y with right preconditioning, where y solves the triangular system of each column */
+    ierr = MatDenseGetLDA(T,&ldt);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(T,&ta);CHKERRQ(ierr);
+    for (i=0; i<max_k; i++) {
+      ierr = MatDenseGetLDA(V[i],&ldv[i]);CHKERRQ(ierr);
+      ierr = MatDenseGetArrayRead(V[i],(const PetscScalar**)&va[i]);CHKERRQ(ierr);
+    }
+    for (j=0; j<N; j++) {
+      t = ta + j*ldt;
+      for (l=0; l<m; l++) t[l] = 0.0;
+      gj = g + j*ldh;
+      for (i=nk[j]-1; i>=0; i--) {
+        y[i] = gj[i];
+        for (k=i+1; k<nk[j]; k++) y[i] -= hh[(j*max_k+k)*ldh+i]*y[k];
+        tt   = hh[(j*max_k+i)*ldh+i];
+        y[i] = tt != 0.0 ? y[i]/tt : 0.0;
+      }
+      for (i=0; i<nk[j]; i++) {
+        v = va[i] + j*ldv[i];
+        for (l=0; l<m; l++) t[l] += y[i]*v[l];
+      }
+    }
+    for (i=0; i<max_k; i++) {ierr = MatDenseRestoreArrayRead(V[i],(const PetscScalar**)&va[i]);CHKERRQ(ierr);}
+    ierr = MatDenseRestoreArray(T,&ta);CHKERRQ(ierr);
+    if (ksp->pc_side == PC_RIGHT) {
+      ierr = PCMatApply(ksp->pc,T,V[0]);CHKERRQ(ierr);
+      C    = V[0];
+    } else C = T;
+    ierr = MatDenseGetLDA(C,&ldt);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(C,(const PetscScalar**)&ta);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(X,&xa);CHKERRQ(ierr);
+    for (j=0; j<N; j++) {
+      if (!nk[j]) continue;
+      for (l=0; l<m; l++) xa[j*ldx+l] += ta[j*ldt+l];
+    }
+    ierr  = MatDenseRestoreArray(X,&xa);CHKERRQ(ierr);
+    ierr  = MatDenseRestoreArrayRead(C,(const PetscScalar**)&ta);CHKERRQ(ierr);
+    first = PETSC_FALSE;
+  } while (active);
+
+  for (i=0; i<=max_k; i++) {ierr = MatDestroy(&V[i]);CHKERRQ(ierr);}
+  ierr = MatDestroy(&T);CHKERRQ(ierr);
+  ierr = MatDestroy(&W);CHKERRQ(ierr);
+  ierr = PetscFree6(hh,cc,ss,g,dots,y);CHKERRQ(ierr);
+  ierr = PetscFree6(V,va,ldv,nk,res,reason);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode KSPReset_GMRES(KSP ksp)
 {
   KSP_GMRES      *gmres = (KSP_GMRES*)ksp->data;
@@ -290,6 +524,7 @@ PetscErrorCode KSPReset_GMRES(KSP ksp)
   ierr = PetscFree(gmres->Rsvd);CHKERRQ(ierr);
   ierr = PetscFree(gmres->Dsvd);CHKERRQ(ierr);
   ierr = PetscFree(gmres->orthogwork);CHKERRQ(ierr);
+  ierr = PetscFree(gmres->orthoggram);CHKERRQ(ierr);
 
   gmres->vv_allocated   = 0;
   gmres->vecs_allocated = 0;
@@ -515,6 +750,10 @@ PetscErrorCode KSPView_GMRES(KSP ksp,PetscViewer viewer)
     }
   } else if (gmres->orthog == KSPGMRESModifiedGramSchmidtOrthogonalization) {
     cstr = "Modified Gram-Schmidt Orthogonalization";
+  } else if (gmres->orthog == KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization) {
+    cstr = "Low-synchronization Classical (unmodified) Gram-Schmidt Orthogonalization with one step of iterative refinement in a single reduction";
+  } else if (gmres->orthog == KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization) {
+    cstr = "Low-synchronization Modified Gram-Schmidt Orthogonalization in a single reduction";
   } else {
     cstr = "unknown orthogonalization";
   }
@@ -587,8 +826,12 @@ PetscErrorCode KSPSetFromOptions_GMRES(PetscOptionItems *PetscOptionsObject,KSP
   if (flg) {ierr = KSPGMRESSetPreAllocateVectors(ksp);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroupBegin("-ksp_gmres_classicalgramschmidt","Classical (unmodified) Gram-Schmidt (fast)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESClassicalGramSchmidtOrthogonalization);CHKERRQ(ierr);}
-  ierr = PetscOptionsBoolGroupEnd("-ksp_gmres_modifiedgramschmidt","Modified Gram-Schmidt (slow,more stable)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
+  ierr = PetscOptionsBoolGroup("-ksp_gmres_modifiedgramschmidt","Modified Gram-Schmidt (slow,more stable)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESModifiedGramSchmidtOrthogonalization);CHKERRQ(ierr);}
+  ierr = PetscOptionsBoolGroup("-ksp_gmres_lowsyncclassicalgramschmidt","Classical Gram-Schmidt with refinement in one reduction","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization);CHKERRQ(ierr);}
+  ierr = PetscOptionsBoolGroupEnd("-ksp_gmres_lowsyncmodifiedgramschmidt","Modified Gram-Schmidt in one reduction","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization);CHKERRQ(ierr);}
   ierr = PetscOptionsEnum("-ksp_gmres_cgs_refinement_type","Type of iterative refinement for classical (unmodified) Gram-Schmidt","KSPGMRESSetCGSRefinementType",
                           KSPGMRESCGSRefinementTypes,(PetscEnum)gmres->cgstype,(PetscEnum*)&gmres->cgstype,&flg);CHKERRQ(ierr);
   flg  = PETSC_FALSE;
@@ -838,6 +1081,8 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
                              vectors are allocated as needed)
 .   -ksp_gmres_classicalgramschmidt - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space (fast) (the default)
 .   -ksp_gmres_modifiedgramschmidt - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
+.   -ksp_gmres_lowsyncclassicalgramschmidt - use classical Gram-Schmidt with one step of refinement, with a single reduction per iteration
+.   -ksp_gmres_lowsyncmodifiedgramschmidt - use modified Gram-Schmidt, with a single reduction per iteration
 .   -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - determine if iterative refinement is used to increase the
                                    stability of the classical Gram-Schmidt  orthogonalization.
 -   -ksp_gmres_krylov_monitor - plot the Krylov space generated
@@ -854,6 +1099,7 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPFGMRES, KSPLGMRES,
            KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetOrthogonalization(), KSPGMRESGetOrthogonalization(),
            KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(),
+           KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization(), KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization(),
            KSPGMRESCGSRefinementType, KSPGMRESSetCGSRefinementType(), KSPGMRESGetCGSRefinementType(), KSPGMRESMonitorKrylov(), KSPSetPCSide()
 
 M*/
@@ -876,6 +1122,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_GMRES(KSP ksp)
   ksp->ops->buildsolution                = KSPBuildSolution_GMRES;
   ksp->ops->setup                        = KSPSetUp_GMRES;
   ksp->ops->solve                        = KSPSolve_GMRES;
+  ksp->ops->matsolve                     = KSPMatSolve_GMRES;
   ksp->ops->reset                        = KSPReset_GMRES;
   ksp->ops->destroy                      = KSPDestroy_GMRES;
   ksp->ops->view                         = KSPView_GMRES;
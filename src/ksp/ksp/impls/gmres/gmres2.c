@@ -16,23 +16,29 @@ $   it is one minus the number of GMRES iterations since last restart;
 $    i.e. the size of Krylov space minus one
 
    Notes:
-   Two orthogonalization routines are predefined, including
+   Four orthogonalization routines are predefined, including
 
    KSPGMRESModifiedGramSchmidtOrthogonalization()
 
    KSPGMRESClassicalGramSchmidtOrthogonalization() - Default. Use KSPGMRESSetCGSRefinementType() to determine if
      iterative refinement is used to increase stability.
 
+   KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization() and KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization() -
+     Modified Gram-Schmidt and classical Gram-Schmidt with one step of refinement, with a single reduction per iteration.
+
 
    Options Database Keys:
 
 +  -ksp_gmres_classicalgramschmidt - Activates KSPGMRESClassicalGramSchmidtOrthogonalization() (default)
--  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+.  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+.  -ksp_gmres_lowsyncclassicalgramschmidt - Activates KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization()
+-  -ksp_gmres_lowsyncmodifiedgramschmidt - Activates KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization()
 
    Level: intermediate
 
 .seealso: KSPGMRESSetRestart(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetCGSRefinementType(), KSPGMRESSetOrthogonalization(),
-          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESGetCGSRefinementType()
+          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESGetCGSRefinementType(),
+          KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization(), KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization()
 @*/
 PetscErrorCode  KSPGMRESSetOrthogonalization(KSP ksp,PetscErrorCode (*fcn)(KSP,PetscInt))
 {
@@ -61,23 +67,29 @@ $   it is one minus the number of GMRES iterations since last restart;
 $    i.e. the size of Krylov space minus one
 
    Notes:
-   Two orthogonalization routines are predefined, including
+   Four orthogonalization routines are predefined, including
 
    KSPGMRESModifiedGramSchmidtOrthogonalization()
 
    KSPGMRESClassicalGramSchmidtOrthogonalization() - Default. Use KSPGMRESSetCGSRefinementType() to determine if
      iterative refinement is used to increase stability.
 
+   KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization() and KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization() -
+     Modified Gram-Schmidt and classical Gram-Schmidt with one step of refinement, with a single reduction per iteration.
+
 
    Options Database Keys:
 
 +  -ksp_gmres_classicalgramschmidt - Activates KSPGMRESClassicalGramSchmidtOrthogonalization() (default)
--  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+.  -ksp_gmres_modifiedgramschmidt - Activates KSPGMRESModifiedGramSchmidtOrthogonalization()
+.  -ksp_gmres_lowsyncclassicalgramschmidt - Activates KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization()
+-  -ksp_gmres_lowsyncmodifiedgramschmidt - Activates KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization()
 
    Level: intermediate
 
 .seealso: KSPGMRESSetRestart(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetCGSRefinementType(), KSPGMRESSetOrthogonalization(),
-          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESGetCGSRefinementType()
+          KSPGMRESModifiedGramSchmidtOrthogonalization(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESGetCGSRefinementType(),
+          KSPGMRESLowSyncModifiedGramSchmidtOrthogonalization(), KSPGMRESLowSyncClassicalGramSchmidtOrthogonalization()
 @*/
 PetscErrorCode  KSPGMRESGetOrthogonalization(KSP ksp,PetscErrorCode (**fcn)(KSP,PetscInt))
 {
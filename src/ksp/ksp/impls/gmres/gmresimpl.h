@@ -18,6 +18,7 @@
   PetscScalar *rs_origin;   /* holds the right-hand-side of the Hessenberg system */ \
                                                                         \
   PetscScalar *orthogwork; /* holds dot products computed in orthogonalization */ \
+  PetscScalar *orthoggram; /* holds the Gram matrix of the Krylov vectors computed by the low-synchronization orthogonalizations */ \
                                                                         \
   /* Work space for computing eigenvalues/singular values */            \
   PetscReal   *Dsvd;                                                    \
@@ -61,6 +62,8 @@ PETSC_INTERN PetscErrorCode KSPComputeRitz_GMRES(KSP,PetscBool,PetscBool,PetscIn
 PETSC_INTERN PetscErrorCode KSPReset_GMRES(KSP);
 PETSC_INTERN PetscErrorCode KSPDestroy_GMRES(KSP);
 PETSC_INTERN PetscErrorCode KSPGMRESGetNewVectors(KSP,PetscInt);
+PETSC_INTERN PetscErrorCode KSPGMRESLowSyncDots_Private(KSP,PetscInt,PetscScalar*,PetscReal*);
+PETSC_INTERN PetscErrorCode KSPGMRESLowSyncUpdate_Private(KSP,PetscInt,PetscScalar*,PetscReal);
 
 typedef PetscErrorCode (*FCN)(KSP,PetscInt); /* force argument to next function to not be extern C*/
 
@@ -80,6 +83,7 @@ PETSC_INTERN PetscErrorCode KSPGMRESGetCGSRefinementType_GMRES(KSP,KSPGMRESCGSRe
 #define CC(a)    (gmres->cc_origin + (a))
 #define SS(a)    (gmres->ss_origin + (a))
 #define GRS(a)   (gmres->rs_origin + (a))
+#define GRAM(a,b) (gmres->orthoggram + (b)*(gmres->max_k+1)+(a))
 
 /* vector names */
 #define VEC_OFFSET     2
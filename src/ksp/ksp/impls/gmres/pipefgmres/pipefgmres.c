@@ -128,8 +128,12 @@ static PetscErrorCode KSPPIPEFGMRESCycle(PetscInt *itcount,KSP ksp)
      (loc_it -1) is passed, so the two are equivalent */
   pipefgmres->it = (loc_it - 1);
 
-  /* initial residual is in VEC_VV(0)  - compute its norm*/
-  ierr = VecNorm(VEC_VV(0),NORM_2,&res_norm);CHKERRQ(ierr);
+  /* initial residual is in VEC_VV(0)  - compute its norm, together with the norm of the right hand side the convergence test may need */
+  ierr = VecNormBegin(VEC_VV(0),NORM_2,&res_norm);CHKERRQ(ierr);
+  ierr = KSPConvergedDefaultRHSNormBegin_Private(ksp);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(0)));CHKERRQ(ierr);
+  ierr = VecNormEnd(VEC_VV(0),NORM_2,&res_norm);CHKERRQ(ierr);
+  ierr = KSPConvergedDefaultRHSNormEnd_Private(ksp);CHKERRQ(ierr);
 
   /* first entry in right-hand-side of hessenberg system is just
      the initial residual norm */
@@ -196,6 +200,7 @@ static PetscErrorCode KSPPIPEFGMRESCycle(PetscInt *itcount,KSP ksp)
        with the results of the inner products.
        */
     ierr = KSP_PCApply(ksp,ZVEC(loc_it),Q);CHKERRQ(ierr);
+    ierr = PetscCommSplitReductionProgress(PetscObjectComm((PetscObject)ZVEC(loc_it)),NULL);CHKERRQ(ierr);
     ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
     ierr = KSP_MatMult(ksp,Amat,Q,W);CHKERRQ(ierr);
 
@@ -760,6 +760,146 @@ PetscErrorCode  KSPConvergedDefault(KSP ksp,PetscInt n,PetscReal rnorm,KSPConver
   PetscFunctionReturn(0);
 }
 
+/*
+   KSPMatSolveRHSNorms_Private - Computes the norms rnorm0[] of the columns of B that KSPConvergedDefault() would compute
+   for each of them at iteration 0: the norm of the right hand side, of the preconditioned right hand side or its natural
+   norm with a nonzero initial guess, and the initial residual norm rnorm[] otherwise
+*/
+static PetscErrorCode KSPMatSolveRHSNorms_Private(KSP ksp,Mat B,PetscInt n,const PetscReal rnorm[],PetscReal rnorm0[])
+{
+  PetscErrorCode         ierr;
+  KSPConvergedDefaultCtx *cctx = (KSPConvergedDefaultCtx*)ksp->cnvP;
+  Mat                    Z = NULL;
+  const PetscScalar      *ba,*za;
+  PetscScalar            *dots;
+  PetscInt               i,j,m,ldb,ldz;
+
+  PetscFunctionBegin;
+  for (j=0; j<n; j++) rnorm0[j] = rnorm[j];
+  if (ksp->guess_zero || ksp->converged != KSPConvergedDefault || !cctx || cctx->initialrtol || ksp->normtype == KSP_NORM_NONE) PetscFunctionReturn(0);
+  ierr = PetscInfo(ksp,"user has provided nonzero initial guess, computing norms of the right hand sides\n");CHKERRQ(ierr);
+  if (ksp->normtype != KSP_NORM_UNPRECONDITIONED && ksp->pc_side != PC_RIGHT) {
+    ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&Z);CHKERRQ(ierr);
+    ierr = PCMatApply(ksp->pc,B,Z);CHKERRQ(ierr);
+  }
+  /* b'*b, b'*B'*B*b or b'*B*b for all the columns in one reduction */
+  ierr = PetscMalloc1(2*n,&dots);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(B,&m,NULL);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(B,&ba);CHKERRQ(ierr);
+  if (Z) {
+    ierr = MatDenseGetLDA(Z,&ldz);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(Z,&za);CHKERRQ(ierr);
+  }
+  for (j=0; j<n; j++) {
+    const PetscScalar *b = ba + j*ldb,*z = Z ? za + j*ldz : b;
+
+    dots[n+j] = 0.0;
+    if (ksp->normtype == KSP_NORM_NATURAL) for (i=0; i<m; i++) dots[n+j] += z[i]*PetscConj(b[i]);
+    else for (i=0; i<m; i++) dots[n+j] += z[i]*PetscConj(z[i]);
+  }
+  ierr = MatDenseRestoreArrayRead(B,&ba);CHKERRQ(ierr);
+  if (Z) {
+    ierr = MatDenseRestoreArrayRead(Z,&za);CHKERRQ(ierr);
+    ierr = MatDestroy(&Z);CHKERRQ(ierr);
+  }
+  ierr = MPIU_Allreduce(dots+n,dots,n,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  for (j=0; j<n; j++) {
+    PetscReal snorm = PetscSqrtReal(PetscAbsScalar(dots[j]));
+
+    /* the special case of a zero right hand side and a nonzero guess */
+    if (!snorm) snorm = rnorm[j];
+    rnorm0[j] = cctx->mininitialrtol ? PetscMin(snorm,rnorm[j]) : snorm;
+  }
+  ierr = PetscFree(dots);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPMatSolveConverged_Private - Tests the convergence of each column of KSPMatSolve() as KSPConvergedDefault() does, relative to the
+   initial residual norm of the column or, with a nonzero initial guess, to the norm of its right hand side in B. A column gets a nonzero reason when it converges or diverges and is not tested any more; at the
+   last iteration the columns that are still iterating get KSP_DIVERGED_ITS. Sets ksp->its, ksp->rnorm to the largest residual norm of the
+   columns, active to the number of columns still iterating and, when there is none left, ksp->reason.
+*/
+PetscErrorCode KSPMatSolveConverged_Private(KSP ksp,Mat B,PetscInt it,PetscInt n,const PetscReal rnorm[],PetscReal rnorm0[],KSPConvergedReason reason[],PetscInt *active)
+{
+  PetscErrorCode ierr;
+  PetscInt       j;
+  PetscReal      max = 0.0;
+
+  PetscFunctionBegin;
+  *active = 0;
+  if (!it) {
+    ierr = KSPMatSolveRHSNorms_Private(ksp,B,n,rnorm,rnorm0);CHKERRQ(ierr);
+    for (j=0; j<n; j++) reason[j] = KSP_CONVERGED_ITERATING;
+  }
+  for (j=0; j<n; j++) {
+    max = PetscMax(max,rnorm[j]);
+    if (reason[j]) continue;
+    if (ksp->normtype == KSP_NORM_NONE) {
+    } else if (PetscIsInfOrNanReal(rnorm[j])) reason[j] = KSP_DIVERGED_NANORINF;
+    else if (rnorm[j] <= PetscMax(ksp->rtol*rnorm0[j],ksp->abstol)) reason[j] = rnorm[j] < ksp->abstol ? KSP_CONVERGED_ATOL : KSP_CONVERGED_RTOL;
+    else if (it && rnorm[j] >= ksp->divtol*rnorm0[j]) reason[j] = KSP_DIVERGED_DTOL;
+    if (!reason[j] && it >= ksp->max_it) reason[j] = ksp->normtype == KSP_NORM_NONE ? KSP_CONVERGED_ITS : KSP_DIVERGED_ITS;
+    if (!reason[j]) (*active)++;
+  }
+  ksp->its   = it;
+  ksp->rnorm = max;
+  ierr = PetscInfo3(ksp,"Iteration %D, largest residual norm %14.12e, %D columns still iterating\n",it,(double)max,*active);CHKERRQ(ierr);
+  if (!*active) {
+    /* the solve converged if all the columns did, otherwise it has the reason of the first column that did not */
+    ksp->reason = n ? reason[0] : KSP_CONVERGED_ITS;
+    for (j=0; j<n; j++) if (reason[j] < 0) {ksp->reason = reason[j]; break;}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPConvergedDefaultUsesRHSNorm_Private - Whether KSPConvergedDefault() will compute the 2-norm of the unpreconditioned
+   right hand side in its first call, which happens with a nonzero initial guess
+*/
+static PetscErrorCode KSPConvergedDefaultUsesRHSNorm_Private(KSP ksp,PetscBool *flg)
+{
+  KSPConvergedDefaultCtx *cctx = (KSPConvergedDefaultCtx*)ksp->cnvP;
+
+  PetscFunctionBegin;
+  *flg = PETSC_FALSE;
+  if (ksp->converged != KSPConvergedDefault || !cctx || ksp->its) PetscFunctionReturn(0);
+  if (ksp->guess_zero || cctx->initialrtol || ksp->normtype == KSP_NORM_NONE) PetscFunctionReturn(0);
+  if (ksp->normtype == KSP_NORM_UNPRECONDITIONED || ksp->pc_side == PC_RIGHT) *flg = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   KSPConvergedDefaultRHSNormBegin_Private - Queues the norm of the right hand side needed by the first call of
+   KSPConvergedDefault() in the split reduction of the vectors of ksp, so that a Krylov method can combine it with the
+   reduction of its initial residual norm. KSPConvergedDefaultRHSNormEnd_Private() must be called after the matching
+   VecxxxEnd() of the method; VecNormEnd() caches the norm in the vector so KSPConvergedDefault() does not communicate.
+*/
+PetscErrorCode KSPConvergedDefaultRHSNormBegin_Private(KSP ksp)
+{
+  PetscErrorCode ierr;
+  PetscBool      flg;
+  PetscReal      bnorm;
+
+  PetscFunctionBegin;
+  ierr = KSPConvergedDefaultUsesRHSNorm_Private(ksp,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = VecNormBegin(ksp->vec_rhs,NORM_2,&bnorm);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode KSPConvergedDefaultRHSNormEnd_Private(KSP ksp)
+{
+  PetscErrorCode ierr;
+  PetscBool      flg;
+  PetscReal      bnorm;
+
+  PetscFunctionBegin;
+  ierr = KSPConvergedDefaultUsesRHSNorm_Private(ksp,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = VecNormEnd(ksp->vec_rhs,NORM_2,&bnorm);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
 /*@C
    KSPConvergedDefaultDestroy - Frees the space used by the KSPConvergedDefault() function context
 
@@ -4,6 +4,7 @@
 */
 
 #include <petsc/private/kspimpl.h>   /*I "petscksp.h" I*/
+#include <petsc/private/pcimpl.h>
 #include <petscdm.h>
 
 PETSC_STATIC_INLINE PetscErrorCode ObjectView(PetscObject obj, PetscViewer viewer, PetscViewerFormat format)
@@ -888,6 +889,115 @@ PetscErrorCode KSPSolveTranspose(KSP ksp,Vec b,Vec x)
   PetscFunctionReturn(0);
 }
 
+/*@
+   KSPMatSolve - Solves a linear system with multiple right hand sides, stored as the columns of a dense matrix
+
+   Collective on ksp
+
+   Input Parameters:
++  ksp - iterative context obtained from KSPCreate()
+-  B - block of right hand sides, a MATSEQDENSE or MATMPIDENSE matrix
+
+   Output Parameter:
+.  X - block of solutions, a dense matrix of the same sizes as B, whose columns are the initial guesses with KSPSetInitialGuessNonzero()
+
+   Options Database Key:
+.  -ksp_converged_reason - prints the reason of the solve
+
+   Notes:
+   KSPCG and KSPGMRES iterate on all the columns at once: each iteration multiplies the whole block by the operator with MatMatMult(),
+   which goes through a MATAIJ matrix once for several columns, applies the preconditioner with PCMatApply() and computes the inner
+   products of all the columns in a single reduction. Each column keeps its own Krylov space and convergence test, so it takes the same
+   iterations as with KSPSolve(), and is not updated any more once it converged. KSPPREONLY applies PCMatApply() to B.
+   The other methods, and the solves with a convergence test other than KSPConvergedDefault(), diagonal scaling, a null space, a KSPGuess or a preconditioner with a presolve, call KSPSolve()
+   on each column.
+
+   The convergence of each column is tested with the tolerances of KSPSetTolerances(), as KSPConvergedDefault() does, and the monitors are not
+   called. KSPGetIterationNumber() gives the largest number of iterations of a column and KSPGetConvergedReason() the reason of a column that
+   did not converge, if there is one.
+
+   B and X must be different matrices.
+
+   Level: intermediate
+
+.seealso: KSPSolve(), PCMatApply(), MatMatSolve(), MatMatMult(), KSPHPDDMMatSolve(), MATDENSE
+@*/
+PetscErrorCode KSPMatSolve(KSP ksp,Mat B,Mat X)
+{
+  PetscErrorCode     ierr;
+  Mat                A,P;
+  MatNullSpace       nullsp,tnullsp;
+  PetscBool          match,diagonalscale,native;
+  PetscInt           m,n,mb,mx,Nb,Nx,j,ldb,ldx,its = 0;
+  Vec                b,x;
+  const PetscScalar  *ba;
+  PetscScalar        *xa;
+  KSPConvergedReason reason = KSP_CONVERGED_ITERATING;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidHeaderSpecific(B,MAT_CLASSID,2);
+  PetscValidHeaderSpecific(X,MAT_CLASSID,3);
+  PetscCheckSameComm(ksp,1,B,2);
+  PetscCheckSameComm(ksp,1,X,3);
+  if (B == X) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_IDN,"B and X must be different matrices");
+  ierr = PetscObjectTypeCompareAny((PetscObject)B,&match,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  if (!match) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Provided block of right hand sides not stored in a dense Mat");
+  ierr = PetscObjectTypeCompareAny((PetscObject)X,&match,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  if (!match) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Provided block of solutions not stored in a dense Mat");
+  ierr = KSPGetOperators(ksp,&A,&P);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(A,&m,&n);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(B,&mb,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(X,&mx,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(B,NULL,&Nb);CHKERRQ(ierr);
+  ierr = MatGetSize(X,NULL,&Nx);CHKERRQ(ierr);
+  if (mb != m) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Operator number of local rows %D does not equal block of right hand sides number of local rows %D",m,mb);
+  if (mx != n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Operator number of local columns %D does not equal block of solutions number of local rows %D",n,mx);
+  if (Nb != Nx) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Block of right hand sides number of columns %D does not equal block of solutions number of columns %D",Nb,Nx);
+
+  ierr = KSPSetUp(ksp);CHKERRQ(ierr);
+  ierr = KSPSetUpOnBlocks(ksp);CHKERRQ(ierr);
+  ierr = MatGetNullSpace(A,&nullsp);CHKERRQ(ierr);
+  ierr = MatGetTransposeNullSpace(P,&tnullsp);CHKERRQ(ierr);
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  native = (PetscBool)(ksp->ops->matsolve && ksp->converged == KSPConvergedDefault && !ksp->dscale && !diagonalscale && !nullsp && !tnullsp && !ksp->guess && !ksp->guess_knoll && !ksp->pc->ops->presolve);
+
+  ierr = PetscLogEventBegin(KSP_MatSolve,ksp,B,X,0);CHKERRQ(ierr);
+  if (native) {
+    ksp->reason = KSP_CONVERGED_ITERATING;
+    if (ksp->guess_zero) {ierr = MatZeroEntries(X);CHKERRQ(ierr);}
+    ierr = (*ksp->ops->matsolve)(ksp,B,X);CHKERRQ(ierr);
+    if (!ksp->reason) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_PLIB,"Internal error, solver returned without setting converged reason");
+    ksp->totalits += ksp->its;
+  } else {
+    /* one column at a time */
+    ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(B,&ba);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(X,&xa);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+    for (j=0; j<Nb; j++) {
+      ierr = VecPlaceArray(b,ba+j*ldb);CHKERRQ(ierr);
+      ierr = VecPlaceArray(x,xa+j*ldx);CHKERRQ(ierr);
+      ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+      ierr = VecResetArray(b);CHKERRQ(ierr);
+      ierr = VecResetArray(x);CHKERRQ(ierr);
+      its  = PetscMax(its,ksp->its);
+      if (reason >= 0) reason = ksp->reason;
+    }
+    ierr = MatDenseRestoreArrayRead(B,&ba);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(X,&xa);CHKERRQ(ierr);
+    ierr = VecDestroy(&x);CHKERRQ(ierr);
+    ierr = VecDestroy(&b);CHKERRQ(ierr);
+    ksp->its    = its;
+    ksp->reason = Nb ? reason : KSP_CONVERGED_ITS;
+  }
+  ierr = PetscLogEventEnd(KSP_MatSolve,ksp,B,X,0);CHKERRQ(ierr);
+  if (native && ksp->viewReason) {ierr = KSPReasonView_Internal(ksp,ksp->viewerReason,ksp->formatReason);CHKERRQ(ierr);}
+  if (ksp->errorifnotconverged && ksp->reason < 0 && ksp->reason != KSP_DIVERGED_ITS) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"KSPMatSolve has not converged, reason %s",KSPConvergedReasons[ksp->reason]);
+  PetscFunctionReturn(0);
+}
+
 /*@
    KSPResetViewers - Resets all the viewers set from the options database during KSPSetFromOptions()
 
@@ -0,0 +1,146 @@
+static char help[] = "Tests KSPMatSolve() against KSPSolve() on each column, with the 2D Laplacian on a DMDA.\n\n";
+
+#include <petscdmda.h>
+#include <petscksp.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  DM             da;
+  KSP            ksp;
+  Mat            A,B,X,X0;
+  Vec            b,x;
+  PetscRandom    rand;
+  MatStencil     row,col[5];
+  PetscScalar    v[5],*ba,*xa,*x0a;
+  PetscReal      nrm,err,maxerr = 0.0;
+  PetscInt       i,j,k,n = 4,mx,my,xs,ys,xm,ym,m,its,maxits = 0;
+  PetscBool      nonzero = PETSC_FALSE;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-nonzero_guess",&nonzero,NULL);CHKERRQ(ierr);
+
+  ierr = DMDACreate2d(PETSC_COMM_WORLD,DM_BOUNDARY_NONE,DM_BOUNDARY_NONE,DMDA_STENCIL_STAR,17,17,PETSC_DECIDE,PETSC_DECIDE,1,1,NULL,NULL,&da);CHKERRQ(ierr);
+  ierr = DMSetFromOptions(da);CHKERRQ(ierr);
+  ierr = DMSetUp(da);CHKERRQ(ierr);
+  ierr = DMCreateMatrix(da,&A);CHKERRQ(ierr);
+  ierr = DMDAGetInfo(da,NULL,&mx,&my,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+  ierr = DMDAGetCorners(da,&xs,&ys,NULL,&xm,&ym,NULL);CHKERRQ(ierr);
+  for (j=ys; j<ys+ym; j++) {
+    for (i=xs; i<xs+xm; i++) {
+      row.i = i; row.j = j;
+      k     = 0;
+      col[k].i = i; col[k].j = j; v[k++] = 4.0;
+      if (i > 0)    {col[k].i = i-1; col[k].j = j;   v[k++] = -1.0;}
+      if (i < mx-1) {col[k].i = i+1; col[k].j = j;   v[k++] = -1.0;}
+      if (j > 0)    {col[k].i = i;   col[k].j = j-1; v[k++] = -1.0;}
+      if (j < my-1) {col[k].i = i;   col[k].j = j+1; v[k++] = -1.0;}
+      ierr = MatSetValuesStencil(A,1,&row,k,col,v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetDM(ksp,da);CHKERRQ(ierr);
+  ierr = KSPSetDMActive(ksp,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetInitialGuessNonzero(ksp,nonzero);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+
+  /* n random right hand sides, and random initial guesses with -nonzero_guess */
+  ierr = MatGetLocalSize(A,&m,NULL);CHKERRQ(ierr);
+  ierr = MatCreateDense(PETSC_COMM_WORLD,m,PETSC_DECIDE,PETSC_DETERMINE,n,NULL,&B);CHKERRQ(ierr);
+  ierr = MatCreateDense(PETSC_COMM_WORLD,m,PETSC_DECIDE,PETSC_DETERMINE,n,NULL,&X);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = MatSetRandom(B,rand);CHKERRQ(ierr);
+  if (nonzero) {ierr = MatSetRandom(X,rand);CHKERRQ(ierr);}
+  else {
+    ierr = MatAssemblyBegin(X,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(X,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  }
+  ierr = MatDuplicate(X,MAT_COPY_VALUES,&X0);CHKERRQ(ierr);
+
+  ierr = KSPMatSolve(ksp,B,X);CHKERRQ(ierr);
+  ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+
+  /* each column with KSPSolve() */
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(B,&ba);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(X,&xa);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(X0,&x0a);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {
+    ierr = VecPlaceArray(b,ba+j*m);CHKERRQ(ierr);
+    ierr = VecPlaceArray(x,x0a+j*m);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp,&k);CHKERRQ(ierr);
+    maxits = PetscMax(maxits,k);
+    ierr = VecNorm(x,NORM_2,&nrm);CHKERRQ(ierr);
+    ierr = VecResetArray(b);CHKERRQ(ierr);
+    ierr = VecPlaceArray(b,xa+j*m);CHKERRQ(ierr);
+    ierr = VecAXPY(x,-1.0,b);CHKERRQ(ierr);
+    ierr = VecNorm(x,NORM_2,&err);CHKERRQ(ierr);
+    maxerr = PetscMax(maxerr,err/nrm);
+    ierr = VecResetArray(b);CHKERRQ(ierr);
+    ierr = VecResetArray(x);CHKERRQ(ierr);
+  }
+  ierr = MatDenseRestoreArray(B,&ba);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(X,&xa);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(X0,&x0a);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"KSPMatSolve() with %D right hand sides: solutions %s, iterations %s\n",n,maxerr < 1.e-6 ? "agree" : "differ",its == maxits ? "agree" : "differ");CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&X0);CHKERRQ(ierr);
+  ierr = MatDestroy(&X);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = DMDestroy(&da);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      args: -ksp_rtol 1.e-10 -options_left 0
+      output_file: output/ex64_1.out
+      test:
+         suffix: cg_jacobi
+         nsize: {{1 2}}
+         args: -ksp_type cg -pc_type jacobi
+      test:
+         suffix: cg_none
+         args: -ksp_type cg -pc_type none -nonzero_guess
+      test:
+         suffix: cg_bjacobi
+         nsize: 2
+         args: -ksp_type cg -pc_type bjacobi -sub_pc_type icc
+      test:
+         suffix: gmres_bjacobi
+         nsize: {{1 2}}
+         args: -ksp_type gmres -pc_type bjacobi -ksp_pc_side {{left right}} -nonzero_guess
+      test:
+         suffix: gmres_restart
+         args: -ksp_type gmres -ksp_gmres_restart 5 -ksp_gmres_cgs_refinement_type refine_always -pc_type jacobi
+      test:
+         suffix: cg_mg
+         nsize: {{1 2}}
+         args: -ksp_type cg -pc_type mg -pc_mg_levels 3 -pc_mg_galerkin pmat -mg_levels_ksp_type richardson -mg_levels_pc_type jacobi -mg_levels_ksp_max_it 2
+      test:
+         suffix: gmres_mg
+         nsize: 2
+         args: -ksp_type gmres -pc_type mg -pc_mg_levels 3 -pc_mg_galerkin pmat -pc_mg_cycle_type w
+      test:
+         suffix: preonly_lu
+         args: -ksp_type preonly -pc_type {{lu cholesky}}
+      test:
+         suffix: bcgs
+         nsize: 2
+         args: -ksp_type bcgs -pc_type jacobi
+
+TEST*/
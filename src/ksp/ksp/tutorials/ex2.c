@@ -224,6 +224,32 @@ int main(int argc,char **args)
       nsize: 2
       args: -ksp_monitor_short -m 5 -n 5 -ksp_gmres_cgs_refinement_type refine_always
 
+   test:
+      suffix: gemv
+      args: -ksp_monitor_short -m 5 -n 5 -ksp_gmres_cgs_refinement_type refine_always -vec_mdot_use_gemv -vec_maxpy_use_gemv
+      output_file: output/ex2_1.out
+
+   test:
+      suffix: gemv_2
+      nsize: 2
+      args: -ksp_monitor_short -m 5 -n 5 -ksp_gmres_cgs_refinement_type refine_always -vec_mdot_use_gemv -vec_maxpy_use_gemv
+      output_file: output/ex2_2.out
+
+   test:
+      suffix: ilu_iterative
+      args: -ksp_monitor_short -m 10 -n 10 -pc_type bjacobi -sub_pc_type ilu -sub_pc_factor_ilu_iterative -sub_pc_factor_ilu_iterative_solve_sweeps 4 -ksp_gmres_cgs_refinement_type refine_always
+
+   test:
+      suffix: ilu_iterative_2
+      nsize: 2
+      args: -ksp_monitor_short -m 10 -n 10 -pc_type bjacobi -sub_pc_type ilu -sub_pc_factor_ilu_iterative -sub_pc_factor_ilu_iterative_solve_sweeps 4 -ksp_gmres_cgs_refinement_type refine_always
+
+   test:
+      suffix: ilu_iterative_omp
+      requires: openmp
+      args: -ksp_monitor_short -m 10 -n 10 -pc_type bjacobi -sub_pc_type ilu -sub_pc_factor_ilu_iterative -sub_pc_factor_ilu_iterative_solve_sweeps 4 -ksp_gmres_cgs_refinement_type refine_always -mat_aij_omp_threads 2
+      output_file: output/ex2_ilu_iterative.out
+
    test:
       suffix: 3
       args: -pc_type sor -pc_sor_symmetric -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always
@@ -327,4 +353,50 @@ int main(int argc,char **args)
    test:
       suffix: pipeprcg_rcw
       args: -ksp_monitor_short -ksp_type pipeprcg -recompute_w false -m 9 -n 9
+
+   test:
+      suffix: cacg
+      nsize: {{1 2}}
+      args: -ksp_monitor_short -ksp_type cacg -ksp_cacg_s 3 -m 15 -n 15 -pc_type jacobi
+      output_file: output/ex2_cacg.out
+
+   test:
+      suffix: cacg_monitor_basis
+      args: -ksp_type cacg -ksp_cacg_monitor_basis -ksp_norm_type unpreconditioned -ksp_converged_reason -m 20 -n 20 -pc_type none
+
+   test:
+      suffix: cacg_large_s
+      args: -ksp_type cacg -ksp_cacg_s 12 -ksp_cacg_monitor_basis -ksp_converged_reason -m 30 -n 30 -pc_type none
+
+   test:
+      suffix: cagmres
+      nsize: {{1 2}}
+      args: -ksp_monitor_short -ksp_type cagmres -ksp_cagmres_s 3 -ksp_gmres_restart 10 -m 9 -n 9 -pc_type jacobi
+      output_file: output/ex2_cagmres.out
+
+   test:
+      suffix: cagmres_right
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type cagmres -ksp_cagmres_s 3 -ksp_gmres_restart 10 -ksp_pc_side right -m 9 -n 9 -pc_type jacobi
+
+   test:
+      suffix: cagmres_monitor_basis
+      args: -ksp_type cagmres -ksp_cagmres_s 8 -ksp_cagmres_monitor_basis -ksp_converged_reason -m 20 -n 20 -pc_type none
+
+   test:
+      suffix: lowsync_cgs
+      nsize: {{1 2}}
+      args: -ksp_monitor_short -ksp_gmres_lowsyncclassicalgramschmidt -ksp_gmres_restart 10 -m 15 -n 15 -pc_type jacobi
+      output_file: output/ex2_lowsync.out
+
+   test:
+      suffix: lowsync_mgs
+      nsize: {{1 2}}
+      args: -ksp_monitor_short -ksp_gmres_lowsyncmodifiedgramschmidt -ksp_gmres_restart 10 -m 15 -n 15 -pc_type jacobi
+      output_file: output/ex2_lowsync.out
+
+   test:
+      suffix: lowsync_fgmres
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type fgmres -ksp_gmres_lowsyncmodifiedgramschmidt -ksp_gmres_restart 10 -m 15 -n 15 -pc_type jacobi
  TEST*/
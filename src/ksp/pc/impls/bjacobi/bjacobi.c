@@ -638,6 +638,50 @@ static PetscErrorCode PCApply_BJacobi_Singleblock(PC pc,Vec x,Vec y)
   PetscFunctionReturn(0);
 }
 
+/*
+   PCMatApply_BJacobi_Singleblock - Solves on the block with KSPMatSolve(), whose right hand sides and solutions are the local rows of X and Y
+*/
+static PetscErrorCode PCMatApply_BJacobi_Singleblock(PC pc,Mat X,Mat Y)
+{
+  PetscErrorCode     ierr;
+  PC_BJacobi         *jac = (PC_BJacobi*)pc->data;
+  Mat                sX,sY;
+  const PetscScalar  *x;
+  PetscScalar        *y;
+  PetscInt           m,N,ldx,ldy;
+  PC                 subpc;
+  PCFailedReason     pcreason;
+  KSPConvergedReason reason;
+
+  PetscFunctionBegin;
+  ierr = KSPSetReusePreconditioner(jac->ksp[0],pc->reusepreconditioner);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(X,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(X,NULL,&N);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(Y,&ldy);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(Y,&y);CHKERRQ(ierr);
+  ierr = MatCreateSeqDense(PETSC_COMM_SELF,m,N,(PetscScalar*)x,&sX);CHKERRQ(ierr);
+  ierr = MatSeqDenseSetLDA(sX,ldx);CHKERRQ(ierr);
+  ierr = MatCreateSeqDense(PETSC_COMM_SELF,m,N,y,&sY);CHKERRQ(ierr);
+  ierr = MatSeqDenseSetLDA(sY,ldy);CHKERRQ(ierr);
+  ierr = KSPMatSolve(jac->ksp[0],sX,sY);CHKERRQ(ierr);
+  ierr = MatDestroy(&sX);CHKERRQ(ierr);
+  ierr = MatDestroy(&sY);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(X,&x);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(Y,&y);CHKERRQ(ierr);
+  /* as KSPCheckSolve() */
+  ierr = KSPGetPC(jac->ksp[0],&subpc);CHKERRQ(ierr);
+  ierr = PCGetFailedReason(subpc,&pcreason);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(jac->ksp[0],&reason);CHKERRQ(ierr);
+  if (pcreason || (reason < 0 && reason != KSP_DIVERGED_ITS)) {
+    if (pc->erroriffailure) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_NOT_CONVERGED,"Detected not converged in KSP inner solve: KSP reason %s PC reason %s",KSPConvergedReasons[reason],PCFailedReasons[pcreason]);
+    ierr = PetscInfo2(jac->ksp[0],"Detected not converged in KSP inner solve: KSP reason %s PC reason %s\n",KSPConvergedReasons[reason],PCFailedReasons[pcreason]);CHKERRQ(ierr);
+    pc->failedreason = PC_SUBPC_ERROR;
+  }
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PCApplySymmetricLeft_BJacobi_Singleblock(PC pc,Vec x,Vec y)
 {
   PetscErrorCode         ierr;
@@ -760,6 +804,7 @@ static PetscErrorCode PCSetUp_BJacobi_Singleblock(PC pc,Mat mat,Mat pmat)
       pc->ops->reset               = PCReset_BJacobi_Singleblock;
       pc->ops->destroy             = PCDestroy_BJacobi_Singleblock;
       pc->ops->apply               = PCApply_BJacobi_Singleblock;
+      pc->ops->matapply            = PCMatApply_BJacobi_Singleblock;
       pc->ops->applysymmetricleft  = PCApplySymmetricLeft_BJacobi_Singleblock;
       pc->ops->applysymmetricright = PCApplySymmetricRight_BJacobi_Singleblock;
       pc->ops->applytranspose      = PCApplyTranspose_BJacobi_Singleblock;
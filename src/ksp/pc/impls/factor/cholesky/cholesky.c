@@ -292,6 +292,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_Cholesky(PC pc)
   pc->ops->destroy             = PCDestroy_Cholesky;
   pc->ops->reset               = PCReset_Cholesky;
   pc->ops->apply               = PCApply_Cholesky;
+  pc->ops->matapply            = PCMatApply_Factor;
   pc->ops->applysymmetricleft  = PCApplySymmetricLeft_Cholesky;
   pc->ops->applysymmetricright = PCApplySymmetricRight_Cholesky;
   pc->ops->applytranspose      = PCApplyTranspose_Cholesky;
@@ -183,6 +183,19 @@ PetscErrorCode  PCFactorGetMatrix_Factor(PC pc,Mat *mat)
   PetscFunctionReturn(0);
 }
 
+/*
+   PCMatApply_Factor - Solves with the factored matrix for all the columns of X with MatMatSolve()
+*/
+PetscErrorCode PCMatApply_Factor(PC pc,Mat X,Mat Y)
+{
+  PC_Factor      *fac = (PC_Factor*)pc->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMatSolve(fac->inplace ? pc->pmat : fac->fact,X,Y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode  PCFactorSetMatSolverType_Factor(PC pc,MatSolverType stype)
 {
   PetscErrorCode ierr;
@@ -178,6 +178,45 @@ PetscErrorCode  PCFactorSetDropTolerance(PC pc,PetscReal dt,PetscReal dtcol,Pets
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCFactorSetILUIterative - Computes the ILU factorization, and the triangular solves of PCApply(), by a fixed number of
+   sweeps that update all the entries at once, so that they run in parallel on OpenMP threads
+
+   Logically Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+.  flg - PETSC_TRUE to use the sweeps
+.  sweeps - the number of sweeps of the numeric factorization, or PETSC_DEFAULT to keep the current value (initially 3)
+-  solvesweeps - the number of Jacobi sweeps of each triangular solve, or PETSC_DEFAULT to keep the current value (initially 3)
+
+   Options Database Keys:
++  -pc_factor_ilu_iterative - use the sweeps
+.  -pc_factor_ilu_iterative_sweeps <sweeps> - the number of sweeps of the numeric factorization
+-  -pc_factor_ilu_iterative_solve_sweeps <solvesweeps> - the number of Jacobi sweeps of each triangular solve
+
+   Level: intermediate
+
+   Notes:
+   This is the fine-grained parallel ILU of Chow and Patel for PCILU with MATSEQAIJ matrices and MATSOLVERPETSC, also as the
+   subdomain solver of PCBJACOBI and PCASM; see MatSeqAIJSetILUIterative() for the method. The threads are given by
+   -mat_aij_omp_threads of the matrix. It must be set before PCSetUp() and is ignored by other matrix types and solver packages.
+
+.seealso: MatSeqAIJSetILUIterative(), PCFactorSetLevels(), PCILU
+@*/
+PetscErrorCode  PCFactorSetILUIterative(PC pc,PetscBool flg,PetscInt sweeps,PetscInt solvesweeps)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidLogicalCollectiveBool(pc,flg,2);
+  PetscValidLogicalCollectiveInt(pc,sweeps,3);
+  PetscValidLogicalCollectiveInt(pc,solvesweeps,4);
+  ierr = PetscTryMethod(pc,"PCFactorSetILUIterative_C",(PC,PetscBool,PetscInt,PetscInt),(pc,flg,sweeps,solvesweeps));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    PCFactorGetZeroPivot - Gets the tolerance used to define a zero privot
 
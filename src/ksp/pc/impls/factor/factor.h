@@ -20,6 +20,7 @@ typedef struct {
 
 PETSC_INTERN PetscErrorCode PCFactorInitialize(PC);
 PETSC_INTERN PetscErrorCode PCFactorGetMatrix_Factor(PC,Mat*);
+PETSC_INTERN PetscErrorCode PCMatApply_Factor(PC,Mat,Mat);
 
 PETSC_INTERN PetscErrorCode PCFactorSetZeroPivot_Factor(PC,PetscReal);
 PETSC_INTERN PetscErrorCode PCFactorGetZeroPivot_Factor(PC,PetscReal*);
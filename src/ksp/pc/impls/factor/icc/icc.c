@@ -184,6 +184,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_ICC(PC pc)
   ((PC_Factor*)icc)->info.shifttype = (PetscReal) MAT_SHIFT_POSITIVE_DEFINITE;
 
   pc->ops->apply               = PCApply_ICC;
+  pc->ops->matapply            = PCMatApply_Factor;
   pc->ops->applytranspose      = PCApply_ICC;
   pc->ops->setup               = PCSetUp_ICC;
   pc->ops->reset               = PCReset_ICC;
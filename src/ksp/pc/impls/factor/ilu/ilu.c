@@ -15,6 +15,23 @@ PetscErrorCode  PCFactorReorderForNonzeroDiagonal_ILU(PC pc,PetscReal z)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PCFactorSetILUIterative_ILU(PC pc,PetscBool flg,PetscInt sweeps,PetscInt solvesweeps)
+{
+  PC_ILU *ilu = (PC_ILU*)pc->data;
+
+  PetscFunctionBegin;
+  ilu->iterative = flg;
+  if (sweeps != PETSC_DEFAULT) {
+    if (sweeps < 1) SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_OUTOFRANGE,"Number of sweeps %D must be positive",sweeps);
+    ilu->sweeps = sweeps;
+  }
+  if (solvesweeps != PETSC_DEFAULT) {
+    if (solvesweeps < 0) SETERRQ1(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_OUTOFRANGE,"Number of solve sweeps %D cannot be negative",solvesweeps);
+    ilu->solvesweeps = solvesweeps;
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode PCReset_ILU(PC pc)
 {
   PC_ILU         *ilu = (PC_ILU*)pc->data;
@@ -65,6 +82,11 @@ static PetscErrorCode PCSetFromOptions_ILU(PetscOptionItems *PetscOptionsObject,
     ierr = PetscOptionsReal("-pc_factor_nonzeros_along_diagonal","Reorder to remove zeros from diagonal","PCFactorReorderForNonzeroDiagonal",ilu->nonzerosalongdiagonaltol,&tol,NULL);CHKERRQ(ierr);
     ierr = PCFactorReorderForNonzeroDiagonal(pc,tol);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsBool("-pc_factor_ilu_iterative","Compute the factor and its triangular solves with sweeps","PCFactorSetILUIterative",ilu->iterative,&ilu->iterative,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-pc_factor_ilu_iterative_sweeps","Number of sweeps of the iterative factorization","PCFactorSetILUIterative",ilu->sweeps,&itmp,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = PCFactorSetILUIterative(pc,ilu->iterative,itmp,PETSC_DEFAULT);CHKERRQ(ierr);}
+  ierr = PetscOptionsInt("-pc_factor_ilu_iterative_solve_sweeps","Number of Jacobi sweeps of each iterative triangular solve","PCFactorSetILUIterative",ilu->solvesweeps,&itmp,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = PCFactorSetILUIterative(pc,ilu->iterative,PETSC_DEFAULT,itmp);CHKERRQ(ierr);}
 
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -132,6 +154,7 @@ static PetscErrorCode PCSetUp_ILU(PC pc)
       if (!((PC_Factor*)ilu)->fact) {
         ierr = MatGetFactor(pc->pmat,((PC_Factor*)ilu)->solvertype,MAT_FACTOR_ILU,&((PC_Factor*)ilu)->fact);CHKERRQ(ierr);
       }
+      if (ilu->iterative) {ierr = MatSeqAIJSetILUIterative(((PC_Factor*)ilu)->fact,PETSC_TRUE,ilu->sweeps,ilu->solvesweeps);CHKERRQ(ierr);}
       ierr = MatILUFactorSymbolic(((PC_Factor*)ilu)->fact,pc->pmat,ilu->row,ilu->col,&((PC_Factor*)ilu)->info);CHKERRQ(ierr);
       ierr = MatGetInfo(((PC_Factor*)ilu)->fact,MAT_LOCAL,&info);CHKERRQ(ierr);
       ilu->hdr.actualfill = info.fill_ratio_needed;
@@ -152,6 +175,7 @@ static PetscErrorCode PCSetUp_ILU(PC pc)
       }
       ierr = MatDestroy(&((PC_Factor*)ilu)->fact);CHKERRQ(ierr);
       ierr = MatGetFactor(pc->pmat,((PC_Factor*)ilu)->solvertype,MAT_FACTOR_ILU,&((PC_Factor*)ilu)->fact);CHKERRQ(ierr);
+      if (ilu->iterative) {ierr = MatSeqAIJSetILUIterative(((PC_Factor*)ilu)->fact,PETSC_TRUE,ilu->sweeps,ilu->solvesweeps);CHKERRQ(ierr);}
       ierr = MatILUFactorSymbolic(((PC_Factor*)ilu)->fact,pc->pmat,ilu->row,ilu->col,&((PC_Factor*)ilu)->info);CHKERRQ(ierr);
       ierr = MatGetInfo(((PC_Factor*)ilu)->fact,MAT_LOCAL,&info);CHKERRQ(ierr);
       ilu->hdr.actualfill = info.fill_ratio_needed;
@@ -246,6 +270,9 @@ static PetscErrorCode PCApplySymmetricRight_ILU(PC pc,Vec x,Vec y)
 .  -pc_factor_nonzeros_along_diagonal - reorder the matrix before factorization to remove zeros from the diagonal,
                                    this decreases the chance of getting a zero pivot
 .  -pc_factor_mat_ordering_type <natural,nd,1wd,rcm,qmd> - set the row/column ordering of the factored matrix
+.  -pc_factor_ilu_iterative - compute the factor and its triangular solves with sweeps that run in parallel, see PCFactorSetILUIterative()
+.  -pc_factor_ilu_iterative_sweeps <sweeps> - number of sweeps of the iterative factorization
+.  -pc_factor_ilu_iterative_solve_sweeps <solvesweeps> - number of Jacobi sweeps of each iterative triangular solve
 -  -pc_factor_pivot_in_blocks - for block ILU(k) factorization, i.e. with BAIJ matrices with block size larger
                              than 1 the diagonal blocks are factored with partial pivoting (this increases the
                              stability of the ILU factorization
@@ -277,7 +304,7 @@ static PetscErrorCode PCApplySymmetricRight_ILU(PC pc,Vec x,Vec y)
            PCFactorSetZeroPivot(), PCFactorSetShiftSetType(), PCFactorSetAmount(),
            PCFactorSetDropTolerance(),PCFactorSetFill(), PCFactorSetMatOrderingType(), PCFactorSetReuseOrdering(),
            PCFactorSetLevels(), PCFactorSetUseInPlace(), PCFactorSetAllowDiagonalFill(), PCFactorSetPivotInBlocks(),
-           PCFactorGetAllowDiagonalFill(), PCFactorGetUseInPlace()
+           PCFactorGetAllowDiagonalFill(), PCFactorGetUseInPlace(), PCFactorSetILUIterative()
 
 M*/
 
@@ -300,10 +327,13 @@ PETSC_EXTERN PetscErrorCode PCCreate_ILU(PC pc)
   ((PC_Factor*)ilu)->info.dt            = PETSC_DEFAULT;
   ((PC_Factor*)ilu)->info.dtcount       = PETSC_DEFAULT;
   ((PC_Factor*)ilu)->info.dtcol         = PETSC_DEFAULT;
+  ilu->sweeps                           = 3;
+  ilu->solvesweeps                      = 3;
 
   pc->ops->reset               = PCReset_ILU;
   pc->ops->destroy             = PCDestroy_ILU;
   pc->ops->apply               = PCApply_ILU;
+  pc->ops->matapply            = PCMatApply_Factor;
   pc->ops->applytranspose      = PCApplyTranspose_ILU;
   pc->ops->setup               = PCSetUp_ILU;
   pc->ops->setfromoptions      = PCSetFromOptions_ILU;
@@ -313,5 +343,6 @@ PETSC_EXTERN PetscErrorCode PCCreate_ILU(PC pc)
   pc->ops->applyrichardson     = NULL;
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorSetDropTolerance_C",PCFactorSetDropTolerance_ILU);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorReorderForNonzeroDiagonal_C",PCFactorReorderForNonzeroDiagonal_ILU);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)pc,"PCFactorSetILUIterative_C",PCFactorSetILUIterative_ILU);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
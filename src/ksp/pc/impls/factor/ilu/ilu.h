@@ -12,6 +12,8 @@ typedef struct {
   void      *implctx;                 /* private implementation context */
   PetscBool nonzerosalongdiagonal;
   PetscReal nonzerosalongdiagonaltol;
+  PetscBool iterative;                 /* compute the factor and its solves with sweeps, see PCFactorSetILUIterative() */
+  PetscInt  sweeps,solvesweeps;
 } PC_ILU;
 
 #endif
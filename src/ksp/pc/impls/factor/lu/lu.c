@@ -260,6 +260,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_LU(PC pc)
   pc->ops->reset             = PCReset_LU;
   pc->ops->destroy           = PCDestroy_LU;
   pc->ops->apply             = PCApply_LU;
+  pc->ops->matapply          = PCMatApply_Factor;
   pc->ops->applytranspose    = PCApplyTranspose_LU;
   pc->ops->setup             = PCSetUp_LU;
   pc->ops->setfromoptions    = PCSetFromOptions_LU;
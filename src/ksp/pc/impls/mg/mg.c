@@ -133,6 +133,8 @@ static PetscErrorCode PCApplyRichardson_MG(PC pc,Vec b,Vec x,Vec w,PetscReal rto
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode PCMGDestroyMats_Private(PC);
+
 PetscErrorCode PCReset_MG(PC pc)
 {
   PC_MG          *mg        = (PC_MG*)pc->data;
@@ -164,6 +166,7 @@ PetscErrorCode PCReset_MG(PC pc)
       ierr = KSPReset(mglevels[i]->smoothu);CHKERRQ(ierr);
     }
   }
+  ierr = PCMGDestroyMats_Private(pc);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -394,6 +397,169 @@ static PetscErrorCode PCApply_MG(PC pc,Vec b,Vec x)
   PetscFunctionReturn(0);
 }
 
+/*
+   PCMGCheckMatSolve_Private - Marks the PC as failed if the KSPMatSolve() of a smoother or of the coarse solver failed, as KSPCheckSolve()
+*/
+static PetscErrorCode PCMGCheckMatSolve_Private(PC pc,KSP ksp)
+{
+  PetscErrorCode     ierr;
+  PC                 subpc;
+  PCFailedReason     pcreason;
+  KSPConvergedReason reason;
+
+  PetscFunctionBegin;
+  ierr = KSPGetPC(ksp,&subpc);CHKERRQ(ierr);
+  ierr = PCGetFailedReason(subpc,&pcreason);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+  if (pcreason || (reason < 0 && reason != KSP_DIVERGED_ITS)) {
+    if (pc->erroriffailure) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_NOT_CONVERGED,"Detected not converged in KSP inner solve: KSP reason %s PC reason %s",KSPConvergedReasons[reason],PCFailedReasons[pcreason]);
+    ierr = PetscInfo2(ksp,"Detected not converged in KSP inner solve: KSP reason %s PC reason %s\n",KSPConvergedReasons[reason],PCFailedReasons[pcreason]);CHKERRQ(ierr);
+    pc->failedreason = PC_SUBPC_ERROR;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMGMCycleMat_Private - The multiplicative cycle of PCMGMCycle_Private() on the block of columns of the dense matrices B and X of each level
+*/
+static PetscErrorCode PCMGMCycleMat_Private(PC pc,PC_MG_Levels **mglevelsin)
+{
+  PC_MG_Levels   *mgc,*mglevels = *mglevelsin;
+  PetscErrorCode ierr;
+  PetscInt       cycles = (mglevels->level == 1) ? 1 : (PetscInt) mglevels->cycles;
+  PetscInt       M,Mc;
+
+  PetscFunctionBegin;
+  if (mglevels->eventsmoothsolve) {ierr = PetscLogEventBegin(mglevels->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
+  ierr = KSPMatSolve(mglevels->smoothd,mglevels->B,mglevels->X);CHKERRQ(ierr);  /* pre-smooth */
+  ierr = PCMGCheckMatSolve_Private(pc,mglevels->smoothd);CHKERRQ(ierr);
+  if (mglevels->eventsmoothsolve) {ierr = PetscLogEventEnd(mglevels->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
+  if (mglevels->level) {  /* not the coarsest grid */
+    if (mglevels->eventresidual) {ierr = PetscLogEventBegin(mglevels->eventresidual,0,0,0,0);CHKERRQ(ierr);}
+    ierr = PCMatProduct_Private(mglevels->A,mglevels->X,MATPRODUCT_AB,&mglevels->AX);CHKERRQ(ierr);
+    if (!mglevels->R) {ierr = MatDuplicate(mglevels->B,MAT_DO_NOT_COPY_VALUES,&mglevels->R);CHKERRQ(ierr);}
+    ierr = MatCopy(mglevels->B,mglevels->R,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatAXPY(mglevels->R,-1.0,mglevels->AX,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    if (mglevels->eventresidual) {ierr = PetscLogEventEnd(mglevels->eventresidual,0,0,0,0);CHKERRQ(ierr);}
+
+    /* as MatRestrict() and MatInterpolateAdd(), the grid transfers are by the matrix or by its transpose depending on its sizes */
+    mgc  = *(mglevelsin - 1);
+    ierr = MatGetSize(mgc->A,&Mc,NULL);CHKERRQ(ierr);
+    ierr = MatGetSize(mglevels->restrct,&M,NULL);CHKERRQ(ierr);
+    if (mglevels->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    ierr = PCMatProduct_Private(mglevels->restrct,mglevels->R,M == Mc ? MATPRODUCT_AB : MATPRODUCT_AtB,&mgc->B);CHKERRQ(ierr);
+    if (mglevels->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    if (!mgc->X) {ierr = MatDuplicate(mgc->B,MAT_DO_NOT_COPY_VALUES,&mgc->X);CHKERRQ(ierr);}
+    ierr = MatZeroEntries(mgc->X);CHKERRQ(ierr);
+    while (cycles--) {
+      ierr = PCMGMCycleMat_Private(pc,mglevelsin-1);CHKERRQ(ierr);
+    }
+    ierr = MatGetSize(mglevels->interpolate,&M,NULL);CHKERRQ(ierr);
+    if (mglevels->eventinterprestrict) {ierr = PetscLogEventBegin(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    ierr = PCMatProduct_Private(mglevels->interpolate,mgc->X,M == Mc ? MATPRODUCT_AtB : MATPRODUCT_AB,&mglevels->IX);CHKERRQ(ierr);
+    ierr = MatAXPY(mglevels->X,1.0,mglevels->IX,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    if (mglevels->eventinterprestrict) {ierr = PetscLogEventEnd(mglevels->eventinterprestrict,0,0,0,0);CHKERRQ(ierr);}
+    if (mglevels->eventsmoothsolve) {ierr = PetscLogEventBegin(mglevels->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
+    ierr = KSPMatSolve(mglevels->smoothu,mglevels->B,mglevels->X);CHKERRQ(ierr);    /* post smooth */
+    ierr = PCMGCheckMatSolve_Private(pc,mglevels->smoothu);CHKERRQ(ierr);
+    if (mglevels->eventsmoothsolve) {ierr = PetscLogEventEnd(mglevels->eventsmoothsolve,0,0,0,0);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMGDestroyMats_Private - Destroys the dense matrices of each level used by PCMatApply_MG()
+*/
+static PetscErrorCode PCMGDestroyMats_Private(PC pc)
+{
+  PC_MG          *mg        = (PC_MG*)pc->data;
+  PC_MG_Levels   **mglevels = mg->levels;
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  if (!mglevels) PetscFunctionReturn(0);
+  for (i=0; i<mglevels[0]->levels; i++) {
+    ierr = MatDestroy(&mglevels[i]->B);CHKERRQ(ierr);
+    ierr = MatDestroy(&mglevels[i]->X);CHKERRQ(ierr);
+    ierr = MatDestroy(&mglevels[i]->R);CHKERRQ(ierr);
+    ierr = MatDestroy(&mglevels[i]->AX);CHKERRQ(ierr);
+    ierr = MatDestroy(&mglevels[i]->IX);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMatApply_MG - Runs the multiplicative cycles on all the columns of B at once: the smoothers and the coarse solver use KSPMatSolve(),
+   the residuals and the grid transfers are products by dense matrices. The other types of cycles, the residuals set with PCMGSetResidual()
+   and the smoothers that change the right hand side apply PCApply_MG() to each column.
+*/
+static PetscErrorCode PCMatApply_MG(PC pc,Mat B,Mat X)
+{
+  PC_MG          *mg        = (PC_MG*)pc->data;
+  PC_MG_Levels   **mglevels = mg->levels;
+  PetscErrorCode ierr;
+  PC             tpc;
+  PetscInt       levels = mglevels[0]->levels,i,j,N,Nr,ldb,ldx;
+  PetscBool      changeu,changed,native = PETSC_TRUE;
+  Vec            b,x;
+  PetscScalar    *ba,*xa;
+
+  PetscFunctionBegin;
+  /* When the DM is supplying the matrix then it will not exist until here */
+  for (i=0; i<levels; i++) {
+    if (!mglevels[i]->A) {
+      ierr = KSPGetOperators(mglevels[i]->smoothu,&mglevels[i]->A,NULL);CHKERRQ(ierr);
+      ierr = PetscObjectReference((PetscObject)mglevels[i]->A);CHKERRQ(ierr);
+    }
+    if (i && mglevels[i]->residual != PCMGResidualDefault) native = PETSC_FALSE;
+  }
+  ierr = KSPGetPC(mglevels[levels-1]->smoothd,&tpc);CHKERRQ(ierr);
+  ierr = PCPreSolveChangeRHS(tpc,&changed);CHKERRQ(ierr);
+  ierr = KSPGetPC(mglevels[levels-1]->smoothu,&tpc);CHKERRQ(ierr);
+  ierr = PCPreSolveChangeRHS(tpc,&changeu);CHKERRQ(ierr);
+  if (mg->am != PC_MG_MULTIPLICATIVE || changed || changeu) native = PETSC_FALSE;
+
+  if (!native) {
+    ierr = MatCreateVecs(pc->pmat,&b,&x);CHKERRQ(ierr);
+    ierr = MatGetSize(B,NULL,&N);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(B,&ba);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(X,&xa);CHKERRQ(ierr);
+    for (j=0; j<N; j++) {
+      ierr = VecPlaceArray(b,ba+j*ldb);CHKERRQ(ierr);
+      ierr = VecPlaceArray(x,xa+j*ldx);CHKERRQ(ierr);
+      ierr = PCApply_MG(pc,b,x);CHKERRQ(ierr);
+      ierr = VecResetArray(b);CHKERRQ(ierr);
+      ierr = VecResetArray(x);CHKERRQ(ierr);
+    }
+    ierr = MatDenseRestoreArray(B,&ba);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(X,&xa);CHKERRQ(ierr);
+    ierr = VecDestroy(&b);CHKERRQ(ierr);
+    ierr = VecDestroy(&x);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  if (mg->stageApply) {ierr = PetscLogStagePush(mg->stageApply);CHKERRQ(ierr);}
+  /* the dense matrices of the levels are kept from one application to the next with the same number of columns */
+  ierr = MatGetSize(B,NULL,&N);CHKERRQ(ierr);
+  if (mglevels[levels-1]->R) {
+    ierr = MatGetSize(mglevels[levels-1]->R,NULL,&Nr);CHKERRQ(ierr);
+    if (Nr != N) {ierr = PCMGDestroyMats_Private(pc);CHKERRQ(ierr);}
+  }
+  mglevels[levels-1]->B = B;
+  mglevels[levels-1]->X = X;
+  ierr = MatZeroEntries(X);CHKERRQ(ierr);
+  for (i=0; i<mg->cyclesperpcapply; i++) {
+    ierr = PCMGMCycleMat_Private(pc,mglevels+levels-1);CHKERRQ(ierr);
+  }
+  mglevels[levels-1]->B = NULL;
+  mglevels[levels-1]->X = NULL;
+  if (mg->stageApply) {ierr = PetscLogStagePop();CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
 
 PetscErrorCode PCSetFromOptions_MG(PetscOptionItems *PetscOptionsObject,PC pc)
 {
@@ -1315,6 +1481,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_MG(PC pc)
   pc->useAmat = PETSC_TRUE;
 
   pc->ops->apply          = PCApply_MG;
+  pc->ops->matapply       = PCMatApply_MG;
   pc->ops->setup          = PCSetUp_MG;
   pc->ops->reset          = PCReset_MG;
   pc->ops->destroy        = PCDestroy_MG;
@@ -3,11 +3,12 @@
     The PC (preconditioner) interface routines, callable by users.
 */
 #include <petsc/private/pcimpl.h>            /*I "petscksp.h" I*/
+#include <petsc/private/matimpl.h>
 #include <petscdm.h>
 
 /* Logging support */
 PetscClassId  PC_CLASSID;
-PetscLogEvent PC_SetUp, PC_SetUpOnBlocks, PC_Apply, PC_ApplyCoarse, PC_ApplyMultiple, PC_ApplySymmetricLeft;
+PetscLogEvent PC_SetUp, PC_SetUpOnBlocks, PC_Apply, PC_MatApply, PC_ApplyCoarse, PC_ApplyMultiple, PC_ApplySymmetricLeft;
 PetscLogEvent PC_ApplySymmetricRight, PC_ModifySubMatrices, PC_ApplyOnBlocks, PC_ApplyTransposeOnBlocks;
 PetscInt      PetscMGLevelId;
 
@@ -448,6 +449,144 @@ PetscErrorCode  PCApply(PC pc,Vec x,Vec y)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PCMatApply - Applies the preconditioner to each column of a dense matrix.
+
+   Collective on PC
+
+   Input Parameters:
++  pc - the preconditioner context
+-  X - block of input vectors, a MATSEQDENSE or MATMPIDENSE matrix
+
+   Output Parameter:
+.  Y - block of output vectors, a dense matrix of the same sizes as X
+
+   Notes:
+   PCJACOBI, PCBJACOBI with one block per process, PCILU, PCICC, PCLU, PCCHOLESKY and PCMG with multiplicative cycles go through their
+   data once for all the columns. The other preconditioners apply PCApply() to each column.
+
+   Level: developer
+
+.seealso: PCApply(), KSPMatSolve()
+@*/
+PetscErrorCode PCMatApply(PC pc,Mat X,Mat Y)
+{
+  PetscErrorCode    ierr;
+  PetscInt          m,n,mx,my,Nx,Ny,j,ldx,ldy;
+  PetscBool         match;
+  Vec               x,y;
+  const PetscScalar *xa;
+  PetscScalar       *ya;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(pc,PC_CLASSID,1);
+  PetscValidHeaderSpecific(X,MAT_CLASSID,2);
+  PetscValidHeaderSpecific(Y,MAT_CLASSID,3);
+  PetscCheckSameComm(pc,1,X,2);
+  PetscCheckSameComm(pc,1,Y,3);
+  if (X == Y) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_ARG_IDN,"X and Y must be different matrices");
+  ierr = PetscObjectTypeCompareAny((PetscObject)X,&match,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  if (!match) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Provided block of input vectors not stored in a dense Mat");
+  ierr = PetscObjectTypeCompareAny((PetscObject)Y,&match,MATSEQDENSE,MATMPIDENSE,"");CHKERRQ(ierr);
+  if (!match) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Provided block of output vectors not stored in a dense Mat");
+  ierr = MatGetLocalSize(pc->pmat,&m,&n);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(X,&mx,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(Y,&my,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(X,NULL,&Nx);CHKERRQ(ierr);
+  ierr = MatGetSize(Y,NULL,&Ny);CHKERRQ(ierr);
+  if (my != m) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Preconditioner number of local rows %D does not equal block of output vectors number of local rows %D",m,my);
+  if (mx != n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Preconditioner number of local columns %D does not equal block of input vectors number of local rows %D",n,mx);
+  if (Nx != Ny) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Block of input vectors number of columns %D does not equal block of output vectors number of columns %D",Nx,Ny);
+
+  ierr = PCSetUp(pc);CHKERRQ(ierr);
+  if (!pc->ops->apply && !pc->ops->matapply) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"PC does not have apply");
+  ierr = PetscLogEventBegin(PC_MatApply,pc,X,Y,0);CHKERRQ(ierr);
+  if (pc->ops->matapply) {
+    ierr = (*pc->ops->matapply)(pc,X,Y);CHKERRQ(ierr);
+  } else {
+    ierr = MatCreateVecs(pc->pmat,&x,&y);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(X,&xa);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(Y,&ya);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(Y,&ldy);CHKERRQ(ierr);
+    for (j=0; j<Nx; j++) {
+      ierr = VecPlaceArray(x,xa+j*ldx);CHKERRQ(ierr);
+      ierr = VecPlaceArray(y,ya+j*ldy);CHKERRQ(ierr);
+      ierr = PCApply(pc,x,y);CHKERRQ(ierr);
+      ierr = VecResetArray(x);CHKERRQ(ierr);
+      ierr = VecResetArray(y);CHKERRQ(ierr);
+    }
+    ierr = MatDenseRestoreArrayRead(X,&xa);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(Y,&ya);CHKERRQ(ierr);
+    ierr = VecDestroy(&x);CHKERRQ(ierr);
+    ierr = VecDestroy(&y);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(PC_MatApply,pc,X,Y,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PCMatProduct_Private - Computes Y = A X (type MATPRODUCT_AB) or Y = A^T X (MATPRODUCT_AtB) for a dense X, with MatMatMult() or
+   MatTransposeMatMult() if there is a product for the types of A and X, otherwise with MatMult() or MatMultTranspose() on each column.
+   Y is created by the first call and must be passed back, with the same A and type, in the next ones.
+*/
+PetscErrorCode PCMatProduct_Private(Mat A,Mat X,MatProductType type,Mat *Y)
+{
+  PetscErrorCode    ierr;
+  PetscErrorCode    (*f)(Mat) = NULL;
+  PetscBool         flg = PETSC_TRUE;
+  char              name[256];
+  PetscInt          m,n,N,j,ldx,ldy;
+  Vec               x,y;
+  const PetscScalar *xa;
+  PetscScalar       *ya;
+
+  PetscFunctionBegin;
+  if (type != MATPRODUCT_AB && type != MATPRODUCT_AtB) SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"MatProduct type %s",MatProductTypes[type]);
+  if (*Y && (*Y)->product) {
+    if (type == MATPRODUCT_AB) {ierr = MatMatMult(A,X,MAT_REUSE_MATRIX,PETSC_DEFAULT,Y);CHKERRQ(ierr);}
+    else {ierr = MatTransposeMatMult(A,X,MAT_REUSE_MATRIX,PETSC_DEFAULT,Y);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  if (!*Y) {
+    /* the products registered for A X do not all have A^T X */
+    if (type == MATPRODUCT_AtB) {ierr = PetscObjectTypeCompareAny((PetscObject)A,&flg,MATSEQAIJ,MATMPIAIJ,"");CHKERRQ(ierr);}
+    if (flg) {
+      ierr = PetscSNPrintf(name,sizeof(name),"MatProductSetFromOptions_%s_%s_C",((PetscObject)A)->type_name,((PetscObject)X)->type_name);CHKERRQ(ierr);
+      ierr = PetscObjectQueryFunction((PetscObject)A,name,&f);CHKERRQ(ierr);
+      if (!f) {ierr = PetscObjectQueryFunction((PetscObject)X,name,&f);CHKERRQ(ierr);}
+    }
+    if (f) {
+      if (type == MATPRODUCT_AB) {ierr = MatMatMult(A,X,MAT_INITIAL_MATRIX,PETSC_DEFAULT,Y);CHKERRQ(ierr);}
+      else {ierr = MatTransposeMatMult(A,X,MAT_INITIAL_MATRIX,PETSC_DEFAULT,Y);CHKERRQ(ierr);}
+      PetscFunctionReturn(0);
+    }
+    ierr = MatGetLocalSize(A,&m,&n);CHKERRQ(ierr);
+    ierr = MatGetSize(X,NULL,&N);CHKERRQ(ierr);
+    ierr = MatCreateDense(PetscObjectComm((PetscObject)A),type == MATPRODUCT_AB ? m : n,PETSC_DECIDE,PETSC_DETERMINE,N,NULL,Y);CHKERRQ(ierr);
+  }
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  if (type == MATPRODUCT_AtB) {Vec t = x; x = y; y = t;}
+  ierr = MatDenseGetArrayRead(X,&xa);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(*Y,&ya);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(*Y,&ldy);CHKERRQ(ierr);
+  ierr = MatGetSize(X,NULL,&N);CHKERRQ(ierr);
+  for (j=0; j<N; j++) {
+    ierr = VecPlaceArray(x,xa+j*ldx);CHKERRQ(ierr);
+    ierr = VecPlaceArray(y,ya+j*ldy);CHKERRQ(ierr);
+    if (type == MATPRODUCT_AB) {ierr = MatMult(A,x,y);CHKERRQ(ierr);}
+    else {ierr = MatMultTranspose(A,x,y);CHKERRQ(ierr);}
+    ierr = VecResetArray(x);CHKERRQ(ierr);
+    ierr = VecResetArray(y);CHKERRQ(ierr);
+  }
+  ierr = MatDenseRestoreArrayRead(X,&xa);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(*Y,&ya);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    PCApplySymmetricLeft - Applies the left part of a symmetric preconditioner to a vector.
 
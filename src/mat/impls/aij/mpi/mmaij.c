@@ -5,6 +5,7 @@
 #include <../src/mat/impls/aij/mpi/mpiaij.h>
 #include <petsc/private/vecimpl.h>
 #include <petsc/private/isimpl.h>    /* needed because accesses data structure of ISLocalToGlobalMapping directly */
+#include <petscsf.h>
 
 PetscErrorCode MatSetUpMultiply_MPIAIJ(Mat mat)
 {
@@ -139,6 +140,113 @@ PetscErrorCode MatSetUpMultiply_MPIAIJ(Mat mat)
   PetscFunctionReturn(0);
 }
 
+/*
+     Sets up the communication of MatMult_MPIAIJ() with -mat_mpiaij_mult_overlap: the ghost values are received
+   from each neighbor straight into its contiguous part of lvec (garray is sorted and the columns are owned by
+   contiguous ranges of ranks), and the off-diagonal part is split into segments, one for each boundary row and
+   neighbor. Since the column indices of a row of B are sorted, the entries of a row with columns from one neighbor
+   are contiguous, so a segment is a range of B->j and B->a and the values never need to be copied.
+*/
+PetscErrorCode MatSetUpMultiplySplit_MPIAIJ(Mat mat)
+{
+  Mat_MPIAIJ           *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ           *b;
+  Mat_MPIAIJ_SplitMult *sp;
+  PetscErrorCode       ierr;
+  PetscSF              sf;
+  PetscInt             i,k,q,row,lastk,nleaves,nranks,niranks,nseg,*cnt;
+  const PetscMPIInt    *ranks,*iranks;
+  const PetscInt       *roffset,*rmine,*rremote,*ioffset,*irootloc;
+  PetscBool            isseqaij,usable = PETSC_TRUE;
+
+  PetscFunctionBegin;
+  ierr = MatResetMultiplySplit_MPIAIJ(mat);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)aij->B,MATSEQAIJ,&isseqaij);CHKERRQ(ierr);
+  if (!isseqaij || !aij->lvec) {
+    ierr = PetscInfo(mat,"The off-diagonal part is not MATSEQAIJ, MatMult() uses the VecScatter\n");CHKERRQ(ierr);
+    aij->multsplit = PETSC_FALSE;
+    PetscFunctionReturn(0);
+  }
+  b    = (Mat_SeqAIJ*)aij->B->data;
+  ierr = VecGetSize(aij->lvec,&nleaves);CHKERRQ(ierr);
+  ierr = PetscSFCreate(PetscObjectComm((PetscObject)mat),&sf);CHKERRQ(ierr);
+  ierr = PetscSFSetType(sf,PETSCSFBASIC);CHKERRQ(ierr);
+  ierr = PetscSFSetGraphLayout(sf,mat->cmap,nleaves,NULL,PETSC_COPY_VALUES,aij->garray);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscSFGetRootRanks(sf,&nranks,&ranks,&roffset,&rmine,&rremote);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafRanks(sf,&niranks,&iranks,&ioffset,&irootloc);CHKERRQ(ierr);
+  for (i=0; i<nleaves; i++) if (rmine[i] != i) usable = PETSC_FALSE;
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,&usable,1,MPIU_BOOL,MPI_LAND,PetscObjectComm((PetscObject)mat));CHKERRQ(ierr);
+  if (!usable) {
+    ierr = PetscInfo(mat,"The ghost values are not grouped by rank in lvec, MatMult() uses the VecScatter\n");CHKERRQ(ierr);
+    ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+    aij->multsplit = PETSC_FALSE;
+    PetscFunctionReturn(0);
+  }
+
+  ierr = PetscNew(&sp);CHKERRQ(ierr);
+  sp->nrecvs = nranks;
+  sp->nsends = niranks;
+  ierr = PetscMalloc5(nranks,&sp->recvranks,nranks+1,&sp->recvoffset,niranks,&sp->sendranks,niranks+1,&sp->sendoffset,ioffset[niranks],&sp->sendidx);CHKERRQ(ierr);
+  ierr = PetscMalloc3(ioffset[niranks],&sp->sendbuf,nranks+niranks,&sp->reqs,nranks,&sp->done);CHKERRQ(ierr);
+  ierr = PetscArraycpy(sp->recvranks,ranks,nranks);CHKERRQ(ierr);
+  ierr = PetscArraycpy(sp->recvoffset,roffset,nranks+1);CHKERRQ(ierr);
+  ierr = PetscArraycpy(sp->sendranks,iranks,niranks);CHKERRQ(ierr);
+  ierr = PetscArraycpy(sp->sendoffset,ioffset,niranks+1);CHKERRQ(ierr);
+  ierr = PetscArraycpy(sp->sendidx,irootloc,ioffset[niranks]);CHKERRQ(ierr);
+  for (i=0; i<nranks+niranks; i++) sp->reqs[i] = MPI_REQUEST_NULL;
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscObjectGetNewTag((PetscObject)mat,&sp->tag);CHKERRQ(ierr);
+
+  /* Count the segments of each neighbor, then fill them in row order */
+  ierr = PetscCalloc1(nranks+1,&sp->segoffset);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nranks+1,&cnt);CHKERRQ(ierr);
+  for (row=0; row<aij->B->rmap->n; row++) {
+    if (b->i[row+1] > b->i[row]) sp->nbrows++;
+    for (q=b->i[row],k=0,lastk=-1; q<b->i[row+1]; q++) {
+      while (b->j[q] >= sp->recvoffset[k+1]) k++;
+      if (k != lastk) {sp->segoffset[k+1]++; lastk = k;}
+    }
+  }
+  for (k=0; k<nranks; k++) sp->segoffset[k+1] += sp->segoffset[k];
+  nseg = sp->segoffset[nranks];
+  ierr = PetscMalloc3(nseg,&sp->segrow,nseg,&sp->segstart,nseg,&sp->segend);CHKERRQ(ierr);
+  ierr = PetscArraycpy(cnt,sp->segoffset,nranks);CHKERRQ(ierr);
+  for (row=0; row<aij->B->rmap->n; row++) {
+    for (q=b->i[row],k=0,lastk=-1; q<b->i[row+1]; q++) {
+      while (b->j[q] >= sp->recvoffset[k+1]) k++;
+      if (k != lastk) {
+        sp->segrow[cnt[k]]   = row;
+        sp->segstart[cnt[k]] = q;
+        cnt[k]++;
+        lastk = k;
+      }
+      sp->segend[cnt[k]-1] = q+1;
+    }
+  }
+  ierr = PetscFree(cnt);CHKERRQ(ierr);
+  sp->nonzerostate = mat->nonzerostate;
+  aij->split       = sp;
+  ierr = PetscInfo3(mat,"MatMult() applies the off-diagonal part per neighbor: %D neighbors, %D boundary rows in %D segments\n",nranks,sp->nbrows,nseg);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatResetMultiplySplit_MPIAIJ(Mat mat)
+{
+  Mat_MPIAIJ           *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_MPIAIJ_SplitMult *sp  = aij->split;
+  PetscErrorCode       ierr;
+
+  PetscFunctionBegin;
+  if (!sp) PetscFunctionReturn(0);
+  ierr = PetscFree5(sp->recvranks,sp->recvoffset,sp->sendranks,sp->sendoffset,sp->sendidx);CHKERRQ(ierr);
+  ierr = PetscFree3(sp->sendbuf,sp->reqs,sp->done);CHKERRQ(ierr);
+  ierr = PetscFree(sp->segoffset);CHKERRQ(ierr);
+  ierr = PetscFree3(sp->segrow,sp->segstart,sp->segend);CHKERRQ(ierr);
+  ierr = PetscFree(aij->split);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
      Takes the local part of an already assembled MPIAIJ matrix
    and disassembles it. This is to allow new nonzeros into the matrix
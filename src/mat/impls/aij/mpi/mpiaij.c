@@ -16,7 +16,9 @@
   the above preallocation routines for simplicity.
 
    Options Database Keys:
-. -mat_type aij - sets the matrix type to "aij" during a call to MatSetFromOptions()
++ -mat_type aij - sets the matrix type to "aij" during a call to MatSetFromOptions()
+- -mat_aij_hash_assembly - if the matrix is not preallocated, MatSetUp() collects the entries given to MatSetValues() in a hash table
+                           and the first MAT_FINAL_ASSEMBLY preallocates exactly the nonzeros that were set
 
   Developer Notes:
     Subclasses include MATAIJCUSP, MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
@@ -1100,6 +1102,63 @@ PetscErrorCode MatZeroRowsColumns_MPIAIJ(Mat A,PetscInt N,const PetscInt rows[],
   PetscFunctionReturn(0);
 }
 
+/*
+   The ghost values of each neighbor are received into lvec and the segments of the boundary rows with columns from that
+   neighbor are added to yy as soon as its message is in, so the slowest neighbor only delays its own segments
+*/
+static PetscErrorCode MatMult_MPIAIJ_Split(Mat A,Vec xx,Vec yy)
+{
+  Mat_MPIAIJ           *a = (Mat_MPIAIJ*)A->data;
+  Mat_MPIAIJ_SplitMult *sp = a->split;
+  Mat_SeqAIJ           *b = (Mat_SeqAIJ*)a->B->data;
+  const PetscScalar    *x;
+  PetscScalar          *y,*lv,sum;
+  const MatScalar      *ba = b->a;
+  const PetscInt       *bj = b->j;
+  PetscInt             i,k,p,q,ndone;
+  PetscMPIInt          n,outcount;
+  MPI_Comm             comm = PetscObjectComm((PetscObject)A);
+  PetscErrorCode       ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetArray(a->lvec,&lv);CHKERRQ(ierr);
+  for (k=0; k<sp->nrecvs; k++) {
+    ierr = PetscMPIIntCast(sp->recvoffset[k+1]-sp->recvoffset[k],&n);CHKERRQ(ierr);
+    ierr = MPI_Irecv(lv+sp->recvoffset[k],n,MPIU_SCALAR,sp->recvranks[k],sp->tag,comm,&sp->reqs[k]);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  for (i=0; i<sp->sendoffset[sp->nsends]; i++) sp->sendbuf[i] = x[sp->sendidx[i]];
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  for (k=0; k<sp->nsends; k++) {
+    ierr = PetscMPIIntCast(sp->sendoffset[k+1]-sp->sendoffset[k],&n);CHKERRQ(ierr);
+    ierr = MPI_Isend(sp->sendbuf+sp->sendoffset[k],n,MPIU_SCALAR,sp->sendranks[k],sp->tag,comm,&sp->reqs[sp->nrecvs+k]);CHKERRQ(ierr);
+  }
+
+  ierr = (*a->A->ops->mult)(a->A,xx,yy);CHKERRQ(ierr);
+
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  for (ndone=0; ndone<sp->nrecvs; ndone+=outcount) {
+    ierr = PetscLogEventBegin(MAT_MultHaloWait,A,0,0,0);CHKERRQ(ierr);
+    ierr = MPI_Waitsome((PetscMPIInt)sp->nrecvs,sp->reqs,&outcount,sp->done,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(MAT_MultHaloWait,A,0,0,0);CHKERRQ(ierr);
+    ierr = PetscLogEventBegin(MAT_MultOffDiag,A,0,0,0);CHKERRQ(ierr);
+    for (i=0; i<outcount; i++) {
+      k = sp->done[i];
+      for (p=sp->segoffset[k]; p<sp->segoffset[k+1]; p++) {
+        sum = y[sp->segrow[p]];
+        for (q=sp->segstart[p]; q<sp->segend[p]; q++) sum += ba[q]*lv[bj[q]];
+        y[sp->segrow[p]] = sum;
+      }
+    }
+    ierr = PetscLogEventEnd(MAT_MultOffDiag,A,0,0,0);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  ierr = VecRestoreArray(a->lvec,&lv);CHKERRQ(ierr);
+  ierr = MPI_Waitall((PetscMPIInt)sp->nsends,sp->reqs+sp->nrecvs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*b->nz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatMult_MPIAIJ(Mat A,Vec xx,Vec yy)
 {
   Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
@@ -1111,6 +1170,14 @@ PetscErrorCode MatMult_MPIAIJ(Mat A,Vec xx,Vec yy)
   ierr = VecGetLocalSize(xx,&nt);CHKERRQ(ierr);
   if (nt != A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Incompatible partition of A (%D) and xx (%D)",A->cmap->n,nt);
 
+  if (a->multsplit) {
+    if (!a->split || a->split->nonzerostate != A->nonzerostate) {ierr = MatSetUpMultiplySplit_MPIAIJ(A);CHKERRQ(ierr);}
+    if (a->split) {
+      ierr = MatMult_MPIAIJ_Split(A,xx,yy);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+  }
+
   ierr = VecScatterBegin(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
   ierr = (*a->A->ops->mult)(a->A,xx,yy);CHKERRQ(ierr);
   ierr = VecScatterEnd(Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
@@ -1275,8 +1342,10 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   ierr = VecDestroy(&aij->lvec);CHKERRQ(ierr);
   ierr = VecScatterDestroy(&aij->Mvctx);CHKERRQ(ierr);
   if (aij->Mvctx_mpi1) {ierr = VecScatterDestroy(&aij->Mvctx_mpi1);CHKERRQ(ierr);}
+  ierr = MatResetMultiplySplit_MPIAIJ(mat);CHKERRQ(ierr);
   ierr = PetscFree2(aij->rowvalues,aij->rowindices);CHKERRQ(ierr);
   ierr = PetscFree(aij->ld);CHKERRQ(ierr);
+  ierr = MatResetCOO_MPIAIJ(mat);CHKERRQ(ierr);
   ierr = PetscFree(mat->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)mat,0);CHKERRQ(ierr);
@@ -1299,6 +1368,8 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpiaij_is_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatProductSetFromOptions_is_mpiaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatProductSetFromOptions_mpiaij_mpiaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1423,6 +1494,12 @@ PetscErrorCode MatView_MPIAIJ_ASCIIorDraworSocket(Mat mat,PetscViewer viewer)
       ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] on-diagonal part: nz %D \n",rank,(PetscInt)info.nz_used);CHKERRQ(ierr);
       ierr = MatGetInfo(aij->B,MAT_LOCAL,&info);CHKERRQ(ierr);
       ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] off-diagonal part: nz %D \n",rank,(PetscInt)info.nz_used);CHKERRQ(ierr);
+      if (((Mat_SeqAIJ*)aij->A->data)->cindices.use || ((Mat_SeqAIJ*)aij->B->data)->cindices.use) {
+        ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] compressed column indices: MatMult() reads %D fewer bytes of indices in the on-diagonal part, %D in the off-diagonal part\n",rank,((Mat_SeqAIJ*)aij->A->data)->cindices.saved,((Mat_SeqAIJ*)aij->B->data)->cindices.saved);CHKERRQ(ierr);
+      }
+      if (aij->split) {
+        ierr = PetscViewerASCIISynchronizedPrintf(viewer,"[%d] MatMult() applies the off-diagonal part per neighbor: %D neighbors, %D boundary and %D interior rows\n",rank,aij->split->nrecvs,aij->split->nbrows,mat->rmap->n-aij->split->nbrows);CHKERRQ(ierr);
+      }
       ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
       ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
       ierr = PetscViewerASCIIPrintf(viewer,"Information on VecScatter used in matrix-vector product: \n");CHKERRQ(ierr);
@@ -1436,6 +1513,9 @@ PetscErrorCode MatView_MPIAIJ_ASCIIorDraworSocket(Mat mat,PetscViewer viewer)
       } else {
         ierr = PetscViewerASCIIPrintf(viewer,"not using I-node (on process 0) routines\n");CHKERRQ(ierr);
       }
+      if (((Mat_SeqAIJ*)aij->A->data)->cindices.use) {
+        ierr = PetscViewerASCIIPrintf(viewer,"using compressed column indices (on process 0): %D byte offsets, MatMult() reads %D fewer bytes of indices in the on-diagonal part\n",((Mat_SeqAIJ*)aij->A->data)->cindices.width,((Mat_SeqAIJ*)aij->A->data)->cindices.saved);CHKERRQ(ierr);
+      }
       PetscFunctionReturn(0);
     } else if (format == PETSC_VIEWER_ASCII_FACTOR_INFO) {
       PetscFunctionReturn(0);
@@ -2165,8 +2245,14 @@ PetscErrorCode MatCopy_MPIAIJ(Mat A,Mat B,MatStructure str)
 PetscErrorCode MatSetUp_MPIAIJ(Mat A)
 {
   PetscErrorCode ierr;
+  PetscBool      hash = PETSC_FALSE;
 
   PetscFunctionBegin;
+  ierr = PetscOptionsGetBool(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_aij_hash_assembly",&hash,NULL);CHKERRQ(ierr);
+  if (hash) {
+    ierr = MatSetUpHash_Private(A);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = MatMPIAIJSetPreallocation(A,PETSC_DEFAULT,0,PETSC_DEFAULT,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -2523,6 +2609,7 @@ PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap(Mat A,PetscBool sc)
 
 PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat A)
 {
+  Mat_MPIAIJ           *a = (Mat_MPIAIJ*)A->data;
   PetscErrorCode       ierr;
   PetscBool            sc = PETSC_FALSE,flg;
 
@@ -2533,6 +2620,7 @@ PetscErrorCode MatSetFromOptions_MPIAIJ(PetscOptionItems *PetscOptionsObject,Mat
   if (flg) {
     ierr = MatMPIAIJSetUseScalableIncreaseOverlap(A,sc);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsBool("-mat_mpiaij_mult_overlap","Apply the off-diagonal part in MatMult() per neighbor as its ghost values arrive","MatMult",a->multsplit,&a->multsplit,NULL);CHKERRQ(ierr);
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -2853,6 +2941,7 @@ PetscErrorCode MatDuplicate_MPIAIJ(Mat matin,MatDuplicateOption cpvalues,Mat *ne
   a->rank         = oldmat->rank;
   a->donotstash   = oldmat->donotstash;
   a->roworiented  = oldmat->roworiented;
+  a->multsplit    = oldmat->multsplit;
   a->rowindices   = NULL;
   a->rowvalues    = NULL;
   a->getrowactive = PETSC_FALSE;
@@ -3814,6 +3903,242 @@ PetscErrorCode MatMPIAIJSetPreallocationCSR_MPIAIJ(Mat B,const PetscInt Ii[],con
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode MatResetCOO_MPIAIJ(Mat mat)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFDestroy(&aij->coo_sf);CHKERRQ(ierr);
+  ierr = PetscFree(aij->coo_sendperm);CHKERRQ(ierr);
+  ierr = PetscFree2(aij->coo_sendbuf,aij->coo_recvbuf);CHKERRQ(ierr);
+  ierr = PetscFree4(aij->Ajmap1,aij->Aperm1,aij->Ajmap2,aij->Aperm2);CHKERRQ(ierr);
+  ierr = PetscFree4(aij->Bjmap1,aij->Bperm1,aij->Bjmap2,aij->Bperm2);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Entries in rows owned by other processes are shipped to their owners once, with the same two-sided
+   handshake used by the scalable MatIncreaseOverlap(); the resulting PetscSF is kept so that MatSetValuesCOO()
+   only has to move the values. On the owner, local entries have tags [0,ncoo) and received entries have
+   tags ncoo + their position in the receive buffer, so each nonzero of the diagonal (A) and off-diagonal (B)
+   blocks gets two maps: one into the user's value array and one into the receive buffer.
+*/
+PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat mat,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ     *a,*b;
+  MPI_Comm       comm;
+  PetscMPIInt    rank,size,owner,*eowner,*toranks,*fromranks;
+  PetscInt       M,N,m,rstart,rend,cstart,cend,k,t,p,r,nown,nsend,nrecv,nto,nfrom,nv;
+  PetscInt       *tocounts,*tosizes,*fromsizes,*sendi,*sendj,*recvi,*recvj,*sendperm;
+  PetscInt       *rows,*cols,*src,*Ci,*Cj,*jmap,*perm;
+  PetscInt       Ak,Bk,n1A,n2A,n1B,n2B;
+  PetscSFNode    *remote;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr   = PetscObjectGetComm((PetscObject)mat,&comm);CHKERRQ(ierr);
+  ierr   = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr   = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr   = PetscLayoutSetUp(mat->rmap);CHKERRQ(ierr);
+  ierr   = PetscLayoutSetUp(mat->cmap);CHKERRQ(ierr);
+  ierr   = MatGetSize(mat,&M,&N);CHKERRQ(ierr);
+  m      = mat->rmap->n;
+  rstart = mat->rmap->rstart;
+  rend   = mat->rmap->rend;
+  cstart = mat->cmap->rstart;
+  cend   = mat->cmap->rend;
+  ierr   = MatResetCOO_MPIAIJ(mat);CHKERRQ(ierr);
+
+  /* find the owner of each entry, negative indices are ignored */
+  ierr = PetscMalloc1(ncoo,&eowner);CHKERRQ(ierr);
+  ierr = PetscCalloc1(size,&tocounts);CHKERRQ(ierr);
+  for (k=0,nown=0,nsend=0; k<ncoo; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) {eowner[k] = -1; continue;}
+    if (coo_i[k] >= M) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry %D has row index %D, must be less than %D",k,coo_i[k],M);
+    if (coo_j[k] >= N) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry %D has column index %D, must be less than %D",k,coo_j[k],N);
+    if (rstart <= coo_i[k] && coo_i[k] < rend) {
+      eowner[k] = rank;
+      nown++;
+    } else {
+      ierr      = PetscLayoutFindOwner(mat->rmap,coo_i[k],&owner);CHKERRQ(ierr);
+      eowner[k] = owner;
+      tocounts[owner]++;
+      nsend++;
+    }
+  }
+
+  /* message <count, offset in the sender's buffer> to each owner */
+  for (r=0,nto=0; r<size; r++) if (tocounts[r]) nto++;
+  ierr = PetscMalloc2(nto,&toranks,2*nto,&tosizes);CHKERRQ(ierr);
+  for (r=0,nto=0,p=0; r<size; r++) {
+    if (tocounts[r]) {
+      toranks[nto]      = r;
+      tosizes[2*nto]    = tocounts[r];
+      tosizes[2*nto+1]  = p;
+      tocounts[r]       = p; /* now the insertion point for rank r */
+      p                += tosizes[2*nto];
+      nto++;
+    }
+  }
+  ierr = PetscMalloc1(nsend,&sendperm);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nsend,&sendi,nsend,&sendj);CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    if (eowner[k] < 0 || eowner[k] == rank) continue;
+    p           = tocounts[eowner[k]]++;
+    sendperm[p] = k;
+    sendi[p]    = coo_i[k];
+    sendj[p]    = coo_j[k];
+  }
+  ierr = PetscCommBuildTwoSided(comm,2,MPIU_INT,nto,toranks,tosizes,&nfrom,&fromranks,&fromsizes);CHKERRQ(ierr);
+  ierr = PetscFree2(toranks,tosizes);CHKERRQ(ierr);
+  ierr = PetscFree(tocounts);CHKERRQ(ierr);
+
+  for (r=0,nrecv=0; r<nfrom; r++) nrecv += fromsizes[2*r];
+  ierr = PetscMalloc1(nrecv,&remote);CHKERRQ(ierr);
+  for (r=0,nrecv=0; r<nfrom; r++) {
+    for (t=0; t<fromsizes[2*r]; t++) {
+      remote[nrecv].rank    = fromranks[r];
+      remote[nrecv++].index = fromsizes[2*r+1]+t;
+    }
+  }
+  ierr = PetscFree(fromranks);CHKERRQ(ierr);
+  ierr = PetscFree(fromsizes);CHKERRQ(ierr);
+  ierr = PetscSFCreate(comm,&aij->coo_sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(aij->coo_sf,nsend,nrecv,NULL,PETSC_OWN_POINTER,remote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetType(aij->coo_sf,PETSCSFBASIC);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(aij->coo_sf);CHKERRQ(ierr);
+
+  ierr = PetscMalloc2(nrecv,&recvi,nrecv,&recvj);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(aij->coo_sf,MPIU_INT,sendi,recvi);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(aij->coo_sf,MPIU_INT,sendi,recvi);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(aij->coo_sf,MPIU_INT,sendj,recvj);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(aij->coo_sf,MPIU_INT,sendj,recvj);CHKERRQ(ierr);
+
+  /* merge local and received entries into the CSR structure of the local rows */
+  nv   = nown + nrecv;
+  ierr = PetscMalloc3(nv,&rows,nv,&cols,nv,&src);CHKERRQ(ierr);
+  for (k=0,p=0; k<ncoo; k++) {
+    if (eowner[k] != rank) continue;
+    rows[p] = coo_i[k] - rstart;
+    cols[p] = coo_j[k];
+    src[p]  = k;
+    p++;
+  }
+  for (t=0; t<nrecv; t++) {
+    if (recvi[t] < rstart || recvi[t] >= rend) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Received row %D not in local range [%D,%D)",recvi[t],rstart,rend);
+    rows[p] = recvi[t] - rstart;
+    cols[p] = recvj[t];
+    src[p]  = ncoo + t;
+    p++;
+  }
+  ierr = PetscFree(eowner);CHKERRQ(ierr);
+  ierr = PetscFree2(sendi,sendj);CHKERRQ(ierr);
+  ierr = PetscFree2(recvi,recvj);CHKERRQ(ierr);
+  ierr = MatSeqAIJCOOMerge_Private(m,nv,rows,cols,src,&Ci,&Cj,&jmap,&perm);CHKERRQ(ierr);
+  ierr = PetscFree3(rows,cols,src);CHKERRQ(ierr);
+
+  if (mat->preallocated) {ierr = MatSetOption(mat,MAT_NEW_NONZERO_LOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);}
+  ierr = MatMPIAIJSetPreallocationCSR(mat,Ci,Cj,NULL);CHKERRQ(ierr);
+
+  /* split the merged map between A and B; columns are sorted, so the k-th diagonal (off-diagonal) nonzero of a row
+     is the k-th entry of that row of A (B), also after B's columns are compacted by MatSetUpMultiply_MPIAIJ() */
+  a = (Mat_SeqAIJ*)aij->A->data;
+  b = (Mat_SeqAIJ*)aij->B->data;
+  n1A = n2A = n1B = n2B = 0;
+  for (k=0; k<Ci[m]; k++) {
+    PetscBool diag = (PetscBool)(cstart <= Cj[k] && Cj[k] < cend);
+    for (t=jmap[k]; t<jmap[k+1]; t++) {
+      if (perm[t] < ncoo) {if (diag) n1A++; else n1B++;}
+      else                {if (diag) n2A++; else n2B++;}
+    }
+  }
+  ierr = PetscMalloc4(a->nz+1,&aij->Ajmap1,n1A,&aij->Aperm1,a->nz+1,&aij->Ajmap2,n2A,&aij->Aperm2);CHKERRQ(ierr);
+  ierr = PetscMalloc4(b->nz+1,&aij->Bjmap1,n1B,&aij->Bperm1,b->nz+1,&aij->Bjmap2,n2B,&aij->Bperm2);CHKERRQ(ierr);
+  aij->Ajmap1[0] = aij->Ajmap2[0] = aij->Bjmap1[0] = aij->Bjmap2[0] = 0;
+  n1A = n2A = n1B = n2B = 0;
+  for (k=0,Ak=0,Bk=0; k<Ci[m]; k++) {
+    if (cstart <= Cj[k] && Cj[k] < cend) {
+      for (t=jmap[k]; t<jmap[k+1]; t++) {
+        if (perm[t] < ncoo) aij->Aperm1[n1A++] = perm[t];
+        else                aij->Aperm2[n2A++] = perm[t] - ncoo;
+      }
+      Ak++;
+      aij->Ajmap1[Ak] = n1A;
+      aij->Ajmap2[Ak] = n2A;
+    } else {
+      for (t=jmap[k]; t<jmap[k+1]; t++) {
+        if (perm[t] < ncoo) aij->Bperm1[n1B++] = perm[t];
+        else                aij->Bperm2[n2B++] = perm[t] - ncoo;
+      }
+      Bk++;
+      aij->Bjmap1[Bk] = n1B;
+      aij->Bjmap2[Bk] = n2B;
+    }
+  }
+  if (Ak != a->nz || Bk != b->nz) SETERRQ4(PETSC_COMM_SELF,PETSC_ERR_PLIB,"COO map has %D+%D nonzeros but the matrix has %D+%D",Ak,Bk,a->nz,b->nz);
+  ierr = PetscFree(Ci);CHKERRQ(ierr);
+  ierr = PetscFree(Cj);CHKERRQ(ierr);
+  ierr = PetscFree(jmap);CHKERRQ(ierr);
+  ierr = PetscFree(perm);CHKERRQ(ierr);
+
+  aij->coo_n            = ncoo;
+  aij->coo_nsend        = nsend;
+  aij->coo_nrecv        = nrecv;
+  aij->coo_sendperm     = sendperm;
+  aij->coo_nonzerostate = mat->nonzerostate;
+  ierr = PetscMalloc2(nsend,&aij->coo_sendbuf,nrecv,&aij->coo_recvbuf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat mat,const PetscScalar v[],InsertMode imode)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)aij->A->data,*b = (Mat_SeqAIJ*)aij->B->data;
+  MatScalar      *Aa = a->a,*Ba = b->a;
+  PetscScalar    *sendbuf = aij->coo_sendbuf,*recvbuf = aij->coo_recvbuf,sum;
+  const PetscInt *Ajmap1 = aij->Ajmap1,*Aperm1 = aij->Aperm1,*Ajmap2 = aij->Ajmap2,*Aperm2 = aij->Aperm2;
+  const PetscInt *Bjmap1 = aij->Bjmap1,*Bperm1 = aij->Bperm1,*Bjmap2 = aij->Bjmap2,*Bperm2 = aij->Bperm2;
+  PetscInt       k,t;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!Ajmap1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  if (mat->nonzerostate != aij->coo_nonzerostate) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Nonzero pattern changed since MatSetPreallocationCOO()");
+  if (aij->coo_n) PetscValidScalarPointer(v,2);
+
+  /* send the entries of rows owned by others, and add up the local entries while the messages are in flight */
+  for (k=0; k<aij->coo_nsend; k++) sendbuf[k] = v[aij->coo_sendperm[k]];
+  ierr = PetscSFBcastBegin(aij->coo_sf,MPIU_SCALAR,sendbuf,recvbuf);CHKERRQ(ierr);
+  for (k=0; k<a->nz; k++) {
+    sum = 0.0;
+    for (t=Ajmap1[k]; t<Ajmap1[k+1]; t++) sum += v[Aperm1[t]];
+    Aa[k] = (imode == INSERT_VALUES ? 0.0 : Aa[k]) + sum;
+  }
+  for (k=0; k<b->nz; k++) {
+    sum = 0.0;
+    for (t=Bjmap1[k]; t<Bjmap1[k+1]; t++) sum += v[Bperm1[t]];
+    Ba[k] = (imode == INSERT_VALUES ? 0.0 : Ba[k]) + sum;
+  }
+  ierr = PetscSFBcastEnd(aij->coo_sf,MPIU_SCALAR,sendbuf,recvbuf);CHKERRQ(ierr);
+  for (k=0; k<a->nz; k++) {
+    for (t=Ajmap2[k]; t<Ajmap2[k+1]; t++) Aa[k] += recvbuf[Aperm2[t]];
+  }
+  for (k=0; k<b->nz; k++) {
+    for (t=Bjmap2[k]; t<Bjmap2[k+1]; t++) Ba[k] += recvbuf[Bperm2[t]];
+  }
+
+  ierr = MatSeqAIJInvalidateDiagonal(aij->A);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)aij->A);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)aij->B);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA)
+  if (aij->A->offloadmask != PETSC_OFFLOAD_UNALLOCATED) aij->A->offloadmask = PETSC_OFFLOAD_CPU;
+  if (aij->B->offloadmask != PETSC_OFFLOAD_UNALLOCATED) aij->B->offloadmask = PETSC_OFFLOAD_CPU;
+#endif
+  PetscFunctionReturn(0);
+}
+
 /*@
    MatMPIAIJSetPreallocationCSR - Allocates memory for a sparse parallel matrix in AIJ format
    (the default parallel PETSc format).
@@ -5832,7 +6157,9 @@ PETSC_INTERN PetscErrorCode MatProductSetFromOptions_MPIDense_MPIAIJ(Mat C)
    MATMPIAIJ - MATMPIAIJ = "mpiaij" - A matrix type to be used for parallel sparse matrices.
 
    Options Database Keys:
-. -mat_type mpiaij - sets the matrix type to "mpiaij" during a call to MatSetFromOptions()
++ -mat_type mpiaij - sets the matrix type to "mpiaij" during a call to MatSetFromOptions()
+- -mat_mpiaij_mult_overlap - MatMult() adds the off-diagonal part of each boundary row per neighboring process, as soon as the ghost values of that
+                             neighbor arrive, instead of after all of them; the log events MatMultHaloWait and MatMultOffDiag time the waits and the updates
 
    Level: beginner
 
@@ -5914,6 +6241,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
 #endif
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatProductSetFromOptions_is_mpiaij_C",MatProductSetFromOptions_IS_XAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatProductSetFromOptions_mpiaij_mpiaij_C",MatProductSetFromOptions_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJ);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -32,6 +32,7 @@ typedef struct { /* used by MatPtAPXXX_MPIAIJ_MPIAIJ() and MatMatMultXXX_MPIAIJ_
   PetscInt                algType;                 /* implementation algorithm */
   PetscSF                 sf;                      /* use it to communicate remote part of C */
   PetscInt                *c_othi,*c_rmti;
+  PetscInt                *c_othj,*c_rmtj;          /* sorted column indices of the remote part of C, so numeric products only send values */
 
   Mat_Merge_SeqsToMPI *merge;
   PetscErrorCode (*destroy)(Mat);
@@ -39,6 +40,21 @@ typedef struct { /* used by MatPtAPXXX_MPIAIJ_MPIAIJ() and MatMatMultXXX_MPIAIJ_
   PetscErrorCode (*view)(Mat,PetscViewer);
 } Mat_APMPI;
 
+typedef struct { /* used by MatMult_MPIAIJ() to apply the off-diagonal part per neighbor as its ghost values arrive */
+  PetscInt         nrecvs,nsends;             /* number of ranks sending us ghost values, and of ranks we send values to */
+  PetscMPIInt      *recvranks,*sendranks;
+  PetscInt         *recvoffset;               /* [nrecvs+1] values from recvranks[k] go to lvec[recvoffset[k]:recvoffset[k+1]] */
+  PetscInt         *sendoffset,*sendidx;      /* [nsends+1] x[sendidx[sendoffset[k]:sendoffset[k+1]]] go to sendranks[k] */
+  PetscScalar      *sendbuf;
+  MPI_Request      *reqs;                     /* [nrecvs+nsends] receives, then sends */
+  PetscMPIInt      *done;                     /* [nrecvs] indices of completed receives returned by MPI_Waitsome() */
+  PetscMPIInt      tag;
+  PetscInt         nbrows;                    /* number of boundary rows, the rows with entries in the off-diagonal part */
+  PetscInt         *segoffset;                /* [nrecvs+1] segments of the boundary rows with columns from recvranks[k] */
+  PetscInt         *segrow,*segstart,*segend; /* row of each segment and its range of entries in B->j and B->a */
+  PetscObjectState nonzerostate;              /* nonzero state of the matrix the segments were built for */
+} Mat_MPIAIJ_SplitMult;
+
 typedef struct {
   Mat A,B;                             /* local submatrices: A (diag part),
                                            B (off-diag part) */
@@ -65,6 +81,8 @@ typedef struct {
   VecScatter Mvctx,Mvctx_mpi1;     /* scatter context for vector */
   PetscBool  Mvctx_mpi1_flg;       /* if true, additional Mvctx_mpi1 is requested for mat-mat ops, default false */
   PetscBool  roworiented;          /* if true, row-oriented input, default true */
+  PetscBool  multsplit;            /* if true, MatMult() applies B per neighbor as the ghost values arrive, default false */
+  Mat_MPIAIJ_SplitMult *split;     /* used by MatMult() when multsplit is true */
 
   /* The following variables are for MatGetRow() */
   PetscInt    *rowindices;         /* column indices for row */
@@ -78,6 +96,17 @@ typedef struct {
   Mat_RARt          *rart;            /* used by MatRARt() */
   Mat_MatMatMatMult *matmatmatmult;   /* used by MatMatMatMult() */
 
+  /* Used by MatSetPreallocationCOO() and MatSetValuesCOO() */
+  PetscInt         coo_n;                   /* number of entries given to MatSetPreallocationCOO() */
+  PetscSF          coo_sf;                  /* moves entries of rows owned by other processes to their owners */
+  PetscInt         coo_nsend,coo_nrecv;     /* number of entries sent and received through coo_sf */
+  PetscInt         *coo_sendperm;           /* coo_sendbuf[k] = coo_v[coo_sendperm[k]] */
+  PetscScalar      *coo_sendbuf,*coo_recvbuf;
+  PetscInt         *Ajmap1,*Aperm1;         /* A->a[k] gets coo_v[Aperm1[Ajmap1[k]..Ajmap1[k+1]-1]] */
+  PetscInt         *Ajmap2,*Aperm2;         /* and coo_recvbuf[Aperm2[Ajmap2[k]..Ajmap2[k+1]-1]] */
+  PetscInt         *Bjmap1,*Bperm1,*Bjmap2,*Bperm2; /* same for B */
+  PetscObjectState coo_nonzerostate;        /* nonzero state when the COO maps were built */
+
   /* Used by MPICUSP and MPICUSPARSE classes */
   void * spptr;
 
@@ -89,6 +118,8 @@ PETSC_INTERN PetscErrorCode MatAssemblyEnd_MPIAIJ(Mat,MatAssemblyType);
 
 PETSC_INTERN PetscErrorCode MatSetUpMultiply_MPIAIJ(Mat);
 PETSC_INTERN PetscErrorCode MatDisAssemble_MPIAIJ(Mat);
+PETSC_INTERN PetscErrorCode MatSetUpMultiplySplit_MPIAIJ(Mat);
+PETSC_INTERN PetscErrorCode MatResetMultiplySplit_MPIAIJ(Mat);
 PETSC_INTERN PetscErrorCode MatDuplicate_MPIAIJ(Mat,MatDuplicateOption,Mat*);
 PETSC_INTERN PetscErrorCode MatIncreaseOverlap_MPIAIJ(Mat,PetscInt,IS [],PetscInt);
 PETSC_INTERN PetscErrorCode MatIncreaseOverlap_MPIAIJ_Scalable(Mat,PetscInt,IS [],PetscInt);
@@ -108,6 +139,9 @@ PETSC_INTERN PetscErrorCode MatGetMultiProcBlock_MPIAIJ(Mat,MPI_Comm,MatReuse,Ma
 PETSC_INTERN PetscErrorCode MatLoad_MPIAIJ(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatLoad_MPIAIJ_Binary(Mat,PetscViewer);
 PETSC_INTERN PetscErrorCode MatCreateColmap_MPIAIJ_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat,const PetscScalar[],InsertMode);
+PETSC_INTERN PetscErrorCode MatResetCOO_MPIAIJ(Mat);
 
 PETSC_INTERN PetscErrorCode MatProductSetFromOptions_MPIAIJ(Mat);
 PETSC_INTERN PetscErrorCode MatProductSymbolic_AB_MPIAIJ_MPIAIJ(Mat);
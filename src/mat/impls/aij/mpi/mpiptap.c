@@ -103,6 +103,8 @@ PetscErrorCode MatFreeIntermediateDataStructures_MPIAIJ_AP(Mat A)
   ierr = PetscSFDestroy(&ptap->sf);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_othi);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_rmti);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->c_othj);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->c_rmtj);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -751,6 +753,24 @@ PETSC_STATIC_INLINE PetscErrorCode MatPtAPNumericComputeOneRowOfAP_private(Mat A
 
 PetscErrorCode MatGetBrowsOfAcols_MPIXAIJ(Mat,Mat,PetscInt dof,MatReuse,Mat*);
 
+/* adds v*AP(i,:) to the row pocol of the remote part of C, whose sorted column indices were computed by the symbolic product */
+static PetscErrorCode MatPtAPNumericAddToRemoteRow_private(Mat_APMPI *ptap,PetscInt pocol,PetscInt voff,const PetscInt apindices[],const PetscScalar apvalues[],PetscScalar v,PetscScalar c_rmta[])
+{
+  PetscErrorCode ierr;
+  PetscInt       jj,loc,nzr = ptap->c_rmti[pocol+1] - ptap->c_rmti[pocol];
+  const PetscInt *c_rmtjj = ptap->c_rmtj + ptap->c_rmti[pocol];
+  PetscScalar    *c_rmtaa = c_rmta + ptap->c_rmti[pocol];
+
+  PetscFunctionBegin;
+  for (jj=0; jj<voff; jj++) {
+    ierr = PetscFindInt(apindices[jj],nzr,c_rmtjj,&loc);CHKERRQ(ierr);
+    if (loc < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Column %D of A*P is not in the nonzero structure of the symbolic product; the nonzero structure of A or P changed",apindices[jj]);
+    c_rmtaa[loc] += apvalues[jj]*v;
+  }
+  ierr = PetscLogFlops(2.0*voff);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce(Mat A,Mat P,PetscInt dof,Mat C)
 {
   PetscErrorCode    ierr;
@@ -758,8 +778,8 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce(Mat A,Mat P,PetscInt dof,
   Mat_SeqAIJ        *cd,*co,*po=(Mat_SeqAIJ*)p->B->data,*pd=(Mat_SeqAIJ*)p->A->data;
   Mat_APMPI         *ptap = c->ap;
   PetscHMapIV       hmap;
-  PetscInt          i,j,jj,kk,nzi,*c_rmtj,voff,*c_othj,pn,pon,pcstart,pcend,ccstart,ccend,row,am,*poj,*pdj,*apindices,cmaxr,*c_rmtc,*c_rmtjj,*dcc,*occ,loc;
-  PetscScalar       *c_rmta,*c_otha,*poa,*pda,*apvalues,*apvaluestmp,*c_rmtaa;
+  PetscInt          i,j,jj,nzi,voff,pn,pon,pcstart,pcend,ccstart,ccend,row,am,*poj,*pdj,*apindices,cmaxr,*dcc,*occ;
+  PetscScalar       *c_rmta,*c_otha,*poa,*pda,*apvalues,*apvaluestmp;
   PetscInt          offset,ii,pocol;
   const PetscInt    *mappingindices;
   IS                map;
@@ -774,23 +794,26 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce(Mat A,Mat P,PetscInt dof,
   /* Get P_oth = ptap->P_oth  and P_loc = ptap->P_loc */
   /*-----------------------------------------------------*/
   if (ptap->reuse == MAT_REUSE_MATRIX) {
-    /* P_oth and P_loc are obtained in MatPtASymbolic() when reuse == MAT_INITIAL_MATRIX */
+    /* P_oth and P_loc are obtained in MatPtASymbolic() when reuse == MAT_INITIAL_MATRIX; only the values are updated here */
+    ierr = PetscLogEventBegin(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
     ierr =  MatGetBrowsOfAcols_MPIXAIJ(A,P,dof,MAT_REUSE_MATRIX,&ptap->P_oth);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
   }
   ierr = PetscObjectQuery((PetscObject)ptap->P_oth,"aoffdiagtopothmapping",(PetscObject*)&map);CHKERRQ(ierr);
 
   ierr = MatGetLocalSize(p->B,NULL,&pon);CHKERRQ(ierr);
   pon *= dof;
-  ierr = PetscCalloc2(ptap->c_rmti[pon],&c_rmtj,ptap->c_rmti[pon],&c_rmta);CHKERRQ(ierr);
+  ierr = PetscCalloc1(ptap->c_rmti[pon],&c_rmta);CHKERRQ(ierr);
   ierr = MatGetLocalSize(A,&am,NULL);CHKERRQ(ierr);
   cmaxr = 0;
   for (i=0; i<pon; i++) {
     cmaxr = PetscMax(cmaxr,ptap->c_rmti[i+1]-ptap->c_rmti[i]);
   }
-  ierr = PetscCalloc4(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp,pon,&c_rmtc);CHKERRQ(ierr);
+  ierr = PetscCalloc3(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp);CHKERRQ(ierr);
   ierr = PetscHMapIVCreate(&hmap);CHKERRQ(ierr);
   ierr = PetscHMapIVResize(hmap,cmaxr);CHKERRQ(ierr);
   ierr = ISGetIndices(map,&mappingindices);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_PtAPNumericLocal,C,0,0,0);CHKERRQ(ierr);
   for (i=0; i<am && pon; i++) {
     ierr = PetscHMapIVClear(hmap);CHKERRQ(ierr);
     offset = i%dof;
@@ -807,46 +830,22 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce(Mat A,Mat P,PetscInt dof,
     poa = po->a + po->i[ii];
     for (j=0; j<nzi; j++) {
       pocol = poj[j]*dof+offset;
-      c_rmtjj = c_rmtj + ptap->c_rmti[pocol];
-      c_rmtaa = c_rmta + ptap->c_rmti[pocol];
-      for (jj=0; jj<voff; jj++) {
-        apvaluestmp[jj] = apvalues[jj]*poa[j];
-        /*If the row is empty */
-        if (!c_rmtc[pocol]) {
-          c_rmtjj[jj] = apindices[jj];
-          c_rmtaa[jj] = apvaluestmp[jj];
-          c_rmtc[pocol]++;
-        } else {
-          ierr = PetscFindInt(apindices[jj],c_rmtc[pocol],c_rmtjj,&loc);CHKERRQ(ierr);
-          if (loc>=0){ /* hit */
-            c_rmtaa[loc] += apvaluestmp[jj];
-            ierr = PetscLogFlops(1.0);CHKERRQ(ierr);
-          } else { /* new element */
-            loc = -(loc+1);
-            /* Move data backward */
-            for (kk=c_rmtc[pocol]; kk>loc; kk--) {
-              c_rmtjj[kk] = c_rmtjj[kk-1];
-              c_rmtaa[kk] = c_rmtaa[kk-1];
-            }/* End kk */
-            c_rmtjj[loc] = apindices[jj];
-            c_rmtaa[loc] = apvaluestmp[jj];
-            c_rmtc[pocol]++;
-          }
-        }
-        ierr = PetscLogFlops(voff);CHKERRQ(ierr);
-      } /* End jj */
+      ierr = MatPtAPNumericAddToRemoteRow_private(ptap,pocol,voff,apindices,apvalues,poa[j],c_rmta);CHKERRQ(ierr);
     } /* End j */
   } /* End i */
+  ierr = PetscLogEventEnd(MAT_PtAPNumericLocal,C,0,0,0);CHKERRQ(ierr);
 
-  ierr = PetscFree4(apindices,apvalues,apvaluestmp,c_rmtc);CHKERRQ(ierr);
+  ierr = PetscFree3(apindices,apvalues,apvaluestmp);CHKERRQ(ierr);
   ierr = PetscHMapIVDestroy(&hmap);CHKERRQ(ierr);
 
   ierr = MatGetLocalSize(P,NULL,&pn);CHKERRQ(ierr);
   pn *= dof;
-  ierr = PetscCalloc2(ptap->c_othi[pn],&c_othj,ptap->c_othi[pn],&c_otha);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ptap->c_othi[pn],&c_otha);CHKERRQ(ierr);
 
-  ierr = PetscSFReduceBegin(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
+  /* the column indices of the remote rows were communicated by the symbolic product, only the values are sent here while the local rows are computed */
+  ierr = PetscLogEventBegin(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
   ierr = PetscSFReduceBegin(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
   ierr = MatGetOwnershipRangeColumn(P,&pcstart,&pcend);CHKERRQ(ierr);
   pcstart = pcstart*dof;
   pcend   = pcend*dof;
@@ -860,6 +859,7 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce(Mat A,Mat P,PetscInt dof,
   ierr = PetscCalloc5(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp,pn,&dcc,pn,&occ);CHKERRQ(ierr);
   ierr = PetscHMapIVCreate(&hmap);CHKERRQ(ierr);
   ierr = PetscHMapIVResize(hmap,cmaxr);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_PtAPNumericLocal,C,0,0,0);CHKERRQ(ierr);
   for (i=0; i<am && pn; i++) {
     ierr = PetscHMapIVClear(hmap);CHKERRQ(ierr);
     offset = i%dof;
@@ -882,20 +882,22 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce(Mat A,Mat P,PetscInt dof,
       ierr = MatSetValues(C,1,&row,voff,apindices,apvaluestmp,ADD_VALUES);CHKERRQ(ierr);
     }
   }
+  ierr = PetscLogEventEnd(MAT_PtAPNumericLocal,C,0,0,0);CHKERRQ(ierr);
   ierr = ISRestoreIndices(map,&mappingindices);CHKERRQ(ierr);
   ierr = MatGetOwnershipRangeColumn(C,&ccstart,&ccend);CHKERRQ(ierr);
   ierr = PetscFree5(apindices,apvalues,apvaluestmp,dcc,occ);CHKERRQ(ierr);
   ierr = PetscHMapIVDestroy(&hmap);CHKERRQ(ierr);
-  ierr = PetscSFReduceEnd(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
   ierr = PetscSFReduceEnd(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscFree2(c_rmtj,c_rmta);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
+  ierr = PetscFree(c_rmta);CHKERRQ(ierr);
 
   /* Add contributions from remote */
   for (i = 0; i < pn; i++) {
     row = i + pcstart;
-    ierr = MatSetValues(C,1,&row,ptap->c_othi[i+1]-ptap->c_othi[i],c_othj+ptap->c_othi[i],c_otha+ptap->c_othi[i],ADD_VALUES);CHKERRQ(ierr);
+    ierr = MatSetValues(C,1,&row,ptap->c_othi[i+1]-ptap->c_othi[i],ptap->c_othj+ptap->c_othi[i],c_otha+ptap->c_othi[i],ADD_VALUES);CHKERRQ(ierr);
   }
-  ierr = PetscFree2(c_othj,c_otha);CHKERRQ(ierr);
+  ierr = PetscFree(c_otha);CHKERRQ(ierr);
 
   ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
@@ -926,8 +928,8 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce_merged(Mat A,Mat P,PetscI
   Mat_SeqAIJ        *cd,*co,*po=(Mat_SeqAIJ*)p->B->data,*pd=(Mat_SeqAIJ*)p->A->data;
   Mat_APMPI         *ptap = c->ap;
   PetscHMapIV       hmap;
-  PetscInt          i,j,jj,kk,nzi,dnzi,*c_rmtj,voff,*c_othj,pn,pon,pcstart,pcend,row,am,*poj,*pdj,*apindices,cmaxr,*c_rmtc,*c_rmtjj,loc;
-  PetscScalar       *c_rmta,*c_otha,*poa,*pda,*apvalues,*apvaluestmp,*c_rmtaa;
+  PetscInt          i,j,jj,nzi,dnzi,voff,pn,pon,pcstart,pcend,row,am,*poj,*pdj,*apindices,cmaxr;
+  PetscScalar       *c_rmta,*c_otha,*poa,*pda,*apvalues,*apvaluestmp;
   PetscInt          offset,ii,pocol;
   const PetscInt    *mappingindices;
   IS                map;
@@ -942,8 +944,10 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce_merged(Mat A,Mat P,PetscI
   /* Get P_oth = ptap->P_oth  and P_loc = ptap->P_loc */
   /*-----------------------------------------------------*/
   if (ptap->reuse == MAT_REUSE_MATRIX) {
-    /* P_oth and P_loc are obtained in MatPtASymbolic() when reuse == MAT_INITIAL_MATRIX */
+    /* P_oth and P_loc are obtained in MatPtASymbolic() when reuse == MAT_INITIAL_MATRIX; only the values are updated here */
+    ierr = PetscLogEventBegin(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
     ierr =  MatGetBrowsOfAcols_MPIXAIJ(A,P,dof,MAT_REUSE_MATRIX,&ptap->P_oth);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
   }
   ierr = PetscObjectQuery((PetscObject)ptap->P_oth,"aoffdiagtopothmapping",(PetscObject*)&map);CHKERRQ(ierr);
   ierr = MatGetLocalSize(p->B,NULL,&pon);CHKERRQ(ierr);
@@ -951,7 +955,7 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce_merged(Mat A,Mat P,PetscI
   ierr = MatGetLocalSize(P,NULL,&pn);CHKERRQ(ierr);
   pn  *= dof;
 
-  ierr = PetscCalloc2(ptap->c_rmti[pon],&c_rmtj,ptap->c_rmti[pon],&c_rmta);CHKERRQ(ierr);
+  ierr = PetscCalloc1(ptap->c_rmti[pon],&c_rmta);CHKERRQ(ierr);
   ierr = MatGetLocalSize(A,&am,NULL);CHKERRQ(ierr);
   ierr = MatGetOwnershipRangeColumn(P,&pcstart,&pcend);CHKERRQ(ierr);
   pcstart *= dof;
@@ -965,10 +969,11 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce_merged(Mat A,Mat P,PetscI
   for (i=0; i<pn; i++) {
     cmaxr = PetscMax(cmaxr,(cd->i[i+1]-cd->i[i])+(co->i[i+1]-co->i[i]));
   }
-  ierr = PetscCalloc4(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp,pon,&c_rmtc);CHKERRQ(ierr);
+  ierr = PetscCalloc3(cmaxr,&apindices,cmaxr,&apvalues,cmaxr,&apvaluestmp);CHKERRQ(ierr);
   ierr = PetscHMapIVCreate(&hmap);CHKERRQ(ierr);
   ierr = PetscHMapIVResize(hmap,cmaxr);CHKERRQ(ierr);
   ierr = ISGetIndices(map,&mappingindices);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_PtAPNumericLocal,C,0,0,0);CHKERRQ(ierr);
   for (i=0; i<am && (pon || pn); i++) {
     ierr = PetscHMapIVClear(hmap);CHKERRQ(ierr);
     offset = i%dof;
@@ -986,34 +991,7 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce_merged(Mat A,Mat P,PetscI
     poa = po->a + po->i[ii];
     for (j=0; j<nzi; j++) {
       pocol = poj[j]*dof+offset;
-      c_rmtjj = c_rmtj + ptap->c_rmti[pocol];
-      c_rmtaa = c_rmta + ptap->c_rmti[pocol];
-      for (jj=0; jj<voff; jj++) {
-        apvaluestmp[jj] = apvalues[jj]*poa[j];
-        /*If the row is empty */
-        if (!c_rmtc[pocol]) {
-          c_rmtjj[jj] = apindices[jj];
-          c_rmtaa[jj] = apvaluestmp[jj];
-          c_rmtc[pocol]++;
-        } else {
-          ierr = PetscFindInt(apindices[jj],c_rmtc[pocol],c_rmtjj,&loc);CHKERRQ(ierr);
-          if (loc>=0){ /* hit */
-            c_rmtaa[loc] += apvaluestmp[jj];
-            ierr = PetscLogFlops(1.0);CHKERRQ(ierr);
-          } else { /* new element */
-            loc = -(loc+1);
-            /* Move data backward */
-            for (kk=c_rmtc[pocol]; kk>loc; kk--) {
-              c_rmtjj[kk] = c_rmtjj[kk-1];
-              c_rmtaa[kk] = c_rmtaa[kk-1];
-            }/* End kk */
-            c_rmtjj[loc] = apindices[jj];
-            c_rmtaa[loc] = apvaluestmp[jj];
-            c_rmtc[pocol]++;
-          }
-        }
-      } /* End jj */
-      ierr = PetscLogFlops(voff);CHKERRQ(ierr);
+      ierr = MatPtAPNumericAddToRemoteRow_private(ptap,pocol,voff,apindices,apvalues,poa[j],c_rmta);CHKERRQ(ierr);
     } /* End j */
 
     /* Form local C(ii, :) */
@@ -1028,24 +1006,26 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIXAIJ_allatonce_merged(Mat A,Mat P,PetscI
       ierr = MatSetValues(C,1,&row,voff,apindices,apvaluestmp,ADD_VALUES);CHKERRQ(ierr);
     }/* End j */
   } /* End i */
+  ierr = PetscLogEventEnd(MAT_PtAPNumericLocal,C,0,0,0);CHKERRQ(ierr);
 
   ierr = ISRestoreIndices(map,&mappingindices);CHKERRQ(ierr);
-  ierr = PetscFree4(apindices,apvalues,apvaluestmp,c_rmtc);CHKERRQ(ierr);
+  ierr = PetscFree3(apindices,apvalues,apvaluestmp);CHKERRQ(ierr);
   ierr = PetscHMapIVDestroy(&hmap);CHKERRQ(ierr);
-  ierr = PetscCalloc2(ptap->c_othi[pn],&c_othj,ptap->c_othi[pn],&c_otha);CHKERRQ(ierr);
+  ierr = PetscMalloc1(ptap->c_othi[pn],&c_otha);CHKERRQ(ierr);
 
-  ierr = PetscSFReduceBegin(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
+  /* the column indices of the remote rows were communicated by the symbolic product, only the values are sent here */
+  ierr = PetscLogEventBegin(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
   ierr = PetscSFReduceBegin(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscSFReduceEnd(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
   ierr = PetscSFReduceEnd(ptap->sf,MPIU_SCALAR,c_rmta,c_otha,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscFree2(c_rmtj,c_rmta);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_PtAPNumericComm,C,0,0,0);CHKERRQ(ierr);
+  ierr = PetscFree(c_rmta);CHKERRQ(ierr);
 
   /* Add contributions from remote */
   for (i = 0; i < pn; i++) {
     row = i + pcstart;
-    ierr = MatSetValues(C,1,&row,ptap->c_othi[i+1]-ptap->c_othi[i],c_othj+ptap->c_othi[i],c_otha+ptap->c_othi[i],ADD_VALUES);CHKERRQ(ierr);
+    ierr = MatSetValues(C,1,&row,ptap->c_othi[i+1]-ptap->c_othi[i],ptap->c_othj+ptap->c_othi[i],c_otha+ptap->c_othi[i],ADD_VALUES);CHKERRQ(ierr);
   }
-  ierr = PetscFree2(c_othj,c_otha);CHKERRQ(ierr);
+  ierr = PetscFree(c_otha);CHKERRQ(ierr);
 
   ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
@@ -1158,6 +1138,7 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIXAIJ_allatonce(Mat A,Mat P,PetscInt dof
   for (i=0; i<pon; i++) {
     off = 0;
     ierr = PetscHSetIGetElems(hta[i],&off,c_rmtj+ptap->c_rmti[i]);CHKERRQ(ierr);
+    ierr = PetscSortInt(off,c_rmtj+ptap->c_rmti[i]);CHKERRQ(ierr);
     ierr = PetscHSetIDestroy(&hta[i]);CHKERRQ(ierr);
   }
   ierr = PetscFree(hta);CHKERRQ(ierr);
@@ -1275,7 +1256,8 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIXAIJ_allatonce(Mat A,Mat P,PetscInt dof
 
   /* Get remote data */
   ierr = PetscSFReduceEnd(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscFree(c_rmtj);CHKERRQ(ierr);
+  /* the column indices are kept so that the numeric product only communicates values */
+  ptap->c_rmtj = c_rmtj;
 
   for (i = 0; i < pn; i++) {
     nzi = ptap->c_othi[i+1] - ptap->c_othi[i];
@@ -1298,7 +1280,7 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIXAIJ_allatonce(Mat A,Mat P,PetscInt dof
   }
 
   ierr = PetscFree2(hta,hto);CHKERRQ(ierr);
-  ierr = PetscFree(c_othj);CHKERRQ(ierr);
+  ptap->c_othj = c_othj;
 
   /* local sizes and preallocation */
   ierr = MatSetSizes(Cmpi,pn,pn,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
@@ -1460,6 +1442,7 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIXAIJ_allatonce_merged(Mat A,Mat P,Petsc
   for (i=0; i<pon; i++) {
     off = 0;
     ierr = PetscHSetIGetElems(hta[i],&off,c_rmtj+ptap->c_rmti[i]);CHKERRQ(ierr);
+    ierr = PetscSortInt(off,c_rmtj+ptap->c_rmti[i]);CHKERRQ(ierr);
     ierr = PetscHSetIDestroy(&hta[i]);CHKERRQ(ierr);
   }
   ierr = PetscFree(hta);CHKERRQ(ierr);
@@ -1539,7 +1522,8 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIXAIJ_allatonce_merged(Mat A,Mat P,Petsc
   ierr = PetscSFReduceBegin(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
   /* Get remote data */
   ierr = PetscSFReduceEnd(ptap->sf,MPIU_INT,c_rmtj,c_othj,MPIU_REPLACE);CHKERRQ(ierr);
-  ierr = PetscFree(c_rmtj);CHKERRQ(ierr);
+  /* the column indices are kept so that the numeric product only communicates values */
+  ptap->c_rmtj = c_rmtj;
   ierr = PetscMalloc2(pn,&dnz,pn,&onz);CHKERRQ(ierr);
   ierr = MatGetOwnershipRangeColumn(P,&pcstart,&pcend);CHKERRQ(ierr);
   pcstart *= dof;
@@ -1565,7 +1549,7 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIXAIJ_allatonce_merged(Mat A,Mat P,Petsc
   }
 
   ierr = PetscFree2(htd,hto);CHKERRQ(ierr);
-  ierr = PetscFree(c_othj);CHKERRQ(ierr);
+  ptap->c_othj = c_othj;
 
   /* local sizes and preallocation */
   ierr = MatSetSizes(Cmpi,pn,pn,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
@@ -8,6 +8,9 @@
 #include <petscblaslapack.h>
 #include <petscbt.h>
 #include <petsc/private/kernels/blocktranspose.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
 
 PetscErrorCode MatSeqAIJSetTypeFromOptions(Mat A)
 {
@@ -1093,8 +1096,19 @@ PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A,MatAssemblyType mode)
 
   if (!A->structure_only) {
     ierr = MatCheckCompressedRow(A,a->nonzerorowcnt,&a->compressedrow,a->i,m,ratio);CHKERRQ(ierr);
+    if (a->compressindices) {
+      ierr = MatCheckCompressedIndices(A,&a->cindices,a->i,a->j,m);CHKERRQ(ierr);
+    }
+    if (a->detectblocks) {
+      ierr = MatSeqAIJCheckBlocks_Private(A);CHKERRQ(ierr);
+    }
   }
   ierr = MatAssemblyEnd_SeqAIJ_Inode(A,mode);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+  if (a->nthreads > 1) {
+    ierr = MatSeqAIJSetUpThreads_Private(A,PETSC_TRUE);CHKERRQ(ierr);
+  }
+#endif
   PetscFunctionReturn(0);
 }
 
@@ -1168,12 +1182,26 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = ISColoringDestroy(&a->coloring);CHKERRQ(ierr);
   ierr = PetscFree2(a->compressedrow.i,a->compressedrow.rindex);CHKERRQ(ierr);
   ierr = PetscFree(a->matmult_abdense);CHKERRQ(ierr);
+  ierr = PetscFree(a->coo_jmap);CHKERRQ(ierr);
+  ierr = PetscFree(a->coo_perm);CHKERRQ(ierr);
+  ierr = PetscFree3(a->threadrows,a->threadnodes,a->threadnoderows);CHKERRQ(ierr);
+  ierr = PetscFree(a->threadwork);CHKERRQ(ierr);
+  ierr = PetscFree(a->af);CHKERRQ(ierr);
+  ierr = MatDestroyCompressedIndices(&a->cindices);CHKERRQ(ierr);
+  ierr = MatDestroy(&a->bmat);CHKERRQ(ierr);
+  ierr = MatDestroySolveLevels(&a->levels);CHKERRQ(ierr);
+  ierr = MatSeqAIJDestroyILUIterative_Private(A);CHKERRQ(ierr);
 
   ierr = MatDestroy_SeqAIJ_Inode(A);CHKERRQ(ierr);
   ierr = PetscFree(A->data);CHKERRQ(ierr);
 
   ierr = PetscObjectChangeTypeName((PetscObject)A,0);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetColumnIndices_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetMixedPrecision_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetCompressIndices_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetDetectBlocks_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetLevelSolve_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetILUIterative_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatStoreValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatRetrieveValues_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqsbaij_C",NULL);CHKERRQ(ierr);
@@ -1203,6 +1231,8 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatProductSetFromOptions_is_seqaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatProductSetFromOptions_seqdense_seqaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatProductSetFromOptions_seqaij_seqaij_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1297,6 +1327,215 @@ PetscErrorCode MatGetDiagonal_SeqAIJ(Mat A,Vec v)
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_HAVE_OPENMP)
+/*
+   Splits the rows of the matrix (the compressed rows if they are used) among a->nthreads threads so that each
+   thread gets about the same number of nonzeros, and likewise splits the inodes if there are any.
+
+   With firsttouch the i, j and a arrays are reallocated and copied by the threads that will later use them, so that on
+   NUMA systems the pages end up on the memory of the socket running the thread. This is only done if the matrix owns
+   its arrays.
+*/
+PetscErrorCode MatSeqAIJSetUpThreads_Private(Mat A,PetscBool firsttouch)
+{
+  Mat_SeqAIJ     *a  = (Mat_SeqAIJ*)A->data;
+  PetscInt       nt  = a->nthreads,m = A->rmap->n,nrows,nz = a->nz,t,lo,hi,mid,target,node_max = 0,node,row;
+  const PetscInt *ii,*ns = a->inode.size;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ns) node_max = a->inode.node_count;
+  if (a->threadrows && a->threadstate == A->nonzerostate && a->threadcprow == a->compressedrow.use && a->threadnodes[nt] == node_max) PetscFunctionReturn(0);
+  if (!a->threadrows) {
+    ierr = PetscMalloc3(nt+1,&a->threadrows,nt+1,&a->threadnodes,nt+1,&a->threadnoderows);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,3*(nt+1)*sizeof(PetscInt));CHKERRQ(ierr);
+  }
+  if (a->compressedrow.use) {
+    nrows = a->compressedrow.nrows;
+    ii    = a->compressedrow.i;
+  } else {
+    nrows = m;
+    ii    = a->i;
+  }
+  /* thread t starts at the first row whose offset reaches t*nz/nt */
+  a->threadrows[0]  = 0;
+  a->threadrows[nt] = nrows;
+  for (t=1; t<nt; t++) {
+    target = (PetscInt)(((PetscInt64)nz*t)/nt);
+    lo     = a->threadrows[t-1];
+    hi     = nrows;
+    while (lo < hi) {
+      mid = lo + (hi-lo)/2;
+      if (ii[mid] < target) lo = mid+1;
+      else hi = mid;
+    }
+    a->threadrows[t] = lo;
+  }
+  /* same for the inodes, walking the nodes once */
+  a->threadnodes[0]    = 0;
+  a->threadnoderows[0] = 0;
+  for (t=1,node=0,row=0; t<nt; t++) {
+    target = (PetscInt)(((PetscInt64)nz*t)/nt);
+    while (node < node_max && a->i[row] < target) row += ns[node++];
+    a->threadnodes[t]    = node;
+    a->threadnoderows[t] = row;
+  }
+  a->threadnodes[nt]    = node_max;
+  a->threadnoderows[nt] = m;
+  a->threadstate        = A->nonzerostate;
+  a->threadcprow        = a->compressedrow.use;
+
+  if (firsttouch && a->free_a && a->free_ij && !A->structure_only && nz) {
+    PetscInt  *ni,*nj;
+    MatScalar *na;
+
+    ierr = PetscMallocPushHugePage();CHKERRQ(ierr);
+    ierr = PetscMalloc1(m+1,&ni);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz,&nj);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz,&na);CHKERRQ(ierr);
+    ierr = PetscMallocPopHugePage();CHKERRQ(ierr);
+#pragma omp parallel num_threads(nt)
+    {
+      PetscInt tt,k;
+
+      for (tt=omp_get_thread_num(); tt<nt; tt+=omp_get_num_threads()) {
+        for (k=ii[a->threadrows[tt]]; k<ii[a->threadrows[tt+1]]; k++) {
+          nj[k] = a->j[k];
+          na[k] = a->a[k];
+        }
+      }
+#pragma omp for schedule(static)
+      for (k=0; k<m+1; k++) ni[k] = a->i[k];
+    }
+    ierr = MatSeqXAIJFreeAIJ(A,&a->a,&a->j,&a->i);CHKERRQ(ierr);
+    a->i            = ni;
+    a->j            = nj;
+    a->a            = na;
+    a->maxnz        = nz;
+    a->singlemalloc = PETSC_FALSE;
+    a->free_a       = PETSC_TRUE;
+    a->free_ij      = PETSC_TRUE;
+    ierr = PetscInfo1(A,"Placed matrix arrays with first touch by %D threads\n",nt);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* zz = A xx + yy, or zz = A xx when yy is NULL */
+static PetscErrorCode MatMultAdd_SeqAIJ_OpenMP(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt    *ii,*ridx = NULL,*rows,nt = a->nthreads,m = A->rmap->n;
+  const PetscInt    *aj = a->j;
+  const MatScalar   *aa = a->a;
+  const PetscScalar *x,*y = NULL;
+  PetscScalar       *z;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSetUpThreads_Private(A,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {
+    ierr = VecGetArrayPair(yy,zz,(PetscScalar**)&y,&z);CHKERRQ(ierr);
+  } else {
+    ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  }
+  rows = a->threadrows;
+  if (usecprow) {
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  } else ii = a->i;
+#pragma omp parallel num_threads(nt)
+  {
+    PetscInt    t,i,n,k;
+    PetscScalar sum;
+
+    if (usecprow && z != y) {
+#pragma omp for schedule(static)
+      for (k=0; k<m; k++) z[k] = y ? y[k] : 0.0;
+    }
+    for (t=omp_get_thread_num(); t<nt; t+=omp_get_num_threads()) {
+      for (i=rows[t]; i<rows[t+1]; i++) {
+        const PetscInt  *idx = aj + ii[i];
+        const MatScalar *v   = aa + ii[i];
+
+        n   = ii[i+1] - ii[i];
+        k   = usecprow ? ridx[i] : i;
+        sum = y ? y[k] : 0.0;
+        PetscSparseDensePlusDot(sum,x,v,idx,n);
+        z[k] = sum;
+      }
+    }
+  }
+  ierr = PetscLogFlops(yy ? 2.0*a->nz : 2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy) {
+    ierr = VecRestoreArrayPair(yy,zz,(PetscScalar**)&y,&z);CHKERRQ(ierr);
+  } else {
+    ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* yy = zz + A^T xx; threads other than the first accumulate into private buffers that are summed at the end */
+static PetscErrorCode MatMultTransposeAdd_SeqAIJ_OpenMP(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt    *ii,*ridx = NULL,*rows,nt = a->nthreads,n = A->cmap->n;
+  const PetscInt    *aj = a->j;
+  const MatScalar   *aa = a->a;
+  const PetscScalar *x;
+  PetscScalar       *y,*work;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSetUpThreads_Private(A,PETSC_FALSE);CHKERRQ(ierr);
+  if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (!a->threadwork) {
+    ierr = PetscMalloc1((nt-1)*n,&a->threadwork);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,(nt-1)*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  rows = a->threadrows;
+  work = a->threadwork;
+  if (usecprow) {
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  } else ii = a->i;
+#pragma omp parallel num_threads(nt)
+  {
+    PetscInt    t,i,j,k,nz;
+    PetscScalar *w,alpha;
+
+    for (t=omp_get_thread_num(); t<nt; t+=omp_get_num_threads()) {
+      if (t) {
+        w = work + (t-1)*n;
+        for (k=0; k<n; k++) w[k] = 0.0;
+      } else w = y;
+      for (i=rows[t]; i<rows[t+1]; i++) {
+        const PetscInt  *idx = aj + ii[i];
+        const MatScalar *v   = aa + ii[i];
+
+        nz    = ii[i+1] - ii[i];
+        alpha = x[usecprow ? ridx[i] : i];
+        for (j=0; j<nz; j++) w[idx[j]] += alpha*v[j];
+      }
+    }
+#pragma omp barrier
+#pragma omp for schedule(static)
+    for (k=0; k<n; k++) {
+      for (t=1; t<nt; t++) y[k] += work[(t-1)*n+k];
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+#endif
+
 #include <../src/mat/impls/aij/seq/ftn-kernels/fmult.h>
 PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A,Vec xx,Vec zz,Vec yy)
 {
@@ -1315,6 +1554,12 @@ PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A,Vec xx,Vec zz,Vec yy)
 #endif
 
   PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  if (a->nthreads > 1) {
+    ierr = MatMultTransposeAdd_SeqAIJ_OpenMP(A,xx,zz,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
   if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);}
   ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
@@ -1377,6 +1622,24 @@ PetscErrorCode MatMult_SeqAIJ(Mat A,Vec xx,Vec yy)
 #endif
 
   PetscFunctionBegin;
+  if (a->cindices.use) {
+    ierr = MatMultAdd_SeqAIJ_CompressedIndices(A,xx,NULL,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (a->mixedprecision) {
+    ierr = MatMultAdd_SeqAIJ_Mixed(A,xx,NULL,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#if defined(PETSC_HAVE_OPENMP)
+  if (a->nthreads > 1) {
+    ierr = MatMultAdd_SeqAIJ_OpenMP(A,xx,NULL,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
+  if (a->bmat) {
+    ierr = MatMultAdd_SeqAIJ_Blocks(A,xx,NULL,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
   ii   = a->i;
@@ -1529,6 +1792,24 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A,Vec xx,Vec yy,Vec zz)
   PetscBool         usecprow=a->compressedrow.use;
 
   PetscFunctionBegin;
+  if (a->cindices.use) {
+    ierr = MatMultAdd_SeqAIJ_CompressedIndices(A,xx,yy,zz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (a->mixedprecision) {
+    ierr = MatMultAdd_SeqAIJ_Mixed(A,xx,yy,zz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#if defined(PETSC_HAVE_OPENMP)
+  if (a->nthreads > 1) {
+    ierr = MatMultAdd_SeqAIJ_OpenMP(A,xx,yy,zz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
+  if (a->bmat) {
+    ierr = MatMultAdd_SeqAIJ_Blocks(A,xx,yy,zz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
   if (usecprow) { /* use compressed row format */
@@ -1831,6 +2112,14 @@ PetscErrorCode MatSOR_SeqAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscR
   const PetscInt    *idx,*diag;
 
   PetscFunctionBegin;
+  if (a->mixedprecision && flag != SOR_APPLY_UPPER && flag != SOR_APPLY_LOWER && !(flag & SOR_EISENSTAT)) {
+    ierr = MatSOR_SeqAIJ_Mixed(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (a->bmatsor && omega == 1.0 && fshift == 0.0 && !(flag & (SOR_EISENSTAT | SOR_APPLY_UPPER | SOR_APPLY_LOWER))) {
+    ierr = MatSOR_SeqAIJ_Blocks(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   its = its*lits;
 
   if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
@@ -1989,6 +2278,315 @@ PetscErrorCode MatSOR_SeqAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscR
   PetscFunctionReturn(0);
 }
 
+/*
+   Returns the single precision copy of the values used when a->mixedprecision is set, refilling it if the matrix
+   changed since it was last filled. Factors store the U part after the L part, so they have a->diag[0]+1 values.
+*/
+PetscErrorCode MatSeqAIJGetSingleValues_Private(Mat A,const float **af)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  PetscInt         i,nz;
+  PetscObjectState state;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectStateGet((PetscObject)A,&state);CHKERRQ(ierr);
+  if (A->factortype == MAT_FACTOR_NONE) nz = a->i[A->rmap->n];
+  else nz = A->rmap->n ? a->diag[0]+1 : 0;
+  if (nz > a->afsize) {
+    ierr = PetscFree(a->af);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz,&a->af);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,(nz-a->afsize)*sizeof(float));CHKERRQ(ierr);
+    a->afsize  = nz;
+    a->afstate = -1;
+  }
+  if (a->afstate != state) {
+    for (i=0; i<nz; i++) a->af[i] = (float)PetscRealPart(a->a[i]);
+    a->afstate = state;
+  }
+  *af = a->af;
+  PetscFunctionReturn(0);
+}
+
+/* z = y + A x with the single precision values, y may be NULL for MatMult() */
+PetscErrorCode MatMultAdd_SeqAIJ_Mixed(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *z,sum;
+  const PetscScalar *x,*y = NULL;
+  const float       *af,*v;
+  const PetscInt    *aj,*ii,*ridx = NULL;
+  PetscInt          m = A->rmap->n,i,j,n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJGetSingleValues_Private(A,&af);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy && yy != zz) {
+    ierr = VecGetArrayRead(yy,&y);CHKERRQ(ierr);
+  }
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  if (yy == zz) y = z;
+  ii = a->i;
+  if (a->compressedrow.use) {
+    if (!y) {
+      ierr = PetscArrayzero(z,m);CHKERRQ(ierr);
+    } else if (y != z) {
+      ierr = PetscArraycpy(z,y,m);CHKERRQ(ierr);
+    }
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  for (i=0; i<m; i++) {
+    n   = ii[i+1] - ii[i];
+    aj  = a->j + ii[i];
+    v   = af + ii[i];
+    sum = ridx ? z[ridx[i]] : (y ? y[i] : 0.0);
+    for (j=0; j<n; j++) sum += v[j]*x[aj[j]];
+    if (ridx) z[ridx[i]] = sum;
+    else z[i] = sum;
+  }
+  ierr = PetscLogFlops(yy ? 2.0*a->nz : 2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy && yy != zz) {
+    ierr = VecRestoreArrayRead(yy,&y);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Kernels for the compressed column indices: the columns of row i are base[i] + off[k], so x is shifted once per row and
+   indexed with the short offsets. ii are the row pointers, or those of the compressed rows together with ridx; in the
+   latter case z already holds y (or zero). The inode variant reads the offsets of each node once, nodes have at most
+   5 rows (inode.max_limit).
+*/
+#define MatMultAdd_SeqAIJ_CI_Rows(name,vtype,itype) \
+static void name(PetscInt m,const PetscInt *ii,const PetscInt *ridx,const PetscInt *base,const itype *off,const vtype *aa,const PetscScalar *x,const PetscScalar *y,PetscScalar *z) \
+{ \
+  PetscInt          i,k,n,row; \
+  const PetscScalar *xb; \
+  const itype       *o; \
+  const vtype       *v; \
+  PetscScalar       sum; \
+  for (i=0; i<m; i++) { \
+    row = ridx ? ridx[i] : i; \
+    n   = ii[i+1] - ii[i]; \
+    xb  = x + base[row]; \
+    o   = off + ii[i]; \
+    v   = aa + ii[i]; \
+    sum = ridx ? z[row] : (y ? y[row] : 0.0); \
+    for (k=0; k<n; k++) sum += v[k]*xb[o[k]]; \
+    z[row] = sum; \
+  } \
+}
+
+#define MatMultAdd_SeqAIJ_CI_Inode(name,vtype,itype) \
+static void name(PetscInt nodes,const PetscInt *ns,const PetscInt *ii,const PetscInt *base,const itype *off,const vtype *aa,const PetscScalar *x,const PetscScalar *y,PetscScalar *z) \
+{ \
+  PetscInt          node,row = 0,r,k,n,sz; \
+  const PetscScalar *xb; \
+  const itype       *o; \
+  const vtype       *v; \
+  PetscScalar       sum[5],tmp; \
+  for (node=0; node<nodes; node++) { \
+    sz = ns[node]; \
+    n  = ii[row+1] - ii[row]; \
+    xb = x + base[row]; \
+    o  = off + ii[row]; \
+    v  = aa + ii[row]; \
+    for (r=0; r<sz; r++) sum[r] = y ? y[row+r] : 0.0; \
+    for (k=0; k<n; k++) { \
+      tmp = xb[o[k]]; \
+      for (r=0; r<sz; r++) sum[r] += v[r*n+k]*tmp; \
+    } \
+    for (r=0; r<sz; r++) z[row+r] = sum[r]; \
+    row += sz; \
+  } \
+}
+
+MatMultAdd_SeqAIJ_CI_Rows(MatMultAdd_SeqAIJ_CI_Rows_8,MatScalar,unsigned char)
+MatMultAdd_SeqAIJ_CI_Rows(MatMultAdd_SeqAIJ_CI_Rows_16,MatScalar,unsigned short)
+MatMultAdd_SeqAIJ_CI_Rows(MatMultAdd_SeqAIJ_CI_Rows_8_Single,float,unsigned char)
+MatMultAdd_SeqAIJ_CI_Rows(MatMultAdd_SeqAIJ_CI_Rows_16_Single,float,unsigned short)
+MatMultAdd_SeqAIJ_CI_Inode(MatMultAdd_SeqAIJ_CI_Inode_8,MatScalar,unsigned char)
+MatMultAdd_SeqAIJ_CI_Inode(MatMultAdd_SeqAIJ_CI_Inode_16,MatScalar,unsigned short)
+MatMultAdd_SeqAIJ_CI_Inode(MatMultAdd_SeqAIJ_CI_Inode_8_Single,float,unsigned char)
+MatMultAdd_SeqAIJ_CI_Inode(MatMultAdd_SeqAIJ_CI_Inode_16_Single,float,unsigned short)
+
+/*
+   z = y + A x with the compressed column indices, y may be NULL for MatMult(). Uses the inodes when the matrix has them,
+   otherwise the compressed rows when they are used, and the single precision values when a->mixedprecision is set
+*/
+PetscErrorCode MatMultAdd_SeqAIJ_CompressedIndices(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_CompressedIndices *ci = &a->cindices;
+  PetscScalar           *z;
+  const PetscScalar     *x,*y = NULL;
+  const float           *af = NULL;
+  const PetscInt        *ii = a->i,*ridx = NULL;
+  PetscInt              m = A->rmap->n;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  if (a->mixedprecision) {
+    ierr = MatSeqAIJGetSingleValues_Private(A,&af);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy && yy != zz) {
+    ierr = VecGetArrayRead(yy,&y);CHKERRQ(ierr);
+  }
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  if (yy == zz) y = z;
+  if (a->inode.size) {
+    if (ci->width == 1) {
+      if (af) MatMultAdd_SeqAIJ_CI_Inode_8_Single(a->inode.node_count,a->inode.size,ii,ci->base,ci->j8,af,x,y,z);
+      else    MatMultAdd_SeqAIJ_CI_Inode_8(a->inode.node_count,a->inode.size,ii,ci->base,ci->j8,a->a,x,y,z);
+    } else {
+      if (af) MatMultAdd_SeqAIJ_CI_Inode_16_Single(a->inode.node_count,a->inode.size,ii,ci->base,ci->j16,af,x,y,z);
+      else    MatMultAdd_SeqAIJ_CI_Inode_16(a->inode.node_count,a->inode.size,ii,ci->base,ci->j16,a->a,x,y,z);
+    }
+  } else {
+    if (a->compressedrow.use) {
+      if (!y) {
+        ierr = PetscArrayzero(z,m);CHKERRQ(ierr);
+      } else if (y != z) {
+        ierr = PetscArraycpy(z,y,m);CHKERRQ(ierr);
+      }
+      m    = a->compressedrow.nrows;
+      ii   = a->compressedrow.i;
+      ridx = a->compressedrow.rindex;
+    }
+    if (ci->width == 1) {
+      if (af) MatMultAdd_SeqAIJ_CI_Rows_8_Single(m,ii,ridx,ci->base,ci->j8,af,x,y,z);
+      else    MatMultAdd_SeqAIJ_CI_Rows_8(m,ii,ridx,ci->base,ci->j8,a->a,x,y,z);
+    } else {
+      if (af) MatMultAdd_SeqAIJ_CI_Rows_16_Single(m,ii,ridx,ci->base,ci->j16,af,x,y,z);
+      else    MatMultAdd_SeqAIJ_CI_Rows_16(m,ii,ridx,ci->base,ci->j16,a->a,x,y,z);
+    }
+  }
+  ierr = PetscLogFlops(yy ? 2.0*a->nz : 2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (yy && yy != zz) {
+    ierr = VecRestoreArrayRead(yy,&y);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatSOR_SeqAIJ() with the single precision values; handles the forward, backward and symmetric sweeps, MatSOR_SeqAIJ()
+   does the Eisenstat and SOR_APPLY_UPPER cases itself
+*/
+PetscErrorCode MatSOR_SeqAIJ_Mixed(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *x,sum,*t;
+  const MatScalar   *idiag,*mdiag;
+  const PetscScalar *b,*xb;
+  const float       *af,*v;
+  PetscErrorCode    ierr;
+  PetscInt          n,m = A->rmap->n,i,j;
+  const PetscInt    *idx,*diag;
+
+  PetscFunctionBegin;
+  its = its*lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJ(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+
+  ierr  = MatSeqAIJGetSingleValues_Private(A,&af);CHKERRQ(ierr);
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+  mdiag = a->mdiag;
+
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        n   = diag[i] - a->i[i];
+        idx = a->j + a->i[i];
+        v   = af + a->i[i];
+        sum = b[i];
+        for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+        t[i] = sum;
+        x[i] = sum*idiag[i];
+      }
+      xb   = t;
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        n   = a->i[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = af + diag[i] + 1;
+        sum = xb[i];
+        for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+        if (xb == b) {
+          x[i] = sum*idiag[i];
+        } else {
+          x[i] = (1-omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        /* lower */
+        n   = diag[i] - a->i[i];
+        idx = a->j + a->i[i];
+        v   = af + a->i[i];
+        sum = b[i];
+        for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+        t[i] = sum;             /* save application of the lower-triangular part */
+        /* upper */
+        n   = a->i[i+1] - diag[i] - 1;
+        idx = a->j + diag[i] + 1;
+        v   = af + diag[i] + 1;
+        for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+        x[i] = (1. - omega)*x[i] + sum*idiag[i]; /* omega in idiag */
+      }
+      xb   = t;
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        sum = xb[i];
+        if (xb == b) {
+          /* whole matrix (no checkpointing available) */
+          n   = a->i[i+1] - a->i[i];
+          idx = a->j + a->i[i];
+          v   = af + a->i[i];
+          for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+          x[i] = (1. - omega)*x[i] + (sum + mdiag[i]*x[i])*idiag[i];
+        } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+          n   = a->i[i+1] - diag[i] - 1;
+          idx = a->j + diag[i] + 1;
+          v   = af + diag[i] + 1;
+          for (j=0; j<n; j++) sum -= v[j]*x[idx[j]];
+          x[i] = (1. - omega)*x[i] + sum*idiag[i];  /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+      } else {
+        ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
 PetscErrorCode MatGetInfo_SeqAIJ(Mat A,MatInfoType flag,MatInfo *info)
 {
@@ -2912,8 +3510,14 @@ PetscErrorCode MatCopy_SeqAIJ(Mat A,Mat B,MatStructure str)
 PetscErrorCode MatSetUp_SeqAIJ(Mat A)
 {
   PetscErrorCode ierr;
+  PetscBool      hash = PETSC_FALSE;
 
   PetscFunctionBegin;
+  ierr = PetscOptionsGetBool(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_aij_hash_assembly",&hash,NULL);CHKERRQ(ierr);
+  if (hash) {
+    ierr = MatSetUpHash_Private(A);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = MatSeqAIJSetPreallocation_SeqAIJ(A,PETSC_DEFAULT,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -2929,8 +3533,12 @@ PETSC_INTERN PetscErrorCode MatSeqAIJGetArray_SeqAIJ(Mat A,PetscScalar *array[])
 
 PETSC_INTERN PetscErrorCode MatSeqAIJRestoreArray_SeqAIJ(Mat A,PetscScalar *array[])
 {
+  Mat_SeqAIJ *a = (Mat_SeqAIJ*)A->data;
+
   PetscFunctionBegin;
-  *array = NULL;
+  *array       = NULL;
+  a->afstate   = -1; /* the values may have changed */
+  a->bmatstate = -1;
   PetscFunctionReturn(0);
 }
 
@@ -3628,6 +4236,303 @@ PetscErrorCode  MatSeqAIJSetColumnIndices(Mat mat,PetscInt *indices)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatSeqAIJSetMixedPrecision_SeqAIJ(Mat A,PetscBool flg)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+#if !defined(PETSC_USE_REAL_DOUBLE) || defined(PETSC_USE_COMPLEX)
+  if (flg) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"Mixed precision values require a real double precision build");
+#endif
+  a->mixedprecision = flg;
+  if (!flg) {
+    ierr = PetscFree(a->af);CHKERRQ(ierr);
+    a->afsize = 0;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+    MatSeqAIJSetMixedPrecision - Keeps a single precision copy of the matrix values that is used by MatMult(), MatMultAdd()
+       and MatSOR(), and by MatSolve() of the LU and ILU factors computed with MATSOLVERPETSC
+
+  Logically Collective on Mat
+
+  Input Parameters:
++  A - the SeqAIJ matrix
+-  flg - PETSC_TRUE to use the single precision values
+
+  Options Database Key:
+.  -mat_aij_mixed_precision - use the single precision values
+
+  Level: advanced
+
+  Notes:
+    The vectors and all arithmetic remain in double precision, only the matrix entries are rounded. Since these operations
+  are limited by memory bandwidth and the values are most of the bytes read, this makes them notably faster when the
+  accuracy of the operator is not critical, for example the smoother and coarse grid operators of PCMG and PCGAMG.
+
+    The double precision values are kept and used by all other operations, so this costs an extra 4 bytes per nonzero.
+  The copy is refreshed automatically when the matrix values change. Factors obtained with MatGetFactor() inherit the
+  setting. Only available when PETSc is configured with real double precision scalars.
+
+    MatSOR() always uses the point sweeps, also for matrices that use inodes, and falls back to the double precision
+  values for SOR_EISENSTAT and SOR_APPLY_UPPER.
+
+.seealso: MatMult(), MatSOR(), MatSolve(), MatGetFactor()
+@*/
+PetscErrorCode MatSeqAIJSetMixedPrecision(Mat A,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveBool(A,flg,2);
+  ierr = PetscTryMethod(A,"MatSeqAIJSetMixedPrecision_C",(Mat,PetscBool),(A,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJSetCompressIndices_SeqAIJ(Mat A,PetscBool flg)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  a->compressindices = flg;
+  if (!flg) {
+    ierr = MatDestroyCompressedIndices(&a->cindices);CHKERRQ(ierr);
+  } else if (A->assembled && A->factortype == MAT_FACTOR_NONE && !A->structure_only) {
+    ierr = MatCheckCompressedIndices(A,&a->cindices,a->i,a->j,A->rmap->n);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+    MatSeqAIJSetCompressIndices - Stores the column indices used by MatMult() and MatMultAdd() as the smallest column of
+       each row plus 8 or 16 bit offsets from it
+
+  Logically Collective on Mat
+
+  Input Parameters:
++  A - the SeqAIJ matrix
+-  flg - PETSC_TRUE to compress the column indices
+
+  Options Database Key:
+.  -mat_aij_compress_indices - compress the column indices, this also applies to the diagonal and off-diagonal blocks of MATMPIAIJ
+
+  Level: advanced
+
+  Notes:
+    The matrix-vector product reads one column index for every value, so the indices are about a third of the memory
+  traffic in double precision. If the columns of every row lie within 256 (or 65536) of each other, as for matrices
+  from stencils on structured or well ordered grids, each index takes 1 (or 2) bytes instead of sizeof(PetscInt). Rows with
+  a wider spread leave the column indices uncompressed; run with -info to see the decision.
+
+    The compressed indices are computed by MatAssemblyEnd() and kept next to the usual column indices, which all other
+  operations continue to use. They are combined with inodes, compressed rows and MatSeqAIJSetMixedPrecision(); when they are
+  used the OpenMP threaded kernels are not. MatView() with PETSC_VIEWER_ASCII_INFO reports how many fewer bytes MatMult() reads.
+
+.seealso: MatMult(), MatSeqAIJSetMixedPrecision(), MatView()
+@*/
+PetscErrorCode MatSeqAIJSetCompressIndices(Mat A,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveBool(A,flg,2);
+  ierr = PetscTryMethod(A,"MatSeqAIJSetCompressIndices_C",(Mat,PetscBool),(A,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJSetDetectBlocks_SeqAIJ(Mat A,PetscBool flg)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  a->detectblocks = flg;
+  if (!flg) {
+    ierr = MatDestroy(&a->bmat);CHKERRQ(ierr);
+    a->bmatsor = PETSC_FALSE;
+  } else if (A->assembled) {
+    ierr = MatSeqAIJCheckBlocks_Private(A);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+    MatSeqAIJSetDetectBlocks - Looks for dense blocks in the nonzero structure of the matrix at assembly and uses the
+       MATSEQBAIJ kernels for them in MatMult(), MatMultAdd() and MatSOR()
+
+  Logically Collective on Mat
+
+  Input Parameters:
++  A - the SeqAIJ matrix
+-  flg - PETSC_TRUE to look for dense blocks
+
+  Options Database Key:
+.  -mat_aij_detect_blocks - look for dense blocks, this also applies to the diagonal and off-diagonal blocks of MATMPIAIJ
+
+  Level: advanced
+
+  Notes:
+    Matrices from discretizations with several fields per node often consist of dense bs x bs blocks but are assembled as
+  MATAIJ. MatAssemblyEnd() then looks for the largest bs from 8 down to 2 that divides the local sizes such that all rows of
+  each block row have the same column indices and these come in aligned runs of bs, and if it finds one keeps a MATSEQBAIJ
+  copy of the matrix. MatMult() and MatMultAdd() use its kernels, which read one column index per block instead of one per
+  nonzero. MatSOR() uses the point block sweeps of MATSEQBAIJ when omega is 1, there is no shift, all diagonal blocks are
+  present and neither SOR_EISENSTAT nor SOR_APPLY_UPPER or SOR_APPLY_LOWER is requested.
+
+    The copy costs the memory of the values and is refreshed automatically when the values change. The compressed column
+  indices, the single precision values and the OpenMP threads take precedence for MatMult() when they are also used.
+  Run with -info to see which block size was found. The LU and ILU factorizations already handle identical rows through inodes.
+
+.seealso: MatMult(), MatSOR(), MATSEQBAIJ, MatSeqAIJSetCompressIndices(), MatSeqAIJSetMixedPrecision()
+@*/
+PetscErrorCode MatSeqAIJSetDetectBlocks(Mat A,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveBool(A,flg,2);
+  ierr = PetscTryMethod(A,"MatSeqAIJSetDetectBlocks_C",(Mat,PetscBool),(A,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJSetLevelSolve_SeqAIJ(Mat A,PetscBool flg)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  a->levelsolve = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+    MatSeqAIJSetLevelSolve - Schedules the triangular solves of MatSolve() of the LU, ILU, Cholesky and ICC factors of the
+       matrix computed with MATSOLVERPETSC by levels, so that they can run in parallel on OpenMP threads
+
+  Logically Collective on Mat
+
+  Input Parameters:
++  A - the SeqAIJ matrix
+-  flg - PETSC_TRUE to schedule the solves by levels
+
+  Options Database Keys:
++  -mat_aij_level_solve - schedule the solves by levels, this also applies to the diagonal blocks of MATMPIAIJ, as used by PCBJACOBI and PCASM
+-  -mat_aij_omp_threads <n> - the number of OpenMP threads used by the solves of the factors
+
+  Level: advanced
+
+  Notes:
+    A triangular solve is a sequence of dependent row updates, so it is the least scalable part of preconditioners such as PCILU
+  and PCICC. Each row of the forward (backward) solve only needs the rows before (after) it in which it has entries, so the
+  rows can be grouped in levels, a row being one level after the last row it needs, and the rows of a level solved in parallel.
+  The numeric factorization computes the levels of the forward and backward solves, once for each symbolic factorization, and
+  copies the entries of the factor in level order so each thread reads consecutive memory; MatSolve() then shares the rows of
+  each level among the threads given by -mat_aij_omp_threads, with one synchronization per level. Without OpenMP it solves
+  the rows in level order.
+
+    The parallelism is the number of rows per level, which depends on the ordering of the factor: the natural ordering of a
+  stencil on a structured grid gives about one level per grid diagonal, while MATORDERINGRCM or MATORDERINGND give fewer
+  levels. MatView() with PETSC_VIEWER_ASCII_INFO, and so -pc_view, prints the numbers of levels and -info the rows per level.
+
+    Factors obtained with MatGetFactor() inherit the setting. The copy costs the memory of the factor again; the other solves
+  of the factor, such as MatSolveTranspose() and MatMatSolve(), use the factor unchanged. MatSeqAIJSetMixedPrecision() is not
+  used by the level scheduled solves.
+
+.seealso: MatSolve(), MatGetFactor(), MatSeqAIJSetMixedPrecision(), PCILU, PCICC
+@*/
+PetscErrorCode MatSeqAIJSetLevelSolve(Mat A,PetscBool flg)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveBool(A,flg,2);
+  ierr = PetscTryMethod(A,"MatSeqAIJSetLevelSolve_C",(Mat,PetscBool),(A,flg));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJSetILUIterative_SeqAIJ(Mat A,PetscBool flg,PetscInt sweeps,PetscInt solvesweeps)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  if (sweeps != PETSC_DEFAULT) {
+    if (sweeps < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of sweeps %D must be positive",sweeps);
+    a->ilusweeps = sweeps;
+  }
+  if (solvesweeps != PETSC_DEFAULT) {
+    if (solvesweeps < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of solve sweeps %D cannot be negative",solvesweeps);
+    a->ilusolvesweeps = solvesweeps;
+  }
+  a->iluiterative = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+    MatSeqAIJSetILUIterative - Computes the ILU factors of the matrix with MATSOLVERPETSC, and the triangular solves of
+       MatSolve() with them, by a fixed number of sweeps that update all the entries at once, so that they run in parallel on
+       OpenMP threads
+
+  Logically Collective on Mat
+
+  Input Parameters:
++  A - the SeqAIJ matrix, or a factor obtained from it with MatGetFactor(A,MATSOLVERPETSC,MAT_FACTOR_ILU,&F)
+.  flg - PETSC_TRUE to use the sweeps
+.  sweeps - the number of sweeps of the numeric factorization, or PETSC_DEFAULT to keep the current value (initially 3)
+-  solvesweeps - the number of Jacobi sweeps of each of the two triangular solves, or PETSC_DEFAULT to keep the current value (initially 3)
+
+  Options Database Keys:
++  -pc_factor_ilu_iterative - use the sweeps in PCILU, see PCFactorSetILUIterative()
+.  -pc_factor_ilu_iterative_sweeps <sweeps> - the number of sweeps of the numeric factorization
+.  -pc_factor_ilu_iterative_solve_sweeps <solvesweeps> - the number of Jacobi sweeps of each triangular solve
+-  -mat_aij_omp_threads <n> - the number of OpenMP threads of the sweeps
+
+  Level: advanced
+
+  Notes:
+    The symbolic factorization is the usual ILU(k) one. Instead of eliminating the rows one after the other, the numeric
+  factorization starts from L = the strictly lower triangular part of the matrix scaled by the diagonal and U = its upper
+  triangular part, and each sweep computes every entry of L and U in the nonzero pattern of the factor from the values of the
+  previous sweep,
+$     l_ij = (a_ij - sum_{k<j} l_ik u_kj) / u_jj   for i > j
+$     u_ij =  a_ij - sum_{k<i} l_ik u_kj           for i <= j
+  with the method of Chow and Patel. The entries are independent of each other within a sweep, so the rows are shared among
+  the threads without any level scheduling, and the factor does not depend on the number of threads. The sweeps converge to
+  the ILU factor, which is the fixed point of this iteration; a few sweeps usually suffice for a preconditioner.
+
+    MatSolve() likewise replaces each of the triangular solves by solvesweeps Jacobi sweeps, y <- b - (L - I) y starting
+  from y = b and x <- D^{-1} (y - (U - D) x) starting from x = D^{-1} y, each of them a product with a triangular factor.
+  With 0 solvesweeps MatSolve() applies D^{-1}. The result is an approximation of the exact triangular solves, the same
+  linear operator for each call, so the preconditioner can be used with Krylov methods that require a fixed preconditioner.
+
+    This is only used by ILU factorizations, not by LU, ILUDT or the in-place ILU. Shifts of the diagonal are not applied, a
+  zero diagonal entry of U after the sweeps is a zero pivot. MatSolveTranspose() is not supported and MatMatSolve() solves
+  the columns one after the other. Factors obtained with MatGetFactor() inherit the setting.
+
+  References:
+.  1. - E. Chow and A. Patel, Fine-grained parallel incomplete LU factorization, SIAM J. Sci. Comput., 37 (2015).
+
+.seealso: MatSolve(), MatGetFactor(), MatSeqAIJSetLevelSolve(), PCFactorSetILUIterative(), PCILU
+@*/
+PetscErrorCode MatSeqAIJSetILUIterative(Mat A,PetscBool flg,PetscInt sweeps,PetscInt solvesweeps)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidLogicalCollectiveBool(A,flg,2);
+  PetscValidLogicalCollectiveInt(A,sweeps,3);
+  PetscValidLogicalCollectiveInt(A,solvesweeps,4);
+  ierr = PetscTryMethod(A,"MatSeqAIJSetILUIterative_C",(Mat,PetscBool,PetscInt,PetscInt),(A,flg,sweeps,solvesweeps));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* ----------------------------------------------------------------------------------------*/
 
 PetscErrorCode  MatStoreValues_SeqAIJ(Mat mat)
@@ -3796,7 +4701,11 @@ PetscErrorCode  MatRetrieveValues(Mat mat)
 
    Options Database Keys:
 +  -mat_no_inode  - Do not use inodes
--  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_aij_omp_threads <n> - Use n OpenMP threads in MatMult(), MatMultAdd() and MatMultTranspose(); the rows are split so each thread gets about the same number of nonzeros (requires PETSc configured with OpenMP)
+.  -mat_aij_mixed_precision - Use a single precision copy of the values in MatMult(), MatMultAdd(), MatSOR() and MatSolve(), see MatSeqAIJSetMixedPrecision()
+.  -mat_aij_compress_indices - Store the column indices as 8 or 16 bit offsets from the smallest column of each row, see MatSeqAIJSetCompressIndices()
+-  -mat_aij_detect_blocks - Look for dense blocks of size 2 to 8 at assembly and use the MATSEQBAIJ kernels for them, see MatSeqAIJSetDetectBlocks()
 
    Level: intermediate
 
@@ -3857,7 +4766,11 @@ PetscErrorCode  MatCreateSeqAIJ(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,
 
    Options Database Keys:
 +  -mat_no_inode  - Do not use inodes
--  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_inode_limit <limit> - Sets inode limit (max limit=5)
+.  -mat_aij_omp_threads <n> - Use n OpenMP threads in MatMult(), MatMultAdd() and MatMultTranspose(); the rows are split so each thread gets about the same number of nonzeros (requires PETSc configured with OpenMP)
+.  -mat_aij_mixed_precision - Use a single precision copy of the values in MatMult(), MatMultAdd(), MatSOR() and MatSolve(), see MatSeqAIJSetMixedPrecision()
+.  -mat_aij_compress_indices - Store the column indices as 8 or 16 bit offsets from the smallest column of each row, see MatSeqAIJSetCompressIndices()
+-  -mat_aij_detect_blocks - Look for dense blocks of size 2 to 8 at assembly and use the MATSEQBAIJ kernels for them, see MatSeqAIJSetDetectBlocks()
 
    Level: intermediate
 
@@ -3903,6 +4816,8 @@ PetscErrorCode  MatSeqAIJSetPreallocation_SeqAIJ(Mat B,PetscInt nz,const PetscIn
   B->preallocated = PETSC_TRUE;
 
   b = (Mat_SeqAIJ*)B->data;
+  /* a new nonzero structure, as in the symbolic factorizations */
+  ierr = MatDestroySolveLevels(&b->levels);CHKERRQ(ierr);
 
   if (!skipallocation) {
     if (!b->imax) {
@@ -3935,6 +4850,7 @@ PetscErrorCode  MatSeqAIJSetPreallocation_SeqAIJ(Mat B,PetscInt nz,const PetscIn
     /* allocate the matrix space */
     /* FIXME: should B's old memory be unlogged? */
     ierr = MatSeqXAIJFreeAIJ(B,&b->a,&b->j,&b->i);CHKERRQ(ierr);
+    ierr = PetscMallocPushHugePage();CHKERRQ(ierr);
     if (B->structure_only) {
       ierr = PetscMalloc1(nz,&b->j);CHKERRQ(ierr);
       ierr = PetscMalloc1(B->rmap->n+1,&b->i);CHKERRQ(ierr);
@@ -3943,6 +4859,7 @@ PetscErrorCode  MatSeqAIJSetPreallocation_SeqAIJ(Mat B,PetscInt nz,const PetscIn
       ierr = PetscMalloc3(nz,&b->a,nz,&b->j,B->rmap->n+1,&b->i);CHKERRQ(ierr);
       ierr = PetscLogObjectMemory((PetscObject)B,(B->rmap->n+1)*sizeof(PetscInt)+nz*(sizeof(PetscScalar)+sizeof(PetscInt)));CHKERRQ(ierr);
     }
+    ierr = PetscMallocPopHugePage();CHKERRQ(ierr);
     b->i[0] = 0;
     for (i=1; i<B->rmap->n+1; i++) {
       b->i[i] = b->i[i-1] + b->imax[i-1];
@@ -4073,6 +4990,143 @@ PetscErrorCode  MatSeqAIJSetPreallocationCSR_SeqAIJ(Mat B,const PetscInt Ii[],co
   PetscFunctionReturn(0);
 }
 
+/*
+   MatSeqAIJCOOMerge_Private - Buckets COO entries of an m-row matrix by row, sorts each row by column and merges
+   repeated entries
+
+   Input Parameters:
++  m - the number of rows
+.  n - the number of entries
+.  rows - the row of each entry, in [0,m)
+.  cols - the column of each entry
+-  src - a tag for each entry, usually its position in the caller's value array
+
+   Output Parameters:
++  Ci,Cj - CSR structure of the merged entries, column indices are sorted within each row
+.  jmap - the CSR nonzero k is made of the entries perm[jmap[k]] to perm[jmap[k+1]-1]
+-  perm - the src tags of the entries, grouped by CSR nonzero
+
+   All the output arrays are obtained with PetscMalloc1() and must be freed by the caller
+*/
+PetscErrorCode MatSeqAIJCOOMerge_Private(PetscInt m,PetscInt n,const PetscInt rows[],const PetscInt cols[],const PetscInt src[],PetscInt **Ci,PetscInt **Cj,PetscInt **jmap,PetscInt **perm)
+{
+  PetscInt       *eoff,*pos,*ecol,*ci,*cj,*jm,*pm;
+  PetscInt       r,k,p,q,nz;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscCalloc1(m+1,&eoff);CHKERRQ(ierr);
+  for (k=0; k<n; k++) eoff[rows[k]+1]++;
+  for (r=0; r<m; r++) eoff[r+1] += eoff[r];
+
+  ierr = PetscMalloc2(m,&pos,n,&ecol);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&pm);CHKERRQ(ierr);
+  ierr = PetscArraycpy(pos,eoff,m);CHKERRQ(ierr);
+  for (k=0; k<n; k++) {
+    p       = pos[rows[k]]++;
+    ecol[p] = cols[k];
+    pm[p]   = src[k];
+  }
+
+  nz = 0;
+  for (r=0; r<m; r++) {
+    ierr = PetscSortIntWithArray(eoff[r+1]-eoff[r],ecol+eoff[r],pm+eoff[r]);CHKERRQ(ierr);
+    for (p=eoff[r]; p<eoff[r+1]; p++) {
+      if (p == eoff[r] || ecol[p] != ecol[p-1]) nz++;
+    }
+  }
+
+  ierr  = PetscMalloc1(m+1,&ci);CHKERRQ(ierr);
+  ierr  = PetscMalloc1(nz,&cj);CHKERRQ(ierr);
+  ierr  = PetscMalloc1(nz+1,&jm);CHKERRQ(ierr);
+  ci[0] = 0;
+  jm[0] = 0;
+  nz    = 0;
+  for (r=0; r<m; r++) {
+    for (p=eoff[r]; p<eoff[r+1]; p=q) {
+      for (q=p+1; q<eoff[r+1] && ecol[q] == ecol[p]; q++) ;
+      cj[nz]   = ecol[p];
+      jm[nz+1] = q;
+      nz++;
+    }
+    ci[r+1] = nz;
+  }
+  ierr = PetscFree2(pos,ecol);CHKERRQ(ierr);
+  ierr = PetscFree(eoff);CHKERRQ(ierr);
+
+  *Ci   = ci;
+  *Cj   = cj;
+  *jmap = jm;
+  *perm = pm;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat A,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_SeqAIJ     *a;
+  PetscInt       m,n,k,nv,*rows,*cols,*src,*Ci,*Cj,*jmap,*perm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  m    = A->rmap->n;
+  n    = A->cmap->n;
+
+  ierr = PetscMalloc3(ncoo,&rows,ncoo,&cols,ncoo,&src);CHKERRQ(ierr);
+  for (k=0,nv=0; k<ncoo; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    if (coo_i[k] >= m) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry %D has row index %D, must be less than %D",k,coo_i[k],m);
+    if (coo_j[k] >= n) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Entry %D has column index %D, must be less than %D",k,coo_j[k],n);
+    rows[nv] = coo_i[k];
+    cols[nv] = coo_j[k];
+    src[nv]  = k;
+    nv++;
+  }
+  ierr = MatSeqAIJCOOMerge_Private(m,nv,rows,cols,src,&Ci,&Cj,&jmap,&perm);CHKERRQ(ierr);
+  ierr = PetscFree3(rows,cols,src);CHKERRQ(ierr);
+
+  /* the merged structure is exact, so a previously frozen nonzero pattern must not reject it */
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_LOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocationCSR(A,Ci,Cj,NULL);CHKERRQ(ierr);
+  ierr = PetscFree(Ci);CHKERRQ(ierr);
+  ierr = PetscFree(Cj);CHKERRQ(ierr);
+
+  a    = (Mat_SeqAIJ*)A->data;
+  ierr = PetscFree(a->coo_jmap);CHKERRQ(ierr);
+  ierr = PetscFree(a->coo_perm);CHKERRQ(ierr);
+  a->coo_n            = ncoo;
+  a->coo_jmap         = jmap;
+  a->coo_perm         = perm;
+  a->coo_nonzerostate = A->nonzerostate;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat A,const PetscScalar v[],InsertMode imode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt *jmap = a->coo_jmap,*perm = a->coo_perm;
+  MatScalar      *aa = a->a;
+  PetscScalar    sum;
+  PetscInt       k,t;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!jmap) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  if (A->nonzerostate != a->coo_nonzerostate) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Nonzero pattern changed since MatSetPreallocationCOO()");
+  if (a->coo_n) PetscValidScalarPointer(v,2);
+  for (k=0; k<a->nz; k++) {
+    sum = 0.0;
+    for (t=jmap[k]; t<jmap[k+1]; t++) sum += v[perm[t]];
+    aa[k] = (imode == INSERT_VALUES ? 0.0 : aa[k]) + sum;
+  }
+  ierr = MatSeqAIJInvalidateDiagonal(A);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA)
+  if (A->offloadmask != PETSC_OFFLOAD_UNALLOCATED) A->offloadmask = PETSC_OFFLOAD_CPU;
+#endif
+  PetscFunctionReturn(0);
+}
+
 #include <../src/mat/impls/dense/seq/dense.h>
 #include <petsc/private/kernels/petscaxpy.h>
 
@@ -4387,6 +5441,9 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   b->idiagvalid         = PETSC_FALSE;
   b->ibdiagvalid        = PETSC_FALSE;
   b->keepnonzeropattern = PETSC_FALSE;
+  b->ilusweeps          = 3;
+  b->ilusolvesweeps     = 3;
+  b->ilunthreads        = 1;
 
   ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJGetArray_C",MatSeqAIJGetArray_SeqAIJ);CHKERRQ(ierr);
@@ -4398,6 +5455,11 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
 #endif
 
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetColumnIndices_C",MatSeqAIJSetColumnIndices_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetMixedPrecision_C",MatSeqAIJSetMixedPrecision_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetCompressIndices_C",MatSeqAIJSetCompressIndices_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetDetectBlocks_C",MatSeqAIJSetDetectBlocks_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetLevelSolve_C",MatSeqAIJSetLevelSolve_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetILUIterative_C",MatSeqAIJSetILUIterative_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatStoreValues_C",MatStoreValues_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqsbaij_C",MatConvert_SeqAIJ_SeqSBAIJ);CHKERRQ(ierr);
@@ -4433,6 +5495,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatProductSetFromOptions_is_seqaij_C",MatProductSetFromOptions_IS_XAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatProductSetFromOptions_seqdense_seqaij_C",MatProductSetFromOptions_SeqDense_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatProductSetFromOptions_seqaij_seqaij_C",MatProductSetFromOptions_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_SeqAIJ);CHKERRQ(ierr);
   ierr = MatCreate_SeqAIJ_Inode(B);CHKERRQ(ierr);
   ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
   ierr = MatSeqAIJSetTypeFromOptions(B);CHKERRQ(ierr);  /* this allows changing the matrix subtype to say MATSEQAIJPERM */
@@ -4522,6 +5586,19 @@ PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat C,Mat A,MatDuplicateOption cpvalu
   }
   c->nonzerorowcnt = a->nonzerorowcnt;
   C->nonzerostate  = A->nonzerostate;
+  if (a->mixedprecision) c->mixedprecision = PETSC_TRUE;
+  if (a->compressindices) {
+    c->compressindices = PETSC_TRUE;
+    if (a->cindices.use) {
+      ierr = MatCheckCompressedIndices(C,&c->cindices,c->i,c->j,m);CHKERRQ(ierr);
+    }
+  }
+  if (a->detectblocks) {
+    c->detectblocks = PETSC_TRUE;
+    if (a->bmat) {
+      ierr = MatSeqAIJCheckBlocks_Private(C);CHKERRQ(ierr);
+    }
+  }
 
   ierr = MatDuplicate_SeqAIJ_Inode(A,cpvalues,&C);CHKERRQ(ierr);
   ierr = PetscFunctionListDuplicate(((PetscObject)A)->qlist,&((PetscObject)C)->qlist);CHKERRQ(ierr);
@@ -109,6 +109,8 @@ PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode_inplace(Mat,Mat,cons
 PETSC_INTERN PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat,Mat,const MatFactorInfo*);
 PETSC_INTERN PetscErrorCode MatSeqAIJGetArray_SeqAIJ(Mat,PetscScalar**);
 PETSC_INTERN PetscErrorCode MatSeqAIJRestoreArray_SeqAIJ(Mat,PetscScalar**);
+PETSC_INTERN PetscErrorCode MatSeqAIJSetUpSolveLevels_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJDestroyILUIterative_Private(Mat);
 
 typedef struct {
   SEQAIJHEADER(MatScalar);
@@ -125,11 +127,58 @@ typedef struct {
   ISColoring  coloring;                       /* set with MatADSetColoring() used by MatADSetValues() */
 
   PetscScalar         *matmult_abdense;    /* used by MatMatMult() */
+  PetscInt            matmult_nthreads;    /* threads of the "threaded" MatMatMult(), matmult_abdense holds one dense row for each */
   Mat_AP              *ap;                 /* used by MatPtAP() */
   Mat_MatMatMatMult   *matmatmatmult;      /* used by MatMatMatMult() */
   Mat_RARt            *rart;               /* used by MatRARt() */
   Mat_MatMatTransMult *abt;                /* used by MatMatTransposeMult() */
   Mat_MatTransMatMult *atb;                /* used by MatTransposeMatMult() */
+
+  /* used by MatSetPreallocationCOO() and MatSetValuesCOO() */
+  PetscInt            coo_n;               /* number of entries given to MatSetPreallocationCOO() */
+  PetscInt            *coo_jmap;           /* a[k] is the sum of coo_v[coo_perm[coo_jmap[k]..coo_jmap[k+1]-1]] */
+  PetscInt            *coo_perm;
+  PetscObjectState    coo_nonzerostate;    /* nonzero state when the COO map was built */
+
+  /* used by the OpenMP threaded MatMult(), MatMultAdd() and MatMultTranspose() */
+  PetscInt            nthreads;            /* number of threads, set with -mat_aij_omp_threads */
+  PetscInt            *threadrows;         /* thread t owns rows [threadrows[t],threadrows[t+1]) of a->i, or of compressedrow.i when it is used */
+  PetscInt            *threadnodes;        /* thread t owns inodes [threadnodes[t],threadnodes[t+1]) */
+  PetscInt            *threadnoderows;     /* first row of inode threadnodes[t] */
+  PetscScalar         *threadwork;         /* private column accumulators of threads 1..nthreads-1 for MatMultTranspose() */
+  PetscObjectState    threadstate;         /* nonzero state when the partition was computed */
+  PetscBool           threadcprow;         /* compressedrow.use when the partition was computed */
+
+  /* used by the mixed precision MatMult(), MatMultAdd(), MatSOR() and MatSolve() */
+  PetscBool           mixedprecision;      /* read the values from af, set with MatSeqAIJSetMixedPrecision() */
+  float               *af;                 /* single precision copy of a */
+  PetscInt            afsize;              /* allocated length of af */
+  PetscObjectState    afstate;             /* object state when af was filled, -1 if it must be refilled */
+
+  /* used by MatMult() and MatMultAdd() with compressed column indices */
+  PetscBool             compressindices;   /* compress the column indices at assembly, set with MatSeqAIJSetCompressIndices() */
+  Mat_CompressedIndices cindices;          /* row bases and short column offsets, see MatCheckCompressedIndices() */
+
+  /* used by MatMult(), MatMultAdd() and MatSOR() with detected dense blocks */
+  PetscBool           detectblocks;        /* look for dense blocks at assembly, set with MatSeqAIJSetDetectBlocks() */
+  Mat                 bmat;                /* MATSEQBAIJ with the same nonzeros when a block size was found, see MatSeqAIJCheckBlocks_Private() */
+  PetscObjectState    bmatstate;           /* object state when the values were copied to bmat, -1 if they must be copied */
+  PetscBool           bmatsor;             /* every block row of bmat has its diagonal block, so MatSOR() can use it */
+
+  /* used by MatSolve() of the LU and ILU factors with level scheduled triangular solves */
+  PetscBool           levelsolve;          /* schedule the solves of the factors by levels, set with MatSeqAIJSetLevelSolve() */
+  Mat_SolveLevels     levels;              /* levels of the forward and backward solves of a factor, see MatSolveLevelsSetUp() */
+
+  /* used by the iterative ILU factorization and triangular solves, see MatSeqAIJSetILUIterative() */
+  PetscBool           iluiterative;        /* compute the ILU factor and its solves with sweeps, set with MatSeqAIJSetILUIterative() */
+  PetscInt            ilusweeps;           /* sweeps of the numeric factorization */
+  PetscInt            ilusolvesweeps;      /* Jacobi sweeps of each triangular solve */
+  PetscInt            ilunthreads;         /* OpenMP threads of the sweeps, from -mat_aij_omp_threads of the factored matrix */
+  PetscInt            *iluapos;            /* position in the values of the factored matrix of each entry of the factor, -1 for fill */
+  PetscInt            *iluui,*iluuj;       /* the strictly upper triangular part of the factor by columns: rows iluuj[iluui[j]..iluui[j+1]-1] */
+  PetscInt            *iluupos;            /* and their positions in the values of the factor */
+  MatScalar           *ilua;               /* the values of the factor in the previous sweep */
+  PetscScalar         *iluwork;            /* the previous iterate of the Jacobi sweeps of the solves */
 } Mat_SeqAIJ;
 
 /*
@@ -238,6 +287,17 @@ PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ(Mat A,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJ(Mat A,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A,Vec,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+PETSC_INTERN PetscErrorCode MatSeqAIJGetSingleValues_Private(Mat,const float**);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_Mixed(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ_Mixed(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+PETSC_INTERN PetscErrorCode MatSolve_SeqAIJ_Mixed(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_CompressedIndices(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSeqAIJCheckBlocks_Private(Mat);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_Blocks(Mat,Vec,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ_Blocks(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+#if defined(PETSC_HAVE_OPENMP)
+PETSC_INTERN PetscErrorCode MatSeqAIJSetUpThreads_Private(Mat,PetscBool);
+#endif
 
 PETSC_INTERN PetscErrorCode MatSetOption_SeqAIJ(Mat,MatOption,PetscBool);
 
@@ -295,6 +355,7 @@ PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Heap(Mat,Mat,PetscR
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_BTHeap(Mat,Mat,PetscReal,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(Mat,Mat,PetscReal,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_LLCondensed(Mat,Mat,PetscReal,Mat);
+PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Threaded(Mat,Mat,PetscReal,Mat);
 #if defined(PETSC_HAVE_HYPRE)
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_AIJ_AIJ_wHYPRE(Mat,Mat,PetscReal,Mat);
 #endif
@@ -304,6 +365,7 @@ PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted(Mat,Mat,Mat);
 
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqDense_SeqAIJ(Mat,Mat,Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(Mat,Mat,Mat);
+PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Threaded(Mat,Mat,Mat);
 
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_SeqAIJ_SeqAIJ_SparseAxpy(Mat,Mat,PetscReal,Mat);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ(Mat,Mat,Mat);
@@ -389,6 +451,9 @@ PETSC_INTERN PetscErrorCode MatCreateSubMatrix_SeqAIJ(Mat,IS,IS,PetscInt,MatReus
 
 PETSC_INTERN PetscErrorCode MatSeqAIJCompactOutExtraColumns_SeqAIJ(Mat,ISLocalToGlobalMapping*);
 PETSC_INTERN PetscErrorCode MatSetSeqAIJWithArrays_private(MPI_Comm,PetscInt,PetscInt,PetscInt[],PetscInt[],PetscScalar[],MatType,Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJCOOMerge_Private(PetscInt,PetscInt,const PetscInt[],const PetscInt[],const PetscInt[],PetscInt**,PetscInt**,PetscInt**,PetscInt**);
+PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat,PetscInt,const PetscInt[],const PetscInt[]);
+PETSC_INTERN PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat,const PetscScalar[],InsertMode);
 
 /*
     PetscSparseDenseMinusDot - The inner kernel of triangular solves and Gauss-Siedel smoothing. \sum_i xv[i] * r[xi[i]] for CSR storage
@@ -102,6 +102,13 @@ PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat A,MatFactorType ftype,
   ierr = MatSetSizes(*B,n,n,n,n);CHKERRQ(ierr);
   if (ftype == MAT_FACTOR_LU || ftype == MAT_FACTOR_ILU || ftype == MAT_FACTOR_ILUDT) {
     ierr = MatSetType(*B,MATSEQAIJ);CHKERRQ(ierr);
+    if (((Mat_SeqAIJ*)A->data)->mixedprecision) {ierr = MatSeqAIJSetMixedPrecision(*B,PETSC_TRUE);CHKERRQ(ierr);}
+    if (((Mat_SeqAIJ*)A->data)->levelsolve) {ierr = MatSeqAIJSetLevelSolve(*B,PETSC_TRUE);CHKERRQ(ierr);}
+    ((Mat_SeqAIJ*)(*B)->data)->levels.nthreads = PetscMax(((Mat_SeqAIJ*)A->data)->nthreads,1);
+    ((Mat_SeqAIJ*)(*B)->data)->ilunthreads     = PetscMax(((Mat_SeqAIJ*)A->data)->nthreads,1);
+    if (((Mat_SeqAIJ*)A->data)->iluiterative) {
+      ierr = MatSeqAIJSetILUIterative(*B,PETSC_TRUE,((Mat_SeqAIJ*)A->data)->ilusweeps,((Mat_SeqAIJ*)A->data)->ilusolvesweeps);CHKERRQ(ierr);
+    }
 
     (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJ;
     (*B)->ops->lufactorsymbolic  = MatLUFactorSymbolic_SeqAIJ;
@@ -110,6 +117,8 @@ PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat A,MatFactorType ftype,
   } else if (ftype == MAT_FACTOR_CHOLESKY || ftype == MAT_FACTOR_ICC) {
     ierr = MatSetType(*B,MATSEQSBAIJ);CHKERRQ(ierr);
     ierr = MatSeqSBAIJSetPreallocation(*B,1,MAT_SKIP_ALLOCATION,NULL);CHKERRQ(ierr);
+    ((Mat_SeqSBAIJ*)(*B)->data)->levelsolve      = ((Mat_SeqAIJ*)A->data)->levelsolve;
+    ((Mat_SeqSBAIJ*)(*B)->data)->levels.nthreads = PetscMax(((Mat_SeqAIJ*)A->data)->nthreads,1);
 
     (*B)->ops->iccfactorsymbolic      = MatICCFactorSymbolic_SeqAIJ;
     (*B)->ops->choleskyfactorsymbolic = MatCholeskyFactorSymbolic_SeqAIJ;
@@ -600,6 +609,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *info)
   C->ops->matsolve          = MatMatSolve_SeqAIJ;
   C->assembled              = PETSC_TRUE;
   C->preallocated           = PETSC_TRUE;
+  ierr = MatSeqAIJSetUpSolveLevels_Private(C);CHKERRQ(ierr);
 
   ierr = PetscLogFlops(C->cmap->n);CHKERRQ(ierr);
 
@@ -1068,16 +1078,19 @@ PetscErrorCode MatMatSolve_SeqAIJ_inplace(Mat A,Mat B,Mat X)
   PetscFunctionReturn(0);
 }
 
+/*
+   MatMatSolve_SeqAIJ - Solves with the factors for four columns at a time, so the factors are read once for four columns
+*/
 PetscErrorCode MatMatSolve_SeqAIJ(Mat A,Mat B,Mat X)
 {
   Mat_SeqAIJ        *a    = (Mat_SeqAIJ*)A->data;
   IS                iscol = a->col,isrow = a->row;
   PetscErrorCode    ierr;
-  PetscInt          i, n = A->rmap->n,*vi,*ai = a->i,*aj = a->j,*adiag = a->diag;
+  PetscInt          i,j,k,n = A->rmap->n,*vi,*ai = a->i,*aj = a->j,*adiag = a->diag;
   PetscInt          nz,neq,ldb,ldx;
   const PetscInt    *rout,*cout,*r,*c;
-  PetscScalar       *x,*tmp = a->solve_work,sum;
-  const PetscScalar *b,*aa = a->a,*v;
+  PetscScalar       *x,*tmp = a->solve_work,*work,*t1,*t2,*t3,*t4,*x1,*x2,*x3,*x4,sum,s1,s2,s3,s4;
+  const PetscScalar *b,*aa = a->a,*v,*b1,*b2,*b3,*b4;
   PetscBool         isdense;
 
   PetscFunctionBegin;
@@ -1094,7 +1107,48 @@ PetscErrorCode MatMatSolve_SeqAIJ(Mat A,Mat B,Mat X)
   ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
   ierr = ISGetIndices(isrow,&rout);CHKERRQ(ierr); r = rout;
   ierr = ISGetIndices(iscol,&cout);CHKERRQ(ierr); c = cout;
-  for (neq=0; neq<B->cmap->n; neq++) {
+  neq  = 0;
+  if (B->cmap->n >= 4) {
+    ierr = PetscMalloc1(4*n,&work);CHKERRQ(ierr);
+    t1 = work; t2 = t1 + n; t3 = t2 + n; t4 = t3 + n;
+    for (; neq+4<=B->cmap->n; neq+=4) {
+      b1 = b; b2 = b1 + ldb; b3 = b2 + ldb; b4 = b3 + ldb;
+      x1 = x; x2 = x1 + ldx; x3 = x2 + ldx; x4 = x3 + ldx;
+      /* forward solve the lower triangular */
+      t1[0] = b1[r[0]]; t2[0] = b2[r[0]]; t3[0] = b3[r[0]]; t4[0] = b4[r[0]];
+      v     = aa;
+      vi    = aj;
+      for (i=1; i<n; i++) {
+        nz = ai[i+1] - ai[i];
+        s1 = b1[r[i]]; s2 = b2[r[i]]; s3 = b3[r[i]]; s4 = b4[r[i]];
+        for (j=0; j<nz; j++) {
+          k   = vi[j];
+          s1 -= v[j]*t1[k]; s2 -= v[j]*t2[k]; s3 -= v[j]*t3[k]; s4 -= v[j]*t4[k];
+        }
+        t1[i] = s1; t2[i] = s2; t3[i] = s3; t4[i] = s4;
+        v    += nz; vi += nz;
+      }
+      /* backward solve the upper triangular */
+      for (i=n-1; i>=0; i--) {
+        v  = aa + adiag[i+1]+1;
+        vi = aj + adiag[i+1]+1;
+        nz = adiag[i]-adiag[i+1]-1;
+        s1 = t1[i]; s2 = t2[i]; s3 = t3[i]; s4 = t4[i];
+        for (j=0; j<nz; j++) {
+          k   = vi[j];
+          s1 -= v[j]*t1[k]; s2 -= v[j]*t2[k]; s3 -= v[j]*t3[k]; s4 -= v[j]*t4[k];
+        }
+        x1[c[i]] = t1[i] = s1*v[nz]; /* v[nz] = aa[adiag[i]] */
+        x2[c[i]] = t2[i] = s2*v[nz];
+        x3[c[i]] = t3[i] = s3*v[nz];
+        x4[c[i]] = t4[i] = s4*v[nz];
+      }
+      b += 4*ldb;
+      x += 4*ldx;
+    }
+    ierr = PetscFree(work);CHKERRQ(ierr);
+  }
+  for (; neq<B->cmap->n; neq++) {
     /* forward solve the lower triangular */
     tmp[0] = b[r[0]];
     v      = aa;
@@ -1566,6 +1620,229 @@ PetscErrorCode MatSolveTransposeAdd_SeqAIJ(Mat A,Vec bb,Vec zz,Vec xx)
   PetscFunctionReturn(0);
 }
 
+/* ----------------------------------------------------------------*/
+/*
+   The iterative ILU of MatSeqAIJSetILUIterative(), on the data structure of the ILU factors described below: the L part
+   of row i is b->i[i] to b->i[i+1]-1 and the U part is b->diag[i+1]+1 to b->diag[i]-1, followed by the diagonal at b->diag[i].
+*/
+
+PetscErrorCode MatSeqAIJDestroyILUIterative_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(a->iluapos);CHKERRQ(ierr);
+  ierr = PetscFree3(a->iluui,a->iluuj,a->iluupos);CHKERRQ(ierr);
+  ierr = PetscFree(a->ilua);CHKERRQ(ierr);
+  ierr = PetscFree(a->iluwork);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Jacobi sweeps for the forward solve with L, whose diagonal is one, and the backward solve with U */
+static PetscErrorCode MatSolve_SeqAIJ_ILUIterative(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode    ierr;
+  const PetscInt    n = A->rmap->n,*ai = a->i,*aj = a->j,*adiag = a->diag,nt = a->ilunthreads;
+  const MatScalar   *aa = a->a;
+  PetscInt          i,s;
+  const PetscInt    *r,*c;
+  PetscScalar       *x,*t,*y,*z,*w;
+  const PetscScalar *b;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+  t    = a->solve_work;
+  y    = a->iluwork;
+  z    = a->iluwork + n;
+
+  /* forward solve: y <- t - (L - I) y, starting from y = t */
+  for (i=0; i<n; i++) t[i] = b[r[i]];
+  ierr = PetscArraycpy(y,t,n);CHKERRQ(ierr);
+  for (s=0; s<a->ilusolvesweeps; s++) {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static)
+#endif
+    for (i=0; i<n; i++) {
+      PetscScalar sum = t[i];
+      PetscInt    k;
+
+      for (k=ai[i]; k<ai[i+1]; k++) sum -= aa[k]*y[aj[k]];
+      z[i] = sum;
+    }
+    w = y; y = z; z = w;
+  }
+
+  /* backward solve: t <- D^{-1} (y - (U - D) t), starting from t = D^{-1} y; a->a holds the inverse of D */
+  for (i=0; i<n; i++) t[i] = aa[adiag[i]]*y[i];
+  for (s=0; s<a->ilusolvesweeps; s++) {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static)
+#endif
+    for (i=0; i<n; i++) {
+      PetscScalar sum = y[i];
+      PetscInt    k;
+
+      for (k=adiag[i+1]+1; k<adiag[i]; k++) sum -= aa[k]*t[aj[k]];
+      z[i] = aa[adiag[i]]*sum;
+    }
+    w = t; t = z; z = w;
+  }
+  for (i=0; i<n; i++) x[c[i]] = t[i];
+
+  ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(a->ilusolvesweeps*(2.0*a->nz - A->cmap->n) + A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* sum_k l_ik u_kj over row i of L and column j of U, both sorted, which only have entries for k < i and k < j */
+PETSC_STATIC_INLINE PetscScalar MatILUIterativeDot_Private(PetscInt i,PetscInt j,const PetscInt *bi,const PetscInt *bj,const PetscInt *ui,const PetscInt *uj,const PetscInt *upos,const MatScalar *v,PetscLogDouble *flops)
+{
+  PetscScalar sum = 0.0;
+  PetscInt    l = bi[i],q = ui[j];
+
+  while (l < bi[i+1] && q < ui[j+1]) {
+    if (bj[l] < uj[q]) l++;
+    else if (bj[l] > uj[q]) q++;
+    else {sum += v[l]*v[upos[q]]; l++; q++; *flops += 2.0;}
+  }
+  return sum;
+}
+
+/*
+   MatLUFactorNumeric_SeqAIJ_ILUIterative - The numeric ILU factorization by the sweeps of Chow and Patel. The first call after the
+   symbolic factorization finds the position in A of each entry of the factor and the columns of U.
+*/
+static PetscErrorCode MatLUFactorNumeric_SeqAIJ_ILUIterative(Mat B,Mat A,const MatFactorInfo *info)
+{
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data;
+  PetscErrorCode  ierr;
+  const PetscInt  n = A->rmap->n,*ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*bdiag = b->diag,nt = b->ilunthreads;
+  const MatScalar *aa = a->a;
+  MatScalar       *ba = b->a,*old;
+  const PetscInt  *r,*ic,*apos,*ui,*uj,*upos;
+  PetscInt        i,k,s,nz = bdiag[0]+1,*map;
+  PetscLogDouble  flops = 0.0;
+  FactorShiftCtx  sctx;
+
+  PetscFunctionBegin;
+  ierr = PetscMemzero(&sctx,sizeof(FactorShiftCtx));CHKERRQ(ierr);
+  if (!b->iluapos) {
+    PetscInt *cnt;
+
+    ierr = ISGetIndices(b->row,&r);CHKERRQ(ierr);
+    ierr = ISGetIndices(b->icol,&ic);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz,&b->iluapos);CHKERRQ(ierr);
+    ierr = PetscMalloc1(n,&map);CHKERRQ(ierr);
+    for (i=0; i<n; i++) map[i] = -1;
+    for (i=0; i<n; i++) {
+      for (k=ai[r[i]]; k<ai[r[i]+1]; k++) map[ic[aj[k]]] = k;
+      for (k=bi[i]; k<bi[i+1]; k++) b->iluapos[k] = map[bj[k]];
+      for (k=bdiag[i+1]+1; k<=bdiag[i]; k++) b->iluapos[k] = map[bj[k]];
+      for (k=ai[r[i]]; k<ai[r[i]+1]; k++) map[ic[aj[k]]] = -1;
+    }
+    ierr = PetscFree(map);CHKERRQ(ierr);
+    ierr = ISRestoreIndices(b->row,&r);CHKERRQ(ierr);
+    ierr = ISRestoreIndices(b->icol,&ic);CHKERRQ(ierr);
+
+    /* the rows of each column of the strictly upper triangular part in increasing order */
+    ierr = PetscCalloc1(n+1,&cnt);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+      for (k=bdiag[i+1]+1; k<bdiag[i]; k++) cnt[bj[k]+1]++;
+    }
+    for (i=0; i<n; i++) cnt[i+1] += cnt[i];
+    ierr = PetscMalloc3(n+1,&b->iluui,cnt[n],&b->iluuj,cnt[n],&b->iluupos);CHKERRQ(ierr);
+    ierr = PetscArraycpy(b->iluui,cnt,n+1);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+      for (k=bdiag[i+1]+1; k<bdiag[i]; k++) {
+        b->iluuj[cnt[bj[k]]]     = i;
+        b->iluupos[cnt[bj[k]]++] = k;
+      }
+    }
+    ierr = PetscFree(cnt);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz,&b->ilua);CHKERRQ(ierr);
+    ierr = PetscMalloc1(2*n,&b->iluwork);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)B,(nz+n+1+2*b->iluui[n])*sizeof(PetscInt)+nz*sizeof(MatScalar)+2*n*sizeof(PetscScalar));CHKERRQ(ierr);
+  }
+  apos = b->iluapos;
+  ui   = b->iluui;
+  uj   = b->iluuj;
+  upos = b->iluupos;
+  old  = b->ilua;
+
+  /* the initial guess: U is the upper triangular part of the matrix and L its strictly lower part scaled by the diagonal */
+  for (i=0; i<n; i++) {
+    sctx.pv = apos[bdiag[i]] < 0 ? 0.0 : aa[apos[bdiag[i]]];
+    ierr    = MatPivotCheck_none(B,A,info,&sctx,i);CHKERRQ(ierr);
+    if (B->factorerrortype) PetscFunctionReturn(0);
+  }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static)
+#endif
+  for (i=0; i<n; i++) {
+    PetscInt p;
+
+    for (p=bi[i]; p<bi[i+1]; p++) ba[p] = apos[p] < 0 ? 0.0 : aa[apos[p]]/aa[apos[bdiag[bj[p]]]];
+    for (p=bdiag[i+1]+1; p<=bdiag[i]; p++) ba[p] = apos[p] < 0 ? 0.0 : aa[apos[p]];
+  }
+
+  /* each sweep computes all the entries from those of the previous sweep, l_ij = (a_ij - sum_k l_ik u_kj)/u_jj and u_ij = a_ij - sum_k l_ik u_kj */
+  for (s=0; s<b->ilusweeps; s++) {
+    ierr = PetscArraycpy(old,ba,nz);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static) reduction(+:flops)
+#endif
+    for (i=0; i<n; i++) {
+      PetscInt p;
+
+      for (p=bi[i]; p<bi[i+1]; p++) {
+        ba[p] = ((apos[p] < 0 ? 0.0 : aa[apos[p]]) - MatILUIterativeDot_Private(i,bj[p],bi,bj,ui,uj,upos,old,&flops))/old[bdiag[bj[p]]];
+      }
+      for (p=bdiag[i+1]+1; p<=bdiag[i]; p++) {
+        ba[p] = (apos[p] < 0 ? 0.0 : aa[apos[p]]) - MatILUIterativeDot_Private(i,bj[p],bi,bj,ui,uj,upos,old,&flops);
+      }
+    }
+  }
+
+  /* the triangular solves use the inverse of the diagonal */
+  for (i=0; i<n; i++) {
+    sctx.pv = ba[bdiag[i]];
+    ierr    = MatPivotCheck_none(B,A,info,&sctx,i);CHKERRQ(ierr);
+    if (B->factorerrortype) PetscFunctionReturn(0);
+    ba[bdiag[i]] = 1.0/ba[bdiag[i]];
+  }
+  ierr = PetscLogFlops(flops + b->ilusweeps*(PetscLogDouble)bi[n] + n);CHKERRQ(ierr);
+
+  B->ops->solve             = MatSolve_SeqAIJ_ILUIterative;
+  B->ops->solveadd          = NULL;
+  B->ops->solvetranspose    = NULL;
+  B->ops->solvetransposeadd = NULL;
+  B->ops->matsolve          = NULL;
+  B->assembled              = PETSC_TRUE;
+  B->preallocated           = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/* called at the end of the ILU symbolic factorizations, frees what the numeric factorization of the previous structure computed */
+static PetscErrorCode MatSeqAIJSetUpILUIterative_Private(Mat fact)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ*)fact->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDestroyILUIterative_Private(fact);CHKERRQ(ierr);
+  if (b->iluiterative) fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_ILUIterative;
+  PetscFunctionReturn(0);
+}
+
 /* ----------------------------------------------------------------*/
 
 /*
@@ -1597,6 +1874,7 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ_ilu0(Mat fact,Mat A,IS isrow,IS iscol
   ierr = ISInvertPermutation(iscol,PETSC_DECIDE,&isicol);CHKERRQ(ierr);
   ierr = MatDuplicateNoCreate_SeqAIJ(fact,A,MAT_DO_NOT_COPY_VALUES,PETSC_FALSE);CHKERRQ(ierr);
   b    = (Mat_SeqAIJ*)(fact)->data;
+  ierr = MatDestroySolveLevels(&b->levels);CHKERRQ(ierr);
 
   /* allocate matrix arrays for new data structure */
   ierr = PetscMalloc3(ai[n]+1,&b->a,ai[n]+1,&b->j,n+1,&b->i);CHKERRQ(ierr);
@@ -1693,6 +1971,7 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ(Mat fact,Mat A,IS isrow,IS iscol,cons
     if (a->inode.size) {
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
     }
+    ierr = MatSeqAIJSetUpILUIterative_Private(fact);CHKERRQ(ierr);
     PetscFunctionReturn(0);
   }
 
@@ -1834,6 +2113,7 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ(Mat fact,Mat A,IS isrow,IS iscol,cons
     (fact)->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
   }
   ierr = MatSeqAIJCheckInode_FactorLU(fact);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetUpILUIterative_Private(fact);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -2031,6 +2311,57 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ_inplace(Mat fact,Mat A,IS isrow,IS is
   PetscFunctionReturn(0);
 }
 
+/*
+   Computes the levels of the solves of a Cholesky or ICC factor, see MatSeqAIJSetUpSolveLevels_Private(). Row k of the factor
+   holds the off-diagonal entries of row k of U, to be subtracted, and the inverse of the diagonal last, at b->diag[k]. The
+   forward solve with U^T needs the columns of U as rows, so they are gathered here.
+*/
+static PetscErrorCode MatSeqSBAIJSetUpSolveLevels_Private(Mat B)
+{
+  Mat_SeqSBAIJ   *b = (Mat_SeqSBAIJ*)B->data;
+  PetscErrorCode ierr;
+  PetscInt       i,k,p,n = B->rmap->n,*ti,*tj,*tpos,*ui,*uj,*upos;
+  const PetscInt *bi = b->i,*bj = b->j;
+
+  PetscFunctionBegin;
+  if (!b->levelsolve) {
+    ierr = MatDestroySolveLevels(&b->levels);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (!b->levels.use) {
+    ierr = PetscCalloc1(n+1,&ti);CHKERRQ(ierr);
+    ierr = PetscMalloc1(n+1,&ui);CHKERRQ(ierr);
+    ui[0] = 0;
+    for (k=0; k<n; k++) {
+      for (p=bi[k]; p<bi[k+1]-1; p++) ti[bj[p]+1]++;
+      ui[k+1] = ui[k] + bi[k+1] - bi[k] - 1;
+    }
+    for (i=0; i<n; i++) ti[i+1] += ti[i];
+    ierr = PetscMalloc4(ui[n],&tj,ui[n],&tpos,ui[n],&uj,ui[n],&upos);CHKERRQ(ierr);
+    for (k=0; k<n; k++) {
+      for (p=bi[k]; p<bi[k+1]-1; p++) {
+        i          = bj[p];
+        tj[ti[i]]   = k;
+        tpos[ti[i]] = p;
+        ti[i]++;
+        uj[ui[k]+p-bi[k]]   = i;
+        upos[ui[k]+p-bi[k]] = p;
+      }
+    }
+    for (i=n; i>0; i--) ti[i] = ti[i-1];
+    ti[0] = 0;
+    ierr = MatSolveLevelsSetUp(B,&b->levels,0,n,ti,tj,tpos,NULL,PETSC_FALSE,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = MatSolveLevelsSetUp(B,&b->levels,1,n,ui,uj,upos,NULL,PETSC_TRUE,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = PetscFree4(tj,tpos,uj,upos);CHKERRQ(ierr);
+    ierr = PetscFree(ti);CHKERRQ(ierr);
+    ierr = PetscFree(ui);CHKERRQ(ierr);
+  }
+  ierr = MatSolveLevelsSetValues(&b->levels,b->a);CHKERRQ(ierr);
+  B->ops->solve          = MatSolve_SeqSBAIJ_1_Levels;
+  B->ops->solvetranspose = MatSolve_SeqSBAIJ_1_Levels;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatCholeskyFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *info)
 {
   Mat            C = B;
@@ -2166,6 +2497,7 @@ PetscErrorCode MatCholeskyFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *
     B->ops->forwardsolve   = MatForwardSolve_SeqSBAIJ_1;
     B->ops->backwardsolve  = MatBackwardSolve_SeqSBAIJ_1;
   }
+  ierr = MatSeqSBAIJSetUpSolveLevels_Private(B);CHKERRQ(ierr);
 
   C->assembled    = PETSC_TRUE;
   C->preallocated = PETSC_TRUE;
@@ -2554,6 +2886,7 @@ PetscErrorCode MatICCFactorSymbolic_SeqAIJ(Mat fact,Mat A,IS perm,const MatFacto
     ierr = PetscInfo(A,"Empty matrix\n");CHKERRQ(ierr);
   }
 #endif
+  ierr = MatDestroySolveLevels(&b->levels);CHKERRQ(ierr);
   fact->ops->choleskyfactornumeric = MatCholeskyFactorNumeric_SeqAIJ;
   PetscFunctionReturn(0);
 }
@@ -2927,6 +3260,7 @@ PetscErrorCode MatCholeskyFactorSymbolic_SeqAIJ(Mat fact,Mat A,IS perm,const Mat
     ierr = PetscInfo(A,"Empty matrix\n");CHKERRQ(ierr);
   }
 #endif
+  ierr = MatDestroySolveLevels(&b->levels);CHKERRQ(ierr);
   fact->ops->choleskyfactornumeric = MatCholeskyFactorNumeric_SeqAIJ;
   PetscFunctionReturn(0);
 }
@@ -3110,6 +3444,10 @@ PetscErrorCode MatSolve_SeqAIJ_NaturalOrdering(Mat A,Vec bb,Vec xx)
 
   PetscFunctionBegin;
   if (!n) PetscFunctionReturn(0);
+  if (a->mixedprecision) {
+    ierr = MatSolve_SeqAIJ_Mixed(A,bb,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
 
   ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
   ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
@@ -3156,6 +3494,10 @@ PetscErrorCode MatSolve_SeqAIJ(Mat A,Vec bb,Vec xx)
 
   PetscFunctionBegin;
   if (!n) PetscFunctionReturn(0);
+  if (a->mixedprecision) {
+    ierr = MatSolve_SeqAIJ_Mixed(A,bb,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
 
   ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
   ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
@@ -3194,6 +3536,129 @@ PetscErrorCode MatSolve_SeqAIJ(Mat A,Vec bb,Vec xx)
   PetscFunctionReturn(0);
 }
 
+/* MatSolve_SeqAIJ() with the rows of each triangular solve in the level order of a->levels */
+static PetscErrorCode MatSolve_SeqAIJ_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode    ierr;
+  PetscInt          i,n = A->rmap->n;
+  const PetscInt    *r,*c;
+  PetscScalar       *x,*tmp;
+  const PetscScalar *b;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+  tmp  = a->solve_work;
+
+  for (i=0; i<n; i++) tmp[i] = b[r[i]];
+  ierr = MatSolveLevelsSweep(&a->levels,0,tmp);CHKERRQ(ierr);
+  ierr = MatSolveLevelsSweep(&a->levels,1,tmp);CHKERRQ(ierr);
+  for (i=0; i<n; i++) x[c[i]] = tmp[i];
+
+  ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatSeqAIJSetUpSolveLevels_Private - Called at the end of the numeric LU and ILU factorizations. With a->levelsolve it computes the
+   levels of the forward and backward solves of the factor, unless they were computed since the symbolic factorization, copies the
+   values of the factor in level order and makes MatSolve() use them; otherwise it frees the levels.
+
+   The L part of row i is b->i[i] to b->i[i+1]-1 and the U part is b->diag[i+1]+1 to b->diag[i]-1, followed by the inverse of the
+   diagonal at b->diag[i].
+*/
+PetscErrorCode MatSeqAIJSetUpSolveLevels_Private(Mat B)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ*)B->data;
+  PetscErrorCode ierr;
+  PetscInt       i,k,n = B->rmap->n,*ui,*uj,*upos;
+  const PetscInt *bi = b->i,*bj = b->j,*bdiag = b->diag;
+
+  PetscFunctionBegin;
+  if (!b->levelsolve) {
+    ierr = MatDestroySolveLevels(&b->levels);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (!b->levels.use) {
+    ierr = MatSolveLevelsSetUp(B,&b->levels,0,n,bi,bj,NULL,NULL,PETSC_FALSE,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = PetscMalloc1(n+1,&ui);CHKERRQ(ierr);
+    ui[0] = 0;
+    for (i=0; i<n; i++) ui[i+1] = ui[i] + bdiag[i] - bdiag[i+1] - 1;
+    ierr = PetscMalloc2(ui[n],&uj,ui[n],&upos);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+      for (k=0; k<ui[i+1]-ui[i]; k++) {
+        upos[ui[i]+k] = bdiag[i+1] + 1 + k;
+        uj[ui[i]+k]   = bj[bdiag[i+1]+1+k];
+      }
+    }
+    ierr = MatSolveLevelsSetUp(B,&b->levels,1,n,ui,uj,upos,bdiag,PETSC_TRUE,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = PetscFree2(uj,upos);CHKERRQ(ierr);
+    ierr = PetscFree(ui);CHKERRQ(ierr);
+  }
+  ierr = MatSolveLevelsSetValues(&b->levels,b->a);CHKERRQ(ierr);
+  B->ops->solve = MatSolve_SeqAIJ_Levels;
+  PetscFunctionReturn(0);
+}
+
+/* MatSolve_SeqAIJ() with the single precision values, used by all the MatSolve() variants of factors with a->mixedprecision */
+PetscErrorCode MatSolve_SeqAIJ_Mixed(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ        *a    = (Mat_SeqAIJ*)A->data;
+  IS                iscol = a->col,isrow = a->row;
+  PetscErrorCode    ierr;
+  PetscInt          i,j,n=A->rmap->n,nz;
+  const PetscInt    *ai=a->i,*aj=a->j,*adiag = a->diag,*vi,*rout,*cout,*r,*c;
+  PetscScalar       *x,*tmp,sum;
+  const PetscScalar *b;
+  const float       *aa,*v;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = MatSeqAIJGetSingleValues_Private(A,&aa);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
+  tmp  = a->solve_work;
+
+  ierr = ISGetIndices(isrow,&rout);CHKERRQ(ierr); r = rout;
+  ierr = ISGetIndices(iscol,&cout);CHKERRQ(ierr); c = cout;
+
+  /* forward solve the lower triangular */
+  tmp[0] = b[r[0]];
+  for (i=1; i<n; i++) {
+    nz  = ai[i+1] - ai[i];
+    v   = aa + ai[i];
+    vi  = aj + ai[i];
+    sum = b[r[i]];
+    for (j=0; j<nz; j++) sum -= v[j]*tmp[vi[j]];
+    tmp[i] = sum;
+  }
+
+  /* backward solve the upper triangular */
+  for (i=n-1; i>=0; i--) {
+    v   = aa + adiag[i+1]+1;
+    vi  = aj + adiag[i+1]+1;
+    nz  = adiag[i]-adiag[i+1]-1;
+    sum = tmp[i];
+    for (j=0; j<nz; j++) sum -= v[j]*tmp[vi[j]];
+    x[c[i]] = tmp[i] = sum*v[nz]; /* v[nz] = aa[adiag[i]] */
+  }
+
+  ierr = ISRestoreIndices(isrow,&rout);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(iscol,&cout);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2*a->nz - A->cmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
     This will get a new name and become a varient of MatILUFactor_SeqAIJ() there is no longer separate functions in the matrix function table for dt factors
 */
@@ -3425,6 +3890,7 @@ PetscErrorCode MatILUDTFactor_SeqAIJ(Mat A,IS isrow,IS iscol,const MatFactorInfo
   B->ops->matsolve          = 0;
   B->assembled              = PETSC_TRUE;
   B->preallocated           = PETSC_TRUE;
+  ierr = MatSeqAIJSetUpSolveLevels_Private(B);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -3546,6 +4012,7 @@ PetscErrorCode  MatILUDTFactorNumeric_SeqAIJ(Mat fact,Mat A,const MatFactorInfo
   C->ops->matsolve          = 0;
   C->assembled              = PETSC_TRUE;
   C->preallocated           = PETSC_TRUE;
+  ierr = MatSeqAIJSetUpSolveLevels_Private(C);CHKERRQ(ierr);
 
   ierr = PetscLogFlops(C->cmap->n);CHKERRQ(ierr);
   PetscFunctionReturn(0);
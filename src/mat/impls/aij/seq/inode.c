@@ -4,6 +4,9 @@
   by taking advantage of rows with identical nonzero structure (I-nodes).
 */
 #include <../src/mat/impls/aij/seq/aij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
 
 static PetscErrorCode MatCreateColInode_Private(Mat A,PetscInt *size,PetscInt **ns)
 {
@@ -364,32 +367,27 @@ static PetscErrorCode MatRestoreColumnIJ_SeqAIJ_Inode(Mat A,PetscInt oshift,Pets
 
 /* ----------------------------------------------------------- */
 
-static PetscErrorCode MatMult_SeqAIJ_Inode(Mat A,Vec xx,Vec yy)
+/*
+   The kernels below compute the rows of the inodes [node0,node1), the first of which is row row0. They do not
+   use PetscFunctionBegin or SETERRQ() since they are called from within OpenMP parallel regions; they return
+   PETSC_ERR_COR for an unsupported node size.
+*/
+static PetscErrorCode MatMult_SeqAIJ_Inode_Private(const Mat_SeqAIJ *a,PetscInt node0,PetscInt node1,PetscInt row0,const PetscScalar *x,PetscScalar *y,PetscInt *nonzerorows)
 {
-  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
   PetscScalar       sum1,sum2,sum3,sum4,sum5,tmp0,tmp1;
-  PetscScalar       *y;
-  const PetscScalar *x;
   const MatScalar   *v1,*v2,*v3,*v4,*v5;
-  PetscErrorCode    ierr;
-  PetscInt          i1,i2,n,i,row,node_max,nsz,sz,nonzerorow=0;
-  const PetscInt    *idx,*ns,*ii;
+  PetscInt          i1,i2,n,i,row,nsz,sz,nonzerorow=0;
+  const PetscInt    *idx,*ns = a->inode.size,*ii;
 
 #if defined(PETSC_HAVE_PRAGMA_DISJOINT)
 #pragma disjoint(*x,*y,*v1,*v2,*v3,*v4,*v5)
 #endif
 
-  PetscFunctionBegin;
-  if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
-  node_max = a->inode.node_count;
-  ns       = a->inode.size;     /* Node Size array */
-  ierr     = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr     = VecGetArray(yy,&y);CHKERRQ(ierr);
-  idx      = a->j;
-  v1       = a->a;
-  ii       = a->i;
+  idx = a->j + a->i[row0];
+  v1  = a->a + a->i[row0];
+  ii  = a->i + row0;
 
-  for (i = 0,row = 0; i< node_max; ++i) {
+  for (i = node0,row = row0; i< node1; ++i) {
     nsz         = ns[i];
     n           = ii[1] - ii[0];
     nonzerorow += (n>0)*nsz;
@@ -544,41 +542,27 @@ static PetscErrorCode MatMult_SeqAIJ_Inode(Mat A,Vec xx,Vec yy)
       idx    +=4*sz;
       break;
     default:
-      SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+      return PETSC_ERR_COR;
     }
   }
-  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
-  ierr = PetscLogFlops(2.0*a->nz - nonzerorow);CHKERRQ(ierr);
-  PetscFunctionReturn(0);
+  *nonzerorows = nonzerorow;
+  return 0;
 }
-/* ----------------------------------------------------------- */
-/* Almost same code as the MatMult_SeqAIJ_Inode() */
-static PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A,Vec xx,Vec zz,Vec yy)
+
+/* Almost same code as MatMult_SeqAIJ_Inode_Private(), y = A x + z */
+static PetscErrorCode MatMultAdd_SeqAIJ_Inode_Private(const Mat_SeqAIJ *a,PetscInt node0,PetscInt node1,PetscInt row0,const PetscScalar *x,const PetscScalar *z,PetscScalar *y)
 {
-  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
   PetscScalar       sum1,sum2,sum3,sum4,sum5,tmp0,tmp1;
   const MatScalar   *v1,*v2,*v3,*v4,*v5;
-  const PetscScalar *x;
-  PetscScalar       *y,*z,*zt;
-  PetscErrorCode    ierr;
-  PetscInt          i1,i2,n,i,row,node_max,nsz,sz;
-  const PetscInt    *idx,*ns,*ii;
+  const PetscScalar *zt = z + row0;
+  PetscInt          i1,i2,n,i,row,nsz,sz;
+  const PetscInt    *idx,*ns = a->inode.size,*ii;
 
-  PetscFunctionBegin;
-  if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
-  node_max = a->inode.node_count;
-  ns       = a->inode.size;     /* Node Size array */
-
-  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr = VecGetArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
-  zt = z;
+  idx = a->j + a->i[row0];
+  v1  = a->a + a->i[row0];
+  ii  = a->i + row0;
 
-  idx = a->j;
-  v1  = a->a;
-  ii  = a->i;
-
-  for (i = 0,row = 0; i< node_max; ++i) {
+  for (i = node0,row = row0; i< node1; ++i) {
     nsz = ns[i];
     n   = ii[1] - ii[0];
     ii += nsz;
@@ -730,9 +714,129 @@ static PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A,Vec xx,Vec zz,Vec yy)
       idx    +=4*sz;
       break;
     default:
-      SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+      return PETSC_ERR_COR;
     }
   }
+  return 0;
+}
+
+#if defined(PETSC_HAVE_OPENMP)
+/* yy = A xx + zz, or yy = A xx when zz is NULL, with the inodes split among the threads */
+static PetscErrorCode MatMultAdd_SeqAIJ_Inode_OpenMP(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt    nt = a->nthreads,*nodes,*rows;
+  const PetscScalar *x,*z = NULL;
+  PetscScalar       *y;
+  PetscInt          nonzerorow = 0;
+  PetscErrorCode    ierr,kerr = 0;
+
+  PetscFunctionBegin;
+  ierr  = MatSeqAIJSetUpThreads_Private(A,PETSC_FALSE);CHKERRQ(ierr);
+  nodes = a->threadnodes;
+  rows  = a->threadnoderows;
+  ierr  = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (zz) {
+    ierr = VecGetArrayPair(zz,yy,(PetscScalar**)&z,&y);CHKERRQ(ierr);
+  } else {
+    ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  }
+#pragma omp parallel num_threads(nt) reduction(+:nonzerorow) reduction(max:kerr)
+  {
+    PetscInt       t,nzr;
+    PetscErrorCode terr;
+
+    for (t=omp_get_thread_num(); t<nt; t+=omp_get_num_threads()) {
+      if (z) {
+        terr = MatMultAdd_SeqAIJ_Inode_Private(a,nodes[t],nodes[t+1],rows[t],x,z,y);
+        nzr  = 0;
+      } else terr = MatMult_SeqAIJ_Inode_Private(a,nodes[t],nodes[t+1],rows[t],x,y,&nzr);
+      kerr        = PetscMax(kerr,terr);
+      nonzerorow += nzr;
+    }
+  }
+  if (kerr) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (zz) {
+    ierr = VecRestoreArrayPair(zz,yy,(PetscScalar**)&z,&y);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  } else {
+    ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+    ierr = PetscLogFlops(2.0*a->nz - nonzerorow);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+#endif
+
+static PetscErrorCode MatMult_SeqAIJ_Inode(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscScalar       *y;
+  const PetscScalar *x;
+  PetscErrorCode    ierr;
+  PetscInt          nonzerorow;
+
+  PetscFunctionBegin;
+  if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
+  if (a->cindices.use) {
+    ierr = MatMultAdd_SeqAIJ_CompressedIndices(A,xx,NULL,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (a->mixedprecision) {
+    ierr = MatMultAdd_SeqAIJ_Mixed(A,xx,NULL,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#if defined(PETSC_HAVE_OPENMP)
+  if (a->nthreads > 1) {
+    ierr = MatMultAdd_SeqAIJ_Inode_OpenMP(A,xx,NULL,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
+  if (a->bmat) {
+    ierr = MatMultAdd_SeqAIJ_Blocks(A,xx,NULL,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  ierr = MatMult_SeqAIJ_Inode_Private(a,0,a->inode.node_count,0,x,y,&nonzerorow);
+  if (ierr) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - nonzerorow);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  const PetscScalar *x;
+  PetscScalar       *y,*z;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
+  if (a->cindices.use) {
+    ierr = MatMultAdd_SeqAIJ_CompressedIndices(A,xx,zz,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (a->mixedprecision) {
+    ierr = MatMultAdd_SeqAIJ_Mixed(A,xx,zz,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#if defined(PETSC_HAVE_OPENMP)
+  if (a->nthreads > 1) {
+    ierr = MatMultAdd_SeqAIJ_Inode_OpenMP(A,xx,zz,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+#endif
+  if (a->bmat) {
+    ierr = MatMultAdd_SeqAIJ_Blocks(A,xx,zz,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
+  ierr = MatMultAdd_SeqAIJ_Inode_Private(a,0,a->inode.node_count,0,x,z,y);
+  if (ierr) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Node size not yet supported");
   ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecRestoreArrayPair(zz,yy,&z,&y);CHKERRQ(ierr);
   ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
@@ -1842,6 +1946,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat B,Mat A,const MatFactorInfo *
   C->ops->matsolve          = MatMatSolve_SeqAIJ;
   C->assembled              = PETSC_TRUE;
   C->preallocated           = PETSC_TRUE;
+  ierr = MatSeqAIJSetUpSolveLevels_Private(C);CHKERRQ(ierr);
 
   ierr = PetscLogFlops(C->cmap->n);CHKERRQ(ierr);
 
@@ -2298,6 +2403,10 @@ PetscErrorCode MatSolve_SeqAIJ_Inode(Mat A,Vec bb,Vec xx)
 
   PetscFunctionBegin;
   if (!a->inode.size) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_COR,"Missing Inode Structure");
+  if (a->mixedprecision) {
+    ierr = MatSolve_SeqAIJ_Mixed(A,bb,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   node_max = a->inode.node_count;
   ns       = a->inode.size;     /* Node Size array */
 
@@ -2724,6 +2833,14 @@ PetscErrorCode MatSOR_SeqAIJ_Inode(Mat A,Vec bb,PetscReal omega,MatSORType flag,
   const PetscInt    *sizes = a->inode.size,*idx,*diag = a->diag,*ii = a->i;
 
   PetscFunctionBegin;
+  if (a->mixedprecision) { /* only the point sweeps of MatSOR_SeqAIJ() have a single precision variant */
+    ierr = MatSOR_SeqAIJ(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (a->bmatsor && omega == 1.0 && fshift == 0.0 && !(flag & (SOR_EISENSTAT | SOR_APPLY_UPPER | SOR_APPLY_LOWER))) {
+    ierr = MatSOR_SeqAIJ_Blocks(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   allowzeropivot = PetscNot(A->erroriffailure);
   if (omega != 1.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support for omega != 1.0; use -mat_no_inode");
   if (fshift != 0.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support for fshift != 0.0; use -mat_no_inode");
@@ -21,6 +21,16 @@ PetscErrorCode MatView_SeqAIJ_Inode(Mat A,PetscViewer viewer)
       } else {
         ierr = PetscViewerASCIIPrintf(viewer,"not using I-node routines\n");CHKERRQ(ierr);
       }
+      if (a->cindices.use) {
+        ierr = PetscViewerASCIIPrintf(viewer,"using compressed column indices: %D byte offsets, MatMult() reads %D fewer bytes of indices\n",a->cindices.width,a->cindices.saved);CHKERRQ(ierr);
+      }
+      if (a->bmat) {
+        ierr = PetscViewerASCIIPrintf(viewer,"using MATSEQBAIJ kernels for dense blocks of size %D%s\n",a->bmat->rmap->bs,a->bmatsor ? ", also in MatSOR()" : "");CHKERRQ(ierr);
+      }
+      ierr = MatSolveLevelsView(&a->levels,viewer);CHKERRQ(ierr);
+      if (a->iluapos) {
+        ierr = PetscViewerASCIIPrintf(viewer,"using iterative ILU with %D threads: %D sweeps of the factorization, %D Jacobi sweeps of each triangular solve\n",a->ilunthreads,a->ilusweeps,a->ilusolvesweeps);CHKERRQ(ierr);
+      }
     }
   }
   PetscFunctionReturn(0);
@@ -59,7 +69,7 @@ PetscErrorCode MatCreate_SeqAIJ_Inode(Mat B)
 {
   Mat_SeqAIJ     *b=(Mat_SeqAIJ*)B->data;
   PetscErrorCode ierr;
-  PetscBool      no_inode,no_unroll;
+  PetscBool      no_inode,no_unroll,mixed,compress,detect,level,flg;
 
   PetscFunctionBegin;
   no_inode             = PETSC_FALSE;
@@ -82,6 +92,19 @@ PetscErrorCode MatCreate_SeqAIJ_Inode(Mat B)
     ierr = PetscInfo(B,"Not using Inode routines due to -mat_no_inode\n");CHKERRQ(ierr);
   }
   ierr = PetscOptionsInt("-mat_inode_limit","Do not use inodes larger then this value",NULL,b->inode.limit,&b->inode.limit,NULL);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+  b->nthreads = 1;
+  ierr = PetscOptionsInt("-mat_aij_omp_threads","Number of OpenMP threads used by MatMult() and MatMultTranspose()",NULL,b->nthreads,&b->nthreads,NULL);CHKERRQ(ierr);
+  if (b->nthreads < 1) SETERRQ1(PetscObjectComm((PetscObject)B),PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",b->nthreads);
+#endif
+  ierr = PetscOptionsBool("-mat_aij_mixed_precision","Use single precision values in MatMult(), MatSOR() and MatSolve()","MatSeqAIJSetMixedPrecision",b->mixedprecision,&mixed,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = MatSeqAIJSetMixedPrecision(B,mixed);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-mat_aij_compress_indices","Store the column indices as 8 or 16 bit offsets in MatMult()","MatSeqAIJSetCompressIndices",b->compressindices,&compress,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = MatSeqAIJSetCompressIndices(B,compress);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-mat_aij_detect_blocks","Use MATSEQBAIJ kernels in MatMult() and MatSOR() for dense blocks found at assembly","MatSeqAIJSetDetectBlocks",b->detectblocks,&detect,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = MatSeqAIJSetDetectBlocks(B,detect);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-mat_aij_level_solve","Schedule the triangular solves of the LU, ILU, Cholesky and ICC factors by levels","MatSeqAIJSetLevelSolve",b->levelsolve,&level,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = MatSeqAIJSetLevelSolve(B,level);CHKERRQ(ierr);}
   ierr = PetscOptionsEnd();CHKERRQ(ierr);
 
   b->inode.use = (PetscBool)(!(no_unroll || no_inode));
@@ -25,15 +25,22 @@ PetscErrorCode MatMatMatMultSymbolic_SeqAIJ_SeqAIJ_SeqAIJ(Mat A,Mat B,Mat C,Pets
   Mat_SeqAIJ        *d;
   Mat_Product       *product = D->product;
   MatProductAlgorithm alg=product->alg;
+  PetscBool         threaded;
 
   PetscFunctionBegin;
   if (!product) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_NULL,"Data struc Mat_Product is not created, call MatProductCreate() first");
   ierr = MatCreate(PETSC_COMM_SELF,&BC);CHKERRQ(ierr);
-  ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ(B,C,fill,BC);CHKERRQ(ierr);
+  ierr = PetscStrcmp(alg,"threaded",&threaded);CHKERRQ(ierr);
+  if (threaded) { /* both products with threads, used by MatPtAP() with "threaded" */
+    ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Threaded(B,C,fill,BC);CHKERRQ(ierr);
+    ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Threaded(A,BC,fill,D);CHKERRQ(ierr);
+  } else {
+    ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ(B,C,fill,BC);CHKERRQ(ierr);
 
-  ierr = MatProductSetAlgorithm(D,"sorted");CHKERRQ(ierr); /* set alg for D = A*BC */
-  ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ(A,BC,fill,D);CHKERRQ(ierr);
-  D->product->alg = alg; /* resume original algorithm for D */
+    ierr = MatProductSetAlgorithm(D,"sorted");CHKERRQ(ierr); /* set alg for D = A*BC */
+    ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ(A,BC,fill,D);CHKERRQ(ierr);
+    D->product->alg = alg; /* resume original algorithm for D */
+  }
 
   /* create struct Mat_MatMatMatMult and attached it to D */
   ierr = PetscNew(&matmatmatmult);CHKERRQ(ierr);
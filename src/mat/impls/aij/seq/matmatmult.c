@@ -9,6 +9,9 @@
 #include <petscbt.h>
 #include <petsc/private/isimpl.h>
 #include <../src/mat/impls/dense/seq/dense.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
 
 PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ(Mat A,Mat B,Mat C)
 {
@@ -123,6 +126,13 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ(Mat A,Mat B,PetscReal fill,Mat C
     PetscFunctionReturn(0);
   }
 
+  /* threaded */
+  ierr = PetscStrcmp(alg,"threaded",&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Threaded(A,B,fill,C);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
 #if defined(PETSC_HAVE_HYPRE)
   ierr = PetscStrcmp(alg,"hypre",&flg);CHKERRQ(ierr);
   if (flg) {
@@ -1142,6 +1152,218 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Sorted(Mat A,Mat B,PetscReal fil
   PetscFunctionReturn(0);
 }
 
+/*
+   "threaded": Gustavson's row by row product with the rows of C split among the OpenMP threads. The symbolic phase
+   counts the entries of each row in a first pass and fills the sorted column indices in a second, each thread marking
+   the columns it has seen in a private dense array; the numeric phase accumulates each row in a private dense row.
+   The rows are summed in the same order as by "sorted", so the result does not depend on the number of threads.
+
+   No PETSc functions are called inside the parallel regions, the function stack is not thread safe.
+*/
+static void MatMatMultSortRow_Private(PetscInt n,PetscInt *x)
+{
+  PetscInt i,j,last,pivot,tmp;
+
+  while (n > 8) {
+    /* median of three to the front, then partition */
+    tmp = x[n/2]; x[n/2] = x[0]; x[0] = tmp;
+    pivot = x[0];
+    last  = 0;
+    for (i=1; i<n; i++) {
+      if (x[i] < pivot) {tmp = x[++last]; x[last] = x[i]; x[i] = tmp;}
+    }
+    tmp = x[0]; x[0] = x[last]; x[last] = tmp;
+    /* recurse on the shorter part, loop on the longer one */
+    if (last < n-1-last) {
+      MatMatMultSortRow_Private(last,x);
+      x += last+1; n -= last+1;
+    } else {
+      MatMatMultSortRow_Private(n-1-last,x+last+1);
+      n = last;
+    }
+  }
+  for (i=1; i<n; i++) {
+    tmp = x[i];
+    for (j=i; j>0 && x[j-1] > tmp; j--) x[j] = x[j-1];
+    x[j] = tmp;
+  }
+}
+
+/* rows[t] is the first row whose offset in the cumulative work w reaches t/nt of the total */
+static void MatMatMultSplitRows_Private(PetscInt m,const PetscInt64 *w,PetscInt nt,PetscInt *rows)
+{
+  PetscInt   t,lo,hi,mid;
+  PetscInt64 target;
+
+  rows[0]  = 0;
+  rows[nt] = m;
+  for (t=1; t<nt; t++) {
+    target = (w[m]*t)/nt;
+    lo     = rows[t-1];
+    hi     = m;
+    while (lo < hi) {
+      mid = lo + (hi-lo)/2;
+      if (w[mid] < target) lo = mid+1;
+      else hi = mid;
+    }
+    rows[t] = lo;
+  }
+}
+
+/* the larger number of threads given to the factors with -mat_aij_omp_threads, otherwise the OpenMP default */
+static PetscInt MatMatMultGetThreads_Private(Mat A,Mat B)
+{
+  PetscInt nt = 1;
+#if defined(PETSC_HAVE_OPENMP)
+  Mat_SeqAIJ *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data;
+
+  nt = PetscMax(a->nthreads,b->nthreads);
+  if (nt <= 1) nt = omp_get_max_threads();
+#endif
+  return nt;
+}
+
+PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Threaded(Mat A,Mat B,PetscReal fill,Mat C)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a  = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c;
+  const PetscInt *ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j;
+  PetscInt       am  = A->rmap->N,bn = B->cmap->N,bm = B->rmap->N,nt,t,i,j,*ci,*cj,*rows,*mark;
+  PetscInt64     *w;
+  PetscReal      afill;
+
+  PetscFunctionBegin;
+  nt   = PetscMax(1,PetscMin(MatMatMultGetThreads_Private(A,B),am));
+  ierr = PetscMalloc1(am+1,&ci);CHKERRQ(ierr);
+  ierr = PetscMalloc3(am+1,&w,nt+1,&rows,nt*bn,&mark);CHKERRQ(ierr);
+
+  /* give each thread about the same number of multiplications */
+  w[0] = 0;
+  for (i=0; i<am; i++) {
+    w[i+1] = w[i];
+    for (j=ai[i]; j<ai[i+1]; j++) w[i+1] += bi[aj[j]+1] - bi[aj[j]];
+  }
+  MatMatMultSplitRows_Private(am,w,nt,rows);
+
+  /* first pass: number of entries in each row of C */
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscInt *seen = mark + t*bn,r,k,l,cnt;
+
+    for (k=0; k<bn; k++) seen[k] = -1;
+    for (r=rows[t]; r<rows[t+1]; r++) {
+      cnt = 0;
+      for (k=ai[r]; k<ai[r+1]; k++) {
+        for (l=bi[aj[k]]; l<bi[aj[k]+1]; l++) {
+          if (seen[bj[l]] != r) {seen[bj[l]] = r; cnt++;}
+        }
+      }
+      ci[r+1] = cnt;
+    }
+  }
+  ci[0] = 0;
+  for (i=0; i<am; i++) ci[i+1] += ci[i];
+  ierr = PetscMalloc1(ci[am]+1,&cj);CHKERRQ(ierr);
+
+  /* second pass: the sorted column indices, the marks of the first pass are told apart by their sign */
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscInt *seen = mark + t*bn,r,k,l,*crow;
+
+    for (r=rows[t]; r<rows[t+1]; r++) {
+      crow = cj + ci[r];
+      for (k=ai[r]; k<ai[r+1]; k++) {
+        for (l=bi[aj[k]]; l<bi[aj[k]+1]; l++) {
+          if (seen[bj[l]] != -r-2) {seen[bj[l]] = -r-2; *crow++ = bj[l];}
+        }
+      }
+      MatMatMultSortRow_Private(ci[r+1]-ci[r],cj+ci[r]);
+    }
+  }
+  ierr = PetscFree3(w,rows,mark);CHKERRQ(ierr);
+
+  /* put together the new symbolic matrix */
+  ierr = MatSetSeqAIJWithArrays_private(PetscObjectComm((PetscObject)A),am,bn,ci,cj,NULL,((PetscObject)A)->type_name,C);CHKERRQ(ierr);
+  ierr = MatSetBlockSizesFromMats(C,A,B);CHKERRQ(ierr);
+
+  /* These are PETSc arrays, so change flags so arrays can be deleted by PETSc */
+  c          = (Mat_SeqAIJ*)(C->data);
+  c->free_a  = PETSC_TRUE;
+  c->free_ij = PETSC_TRUE;
+  c->nonew   = 0;
+
+  /* one dense row for each thread, used by the numeric phase */
+  ierr = PetscCalloc1(nt*bn,&c->matmult_abdense);CHKERRQ(ierr);
+  c->matmult_nthreads = nt;
+
+  C->ops->matmultnumeric = MatMatMultNumeric_SeqAIJ_SeqAIJ_Threaded;
+
+  /* set MatInfo */
+  afill = (PetscReal)ci[am]/(ai[am]+bi[bm]) + 1.e-5;
+  if (afill < 1.0) afill = 1.0;
+  c->maxnz                  = ci[am];
+  c->nz                     = ci[am];
+  C->info.mallocs           = 0;
+  C->info.fill_ratio_given  = fill;
+  C->info.fill_ratio_needed = afill;
+  ierr = PetscInfo3(C,"Product with %D nonzeros computed by %D threads; fill ratio needed %g\n",ci[am],nt,(double)afill);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Threaded(Mat A,Mat B,Mat C)
+{
+  PetscErrorCode  ierr;
+  Mat_SeqAIJ      *a  = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c = (Mat_SeqAIJ*)C->data;
+  const PetscInt  *ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*ci = c->i,*cj = c->j;
+  const MatScalar *aa = a->a,*ba = b->a;
+  PetscInt        am  = A->rmap->n,bn = B->cmap->N,nt = c->matmult_nthreads,t,i,*rows;
+  PetscScalar     *ca,*dense = c->matmult_abdense;
+  PetscInt64      *w;
+  PetscLogDouble  flops = 0.0;
+
+  PetscFunctionBegin;
+  if (!c->a) {
+    ierr      = PetscMalloc1(ci[am]+1,&c->a);CHKERRQ(ierr);
+    c->free_a = PETSC_TRUE;
+  }
+  ca = c->a;
+
+  /* the work of a row is proportional to its length in C */
+  ierr = PetscMalloc2(am+1,&w,nt+1,&rows);CHKERRQ(ierr);
+  for (i=0; i<=am; i++) w[i] = ci[i];
+  MatMatMultSplitRows_Private(am,w,nt,rows);
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscScalar *row = dense + t*bn,v;
+    PetscInt    r,k,l;
+
+    for (r=rows[t]; r<rows[t+1]; r++) {
+      for (k=ai[r]; k<ai[r+1]; k++) {
+        v = aa[k];
+        for (l=bi[aj[k]]; l<bi[aj[k]+1]; l++) row[bj[l]] += v*ba[l];
+        flops += 2*(bi[aj[k]+1] - bi[aj[k]]);
+      }
+      for (k=ci[r]; k<ci[r+1]; k++) {
+        ca[k]      = row[cj[k]];
+        row[cj[k]] = 0.0;
+      }
+    }
+  }
+  ierr = PetscFree2(w,rows);CHKERRQ(ierr);
+
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatDestroy_SeqAIJ_MatMatMultTrans(Mat A)
 {
   PetscErrorCode      ierr;
@@ -1454,13 +1676,13 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqDense(Mat A,Mat B,PetscReal fill,Mat
 PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat A,Mat B,Mat C)
 {
   Mat_SeqAIJ        *a=(Mat_SeqAIJ*)A->data;
-  Mat_SeqDense      *bd = (Mat_SeqDense*)B->data;
+  Mat_SeqDense      *bd = (Mat_SeqDense*)B->data,*cd = (Mat_SeqDense*)C->data;
   PetscErrorCode    ierr;
   PetscScalar       *c,r1,r2,r3,r4,*c1,*c2,*c3,*c4,aatmp;
   const PetscScalar *aa,*b,*b1,*b2,*b3,*b4,*av;
   const PetscInt    *aj;
-  PetscInt          cm=C->rmap->n,cn=B->cmap->n,bm=bd->lda,am=A->rmap->n;
-  PetscInt          am4=4*am,bm4=4*bm,col,i,j,n,ajtmp;
+  PetscInt          cm=C->rmap->n,cn=B->cmap->n,bm=bd->lda,ldc=cd->lda,am=A->rmap->n;
+  PetscInt          cm4=4*ldc,bm4=4*bm,col,i,j,n,ajtmp;
 
   PetscFunctionBegin;
   if (!cm || !cn) PetscFunctionReturn(0);
@@ -1468,8 +1690,8 @@ PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat A,Mat B,Mat C)
   ierr = MatDenseGetArray(C,&c);CHKERRQ(ierr);
   ierr = MatDenseGetArrayRead(B,&b);CHKERRQ(ierr);
   b1 = b; b2 = b1 + bm; b3 = b2 + bm; b4 = b3 + bm;
-  c1 = c; c2 = c1 + am; c3 = c2 + am; c4 = c3 + am;
-  for (col=0; col<cn-4; col += 4) {  /* over columns of C */
+  c1 = c; c2 = c1 + ldc; c3 = c2 + ldc; c4 = c3 + ldc;
+  for (col=0; col<cn-3; col += 4) {  /* over columns of C, four at a time so that A is read once for four columns */
     for (i=0; i<am; i++) {        /* over rows of C in those columns */
       r1 = r2 = r3 = r4 = 0.0;
       n  = a->i[i+1] - a->i[i];
@@ -1488,7 +1710,7 @@ PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat A,Mat B,Mat C)
       c4[i] += r4;
     }
     b1 += bm4; b2 += bm4; b3 += bm4; b4 += bm4;
-    c1 += am4; c2 += am4; c3 += am4; c4 += am4;
+    c1 += cm4; c2 += cm4; c3 += cm4; c4 += cm4;
   }
   for (; col<cn; col++) {   /* over extra columns of C */
     for (i=0; i<am; i++) {  /* over rows of C in those columns */
@@ -1502,7 +1724,7 @@ PetscErrorCode MatMatMultNumericAdd_SeqAIJ_SeqDense(Mat A,Mat B,Mat C)
       c1[i] += r1;
     }
     b1 += bm;
-    c1 += am;
+    c1 += ldc;
   }
   ierr = PetscLogFlops(cn*(2.0*a->nz));CHKERRQ(ierr);
   ierr = MatDenseRestoreArray(C,&c);CHKERRQ(ierr);
@@ -1880,11 +2102,11 @@ static PetscErrorCode MatProductSetFromOptions_SeqAIJ_AB(Mat C)
   PetscInt       alg = 0; /* default algorithm */
   PetscBool      flg = PETSC_FALSE;
 #if !defined(PETSC_HAVE_HYPRE)
-  const char     *algTypes[7] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","rowmerge"};
-  PetscInt       nalg = 7;
-#else
-  const char     *algTypes[8] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","rowmerge","hypre"};
+  const char     *algTypes[8] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","rowmerge","threaded"};
   PetscInt       nalg = 8;
+#else
+  const char     *algTypes[9] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","rowmerge","threaded","hypre"};
+  PetscInt       nalg = 9;
 #endif
 
   PetscFunctionBegin;
@@ -1990,11 +2212,11 @@ static PetscErrorCode MatProductSetFromOptions_SeqAIJ_PtAP(Mat C)
   PetscBool      flg = PETSC_FALSE;
   PetscInt       alg = 0; /* default algorithm -- alg=1 should be default!!! */
 #if !defined(PETSC_HAVE_HYPRE)
-  const char      *algTypes[2] = {"scalable","rap"};
-  PetscInt        nalg = 2;
-#else
-  const char      *algTypes[3] = {"scalable","rap","hypre"};
+  const char      *algTypes[3] = {"scalable","rap","threaded"};
   PetscInt        nalg = 3;
+#else
+  const char      *algTypes[4] = {"scalable","rap","threaded","hypre"};
+  PetscInt        nalg = 4;
 #endif
 
   PetscFunctionBegin;
@@ -2063,8 +2285,8 @@ static PetscErrorCode MatProductSetFromOptions_SeqAIJ_ABC(Mat C)
   Mat_Product    *product = C->product;
   PetscInt       alg = 0; /* default algorithm */
   PetscBool      flg = PETSC_FALSE;
-  const char     *algTypes[7] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","rowmerge"};
-  PetscInt       nalg = 7;
+  const char     *algTypes[8] = {"sorted","scalable","scalable_fast","heap","btheap","llcondensed","rowmerge","threaded"};
+  PetscInt       nalg = 8;
 
   PetscFunctionBegin;
   /* Set default algorithm */
@@ -34,8 +34,9 @@ PetscErrorCode MatProductSymbolic_PtAP_SeqAIJ_SeqAIJ(Mat C)
     PetscFunctionReturn(0);
   }
 
-  /* "rap" */
+  /* "rap", and "threaded" which computes both products of P^T*(A*P) with threads */
   ierr = PetscStrcmp(alg,"rap",&flg);CHKERRQ(ierr);
+  if (!flg) {ierr = PetscStrcmp(alg,"threaded",&flg);CHKERRQ(ierr);}
   if (flg) { /* Set default algorithm */
     ierr = PetscNew(&atb);CHKERRQ(ierr);
     ierr = MatTranspose_SeqAIJ(P,MAT_INITIAL_MATRIX,&Pt);CHKERRQ(ierr);
@@ -111,3 +111,133 @@ PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqBAIJ(Mat A,MatType newtype,MatR
   } else *newmat = B;
   PetscFunctionReturn(0);
 }
+
+/*
+   Looks for a block size bs from 8 down to 2 such that the nonzeros of the SeqAIJ matrix are dense bs x bs blocks aligned
+   with multiples of bs: the rows of each block row have identical column indices and these come in runs of bs starting
+   at a multiple of bs. If one is found, a->bmat is a MATSEQBAIJ with this block structure whose values are copied from
+   a->a when MatMultAdd_SeqAIJ_Blocks() or MatSOR_SeqAIJ_Blocks() is called after the matrix changed.
+*/
+PETSC_INTERN PetscErrorCode MatSeqAIJCheckBlocks_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       m = A->rmap->n,n = A->cmap->n,*ai = a->i,*aj = a->j,bs,mbs,i,r,k,l,row,nz,*bi,*bj;
+  PetscBool      blocked = PETSC_FALSE,eq;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDestroy(&a->bmat);CHKERRQ(ierr);
+  a->bmatsor = PETSC_FALSE;
+  if (!a->detectblocks || A->factortype != MAT_FACTOR_NONE || A->structure_only || !a->nz) PetscFunctionReturn(0);
+  for (bs=8; bs>1; bs--) {
+    if (m % bs || n % bs) continue;
+    blocked = PETSC_TRUE;
+    for (i=0; i<m && blocked; i+=bs) {
+      nz = ai[i+1] - ai[i];
+      if (nz % bs) {blocked = PETSC_FALSE; break;}
+      for (k=ai[i]; k<ai[i+1] && blocked; k+=bs) {
+        if (aj[k] % bs) blocked = PETSC_FALSE;
+        for (l=1; l<bs && blocked; l++) blocked = (PetscBool)(aj[k+l] == aj[k]+l);
+      }
+      for (r=i+1; r<i+bs && blocked; r++) {
+        if (ai[r+1] - ai[r] != nz) {blocked = PETSC_FALSE; break;}
+        ierr = PetscArraycmp(aj+ai[r],aj+ai[i],nz,&eq);CHKERRQ(ierr);
+        blocked = eq;
+      }
+    }
+    if (blocked) break;
+  }
+  if (!blocked) {
+    ierr = PetscInfo(A,"No dense blocks found\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  mbs  = m/bs;
+  ierr = PetscMalloc2(mbs+1,&bi,a->nz/bs/bs,&bj);CHKERRQ(ierr);
+  bi[0] = 0;
+  for (i=0; i<mbs; i++) {
+    row     = i*bs;
+    bi[i+1] = bi[i] + (ai[row+1] - ai[row])/bs;
+    for (k=bi[i]; k<bi[i+1]; k++) bj[k] = aj[ai[row] + (k-bi[i])*bs]/bs;
+  }
+  ierr = MatCreate(PETSC_COMM_SELF,&a->bmat);CHKERRQ(ierr);
+  ierr = MatSetSizes(a->bmat,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(a->bmat,MATSEQBAIJ);CHKERRQ(ierr);
+  ierr = MatSeqBAIJSetPreallocationCSR(a->bmat,bs,bi,bj,NULL);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)A,(PetscObject)a->bmat);CHKERRQ(ierr);
+  a->bmatstate = -1;
+
+  /* MatSOR_SeqBAIJ() inverts the diagonal blocks */
+  if (m == n) {
+    a->bmatsor = PETSC_TRUE;
+    for (i=0; i<mbs && a->bmatsor; i++) {
+      ierr = PetscFindInt(i,bi[i+1]-bi[i],bj+bi[i],&k);CHKERRQ(ierr);
+      a->bmatsor = (PetscBool)(k >= 0);
+    }
+  }
+  ierr = PetscFree2(bi,bj);CHKERRQ(ierr);
+  ierr = PetscInfo3(A,"Found dense %D x %D blocks, MatMult() uses MATSEQBAIJ kernels, MatSOR() %s\n",bs,bs,a->bmatsor ? "as well" : "does not since diagonal blocks are missing");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* returns a->bmat after copying the values of A to it if they changed since the last copy */
+static PetscErrorCode MatSeqAIJGetBlockMatrix_Private(Mat A,Mat *B)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqBAIJ      *b = (Mat_SeqBAIJ*)a->bmat->data;
+  PetscInt         bs = a->bmat->rmap->bs,bs2 = bs*bs,mbs = b->mbs,i,r,k,c,nb;
+  const MatScalar  *v;
+  MatScalar        *bv;
+  PetscObjectState state;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectStateGet((PetscObject)A,&state);CHKERRQ(ierr);
+  if (a->bmatstate != state) {
+    /* the blocks of MATSEQBAIJ are stored by columns */
+    for (i=0; i<mbs; i++) {
+      nb = b->i[i+1] - b->i[i];
+      for (r=0; r<bs; r++) {
+        v  = a->a + a->i[i*bs+r];
+        bv = b->a + bs2*b->i[i] + r;
+        for (k=0; k<nb; k++) {
+          for (c=0; c<bs; c++) bv[c*bs] = v[c];
+          v  += bs;
+          bv += bs2;
+        }
+      }
+    }
+    b->idiagvalid = PETSC_FALSE;
+    ierr = PetscObjectStateIncrease((PetscObject)a->bmat);CHKERRQ(ierr);
+    a->bmatstate = state;
+  }
+  *B = a->bmat;
+  PetscFunctionReturn(0);
+}
+
+/* z = y + A x with the MATSEQBAIJ kernels, y may be NULL for MatMult() */
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_Blocks(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat            B;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJGetBlockMatrix_Private(A,&B);CHKERRQ(ierr);
+  if (yy) {
+    ierr = (*B->ops->multadd)(B,xx,yy,zz);CHKERRQ(ierr);
+  } else {
+    ierr = (*B->ops->mult)(B,xx,zz);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/* MatSOR() with the MATSEQBAIJ kernels, only for omega = 1, no shift and the forward, backward and symmetric sweeps */
+PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ_Blocks(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat            B;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJGetBlockMatrix_Private(A,&B);CHKERRQ(ierr);
+  ierr = (*B->ops->sor)(B,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -24,6 +24,8 @@ typedef struct {
   Mat_SeqAIJ_Inode inode;
   unsigned short   *jshort;
   PetscBool        free_jshort;
+  PetscBool        levelsolve;      /* schedule the solves of the Cholesky and ICC factors by levels, see MatSeqAIJSetLevelSolve() */
+  Mat_SolveLevels  levels;          /* levels of the forward and backward solves */
 } Mat_SeqSBAIJ;
 
 PETSC_INTERN PetscErrorCode MatCholeskyFactorSymbolic_SeqSBAIJ(Mat,Mat,IS,const MatFactorInfo*);
@@ -114,6 +116,7 @@ PETSC_INTERN PetscErrorCode MatCholeskyFactorNumeric_SeqSBAIJ_7(Mat,Mat,const Ma
 PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_N_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_1_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_1(Mat,Vec,Vec);
+PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_1_Levels(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_2_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_3_inplace(Mat,Vec,Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqSBAIJ_4_inplace(Mat,Vec,Vec);
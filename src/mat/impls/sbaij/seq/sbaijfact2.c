@@ -1621,6 +1621,39 @@ PetscErrorCode MatSolve_SeqSBAIJ_1(Mat A,Vec bb,Vec xx)
   PetscFunctionReturn(0);
 }
 
+/* MatSolve_SeqSBAIJ_1() with the rows of each triangular solve in the level order of a->levels */
+PetscErrorCode MatSolve_SeqSBAIJ_1_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqSBAIJ      *a = (Mat_SeqSBAIJ*)A->data;
+  PetscErrorCode    ierr;
+  const PetscInt    mbs = a->mbs,*adiag = a->diag,*rp;
+  const MatScalar   *aa = a->a;
+  const PetscScalar *b;
+  PetscScalar       *x,*t;
+  PetscInt          k;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  t    = a->solve_work;
+  ierr = ISGetIndices(a->row,&rp);CHKERRQ(ierr);
+
+  /* solve U^T*D*y = perm(b) by forward substitution */
+  for (k=0; k<mbs; k++) t[k] = b[rp[k]];
+  ierr = MatSolveLevelsSweep(&a->levels,0,t);CHKERRQ(ierr);
+  for (k=0; k<mbs; k++) t[k] *= aa[adiag[k]];
+
+  /* solve U*perm(x) = y by back substitution */
+  ierr = MatSolveLevelsSweep(&a->levels,1,t);CHKERRQ(ierr);
+  for (k=0; k<mbs; k++) x[rp[k]] = t[k];
+
+  ierr = ISRestoreIndices(a->row,&rp);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(4.0*a->nz - 3.0*mbs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatSolve_SeqSBAIJ_1_inplace(Mat A,Vec bb,Vec xx)
 {
   Mat_SeqSBAIJ      *a   = (Mat_SeqSBAIJ*)A->data;
@@ -5,7 +5,7 @@
 #include <../src/mat/impls/sell/seq/sell.h>  /*I   "petscmat.h"  I*/
 #include <petscblaslapack.h>
 #include <petsc/private/kernels/blocktranspose.h>
-#if defined(PETSC_HAVE_IMMINTRIN_H) && (defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__)) || defined(__AVX__)) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
 
   #include <immintrin.h>
 
@@ -13,7 +13,28 @@
   #define _MM_SCALE_8    8
   #endif
 
-  #if defined(__AVX512F__)
+  #if (defined(__x86_64__) || defined(__i386__)) && !defined(__INTEL_COMPILER) && ((defined(__clang__) && __clang_major__ >= 4) || (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 5))
+    /* every kernel variant is compiled with its own target attribute and the variant is picked at runtime from the CPU features */
+    #define PETSC_SELL_RUNTIME_SIMD
+    #define PETSC_SELL_TARGET(isa) __attribute__((target(isa)))
+    #define PETSC_SELL_HAVE_AVX
+    #define PETSC_SELL_HAVE_AVX2
+    #define PETSC_SELL_HAVE_AVX512
+  #else
+    /* only the variants enabled by the compiler flags are available */
+    #define PETSC_SELL_TARGET(isa)
+    #if defined(__AVX__)
+      #define PETSC_SELL_HAVE_AVX
+    #endif
+    #if defined(__AVX2__) && defined(__FMA__)
+      #define PETSC_SELL_HAVE_AVX2
+    #endif
+    #if defined(__AVX512F__)
+      #define PETSC_SELL_HAVE_AVX512
+    #endif
+  #endif
+
+  #if defined(PETSC_SELL_HAVE_AVX512)
   /* these do not work
    vec_idx  = _mm512_loadunpackhi_epi32(vec_idx,acolidx);
    vec_vals = _mm512_loadunpackhi_pd(vec_vals,aval);
@@ -24,7 +45,8 @@
     vec_vals = _mm512_loadu_pd(aval); \
     vec_x    = _mm512_i32gather_pd(vec_idx,x,_MM_SCALE_8); \
     vec_y    = _mm512_fmadd_pd(vec_x,vec_vals,vec_y)
-  #elif defined(__AVX2__) && defined(__FMA__)
+  #endif
+  #if defined(PETSC_SELL_HAVE_AVX2)
     #define AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y) \
     vec_vals = _mm256_loadu_pd(aval); \
     vec_idx  = _mm_loadu_si128((__m128i const*)acolidx); /* SSE2 */ \
@@ -292,44 +314,125 @@ PetscErrorCode MatConvert_SeqAIJ_SeqSELL(Mat A,MatType newtype,MatReuse reuse,Ma
   PetscFunctionReturn(0);
 }
 
-PetscErrorCode MatMult_SeqSELL(Mat A,Vec xx,Vec yy)
+/*
+   Kernels for MatMult(), MatMultAdd(), MatMultTranspose() and the SOR sweeps, one variant per instruction set.
+   MatSeqSELLSetSIMD_Private() picks the variants when the matrix type is set; the operations below call them through
+   the function pointers in Mat_SeqSELL.
+*/
+static void MatMult_SeqSELL_Kernel(Mat A,const PetscScalar *x,PetscScalar *y)
 {
-  Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
-  PetscScalar       *y;
-  const PetscScalar *x;
-  const MatScalar   *aval=a->val;
-  PetscInt          totalslices=a->totalslices;
-  const PetscInt    *acolidx=a->colidx;
-  PetscInt          i,j;
-  PetscErrorCode    ierr;
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m512d           vec_x,vec_y,vec_vals;
-  __m256i           vec_idx;
-  __mmask8          mask;
-  __m512d           vec_x2,vec_y2,vec_vals2,vec_x3,vec_y3,vec_vals3,vec_x4,vec_y4,vec_vals4;
-  __m256i           vec_idx2,vec_idx3,vec_idx4;
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m128i           vec_idx;
-  __m256d           vec_x,vec_y,vec_y2,vec_vals;
-  MatScalar         yval;
-  PetscInt          r,rows_left,row,nnz_in_row;
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m128d           vec_x_tmp;
-  __m256d           vec_x,vec_y,vec_y2,vec_vals;
-  MatScalar         yval;
-  PetscInt          r,rows_left,row,nnz_in_row;
-#else
-  PetscScalar       sum[8];
-#endif
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,totalslices=a->totalslices;
+  PetscScalar     sum[8];
 
 #if defined(PETSC_HAVE_PRAGMA_DISJOINT)
 #pragma disjoint(*x,*y,*aval)
 #endif
 
-  PetscFunctionBegin;
-  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  for (i=0; i<totalslices; i++) { /* loop over slices */
+    for (j=0; j<8; j++) sum[j] = 0.0;
+    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
+      sum[0] += aval[j] * x[acolidx[j]];
+      sum[1] += aval[j+1] * x[acolidx[j+1]];
+      sum[2] += aval[j+2] * x[acolidx[j+2]];
+      sum[3] += aval[j+3] * x[acolidx[j+3]];
+      sum[4] += aval[j+4] * x[acolidx[j+4]];
+      sum[5] += aval[j+5] * x[acolidx[j+5]];
+      sum[6] += aval[j+6] * x[acolidx[j+6]];
+      sum[7] += aval[j+7] * x[acolidx[j+7]];
+    }
+    if (i == totalslices-1 && (A->rmap->n & 0x07)) { /* if last slice has padding rows */
+      for(j=0; j<(A->rmap->n & 0x07); j++) y[8*i+j] = sum[j];
+    } else {
+      for(j=0; j<8; j++) y[8*i+j] = sum[j];
+    }
+  }
+}
+
+static void MatMultAdd_SeqSELL_Kernel(Mat A,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,totalslices=a->totalslices;
+  PetscScalar     sum[8];
+
+  for (i=0; i<totalslices; i++) { /* loop over slices */
+    for (j=0; j<8; j++) sum[j] = 0.0;
+    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
+      sum[0] += aval[j] * x[acolidx[j]];
+      sum[1] += aval[j+1] * x[acolidx[j+1]];
+      sum[2] += aval[j+2] * x[acolidx[j+2]];
+      sum[3] += aval[j+3] * x[acolidx[j+3]];
+      sum[4] += aval[j+4] * x[acolidx[j+4]];
+      sum[5] += aval[j+5] * x[acolidx[j+5]];
+      sum[6] += aval[j+6] * x[acolidx[j+6]];
+      sum[7] += aval[j+7] * x[acolidx[j+7]];
+    }
+    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
+      for (j=0; j<(A->rmap->n & 0x07); j++) z[8*i+j] = y[8*i+j] + sum[j];
+    } else {
+      for (j=0; j<8; j++) z[8*i+j] = y[8*i+j] + sum[j];
+    }
+  }
+}
+
+/* y = y + A^T x */
+static void MatMultTransposeAdd_SeqSELL_Kernel(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,r,row,shift,nnz_in_row,totalslices=a->totalslices;
+
+  for (i=0; i<totalslices; i++) { /* loop over slices */
+    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
+      shift = a->sliidx[i];
+      for (r=0; r<(A->rmap->n & 0x07); ++r) {
+        row        = 8*i + r;
+        nnz_in_row = a->rlen[row];
+        for (j=0; j<nnz_in_row; ++j) y[acolidx[shift+8*j+r]] += aval[shift+8*j+r] * x[row];
+      }
+      break;
+    }
+    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
+      y[acolidx[j]]   += aval[j] * x[8*i];
+      y[acolidx[j+1]] += aval[j+1] * x[8*i+1];
+      y[acolidx[j+2]] += aval[j+2] * x[8*i+2];
+      y[acolidx[j+3]] += aval[j+3] * x[8*i+3];
+      y[acolidx[j+4]] += aval[j+4] * x[8*i+4];
+      y[acolidx[j+5]] += aval[j+5] * x[8*i+5];
+      y[acolidx[j+6]] += aval[j+6] * x[8*i+6];
+      y[acolidx[j+7]] += aval[j+7] * x[8*i+7];
+    }
+  }
+}
+
+/* returns sum_j val[8*j]*x[colidx[8*j]] for j < n, that is the dot product of part of a row with x */
+static PetscScalar MatSOR_SeqSELL_RowDot(const MatScalar *val,const PetscInt *colidx,const PetscScalar *x,PetscInt n)
+{
+  PetscScalar sum = 0.0;
+  PetscInt    j;
+
+  for (j=0; j<n; j++) sum += val[8*j]*x[colidx[8*j]];
+  return sum;
+}
+
+#if defined(PETSC_SELL_HAVE_AVX512)
+static PETSC_SELL_TARGET("avx512f") void MatMult_SeqSELL_AVX512(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,totalslices=a->totalslices;
+  __m512d         vec_x,vec_y,vec_vals;
+  __m256i         vec_idx;
+  __mmask8        mask;
+  __m512d         vec_x2,vec_y2,vec_vals2,vec_x3,vec_y3,vec_vals3,vec_x4,vec_y4,vec_vals4;
+  __m256i         vec_idx2,vec_idx3,vec_idx4;
+
   for (i=0; i<totalslices; i++) { /* loop over slices */
     PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
     PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
@@ -385,7 +488,150 @@ PetscErrorCode MatMult_SeqSELL(Mat A,Vec xx,Vec yy)
       _mm512_storeu_pd(&y[8*i],vec_y);
     }
   }
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+}
+
+static PETSC_SELL_TARGET("avx512f") void MatMultAdd_SeqSELL_AVX512(Mat A,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,totalslices=a->totalslices;
+  __m512d         vec_x,vec_y,vec_vals;
+  __m256i         vec_idx;
+  __mmask8        mask = 0;
+  __m512d         vec_x2,vec_y2,vec_vals2,vec_x3,vec_y3,vec_vals3,vec_x4,vec_y4,vec_vals4;
+  __m256i         vec_idx2,vec_idx3,vec_idx4;
+
+  for (i=0; i<totalslices; i++) { /* loop over slices */
+    PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+
+    if (i == totalslices-1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
+      mask   = (__mmask8)(0xff >> (8-(A->rmap->n & 0x07)));
+      vec_y  = _mm512_mask_loadu_pd(_mm512_setzero_pd(),mask,&y[8*i]);
+    } else {
+      vec_y  = _mm512_loadu_pd(&y[8*i]);
+    }
+    vec_y2 = _mm512_setzero_pd();
+    vec_y3 = _mm512_setzero_pd();
+    vec_y4 = _mm512_setzero_pd();
+
+    j = a->sliidx[i]>>3; /* 8 bytes are read at each time, corresponding to a slice columnn */
+    switch ((a->sliidx[i+1]-a->sliidx[i])/8 & 3) {
+    case 3:
+      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+      acolidx += 8; aval += 8;
+      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
+      acolidx += 8; aval += 8;
+      AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
+      acolidx += 8; aval += 8;
+      j += 3;
+      break;
+    case 2:
+      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+      acolidx += 8; aval += 8;
+      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
+      acolidx += 8; aval += 8;
+      j += 2;
+      break;
+    case 1:
+      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+      acolidx += 8; aval += 8;
+      j += 1;
+      break;
+    }
+    #pragma novector
+    for (; j<(a->sliidx[i+1]>>3); j+=4) {
+      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+      acolidx += 8; aval += 8;
+      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
+      acolidx += 8; aval += 8;
+      AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
+      acolidx += 8; aval += 8;
+      AVX512_Mult_Private(vec_idx4,vec_x4,vec_vals4,vec_y4);
+      acolidx += 8; aval += 8;
+    }
+
+    vec_y = _mm512_add_pd(vec_y,vec_y2);
+    vec_y = _mm512_add_pd(vec_y,vec_y3);
+    vec_y = _mm512_add_pd(vec_y,vec_y4);
+    if (i == totalslices-1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
+      _mm512_mask_storeu_pd(&z[8*i],mask,vec_y);
+    } else {
+      _mm512_storeu_pd(&z[8*i],vec_y);
+    }
+  }
+}
+
+/* the products of a slice column with x are vectorized, the scatter into y stays scalar since columns may repeat */
+static PETSC_SELL_TARGET("avx512f") void MatMultTransposeAdd_SeqSELL_AVX512(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,r,row,shift,nnz_in_row,totalslices=a->totalslices;
+  PetscScalar     t[8];
+  __m512d         vec_x;
+
+  for (i=0; i<totalslices; i++) { /* loop over slices */
+    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
+      shift = a->sliidx[i];
+      for (r=0; r<(A->rmap->n & 0x07); ++r) {
+        row        = 8*i + r;
+        nnz_in_row = a->rlen[row];
+        for (j=0; j<nnz_in_row; ++j) y[acolidx[shift+8*j+r]] += aval[shift+8*j+r] * x[row];
+      }
+      break;
+    }
+    vec_x = _mm512_loadu_pd(x+8*i);
+    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
+      _mm512_storeu_pd(t,_mm512_mul_pd(_mm512_loadu_pd(aval+j),vec_x));
+      y[acolidx[j]]   += t[0];
+      y[acolidx[j+1]] += t[1];
+      y[acolidx[j+2]] += t[2];
+      y[acolidx[j+3]] += t[3];
+      y[acolidx[j+4]] += t[4];
+      y[acolidx[j+5]] += t[5];
+      y[acolidx[j+6]] += t[6];
+      y[acolidx[j+7]] += t[7];
+    }
+  }
+}
+
+/* gathers 8 entries of the row (stride 8 in val and colidx) at a time */
+static PETSC_SELL_TARGET("avx512f") PetscScalar MatSOR_SeqSELL_RowDot_AVX512(const MatScalar *val,const PetscInt *colidx,const PetscScalar *x,PetscInt n)
+{
+  const __m256i vec_stride = _mm256_set_epi32(56,48,40,32,24,16,8,0);
+  __m512d       vec_sum = _mm512_setzero_pd(),vec_vals,vec_x;
+  __m256i       vec_idx;
+  PetscScalar   t[8],sum;
+  PetscInt      j;
+
+  for (j=0; j+8<=n; j+=8) {
+    vec_idx  = _mm256_i32gather_epi32((const int*)(colidx+8*j),vec_stride,4);
+    vec_vals = _mm512_i32gather_pd(vec_stride,val+8*j,_MM_SCALE_8);
+    vec_x    = _mm512_i32gather_pd(vec_idx,x,_MM_SCALE_8);
+    vec_sum  = _mm512_fmadd_pd(vec_vals,vec_x,vec_sum);
+  }
+  _mm512_storeu_pd(t,vec_sum);
+  sum = ((t[0]+t[1])+(t[2]+t[3]))+((t[4]+t[5])+(t[6]+t[7]));
+  for (; j<n; j++) sum += val[8*j]*x[colidx[8*j]];
+  return sum;
+}
+#endif
+
+#if defined(PETSC_SELL_HAVE_AVX2)
+static PETSC_SELL_TARGET("avx2,fma") void MatMult_SeqSELL_AVX2(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,totalslices=a->totalslices;
+  __m128i         vec_idx;
+  __m256d         vec_x,vec_y,vec_y2,vec_vals;
+  MatScalar       yval;
+  PetscInt        r,rows_left,row,nnz_in_row;
+
   for (i=0; i<totalslices; i++) { /* loop over full slices */
     PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
     PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
@@ -419,7 +665,85 @@ PetscErrorCode MatMult_SeqSELL(Mat A,Vec xx,Vec yy)
     _mm256_storeu_pd(y+i*8,vec_y);
     _mm256_storeu_pd(y+i*8+4,vec_y2);
   }
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+}
+
+static PETSC_SELL_TARGET("avx2,fma") void MatMultAdd_SeqSELL_AVX2(Mat A,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,totalslices=a->totalslices;
+  __m128i         vec_idx;
+  __m256d         vec_x,vec_y,vec_y2,vec_vals;
+  MatScalar       yval;
+  PetscInt        r,row,nnz_in_row;
+
+  for (i=0; i<totalslices; i++) { /* loop over full slices */
+    PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+    PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
+
+    /* last slice may have padding rows. Don't use vectorization. */
+    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
+      for (r=0; r<(A->rmap->n & 0x07); ++r) {
+        row        = 8*i + r;
+        yval       = (MatScalar)0.0;
+        nnz_in_row = a->rlen[row];
+        for (j=0; j<nnz_in_row; ++j) yval += aval[8*j+r] * x[acolidx[8*j+r]];
+        z[row] = y[row] + yval;
+      }
+      break;
+    }
+
+    vec_y  = _mm256_loadu_pd(y+8*i);
+    vec_y2 = _mm256_loadu_pd(y+8*i+4);
+
+    /* Process slice of height 8 (512 bits) via two subslices of height 4 (256 bits) via AVX */
+    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
+      AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
+      aval += 4; acolidx += 4;
+      AVX2_Mult_Private(vec_idx,vec_x,vec_vals,vec_y2);
+      aval += 4; acolidx += 4;
+    }
+
+    _mm256_storeu_pd(z+i*8,vec_y);
+    _mm256_storeu_pd(z+i*8+4,vec_y2);
+  }
+}
+
+/* gathers 4 entries of the row (stride 8 in val and colidx) at a time */
+static PETSC_SELL_TARGET("avx2,fma") PetscScalar MatSOR_SeqSELL_RowDot_AVX2(const MatScalar *val,const PetscInt *colidx,const PetscScalar *x,PetscInt n)
+{
+  const __m128i vec_stride = _mm_set_epi32(24,16,8,0);
+  __m256d       vec_sum = _mm256_setzero_pd(),vec_vals,vec_x;
+  __m128i       vec_idx;
+  PetscScalar   t[4],sum;
+  PetscInt      j;
+
+  for (j=0; j+4<=n; j+=4) {
+    vec_idx  = _mm_i32gather_epi32((const int*)(colidx+8*j),vec_stride,4);
+    vec_vals = _mm256_i32gather_pd(val+8*j,vec_stride,_MM_SCALE_8);
+    vec_x    = _mm256_i32gather_pd(x,vec_idx,_MM_SCALE_8);
+    vec_sum  = _mm256_fmadd_pd(vec_vals,vec_x,vec_sum);
+  }
+  _mm256_storeu_pd(t,vec_sum);
+  sum = (t[0]+t[1])+(t[2]+t[3]);
+  for (; j<n; j++) sum += val[8*j]*x[colidx[8*j]];
+  return sum;
+}
+#endif
+
+#if defined(PETSC_SELL_HAVE_AVX)
+static PETSC_SELL_TARGET("avx") void MatMult_SeqSELL_AVX(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,totalslices=a->totalslices;
+  __m128d         vec_x_tmp = _mm_setzero_pd();
+  __m256d         vec_x = _mm256_setzero_pd(),vec_y,vec_y2,vec_vals;
+  MatScalar       yval;
+  PetscInt        r,rows_left,row,nnz_in_row;
+
   for (i=0; i<totalslices; i++) { /* loop over full slices */
     PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
     PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
@@ -468,127 +792,19 @@ PetscErrorCode MatMult_SeqSELL(Mat A,Vec xx,Vec yy)
     _mm256_storeu_pd(y + i*8,     vec_y);
     _mm256_storeu_pd(y + i*8 + 4, vec_y2);
   }
-#else
-  for (i=0; i<totalslices; i++) { /* loop over slices */
-    for (j=0; j<8; j++) sum[j] = 0.0;
-    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
-      sum[0] += aval[j] * x[acolidx[j]];
-      sum[1] += aval[j+1] * x[acolidx[j+1]];
-      sum[2] += aval[j+2] * x[acolidx[j+2]];
-      sum[3] += aval[j+3] * x[acolidx[j+3]];
-      sum[4] += aval[j+4] * x[acolidx[j+4]];
-      sum[5] += aval[j+5] * x[acolidx[j+5]];
-      sum[6] += aval[j+6] * x[acolidx[j+6]];
-      sum[7] += aval[j+7] * x[acolidx[j+7]];
-    }
-    if (i == totalslices-1 && (A->rmap->n & 0x07)) { /* if last slice has padding rows */
-      for(j=0; j<(A->rmap->n & 0x07); j++) y[8*i+j] = sum[j];
-    } else {
-      for(j=0; j<8; j++) y[8*i+j] = sum[j];
-    }
-  }
-#endif
-
-  ierr = PetscLogFlops(2.0*a->nz-a->nonzerorowcnt);CHKERRQ(ierr); /* theoretical minimal FLOPs */
-  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
-  PetscFunctionReturn(0);
 }
 
-#include <../src/mat/impls/aij/seq/ftn-kernels/fmultadd.h>
-PetscErrorCode MatMultAdd_SeqSELL(Mat A,Vec xx,Vec yy,Vec zz)
+static PETSC_SELL_TARGET("avx") void MatMultAdd_SeqSELL_AVX(Mat A,const PetscScalar *x,const PetscScalar *y,PetscScalar *z)
 {
-  Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
-  PetscScalar       *y,*z;
-  const PetscScalar *x;
-  const MatScalar   *aval=a->val;
-  PetscInt          totalslices=a->totalslices;
-  const PetscInt    *acolidx=a->colidx;
-  PetscInt          i,j;
-  PetscErrorCode    ierr;
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m512d           vec_x,vec_y,vec_vals;
-  __m256i           vec_idx;
-  __mmask8          mask;
-  __m512d           vec_x2,vec_y2,vec_vals2,vec_x3,vec_y3,vec_vals3,vec_x4,vec_y4,vec_vals4;
-  __m256i           vec_idx2,vec_idx3,vec_idx4;
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m128d           vec_x_tmp;
-  __m256d           vec_x,vec_y,vec_y2,vec_vals;
-  MatScalar         yval;
-  PetscInt          r,row,nnz_in_row;
-#else
-  PetscScalar       sum[8];
-#endif
-
-#if defined(PETSC_HAVE_PRAGMA_DISJOINT)
-#pragma disjoint(*x,*y,*aval)
-#endif
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,totalslices=a->totalslices;
+  __m128d         vec_x_tmp = _mm_setzero_pd();
+  __m256d         vec_x = _mm256_setzero_pd(),vec_y,vec_y2,vec_vals;
+  MatScalar       yval;
+  PetscInt        r,row,nnz_in_row;
 
-  PetscFunctionBegin;
-  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
-  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  for (i=0; i<totalslices; i++) { /* loop over slices */
-    PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
-
-    if (i == totalslices-1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
-      mask   = (__mmask8)(0xff >> (8-(A->rmap->n & 0x07)));
-      vec_y  = _mm512_mask_loadu_pd(vec_y,mask,&y[8*i]);
-    } else {
-      vec_y  = _mm512_loadu_pd(&y[8*i]);
-    }
-    vec_y2 = _mm512_setzero_pd();
-    vec_y3 = _mm512_setzero_pd();
-    vec_y4 = _mm512_setzero_pd();
-
-    j = a->sliidx[i]>>3; /* 8 bytes are read at each time, corresponding to a slice columnn */
-    switch ((a->sliidx[i+1]-a->sliidx[i])/8 & 3) {
-    case 3:
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
-      acolidx += 8; aval += 8;
-      j += 3;
-      break;
-    case 2:
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
-      acolidx += 8; aval += 8;
-      j += 2;
-      break;
-    case 1:
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      j += 1;
-      break;
-    }
-    #pragma novector
-    for (; j<(a->sliidx[i+1]>>3); j+=4) {
-      AVX512_Mult_Private(vec_idx,vec_x,vec_vals,vec_y);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx2,vec_x2,vec_vals2,vec_y2);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx3,vec_x3,vec_vals3,vec_y3);
-      acolidx += 8; aval += 8;
-      AVX512_Mult_Private(vec_idx4,vec_x4,vec_vals4,vec_y4);
-      acolidx += 8; aval += 8;
-    }
-
-    vec_y = _mm512_add_pd(vec_y,vec_y2);
-    vec_y = _mm512_add_pd(vec_y,vec_y3);
-    vec_y = _mm512_add_pd(vec_y,vec_y4);
-    if (i == totalslices-1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
-      _mm512_mask_storeu_pd(&z[8*i],mask,vec_y);
-    } else {
-      _mm512_storeu_pd(&z[8*i],vec_y);
-    }
-  }
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
   for (i=0; i<totalslices; i++) { /* loop over full slices */
     PetscPrefetchBlock(acolidx,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
     PetscPrefetchBlock(aval,a->sliidx[i+1]-a->sliidx[i],0,PETSC_PREFETCH_HINT_T0);
@@ -634,27 +850,139 @@ PetscErrorCode MatMultAdd_SeqSELL(Mat A,Vec xx,Vec yy,Vec zz)
     _mm256_storeu_pd(z+i*8,vec_y);
     _mm256_storeu_pd(z+i*8+4,vec_y2);
   }
-#else
+}
+
+/* the products of a slice column with x are vectorized, the scatter into y stays scalar since columns may repeat */
+static PETSC_SELL_TARGET("avx") void MatMultTransposeAdd_SeqSELL_AVX(Mat A,const PetscScalar *x,PetscScalar *y)
+{
+  Mat_SeqSELL     *a=(Mat_SeqSELL*)A->data;
+  const MatScalar *aval=a->val;
+  const PetscInt  *acolidx=a->colidx;
+  PetscInt        i,j,r,row,shift,nnz_in_row,totalslices=a->totalslices;
+  PetscScalar     t[8];
+  __m256d         vec_x,vec_x2;
+
   for (i=0; i<totalslices; i++) { /* loop over slices */
-    for (j=0; j<8; j++) sum[j] = 0.0;
-    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
-      sum[0] += aval[j] * x[acolidx[j]];
-      sum[1] += aval[j+1] * x[acolidx[j+1]];
-      sum[2] += aval[j+2] * x[acolidx[j+2]];
-      sum[3] += aval[j+3] * x[acolidx[j+3]];
-      sum[4] += aval[j+4] * x[acolidx[j+4]];
-      sum[5] += aval[j+5] * x[acolidx[j+5]];
-      sum[6] += aval[j+6] * x[acolidx[j+6]];
-      sum[7] += aval[j+7] * x[acolidx[j+7]];
-    }
     if (i == totalslices-1 && (A->rmap->n & 0x07)) {
-      for (j=0; j<(A->rmap->n & 0x07); j++) z[8*i+j] = y[8*i+j] + sum[j];
-    } else {
-      for (j=0; j<8; j++) z[8*i+j] = y[8*i+j] + sum[j];
+      shift = a->sliidx[i];
+      for (r=0; r<(A->rmap->n & 0x07); ++r) {
+        row        = 8*i + r;
+        nnz_in_row = a->rlen[row];
+        for (j=0; j<nnz_in_row; ++j) y[acolidx[shift+8*j+r]] += aval[shift+8*j+r] * x[row];
+      }
+      break;
+    }
+    vec_x  = _mm256_loadu_pd(x+8*i);
+    vec_x2 = _mm256_loadu_pd(x+8*i+4);
+    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
+      _mm256_storeu_pd(t,_mm256_mul_pd(_mm256_loadu_pd(aval+j),vec_x));
+      _mm256_storeu_pd(t+4,_mm256_mul_pd(_mm256_loadu_pd(aval+j+4),vec_x2));
+      y[acolidx[j]]   += t[0];
+      y[acolidx[j+1]] += t[1];
+      y[acolidx[j+2]] += t[2];
+      y[acolidx[j+3]] += t[3];
+      y[acolidx[j+4]] += t[4];
+      y[acolidx[j+5]] += t[5];
+      y[acolidx[j+6]] += t[6];
+      y[acolidx[j+7]] += t[7];
     }
   }
+}
 #endif
 
+/*
+   Picks the kernel variants for the instruction sets supported by both this build and the CPU running it,
+   the option -mat_sell_simd can select a lower one.
+*/
+static PetscErrorCode MatSeqSELLSetSIMD_Private(Mat A)
+{
+  Mat_SeqSELL       *a = (Mat_SeqSELL*)A->data;
+  const char *const simdtypes[] = {"none","avx","avx2","avx512"};
+  PetscInt          best = MAT_SELL_SIMD_NONE,simd;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+#if defined(PETSC_SELL_RUNTIME_SIMD)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) best = MAT_SELL_SIMD_AVX512;
+  else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) best = MAT_SELL_SIMD_AVX2;
+  else if (__builtin_cpu_supports("avx")) best = MAT_SELL_SIMD_AVX;
+#elif defined(PETSC_SELL_HAVE_AVX512)
+  best = MAT_SELL_SIMD_AVX512;
+#elif defined(PETSC_SELL_HAVE_AVX2)
+  best = MAT_SELL_SIMD_AVX2;
+#elif defined(PETSC_SELL_HAVE_AVX)
+  best = MAT_SELL_SIMD_AVX;
+#endif
+  simd = best;
+  ierr = PetscObjectOptionsBegin((PetscObject)A);CHKERRQ(ierr);
+  ierr = PetscOptionsEList("-mat_sell_simd","Instruction set used by the SELL kernels","None",simdtypes,4,simdtypes[best],&simd,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (simd > best) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_SUP,"Instruction set %s is not supported by this build or CPU, the best available is %s",simdtypes[simd],simdtypes[best]);
+
+  a->simd                   = (MatSeqSELLSIMD)simd;
+  a->multkernel             = MatMult_SeqSELL_Kernel;
+  a->multaddkernel          = MatMultAdd_SeqSELL_Kernel;
+  a->multtransposeaddkernel = MatMultTransposeAdd_SeqSELL_Kernel;
+  a->sorrowdotkernel        = MatSOR_SeqSELL_RowDot;
+  switch (a->simd) {
+#if defined(PETSC_SELL_HAVE_AVX512)
+  case MAT_SELL_SIMD_AVX512:
+    a->multkernel             = MatMult_SeqSELL_AVX512;
+    a->multaddkernel          = MatMultAdd_SeqSELL_AVX512;
+    a->multtransposeaddkernel = MatMultTransposeAdd_SeqSELL_AVX512;
+    a->sorrowdotkernel        = MatSOR_SeqSELL_RowDot_AVX512;
+    break;
+#endif
+#if defined(PETSC_SELL_HAVE_AVX2)
+  case MAT_SELL_SIMD_AVX2:
+    a->multkernel             = MatMult_SeqSELL_AVX2;
+    a->multaddkernel          = MatMultAdd_SeqSELL_AVX2;
+    a->multtransposeaddkernel = MatMultTransposeAdd_SeqSELL_AVX;
+    a->sorrowdotkernel        = MatSOR_SeqSELL_RowDot_AVX2;
+    break;
+#endif
+#if defined(PETSC_SELL_HAVE_AVX)
+  case MAT_SELL_SIMD_AVX:
+    a->multkernel             = MatMult_SeqSELL_AVX;
+    a->multaddkernel          = MatMultAdd_SeqSELL_AVX;
+    a->multtransposeaddkernel = MatMultTransposeAdd_SeqSELL_AVX;
+    break;
+#endif
+  default: break;
+  }
+  ierr = PetscInfo1(A,"Using %s kernels\n",simdtypes[simd]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqSELL(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
+  PetscScalar       *y;
+  const PetscScalar *x;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  (*a->multkernel)(A,x,y);
+  ierr = PetscLogFlops(2.0*a->nz-a->nonzerorowcnt);CHKERRQ(ierr); /* theoretical minimal FLOPs */
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqSELL(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
+  PetscScalar       *y,*z;
+  const PetscScalar *x;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  (*a->multaddkernel)(A,x,y,z);
   ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
@@ -666,15 +994,8 @@ PetscErrorCode MatMultTransposeAdd_SeqSELL(Mat A,Vec xx,Vec zz,Vec yy)
   Mat_SeqSELL       *a=(Mat_SeqSELL*)A->data;
   PetscScalar       *y;
   const PetscScalar *x;
-  const MatScalar   *aval=a->val;
-  const PetscInt    *acolidx=a->colidx;
-  PetscInt          i,j,r,row,nnz_in_row,totalslices=a->totalslices;
   PetscErrorCode    ierr;
 
-#if defined(PETSC_HAVE_PRAGMA_DISJOINT)
-#pragma disjoint(*x,*y,*aval)
-#endif
-
   PetscFunctionBegin;
   if (A->symmetric) {
     ierr = MatMultAdd_SeqSELL(A,xx,zz,yy);CHKERRQ(ierr);
@@ -683,26 +1004,7 @@ PetscErrorCode MatMultTransposeAdd_SeqSELL(Mat A,Vec xx,Vec zz,Vec yy)
   if (zz != yy) { ierr = VecCopy(zz,yy);CHKERRQ(ierr); }
   ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
-  for (i=0; i<a->totalslices; i++) { /* loop over slices */
-    if (i == totalslices-1 && (A->rmap->n & 0x07)) {
-      for (r=0; r<(A->rmap->n & 0x07); ++r) {
-        row        = 8*i + r;
-        nnz_in_row = a->rlen[row];
-        for (j=0; j<nnz_in_row; ++j) y[acolidx[8*j+r]] += aval[8*j+r] * x[row];
-      }
-      break;
-    }
-    for (j=a->sliidx[i]; j<a->sliidx[i+1]; j+=8) {
-      y[acolidx[j]]   += aval[j] * x[8*i];
-      y[acolidx[j+1]] += aval[j+1] * x[8*i+1];
-      y[acolidx[j+2]] += aval[j+2] * x[8*i+2];
-      y[acolidx[j+3]] += aval[j+3] * x[8*i+3];
-      y[acolidx[j+4]] += aval[j+4] * x[8*i+4];
-      y[acolidx[j+5]] += aval[j+5] * x[8*i+5];
-      y[acolidx[j+6]] += aval[j+6] * x[8*i+6];
-      y[acolidx[j+7]] += aval[j+7] * x[8*i+7];
-    }
-  }
+  (*a->multtransposeaddkernel)(A,x,y);
   ierr = PetscLogFlops(2.0*a->sliidx[a->totalslices]);CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
@@ -1638,7 +1940,7 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
   PetscScalar       *x,sum,*t;
   const MatScalar   *idiag=0,*mdiag;
   const PetscScalar *b,*xb;
-  PetscInt          n,m=A->rmap->n,i,j,shift;
+  PetscInt          n,m=A->rmap->n,i,shift;
   const PetscInt    *diag;
   PetscErrorCode    ierr;
 
@@ -1668,7 +1970,7 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
         shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
         sum   = b[i];
         n     = (diag[i]-shift)/8;
-        for (j=0; j<n; j++) sum -= a->val[shift+j*8]*x[a->colidx[shift+j*8]];
+        sum  -= (*a->sorrowdotkernel)(a->val+shift,a->colidx+shift,x,n);
         t[i]  = sum;
         x[i]  = sum*idiag[i];
       }
@@ -1680,7 +1982,7 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
         shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
         sum   = xb[i];
         n     = a->rlen[i]-(diag[i]-shift)/8-1;
-        for (j=1; j<=n; j++) sum -= a->val[diag[i]+j*8]*x[a->colidx[diag[i]+j*8]];
+        sum  -= (*a->sorrowdotkernel)(a->val+diag[i]+8,a->colidx+diag[i]+8,x,n);
         if (xb == b) {
           x[i] = sum*idiag[i];
         } else {
@@ -1698,11 +2000,11 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
         shift = a->sliidx[i>>3]+(i&0x07); /* starting index of the row i */
         sum   = b[i];
         n     = (diag[i]-shift)/8;
-        for (j=0; j<n; j++) sum -= a->val[shift+j*8]*x[a->colidx[shift+j*8]];
+        sum  -= (*a->sorrowdotkernel)(a->val+shift,a->colidx+shift,x,n);
         t[i]  = sum;             /* save application of the lower-triangular part */
         /* upper */
         n     = a->rlen[i]-(diag[i]-shift)/8-1;
-        for (j=1; j<=n; j++) sum -= a->val[diag[i]+j*8]*x[a->colidx[diag[i]+j*8]];
+        sum  -= (*a->sorrowdotkernel)(a->val+diag[i]+8,a->colidx+diag[i]+8,x,n);
         x[i]  = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
       }
       xb   = t;
@@ -1715,11 +2017,11 @@ PetscErrorCode MatSOR_SeqSELL(Mat A,Vec bb,PetscReal omega,MatSORType flag,Petsc
         if (xb == b) {
           /* whole matrix (no checkpointing available) */
           n     = a->rlen[i];
-          for (j=0; j<n; j++) sum -= a->val[shift+j*8]*x[a->colidx[shift+j*8]];
+          sum  -= (*a->sorrowdotkernel)(a->val+shift,a->colidx+shift,x,n);
           x[i] = (1.-omega)*x[i]+(sum+mdiag[i]*x[i])*idiag[i];
         } else { /* lower-triangular part has been saved, so only apply upper-triangular */
           n     = a->rlen[i]-(diag[i]-shift)/8-1;
-          for (j=1; j<=n; j++) sum -= a->val[diag[i]+j*8]*x[a->colidx[diag[i]+j*8]];
+          sum  -= (*a->sorrowdotkernel)(a->val+diag[i]+8,a->colidx+diag[i]+8,x,n);
           x[i]  = (1.-omega)*x[i]+sum*idiag[i];  /* omega in idiag */
         }
       }
@@ -1978,6 +2280,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqSELL(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatRetrieveValues_C",MatRetrieveValues_SeqSELL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqSELLSetPreallocation_C",MatSeqSELLSetPreallocation_SeqSELL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqsell_seqaij_C",MatConvert_SeqSELL_SeqAIJ);CHKERRQ(ierr);
+  ierr = MatSeqSELLSetSIMD_Private(B);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -2105,6 +2408,10 @@ PetscErrorCode MatDuplicate_SeqSELL(Mat A,MatDuplicateOption cpvalues,Mat *B)
  allocation.  For large problems you MUST preallocate memory or you
  will get TERRIBLE performance, see the users' manual chapter on matrices.
 
+ Options Database Keys:
+ .  -mat_sell_simd <none,avx,avx2,avx512> - instruction set used by the MatMult(), MatMultAdd(), MatMultTranspose() and MatSOR()
+    kernels, the default is the best one supported by both the build and the CPU
+
  Level: intermediate
 
  .seealso: MatCreate(), MatCreateSELL(), MatSetValues(), MatCreateSeqSELLWithArrays()
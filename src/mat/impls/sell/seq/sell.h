@@ -40,6 +40,9 @@ PetscInt    totalslices;       /* total number of slices */ \
 PetscInt    *getrowcols;       /* workarray for MatGetRow_SeqSELL */ \
 PetscScalar *getrowvals        /* workarray for MatGetRow_SeqSELL */ \
 
+/* instruction set used by the MatMult(), MatMultAdd(), MatMultTranspose() and MatSOR() kernels */
+typedef enum {MAT_SELL_SIMD_NONE,MAT_SELL_SIMD_AVX,MAT_SELL_SIMD_AVX2,MAT_SELL_SIMD_AVX512} MatSeqSELLSIMD;
+
 typedef struct {
   SEQSELLHEADER(MatScalar);
   MatScalar   *saved_values;             /* location for stashing nonzero values of matrix */
@@ -47,6 +50,11 @@ typedef struct {
   PetscBool   idiagvalid;                /* current idiag[] and mdiag[] are valid */
   PetscScalar fshift,omega;              /* last used omega and fshift */
   ISColoring  coloring;                  /* set with MatADSetColoring() used by MatADSetValues() */
+  MatSeqSELLSIMD simd;                   /* kernels below are selected at MatCreate_SeqSELL() from the CPU features */
+  void        (*multkernel)(Mat,const PetscScalar*,PetscScalar*);
+  void        (*multaddkernel)(Mat,const PetscScalar*,const PetscScalar*,PetscScalar*);
+  void        (*multtransposeaddkernel)(Mat,const PetscScalar*,PetscScalar*);
+  PetscScalar (*sorrowdotkernel)(const MatScalar*,const PetscInt*,const PetscScalar*,PetscInt);
 } Mat_SeqSELL;
 
 /*
@@ -0,0 +1,846 @@
+/*
+    Defines the parallel VBAIJ (variable block compressed row) matrix format, which stores the locally
+  owned block rows as two MATSEQVBAIJ matrices.
+*/
+#include <../src/mat/impls/vbaij/mpi/mpivbaij.h>  /*I "petscmat.h" I*/
+#include <petscsf.h>
+
+static PetscErrorCode MatMPIVBAIJFreeStructure_Private(Mat mat)
+{
+  Mat_MPIVBAIJ   *b = (Mat_MPIVBAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDestroy(&b->A);CHKERRQ(ierr);
+  ierr = MatDestroy(&b->B);CHKERRQ(ierr);
+  ierr = PetscFree2(b->garray,b->gcols);CHKERRQ(ierr);
+  ierr = VecDestroy(&b->lvec);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&b->Mvctx);CHKERRQ(ierr);
+  ierr = PetscFree2(b->rowindices,b->rowvalues);CHKERRQ(ierr);
+  b->nghost = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMPIVBAIJSetPreallocationCSR_MPIVBAIJ(Mat B,PetscInt nblocks,const PetscInt bsizes[],const PetscInt ii[],const PetscInt jj[],const PetscScalar v[])
+{
+  Mat_MPIVBAIJ   *b = (Mat_MPIVBAIJ*)B->data;
+  MPI_Comm       comm;
+  PetscLayout    blayout;
+  PetscSF        sf;
+  IS             from;
+  Vec            gvec;
+  PetscInt       ib,jb,k,c,p,pos,sz,m = 0,n = 0,nz,Nbs,nvd = 0,nvo = 0,nghost = 0,*ghosts,*rootdata,*gbsizes,*gbstart;
+  PetscInt       *iid,*jjd,*iio,*jjo;
+  PetscScalar    *vd = NULL,*vo = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)B,&comm);CHKERRQ(ierr);
+  if (nblocks < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of block rows %D cannot be negative",nblocks);
+  if (ii[0]) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"ii[0] must be 0 it is %D",ii[0]);
+  for (ib=0; ib<nblocks; ib++) m += bsizes[ib];
+  if (B->rmap->n < 0) {ierr = PetscLayoutSetLocalSize(B->rmap,m);CHKERRQ(ierr);}
+  if (B->cmap->n < 0) {ierr = PetscLayoutSetLocalSize(B->cmap,m);CHKERRQ(ierr);}
+  ierr = PetscLayoutSetUp(B->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(B->cmap);CHKERRQ(ierr);
+  if (B->rmap->n != m || B->cmap->n != m) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"MATMPIVBAIJ requires %D local rows and columns to match the block sizes, not %D and %D",m,B->rmap->n,B->cmap->n);
+  ierr = MatMPIVBAIJFreeStructure_Private(B);CHKERRQ(ierr);
+
+  ierr = PetscLayoutCreate(comm,&blayout);CHKERRQ(ierr);
+  ierr = PetscLayoutSetLocalSize(blayout,nblocks);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(blayout);CHKERRQ(ierr);
+  b->rstartbs = blayout->rstart;
+  b->rendbs   = blayout->rend;
+  Nbs         = blayout->N;
+
+  /* the blocks of the other processes that are coupled to, in increasing order */
+  nz   = ii[nblocks];
+  ierr = PetscMalloc1(nz,&ghosts);CHKERRQ(ierr);
+  for (k=0; k<nz; k++) {
+    jb = jj[k];
+    if (jb < 0 || jb >= Nbs) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Block column %D is not in [0,%D)",jb,Nbs);
+    if (jb < b->rstartbs || jb >= b->rendbs) ghosts[nghost++] = jb;
+  }
+  ierr = PetscSortRemoveDupsInt(&nghost,ghosts);CHKERRQ(ierr);
+
+  /* their sizes and first global columns, from their owners */
+  ierr = PetscMalloc3(2*nblocks,&rootdata,nghost,&gbsizes,nghost,&gbstart);CHKERRQ(ierr);
+  for (ib=0, p=B->cmap->rstart; ib<nblocks; ib++) {
+    rootdata[ib]         = bsizes[ib];
+    rootdata[nblocks+ib] = p;
+    p                   += bsizes[ib];
+  }
+  ierr = PetscSFCreate(comm,&sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraphLayout(sf,blayout,nghost,NULL,PETSC_OWN_POINTER,ghosts);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(sf,MPIU_INT,rootdata,gbsizes);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf,MPIU_INT,rootdata,gbsizes);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(sf,MPIU_INT,rootdata+nblocks,gbstart);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf,MPIU_INT,rootdata+nblocks,gbstart);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscLayoutDestroy(&blayout);CHKERRQ(ierr);
+
+  b->nghost = nghost;
+  for (k=0; k<nghost; k++) n += gbsizes[k];
+  ierr = PetscMalloc2(nghost,&b->garray,n,&b->gcols);CHKERRQ(ierr);
+  ierr = PetscArraycpy(b->garray,ghosts,nghost);CHKERRQ(ierr);
+  for (k=0, p=0; k<nghost; k++) {
+    for (c=0; c<gbsizes[k]; c++) b->gcols[p++] = gbstart[k] + c;
+  }
+  ierr = PetscFree(ghosts);CHKERRQ(ierr);
+
+  /* split the block rows between the two parts, with the block columns of B numbered by their position in garray */
+  ierr = PetscMalloc4(nblocks+1,&iid,nz,&jjd,nblocks+1,&iio,nz,&jjo);CHKERRQ(ierr);
+  iid[0] = 0;
+  iio[0] = 0;
+  for (ib=0; ib<nblocks; ib++) {
+    iid[ib+1] = iid[ib];
+    iio[ib+1] = iio[ib];
+    for (k=ii[ib]; k<ii[ib+1]; k++) {
+      jb = jj[k];
+      if (jb >= b->rstartbs && jb < b->rendbs) {
+        jjd[iid[ib+1]++] = jb - b->rstartbs;
+        nvd             += bsizes[ib]*bsizes[jb-b->rstartbs];
+      } else {
+        ierr = PetscFindInt(jb,nghost,b->garray,&pos);CHKERRQ(ierr);
+        jjo[iio[ib+1]++] = pos;
+        nvo             += bsizes[ib]*gbsizes[pos];
+      }
+    }
+  }
+  if (v) {
+    ierr = PetscMalloc2(nvd,&vd,nvo,&vo);CHKERRQ(ierr);
+    nvd  = 0;
+    nvo  = 0;
+    for (ib=0, p=0; ib<nblocks; ib++) {
+      for (k=ii[ib]; k<ii[ib+1]; k++) {
+        jb = jj[k];
+        if (jb >= b->rstartbs && jb < b->rendbs) {
+          sz   = bsizes[ib]*bsizes[jb-b->rstartbs];
+          ierr = PetscArraycpy(vd+nvd,v+p,sz);CHKERRQ(ierr);
+          nvd += sz;
+        } else {
+          ierr = PetscFindInt(jb,nghost,b->garray,&pos);CHKERRQ(ierr);
+          sz   = bsizes[ib]*gbsizes[pos];
+          ierr = PetscArraycpy(vo+nvo,v+p,sz);CHKERRQ(ierr);
+          nvo += sz;
+        }
+        p += sz;
+      }
+    }
+  }
+
+  ierr = MatCreate(PETSC_COMM_SELF,&b->A);CHKERRQ(ierr);
+  ierr = MatSetSizes(b->A,m,m,m,m);CHKERRQ(ierr);
+  ierr = MatSetType(b->A,MATSEQVBAIJ);CHKERRQ(ierr);
+  ierr = MatSetOption(b->A,MAT_ROW_ORIENTED,b->roworiented);CHKERRQ(ierr);
+  ierr = MatSeqVBAIJSetPreallocationCSR(b->A,nblocks,bsizes,iid,jjd,vd);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)B,(PetscObject)b->A);CHKERRQ(ierr);
+  ierr = MatCreate(PETSC_COMM_SELF,&b->B);CHKERRQ(ierr);
+  ierr = MatSetSizes(b->B,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(b->B,MATSEQVBAIJ);CHKERRQ(ierr);
+  ierr = MatSetOption(b->B,MAT_ROW_ORIENTED,b->roworiented);CHKERRQ(ierr);
+  ierr = MatSeqVBAIJSetPreallocationCSR_Private(b->B,nblocks,bsizes,nghost,gbsizes,iio,jjo,vo);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)B,(PetscObject)b->B);CHKERRQ(ierr);
+  ierr = PetscFree4(iid,jjd,iio,jjo);CHKERRQ(ierr);
+  ierr = PetscFree2(vd,vo);CHKERRQ(ierr);
+  ierr = PetscFree3(rootdata,gbsizes,gbstart);CHKERRQ(ierr);
+
+  /* the scatter of the entries of x that B multiplies */
+  ierr = VecCreateSeq(PETSC_COMM_SELF,n,&b->lvec);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)B,(PetscObject)b->lvec);CHKERRQ(ierr);
+  ierr = VecCreateMPIWithArray(comm,1,m,B->cmap->N,NULL,&gvec);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF,n,b->gcols,PETSC_USE_POINTER,&from);CHKERRQ(ierr);
+  ierr = VecScatterCreate(gvec,from,b->lvec,NULL,&b->Mvctx);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)B,(PetscObject)b->Mvctx);CHKERRQ(ierr);
+  ierr = ISDestroy(&from);CHKERRQ(ierr);
+  ierr = VecDestroy(&gvec);CHKERRQ(ierr);
+
+  ierr = MatSetVariableBlockSizes(B,nblocks,(PetscInt*)bsizes);CHKERRQ(ierr);
+  B->preallocated = PETSC_TRUE;
+  B->nonzerostate++;
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValues_MPIVBAIJ(Mat mat,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode addv)
+{
+  Mat_MPIVBAIJ   *b = (Mat_MPIVBAIJ*)mat->data;
+  PetscInt       i,j,row,col,rstart = mat->rmap->rstart,rend = mat->rmap->rend,cstart = mat->cmap->rstart,cend = mat->cmap->rend;
+  PetscScalar    value;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    if (im[i] < 0) continue;
+    if (PetscUnlikelyDebug(im[i] >= mat->rmap->N)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",im[i],mat->rmap->N-1);
+    if (im[i] >= rstart && im[i] < rend) {
+      row = im[i] - rstart;
+      for (j=0; j<n; j++) {
+        if (in[j] < 0) continue;
+        if (PetscUnlikelyDebug(in[j] >= mat->cmap->N)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",in[j],mat->cmap->N-1);
+        value = b->roworiented ? v[i*n+j] : v[i+j*m];
+        if (in[j] >= cstart && in[j] < cend) {
+          col  = in[j] - cstart;
+          ierr = (*b->A->ops->setvalues)(b->A,1,&row,1,&col,&value,addv);CHKERRQ(ierr);
+        } else {
+          ierr = PetscFindInt(in[j],b->B->cmap->n,b->gcols,&col);CHKERRQ(ierr);
+          if (col < 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Inserting a new nonzero at (%D,%D) in a block that is not in the nonzero structure of the matrix",im[i],in[j]);
+          ierr = (*b->B->ops->setvalues)(b->B,1,&row,1,&col,&value,addv);CHKERRQ(ierr);
+        }
+      }
+    } else if (!b->donotstash) {
+      mat->assembled = PETSC_FALSE;
+      if (b->roworiented) {
+        ierr = MatStashValuesRow_Private(&mat->stash,im[i],n,in,v+i*n,PETSC_FALSE);CHKERRQ(ierr);
+      } else {
+        ierr = MatStashValuesCol_Private(&mat->stash,im[i],n,in,v+i,m,PETSC_FALSE);CHKERRQ(ierr);
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetValues_MPIVBAIJ(Mat mat,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],PetscScalar v[])
+{
+  Mat_MPIVBAIJ   *b = (Mat_MPIVBAIJ*)mat->data;
+  PetscInt       i,j,row,col,rstart = mat->rmap->rstart,rend = mat->rmap->rend,cstart = mat->cmap->rstart,cend = mat->cmap->rend;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    if (im[i] < 0) {v += n; continue;}
+    if (im[i] < rstart || im[i] >= rend) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Only local values currently supported");
+    row = im[i] - rstart;
+    for (j=0; j<n; j++) {
+      if (in[j] < 0) {v++; continue;}
+      if (in[j] >= mat->cmap->N) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column %D too large, max %D",in[j],mat->cmap->N-1);
+      if (in[j] >= cstart && in[j] < cend) {
+        col  = in[j] - cstart;
+        ierr = MatGetValues(b->A,1,&row,1,&col,v);CHKERRQ(ierr);
+      } else {
+        ierr = PetscFindInt(in[j],b->B->cmap->n,b->gcols,&col);CHKERRQ(ierr);
+        if (col < 0) *v = 0.0;
+        else {
+          ierr = MatGetValues(b->B,1,&row,1,&col,v);CHKERRQ(ierr);
+        }
+      }
+      v++;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetRow_MPIVBAIJ(Mat mat,PetscInt row,PetscInt *nz,PetscInt **idx,PetscScalar **v)
+{
+  Mat_MPIVBAIJ   *b = (Mat_MPIVBAIJ*)mat->data;
+  PetscScalar    *vworkA,*vworkB,**pvA,**pvB;
+  PetscInt       i,imark,nzA,nzB,lrow,*cworkA,*cworkB,**pcA,**pcB,cstart = mat->cmap->rstart;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (b->getrowactive) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Already active");
+  if (row < mat->rmap->rstart || row >= mat->rmap->rend) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Only local rows");
+  b->getrowactive = PETSC_TRUE;
+  if (!b->rowvalues && (idx || v)) {
+    PetscInt max = ((Mat_SeqVBAIJ*)b->A->data)->maxrowlen + ((Mat_SeqVBAIJ*)b->B->data)->maxrowlen;
+    ierr = PetscMalloc2(max,&b->rowindices,max,&b->rowvalues);CHKERRQ(ierr);
+  }
+  lrow = row - mat->rmap->rstart;
+  pvA  = &vworkA; pcA = &cworkA; pvB = &vworkB; pcB = &cworkB;
+  if (!v) {pvA = NULL; pvB = NULL;}
+  ierr = (*b->A->ops->getrow)(b->A,lrow,&nzA,pcA,pvA);CHKERRQ(ierr);
+  ierr = (*b->B->ops->getrow)(b->B,lrow,&nzB,pcB,pvB);CHKERRQ(ierr);
+  *nz  = nzA + nzB;
+  if (idx || v) {
+    if (*nz) {
+      /* the columns of B left of the local columns come first */
+      for (imark=0; imark<nzB; imark++) {
+        if (b->gcols[cworkB[imark]] > cstart) break;
+      }
+      if (idx) {
+        *idx = b->rowindices;
+        for (i=0; i<imark; i++)   b->rowindices[i]     = b->gcols[cworkB[i]];
+        for (i=0; i<nzA; i++)     b->rowindices[imark+i] = cstart + cworkA[i];
+        for (i=imark; i<nzB; i++) b->rowindices[nzA+i] = b->gcols[cworkB[i]];
+      }
+      if (v) {
+        *v = b->rowvalues;
+        for (i=0; i<imark; i++)   b->rowvalues[i]       = vworkB[i];
+        for (i=0; i<nzA; i++)     b->rowvalues[imark+i] = vworkA[i];
+        for (i=imark; i<nzB; i++) b->rowvalues[nzA+i]   = vworkB[i];
+      }
+    } else {
+      if (idx) *idx = NULL;
+      if (v)   *v   = NULL;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatRestoreRow_MPIVBAIJ(Mat mat,PetscInt row,PetscInt *nz,PetscInt **idx,PetscScalar **v)
+{
+  Mat_MPIVBAIJ *b = (Mat_MPIVBAIJ*)mat->data;
+
+  PetscFunctionBegin;
+  if (!b->getrowactive) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"MatGetRow() must be called first");
+  b->getrowactive = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyBegin_MPIVBAIJ(Mat mat,MatAssemblyType mode)
+{
+  Mat_MPIVBAIJ   *b = (Mat_MPIVBAIJ*)mat->data;
+  PetscInt       nstash,reallocs;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (b->donotstash || mat->nooffprocentries) PetscFunctionReturn(0);
+  ierr = MatStashScatterBegin_Private(mat,&mat->stash,mat->rmap->range);CHKERRQ(ierr);
+  ierr = MatStashGetInfo_Private(&mat->stash,&nstash,&reallocs);CHKERRQ(ierr);
+  ierr = PetscInfo2(b->A,"Stash has %D entries, uses %D mallocs.\n",nstash,reallocs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_MPIVBAIJ(Mat mat,MatAssemblyType mode)
+{
+  Mat_MPIVBAIJ   *b = (Mat_MPIVBAIJ*)mat->data;
+  PetscMPIInt    n;
+  PetscInt       i,j,rstart,ncols,flg,*row,*col;
+  PetscScalar    *val;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!b->donotstash && !mat->nooffprocentries) {
+    while (1) {
+      ierr = MatStashScatterGetMesg_Private(&mat->stash,&n,&row,&col,&val,&flg);CHKERRQ(ierr);
+      if (!flg) break;
+      for (i=0; i<n; ) {
+        /* the consecutive values of the same row are set with a single call */
+        for (j=i,rstart=row[j]; j<n; j++) {
+          if (row[j] != rstart) break;
+        }
+        ncols = j - i;
+        ierr  = MatSetValues_MPIVBAIJ(mat,1,row+i,ncols,col+i,val+i,mat->insertmode);CHKERRQ(ierr);
+        i     = j;
+      }
+    }
+    ierr = MatStashScatterEnd_Private(&mat->stash);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(b->A,mode);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(b->A,mode);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(b->B,mode);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(b->B,mode);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMult_MPIVBAIJ(Mat A,Vec xx,Vec yy)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecScatterBegin(a->Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = (*a->A->ops->mult)(a->A,xx,yy);CHKERRQ(ierr);
+  ierr = VecScatterEnd(a->Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = (*a->B->ops->multadd)(a->B,a->lvec,yy,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultAdd_MPIVBAIJ(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecScatterBegin(a->Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = (*a->A->ops->multadd)(a->A,xx,yy,zz);CHKERRQ(ierr);
+  ierr = VecScatterEnd(a->Mvctx,xx,a->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = (*a->B->ops->multadd)(a->B,a->lvec,zz,zz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultTranspose_MPIVBAIJ(Mat A,Vec xx,Vec yy)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = (*a->B->ops->multtranspose)(a->B,xx,a->lvec);CHKERRQ(ierr);
+  ierr = (*a->A->ops->multtranspose)(a->A,xx,yy);CHKERRQ(ierr);
+  ierr = VecScatterBegin(a->Mvctx,a->lvec,yy,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = VecScatterEnd(a->Mvctx,a->lvec,yy,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultTransposeAdd_MPIVBAIJ(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = (*a->B->ops->multtranspose)(a->B,xx,a->lvec);CHKERRQ(ierr);
+  ierr = (*a->A->ops->multtransposeadd)(a->A,xx,yy,zz);CHKERRQ(ierr);
+  ierr = VecScatterBegin(a->Mvctx,a->lvec,zz,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = VecScatterEnd(a->Mvctx,a->lvec,zz,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    Processor block Gauss-Seidel: the local sweeps of MatSOR_SeqVBAIJ() with the coupling to the other processes
+  moved to the right hand side, as in MatSOR_MPIBAIJ()
+*/
+static PetscErrorCode MatSOR_MPIVBAIJ(Mat matin,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_MPIVBAIJ   *mat = (Mat_MPIVBAIJ*)matin->data;
+  MatSORType     sweep;
+  Vec            bb1 = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if ((flag & SOR_LOCAL_SYMMETRIC_SWEEP) == SOR_LOCAL_SYMMETRIC_SWEEP) sweep = SOR_SYMMETRIC_SWEEP;
+  else if (flag & SOR_LOCAL_FORWARD_SWEEP) sweep = SOR_FORWARD_SWEEP;
+  else if (flag & SOR_LOCAL_BACKWARD_SWEEP) sweep = SOR_BACKWARD_SWEEP;
+  else SETERRQ(PetscObjectComm((PetscObject)matin),PETSC_ERR_SUP,"Parallel version of SOR requested not supported");
+
+  if (its > 1 || ~flag & SOR_ZERO_INITIAL_GUESS) {
+    ierr = VecDuplicate(bb,&bb1);CHKERRQ(ierr);
+  }
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    ierr = (*mat->A->ops->sor)(mat->A,bb,omega,flag,fshift,lits,1,xx);CHKERRQ(ierr);
+    its--;
+  }
+  while (its--) {
+    ierr = VecScatterBegin(mat->Mvctx,xx,mat->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+    ierr = VecScatterEnd(mat->Mvctx,xx,mat->lvec,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+
+    /* update rhs: bb1 = bb - B*x */
+    ierr = VecScale(mat->lvec,-1.0);CHKERRQ(ierr);
+    ierr = (*mat->B->ops->multadd)(mat->B,mat->lvec,bb,bb1);CHKERRQ(ierr);
+
+    /* local sweep */
+    ierr = (*mat->A->ops->sor)(mat->A,bb1,omega,sweep,fshift,lits,1,xx);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&bb1);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatInvertVariableBlockDiagonal_MPIVBAIJ(Mat A,PetscInt nblocks,const PetscInt *bsizes,PetscScalar *diag)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatInvertVariableBlockDiagonal(a->A,nblocks,bsizes,diag);CHKERRQ(ierr);
+  A->factorerrortype = a->A->factorerrortype;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetDiagonal_MPIVBAIJ(Mat A,Vec v)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetDiagonal(a->A,v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMissingDiagonal_MPIVBAIJ(Mat A,PetscBool *missing,PetscInt *d)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMissingDiagonal(a->A,missing,d);CHKERRQ(ierr);
+  if (*missing && d) *d += A->rmap->rstart;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatScale_MPIVBAIJ(Mat A,PetscScalar alpha)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatScale(a->A,alpha);CHKERRQ(ierr);
+  ierr = MatScale(a->B,alpha);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatZeroEntries_MPIVBAIJ(Mat A)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatZeroEntries(a->A);CHKERRQ(ierr);
+  ierr = MatZeroEntries(a->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetOption_MPIVBAIJ(Mat A,MatOption op,PetscBool flg)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  switch (op) {
+  case MAT_ROW_ORIENTED:
+    a->roworiented = flg;
+    if (a->A) {
+      ierr = MatSetOption(a->A,op,flg);CHKERRQ(ierr);
+      ierr = MatSetOption(a->B,op,flg);CHKERRQ(ierr);
+    }
+    break;
+  case MAT_IGNORE_OFF_PROC_ENTRIES:
+    a->donotstash = flg;
+    break;
+  case MAT_NEW_NONZERO_LOCATIONS:
+  case MAT_NEW_NONZERO_LOCATION_ERR:
+  case MAT_NEW_NONZERO_ALLOCATION_ERR:
+  case MAT_KEEP_NONZERO_PATTERN:
+  case MAT_SORTED_FULL:
+  case MAT_SYMMETRIC:
+  case MAT_STRUCTURALLY_SYMMETRIC:
+  case MAT_HERMITIAN:
+  case MAT_SYMMETRY_ETERNAL:
+  case MAT_SPD:
+    /* the nonzero blocks are fixed by MatMPIVBAIJSetPreallocationCSR() and symmetry is recorded in the Mat header */
+    break;
+  default:
+    ierr = PetscInfo1(A,"Option %s ignored\n",MatOptions[op]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetInfo_MPIVBAIJ(Mat matin,MatInfoType flag,MatInfo *info)
+{
+  Mat_MPIVBAIJ   *a = (Mat_MPIVBAIJ*)matin->data;
+  PetscLogDouble isend[5],irecv[5];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetInfo(a->A,MAT_LOCAL,info);CHKERRQ(ierr);
+  isend[0] = info->nz_used; isend[1] = info->nz_allocated; isend[2] = info->nz_unneeded;
+  isend[3] = info->memory;  isend[4] = info->mallocs;
+  ierr = MatGetInfo(a->B,MAT_LOCAL,info);CHKERRQ(ierr);
+  isend[0] += info->nz_used; isend[1] += info->nz_allocated; isend[2] += info->nz_unneeded;
+  isend[3] += info->memory;  isend[4] += info->mallocs;
+  if (flag == MAT_LOCAL) {
+    ierr = PetscArraycpy(irecv,isend,5);CHKERRQ(ierr);
+  } else if (flag == MAT_GLOBAL_MAX) {
+    ierr = MPIU_Allreduce(isend,irecv,5,MPIU_PETSCLOGDOUBLE,MPI_MAX,PetscObjectComm((PetscObject)matin));CHKERRQ(ierr);
+  } else if (flag == MAT_GLOBAL_SUM) {
+    ierr = MPIU_Allreduce(isend,irecv,5,MPIU_PETSCLOGDOUBLE,MPI_SUM,PetscObjectComm((PetscObject)matin));CHKERRQ(ierr);
+  } else SETERRQ1(PetscObjectComm((PetscObject)matin),PETSC_ERR_ARG_WRONG,"Unknown MatInfoType argument %d",(int)flag);
+  info->block_size        = 1.0;
+  info->nz_used           = irecv[0];
+  info->nz_allocated      = irecv[1];
+  info->nz_unneeded       = irecv[2];
+  info->memory            = irecv[3];
+  info->mallocs           = irecv[4];
+  info->fill_ratio_given  = 0;
+  info->fill_ratio_needed = 0;
+  info->factor_mallocs    = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDuplicate_MPIVBAIJ(Mat matin,MatDuplicateOption cpvalues,Mat *newmat)
+{
+  Mat_MPIVBAIJ   *a,*oldmat = (Mat_MPIVBAIJ*)matin->data;
+  Mat            mat;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(PetscObjectComm((PetscObject)matin),&mat);CHKERRQ(ierr);
+  ierr = MatSetSizes(mat,matin->rmap->n,matin->cmap->n,matin->rmap->N,matin->cmap->N);CHKERRQ(ierr);
+  ierr = MatSetType(mat,((PetscObject)matin)->type_name);CHKERRQ(ierr);
+  ierr = PetscLayoutReference(matin->rmap,&mat->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutReference(matin->cmap,&mat->cmap);CHKERRQ(ierr);
+  a    = (Mat_MPIVBAIJ*)mat->data;
+
+  mat->assembled    = matin->assembled;
+  mat->insertmode   = NOT_SET_VALUES;
+  mat->preallocated = matin->preallocated;
+  a->rstartbs       = oldmat->rstartbs;
+  a->rendbs         = oldmat->rendbs;
+  a->nghost         = oldmat->nghost;
+  a->roworiented    = oldmat->roworiented;
+  a->donotstash     = oldmat->donotstash;
+  if (matin->preallocated) {
+    ierr = PetscMalloc2(a->nghost,&a->garray,oldmat->B->cmap->n,&a->gcols);CHKERRQ(ierr);
+    ierr = PetscArraycpy(a->garray,oldmat->garray,a->nghost);CHKERRQ(ierr);
+    ierr = PetscArraycpy(a->gcols,oldmat->gcols,oldmat->B->cmap->n);CHKERRQ(ierr);
+    ierr = VecDuplicate(oldmat->lvec,&a->lvec);CHKERRQ(ierr);
+    ierr = PetscLogObjectParent((PetscObject)mat,(PetscObject)a->lvec);CHKERRQ(ierr);
+    ierr = VecScatterCopy(oldmat->Mvctx,&a->Mvctx);CHKERRQ(ierr);
+    ierr = PetscLogObjectParent((PetscObject)mat,(PetscObject)a->Mvctx);CHKERRQ(ierr);
+    ierr = MatDuplicate(oldmat->A,cpvalues,&a->A);CHKERRQ(ierr);
+    ierr = PetscLogObjectParent((PetscObject)mat,(PetscObject)a->A);CHKERRQ(ierr);
+    ierr = MatDuplicate(oldmat->B,cpvalues,&a->B);CHKERRQ(ierr);
+    ierr = PetscLogObjectParent((PetscObject)mat,(PetscObject)a->B);CHKERRQ(ierr);
+    ierr = MatSetVariableBlockSizes(mat,matin->nblocks,matin->bsizes);CHKERRQ(ierr);
+  }
+  ierr    = PetscFunctionListDuplicate(((PetscObject)matin)->qlist,&((PetscObject)mat)->qlist);CHKERRQ(ierr);
+  *newmat = mat;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatView_MPIVBAIJ(Mat A,PetscViewer viewer)
+{
+  Mat_MPIVBAIJ      *a = (Mat_MPIVBAIJ*)A->data;
+  Mat_SeqVBAIJ      *ad = (Mat_SeqVBAIJ*)a->A->data,*ao = (Mat_SeqVBAIJ*)a->B->data;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+  PetscInt          ib,sum[2],minbs = PETSC_MAX_INT,maxbs = 0,gminbs,gmaxbs;
+  Mat               B;
+  const char        *name;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO || format == PETSC_VIEWER_ASCII_INFO_DETAIL) {
+      for (ib=0; ib<ad->mbs; ib++) {
+        minbs = PetscMin(minbs,ad->bsizes[ib]);
+        maxbs = PetscMax(maxbs,ad->bsizes[ib]);
+      }
+      sum[0] = ad->mbs;
+      sum[1] = ad->nz + ao->nz;
+      ierr = MPIU_Allreduce(MPI_IN_PLACE,sum,2,MPIU_INT,MPI_SUM,PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
+      ierr = MPIU_Allreduce(&minbs,&gminbs,1,MPIU_INT,MPI_MIN,PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
+      ierr = MPIU_Allreduce(&maxbs,&gmaxbs,1,MPIU_INT,MPI_MAX,PetscObjectComm((PetscObject)A));CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPrintf(viewer,"%D block rows with block sizes from %D to %D, %D nonzero blocks\n",sum[0],sum[0] ? gminbs : 0,gmaxbs,sum[1]);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    if (format == PETSC_VIEWER_ASCII_FACTOR_INFO) PetscFunctionReturn(0);
+  }
+  /* the entries are shown as those of the equivalent MATAIJ matrix */
+  ierr = MatConvert(A,MATAIJ,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = PetscObjectGetName((PetscObject)A,&name);CHKERRQ(ierr);
+  ierr = PetscObjectSetName((PetscObject)B,name);CHKERRQ(ierr);
+  ierr = (*B->ops->view)(B,viewer);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_MPIVBAIJ(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_LOG)
+  PetscLogObjectState((PetscObject)A,"Rows=%D, Cols=%D",A->rmap->N,A->cmap->N);
+#endif
+  ierr = MatStashDestroy_Private(&A->stash);CHKERRQ(ierr);
+  ierr = MatMPIVBAIJFreeStructure_Private(A);CHKERRQ(ierr);
+  ierr = PetscFree(A->data);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatMPIVBAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_mpiaij_mpivbaij_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    The nonzero blocks are the blocks of A that contain at least one entry of its nonzero structure; the
+  blocks of the columns owned by other processes are found by asking the owners for the blocks of these columns
+*/
+static PetscErrorCode MatConvert_MPIAIJ_MPIVBAIJ(Mat A,MatType newtype,MatReuse reuse,Mat *newmat)
+{
+  Mat               B,Ad,Ao;
+  MPI_Comm          comm;
+  PetscSF           sf;
+  const PetscInt    *garray,*cols;
+  const PetscScalar *vals;
+  PetscInt          m = A->rmap->n,mbs = A->nblocks,rstart = A->rmap->rstart,cstart = A->cmap->rstart,cend = A->cmap->rend;
+  PetscInt          ib,r,k,l,row,nc,nghost,rstartbs,rendbs,len,nzmax = 0,*gblock,*ghostblock,*ii,*jj;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)A,&comm);CHKERRQ(ierr);
+  if (m && !A->nblocks) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Call MatSetVariableBlockSizes() on the matrix before converting it to MATMPIVBAIJ");
+  if (m != A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_SUP,"MATMPIVBAIJ requires the same number of local rows and columns, not %D and %D",m,A->cmap->n);
+  ierr = MPI_Scan(&mbs,&rendbs,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+  rstartbs = rendbs - mbs;
+
+  /* global block of each local column, and of each column of the off-diagonal part from its owner */
+  ierr = MatMPIAIJGetSeqAIJ(A,&Ad,&Ao,&garray);CHKERRQ(ierr);
+  nghost = Ao->cmap->n;
+  ierr = PetscMalloc2(m,&gblock,nghost,&ghostblock);CHKERRQ(ierr);
+  for (ib=0, row=0; ib<mbs; ib++) {
+    for (r=0; r<A->bsizes[ib]; r++, row++) gblock[row] = rstartbs + ib;
+  }
+  ierr = PetscSFCreate(comm,&sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraphLayout(sf,A->cmap,nghost,NULL,PETSC_OWN_POINTER,garray);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(sf,MPIU_INT,gblock,ghostblock);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf,MPIU_INT,gblock,ghostblock);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+
+  if (reuse == MAT_REUSE_MATRIX) {
+    B    = *newmat;
+    ierr = MatZeroEntries(B);CHKERRQ(ierr);
+  } else {
+    for (row=rstart; row<rstart+m; row++) {
+      ierr   = MatGetRow(A,row,&nc,NULL,NULL);CHKERRQ(ierr);
+      nzmax += nc;
+      ierr   = MatRestoreRow(A,row,&nc,NULL,NULL);CHKERRQ(ierr);
+    }
+    ierr  = PetscMalloc2(mbs+1,&ii,nzmax,&jj);CHKERRQ(ierr);
+    ii[0] = 0;
+    for (ib=0, row=rstart; ib<mbs; ib++) {
+      len = 0;
+      for (r=0; r<A->bsizes[ib]; r++, row++) {
+        ierr = MatGetRow(A,row,&nc,&cols,NULL);CHKERRQ(ierr);
+        for (l=0; l<nc; l++) {
+          if (cols[l] >= cstart && cols[l] < cend) jj[ii[ib]+len++] = gblock[cols[l]-cstart];
+          else {
+            ierr = PetscFindInt(cols[l],nghost,garray,&k);CHKERRQ(ierr);
+            jj[ii[ib]+len++] = ghostblock[k];
+          }
+        }
+        ierr = MatRestoreRow(A,row,&nc,&cols,NULL);CHKERRQ(ierr);
+      }
+      ierr     = PetscSortRemoveDupsInt(&len,jj+ii[ib]);CHKERRQ(ierr);
+      ii[ib+1] = ii[ib] + len;
+    }
+    ierr = MatCreate(comm,&B);CHKERRQ(ierr);
+    ierr = MatSetSizes(B,m,m,A->rmap->N,A->cmap->N);CHKERRQ(ierr);
+    ierr = MatSetType(B,MATMPIVBAIJ);CHKERRQ(ierr);
+    ierr = MatMPIVBAIJSetPreallocationCSR(B,mbs,A->bsizes,ii,jj,NULL);CHKERRQ(ierr);
+    ierr = PetscFree2(ii,jj);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(gblock,ghostblock);CHKERRQ(ierr);
+
+  for (row=rstart; row<rstart+m; row++) {
+    ierr = MatGetRow(A,row,&nc,&cols,&vals);CHKERRQ(ierr);
+    ierr = MatSetValues(B,1,&row,nc,cols,vals,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = MatRestoreRow(A,row,&nc,&cols,&vals);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  if (reuse == MAT_INPLACE_MATRIX) {
+    ierr = MatHeaderReplace(A,&B);CHKERRQ(ierr);
+  } else *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATMPIVBAIJ - MATMPIVBAIJ = "mpivbaij" - A matrix type for parallel sparse matrices made of dense blocks
+   whose sizes vary from block row to block row.
+
+   Each process owns whole block rows. The rows and the columns are split into blocks of the same sizes, set with
+   MatMPIVBAIJSetPreallocationCSR() or taken from MatSetVariableBlockSizes() when a MATMPIAIJ matrix is converted
+   with MatConvert().
+
+   Options Database Keys:
+. -mat_type mpivbaij - sets the matrix type to "mpivbaij" during a call to MatSetFromOptions()
+
+   Level: intermediate
+
+   Notes:
+    MatSetValues() can set entries of rows owned by other processes; they are sent to their owners during the
+    assembly. Only entries of the nonzero blocks given to MatMPIVBAIJSetPreallocationCSR() can be set.
+
+    MatSOR() provides the processor local block Gauss-Seidel sweeps and MatInvertVariableBlockDiagonal() provides
+    the inverses of the diagonal blocks to PCVPBJACOBI.
+
+.seealso: MatMPIVBAIJSetPreallocationCSR(), MATSEQVBAIJ, MATVBAIJ, MatSetVariableBlockSizes(), PCVPBJACOBI
+M*/
+
+/*MC
+   MATVBAIJ - MATVBAIJ = "vbaij" - A matrix type for sparse matrices made of dense blocks whose sizes vary
+   from block row to block row.
+
+   This matrix type is identical to MATSEQVBAIJ when constructed with a single process communicator,
+   and MATMPIVBAIJ otherwise.
+
+   Options Database Keys:
+. -mat_type vbaij - sets the matrix type to "vbaij" during a call to MatSetFromOptions()
+
+   Level: intermediate
+
+.seealso: MATSEQVBAIJ, MATMPIVBAIJ, MatSeqVBAIJSetPreallocationCSR(), MatMPIVBAIJSetPreallocationCSR()
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIVBAIJ(Mat B)
+{
+  Mat_MPIVBAIJ   *b;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr    = PetscNewLog(B,&b);CHKERRQ(ierr);
+  B->data = (void*)b;
+  b->roworiented = PETSC_TRUE;
+  ierr = MatStashCreate_Private(PetscObjectComm((PetscObject)B),1,&B->stash);CHKERRQ(ierr);
+
+  B->ops->setvalues                   = MatSetValues_MPIVBAIJ;
+  B->ops->getvalues                   = MatGetValues_MPIVBAIJ;
+  B->ops->getrow                      = MatGetRow_MPIVBAIJ;
+  B->ops->restorerow                  = MatRestoreRow_MPIVBAIJ;
+  B->ops->assemblybegin               = MatAssemblyBegin_MPIVBAIJ;
+  B->ops->assemblyend                 = MatAssemblyEnd_MPIVBAIJ;
+  B->ops->mult                        = MatMult_MPIVBAIJ;
+  B->ops->multadd                     = MatMultAdd_MPIVBAIJ;
+  B->ops->multtranspose               = MatMultTranspose_MPIVBAIJ;
+  B->ops->multtransposeadd            = MatMultTransposeAdd_MPIVBAIJ;
+  B->ops->sor                         = MatSOR_MPIVBAIJ;
+  B->ops->invertvariableblockdiagonal = MatInvertVariableBlockDiagonal_MPIVBAIJ;
+  B->ops->getdiagonal                 = MatGetDiagonal_MPIVBAIJ;
+  B->ops->missingdiagonal             = MatMissingDiagonal_MPIVBAIJ;
+  B->ops->scale                       = MatScale_MPIVBAIJ;
+  B->ops->zeroentries                 = MatZeroEntries_MPIVBAIJ;
+  B->ops->setoption                   = MatSetOption_MPIVBAIJ;
+  B->ops->getinfo                     = MatGetInfo_MPIVBAIJ;
+  B->ops->duplicate                   = MatDuplicate_MPIVBAIJ;
+  B->ops->view                        = MatView_MPIVBAIJ;
+  B->ops->destroy                     = MatDestroy_MPIVBAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIVBAIJSetPreallocationCSR_C",MatMPIVBAIJSetPreallocationCSR_MPIVBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpivbaij_C",MatConvert_MPIAIJ_MPIVBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIVBAIJ);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatMPIVBAIJSetPreallocationCSR - Sets the variable block sizes, the nonzero blocks and (optionally) the values of
+   the locally owned block rows of a MATMPIVBAIJ matrix
+
+   Collective
+
+   Input Parameters:
++  B - the matrix
+.  nblocks - the number of locally owned block rows
+.  bsizes - the size of each locally owned block row
+.  i - the indices into j for the start of each local block row (starts with zero)
+.  j - the global block column indices for each local block row (starts with zero), these must be sorted for each block row
+-  v - optional values of the blocks, one after the other in the order of j
+
+   Level: intermediate
+
+   Notes:
+   The block rows are numbered across the processes in rank order and block column J has the size of block row J,
+   which may be owned by another process. Block (I,J) has bsizes[I] rows and the size of block J as number of columns.
+   The order of the entries within a block of v is specified by the MatOption MAT_ROW_ORIENTED, as for
+   MatSeqVBAIJSetPreallocationCSR().
+
+   The local number of rows and columns of the matrix is the sum of bsizes; the block sizes are also set with
+   MatSetVariableBlockSizes() so that PCVPBJACOBI uses them.
+
+   Though this routine has Preallocation() in the name it also sets the exact nonzero blocks of the matrix; MatSetValues()
+   cannot add new blocks later.
+
+.seealso: MatCreate(), MATMPIVBAIJ, MatSeqVBAIJSetPreallocationCSR(), MatSetValues(), MatSetVariableBlockSizes(), MatMPIBAIJSetPreallocationCSR()
+@*/
+PetscErrorCode MatMPIVBAIJSetPreallocationCSR(Mat B,PetscInt nblocks,const PetscInt bsizes[],const PetscInt i[],const PetscInt j[],const PetscScalar v[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(B,MAT_CLASSID,1);
+  PetscValidType(B,1);
+  ierr = PetscTryMethod(B,"MatMPIVBAIJSetPreallocationCSR_C",(Mat,PetscInt,const PetscInt[],const PetscInt[],const PetscInt[],const PetscScalar[]),(B,nblocks,bsizes,i,j,v));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
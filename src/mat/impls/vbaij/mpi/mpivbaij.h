@@ -0,0 +1,25 @@
+#if !defined(__MPIVBAIJ_H)
+#define __MPIVBAIJ_H
+#include <../src/mat/impls/vbaij/seq/vbaij.h>
+
+/*
+   MATMPIVBAIJ stores the block rows owned by a process in two MATSEQVBAIJ matrices: A holds the blocks in the
+   block columns owned by the process and B the blocks in the block columns of the other processes. The block
+   columns of B are the global blocks garray, in increasing order, and lvec receives the entries of x they multiply.
+*/
+typedef struct {
+  Mat         A,B;                  /* diagonal and off-diagonal parts */
+  PetscInt    rstartbs,rendbs;      /* block rows owned by this process */
+  PetscInt    nghost;               /* number of block columns of B */
+  PetscInt    *garray;              /* global block of each block column of B */
+  PetscInt    *gcols;               /* global column of each column of B, increasing */
+  Vec         lvec;                 /* the entries of x multiplied by B */
+  VecScatter  Mvctx;                /* scatters x into lvec */
+  PetscBool   roworiented;
+  PetscBool   donotstash;
+  PetscBool   getrowactive;         /* work space for MatGetRow() */
+  PetscInt    *rowindices;
+  PetscScalar *rowvalues;
+} Mat_MPIVBAIJ;
+
+#endif
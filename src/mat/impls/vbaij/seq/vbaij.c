@@ -0,0 +1,804 @@
+
+/*
+    Defines the basic matrix operations for the VBAIJ (variable block compressed row)
+  matrix storage format.
+*/
+#include <../src/mat/impls/vbaij/seq/vbaij.h>  /*ib "petscmat.h" ib*/
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <petsc/private/kernels/blockinvert.h>
+
+static PetscErrorCode MatSeqVBAIJFreeStructure_Private(Mat A)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (a->cbsizes != a->bsizes) {ierr = PetscFree3(a->cbsizes,a->cboff,a->colblock);CHKERRQ(ierr);}
+  a->cbsizes  = NULL;
+  a->cboff    = NULL;
+  a->colblock = NULL;
+  ierr = PetscFree5(a->bsizes,a->boff,a->rowblock,a->diag,a->idiagoff);CHKERRQ(ierr);
+  ierr = PetscFree3(a->i,a->j,a->voff);CHKERRQ(ierr);
+  ierr = PetscFree(a->a);CHKERRQ(ierr);
+  ierr = PetscFree(a->idiag);CHKERRQ(ierr);
+  ierr = PetscFree2(a->rowcols,a->rowvals);CHKERRQ(ierr);
+  ierr = PetscFree2(a->work,a->pivots);CHKERRQ(ierr);
+  a->idiagvalid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*
+    Sets the nonzero blocks of a square matrix, or with cbsizes the nonzero blocks of a rectangular matrix whose
+  nbs block columns have the sizes cbsizes; MATMPIVBAIJ uses the latter for its off-diagonal part
+*/
+PetscErrorCode MatSeqVBAIJSetPreallocationCSR_Private(Mat B,PetscInt nblocks,const PetscInt bsizes[],PetscInt nbs,const PetscInt cbsizes[],const PetscInt ii[],const PetscInt jj[],const PetscScalar v[])
+{
+  Mat_SeqVBAIJ   *b = (Mat_SeqVBAIJ*)B->data;
+  PetscInt       ib,jb,k,r,c,rb,cb,len,nz,m,n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLayoutSetUp(B->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(B->cmap);CHKERRQ(ierr);
+  m    = B->rmap->n;
+  n    = B->cmap->n;
+  if (ii[0]) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"ii[0] must be 0 it is %D",ii[0]);
+  ierr = MatSeqVBAIJFreeStructure_Private(B);CHKERRQ(ierr);
+
+  b->mbs   = nblocks;
+  b->nbs   = nbs;
+  b->maxbs = 1;
+  nz       = ii[nblocks];
+  ierr = PetscMalloc5(nblocks,&b->bsizes,nblocks+1,&b->boff,m,&b->rowblock,nblocks,&b->diag,nblocks+1,&b->idiagoff);CHKERRQ(ierr);
+  ierr = PetscMalloc3(nblocks+1,&b->i,nz,&b->j,nz+1,&b->voff);CHKERRQ(ierr);
+  b->boff[0]     = 0;
+  b->idiagoff[0] = 0;
+  for (ib=0; ib<nblocks; ib++) {
+    if (bsizes[ib] <= 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Block %D has size %D",ib,bsizes[ib]);
+    b->bsizes[ib]     = bsizes[ib];
+    b->maxbs          = PetscMax(b->maxbs,bsizes[ib]);
+    b->boff[ib+1]     = b->boff[ib] + bsizes[ib];
+    b->idiagoff[ib+1] = b->idiagoff[ib] + bsizes[ib]*bsizes[ib];
+    if (b->boff[ib+1] > m) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Block sizes add up to more than the %D rows of the matrix",m);
+    for (r=b->boff[ib]; r<b->boff[ib+1]; r++) b->rowblock[r] = ib;
+  }
+  if (b->boff[nblocks] != m) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Block sizes add up to %D, not to the %D rows of the matrix",b->boff[nblocks],m);
+  if (!cbsizes) {
+    b->cbsizes  = b->bsizes;
+    b->cboff    = b->boff;
+    b->colblock = b->rowblock;
+  } else {
+    ierr = PetscMalloc3(nbs,&b->cbsizes,nbs+1,&b->cboff,n,&b->colblock);CHKERRQ(ierr);
+    b->cboff[0] = 0;
+    for (jb=0; jb<nbs; jb++) {
+      if (cbsizes[jb] <= 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Block column %D has size %D",jb,cbsizes[jb]);
+      b->cbsizes[jb]  = cbsizes[jb];
+      b->cboff[jb+1] = b->cboff[jb] + cbsizes[jb];
+      if (b->cboff[jb+1] > n) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Block column sizes add up to more than the %D columns of the matrix",n);
+      for (c=b->cboff[jb]; c<b->cboff[jb+1]; c++) b->colblock[c] = jb;
+    }
+  }
+  if (b->cboff[nbs] != n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Block column sizes add up to %D, not to the %D columns of the matrix",b->cboff[nbs],n);
+
+  /* block structure, offsets of the blocks, and the longest point row */
+  b->nz        = nz;
+  b->maxrowlen = 0;
+  b->voff[0]   = 0;
+  ierr = PetscArraycpy(b->i,ii,nblocks+1);CHKERRQ(ierr);
+  ierr = PetscArraycpy(b->j,jj,nz);CHKERRQ(ierr);
+  for (ib=0; ib<nblocks; ib++) {
+    if (ii[ib+1] < ii[ib]) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Block row %D has a negative number of blocks %D",ib,ii[ib+1]-ii[ib]);
+    b->diag[ib] = -1;
+    len         = 0;
+    for (k=ii[ib]; k<ii[ib+1]; k++) {
+      jb = jj[k];
+      if (jb < 0 || jb >= nbs) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Block column %D in block row %D is not in [0,%D)",jb,ib,nbs);
+      if (k > ii[ib] && jb <= jj[k-1]) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Block column indices of block row %D must be sorted and unique",ib);
+      if (jb == ib && !cbsizes) b->diag[ib] = k;
+      b->voff[k+1] = b->voff[k] + bsizes[ib]*b->cbsizes[jb];
+      len         += b->cbsizes[jb];
+    }
+    b->maxrowlen = PetscMax(b->maxrowlen,len);
+  }
+  b->nzp = b->voff[nz];
+
+  ierr = PetscCalloc1(b->nzp,&b->a);CHKERRQ(ierr);
+  ierr = PetscMalloc1(b->idiagoff[nblocks],&b->idiag);CHKERRQ(ierr);
+  ierr = PetscMalloc2(b->maxrowlen,&b->rowcols,b->maxrowlen,&b->rowvals);CHKERRQ(ierr);
+  ierr = PetscMalloc2(2*b->maxbs,&b->work,b->maxbs,&b->pivots);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)B,(b->nzp+b->idiagoff[nblocks])*sizeof(MatScalar)+(3*nz+4*nblocks+m)*sizeof(PetscInt));CHKERRQ(ierr);
+
+  if (v) {
+    for (ib=0; ib<nblocks; ib++) {
+      rb = bsizes[ib];
+      for (k=ii[ib]; k<ii[ib+1]; k++) {
+        cb = b->cbsizes[jj[k]];
+        for (c=0; c<cb; c++) {
+          for (r=0; r<rb; r++) b->a[b->voff[k]+c*rb+r] = b->roworiented ? v[b->voff[k]+r*cb+c] : v[b->voff[k]+c*rb+r];
+        }
+      }
+    }
+  }
+  B->preallocated = PETSC_TRUE;
+  if (B->factortype) PetscFunctionReturn(0);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqVBAIJSetPreallocationCSR_SeqVBAIJ(Mat B,PetscInt nblocks,const PetscInt bsizes[],const PetscInt ii[],const PetscInt jj[],const PetscScalar v[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLayoutSetUp(B->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(B->cmap);CHKERRQ(ierr);
+  if (B->rmap->n != B->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_SUP,"MATSEQVBAIJ requires a square matrix, not %D by %D",B->rmap->n,B->cmap->n);
+  ierr = MatSetVariableBlockSizes(B,nblocks,(PetscInt*)bsizes);CHKERRQ(ierr);
+  ierr = MatSeqVBAIJSetPreallocationCSR_Private(B,nblocks,bsizes,nblocks,NULL,ii,jj,v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValues_SeqVBAIJ(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode is)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscInt       k,l,row,col,ib,jb,pos,p;
+  PetscScalar    value;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<m; k++) {
+    row = im[k];
+    if (row < 0) continue;
+    if (PetscUnlikelyDebug(row >= A->rmap->n)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",row,A->rmap->n-1);
+    ib = a->rowblock[row];
+    for (l=0; l<n; l++) {
+      col = in[l];
+      if (col < 0) continue;
+      if (PetscUnlikelyDebug(col >= A->cmap->n)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",col,A->cmap->n-1);
+      jb    = a->colblock[col];
+      ierr = PetscFindInt(jb,a->i[ib+1]-a->i[ib],a->j+a->i[ib],&pos);CHKERRQ(ierr);
+      if (pos < 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Inserting a new nonzero at (%D,%D) in a block that is not in the nonzero structure of the matrix",row,col);
+      p     = a->voff[a->i[ib]+pos] + (col-a->cboff[jb])*a->bsizes[ib] + row-a->boff[ib];
+      value = a->roworiented ? v[k*n+l] : v[k+l*m];
+      if (is == ADD_VALUES) a->a[p] += value;
+      else a->a[p] = value;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetValues_SeqVBAIJ(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],PetscScalar v[])
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscInt       k,l,row,col,ib,jb,pos;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<m; k++) {
+    row = im[k];
+    if (row < 0) {v += n; continue;}
+    if (row >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row %D too large, max %D",row,A->rmap->n-1);
+    ib = a->rowblock[row];
+    for (l=0; l<n; l++) {
+      col = in[l];
+      if (col < 0) {v++; continue;}
+      if (col >= A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column %D too large, max %D",col,A->cmap->n-1);
+      jb    = a->colblock[col];
+      ierr = PetscFindInt(jb,a->i[ib+1]-a->i[ib],a->j+a->i[ib],&pos);CHKERRQ(ierr);
+      *v++ = pos < 0 ? 0.0 : a->a[a->voff[a->i[ib]+pos] + (col-a->cboff[jb])*a->bsizes[ib] + row-a->boff[ib]];
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetRow_SeqVBAIJ(Mat A,PetscInt row,PetscInt *nz,PetscInt **idx,PetscScalar **v)
+{
+  Mat_SeqVBAIJ *a = (Mat_SeqVBAIJ*)A->data;
+  PetscInt     ib,jb,k,c,r,rb,len = 0;
+
+  PetscFunctionBegin;
+  if (row < 0 || row >= A->rmap->n) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row %D out of range",row);
+  ib  = a->rowblock[row];
+  r  = row - a->boff[ib];
+  rb = a->bsizes[ib];
+  for (k=a->i[ib]; k<a->i[ib+1]; k++) {
+    jb = a->j[k];
+    for (c=0; c<a->cbsizes[jb]; c++) {
+      a->rowcols[len] = a->cboff[jb] + c;
+      a->rowvals[len] = a->a[a->voff[k]+c*rb+r];
+      len++;
+    }
+  }
+  if (nz)  *nz  = len;
+  if (idx) *idx = len ? a->rowcols : NULL;
+  if (v)   *v   = len ? a->rowvals : NULL;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatRestoreRow_SeqVBAIJ(Mat A,PetscInt row,PetscInt *nz,PetscInt **idx,PetscScalar **v)
+{
+  PetscFunctionBegin;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultAdd_SeqVBAIJ_Private(Mat A,Vec xx,Vec zz,PetscBool add)
+{
+  Mat_SeqVBAIJ      *a = (Mat_SeqVBAIJ*)A->data;
+  const PetscScalar *x;
+  PetscScalar       *z,*zb;
+  PetscInt          ib,k,r,rb;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  for (ib=0; ib<a->mbs; ib++) {
+    rb = a->bsizes[ib];
+    zb = z + a->boff[ib];
+    if (!add) for (r=0; r<rb; r++) zb[r] = 0.0;
+    for (k=a->i[ib]; k<a->i[ib+1]; k++) {
+      MatSeqVBAIJKernel_w_gets_w_plus_A_times_v(rb,a->cbsizes[a->j[k]],a->a+a->voff[k],x+a->cboff[a->j[k]],zb);
+    }
+  }
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  ierr = PetscLogFlops(add ? 2.0*a->nzp : 2.0*a->nzp - A->rmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMult_SeqVBAIJ(Mat A,Vec xx,Vec zz)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultAdd_SeqVBAIJ_Private(A,xx,zz,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultAdd_SeqVBAIJ(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (yy != zz) {ierr = VecCopy(yy,zz);CHKERRQ(ierr);}
+  ierr = MatMultAdd_SeqVBAIJ_Private(A,xx,zz,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultTransposeAdd_SeqVBAIJ(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqVBAIJ      *a = (Mat_SeqVBAIJ*)A->data;
+  const PetscScalar *x;
+  PetscScalar       *z;
+  PetscInt          ib,k;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (!yy) {
+    ierr = VecSet(zz,0.0);CHKERRQ(ierr);
+  } else if (yy != zz) {
+    ierr = VecCopy(yy,zz);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  for (ib=0; ib<a->mbs; ib++) {
+    for (k=a->i[ib]; k<a->i[ib+1]; k++) {
+      MatSeqVBAIJKernel_w_gets_w_plus_transA_times_v(a->bsizes[ib],a->cbsizes[a->j[k]],a->a+a->voff[k],x+a->boff[ib],z+a->cboff[a->j[k]]);
+    }
+  }
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nzp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultTranspose_SeqVBAIJ(Mat A,Vec xx,Vec zz)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMultTransposeAdd_SeqVBAIJ(A,xx,NULL,zz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    Computes the inverses of the diagonal blocks start to end-1, stored by columns in a->idiag, with the kernels used by MATSEQBAIJ
+*/
+PetscErrorCode MatSeqVBAIJInvertDiagonal_Private(Mat A,PetscInt start,PetscInt end)
+{
+  Mat_SeqVBAIJ    *a = (Mat_SeqVBAIJ*)A->data;
+  PetscInt        ib,rb,ipvt[5];
+  MatScalar       *d,work[25];
+  PetscBool       allowzeropivot,zeropivotdetected = PETSC_FALSE;
+  const PetscReal shift = 0.0;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  allowzeropivot = PetscNot(A->erroriffailure);
+  for (ib=start; ib<end; ib++) {
+    if (a->diag[ib] < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Matrix is missing diagonal block %D",ib);
+    rb   = a->bsizes[ib];
+    d    = a->idiag + a->idiagoff[ib];
+    ierr = PetscArraycpy(d,a->a+a->voff[a->diag[ib]],rb*rb);CHKERRQ(ierr);
+    switch (rb) {
+    case 1:
+      if (*d == (MatScalar)0.0) {
+        if (!allowzeropivot) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_MAT_LU_ZRPVT,"Zero pivot, row %D",a->boff[ib]);
+        zeropivotdetected = PETSC_TRUE;
+      } else *d = 1.0/(*d);
+      break;
+    case 2:
+      ierr = PetscKernel_A_gets_inverse_A_2(d,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 3:
+      ierr = PetscKernel_A_gets_inverse_A_3(d,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 4:
+      ierr = PetscKernel_A_gets_inverse_A_4(d,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 5:
+      ierr = PetscKernel_A_gets_inverse_A_5(d,ipvt,work,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 6:
+      ierr = PetscKernel_A_gets_inverse_A_6(d,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 7:
+      ierr = PetscKernel_A_gets_inverse_A_7(d,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    default:
+      ierr = PetscKernel_A_gets_inverse_A(rb,d,a->pivots,a->work,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+    }
+    if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatInvertVariableBlockDiagonal_SeqVBAIJ(Mat A,PetscInt nblocks,const PetscInt *bsizes,PetscScalar *diag)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscInt       ib,k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (nblocks != a->mbs) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Number of blocks %D does not match the %D block rows of the matrix",nblocks,a->mbs);
+  for (ib=0; ib<nblocks; ib++) {
+    if (bsizes[ib] != a->bsizes[ib]) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Size %D of block %D does not match the block size %D of the matrix",bsizes[ib],ib,a->bsizes[ib]);
+  }
+  if (!a->idiagvalid) {
+    ierr = MatSeqVBAIJInvertDiagonal_Private(A,0,a->mbs);CHKERRQ(ierr);
+    a->idiagvalid = PETSC_TRUE;
+  }
+  for (k=0; k<a->idiagoff[a->mbs]; k++) diag[k] = a->idiag[k];
+  PetscFunctionReturn(0);
+}
+
+/*
+    Block Gauss-Seidel with the inverted diagonal blocks, as MatSOR_SeqBAIJ() does for a single block size
+*/
+static PetscErrorCode MatSOR_SeqVBAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqVBAIJ      *a = (Mat_SeqVBAIJ*)A->data;
+  const PetscScalar *b;
+  PetscScalar       *x,*t = a->work;
+  PetscInt          ib,k,r,rb,kstart,kend,sweeps = 0;
+  PetscBool         zeroguess = (flag & SOR_ZERO_INITIAL_GUESS) ? PETSC_TRUE : PETSC_FALSE;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (flag & SOR_EISENSTAT) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No support yet for Eisenstat");
+  its = its*lits;
+  if (its <= 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Relaxation requires global its %D and local its %D both positive",its,lits);
+  if (fshift) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Sorry, no support for diagonal shift");
+  if (omega != 1.0) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Sorry, no support for non-trivial relaxation factor");
+  if ((flag & SOR_APPLY_UPPER) || (flag & SOR_APPLY_LOWER)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Sorry, no support for applying upper or lower triangular parts");
+
+  if (!a->idiagvalid) {
+    ierr = MatSeqVBAIJInvertDiagonal_Private(A,0,a->mbs);CHKERRQ(ierr);
+    a->idiagvalid = PETSC_TRUE;
+  }
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  while (its--) {
+    /* with a zero initial guess the first sweep skips the blocks that multiply the zero part of x */
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (ib=0; ib<a->mbs; ib++) {
+        rb     = a->bsizes[ib];
+        kstart = a->i[ib];
+        kend   = (zeroguess && !sweeps) ? a->diag[ib] : a->i[ib+1];
+        for (r=0; r<rb; r++) t[r] = b[a->boff[ib]+r];
+        for (k=kstart; k<kend; k++) {
+          if (k == a->diag[ib]) continue;
+          MatSeqVBAIJKernel_w_gets_w_minus_A_times_v(rb,a->bsizes[a->j[k]],a->a+a->voff[k],x+a->boff[a->j[k]],t);
+        }
+        MatSeqVBAIJKernel_w_gets_A_times_v(rb,a->idiag+a->idiagoff[ib],t,x+a->boff[ib]);
+      }
+      sweeps++;
+    }
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (ib=a->mbs-1; ib>=0; ib--) {
+        rb     = a->bsizes[ib];
+        kstart = (zeroguess && !sweeps) ? a->diag[ib]+1 : a->i[ib];
+        kend   = a->i[ib+1];
+        for (r=0; r<rb; r++) t[r] = b[a->boff[ib]+r];
+        for (k=kstart; k<kend; k++) {
+          if (k == a->diag[ib]) continue;
+          MatSeqVBAIJKernel_w_gets_w_minus_A_times_v(rb,a->bsizes[a->j[k]],a->a+a->voff[k],x+a->boff[a->j[k]],t);
+        }
+        MatSeqVBAIJKernel_w_gets_A_times_v(rb,a->idiag+a->idiagoff[ib],t,x+a->boff[ib]);
+      }
+      sweeps++;
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = PetscLogFlops(sweeps*(2.0*a->nzp));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetDiagonal_SeqVBAIJ(Mat A,Vec v)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscScalar    *x;
+  PetscInt       ib,r,rb,n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (A->factortype) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Not for factored matrix");
+  ierr = VecGetLocalSize(v,&n);CHKERRQ(ierr);
+  if (n != A->rmap->n) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Nonconforming matrix and vector");
+  ierr = VecGetArray(v,&x);CHKERRQ(ierr);
+  for (ib=0; ib<a->mbs; ib++) {
+    rb = a->bsizes[ib];
+    for (r=0; r<rb; r++) x[a->boff[ib]+r] = a->diag[ib] < 0 ? 0.0 : a->a[a->voff[a->diag[ib]]+r*rb+r];
+  }
+  ierr = VecRestoreArray(v,&x);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMissingDiagonal_SeqVBAIJ(Mat A,PetscBool *missing,PetscInt *d)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscInt       ib;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *missing = PETSC_FALSE;
+  for (ib=0; ib<a->mbs; ib++) {
+    if (a->diag[ib] < 0) {
+      *missing = PETSC_TRUE;
+      if (d) *d = a->boff[ib];
+      ierr = PetscInfo1(A,"Matrix is missing diagonal block %D\n",ib);CHKERRQ(ierr);
+      break;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatScale_SeqVBAIJ(Mat A,PetscScalar alpha)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscInt       k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (k=0; k<a->nzp; k++) a->a[k] *= alpha;
+  a->idiagvalid = PETSC_FALSE;
+  ierr = PetscLogFlops(a->nzp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatZeroEntries_SeqVBAIJ(Mat A)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscArrayzero(a->a,a->nzp);CHKERRQ(ierr);
+  a->idiagvalid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_SeqVBAIJ(Mat A,MatAssemblyType mode)
+{
+  Mat_SeqVBAIJ *a = (Mat_SeqVBAIJ*)A->data;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  a->idiagvalid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetOption_SeqVBAIJ(Mat A,MatOption op,PetscBool flg)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  switch (op) {
+  case MAT_ROW_ORIENTED:
+    a->roworiented = flg;
+    break;
+  case MAT_NEW_NONZERO_LOCATIONS:
+  case MAT_NEW_NONZERO_LOCATION_ERR:
+  case MAT_NEW_NONZERO_ALLOCATION_ERR:
+  case MAT_KEEP_NONZERO_PATTERN:
+  case MAT_IGNORE_OFF_PROC_ENTRIES:
+  case MAT_NO_OFF_PROC_ENTRIES:
+  case MAT_SORTED_FULL:
+  case MAT_SYMMETRIC:
+  case MAT_STRUCTURALLY_SYMMETRIC:
+  case MAT_HERMITIAN:
+  case MAT_SYMMETRY_ETERNAL:
+  case MAT_SPD:
+    /* the nonzero blocks are fixed by MatSeqVBAIJSetPreallocationCSR() and symmetry is recorded in the Mat header */
+    break;
+  default:
+    ierr = PetscInfo1(A,"Option %s ignored\n",MatOptions[op]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetInfo_SeqVBAIJ(Mat A,MatInfoType flag,MatInfo *info)
+{
+  Mat_SeqVBAIJ *a = (Mat_SeqVBAIJ*)A->data;
+
+  PetscFunctionBegin;
+  info->block_size   = 1.0;
+  info->nz_allocated = a->nzp;
+  info->nz_used      = a->nzp;
+  info->nz_unneeded  = 0.0;
+  info->assemblies   = A->num_ass;
+  info->mallocs      = 0.0;
+  info->memory       = ((PetscObject)A)->mem;
+  if (A->factortype) {
+    info->fill_ratio_given  = 1.0;
+    info->fill_ratio_needed = 1.0;
+    info->factor_mallocs    = 0.0;
+  } else {
+    info->fill_ratio_given  = 0;
+    info->fill_ratio_needed = 0;
+    info->factor_mallocs    = 0;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDuplicate_SeqVBAIJ(Mat A,MatDuplicateOption op,Mat *B)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data,*b;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(PetscObjectComm((PetscObject)A),B);CHKERRQ(ierr);
+  ierr = MatSetSizes(*B,A->rmap->n,A->cmap->n,A->rmap->n,A->cmap->n);CHKERRQ(ierr);
+  ierr = MatSetType(*B,((PetscObject)A)->type_name);CHKERRQ(ierr);
+  if (a->cbsizes == a->bsizes) {
+    ierr = MatSeqVBAIJSetPreallocationCSR(*B,a->mbs,a->bsizes,a->i,a->j,NULL);CHKERRQ(ierr);
+  } else {
+    ierr = MatSeqVBAIJSetPreallocationCSR_Private(*B,a->mbs,a->bsizes,a->nbs,a->cbsizes,a->i,a->j,NULL);CHKERRQ(ierr);
+  }
+  b    = (Mat_SeqVBAIJ*)(*B)->data;
+  b->roworiented = a->roworiented;
+  if (op == MAT_COPY_VALUES) {
+    ierr = PetscArraycpy(b->a,a->a,a->nzp);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatView_SeqVBAIJ(Mat A,PetscViewer viewer)
+{
+  Mat_SeqVBAIJ      *a = (Mat_SeqVBAIJ*)A->data;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+  PetscInt          ib,minbs;
+  Mat               B;
+  const char        *name;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO || format == PETSC_VIEWER_ASCII_INFO_DETAIL) {
+      minbs = a->maxbs;
+      for (ib=0; ib<a->mbs; ib++) minbs = PetscMin(minbs,a->bsizes[ib]);
+      ierr = PetscViewerASCIIPrintf(viewer,"%D block rows with block sizes from %D to %D, %D nonzero blocks\n",a->mbs,a->mbs ? minbs : 0,a->mbs ? a->maxbs : 0,a->nz);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    if (format == PETSC_VIEWER_ASCII_FACTOR_INFO) PetscFunctionReturn(0);
+  }
+  /* the entries are shown as those of the equivalent MATSEQAIJ matrix */
+  ierr = MatConvert(A,MATSEQAIJ,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = PetscObjectGetName((PetscObject)A,&name);CHKERRQ(ierr);
+  ierr = PetscObjectSetName((PetscObject)B,name);CHKERRQ(ierr);
+  ierr = (*B->ops->view)(B,viewer);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_SeqVBAIJ(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_LOG)
+  PetscLogObjectState((PetscObject)A,"Rows=%D, NZ=%D",A->rmap->n,((Mat_SeqVBAIJ*)A->data)->nzp);
+#endif
+  ierr = MatSeqVBAIJFreeStructure_Private(A);CHKERRQ(ierr);
+  ierr = PetscFree(A->data);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)A,NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqVBAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatConvert_seqaij_seqvbaij_C",NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    The nonzero blocks are the blocks of A that contain at least one entry of its nonzero structure
+*/
+PetscErrorCode MatConvert_SeqAIJ_SeqVBAIJ(Mat A,MatType newtype,MatReuse reuse,Mat *newmat)
+{
+  Mat_SeqAIJ     *aij = (Mat_SeqAIJ*)A->data;
+  Mat_SeqVBAIJ   *b;
+  Mat            B;
+  PetscInt       m = A->rmap->n,mbs = A->nblocks,ib,jb,k,l,r,row,col,cnt,*boff,*rowblock,*map,*ii,*jj;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!A->bsizes) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Call MatSetVariableBlockSizes() on the matrix before converting it to MATSEQVBAIJ");
+  if (m != A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_SUP,"MATSEQVBAIJ requires a square matrix, not %D by %D",m,A->cmap->n);
+  ierr = PetscMalloc3(mbs+1,&boff,m,&rowblock,mbs,&map);CHKERRQ(ierr);
+  boff[0] = 0;
+  for (ib=0; ib<mbs; ib++) {
+    boff[ib+1] = boff[ib] + A->bsizes[ib];
+    for (r=boff[ib]; r<boff[ib+1]; r++) rowblock[r] = ib;
+    map[ib] = -1;
+  }
+  if (reuse == MAT_REUSE_MATRIX) {
+    B = *newmat;
+  } else {
+    ierr  = PetscMalloc2(mbs+1,&ii,aij->nz,&jj);CHKERRQ(ierr);
+    ii[0] = 0;
+    for (ib=0; ib<mbs; ib++) {
+      cnt = ii[ib];
+      for (row=boff[ib]; row<boff[ib+1]; row++) {
+        for (l=aij->i[row]; l<aij->i[row+1]; l++) {
+          jb = rowblock[aij->j[l]];
+          if (map[jb] != ib) {map[jb] = ib; jj[cnt++] = jb;}
+        }
+      }
+      ierr    = PetscSortInt(cnt-ii[ib],jj+ii[ib]);CHKERRQ(ierr);
+      ii[ib+1] = cnt;
+    }
+    ierr = MatCreate(PETSC_COMM_SELF,&B);CHKERRQ(ierr);
+    ierr = MatSetSizes(B,m,m,m,m);CHKERRQ(ierr);
+    ierr = MatSetType(B,MATSEQVBAIJ);CHKERRQ(ierr);
+    ierr = MatSeqVBAIJSetPreallocationCSR(B,mbs,A->bsizes,ii,jj,NULL);CHKERRQ(ierr);
+    ierr = PetscFree2(ii,jj);CHKERRQ(ierr);
+    for (ib=0; ib<mbs; ib++) map[ib] = -1;
+  }
+
+  b = (Mat_SeqVBAIJ*)B->data;
+  if (b->mbs != mbs) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Matrix to reuse has %D block rows, not %D",b->mbs,mbs);
+  ierr = PetscArrayzero(b->a,b->nzp);CHKERRQ(ierr);
+  for (ib=0; ib<mbs; ib++) {
+    for (k=b->i[ib]; k<b->i[ib+1]; k++) map[b->j[k]] = k;
+    for (row=boff[ib]; row<boff[ib+1]; row++) {
+      for (l=aij->i[row]; l<aij->i[row+1]; l++) {
+        col = aij->j[l];
+        jb   = rowblock[col];
+        if (map[jb] < 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Entry (%D,%D) is not in the nonzero blocks of the matrix to reuse",row,col);
+        b->a[b->voff[map[jb]] + (col-boff[jb])*b->bsizes[ib] + row-boff[ib]] = aij->a[l];
+      }
+    }
+    for (k=b->i[ib]; k<b->i[ib+1]; k++) map[b->j[k]] = -1;
+  }
+  ierr = PetscFree3(boff,rowblock,map);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  if (reuse == MAT_INPLACE_MATRIX) {
+    ierr = MatHeaderReplace(A,&B);CHKERRQ(ierr);
+  } else *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATSEQVBAIJ - MATSEQVBAIJ = "seqvbaij" - A matrix type for sequential sparse matrices made of dense blocks
+   whose sizes vary from block row to block row, for example for problems with a different number of
+   degrees of freedom at each node.
+
+   The rows and the columns are split into blocks of the same sizes, set with MatSeqVBAIJSetPreallocationCSR()
+   or taken from MatSetVariableBlockSizes() when a MATSEQAIJ matrix is converted with MatConvert().
+
+   Options Database Keys:
+. -mat_type seqvbaij - sets the matrix type to "seqvbaij" during a call to MatSetFromOptions()
+
+   Level: intermediate
+
+   Notes:
+    MatSetValues() can only change entries of the nonzero blocks given to MatSeqVBAIJSetPreallocationCSR().
+
+    MatSOR() does block Gauss-Seidel with the inverses of the diagonal blocks, MatInvertVariableBlockDiagonal()
+    provides these inverses to PCVPBJACOBI and MatGetFactor() with MATSOLVERPETSC provides block ILU(0) with
+    the natural ordering.
+
+.seealso: MatSeqVBAIJSetPreallocationCSR(), MatSetVariableBlockSizes(), PCVPBJACOBI, MATSEQBAIJ
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqVBAIJ(Mat B)
+{
+  Mat_SeqVBAIJ   *b;
+  PetscMPIInt    size;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)B),&size);CHKERRQ(ierr);
+  if (size > 1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Comm must be of size 1");
+
+  ierr    = PetscNewLog(B,&b);CHKERRQ(ierr);
+  B->data = (void*)b;
+  b->roworiented = PETSC_TRUE;
+
+  B->ops->setvalues                   = MatSetValues_SeqVBAIJ;
+  B->ops->getvalues                   = MatGetValues_SeqVBAIJ;
+  B->ops->getrow                      = MatGetRow_SeqVBAIJ;
+  B->ops->restorerow                  = MatRestoreRow_SeqVBAIJ;
+  B->ops->mult                        = MatMult_SeqVBAIJ;
+  B->ops->multadd                     = MatMultAdd_SeqVBAIJ;
+  B->ops->multtranspose               = MatMultTranspose_SeqVBAIJ;
+  B->ops->multtransposeadd            = MatMultTransposeAdd_SeqVBAIJ;
+  B->ops->sor                         = MatSOR_SeqVBAIJ;
+  B->ops->invertvariableblockdiagonal = MatInvertVariableBlockDiagonal_SeqVBAIJ;
+  B->ops->getdiagonal                 = MatGetDiagonal_SeqVBAIJ;
+  B->ops->missingdiagonal             = MatMissingDiagonal_SeqVBAIJ;
+  B->ops->scale                       = MatScale_SeqVBAIJ;
+  B->ops->zeroentries                 = MatZeroEntries_SeqVBAIJ;
+  B->ops->assemblyend                 = MatAssemblyEnd_SeqVBAIJ;
+  B->ops->setoption                   = MatSetOption_SeqVBAIJ;
+  B->ops->getinfo                     = MatGetInfo_SeqVBAIJ;
+  B->ops->duplicate                   = MatDuplicate_SeqVBAIJ;
+  B->ops->view                        = MatView_SeqVBAIJ;
+  B->ops->destroy                     = MatDestroy_SeqVBAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqVBAIJSetPreallocationCSR_C",MatSeqVBAIJSetPreallocationCSR_SeqVBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqvbaij_C",MatConvert_SeqAIJ_SeqVBAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQVBAIJ);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatSeqVBAIJSetPreallocationCSR - Sets the variable block sizes, the nonzero blocks and (optionally) the values of a MATSEQVBAIJ matrix
+
+   Collective
+
+   Input Parameters:
++  B - the matrix
+.  nblocks - the number of block rows, which is also the number of block columns
+.  bsizes - the size of each block row and block column
+.  i - the indices into j for the start of each block row (starts with zero)
+.  j - the block column indices for each block row (starts with zero), these must be sorted for each block row
+-  v - optional values of the blocks, one after the other in the order of j
+
+   Level: intermediate
+
+   Notes:
+   Block (I,J) has bsizes[I] rows and bsizes[J] columns. The order of the entries within a block of v is specified by
+   the MatOption MAT_ROW_ORIENTED, as for MatSeqBAIJSetPreallocationCSR().
+
+   The block sizes are also set with MatSetVariableBlockSizes() so that PCVPBJACOBI uses them.
+
+   Though this routine has Preallocation() in the name it also sets the exact nonzero blocks of the matrix; MatSetValues()
+   cannot add new blocks later.
+
+.seealso: MatCreate(), MATSEQVBAIJ, MatSetValues(), MatSetVariableBlockSizes(), MatSeqBAIJSetPreallocationCSR()
+@*/
+PetscErrorCode MatSeqVBAIJSetPreallocationCSR(Mat B,PetscInt nblocks,const PetscInt bsizes[],const PetscInt i[],const PetscInt j[],const PetscScalar v[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(B,MAT_CLASSID,1);
+  PetscValidType(B,1);
+  ierr = PetscTryMethod(B,"MatSeqVBAIJSetPreallocationCSR_C",(Mat,PetscInt,const PetscInt[],const PetscInt[],const PetscInt[],const PetscScalar[]),(B,nblocks,bsizes,i,j,v));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
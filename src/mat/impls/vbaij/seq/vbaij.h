@@ -0,0 +1,91 @@
+
+#if !defined(__VBAIJ_H)
+#define __VBAIJ_H
+#include <petsc/private/matimpl.h>
+
+/*
+   MATSEQVBAIJ stores dense blocks whose sizes vary from block row to block row. The columns are split
+   into blocks of the same sizes as the rows, so block (I,J) is bsizes[I] by bsizes[J]. Each block is
+   stored by columns, as in MATSEQBAIJ.
+
+   The off-diagonal part of MATMPIVBAIJ is the only rectangular MATSEQVBAIJ: its block columns are the
+   blocks of the other processes it couples to, so they have their own sizes.
+*/
+typedef struct {
+  PetscInt    mbs;                  /* number of block rows */
+  PetscInt    nbs;                  /* number of block columns, mbs unless the matrix is rectangular */
+  PetscInt    maxbs;                /* largest block size */
+  PetscInt    *bsizes;              /* size of each block row */
+  PetscInt    *boff;                /* first point row of each block row, length mbs+1 */
+  PetscInt    *rowblock;            /* block row containing each point row */
+  PetscInt    *cbsizes,*cboff;      /* the same as bsizes, boff and rowblock for the block columns; */
+  PetscInt    *colblock;            /* they are separate arrays only for a rectangular matrix */
+  PetscInt    nz;                   /* number of nonzero blocks */
+  PetscInt    nzp;                  /* number of entries in the nonzero blocks */
+  PetscInt    *i,*j;                /* block row starts and sorted block column indices */
+  PetscInt    *voff;                /* offset of each block into a, length nz+1 */
+  PetscInt    *diag;                /* location of the diagonal block of each block row, -1 if it is missing */
+  MatScalar   *a;                   /* values of the blocks */
+  PetscInt    maxrowlen;            /* largest number of entries in a point row */
+  PetscInt    *rowcols;             /* work space for MatGetRow() */
+  PetscScalar *rowvals;
+  PetscBool   roworiented;
+  PetscInt    *idiagoff;            /* offset of each inverted diagonal block, length mbs+1 */
+  MatScalar   *idiag;               /* inverses of the diagonal blocks for MatSOR() and MatSolve() */
+  PetscBool   idiagvalid;
+  PetscScalar *work;                /* work space of length 2*maxbs */
+  PetscInt    *pivots;
+} Mat_SeqVBAIJ;
+
+/*
+   Kernels for a single rb by cb block A stored by columns; the block sizes are small and vary, so plain
+   loops the compiler can unroll are used instead of the BLAS calls of the general block size MATSEQBAIJ kernels
+*/
+PETSC_STATIC_INLINE void MatSeqVBAIJKernel_w_gets_w_plus_A_times_v(PetscInt rb,PetscInt cb,const MatScalar *A,const PetscScalar *v,PetscScalar *w)
+{
+  PetscInt r,c;
+
+  for (c=0; c<cb; c++) {
+    const PetscScalar vc = v[c];
+    for (r=0; r<rb; r++) w[r] += A[r]*vc;
+    A += rb;
+  }
+}
+
+PETSC_STATIC_INLINE void MatSeqVBAIJKernel_w_gets_w_minus_A_times_v(PetscInt rb,PetscInt cb,const MatScalar *A,const PetscScalar *v,PetscScalar *w)
+{
+  PetscInt r,c;
+
+  for (c=0; c<cb; c++) {
+    const PetscScalar vc = v[c];
+    for (r=0; r<rb; r++) w[r] -= A[r]*vc;
+    A += rb;
+  }
+}
+
+PETSC_STATIC_INLINE void MatSeqVBAIJKernel_w_gets_w_plus_transA_times_v(PetscInt rb,PetscInt cb,const MatScalar *A,const PetscScalar *v,PetscScalar *w)
+{
+  PetscInt    r,c;
+  PetscScalar sum;
+
+  for (c=0; c<cb; c++) {
+    sum = 0.0;
+    for (r=0; r<rb; r++) sum += A[r]*v[r];
+    w[c] += sum;
+    A    += rb;
+  }
+}
+
+PETSC_STATIC_INLINE void MatSeqVBAIJKernel_w_gets_A_times_v(PetscInt rb,const MatScalar *A,const PetscScalar *v,PetscScalar *w)
+{
+  PetscInt r;
+
+  for (r=0; r<rb; r++) w[r] = 0.0;
+  MatSeqVBAIJKernel_w_gets_w_plus_A_times_v(rb,rb,A,v,w);
+}
+
+PETSC_INTERN PetscErrorCode MatSeqVBAIJSetPreallocationCSR_Private(Mat,PetscInt,const PetscInt[],PetscInt,const PetscInt[],const PetscInt[],const PetscInt[],const PetscScalar[]);
+PETSC_INTERN PetscErrorCode MatSeqVBAIJInvertDiagonal_Private(Mat,PetscInt,PetscInt);
+PETSC_INTERN PetscErrorCode MatGetFactor_seqvbaij_petsc(Mat,MatFactorType,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqVBAIJ(Mat,MatType,MatReuse,Mat*);
+#endif
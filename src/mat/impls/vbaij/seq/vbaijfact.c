@@ -0,0 +1,141 @@
+
+/*
+    Block ILU(0) factorization with the natural ordering for the VBAIJ format
+*/
+#include <../src/mat/impls/vbaij/seq/vbaij.h>
+
+/*
+    The factor has the nonzero blocks of the matrix: the blocks left of the diagonal hold L (with identity diagonal
+  blocks), the blocks right of the diagonal hold U and idiag holds the inverses of the diagonal blocks of U
+*/
+static PetscErrorCode MatSolve_SeqVBAIJ(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscScalar    *x,*t = a->work;
+  PetscInt       ib,k,r,rb;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecCopy(bb,xx);CHKERRQ(ierr);
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  for (ib=0; ib<a->mbs; ib++) {
+    rb = a->bsizes[ib];
+    for (k=a->i[ib]; k<a->diag[ib]; k++) {
+      MatSeqVBAIJKernel_w_gets_w_minus_A_times_v(rb,a->bsizes[a->j[k]],a->a+a->voff[k],x+a->boff[a->j[k]],x+a->boff[ib]);
+    }
+  }
+  for (ib=a->mbs-1; ib>=0; ib--) {
+    rb = a->bsizes[ib];
+    for (r=0; r<rb; r++) t[r] = x[a->boff[ib]+r];
+    for (k=a->diag[ib]+1; k<a->i[ib+1]; k++) {
+      MatSeqVBAIJKernel_w_gets_w_minus_A_times_v(rb,a->bsizes[a->j[k]],a->a+a->voff[k],x+a->boff[a->j[k]],t);
+    }
+    MatSeqVBAIJKernel_w_gets_A_times_v(rb,a->idiag+a->idiagoff[ib],t,x+a->boff[ib]);
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nzp - A->rmap->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatILUFactorNumeric_SeqVBAIJ(Mat fact,Mat A,const MatFactorInfo *info)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data,*b = (Mat_SeqVBAIJ*)fact->data;
+  MatScalar      *L,*U,*C,*D,*w;
+  PetscScalar    u;
+  PetscInt       ib,jb,kb,k,kk,p,r,c,q,rb,ck,cj,*map;
+  PetscLogDouble flops = 0.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (a->nz != b->nz || a->nzp != b->nzp) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Nonzero blocks of the matrix changed since the symbolic factorization");
+  ierr = PetscArraycpy(b->a,a->a,a->nzp);CHKERRQ(ierr);
+  ierr = PetscMalloc2(b->mbs,&map,b->maxbs*b->maxbs,&w);CHKERRQ(ierr);
+  for (ib=0; ib<b->mbs; ib++) map[ib] = -1;
+  fact->erroriffailure  = A->erroriffailure;
+  fact->factorerrortype = MAT_FACTOR_NOERROR;
+
+  for (ib=0; ib<b->mbs; ib++) {
+    rb = b->bsizes[ib];
+    for (k=b->i[ib]; k<b->i[ib+1]; k++) map[b->j[k]] = k;
+    for (k=b->i[ib]; k<b->diag[ib]; k++) {
+      /* L(ib,kb) = A(ib,kb) inv(U(kb,kb)) */
+      kb   = b->j[k];
+      ck   = b->bsizes[kb];
+      L    = b->a + b->voff[k];
+      D    = b->idiag + b->idiagoff[kb];
+      ierr = PetscArraycpy(w,L,rb*ck);CHKERRQ(ierr);
+      for (c=0; c<ck; c++) {
+        for (r=0; r<rb; r++) L[c*rb+r] = 0.0;
+        for (q=0; q<ck; q++) {
+          u = D[c*ck+q];
+          for (r=0; r<rb; r++) L[c*rb+r] += w[q*rb+r]*u;
+        }
+      }
+      flops += 2.0*rb*ck*ck;
+      /* A(ib,jb) -= L(ib,kb) U(kb,jb) for the blocks of block row kb right of its diagonal that are also in block row ib */
+      for (kk=b->diag[kb]+1; kk<b->i[kb+1]; kk++) {
+        jb = b->j[kk];
+        p  = map[jb];
+        if (p < 0) continue;
+        cj = b->bsizes[jb];
+        U  = b->a + b->voff[kk];
+        C  = b->a + b->voff[p];
+        for (c=0; c<cj; c++) {
+          for (q=0; q<ck; q++) {
+            u = U[c*ck+q];
+            for (r=0; r<rb; r++) C[c*rb+r] -= L[q*rb+r]*u;
+          }
+        }
+        flops += 2.0*rb*ck*cj;
+      }
+    }
+    ierr = MatSeqVBAIJInvertDiagonal_Private(fact,ib,ib+1);CHKERRQ(ierr);
+    for (k=b->i[ib]; k<b->i[ib+1]; k++) map[b->j[k]] = -1;
+  }
+  ierr = PetscFree2(map,w);CHKERRQ(ierr);
+
+  b->idiagvalid       = PETSC_TRUE;
+  fact->ops->solve    = MatSolve_SeqVBAIJ;
+  fact->assembled     = PETSC_TRUE;
+  fact->preallocated  = PETSC_TRUE;
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatILUFactorSymbolic_SeqVBAIJ(Mat fact,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  Mat_SeqVBAIJ   *a = (Mat_SeqVBAIJ*)A->data;
+  PetscBool      rowidentity,colidentity,missing;
+  PetscInt       d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (info->levels > 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"MATSEQVBAIJ only supports ILU(0), not ILU(%D)",(PetscInt)info->levels);
+  ierr = ISIdentity(isrow,&rowidentity);CHKERRQ(ierr);
+  ierr = ISIdentity(iscol,&colidentity);CHKERRQ(ierr);
+  if (!rowidentity || !colidentity) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"MATSEQVBAIJ ILU(0) only supports the natural ordering");
+  ierr = MatMissingDiagonal(A,&missing,&d);CHKERRQ(ierr);
+  if (missing) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Matrix is missing the diagonal block of row %D",d);
+
+  ierr = MatSeqVBAIJSetPreallocationCSR(fact,a->mbs,a->bsizes,a->i,a->j,NULL);CHKERRQ(ierr);
+  fact->ops->lufactornumeric = MatILUFactorNumeric_SeqVBAIJ;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqvbaij_petsc(Mat A,MatFactorType ftype,Mat *B)
+{
+  PetscInt       n = A->rmap->n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ftype != MAT_FACTOR_ILU) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"MATSEQVBAIJ only supports ILU(0) factorization");
+  ierr = MatCreate(PetscObjectComm((PetscObject)A),B);CHKERRQ(ierr);
+  ierr = MatSetSizes(*B,n,n,n,n);CHKERRQ(ierr);
+  ierr = MatSetType(*B,MATSEQVBAIJ);CHKERRQ(ierr);
+  (*B)->factortype             = ftype;
+  (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqVBAIJ;
+
+  ierr = PetscFree((*B)->solvertype);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(MATSOLVERPETSC,&(*B)->solvertype);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
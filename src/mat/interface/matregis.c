@@ -11,6 +11,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat);
 
 PETSC_EXTERN PetscErrorCode MatCreate_SeqBAIJ(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIBAIJ(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_SeqVBAIJ(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIVBAIJ(Mat);
 
 PETSC_EXTERN PetscErrorCode MatCreate_SeqSBAIJ(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPISBAIJ(Mat);
@@ -137,6 +139,10 @@ PetscErrorCode  MatRegisterAll(void)
   ierr = MatRegister(MATMPIBAIJ,        MatCreate_MPIBAIJ);CHKERRQ(ierr);
   ierr = MatRegister(MATSEQBAIJ,        MatCreate_SeqBAIJ);CHKERRQ(ierr);
 
+  ierr = MatRegisterRootName(MATVBAIJ,MATSEQVBAIJ,MATMPIVBAIJ);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIVBAIJ,       MatCreate_MPIVBAIJ);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQVBAIJ,       MatCreate_SeqVBAIJ);CHKERRQ(ierr);
+
   ierr = MatRegisterRootName(MATSBAIJ,MATSEQSBAIJ,MATMPISBAIJ);CHKERRQ(ierr);
   ierr = MatRegister(MATMPISBAIJ,       MatCreate_MPISBAIJ);CHKERRQ(ierr);
   ierr = MatRegister(MATSEQSBAIJ,       MatCreate_SeqSBAIJ);CHKERRQ(ierr);
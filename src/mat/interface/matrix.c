@@ -22,16 +22,18 @@ PetscLogEvent MAT_IncreaseOverlap, MAT_Partitioning, MAT_PartitioningND, MAT_Coa
 PetscLogEvent MAT_FDColoringSetUp, MAT_FDColoringApply,MAT_Transpose,MAT_FDColoringFunction, MAT_CreateSubMat;
 PetscLogEvent MAT_TransposeColoringCreate;
 PetscLogEvent MAT_MatMult, MAT_MatMultSymbolic, MAT_MatMultNumeric;
-PetscLogEvent MAT_PtAP, MAT_PtAPSymbolic, MAT_PtAPNumeric,MAT_RARt, MAT_RARtSymbolic, MAT_RARtNumeric;
+PetscLogEvent MAT_PtAP, MAT_PtAPSymbolic, MAT_PtAPNumeric, MAT_PtAPNumericComm, MAT_PtAPNumericLocal,MAT_RARt, MAT_RARtSymbolic, MAT_RARtNumeric;
 PetscLogEvent MAT_MatTransposeMult, MAT_MatTransposeMultSymbolic, MAT_MatTransposeMultNumeric;
 PetscLogEvent MAT_TransposeMatMult, MAT_TransposeMatMultSymbolic, MAT_TransposeMatMultNumeric;
 PetscLogEvent MAT_MatMatMult, MAT_MatMatMultSymbolic, MAT_MatMatMultNumeric;
 PetscLogEvent MAT_MultHermitianTranspose,MAT_MultHermitianTransposeAdd;
+PetscLogEvent MAT_MultHaloWait,MAT_MultOffDiag;
 PetscLogEvent MAT_Getsymtranspose, MAT_Getsymtransreduced, MAT_GetBrowsOfAcols;
 PetscLogEvent MAT_GetBrowsOfAocols, MAT_Getlocalmat, MAT_Getlocalmatcondensed, MAT_Seqstompi, MAT_Seqstompinum, MAT_Seqstompisym;
 PetscLogEvent MAT_Applypapt, MAT_Applypapt_numeric, MAT_Applypapt_symbolic, MAT_GetSequentialNonzeroStructure;
 PetscLogEvent MAT_GetMultiProcBlock;
 PetscLogEvent MAT_CUSPARSECopyToGPU, MAT_SetValuesBatch;
+PetscLogEvent MAT_PreallCOO, MAT_SetVCOO;
 PetscLogEvent MAT_ViennaCLCopyToGPU;
 PetscLogEvent MAT_DenseCopyToGPU, MAT_DenseCopyFromGPU;
 PetscLogEvent MAT_Merge,MAT_Residual,MAT_SetRandom;
@@ -2030,6 +2032,164 @@ PetscErrorCode MatSetValuesBatch(Mat mat, PetscInt nb, PetscInt bs, PetscInt row
   PetscFunctionReturn(0);
 }
 
+/*
+   Fallback for matrix types that do not provide a COO implementation: the nonzero pattern is preallocated with
+   MATPREALLOCATOR and the coordinates are kept so that MatSetValuesCOO() can replay them through MatSetValues()
+*/
+static PetscErrorCode MatSetPreallocationCOO_Basic(Mat A,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat            preallocator;
+  PetscContainer container;
+  PetscInt       *coo,n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  ierr = MatCreate(PetscObjectComm((PetscObject)A),&preallocator);CHKERRQ(ierr);
+  ierr = MatSetType(preallocator,MATPREALLOCATOR);CHKERRQ(ierr);
+  ierr = MatSetSizes(preallocator,A->rmap->n,A->cmap->n,A->rmap->N,A->cmap->N);CHKERRQ(ierr);
+  ierr = MatSetBlockSizesFromMats(preallocator,A,A);CHKERRQ(ierr);
+  ierr = MatSetUp(preallocator);CHKERRQ(ierr);
+  for (n=0; n<ncoo; n++) {
+    ierr = MatSetValue(preallocator,coo_i[n],coo_j[n],0.0,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(preallocator,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(preallocator,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatPreallocatorPreallocate(preallocator,PETSC_TRUE,A);CHKERRQ(ierr);
+  ierr = MatDestroy(&preallocator);CHKERRQ(ierr);
+
+  /* stored as [ncoo, coo_i[], coo_j[]] */
+  ierr = PetscMalloc1(1+2*ncoo,&coo);CHKERRQ(ierr);
+  coo[0] = ncoo;
+  ierr = PetscArraycpy(coo+1,coo_i,ncoo);CHKERRQ(ierr);
+  ierr = PetscArraycpy(coo+1+ncoo,coo_j,ncoo);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,coo);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,PetscContainerUserDestroyDefault);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)A,"__PETSc_coo",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_Basic(Mat A,const PetscScalar coo_v[],InsertMode imode)
+{
+  PetscContainer container;
+  const PetscInt *coo,*cooi,*cooj;
+  PetscInt       ncoo,n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQuery((PetscObject)A,"__PETSc_coo",(PetscObject*)&container);CHKERRQ(ierr);
+  if (!container) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  ierr = PetscContainerGetPointer(container,(void**)&coo);CHKERRQ(ierr);
+  ncoo = coo[0];
+  cooi = coo+1;
+  cooj = coo+1+ncoo;
+  if (imode == INSERT_VALUES) {ierr = MatZeroEntries(A);CHKERRQ(ierr);}
+  for (n=0; n<ncoo; n++) {
+    ierr = MatSetValue(A,cooi[n],cooj[n],coo_v[n],ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatSetPreallocationCOO - set the nonzero pattern of a matrix from a list of coordinates (COO format), to be
+   followed by one or more calls to MatSetValuesCOO()
+
+   Collective on Mat
+
+   Input Parameters:
++  A - the matrix, its sizes and type must have been set
+.  ncoo - the number of entries on this process
+.  coo_i - the global row indices of the entries
+-  coo_j - the global column indices of the entries
+
+   Notes:
+   Entries may be repeated, in which case their values are added together by MatSetValuesCOO(). Entries with a
+   negative row or column index are ignored. Rows owned by other processes are allowed; the communication
+   needed to move them to their owners is computed once here so that MatSetValuesCOO() only moves values.
+
+   Any existing nonzero pattern and values of the matrix are discarded. The arrays coo_i and coo_j may be
+   freed after this call returns.
+
+   For MATSEQAIJ and MATMPIAIJ the mapping from the coordinates to the compressed row storage is precomputed,
+   so that MatSetValuesCOO() is a single pass over the value array. Other matrix types fall back to MatSetValues().
+
+   Level: beginner
+
+.seealso: MatSetValuesCOO(), MatSeqAIJSetPreallocation(), MatMPIAIJSetPreallocation(), MatSetValues(), MatCreateSeqAIJWithArrays()
+@*/
+PetscErrorCode MatSetPreallocationCOO(Mat A,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  PetscErrorCode (*f)(Mat,PetscInt,const PetscInt[],const PetscInt[]) = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidType(A,1);
+  if (ncoo) PetscValidIntPointer(coo_i,3);
+  if (ncoo) PetscValidIntPointer(coo_j,4);
+  if (ncoo < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of entries cannot be negative: %D",ncoo);
+  if (PetscUnlikelyDebug(A->factortype)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Not for factored matrix");
+
+  ierr = PetscObjectQueryFunction((PetscObject)A,"MatSetPreallocationCOO_C",&f);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_PreallCOO,A,0,0,0);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(A,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetPreallocationCOO_Basic(A,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(MAT_PreallCOO,A,0,0,0);CHKERRQ(ierr);
+  A->preallocated = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   MatSetValuesCOO - set the values of a matrix whose nonzero pattern was given with MatSetPreallocationCOO()
+
+   Collective on Mat
+
+   Input Parameters:
++  A - the matrix
+.  coo_v - the values, in the same order as the coordinates given to MatSetPreallocationCOO()
+-  imode - INSERT_VALUES to overwrite the current values of the matrix, ADD_VALUES to add to them
+
+   Notes:
+   The matrix is assembled on return; MatAssemblyBegin()/MatAssemblyEnd() need not be called.
+
+   Repeated coordinates are always added together, independently of imode.
+
+   Level: beginner
+
+.seealso: MatSetPreallocationCOO(), MatSetValues(), InsertMode, INSERT_VALUES, ADD_VALUES
+@*/
+PetscErrorCode MatSetValuesCOO(Mat A,const PetscScalar coo_v[],InsertMode imode)
+{
+  PetscErrorCode (*f)(Mat,const PetscScalar[],InsertMode) = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidType(A,1);
+  MatCheckPreallocated(A,1);
+  PetscValidLogicalCollectiveEnum(A,imode,3);
+  if (imode != INSERT_VALUES && imode != ADD_VALUES) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_WRONG,"Only INSERT_VALUES and ADD_VALUES are supported");
+
+  ierr = PetscObjectQueryFunction((PetscObject)A,"MatSetValuesCOO_C",&f);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_SetVCOO,A,0,0,0);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(A,coo_v,imode);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetValuesCOO_Basic(A,coo_v,imode);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(MAT_SetVCOO,A,0,0,0);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    MatSetLocalToGlobalMapping - Sets a local-to-global numbering for use by
    the routine MatSetValuesLocal() to allow users to insert matrix entries
@@ -3364,18 +3524,19 @@ static PetscErrorCode MatMatSolve_Basic(Mat A,Mat B,Mat X,PetscBool trans)
 {
   PetscErrorCode ierr;
   Vec            b,x;
-  PetscInt       m,N,i;
+  PetscInt       ldb,ldx,N,i;
   PetscScalar    *bb,*xx;
 
   PetscFunctionBegin;
   ierr = MatDenseGetArrayRead(B,(const PetscScalar**)&bb);CHKERRQ(ierr);
   ierr = MatDenseGetArray(X,&xx);CHKERRQ(ierr);
-  ierr = MatGetLocalSize(B,&m,NULL);CHKERRQ(ierr);  /* number local rows */
+  ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);      /* leading dimensions of the local arrays */
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
   ierr = MatGetSize(B,NULL,&N);CHKERRQ(ierr);       /* total columns in dense matrix */
   ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
   for (i=0; i<N; i++) {
-    ierr = VecPlaceArray(b,bb + i*m);CHKERRQ(ierr);
-    ierr = VecPlaceArray(x,xx + i*m);CHKERRQ(ierr);
+    ierr = VecPlaceArray(b,bb + i*ldb);CHKERRQ(ierr);
+    ierr = VecPlaceArray(x,xx + i*ldx);CHKERRQ(ierr);
     if (trans) {
       ierr = MatSolveTranspose(A,b,x);CHKERRQ(ierr);
     } else {
@@ -0,0 +1,94 @@
+
+static char help[] = "Tests MatSetPreallocationCOO() and MatSetValuesCOO() against MatSetValues().\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,B,C;
+  PetscInt       M = 11,n = 40,k,*coo_i,*coo_j;
+  PetscScalar    *coo_v;
+  PetscReal      norm;
+  PetscMPIInt    rank;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-M",&M,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* entries anywhere in the matrix, with repeated coordinates and some ignored (negative) ones */
+  ierr = PetscMalloc3(n,&coo_i,n,&coo_j,n,&coo_v);CHKERRQ(ierr);
+  for (k=0; k<n; k++) {
+    coo_i[k] = (7*rank + 3*k) % M;
+    coo_j[k] = (5*k + rank) % M;
+    coo_v[k] = (PetscScalar)(k + 1 + rank);
+    if (k % 9 == 4) coo_i[k] = -1;
+    if (k % 11 == 6) coo_j[k] = -1;
+  }
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,M,M);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO(A,n,coo_i,coo_j);CHKERRQ(ierr);
+  ierr = MatSetValuesCOO(A,coo_v,INSERT_VALUES);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,M,M);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(B);CHKERRQ(ierr);
+  ierr = MatSetUp(B);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  for (k=0; k<n; k++) {
+    ierr = MatSetValue(B,coo_i[k],coo_j[k],coo_v[k],ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatDuplicate(B,MAT_COPY_VALUES,&C);CHKERRQ(ierr);
+  ierr = MatAXPY(C,-1.0,A,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatNorm(C,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm of difference with INSERT_VALUES %g\n",(double)norm);CHKERRQ(ierr);
+
+  /* reuse the pattern: A becomes 2*B */
+  ierr = MatSetValuesCOO(A,coo_v,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_COPY_VALUES,&C);CHKERRQ(ierr);
+  ierr = MatAXPY(C,-0.5,A,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatNorm(C,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm of difference with ADD_VALUES %g\n",(double)norm);CHKERRQ(ierr);
+
+  /* and back to B */
+  ierr = MatSetValuesCOO(A,coo_v,INSERT_VALUES);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_COPY_VALUES,&C);CHKERRQ(ierr);
+  ierr = MatAXPY(C,-1.0,A,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatNorm(C,NORM_FROBENIUS,&norm);CHKERRQ(ierr);
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"Norm of difference with INSERT_VALUES %g\n",(double)norm);CHKERRQ(ierr);
+
+  ierr = PetscFree3(coo_i,coo_j,coo_v);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: seqaij
+      args: -mat_type aij
+
+   test:
+      suffix: mpiaij
+      nsize: 3
+      args: -mat_type aij
+      output_file: output/ex302_seqaij.out
+
+   test:
+      suffix: baij
+      nsize: 2
+      args: -mat_type baij
+      output_file: output/ex302_seqaij.out
+
+TEST*/
@@ -0,0 +1,144 @@
+static char help[] = "Tests the OpenMP threaded MatMult(), MatMultAdd(), MatMultTranspose() and MatMultTransposeAdd() for SeqAIJ.\n\n";
+
+#include <petscmat.h>
+
+/* rows come in pairs with identical nonzero structure (inodes), row lengths vary, and with -empty most rows are empty (compressed rows) */
+static PetscErrorCode FillMatrix(Mat A,PetscInt m,PetscInt n,PetscBool empty)
+{
+  PetscInt       i,k,len,col;
+  PetscScalar    v;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    if (empty && (i/2) % 3) continue;
+    len = 1 + ((i/2)*7) % 13;
+    for (k=0; k<len; k++) {
+      col  = ((i/2)*5 + k*k + 3*k) % n;
+      v    = (PetscScalar)(1.0 + i + 0.5*k);
+      ierr = MatSetValue(A,i,col,v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckDifference(const char *op,Vec x,Vec y)
+{
+  PetscReal      norm,ref;
+  Vec            d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+  if (norm > 100*PETSC_MACHINE_EPSILON*ref) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: difference %g\n",op,(double)norm);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results agree\n",op);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,z,xt,yt,zt,w,wt;
+  PetscInt       m = 203,n = 157;
+  PetscBool      empty = PETSC_FALSE;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-empty",&empty,NULL);CHKERRQ(ierr);
+
+  /* A uses the options with prefix thr_, B is the reference */
+  ierr = MatCreate(PETSC_COMM_SELF,&A);CHKERRQ(ierr);
+  ierr = MatSetOptionsPrefix(A,"thr_");CHKERRQ(ierr);
+  ierr = MatSetSizes(A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,13,NULL);CHKERRQ(ierr);
+  ierr = FillMatrix(A,m,n,empty);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_SELF,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(B,13,NULL);CHKERRQ(ierr);
+  ierr = FillMatrix(B,m,n,empty);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&w);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&xt,&yt);CHKERRQ(ierr);
+  ierr = VecDuplicate(xt,&zt);CHKERRQ(ierr);
+  ierr = VecDuplicate(xt,&wt);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(yt,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(zt,rand);CHKERRQ(ierr);
+
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMult",w,y);CHKERRQ(ierr);
+
+  ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultAdd",w,y);CHKERRQ(ierr);
+
+  ierr = MatMultTranspose(A,yt,xt);CHKERRQ(ierr);
+  ierr = MatMultTranspose(B,yt,wt);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultTranspose",wt,xt);CHKERRQ(ierr);
+
+  ierr = MatMultTransposeAdd(A,yt,zt,xt);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd(B,yt,zt,wt);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultTransposeAdd",wt,xt);CHKERRQ(ierr);
+
+  /* in-place MatMultAdd() */
+  ierr = VecCopy(z,y);CHKERRQ(ierr);
+  ierr = VecCopy(z,w);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,y,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,w,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultAdd in place",w,y);CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&xt);CHKERRQ(ierr);
+  ierr = VecDestroy(&yt);CHKERRQ(ierr);
+  ierr = VecDestroy(&zt);CHKERRQ(ierr);
+  ierr = VecDestroy(&wt);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      requires: openmp
+      output_file: output/ex303_1.out
+      test:
+         suffix: 1
+         args: -thr_mat_aij_omp_threads 3
+      test:
+         suffix: noinode
+         args: -thr_mat_aij_omp_threads 4 -thr_mat_no_inode
+      test:
+         suffix: cprow
+         args: -thr_mat_aij_omp_threads 3 -empty -thr_mat_no_inode
+      test:
+         suffix: manythreads
+         args: -thr_mat_aij_omp_threads 8 -m 5 -n 7
+
+TEST*/
@@ -0,0 +1,147 @@
+static char help[] = "Tests the SIMD variants of MatMult(), MatMultAdd(), MatMultTranspose(), MatMultTransposeAdd() and MatSOR() for SeqSELL.\n\n";
+
+#include <petscmat.h>
+
+/* diagonally dominant with row lengths between 1 and 40, the last slice is padded unless m is a multiple of 8 */
+static PetscErrorCode FillMatrix(Mat A,PetscInt m)
+{
+  PetscInt       i,k,len,col;
+  PetscScalar    v;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    len  = (i*11) % 40;
+    for (k=0; k<len; k++) {
+      col  = (i*7 + k*k + 3*k) % m;
+      if (col == i) continue;
+      v    = (PetscScalar)(0.01*(1 + (i+k) % 5));
+      ierr = MatSetValue(A,i,col,v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+    ierr = MatSetValue(A,i,i,2.0+0.1*i,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckDifference(Vec x,Vec y,PetscBool *agree)
+{
+  PetscReal      norm,ref;
+  Vec            d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+  if (norm > 100*PETSC_MACHINE_EPSILON*ref) *agree = PETSC_FALSE;
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,z,w;
+  PetscInt       m = 203,i,k,tested = 0;
+  const char     *simd[] = {"none","avx","avx2","avx512"};
+  const char     *ops[] = {"MatMult","MatMultAdd","MatMultTranspose","MatMultTransposeAdd","MatSOR"};
+  PetscBool      agree[5];
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+
+  /* B is the reference */
+  ierr = MatCreate(PETSC_COMM_SELF,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,m,m,m,m);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(B,41,NULL);CHKERRQ(ierr);
+  ierr = FillMatrix(B,m);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(B,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&w);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rand);CHKERRQ(ierr);
+
+  for (k=0; k<5; k++) agree[k] = PETSC_TRUE;
+  /* try every instruction set, the ones this build or CPU does not support fail at MatSetType() and are skipped */
+  for (i=0; i<4; i++) {
+    ierr = PetscOptionsSetValue(NULL,"-mat_sell_simd",simd[i]);CHKERRQ(ierr);
+    ierr = MatCreate(PETSC_COMM_SELF,&A);CHKERRQ(ierr);
+    ierr = MatSetSizes(A,m,m,m,m);CHKERRQ(ierr);
+    ierr = PetscPushErrorHandler(PetscIgnoreErrorHandler,NULL);CHKERRQ(ierr);
+    ierr = MatSetType(A,MATSEQSELL);
+    ierr = PetscPopErrorHandler();CHKERRQ(ierr);
+    if (ierr) {
+      ierr = MatDestroy(&A);CHKERRQ(ierr);
+      break;
+    }
+    tested++;
+    ierr = MatSeqSELLSetPreallocation(A,41,NULL);CHKERRQ(ierr);
+    ierr = FillMatrix(A,m);CHKERRQ(ierr);
+
+    ierr = MatMult(A,x,y);CHKERRQ(ierr);
+    ierr = MatMult(B,x,w);CHKERRQ(ierr);
+    ierr = CheckDifference(w,y,&agree[0]);CHKERRQ(ierr);
+
+    ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);
+    ierr = MatMultAdd(B,x,z,w);CHKERRQ(ierr);
+    ierr = CheckDifference(w,y,&agree[1]);CHKERRQ(ierr);
+
+    ierr = MatMultTranspose(A,x,y);CHKERRQ(ierr);
+    ierr = MatMultTranspose(B,x,w);CHKERRQ(ierr);
+    ierr = CheckDifference(w,y,&agree[2]);CHKERRQ(ierr);
+
+    ierr = MatMultTransposeAdd(A,x,z,y);CHKERRQ(ierr);
+    ierr = MatMultTransposeAdd(B,x,z,w);CHKERRQ(ierr);
+    ierr = CheckDifference(w,y,&agree[3]);CHKERRQ(ierr);
+
+    ierr = VecCopy(z,y);CHKERRQ(ierr);
+    ierr = VecCopy(z,w);CHKERRQ(ierr);
+    ierr = MatSOR(A,x,1.2,SOR_SYMMETRIC_SWEEP,0.0,2,1,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,x,1.2,SOR_SYMMETRIC_SWEEP,0.0,2,1,w);CHKERRQ(ierr);
+    ierr = CheckDifference(w,y,&agree[4]);CHKERRQ(ierr);
+    ierr = MatSOR(A,x,1.0,(MatSORType)(SOR_FORWARD_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,1,1,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,x,1.0,(MatSORType)(SOR_FORWARD_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,1,1,w);CHKERRQ(ierr);
+    ierr = CheckDifference(w,y,&agree[4]);CHKERRQ(ierr);
+    ierr = MatSOR(A,x,1.0,(MatSORType)(SOR_BACKWARD_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,2,1,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,x,1.0,(MatSORType)(SOR_BACKWARD_SWEEP | SOR_ZERO_INITIAL_GUESS),0.0,2,1,w);CHKERRQ(ierr);
+    ierr = CheckDifference(w,y,&agree[4]);CHKERRQ(ierr);
+    ierr = MatDestroy(&A);CHKERRQ(ierr);
+  }
+  ierr = PetscInfo1(NULL,"Tested %D instruction sets\n",tested);CHKERRQ(ierr);
+  for (k=0; k<5; k++) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s\n",ops[k],agree[k] ? "results agree" : "results differ");CHKERRQ(ierr);
+  }
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex304_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         args: -m 64
+      test:
+         suffix: 3
+         args: -m 5
+
+TEST*/
@@ -0,0 +1,172 @@
+static char help[] = "Tests MatMult(), MatMultAdd(), MatSOR() and MatSolve() of SeqAIJ with single precision values.\n\n";
+
+#include <petscmat.h>
+
+/* diagonally dominant, rows come in pairs with identical nonzero structure (inodes) */
+static PetscErrorCode FillMatrix(Mat A,PetscInt m)
+{
+  PetscInt       i,k,col;
+  PetscScalar    v;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    for (k=0; k<1+((i/2)*7)%11; k++) {
+      col  = ((i/2)*5 + k*k + 3*k) % m;
+      v    = (PetscScalar)(-0.1/(1.0 + k) - 1.e-3*i);
+      ierr = MatSetValue(A,i,col,v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+    if ((i^1) < m) {ierr = MatSetValue(A,i,i^1,0.3,INSERT_VALUES);CHKERRQ(ierr);}
+    ierr = MatSetValue(A,i,i,3.0 + 1.0/(1.0 + i),INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* the single precision values give a relative error of about 1e-7 */
+static PetscErrorCode CheckDifference(const char *op,Vec x,Vec y)
+{
+  PetscReal      norm,ref;
+  Vec            d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+  if (norm > 1.e-5*ref) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: difference %g\n",op,(double)norm);CHKERRQ(ierr);
+  } else if (norm == 0.0) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results are identical, single precision values not used\n",op);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results agree\n",op);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckFactor(Mat A,Mat B,MatFactorType ftype,const char *op,Vec b)
+{
+  Mat            FA,FB;
+  IS             isrow,iscol;
+  MatFactorInfo  info;
+  Vec            x,w;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(b,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(b,&w);CHKERRQ(ierr);
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  ierr = MatGetOrdering(A,MATORDERINGRCM,&isrow,&iscol);CHKERRQ(ierr);
+  ierr = MatGetFactor(A,MATSOLVERPETSC,ftype,&FA);CHKERRQ(ierr);
+  ierr = MatGetFactor(B,MATSOLVERPETSC,ftype,&FB);CHKERRQ(ierr);
+  if (ftype == MAT_FACTOR_LU) {
+    info.fill = 5.0;
+    ierr = MatLUFactorSymbolic(FA,A,isrow,iscol,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorSymbolic(FB,B,isrow,iscol,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(FA,A,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(FB,B,&info);CHKERRQ(ierr);
+  } else {
+    info.fill   = 1.0;
+    info.levels = 1;
+    ierr = MatILUFactorSymbolic(FA,A,isrow,iscol,&info);CHKERRQ(ierr);
+    ierr = MatILUFactorSymbolic(FB,B,isrow,iscol,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(FA,A,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(FB,B,&info);CHKERRQ(ierr);
+  }
+  ierr = MatSolve(FA,b,x);CHKERRQ(ierr);
+  ierr = MatSolve(FB,b,w);CHKERRQ(ierr);
+  ierr = CheckDifference(op,w,x);CHKERRQ(ierr);
+  ierr = ISDestroy(&isrow);CHKERRQ(ierr);
+  ierr = ISDestroy(&iscol);CHKERRQ(ierr);
+  ierr = MatDestroy(&FA);CHKERRQ(ierr);
+  ierr = MatDestroy(&FB);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,z,w;
+  PetscInt       m = 101;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+
+  /* A uses the options with prefix sp_, B is the double precision reference */
+  ierr = MatCreate(PETSC_COMM_SELF,&A);CHKERRQ(ierr);
+  ierr = MatSetOptionsPrefix(A,"sp_");CHKERRQ(ierr);
+  ierr = MatSetSizes(A,m,m,m,m);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,13,NULL);CHKERRQ(ierr);
+  ierr = FillMatrix(A,m);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_SELF,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,m,m,m,m);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(B,13,NULL);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_USE_INODES,PETSC_FALSE);CHKERRQ(ierr); /* with single precision values MatSOR() uses the point sweeps */
+  ierr = FillMatrix(B,m);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&w);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rand);CHKERRQ(ierr);
+
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMult",w,y);CHKERRQ(ierr);
+
+  ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultAdd",w,y);CHKERRQ(ierr);
+
+  ierr = VecCopy(z,y);CHKERRQ(ierr);
+  ierr = VecCopy(z,w);CHKERRQ(ierr);
+  ierr = MatSOR(A,x,1.0,SOR_SYMMETRIC_SWEEP,0.0,2,1,y);CHKERRQ(ierr);
+  ierr = MatSOR(B,x,1.0,SOR_SYMMETRIC_SWEEP,0.0,2,1,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatSOR",w,y);CHKERRQ(ierr);
+
+  ierr = CheckFactor(A,B,MAT_FACTOR_LU,"MatSolve LU",x);CHKERRQ(ierr);
+  ierr = CheckFactor(A,B,MAT_FACTOR_ILU,"MatSolve ILU",x);CHKERRQ(ierr);
+
+  /* the single precision copy must follow changes of the values */
+  ierr = MatScale(A,2.0);CHKERRQ(ierr);
+  ierr = MatScale(B,2.0);CHKERRQ(ierr);
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMult after MatScale",w,y);CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      requires: double !complex
+      output_file: output/ex305_1.out
+      test:
+         suffix: 1
+         args: -sp_mat_aij_mixed_precision
+      test:
+         suffix: noinode
+         args: -sp_mat_aij_mixed_precision -sp_mat_no_inode
+
+TEST*/
@@ -0,0 +1,171 @@
+static char help[] = "Tests MatMult() and MatMultAdd() of AIJ matrices with compressed column indices.\n\n";
+
+#include <petscmat.h>
+
+/* rows couple columns within w of the diagonal, pairs of rows have identical nonzero structure (inodes), and with -empty most rows are empty (compressed rows) */
+static PetscErrorCode FillMatrix(Mat A,PetscInt w,PetscBool empty)
+{
+  PetscInt       i,k,len,col,rstart,rend,M;
+  PetscScalar    v;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetSize(A,&M,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    if (empty && (i/2) % 3) continue;
+    len = 1 + ((i/2)*7) % 13;
+    for (k=0; k<len; k++) {
+      col = 2*(i/2) - w + ((i/2)*5 + k*k*w + 3*k) % (2*w+1);
+      if (col < 0 || col >= M) continue;
+      v    = (PetscScalar)(1.0 + 0.01*i + 0.5*k);
+      ierr = MatSetValues(A,1,&i,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* the reference matrix uses neither the compressed indices nor the single precision values given in the options */
+static PetscErrorCode SetReference(Mat B)
+{
+  Mat            Ad,Ao;
+  PetscBool      mpi;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)B,MATMPIAIJ,&mpi);CHKERRQ(ierr);
+  if (mpi) {
+    ierr = MatMPIAIJGetSeqAIJ(B,&Ad,&Ao,NULL);CHKERRQ(ierr);
+    ierr = SetReference(Ad);CHKERRQ(ierr);
+    ierr = SetReference(Ao);CHKERRQ(ierr);
+  } else {
+    ierr = MatSeqAIJSetCompressIndices(B,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = MatSeqAIJSetMixedPrecision(B,PETSC_FALSE);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckDifference(const char *op,Vec x,Vec y,PetscReal tol)
+{
+  PetscReal      norm,ref;
+  Vec            d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+  if (norm > tol*ref) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: difference %g\n",op,(double)norm);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results agree\n",op);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,z,w;
+  PetscInt       m = 203,width = 10;
+  PetscReal      tol = 100*PETSC_MACHINE_EPSILON;
+  PetscBool      empty = PETSC_FALSE;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-w",&width,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-tol",&tol,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-empty",&empty,NULL);CHKERRQ(ierr);
+
+  /* the blocks of MATMPIAIJ read the options without prefix, so B turns off what it should not use */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m,m);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,13,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,13,NULL,13,NULL);CHKERRQ(ierr);
+  ierr = FillMatrix(A,width,empty);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,m,m);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(B,13,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(B,13,NULL,13,NULL);CHKERRQ(ierr);
+  ierr = SetReference(B);CHKERRQ(ierr);
+  ierr = FillMatrix(B,width,empty);CHKERRQ(ierr);
+  ierr = MatViewFromOptions(A,NULL,"-view_info");CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&w);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rand);CHKERRQ(ierr);
+
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMult",w,y,tol);CHKERRQ(ierr);
+
+  ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultAdd",w,y,tol);CHKERRQ(ierr);
+
+  /* in-place MatMultAdd() */
+  ierr = VecCopy(z,y);CHKERRQ(ierr);
+  ierr = VecCopy(z,w);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,y,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,w,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultAdd in place",w,y,tol);CHKERRQ(ierr);
+
+  /* the compressed indices must follow changes of the nonzero structure */
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatShift(A,2.0);CHKERRQ(ierr);
+  ierr = MatShift(B,2.0);CHKERRQ(ierr);
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMult after MatShift",w,y,tol);CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      requires: !define(PETSC_USE_64BIT_INDICES)
+      args: -mat_aij_compress_indices -view_info ::ascii_info
+      test:
+         suffix: 1
+      test:
+         suffix: noinode
+         args: -mat_no_inode
+      test:
+         suffix: wide
+         args: -m 2000 -w 400
+      test:
+         suffix: cprow
+         args: -empty -mat_no_inode
+      test:
+         suffix: mixed
+         requires: double !complex
+         args: -mat_aij_mixed_precision -tol 1.e-5
+         output_file: output/ex306_1.out
+      test:
+         suffix: 2
+         nsize: 2
+
+TEST*/
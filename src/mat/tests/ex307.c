@@ -0,0 +1,122 @@
+static char help[] = "Tests assembling AIJ matrices without preallocation with -mat_aij_hash_assembly.\n\n";
+
+#include <petscmat.h>
+
+/* adds element matrices coupling rows e, e+1, e+7 and e+50, so in parallel some rows belong to other processes */
+static PetscErrorCode FillMatrix(Mat A,PetscBool flush)
+{
+  PetscInt       e,k,l,rstart,rend,M,idx[4];
+  PetscScalar    v[16];
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetSize(A,&M,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (e=rstart; e<rend; e++) {
+    idx[0] = e; idx[1] = (e+1) % M; idx[2] = (e+7) % M; idx[3] = (e+50) % M;
+    for (k=0; k<4; k++) {
+      for (l=0; l<4; l++) v[4*k+l] = (PetscScalar)(k == l ? 4.0 : -1.0/(1.0 + k + 2*l) + 0.001*e);
+    }
+    ierr = MatSetValues(A,4,idx,4,idx,v,ADD_VALUES);CHKERRQ(ierr);
+    if (flush && e == (rstart+rend)/2) {
+      ierr = MatAssemblyBegin(A,MAT_FLUSH_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(A,MAT_FLUSH_ASSEMBLY);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckEqual(const char *stage,Mat A,Mat B)
+{
+  PetscBool      equal;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatEqual(A,B,&equal);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: matrices are %s\n",stage,equal ? "equal" : "different");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat              A,B;
+  MatInfo          info;
+  PetscInt         m = 203;
+  PetscBool        colmajor = PETSC_FALSE,flush = PETSC_FALSE;
+  PetscObjectState state,state2;
+  PetscErrorCode   ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-colmajor",&colmajor,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-flush",&flush,NULL);CHKERRQ(ierr);
+
+  /* A is not preallocated and uses the options with prefix h_, B is preallocated generously */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetOptionsPrefix(A,"h_");CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m,m);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,m,m);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(B,40,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(B,40,NULL,40,NULL);CHKERRQ(ierr);
+
+  if (colmajor) {
+    ierr = MatSetOption(A,MAT_ROW_ORIENTED,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = MatSetOption(B,MAT_ROW_ORIENTED,PETSC_FALSE);CHKERRQ(ierr);
+  }
+  ierr = FillMatrix(A,flush);CHKERRQ(ierr);
+  ierr = FillMatrix(B,flush);CHKERRQ(ierr);
+  ierr = CheckEqual("First assembly",A,B);CHKERRQ(ierr);
+  ierr = MatGetInfo(A,MAT_GLOBAL_SUM,&info);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"mallocs during MatSetValues() %g, unneeded nonzeros %g\n",(double)info.mallocs,(double)info.nz_unneeded);CHKERRQ(ierr);
+
+  /* the second assembly uses the CSR structure */
+  ierr = MatGetNonzeroState(A,&state);CHKERRQ(ierr);
+  ierr = MatZeroEntries(A);CHKERRQ(ierr);
+  ierr = MatZeroEntries(B);CHKERRQ(ierr);
+  ierr = FillMatrix(A,flush);CHKERRQ(ierr);
+  ierr = FillMatrix(B,flush);CHKERRQ(ierr);
+  ierr = CheckEqual("Second assembly",A,B);CHKERRQ(ierr);
+  ierr = MatGetNonzeroState(A,&state2);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"nonzero structure %s\n",state == state2 ? "unchanged" : "changed");CHKERRQ(ierr);
+
+  /* new nonzeros are still allowed after the hash assembly */
+  ierr = MatSetValue(A,0,m-1,1.0,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatSetValue(B,0,m-1,1.0,ADD_VALUES);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = CheckEqual("New nonzero",A,B);CHKERRQ(ierr);
+
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      args: -h_mat_aij_hash_assembly
+      output_file: output/ex307_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: colmajor
+         args: -colmajor -flush
+      test:
+         suffix: 2
+         nsize: 3
+      test:
+         suffix: 2_colmajor
+         nsize: 3
+         args: -colmajor -flush
+
+TEST*/
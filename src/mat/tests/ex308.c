@@ -0,0 +1,118 @@
+static char help[] = "Tests the threaded MatMatMult() and MatPtAP() of SeqAIJ matrices against the serial products.\n\n";
+
+#include <petscmat.h>
+
+/* the 5-point Laplacian on an n x n grid, and a prolongator from aggregates of 2 x 2 cells that also couples each cell to the next aggregate */
+static PetscErrorCode CreateMatrices(PetscInt n,Mat *A,Mat *P)
+{
+  PetscInt       i,j,row,nc = (n+1)/2;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n*n,n*n,5,NULL,A);CHKERRQ(ierr);
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n*n,nc*nc,2,NULL,P);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (j=0; j<n; j++) {
+      row  = i*n + j;
+      ierr = MatSetValue(*A,row,row,4.0 + 1.e-3*row,INSERT_VALUES);CHKERRQ(ierr);
+      if (i > 0)   {ierr = MatSetValue(*A,row,row-n,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      if (i < n-1) {ierr = MatSetValue(*A,row,row+n,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      if (j > 0)   {ierr = MatSetValue(*A,row,row-1,-1.0 - 1.e-4*row,INSERT_VALUES);CHKERRQ(ierr);}
+      if (j < n-1) {ierr = MatSetValue(*A,row,row+1,-1.0,INSERT_VALUES);CHKERRQ(ierr);}
+      ierr = MatSetValue(*P,row,(i/2)*nc + j/2,1.0,INSERT_VALUES);CHKERRQ(ierr);
+      if (j/2 < nc-1) {ierr = MatSetValue(*P,row,(i/2)*nc + j/2 + 1,0.25/(1.0 + j),INSERT_VALUES);CHKERRQ(ierr);}
+    }
+  }
+  ierr = MatAssemblyBegin(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(*P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(*P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckEqual(const char *op,Mat C,Mat D)
+{
+  PetscBool      equal;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatEqual(C,D,&equal);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"%s: threaded and serial products are %s\n",op,equal ? "identical" : "different");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,P,Pt,AP,C,D,R,E;
+  PetscInt       n = 31;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = CreateMatrices(n,&A,&P);CHKERRQ(ierr);
+
+  /* C = A*A with "threaded", D with the default "sorted" which sums in the same order */
+  ierr = MatProductCreate(A,A,NULL,&C);CHKERRQ(ierr);
+  ierr = MatProductSetType(C,MATPRODUCT_AB);CHKERRQ(ierr);
+  ierr = MatProductSetAlgorithm(C,"threaded");CHKERRQ(ierr);
+  ierr = MatProductSetFromOptions(C);CHKERRQ(ierr);
+  ierr = MatProductSymbolic(C);CHKERRQ(ierr);
+  ierr = MatProductNumeric(C);CHKERRQ(ierr);
+  ierr = MatMatMult(A,A,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&D);CHKERRQ(ierr);
+  ierr = CheckEqual("MatMatMult",C,D);CHKERRQ(ierr);
+
+  /* R = P^T*A*P with "threaded", compared with the products computed one after the other */
+  ierr = MatProductCreate(A,P,NULL,&R);CHKERRQ(ierr);
+  ierr = MatProductSetType(R,MATPRODUCT_PtAP);CHKERRQ(ierr);
+  ierr = MatProductSetAlgorithm(R,"threaded");CHKERRQ(ierr);
+  ierr = MatProductSetFromOptions(R);CHKERRQ(ierr);
+  ierr = MatProductSymbolic(R);CHKERRQ(ierr);
+  ierr = MatProductNumeric(R);CHKERRQ(ierr);
+  ierr = MatTranspose(P,MAT_INITIAL_MATRIX,&Pt);CHKERRQ(ierr);
+  ierr = MatMatMult(A,P,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&AP);CHKERRQ(ierr);
+  ierr = MatMatMult(Pt,AP,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&E);CHKERRQ(ierr);
+  ierr = CheckEqual("MatPtAP",R,E);CHKERRQ(ierr);
+  ierr = MatDestroy(&E);CHKERRQ(ierr);
+  ierr = MatDestroy(&Pt);CHKERRQ(ierr);
+  ierr = MatDestroy(&AP);CHKERRQ(ierr);
+
+  /* reuse the symbolic products with new values */
+  ierr = MatScale(A,2.0);CHKERRQ(ierr);
+  ierr = MatScale(P,-0.5);CHKERRQ(ierr);
+  ierr = MatProductNumeric(C);CHKERRQ(ierr);
+  ierr = MatMatMult(A,A,MAT_REUSE_MATRIX,PETSC_DEFAULT,&D);CHKERRQ(ierr);
+  ierr = CheckEqual("MatMatMult reuse",C,D);CHKERRQ(ierr);
+  ierr = MatProductNumeric(R);CHKERRQ(ierr);
+  ierr = MatTranspose(P,MAT_INITIAL_MATRIX,&Pt);CHKERRQ(ierr);
+  ierr = MatMatMult(A,P,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&AP);CHKERRQ(ierr);
+  ierr = MatMatMult(Pt,AP,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&E);CHKERRQ(ierr);
+  ierr = CheckEqual("MatPtAP reuse",R,E);CHKERRQ(ierr);
+
+  ierr = MatDestroy(&Pt);CHKERRQ(ierr);
+  ierr = MatDestroy(&AP);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&P);CHKERRQ(ierr);
+  ierr = MatDestroy(&C);CHKERRQ(ierr);
+  ierr = MatDestroy(&D);CHKERRQ(ierr);
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  ierr = MatDestroy(&E);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex308_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         requires: openmp
+         args: -mat_aij_omp_threads 3
+      test:
+         suffix: small
+         requires: openmp
+         args: -mat_aij_omp_threads 4 -n 3
+
+TEST*/
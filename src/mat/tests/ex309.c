@@ -0,0 +1,150 @@
+static char help[] = "Tests MatMult(), MatMultAdd() and MatSOR() of AIJ matrices with dense blocks found by -mat_aij_detect_blocks.\n\n";
+
+#include <petscmat.h>
+
+/* block tridiagonal matrix with dense bs x bs blocks and a few more blocks per block row, assembled one entry at a time */
+static PetscErrorCode FillMatrix(Mat A,PetscInt bs)
+{
+  PetscInt       ib,jb,k,r,c,row,col,rstart,rend,mbs,cols[4];
+  PetscScalar    v;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetSize(A,&mbs,NULL);CHKERRQ(ierr);
+  mbs /= bs;
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (ib=rstart/bs; ib<rend/bs; ib++) {
+    cols[0] = ib; cols[1] = ib > 0 ? ib-1 : -1; cols[2] = ib < mbs-1 ? ib+1 : -1; cols[3] = (ib*7+3) % mbs;
+    if (cols[3] == ib || cols[3] == ib-1 || cols[3] == ib+1) cols[3] = -1;
+    for (k=0; k<4; k++) {
+      jb = cols[k];
+      if (jb < 0) continue;
+      for (r=0; r<bs; r++) {
+        for (c=0; c<bs; c++) {
+          row  = ib*bs + r;
+          col  = jb*bs + c;
+          v    = (PetscScalar)(jb == ib ? (r == c ? 4.0*bs : 0.5/(1.0 + r + 2*c)) : -1.0/(1.0 + k + r + c) + 0.001*ib);
+          ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
+        }
+      }
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckDifference(const char *op,Vec x,Vec y,PetscReal tol)
+{
+  PetscReal      norm,ref;
+  Vec            d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+  if (norm > tol*ref) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: difference %g\n",op,(double)norm);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results agree\n",op);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,z,w;
+  PetscInt       mbs = 40,bs = 3;
+  PetscReal      tol = 100*PETSC_MACHINE_EPSILON;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-mbs",&mbs,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-bs",&bs,NULL);CHKERRQ(ierr);
+
+  /* A is MATAIJ and does not know its block size, B is the same matrix as MATBAIJ */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,mbs*bs,mbs*bs);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,4*bs,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,4*bs,NULL,4*bs,NULL);CHKERRQ(ierr);
+  ierr = FillMatrix(A,bs);CHKERRQ(ierr);
+  ierr = MatViewFromOptions(A,NULL,"-view_info");CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,mbs*bs,mbs*bs);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATBAIJ);CHKERRQ(ierr);
+  ierr = MatSeqBAIJSetPreallocation(B,bs,4,NULL);CHKERRQ(ierr);
+  ierr = MatMPIBAIJSetPreallocation(B,bs,4,NULL,4,NULL);CHKERRQ(ierr);
+  ierr = FillMatrix(B,bs);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&w);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rand);CHKERRQ(ierr);
+
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMult",w,y,tol);CHKERRQ(ierr);
+
+  ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultAdd",w,y,tol);CHKERRQ(ierr);
+
+  /* the point block sweeps of MATBAIJ */
+  ierr = VecSet(y,0.0);CHKERRQ(ierr);
+  ierr = VecSet(w,0.0);CHKERRQ(ierr);
+  ierr = MatSOR(A,z,1.0,SOR_LOCAL_SYMMETRIC_SWEEP,0.0,2,1,y);CHKERRQ(ierr);
+  ierr = MatSOR(B,z,1.0,SOR_LOCAL_SYMMETRIC_SWEEP,0.0,2,1,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatSOR",w,y,tol);CHKERRQ(ierr);
+
+  /* the blocks must follow changes of the values */
+  ierr = MatScale(A,-2.0);CHKERRQ(ierr);
+  ierr = MatScale(B,-2.0);CHKERRQ(ierr);
+  ierr = MatShift(A,1.0);CHKERRQ(ierr);
+  ierr = MatShift(B,1.0);CHKERRQ(ierr);
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMult after MatScale",w,y,tol);CHKERRQ(ierr);
+  ierr = VecSet(y,0.0);CHKERRQ(ierr);
+  ierr = VecSet(w,0.0);CHKERRQ(ierr);
+  ierr = MatSOR(A,z,1.0,SOR_LOCAL_FORWARD_SWEEP,0.0,1,1,y);CHKERRQ(ierr);
+  ierr = MatSOR(B,z,1.0,SOR_LOCAL_FORWARD_SWEEP,0.0,1,1,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatSOR after MatScale",w,y,tol);CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      args: -mat_aij_detect_blocks -view_info ::ascii_info
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         args: -bs 2 -mat_no_inode
+      test:
+         suffix: 7
+         args: -bs 7 -mbs 13
+      test:
+         suffix: mpi
+         nsize: 2
+
+TEST*/
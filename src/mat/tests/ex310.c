@@ -0,0 +1,179 @@
+static char help[] = "Tests MATSEQVBAIJ, the matrix type with variable size dense blocks, against MATSEQAIJ.\n\n";
+
+#include <petscksp.h>
+
+/* nodes with 1 to 5 unknowns, each coupled to its neighbors and to a node further away; with lower only the blocks on and left of the diagonal are set */
+static PetscErrorCode FillMatrix(Mat A,PetscInt nb,const PetscInt bsizes[],PetscBool lower)
+{
+  PetscInt       ib,jb,k,r,c,row,col,*boff,nodes[4];
+  PetscScalar    v;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(nb+1,&boff);CHKERRQ(ierr);
+  boff[0] = 0;
+  for (ib=0; ib<nb; ib++) boff[ib+1] = boff[ib] + bsizes[ib];
+  for (ib=0; ib<nb; ib++) {
+    nodes[0] = ib; nodes[1] = ib > 0 ? ib-1 : -1; nodes[2] = ib < nb-1 ? ib+1 : -1; nodes[3] = (ib*7+3) % nb;
+    if (nodes[3] == ib || nodes[3] == ib-1 || nodes[3] == ib+1) nodes[3] = -1;
+    for (k=0; k<4; k++) {
+      jb = nodes[k];
+      if (jb < 0 || (lower && jb > ib)) continue;
+      for (r=0; r<bsizes[ib]; r++) {
+        for (c=0; c<bsizes[jb]; c++) {
+          row  = boff[ib] + r;
+          col  = boff[jb] + c;
+          v    = (PetscScalar)(jb == ib ? (r == c ? 12.0 : 0.5/(1.0 + r + 2*c)) : -1.0/(1.0 + k + r + c) + 0.001*ib);
+          ierr = MatSetValues(A,1,&row,1,&col,&v,INSERT_VALUES);CHKERRQ(ierr);
+        }
+      }
+    }
+  }
+  ierr = PetscFree(boff);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckDifference(const char *op,Vec x,Vec y,PetscReal tol)
+{
+  PetscReal      norm,ref;
+  Vec            d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+  if (norm > tol*ref) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: difference %g\n",op,(double)norm);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results agree\n",op);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* applies the preconditioner of the given type built from A */
+static PetscErrorCode ApplyPC(Mat A,PCType type,Vec b,Vec x)
+{
+  KSP            ksp;
+  PC             pc;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetType(ksp,KSPPREONLY);CHKERRQ(ierr);
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  ierr = PCSetType(pc,type);CHKERRQ(ierr);
+  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B,L;
+  Vec            x,y,z,w;
+  PetscInt       nb = 40,ib,m = 0,*bsizes;
+  PetscReal      tol = 1000*PETSC_MACHINE_EPSILON;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nb",&nb,NULL);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nb,&bsizes);CHKERRQ(ierr);
+  for (ib=0; ib<nb; ib++) {
+    bsizes[ib] = 1 + (ib*3) % 5;
+    m         += bsizes[ib];
+  }
+
+  /* A is MATSEQAIJ with the block sizes attached, B is converted from it, L is the lower block triangular part of A */
+  ierr = MatCreateSeqAIJ(PETSC_COMM_WORLD,m,m,20,NULL,&A);CHKERRQ(ierr);
+  ierr = MatSetVariableBlockSizes(A,nb,bsizes);CHKERRQ(ierr);
+  ierr = FillMatrix(A,nb,bsizes,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatCreateSeqAIJ(PETSC_COMM_WORLD,m,m,20,NULL,&L);CHKERRQ(ierr);
+  ierr = FillMatrix(L,nb,bsizes,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATSEQVBAIJ,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = MatViewFromOptions(B,NULL,"-view_info");CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&w);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rand);CHKERRQ(ierr);
+
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMult",w,y,tol);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,z,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(B,x,z,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultAdd",w,y,tol);CHKERRQ(ierr);
+  ierr = MatMultTranspose(A,x,y);CHKERRQ(ierr);
+  ierr = MatMultTranspose(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMultTranspose",w,y,tol);CHKERRQ(ierr);
+  ierr = MatGetDiagonal(A,y);CHKERRQ(ierr);
+  ierr = MatGetDiagonal(B,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatGetDiagonal",w,y,tol);CHKERRQ(ierr);
+
+  /* a forward block Gauss-Seidel sweep from zero solves with the lower block triangular part */
+  ierr = MatSOR(B,z,1.0,SOR_LOCAL_FORWARD_SWEEP | SOR_ZERO_INITIAL_GUESS,0.0,1,1,w);CHKERRQ(ierr);
+  ierr = MatMult(L,w,y);CHKERRQ(ierr);
+  ierr = CheckDifference("MatSOR forward sweep",z,y,tol);CHKERRQ(ierr);
+
+  /* many symmetric sweeps converge to the solution */
+  ierr = MatSOR(B,z,1.0,SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS,0.0,40,1,w);CHKERRQ(ierr);
+  ierr = MatMult(A,w,y);CHKERRQ(ierr);
+  ierr = CheckDifference("MatSOR symmetric sweeps",z,y,tol);CHKERRQ(ierr);
+
+  /* the inverses of the diagonal blocks */
+  ierr = ApplyPC(A,PCVPBJACOBI,z,y);CHKERRQ(ierr);
+  ierr = ApplyPC(B,PCVPBJACOBI,z,w);CHKERRQ(ierr);
+  ierr = CheckDifference("PCVPBJACOBI",w,y,tol);CHKERRQ(ierr);
+
+  /* block ILU(0) is the point ILU(0) of A since all the blocks are dense */
+  ierr = ApplyPC(A,PCILU,z,y);CHKERRQ(ierr);
+  ierr = ApplyPC(B,PCILU,z,w);CHKERRQ(ierr);
+  ierr = CheckDifference("PCILU",w,y,tol);CHKERRQ(ierr);
+
+  /* new values with the same nonzero structure */
+  ierr = MatScale(A,-2.0);CHKERRQ(ierr);
+  ierr = MatShift(A,1.0);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATSEQVBAIJ,MAT_REUSE_MATRIX,&B);CHKERRQ(ierr);
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMult(B,x,w);CHKERRQ(ierr);
+  ierr = CheckDifference("MatMult after MatConvert reuse",w,y,tol);CHKERRQ(ierr);
+  ierr = MatScale(A,0.5);CHKERRQ(ierr);
+  ierr = MatScale(B,0.5);CHKERRQ(ierr);
+  ierr = ApplyPC(A,PCILU,z,y);CHKERRQ(ierr);
+  ierr = ApplyPC(B,PCILU,z,w);CHKERRQ(ierr);
+  ierr = CheckDifference("PCILU after MatScale",w,y,tol);CHKERRQ(ierr);
+
+  ierr = PetscFree(bsizes);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&L);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      args: -view_info ::ascii_info
+
+   test:
+      suffix: 2
+      args: -nb 7 -view_info
+      filter: grep -v "MPI process"
+
+TEST*/
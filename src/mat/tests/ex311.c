@@ -0,0 +1,120 @@
+static char help[] = "Tests MatMult() of MATMPIAIJ with -mat_mpiaij_mult_overlap against MatMultAdd(), which uses the VecScatter.\n\n";
+
+#include <petscmat.h>
+
+static PetscErrorCode CheckMult(const char *op,Mat A,Vec x)
+{
+  Vec            y,z,w;
+  PetscReal      norm,ref;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreateVecs(A,NULL,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&w);CHKERRQ(ierr);
+  ierr = VecSet(z,0.0);CHKERRQ(ierr);
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = MatMultAdd(A,x,z,w);CHKERRQ(ierr);
+  ierr = VecAXPY(w,-1.0,y);CHKERRQ(ierr);
+  ierr = VecNorm(w,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_INFINITY,&ref);CHKERRQ(ierr);
+  if (norm > 1000*PETSC_MACHINE_EPSILON*ref) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: difference %g\n",op,(double)norm);CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results agree\n",op);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  Vec            x;
+  PetscInt       m = 23,i,j,k,rstart,rend,N,row;
+  PetscScalar    v;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+
+  /* each row couples to its neighbors and to rows spread over all the processes, some rows have no off-process entries */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,m,m,PETSC_DECIDE,PETSC_DECIDE);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSetUp(A);CHKERRQ(ierr);
+  ierr = MatGetSize(A,&N,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    v    = 4.0;
+    ierr = MatSetValues(A,1,&i,1,&i,&v,INSERT_VALUES);CHKERRQ(ierr);
+    for (k=-1; k<=1; k+=2) {
+      j = i+k;
+      if (j < 0 || j >= N) continue;
+      v    = -1.0 - 0.01*i;
+      ierr = MatSetValues(A,1,&i,1,&j,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+    if (i % 3) continue;
+    for (k=1; k<4; k++) {
+      j    = (i*7 + k*N/4 + 5) % N;
+      v    = 0.1*k + 0.001*j;
+      ierr = MatSetValues(A,1,&i,1,&j,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = CheckMult("MatMult",A,x);CHKERRQ(ierr);
+  ierr = CheckMult("MatMult again",A,x);CHKERRQ(ierr);
+
+  /* new values in the same nonzero structure, then new off-process nonzeros */
+  ierr = MatScale(A,-0.5);CHKERRQ(ierr);
+  ierr = CheckMult("MatMult after MatScale",A,x);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  if (rend > rstart) {
+    row  = rstart;
+    j    = (rend + N/2) % N;
+    v    = 2.5;
+    ierr = MatSetValues(A,1,&row,1,&j,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = CheckMult("MatMult after new nonzeros",A,x);CHKERRQ(ierr);
+  ierr = MatViewFromOptions(A,NULL,"-view_info");CHKERRQ(ierr);
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      args: -mat_type mpiaij -mat_mpiaij_mult_overlap
+      output_file: output/ex311_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         nsize: 3
+      test:
+         suffix: 3
+         nsize: 5
+         args: -m 4
+
+   test:
+      suffix: info
+      nsize: 3
+      args: -mat_type mpiaij -mat_mpiaij_mult_overlap -view_info ::ascii_info_detail
+      filter: grep "per neighbor"
+
+TEST*/
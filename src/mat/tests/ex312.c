@@ -0,0 +1,148 @@
+static char help[] = "Tests MatSolve() of LU, ILU, Cholesky and ICC factors of MATSEQAIJ with level scheduled triangular solves, and the iterative ILU.\n\n";
+
+#include <petscmat.h>
+
+/* sweeps > 0 computes the ILU factor and the triangular solves with that many sweeps of the iterative ILU */
+static PetscErrorCode SolveFactor(Mat A,MatFactorType ftype,PetscInt levels,MatOrderingType otype,PetscBool levelsolve,PetscInt sweeps,PetscBool view,Vec b,Vec x)
+{
+  Mat            F;
+  IS             rperm,cperm;
+  MatFactorInfo  info;
+  PetscInt       k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJSetLevelSolve(A,levelsolve);CHKERRQ(ierr);
+  ierr = MatGetOrdering(A,otype,&rperm,&cperm);CHKERRQ(ierr);
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.fill   = 1.0;
+  info.levels = levels;
+  ierr = MatGetFactor(A,MATSOLVERPETSC,ftype,&F);CHKERRQ(ierr);
+  if (sweeps > 0) {ierr = MatSeqAIJSetILUIterative(F,PETSC_TRUE,sweeps,sweeps);CHKERRQ(ierr);}
+  if (ftype == MAT_FACTOR_LU || ftype == MAT_FACTOR_ILU) {
+    if (ftype == MAT_FACTOR_LU) {ierr = MatLUFactorSymbolic(F,A,rperm,cperm,&info);CHKERRQ(ierr);}
+    else {ierr = MatILUFactorSymbolic(F,A,rperm,cperm,&info);CHKERRQ(ierr);}
+  } else {
+    if (ftype == MAT_FACTOR_CHOLESKY) {ierr = MatCholeskyFactorSymbolic(F,A,rperm,&info);CHKERRQ(ierr);}
+    else {ierr = MatICCFactorSymbolic(F,A,rperm,&info);CHKERRQ(ierr);}
+  }
+  /* the second numeric factorization reuses what the first one set up */
+  for (k=0; k<2; k++) {
+    if (ftype == MAT_FACTOR_LU || ftype == MAT_FACTOR_ILU) {ierr = MatLUFactorNumeric(F,A,&info);CHKERRQ(ierr);}
+    else {ierr = MatCholeskyFactorNumeric(F,A,&info);CHKERRQ(ierr);}
+  }
+  ierr = MatSolve(F,b,x);CHKERRQ(ierr);
+  if (view) {
+    ierr = PetscViewerPushFormat(PETSC_VIEWER_STDOUT_SELF,PETSC_VIEWER_ASCII_INFO);CHKERRQ(ierr);
+    ierr = MatView(F,PETSC_VIEWER_STDOUT_SELF);CHKERRQ(ierr);
+    ierr = PetscViewerPopFormat(PETSC_VIEWER_STDOUT_SELF);CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&F);CHKERRQ(ierr);
+  ierr = ISDestroy(&rperm);CHKERRQ(ierr);
+  ierr = ISDestroy(&cperm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A;
+  Vec            b,x,y;
+  PetscInt       m = 10,n,i,j,k,row,col[5],t,sweeps;
+  PetscScalar    v[5];
+  PetscReal      norm,ref,diff[2];
+  PetscRandom    rand;
+  PetscBool      view = PETSC_FALSE;
+  PetscErrorCode ierr;
+  const char     *names[] = {"LU","ILU(0)","ILU(1)","Cholesky","ICC(0)"};
+  MatFactorType  ftypes[] = {MAT_FACTOR_LU,MAT_FACTOR_ILU,MAT_FACTOR_ILU,MAT_FACTOR_CHOLESKY,MAT_FACTOR_ICC};
+  PetscInt       levels[] = {0,0,1,0,0};
+  MatOrderingType otypes[] = {MATORDERINGND,MATORDERINGNATURAL,MATORDERINGNATURAL,MATORDERINGNATURAL,MATORDERINGRCM};
+  const char     *inames[] = {"ILU(0)","ILU(1) with RCM"};
+  PetscInt       ilevels[] = {0,1};
+  MatOrderingType iotypes[] = {MATORDERINGNATURAL,MATORDERINGRCM};
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-view_factor",&view,NULL);CHKERRQ(ierr);
+
+  /* the 2D Laplacian on an m by m grid */
+  n    = m*m;
+  ierr = MatCreate(PETSC_COMM_SELF,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,n,n,n,n);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,5,NULL);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    for (j=0; j<m; j++) {
+      row = i*m+j;
+      k   = 0;
+      col[k] = row; v[k++] = 4.0;
+      if (i > 0)   {col[k] = row-m; v[k++] = -1.0;}
+      if (i < m-1) {col[k] = row+m; v[k++] = -1.0;}
+      if (j > 0)   {col[k] = row-1; v[k++] = -1.0;}
+      if (j < m-1) {col[k] = row+1; v[k++] = -1.0;}
+      ierr = MatSetValues(A,1,&row,k,col,v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_SELF,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(b,rand);CHKERRQ(ierr);
+
+  /* ILU(0) with the natural ordering is set up by MatILUFactorSymbolic_SeqAIJ_ilu0() */
+  for (t=0; t<5; t++) {
+    ierr = SolveFactor(A,ftypes[t],levels[t],otypes[t],PETSC_FALSE,0,PETSC_FALSE,b,x);CHKERRQ(ierr);
+    ierr = SolveFactor(A,ftypes[t],levels[t],otypes[t],PETSC_TRUE,0,view,b,y);CHKERRQ(ierr);
+    ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+    ierr = VecAXPY(y,-1.0,x);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_INFINITY,&norm);CHKERRQ(ierr);
+    if (norm > 1000*PETSC_MACHINE_EPSILON*ref) {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%s: difference %g\n",names[t],(double)norm);CHKERRQ(ierr);
+    } else {
+      ierr = PetscPrintf(PETSC_COMM_SELF,"%s: results agree\n",names[t]);CHKERRQ(ierr);
+    }
+  }
+
+  /* enough sweeps of the iterative ILU give the ILU factor and the exact triangular solves, a few of them an approximation */
+  for (t=0; t<2; t++) {
+    ierr = SolveFactor(A,MAT_FACTOR_ILU,ilevels[t],iotypes[t],PETSC_FALSE,0,PETSC_FALSE,b,x);CHKERRQ(ierr);
+    ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+    for (k=0; k<2; k++) {
+      sweeps = k ? 3 : 64;
+      ierr   = SolveFactor(A,MAT_FACTOR_ILU,ilevels[t],iotypes[t],PETSC_FALSE,sweeps,(PetscBool)(view && k),b,y);CHKERRQ(ierr);
+      ierr   = VecAXPY(y,-1.0,x);CHKERRQ(ierr);
+      ierr   = VecNorm(y,NORM_INFINITY,&norm);CHKERRQ(ierr);
+      diff[k] = norm/ref;
+    }
+    ierr = PetscPrintf(PETSC_COMM_SELF,"iterative %s: %s with 64 sweeps, %s with 3 sweeps\n",inames[t],diff[0] < 1.e-10 ? "results agree" : "results differ",diff[1] < 0.5 ? "close" : "far");CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+
+   test:
+      suffix: 2
+      requires: openmp
+      args: -mat_aij_omp_threads 3
+      output_file: output/ex312_1.out
+
+   test:
+      suffix: view
+      args: -m 6 -view_factor
+
+TEST*/
@@ -10,7 +10,7 @@ int main(int argc,char **argv)
   PetscInt       M,N,Z,i,nrows;
   PetscScalar    one = 1.0;
   PetscReal      fill=2.0;
-  Mat            A,P,C;
+  Mat            A,P,Paij,C;
   PetscScalar    *array,alpha;
   PetscBool      Test_3D=PETSC_FALSE,flg;
   const PetscInt *ia,*ja;
@@ -100,6 +100,11 @@ int main(int argc,char **argv)
     ierr   = MatPtAP(A,P,MAT_REUSE_MATRIX,fill,&C);CHKERRQ(ierr);
   }
 
+  /* Test MAT_REUSE_MATRIX with new values of P, the interpolation is a MAIJ matrix so its AIJ part is scaled */
+  ierr = MatMAIJGetAIJ(P,&Paij);CHKERRQ(ierr);
+  ierr = MatScale(Paij,2.0);CHKERRQ(ierr);
+  ierr = MatPtAP(A,P,MAT_REUSE_MATRIX,fill,&C);CHKERRQ(ierr);
+
   /* Free intermediate data structures created for reuse of C=Pt*A*P */
   ierr = MatFreeIntermediateDataStructures(C);CHKERRQ(ierr);
 
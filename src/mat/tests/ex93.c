@@ -227,4 +227,9 @@ PetscErrorCode testPTAPRectangular(void)
       args: -matmatmult_via scalable_fast
       output_file: output/ex93_1.out
 
+   test:
+      suffix: threaded
+      args: -matmatmult_via threaded -matptap_via threaded
+      output_file: output/ex93_1.out
+
 TEST*/
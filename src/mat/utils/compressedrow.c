@@ -66,3 +66,102 @@ PETSC_EXTERN PetscErrorCode MatCheckCompressedRow(Mat A,PetscInt nrows,Mat_Compr
   }
   PetscFunctionReturn(0);
 }
+
+/*@C
+   MatCheckCompressedIndices - Stores the column indices of each row as the smallest column of the row plus 8 or 16 bit
+      offsets from it, if the columns of every row span few enough columns and this reduces the index storage.
+      This lowers the memory traffic of the matrix-vector product for matrices whose rows couple nearby columns.
+      Supported types are MATAIJ.
+
+   Not Collective
+
+   Input Parameters:
++  A    - the matrix
+.  ci   - pointer to the struct Mat_CompressedIndices, its use field is set to indicate whether the compressed indices are used
+.  ai   - row pointer used by seqaij
+.  aj   - column indices used by seqaij
+-  mbs  - number of rows represented by ai
+
+   Developer Note: The offsets are stored at the same locations as the column indices, that is the offset of aj[k] is
+                   j8[k] or j16[k], so kernels use the row pointers (or those of Mat_CompressedRow) unchanged.
+                   This is not a general public routine and hence is not listed in petscmat.h (it exposes a private data structure)
+
+   Level: developer
+@*/
+PETSC_EXTERN PetscErrorCode MatCheckCompressedIndices(Mat A,Mat_CompressedIndices *ci,const PetscInt *ai,const PetscInt *aj,PetscInt mbs)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,k,nz = mbs ? ai[mbs] : 0,cmin,cmax,span = 0,width;
+  PetscInt64     saved;
+
+  PetscFunctionBegin;
+  /* in case this is being reused, delete old space */
+  ierr = MatDestroyCompressedIndices(ci);CHKERRQ(ierr);
+
+  for (i=0; i<mbs; i++) {
+    if (ai[i+1] == ai[i]) continue;
+    cmin = cmax = aj[ai[i]];
+    for (k=ai[i]+1; k<ai[i+1]; k++) {
+      cmin = PetscMin(cmin,aj[k]);
+      cmax = PetscMax(cmax,aj[k]);
+    }
+    span = PetscMax(span,cmax-cmin);
+  }
+  if (span < 256)        width = 1;
+  else if (span < 65536) width = 2;
+  else {
+    ierr = PetscInfo1(A,"Rows span up to %D columns, too many for 16 bit offsets. Do not use compressed column indices.\n",span);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  saved = (PetscInt64)nz*(PetscInt64)(sizeof(PetscInt)-width) - (PetscInt64)mbs*(PetscInt64)sizeof(PetscInt);
+  if (saved <= 0) {
+    ierr = PetscInfo2(A,"Compressed column indices with %D byte offsets would not save memory for %D nonzeros. Do not use them.\n",width,nz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscInfo3(A,"Rows span up to %D columns. Use compressed column indices with %D byte offsets, MatMult() reads %g fewer bytes.\n",span,width,(double)saved);CHKERRQ(ierr);
+
+  ierr = PetscMalloc1(mbs,&ci->base);CHKERRQ(ierr);
+  if (width == 1) {
+    ierr = PetscMalloc1(nz,&ci->j8);CHKERRQ(ierr);
+  } else {
+    ierr = PetscMalloc1(nz,&ci->j16);CHKERRQ(ierr);
+  }
+  ierr = PetscLogObjectMemory((PetscObject)A,mbs*sizeof(PetscInt)+nz*width);CHKERRQ(ierr);
+  for (i=0; i<mbs; i++) {
+    cmin = ai[i+1] > ai[i] ? aj[ai[i]] : 0;
+    for (k=ai[i]+1; k<ai[i+1]; k++) cmin = PetscMin(cmin,aj[k]);
+    ci->base[i] = cmin;
+    if (width == 1) for (k=ai[i]; k<ai[i+1]; k++) ci->j8[k]  = (unsigned char)(aj[k]-cmin);
+    else            for (k=ai[i]; k<ai[i+1]; k++) ci->j16[k] = (unsigned short)(aj[k]-cmin);
+  }
+  ci->use   = PETSC_TRUE;
+  ci->width = width;
+  ci->saved = (PetscInt)PetscMin(saved,PETSC_MAX_INT);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatDestroyCompressedIndices - Frees the space used by Mat_CompressedIndices and marks it as not used
+
+   Not Collective
+
+   Input Parameter:
+.  ci - pointer to the struct Mat_CompressedIndices
+
+   Level: developer
+
+.seealso: MatCheckCompressedIndices()
+@*/
+PETSC_EXTERN PetscErrorCode MatDestroyCompressedIndices(Mat_CompressedIndices *ci)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(ci->base);CHKERRQ(ierr);
+  ierr = PetscFree(ci->j8);CHKERRQ(ierr);
+  ierr = PetscFree(ci->j16);CHKERRQ(ierr);
+  ci->use   = PETSC_FALSE;
+  ci->width = 0;
+  ci->saved = 0;
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,255 @@
+/*
+   Assembly of AIJ matrices that were not preallocated: MatSetValues() collects the entries in a hash table and the first
+   final assembly computes the exact preallocation from it, inserts the entries row by row in sorted order and then
+   assembles the matrix with the operations of its type, which it uses from then on.
+*/
+#include <petsc/private/matimpl.h>
+#include <petsc/private/hashmapijv.h>
+
+struct _n_MatHash {
+  PetscHMapIJV   ht;                                   /* (row,column) -> value of the locally owned rows */
+  struct _MatOps ops;                                  /* operations of the matrix type, restored by the first final assembly */
+  PetscInt       opts[MAT_OPTION_MAX-MAT_OPTION_MIN];  /* value given to MatSetOption(), or -1, replayed after the preallocation */
+};
+
+#define MatHashGetOption(h,op) ((h)->opts[(op)-MAT_OPTION_MIN])
+
+static PetscErrorCode MatSetValues_Hash(Mat A,PetscInt m,const PetscInt im[],PetscInt n,const PetscInt in[],const PetscScalar v[],InsertMode addv)
+{
+  MatHash        h = A->hash;
+  PetscInt       i,j,rstart = A->rmap->rstart,rend = A->rmap->rend;
+  PetscBool      roworiented       = (PetscBool)(MatHashGetOption(h,MAT_ROW_ORIENTED) != 0);
+  PetscBool      ignorezeroentries = (PetscBool)(MatHashGetOption(h,MAT_IGNORE_ZERO_ENTRIES) == 1);
+  PetscBool      donotstash        = (PetscBool)(MatHashGetOption(h,MAT_IGNORE_OFF_PROC_ENTRIES) == 1);
+  PetscHashIJKey key;
+  PetscScalar    value = 0.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<m; i++) {
+    if (im[i] < 0) continue;
+    if (PetscUnlikelyDebug(im[i] >= A->rmap->N)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row too large: row %D max %D",im[i],A->rmap->N-1);
+    if (im[i] >= rstart && im[i] < rend) {
+      key.i = im[i];
+      for (j=0; j<n; j++) {
+        if (in[j] < 0) continue;
+        if (PetscUnlikelyDebug(in[j] >= A->cmap->N)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column too large: col %D max %D",in[j],A->cmap->N-1);
+        key.j = in[j];
+        if (v) value = roworiented ? v[i*n+j] : v[i+j*m];
+        if (ignorezeroentries && value == 0.0 && addv == ADD_VALUES && key.i != key.j) continue;
+        if (addv == ADD_VALUES) {
+          ierr = PetscHMapIJVAddValue(h->ht,key,value);CHKERRQ(ierr);
+        } else {
+          ierr = PetscHMapIJVSet(h->ht,key,value);CHKERRQ(ierr);
+        }
+      }
+    } else {
+      if (A->nooffprocentries) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Setting off process row %D even though MatSetOption(,MAT_NO_OFF_PROC_ENTRIES,PETSC_TRUE) was set",im[i]);
+      if (!donotstash) {
+        A->assembled = PETSC_FALSE;
+        if (roworiented) {
+          ierr = MatStashValuesRow_Private(&A->stash,im[i],n,in,v+i*n,(PetscBool)(ignorezeroentries && (addv == ADD_VALUES)));CHKERRQ(ierr);
+        } else {
+          ierr = MatStashValuesCol_Private(&A->stash,im[i],n,in,v+i,m,(PetscBool)(ignorezeroentries && (addv == ADD_VALUES)));CHKERRQ(ierr);
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetOption_Hash(Mat A,MatOption op,PetscBool flg)
+{
+  PetscFunctionBegin;
+  MatHashGetOption(A->hash,op) = flg;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatZeroEntries_Hash(Mat A)
+{
+  MatHash        h = A->hash;
+  PetscHashIter  hi;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscHashIterBegin(h->ht,hi);
+  while (!PetscHashIterAtEnd(h->ht,hi)) {
+    ierr = PetscHMapIJVIterSet(h->ht,hi,0.0);CHKERRQ(ierr);
+    PetscHashIterNext(h->ht,hi);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatHashDestroy_Private(Mat A)
+{
+  MatHash        h = A->hash;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMemcpy(A->ops,&h->ops,sizeof(struct _MatOps));CHKERRQ(ierr);
+  ierr = PetscHMapIJVDestroy(&h->ht);CHKERRQ(ierr);
+  ierr = PetscFree(A->hash);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_Hash(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatHashDestroy_Private(A);CHKERRQ(ierr);
+  ierr = (*A->ops->destroy)(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* off-process entries are only communicated in parallel and unless the user promised there are none */
+static PetscErrorCode MatHashUseStash_Private(Mat A,PetscBool *usestash)
+{
+  PetscMPIInt    size;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr      = MPI_Comm_size(PetscObjectComm((PetscObject)A),&size);CHKERRQ(ierr);
+  *usestash = (PetscBool)(size > 1 && !A->nooffprocentries && MatHashGetOption(A->hash,MAT_IGNORE_OFF_PROC_ENTRIES) != 1);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyBegin_Hash(Mat A,MatAssemblyType type)
+{
+  PetscInt       nstash,reallocs;
+  PetscBool      usestash;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatHashUseStash_Private(A,&usestash);CHKERRQ(ierr);
+  if (!usestash) PetscFunctionReturn(0);
+  ierr = MatStashScatterBegin_Private(A,&A->stash,A->rmap->range);CHKERRQ(ierr);
+  ierr = MatStashGetInfo_Private(&A->stash,&nstash,&reallocs);CHKERRQ(ierr);
+  ierr = PetscInfo2(A,"Stash has %D entries, uses %D mallocs.\n",nstash,reallocs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatAssemblyEnd_Hash(Mat A,MatAssemblyType type)
+{
+  MatHash        h = A->hash;
+  PetscHashIter  hi;
+  PetscHashIJKey key;
+  PetscScalar    *val,*vals;
+  PetscInt       *row,*col,*dnz,*onz,*ii,*jj,*next;
+  PetscInt       i,j,r,k,rstart,grow,ncols,flg,nz,m = A->rmap->n;
+  PetscInt       cstart = A->cmap->rstart,cend = A->cmap->rend;
+  PetscInt       opts[MAT_OPTION_MAX-MAT_OPTION_MIN];
+  PetscMPIInt    n;
+  PetscBool      usestash;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatHashUseStash_Private(A,&usestash);CHKERRQ(ierr);
+  if (usestash) {
+    while (1) {
+      ierr = MatStashScatterGetMesg_Private(&A->stash,&n,&row,&col,&val,&flg);CHKERRQ(ierr);
+      if (!flg) break;
+
+      for (i=0; i<n; ) {
+        /* Now identify the consecutive vals belonging to the same row */
+        for (j=i,rstart=row[j]; j<n; j++) {
+          if (row[j] != rstart) break;
+        }
+        if (j < n) ncols = j-i;
+        else       ncols = n-i;
+        /* Now assemble all these values with a single function call */
+        ierr = MatSetValues_Hash(A,1,row+i,ncols,col+i,val+i,A->insertmode);CHKERRQ(ierr);
+        i    = j;
+      }
+    }
+    ierr = MatStashScatterEnd_Private(&A->stash);CHKERRQ(ierr);
+  }
+  if (type == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* count the entries of each row in the diagonal and off-diagonal blocks and sort them into CSR */
+  rstart = A->rmap->rstart;
+  ierr   = PetscHMapIJVGetSize(h->ht,&nz);CHKERRQ(ierr);
+  ierr   = PetscCalloc2(m,&dnz,m,&onz);CHKERRQ(ierr);
+  ierr   = PetscMalloc4(m+1,&ii,m,&next,nz,&jj,nz,&vals);CHKERRQ(ierr);
+  PetscHashIterBegin(h->ht,hi);
+  while (!PetscHashIterAtEnd(h->ht,hi)) {
+    PetscHashIterGetKey(h->ht,hi,key);
+    if (key.j >= cstart && key.j < cend) dnz[key.i-rstart]++;
+    else onz[key.i-rstart]++;
+    PetscHashIterNext(h->ht,hi);
+  }
+  ii[0] = 0;
+  for (r=0; r<m; r++) {
+    ii[r+1] = ii[r] + dnz[r] + onz[r];
+    next[r] = ii[r];
+  }
+  PetscHashIterBegin(h->ht,hi);
+  while (!PetscHashIterAtEnd(h->ht,hi)) {
+    PetscHashIterGetKey(h->ht,hi,key);
+    k       = next[key.i-rstart]++;
+    jj[k]   = key.j;
+    PetscHashIterGetVal(h->ht,hi,vals[k]);
+    PetscHashIterNext(h->ht,hi);
+  }
+  for (r=0; r<m; r++) {
+    ierr = PetscSortIntWithScalarArray(ii[r+1]-ii[r],jj+ii[r],vals+ii[r]);CHKERRQ(ierr);
+  }
+  ierr = PetscInfo1(A,"Preallocating %D nonzeros found in the hash table\n",nz);CHKERRQ(ierr);
+
+  /* switch to the operations of the matrix type, which only sees the exactly preallocated matrix */
+  ierr = PetscArraycpy(opts,h->opts,MAT_OPTION_MAX-MAT_OPTION_MIN);CHKERRQ(ierr);
+  ierr = MatHashDestroy_Private(A);CHKERRQ(ierr);
+  A->preallocated = PETSC_FALSE;
+  ierr = MatXAIJSetPreallocation(A,1,dnz,onz,NULL,NULL);CHKERRQ(ierr);
+  for (r=0; r<m; r++) {
+    grow = rstart + r;
+    ierr = (*A->ops->setvalues)(A,1,&grow,ii[r+1]-ii[r],jj+ii[r],vals+ii[r],INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(dnz,onz);CHKERRQ(ierr);
+  ierr = PetscFree4(ii,next,jj,vals);CHKERRQ(ierr);
+
+  /* later new nonzeros are allowed, as for a matrix that was not preallocated, unless the options given before say otherwise */
+  ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+  for (k=0; k<MAT_OPTION_MAX-MAT_OPTION_MIN; k++) {
+    if (opts[k] < 0) continue;
+    ierr = MatSetOption(A,(MatOption)(k+MAT_OPTION_MIN),(PetscBool)opts[k]);CHKERRQ(ierr);
+  }
+  if (A->ops->assemblybegin) {
+    ierr = (*A->ops->assemblybegin)(A,type);CHKERRQ(ierr);
+  }
+  if (A->ops->assemblyend) {
+    ierr = (*A->ops->assemblyend)(A,type);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatSetUpHash_Private - Called by MatSetUp() of AIJ matrices instead of the default preallocation when
+   -mat_aij_hash_assembly is given. Until the first MAT_FINAL_ASSEMBLY only MatSetValues() (and what is built on it),
+   MatSetOption(), MatZeroEntries() and the assembly are available.
+*/
+PetscErrorCode MatSetUpHash_Private(Mat A)
+{
+  MatHash        h;
+  PetscInt       k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  ierr = PetscNew(&h);CHKERRQ(ierr);
+  ierr = PetscHMapIJVCreate(&h->ht);CHKERRQ(ierr);
+  for (k=0; k<MAT_OPTION_MAX-MAT_OPTION_MIN; k++) h->opts[k] = -1;
+  ierr = PetscMemcpy(&h->ops,A->ops,sizeof(struct _MatOps));CHKERRQ(ierr);
+  ierr = PetscMemzero(A->ops,sizeof(struct _MatOps));CHKERRQ(ierr);
+  A->ops->setvalues     = MatSetValues_Hash;
+  A->ops->setoption     = MatSetOption_Hash;
+  A->ops->zeroentries   = MatZeroEntries_Hash;
+  A->ops->assemblybegin = MatAssemblyBegin_Hash;
+  A->ops->assemblyend   = MatAssemblyEnd_Hash;
+  A->ops->destroy       = MatDestroy_Hash;
+  A->ops->setblocksizes = h->ops.setblocksizes;
+  A->hash               = h;
+  ierr = PetscInfo(A,"Collecting the entries in a hash table until the first final assembly\n");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
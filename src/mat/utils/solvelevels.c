@@ -0,0 +1,242 @@
+/*
+   Level scheduled triangular solves: the rows of a sweep of MatSolve() of a factor are grouped in levels such that the
+   rows of a level only depend on rows of earlier levels, so the rows of each level can be solved in parallel. The entries
+   of the rows are copied in level order so that each thread reads consecutive memory.
+*/
+#include <petsc/private/matimpl.h>  /*I   "petscmat.h"  I*/
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+static PetscErrorCode MatSolveLevelsDestroySweep_Private(Mat_SolveLevels *sl,PetscInt s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(sl->level[s],sl->row[s]);CHKERRQ(ierr);
+  ierr = PetscFree4(sl->i[s],sl->j[s],sl->a[s],sl->pos[s]);CHKERRQ(ierr);
+  sl->nrows[s]   = 0;
+  sl->nlevels[s] = 0;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatSolveLevelsSetUp - Computes the levels of one sweep of the triangular solves of a factor and stores its rows in level order
+
+   Not Collective
+
+   Input Parameters:
++  A        - the factored matrix, used for logging
+.  sl       - pointer to the struct Mat_SolveLevels
+.  s        - the sweep, 0 for the forward solve and 1 for the backward solve
+.  n        - the number of rows
+.  ii       - the entries of row r, without its diagonal, are ii[r] to ii[r+1]-1
+.  jj       - column of each entry
+.  pos      - position of each entry in the values of the factor, or NULL if it is the entry number
+.  diag     - position of the inverse of the diagonal entry of each row in the values of the factor, or NULL for a unit diagonal
+.  backward - the rows depend on the rows after them instead of on the rows before them
+-  negate   - the rows are solved with the negated values of the factor
+
+   Developer Note: A sweep computes x[r] = (x[r] - sum_k a[pos[k]] x[jj[k]]) a[diag[r]] row by row, or with + instead of - if negate.
+                   The level of a row is one more than the largest level of the rows it depends on. The values are copied by
+                   MatSolveLevelsSetValues() after each numeric factorization, with the same structure the levels are reused.
+                   This is not a general public routine and hence is not listed in petscmat.h (it exposes a private data structure)
+
+   Level: developer
+
+.seealso: MatSolveLevelsSetValues(), MatSolveLevelsSweep(), MatDestroySolveLevels()
+@*/
+PETSC_EXTERN PetscErrorCode MatSolveLevelsSetUp(Mat A,Mat_SolveLevels *sl,PetscInt s,PetscInt n,const PetscInt *ii,const PetscInt *jj,const PetscInt *pos,const PetscInt *diag,PetscBool backward,PetscBool negate)
+{
+  PetscErrorCode ierr;
+  PetscInt       r,k,p,q,nz = n ? ii[n] : 0,nlevels = 0,*lev,*cnt,*level,*row;
+
+  PetscFunctionBegin;
+  if (s < 0 || s > 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Sweep %D must be 0 or 1",s);
+  ierr = MatSolveLevelsDestroySweep_Private(sl,s);CHKERRQ(ierr);
+
+  /* the level of each row, in the order the rows are solved */
+  ierr = PetscMalloc1(n,&lev);CHKERRQ(ierr);
+  for (q=0; q<n; q++) {
+    r      = backward ? n-1-q : q;
+    lev[r] = 0;
+    for (k=ii[r]; k<ii[r+1]; k++) lev[r] = PetscMax(lev[r],lev[jj[k]]+1);
+    nlevels = PetscMax(nlevels,lev[r]+1);
+  }
+
+  /* the rows of each level in increasing order */
+  ierr = PetscMalloc2(nlevels+1,&level,n,&row);CHKERRQ(ierr);
+  ierr = PetscCalloc1(nlevels+1,&cnt);CHKERRQ(ierr);
+  for (r=0; r<n; r++) cnt[lev[r]+1]++;
+  for (k=0; k<nlevels; k++) cnt[k+1] += cnt[k];
+  ierr = PetscArraycpy(level,cnt,nlevels+1);CHKERRQ(ierr);
+  for (r=0; r<n; r++) row[cnt[lev[r]]++] = r;
+  ierr = PetscFree(cnt);CHKERRQ(ierr);
+  ierr = PetscFree(lev);CHKERRQ(ierr);
+
+  /* the entries of the rows in level order, each row followed by the inverse of its diagonal */
+  if (diag) nz += n;
+  ierr = PetscMalloc4(n+1,&sl->i[s],nz,&sl->j[s],nz,&sl->a[s],nz,&sl->pos[s]);CHKERRQ(ierr);
+  sl->i[s][0] = 0;
+  for (q=0,p=0; q<n; q++) {
+    r = row[q];
+    for (k=ii[r]; k<ii[r+1]; k++,p++) {
+      sl->j[s][p]   = jj[k];
+      sl->pos[s][p] = pos ? pos[k] : k;
+    }
+    if (diag) {
+      sl->j[s][p]   = r;
+      sl->pos[s][p] = diag[r];
+      p++;
+    }
+    sl->i[s][q+1] = p;
+  }
+  ierr = PetscLogObjectMemory((PetscObject)A,(nlevels+2*n+1+3*nz)*sizeof(PetscInt)+nz*sizeof(MatScalar));CHKERRQ(ierr);
+  ierr = PetscInfo4(A,"%s solve of %D rows in %D levels, %g rows per level on average\n",s ? "Backward" : "Forward",n,nlevels,nlevels ? (double)n/nlevels : 0.0);CHKERRQ(ierr);
+
+  sl->nrows[s]   = n;
+  sl->nlevels[s] = nlevels;
+  sl->level[s]   = level;
+  sl->row[s]     = row;
+  sl->diag[s]    = diag ? PETSC_TRUE : PETSC_FALSE;
+  sl->negate[s]  = negate;
+  sl->use        = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatSolveLevelsSetValues - Copies the values of a factor to the level ordered rows of its sweeps
+
+   Not Collective
+
+   Input Parameters:
++  sl - pointer to the struct Mat_SolveLevels
+-  aa - the values of the factor
+
+   Level: developer
+
+.seealso: MatSolveLevelsSetUp()
+@*/
+PETSC_EXTERN PetscErrorCode MatSolveLevelsSetValues(Mat_SolveLevels *sl,const MatScalar *aa)
+{
+  PetscInt s,k,nz;
+
+  PetscFunctionBegin;
+  for (s=0; s<2; s++) {
+    const PetscInt *pos = sl->pos[s];
+    MatScalar      *a   = sl->a[s];
+
+    if (!sl->row[s]) continue;
+    nz = sl->i[s][sl->nrows[s]];
+    if (sl->negate[s]) {
+      /* the inverses of the diagonal are not negated */
+      PetscInt q,last;
+
+      for (k=0; k<nz; k++) a[k] = -aa[pos[k]];
+      if (sl->diag[s]) for (q=0; q<sl->nrows[s]; q++) {last = sl->i[s][q+1]-1; a[last] = aa[pos[last]];}
+    } else {
+      for (k=0; k<nz; k++) a[k] = aa[pos[k]];
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* solves row k of the level ordering of a sweep */
+#define MatSolveLevelsRow_Private(k) do {                                     \
+    const PetscInt  _r = row[k],_e = diag ? ii[(k)+1]-1 : ii[(k)+1];          \
+    PetscScalar     _sum = x[_r];                                              \
+    PetscInt        _p;                                                        \
+    for (_p=ii[k]; _p<_e; _p++) _sum -= aa[_p]*x[jj[_p]];                      \
+    x[_r] = diag ? _sum*aa[_e] : _sum;                                         \
+  } while (0)
+
+/*@C
+   MatSolveLevelsSweep - Solves one sweep of the triangular solves of a factor in place, level by level
+
+   Not Collective
+
+   Input Parameters:
++  sl - pointer to the struct Mat_SolveLevels
+.  s  - the sweep, 0 for the forward solve and 1 for the backward solve
+-  x  - the right hand side, overwritten by the solution
+
+   Developer Note: With sl->nthreads > 1 the rows of each level are shared by that many OpenMP threads, which wait for each
+                   other at the end of each level; otherwise the rows are solved one after the other in level order.
+
+   Level: developer
+
+.seealso: MatSolveLevelsSetUp()
+@*/
+PETSC_EXTERN PetscErrorCode MatSolveLevelsSweep(Mat_SolveLevels *sl,PetscInt s,PetscScalar *x)
+{
+  const PetscInt  n = sl->nrows[s],*row = sl->row[s],*ii = sl->i[s],*jj = sl->j[s];
+  const MatScalar *aa = sl->a[s];
+  const PetscBool diag = sl->diag[s];
+  PetscInt        k;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  if (sl->nthreads > 1) {
+    const PetscInt nlevels = sl->nlevels[s],*level = sl->level[s];
+
+#pragma omp parallel num_threads(sl->nthreads)
+    {
+      PetscInt l,q;
+
+      for (l=0; l<nlevels; l++) {
+#pragma omp for schedule(static)
+        for (q=level[l]; q<level[l+1]; q++) MatSolveLevelsRow_Private(q);
+      }
+    }
+    PetscFunctionReturn(0);
+  }
+#endif
+  for (k=0; k<n; k++) MatSolveLevelsRow_Private(k);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatSolveLevelsView - Prints the number of levels of the sweeps of a factor
+
+   Not Collective
+
+   Input Parameters:
++  sl     - pointer to the struct Mat_SolveLevels
+-  viewer - an ASCII viewer
+
+   Level: developer
+
+.seealso: MatSolveLevelsSetUp()
+@*/
+PETSC_EXTERN PetscErrorCode MatSolveLevelsView(Mat_SolveLevels *sl,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!sl->use) PetscFunctionReturn(0);
+  ierr = PetscViewerASCIIPrintf(viewer,"using level scheduled triangular solves with %D threads: %D levels in the forward solve and %D in the backward solve, %g and %g rows per level on average\n",sl->nthreads,sl->nlevels[0],sl->nlevels[1],sl->nlevels[0] ? (double)sl->nrows[0]/sl->nlevels[0] : 0.0,sl->nlevels[1] ? (double)sl->nrows[1]/sl->nlevels[1] : 0.0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatDestroySolveLevels - Frees the space used by Mat_SolveLevels and marks it as not used
+
+   Not Collective
+
+   Input Parameter:
+.  sl - pointer to the struct Mat_SolveLevels
+
+   Level: developer
+
+.seealso: MatSolveLevelsSetUp()
+@*/
+PETSC_EXTERN PetscErrorCode MatDestroySolveLevels(Mat_SolveLevels *sl)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr    = MatSolveLevelsDestroySweep_Private(sl,0);CHKERRQ(ierr);
+  ierr    = MatSolveLevelsDestroySweep_Private(sl,1);CHKERRQ(ierr);
+  sl->use = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
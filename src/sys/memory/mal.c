@@ -2,7 +2,17 @@
     Code that allows a user to dictate what malloc() PETSc uses.
 */
 #include <petscsys.h>             /*I   "petscsys.h"   I*/
+#include <petsc/private/petscimpl.h>
 #include <stdarg.h>
+#if defined(PETSC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+#if defined(PETSC_HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
 #if defined(PETSC_HAVE_MALLOC_H)
 #include <malloc.h>
 #endif
@@ -23,11 +33,141 @@ PetscMemkindType previousmktype = PETSC_MK_HBW_PREFERRED;
 */
 #define SHIFT_CLASSID 456123
 
+/*
+    Arrays of at least petschugepagethreshold bytes allocated between PetscMallocPushHugePage() and PetscMallocPopHugePage()
+  are mapped directly with mmap(), either from the huge page pool (MAP_HUGETLB) or as ordinary pages the kernel is advised
+  to back with transparent huge pages, with the start aligned to a huge page. The pages are then touched by the OpenMP
+  threads with a static split, so that on NUMA systems each part of the array is on the memory of the socket of the
+  thread that touches it, as it would be for a loop with schedule(static) over the array. PetscFreeAlign() recognizes
+  these arrays from the list of mapped regions below, which only holds large arrays so it is searched linearly.
+*/
+const char *const PetscMallocHugePageTypes[] = {"none","thp","hugetlb","PetscMallocHugePageType","PETSC_MALLOC_HUGEPAGE_",0};
+
+#if defined(PETSC_HAVE_MMAP) && defined(PETSC_HAVE_GETPAGESIZE) && defined(MAP_ANONYMOUS)
+#define MALLOC_HUGEPAGE_MMAP
+#define PETSC_HUGEPAGE_SIZE     (2*1024*1024)
+#define PETSC_HUGEPAGE_MAXNODES 64
+
+typedef struct {
+  char   *addr;
+  size_t len;
+  int    hugetlb;
+} PetscHugePageRegion;
+
+static PetscMallocHugePageType petschugepagetype      = PETSC_MALLOC_HUGEPAGE_NONE;
+static size_t                  petschugepagethreshold = PETSC_HUGEPAGE_SIZE;
+static int                     petschugepagedepth     = 0;
+static PetscHugePageRegion     *petschugepageregions  = NULL;
+static int                     petschugepagen = 0,petschugepagemaxn = 0;
+static PetscLogDouble          petschugepagecount = 0,petschugepagebytes = 0,petschugepagemaxbytes = 0,petschugepagehugetlbbytes = 0,petschugepagefailed = 0;
+static PetscLogDouble          petschugepagenodebytes[PETSC_HUGEPAGE_MAXNODES+1]; /* the last entry counts the bytes of pages that were never touched */
+
+/* Adds to petschugepagenodebytes[] the NUMA node of one page per huge page of the region */
+static void PetscHugePageSample_Private(PetscHugePageRegion *r)
+{
+#if defined(__linux__) && defined(SYS_move_pages)
+  void   *pages[64];
+  int    status[64];
+  size_t off = 0,k,n;
+
+  while (off < r->len) {
+    for (n=0; n<64 && off+n*PETSC_HUGEPAGE_SIZE < r->len; n++) pages[n] = r->addr + off + n*PETSC_HUGEPAGE_SIZE;
+    if (syscall(SYS_move_pages,0,(unsigned long)n,pages,NULL,status,0)) return;
+    for (k=0; k<n; k++) {
+      size_t bytes = PetscMin((size_t)PETSC_HUGEPAGE_SIZE,r->len - (off + k*PETSC_HUGEPAGE_SIZE));
+      if (status[k] >= 0 && status[k] < PETSC_HUGEPAGE_MAXNODES) petschugepagenodebytes[status[k]] += bytes;
+      else petschugepagenodebytes[PETSC_HUGEPAGE_MAXNODES] += bytes;
+    }
+    off += n*PETSC_HUGEPAGE_SIZE;
+  }
+#endif
+}
+
+static void *PetscMallocHugePage_Private(size_t mem)
+{
+  size_t              pagesize = (size_t)getpagesize(),len = ((mem + pagesize-1)/pagesize)*pagesize;
+  char                *addr = NULL;
+  int                 hugetlb = 0;
+  PetscHugePageRegion *regions;
+
+#if defined(MAP_HUGETLB)
+  if (petschugepagetype == PETSC_MALLOC_HUGEPAGE_HUGETLB) {
+    size_t hlen = ((mem + PETSC_HUGEPAGE_SIZE-1)/PETSC_HUGEPAGE_SIZE)*PETSC_HUGEPAGE_SIZE;
+
+    addr = (char*)mmap(NULL,hlen,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+    if (addr == (char*)MAP_FAILED) {addr = NULL; petschugepagefailed++;}
+    else {len = hlen; hugetlb = 1;}
+  }
+#endif
+  if (!addr) {
+    /* map one huge page more than needed and unmap what lies before and after the aligned part */
+    char *base = (char*)mmap(NULL,len + PETSC_HUGEPAGE_SIZE,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (base == (char*)MAP_FAILED) return NULL;
+    addr = (char*)(((PETSC_UINTPTR_T)base + PETSC_HUGEPAGE_SIZE-1) & ~(PETSC_UINTPTR_T)(PETSC_HUGEPAGE_SIZE-1));
+    if (addr > base) munmap(base,addr - base);
+    if (base + PETSC_HUGEPAGE_SIZE > addr) munmap(addr + len,base + PETSC_HUGEPAGE_SIZE - addr);
+#if defined(MADV_HUGEPAGE)
+    (void)madvise(addr,len,MADV_HUGEPAGE);
+#endif
+  }
+  if (petschugepagen == petschugepagemaxn) {
+    regions = (PetscHugePageRegion*)realloc(petschugepageregions,(2*petschugepagemaxn+16)*sizeof(PetscHugePageRegion));
+    if (!regions) {munmap(addr,len); return NULL;}
+    petschugepageregions = regions;
+    petschugepagemaxn    = 2*petschugepagemaxn+16;
+  }
+  petschugepageregions[petschugepagen].addr    = addr;
+  petschugepageregions[petschugepagen].len     = len;
+  petschugepageregions[petschugepagen].hugetlb = hugetlb;
+  petschugepagen++;
+  petschugepagecount++;
+  petschugepagebytes        += len;
+  petschugepagemaxbytes      = PetscMax(petschugepagemaxbytes,petschugepagebytes);
+  if (hugetlb) petschugepagehugetlbbytes += len;
+#if defined(PETSC_HAVE_OPENMP)
+  {
+    PetscInt64 k,npages = (PetscInt64)(len/pagesize);
+#pragma omp parallel for schedule(static)
+    for (k=0; k<npages; k++) addr[k*pagesize] = 0;
+  }
+#endif
+  return addr;
+}
+
+/* Returns the index of the mapped region starting at ptr or -1; the regions are page aligned, other pointers are skipped quickly */
+static int PetscHugePageFind_Private(void *ptr)
+{
+  int k;
+
+  if (!petschugepagen || ((PETSC_UINTPTR_T)ptr & (PETSC_UINTPTR_T)(getpagesize()-1))) return -1;
+  for (k=0; k<petschugepagen; k++) if (petschugepageregions[k].addr == (char*)ptr) return k;
+  return -1;
+}
+
+static PetscErrorCode PetscFreeHugePage_Private(int k,int line,const char func[],const char file[])
+{
+  PetscHugePageRegion r = petschugepageregions[k];
+
+  PetscHugePageSample_Private(&r);
+  petschugepageregions[k] = petschugepageregions[--petschugepagen];
+  petschugepagebytes     -= r.len;
+  if (munmap(r.addr,r.len)) return PetscError(PETSC_COMM_SELF,line,func,file,PETSC_ERR_SYS,PETSC_ERROR_INITIAL,"munmap() failed on a huge page array");
+  return 0;
+}
+#endif
+
 PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,PetscBool clear,int line,const char func[],const char file[],void **result)
 {
   PetscErrorCode ierr;
 
   if (!mem) {*result = NULL; return 0;}
+#if defined(MALLOC_HUGEPAGE_MMAP)
+  /* the mapped pages are zero, so clear needs no memset; fall back to malloc() if mmap() fails */
+  if (petschugepagedepth && petschugepagetype && mem >= petschugepagethreshold) {
+    *result = PetscMallocHugePage_Private(mem);
+    if (*result) return 0;
+  }
+#endif
 #if defined(PETSC_HAVE_MEMKIND)
   {
     if (!currentmktype) ierr = memkind_posix_memalign(MEMKIND_DEFAULT,result,PETSC_MEMALIGN,mem);
@@ -82,6 +222,12 @@ PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t mem,PetscBool clear,int line
 PETSC_EXTERN PetscErrorCode PetscFreeAlign(void *ptr,int line,const char func[],const char file[])
 {
   if (!ptr) return 0;
+#if defined(MALLOC_HUGEPAGE_MMAP)
+  {
+    int k = PetscHugePageFind_Private(ptr);
+    if (k >= 0) return PetscFreeHugePage_Private(k,line,func,file);
+  }
+#endif
 #if defined(PETSC_HAVE_MEMKIND)
   memkind_free(0,ptr); /* specify the kind to 0 so that memkind will look up for the right type */
 #else
@@ -118,6 +264,23 @@ PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t mem, int line, const char f
     *result = NULL;
     return 0;
   }
+#if defined(MALLOC_HUGEPAGE_MMAP)
+  {
+    int k = PetscHugePageFind_Private(*result);
+    if (k >= 0) {
+      void *newResult;
+
+      ierr = PetscMallocAlign(mem,PETSC_FALSE,line,func,file,&newResult);
+      if (ierr) return ierr;
+      ierr = PetscMemcpy(newResult,*result,PetscMin(mem,petschugepageregions[k].len));
+      if (ierr) return ierr;
+      ierr = PetscFreeHugePage_Private(k,line,func,file);
+      if (ierr) return ierr;
+      *result = newResult;
+      return 0;
+    }
+  }
+#endif
 #if defined(PETSC_HAVE_MEMKIND)
   if (!currentmktype) *result = memkind_realloc(MEMKIND_DEFAULT,*result,mem);
   else *result = memkind_realloc(MEMKIND_HBW_PREFERRED,*result,mem);
@@ -334,6 +497,381 @@ PetscErrorCode PetscMallocResetDRAM(void)
   PetscFunctionReturn(0);
 }
 
+/*@C
+   PetscMallocSetHugePage - Sets how the arrays allocated between PetscMallocPushHugePage() and PetscMallocPopHugePage() are
+   mapped
+
+   Not Collective
+
+   Input Parameters:
++  type - PETSC_MALLOC_HUGEPAGE_NONE to use the usual malloc(), PETSC_MALLOC_HUGEPAGE_THP to map the arrays with mmap() and
+          advise the kernel to use transparent huge pages, or PETSC_MALLOC_HUGEPAGE_HUGETLB to take them from the huge page
+          pool of the system (falling back to transparent huge pages when the pool is empty)
+-  threshold - smallest array, in bytes, that is mapped, or 0 for 2 MB
+
+   Options Database Keys:
++  -malloc_hugepage <none,thp,hugetlb> - the type
+-  -malloc_hugepage_threshold <bytes> - the threshold
+
+   Level: developer
+
+   Notes:
+   PETSc calls PetscMallocPushHugePage() around the allocation of the arrays of VECSEQ (and so VECMPI) vectors and of the
+   values and indices of MATSEQAIJ matrices. With OpenMP the mapped pages are first touched by the threads with a static
+   split of the array, so that on NUMA systems each part of it is on the memory of the socket that works on it.
+
+   The number and size of these arrays and the NUMA nodes their pages were on when they were freed are printed by -malloc_view.
+
+.seealso: PetscMallocPushHugePage(), PetscMallocPopHugePage(), PetscMallocView()
+@*/
+PetscErrorCode PetscMallocSetHugePage(PetscMallocHugePageType type,size_t threshold)
+{
+  PetscFunctionBegin;
+#if defined(MALLOC_HUGEPAGE_MMAP)
+  petschugepagetype      = type;
+  petschugepagethreshold = threshold ? threshold : PETSC_HUGEPAGE_SIZE;
+#else
+  if (type != PETSC_MALLOC_HUGEPAGE_NONE) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Huge page arrays need mmap() with MAP_ANONYMOUS");
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocPushHugePage - Starts a part of the code whose large allocations are mapped as set with PetscMallocSetHugePage()
+
+   Not Collective
+
+   Level: developer
+
+   Notes:
+   Must be paired with PetscMallocPopHugePage(); the pairs may be nested. The arrays can be freed anywhere with PetscFree().
+
+.seealso: PetscMallocSetHugePage(), PetscMallocPopHugePage()
+@*/
+PetscErrorCode PetscMallocPushHugePage(void)
+{
+  PetscFunctionBegin;
+#if defined(MALLOC_HUGEPAGE_MMAP)
+  petschugepagedepth++;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocPopHugePage - Ends a part of the code started with PetscMallocPushHugePage()
+
+   Not Collective
+
+   Level: developer
+
+.seealso: PetscMallocSetHugePage(), PetscMallocPushHugePage()
+@*/
+PetscErrorCode PetscMallocPopHugePage(void)
+{
+  PetscFunctionBegin;
+#if defined(MALLOC_HUGEPAGE_MMAP)
+  if (!petschugepagedepth) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"PetscMallocPopHugePage() without PetscMallocPushHugePage()");
+  petschugepagedepth--;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscMallocHugePageView_Private - Prints the huge page arrays and the NUMA nodes of their pages for PetscMallocView()
+*/
+PetscErrorCode PetscMallocHugePageView_Private(FILE *fp,PetscMPIInt rank)
+{
+#if defined(MALLOC_HUGEPAGE_MMAP)
+  int k;
+
+  PetscFunctionBegin;
+  if (!petschugepagecount) PetscFunctionReturn(0);
+  (void) fprintf(fp,"[%d] Huge page arrays (%s): %.0f mapped, maximum %.0f bytes at once, %.0f bytes from the huge page pool, %.0f hugetlb mappings failed\n",rank,PetscMallocHugePageTypes[petschugepagetype],petschugepagecount,petschugepagemaxbytes,petschugepagehugetlbbytes,petschugepagefailed);
+  /* the arrays that are still mapped are counted as they are now */
+  for (k=0; k<petschugepagen; k++) PetscHugePageSample_Private(&petschugepageregions[k]);
+  for (k=0; k<PETSC_HUGEPAGE_MAXNODES; k++) {
+    if (petschugepagenodebytes[k]) (void) fprintf(fp,"[%d] Huge page arrays: %.0f bytes on NUMA node %d\n",rank,petschugepagenodebytes[k],k);
+  }
+  if (petschugepagenodebytes[PETSC_HUGEPAGE_MAXNODES]) (void) fprintf(fp,"[%d] Huge page arrays: %.0f bytes never touched or of unknown node\n",rank,petschugepagenodebytes[PETSC_HUGEPAGE_MAXNODES]);
+  for (k=0; k<=PETSC_HUGEPAGE_MAXNODES; k++) petschugepagenodebytes[k] = 0;
+#else
+  PetscFunctionBegin;
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*
+    The pooled allocator keeps the blocks freed with PetscFreePool() in free lists of size classes, four per power of two
+  from 16 bytes to PETSC_POOL_MAXSIZE, and hands them out again to PetscMallocPool() requests of the same class. Larger
+  requests go straight to PetscMallocAlign(). Each block starts with a header that records its class, so that
+  PetscFreePool() and PetscReallocPool() need not search for it. Once petscpoolmaxcached bytes are kept in the free
+  lists further freed blocks are returned to the system.
+*/
+#define PETSC_POOL_NCLASSES 65
+#define PETSC_POOL_MAXSIZE  ((size_t)16 << 16)
+#define PETSC_POOL_CLASSSIZE(k) (((size_t)4 << ((k)/4))*(4 + (k)%4))
+
+typedef struct _n_PetscPoolHeader {
+  struct _n_PetscPoolHeader *next;     /* next free block of the class */
+  size_t                    capacity;  /* usable bytes after the header */
+  int                       klass;     /* size class, or -1 for blocks that are not pooled */
+} PetscPoolHeader;
+
+#define PETSC_POOL_HEADERSIZE (((sizeof(PetscPoolHeader)+PETSC_MEMALIGN-1)/PETSC_MEMALIGN)*PETSC_MEMALIGN)
+
+static PetscPoolHeader *petscpoolfree[PETSC_POOL_NCLASSES];
+static size_t          petscpoolmaxcached = (size_t)-1,petscpoolcached = 0;
+#if defined(PETSC_HAVE_THREADSAFETY)
+static PetscSpinlock   petscpoollock;
+#endif
+static PetscBool       petscpoolset = PETSC_FALSE;
+static PetscLogDouble  petscpoolrequests = 0,petscpoolhits = 0,petscpoollarge = 0,petscpoolreleased = 0,petscpoolmaxcachedseen = 0;
+
+PETSC_STATIC_INLINE int PetscPoolClass_Private(size_t mem)
+{
+  size_t u;
+  int    b = 0;
+
+  if (mem <= 16) return 0;
+  u = (mem-1) >> 2;
+  while ((u >> b) >= 8) b++;
+  return 4*b + (int)((u >> b) - 4) + 1;
+}
+
+/* Creates the lock of the free lists, from PetscMallocSetPool() or from the first PetscMallocPool() when the pool was passed to PetscMallocSet() */
+static PetscErrorCode PetscPoolSetUp_Private(void)
+{
+  PetscErrorCode ierr;
+
+  if (petscpoolset) return 0;
+  ierr = PetscSpinlockCreate(&petscpoollock);if (ierr) return ierr;
+  petscpoolset = PETSC_TRUE;
+  return 0;
+}
+
+/*@C
+   PetscMallocPool - Allocates memory from the pool of freed blocks of the same size class, see PetscMallocSetPool()
+
+   Not Collective
+
+   Input Parameters:
++  mem - the number of bytes
+.  clear - zero the memory
+.  line - the line of the call
+.  func - the function of the call
+-  file - the file of the call
+
+   Output Parameter:
+.  result - the memory, aligned to PETSC_MEMALIGN
+
+   Level: developer
+
+   Notes:
+   PetscMallocPool(), PetscFreePool() and PetscReallocPool() may be passed to PetscMallocSet() before PetscInitialize()
+   when PETSc does not use its debugging malloc, that is with -malloc_debug no in a debug build; otherwise use -malloc_pool
+   or PetscMallocSetPool(). The pool is then set up by the first PetscMallocPool(), which must not be called by several
+   threads at once, keeps no limit on the memory in the free lists, and is trimmed by PetscFinalize().
+
+.seealso: PetscMallocSetPool(), PetscFreePool(), PetscReallocPool(), PetscMallocSet()
+@*/
+PetscErrorCode PetscMallocPool(size_t mem,PetscBool clear,int line,const char func[],const char file[],void **result)
+{
+  PetscErrorCode  ierr;
+  PetscPoolHeader *h = NULL;
+  int             k = -1;
+
+  if (!mem) {*result = NULL; return 0;}
+  if (!petscpoolset) {ierr = PetscPoolSetUp_Private();if (ierr) return ierr;}
+  if (mem <= PETSC_POOL_MAXSIZE) {
+    k    = PetscPoolClass_Private(mem);
+    ierr = PetscSpinlockLock(&petscpoollock);if (ierr) return ierr;
+    petscpoolrequests++;
+    if (petscpoolfree[k]) {
+      h                = petscpoolfree[k];
+      petscpoolfree[k] = h->next;
+      petscpoolcached -= h->capacity;
+      petscpoolhits++;
+    }
+    ierr = PetscSpinlockUnlock(&petscpoollock);if (ierr) return ierr;
+  } else petscpoollarge++;
+  if (!h) {
+    size_t capacity = k < 0 ? mem : PETSC_POOL_CLASSSIZE(k);
+
+    ierr = PetscMallocAlign(capacity+PETSC_POOL_HEADERSIZE,PETSC_FALSE,line,func,file,(void**)&h);if (ierr) return ierr;
+    h->capacity = capacity;
+    h->klass    = k;
+  }
+  h->next = NULL;
+  *result = (char*)h + PETSC_POOL_HEADERSIZE;
+  if (clear) {ierr = PetscMemzero(*result,mem);if (ierr) return ierr;}
+  return 0;
+}
+
+/*@C
+   PetscFreePool - Returns memory obtained with PetscMallocPool() to the pool, see PetscMallocSetPool()
+
+   Not Collective
+
+   Input Parameters:
++  ptr - the memory
+.  line - the line of the call
+.  func - the function of the call
+-  file - the file of the call
+
+   Level: developer
+
+.seealso: PetscMallocSetPool(), PetscMallocPool(), PetscReallocPool(), PetscMallocPoolTrim()
+@*/
+PetscErrorCode PetscFreePool(void *ptr,int line,const char func[],const char file[])
+{
+  PetscErrorCode  ierr;
+  PetscPoolHeader *h;
+  PetscBool       cached = PETSC_FALSE;
+
+  if (!ptr) return 0;
+  h = (PetscPoolHeader*)((char*)ptr - PETSC_POOL_HEADERSIZE);
+  if (h->klass >= 0) {
+    ierr = PetscSpinlockLock(&petscpoollock);if (ierr) return ierr;
+    if (petscpoolcached + h->capacity <= petscpoolmaxcached) {
+      h->next                 = petscpoolfree[h->klass];
+      petscpoolfree[h->klass] = h;
+      petscpoolcached        += h->capacity;
+      petscpoolmaxcachedseen  = PetscMax(petscpoolmaxcachedseen,(PetscLogDouble)petscpoolcached);
+      cached                  = PETSC_TRUE;
+    } else petscpoolreleased++;
+    ierr = PetscSpinlockUnlock(&petscpoollock);if (ierr) return ierr;
+  }
+  if (!cached) {ierr = PetscFreeAlign(h,line,func,file);if (ierr) return ierr;}
+  return 0;
+}
+
+/*@C
+   PetscReallocPool - Changes the size of memory obtained with PetscMallocPool(), see PetscMallocSetPool()
+
+   Not Collective
+
+   Input Parameters:
++  mem - the new number of bytes
+.  line - the line of the call
+.  func - the function of the call
+-  file - the file of the call
+
+   Input/Output Parameter:
+.  result - the memory
+
+   Level: developer
+
+.seealso: PetscMallocSetPool(), PetscMallocPool(), PetscFreePool()
+@*/
+PetscErrorCode PetscReallocPool(size_t mem,int line,const char func[],const char file[],void **result)
+{
+  PetscErrorCode  ierr;
+  PetscPoolHeader *h;
+  void            *newResult;
+
+  if (!mem) {
+    ierr    = PetscFreePool(*result,line,func,file);if (ierr) return ierr;
+    *result = NULL;
+    return 0;
+  }
+  if (!*result) return PetscMallocPool(mem,PETSC_FALSE,line,func,file,result);
+  h = (PetscPoolHeader*)((char*)*result - PETSC_POOL_HEADERSIZE);
+  /* a block of the right class already, or a large block that stays large */
+  if (h->klass >= 0 && mem <= h->capacity && PetscPoolClass_Private(mem) == h->klass) return 0;
+  if (h->klass < 0 && mem > PETSC_POOL_MAXSIZE) {
+    ierr        = PetscReallocAlign(mem+PETSC_POOL_HEADERSIZE,line,func,file,(void**)&h);if (ierr) return ierr;
+    h->capacity = mem;
+    *result     = (char*)h + PETSC_POOL_HEADERSIZE;
+    return 0;
+  }
+  ierr    = PetscMallocPool(mem,PETSC_FALSE,line,func,file,&newResult);if (ierr) return ierr;
+  ierr    = PetscMemcpy(newResult,*result,PetscMin(mem,h->capacity));if (ierr) return ierr;
+  ierr    = PetscFreePool(*result,line,func,file);if (ierr) return ierr;
+  *result = newResult;
+  return 0;
+}
+
+/*@C
+   PetscMallocSetPool - Makes PetscMalloc() reuse the blocks released by PetscFree(), kept in free lists of size classes
+
+   Not Collective
+
+   Input Parameter:
+.  maxcached - the most bytes kept in the free lists, freed blocks beyond it are returned to the system, or 0 for no limit
+
+   Options Database Keys:
++  -malloc_pool - use the pool
+-  -malloc_pool_max <bytes> - the most bytes kept in the free lists
+
+   Level: developer
+
+   Notes:
+   This is for codes that create and destroy many short-lived objects and work arrays, such as the work vectors of
+   line searches and Krylov methods. Allocations of up to 1 MB are served from the free list of their size class when it
+   is not empty, larger ones go to the system directly. The free lists are shared by all threads and protected by a lock
+   when PETSc is configured for thread safety.
+
+   It can be called only once, in PetscInitialize(), and combines with the PETSc debugging malloc, which then takes its
+   memory from the pool. -malloc_view prints how many requests were served from the pool.
+
+.seealso: PetscMallocPool(), PetscFreePool(), PetscReallocPool(), PetscMallocPoolTrim(), PetscMallocSet()
+@*/
+PetscErrorCode PetscMallocSetPool(size_t maxcached)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (petscpoolset) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"The pool is already in use");
+  ierr = PetscPoolSetUp_Private();CHKERRQ(ierr);
+  petscpoolmaxcached = maxcached ? maxcached : (size_t)-1;
+  if (PetscTrMalloc == PetscMallocAlign) {
+    ierr = PetscMallocSet(PetscMallocPool,PetscFreePool,PetscReallocPool);CHKERRQ(ierr);
+  } else {
+    ierr = PetscMallocSetDebugBase_Private(PetscMallocPool,PetscFreePool,PetscReallocPool);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocPoolTrim - Returns all the blocks kept in the free lists of PetscMallocSetPool() to the system
+
+   Not Collective
+
+   Level: developer
+
+.seealso: PetscMallocSetPool()
+@*/
+PetscErrorCode PetscMallocPoolTrim(void)
+{
+  PetscErrorCode  ierr;
+  PetscPoolHeader *h;
+  int             k;
+
+  PetscFunctionBegin;
+  if (!petscpoolset) PetscFunctionReturn(0);
+  ierr = PetscSpinlockLock(&petscpoollock);CHKERRQ(ierr);
+  for (k=0; k<PETSC_POOL_NCLASSES; k++) {
+    while ((h = petscpoolfree[k])) {
+      petscpoolfree[k] = h->next;
+      ierr = PetscFreeAlign(h,__LINE__,PETSC_FUNCTION_NAME,__FILE__);CHKERRQ(ierr);
+    }
+  }
+  petscpoolcached = 0;
+  ierr = PetscSpinlockUnlock(&petscpoollock);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscMallocPoolView_Private - Prints how many requests PetscMallocPool() served from the free lists for PetscMallocView()
+*/
+PetscErrorCode PetscMallocPoolView_Private(FILE *fp,PetscMPIInt rank)
+{
+  PetscFunctionBegin;
+  if (!petscpoolrequests && !petscpoollarge) PetscFunctionReturn(0);
+  (void) fprintf(fp,"[%d] Pooled allocations: %.0f requests, %.0f served from the pool (%.1f%%), %.0f larger than the largest class, at most %.0f bytes kept, %.0f blocks returned at the limit\n",rank,petscpoolrequests,petscpoolhits,petscpoolrequests ? 100.0*petscpoolhits/petscpoolrequests : 0.0,petscpoollarge,petscpoolmaxcachedseen,petscpoolreleased);
+  PetscFunctionReturn(0);
+}
+
 static PetscBool petscmalloccoalesce =
 #if defined(PETSC_USE_MALLOC_COALESCED)
   PETSC_TRUE;
@@ -4,6 +4,7 @@
 */
 #include <petscsys.h>           /*I "petscsys.h" I*/
 #include <petscviewer.h>
+#include <petsc/private/petscimpl.h>
 #if defined(PETSC_HAVE_MALLOC_H)
 #include <malloc.h>
 #endif
@@ -65,6 +66,20 @@ static size_t     PetscLogMallocThreshold = 0;
 static size_t     *PetscLogMallocLength;
 static const char **PetscLogMallocFile,**PetscLogMallocFunction;
 
+/*
+      The allocator under the tracing, PetscMallocAlign() unless PetscMallocSetPool() is used
+*/
+static PetscErrorCode (*TRmallocbase)(size_t,PetscBool,int,const char[],const char[],void**) = PetscMallocAlign;
+static PetscErrorCode (*TRfreebase)(void*,int,const char[],const char[])                    = PetscFreeAlign;
+static PetscErrorCode (*TRreallocbase)(size_t,int,const char[],const char[],void**)         = PetscReallocAlign;
+
+/*
+      Functions that print the statistics of object pools in PetscMallocView()
+*/
+#define MAXMALLOCVIEWFUNCTIONS 8
+static int            NumMallocViewFunctions = 0;
+static PetscErrorCode (*MallocViewFunctions[MAXMALLOCVIEWFUNCTIONS])(FILE*,PetscMPIInt);
+
 /*@C
    PetscMallocValidate - Test the memory for corruption.  This can be called at any time between PetscInitialize() and PetscFinalize()
 
@@ -161,7 +176,7 @@ PetscErrorCode  PetscTrMallocDefault(size_t a,PetscBool clear,int lineno,const c
   ierr = PetscMallocValidate(lineno,function,filename); if (ierr) PetscFunctionReturn(ierr);
 
   nsize = (a + (PETSC_MEMALIGN-1)) & ~(PETSC_MEMALIGN-1);
-  ierr  = PetscMallocAlign(nsize+sizeof(TrSPACE)+sizeof(PetscClassId),clear,lineno,function,filename,(void**)&inew);CHKERRQ(ierr);
+  ierr  = (*TRmallocbase)(nsize+sizeof(TrSPACE)+sizeof(PetscClassId),clear,lineno,function,filename,(void**)&inew);CHKERRQ(ierr);
 
   head  = (TRSPACE*)inew;
   inew += sizeof(TrSPACE);
@@ -304,7 +319,7 @@ PetscErrorCode  PetscTrFreeDefault(void *aa,int line,const char function[],const
   else TRhead = head->next;
 
   if (head->next) head->next->prev = head->prev;
-  ierr = PetscFreeAlign(a,line,function,file);CHKERRQ(ierr);
+  ierr = (*TRfreebase)(a,line,function,file);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -386,7 +401,7 @@ PetscErrorCode PetscTrReallocDefault(size_t len, int lineno, const char function
   if (head->next) head->next->prev = head->prev;
 
   nsize = (len + (PETSC_MEMALIGN-1)) & ~(PETSC_MEMALIGN-1);
-  ierr  = PetscReallocAlign(nsize+sizeof(TrSPACE)+sizeof(PetscClassId),lineno,function,filename,(void**)&inew);CHKERRQ(ierr);
+  ierr  = (*TRreallocbase)(nsize+sizeof(TrSPACE)+sizeof(PetscClassId),lineno,function,filename,(void**)&inew);CHKERRQ(ierr);
 
   head  = (TRSPACE*)inew;
   inew += sizeof(TrSPACE);
@@ -820,6 +835,9 @@ PetscErrorCode  PetscMallocView(FILE *fp)
   } else {
     (void) fprintf(fp,"[%d] Maximum memory PetscMalloc()ed %.0f OS cannot compute size of entire process\n",rank,(PetscLogDouble)TRMaxMem);
   }
+  ierr = PetscMallocHugePageView_Private(fp,rank);CHKERRQ(ierr);
+  ierr = PetscMallocPoolView_Private(fp,rank);CHKERRQ(ierr);
+  for (i=0; i<NumMallocViewFunctions; i++) {ierr = (*MallocViewFunctions[i])(fp,rank);CHKERRQ(ierr);}
   shortcount    = (int*)malloc(PetscLogMalloc*sizeof(int));if (!shortcount) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_MEM,"Out of memory");
   shortlength   = (size_t*)malloc(PetscLogMalloc*sizeof(size_t));if (!shortlength) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_MEM,"Out of memory");
   shortfunction = (const char**)malloc(PetscLogMalloc*sizeof(char*));if (!shortfunction) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_MEM,"Out of memory");
@@ -926,3 +944,31 @@ PetscErrorCode PetscMallocGetDebug(PetscBool *basic, PetscBool *eachcall, PetscB
   if (initializenan) *initializenan = TRdebugIinitializenan;
   PetscFunctionReturn(0);
 }
+
+/*
+   PetscMallocSetDebugBase_Private - Sets the allocator that the PETSc debugging malloc takes its memory from, used by PetscMallocSetPool()
+*/
+PetscErrorCode PetscMallocSetDebugBase_Private(PetscErrorCode (*imalloc)(size_t,PetscBool,int,const char[],const char[],void**),PetscErrorCode (*ifree)(void*,int,const char[],const char[]),PetscErrorCode (*iralloc)(size_t,int,const char[],const char[],void**))
+{
+  PetscFunctionBegin;
+  if (PetscTrMalloc != PetscTrMallocDefault) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Cannot put an allocator under a malloc set with PetscMallocSet()");
+  if (TRfrags) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Cannot change the allocator under the debugging malloc once memory is allocated");
+  TRmallocbase  = imalloc;
+  TRfreebase    = ifree;
+  TRreallocbase = iralloc;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscMallocViewAddFunction_Private - Adds a function that PetscMallocView() calls to print the statistics of a pool of objects
+*/
+PetscErrorCode PetscMallocViewAddFunction_Private(PetscErrorCode (*view)(FILE*,PetscMPIInt))
+{
+  int i;
+
+  PetscFunctionBegin;
+  for (i=0; i<NumMallocViewFunctions; i++) if (MallocViewFunctions[i] == view) PetscFunctionReturn(0);
+  if (NumMallocViewFunctions == MAXMALLOCVIEWFUNCTIONS) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SUP,"Only %d functions can be added",MAXMALLOCVIEWFUNCTIONS);
+  MallocViewFunctions[NumMallocViewFunctions++] = view;
+  PetscFunctionReturn(0);
+}
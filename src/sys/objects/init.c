@@ -430,12 +430,27 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
 #endif
   }
 
+  flg1 = PETSC_FALSE;
+  ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_pool",&flg1,NULL);CHKERRQ(ierr);
+  if (flg1) {
+    PetscReal poolmax = 0;
+    ierr = PetscOptionsGetReal(NULL,NULL,"-malloc_pool_max",&poolmax,NULL);CHKERRQ(ierr);
+    ierr = PetscMallocSetPool((size_t)PetscMax(poolmax,0));CHKERRQ(ierr);
+  }
   ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_coalesce",&flg1,&flg2);CHKERRQ(ierr);
   if (flg2) {ierr = PetscMallocSetCoalesce(flg1);CHKERRQ(ierr);}
   flg1 = PETSC_FALSE;
   ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_hbw",&flg1,NULL);CHKERRQ(ierr);
   /* ignore this option if malloc is already set */
   if (flg1 && !petscsetmallocvisited) {ierr = PetscSetUseHBWMalloc_Private();CHKERRQ(ierr);}
+  {
+    PetscMallocHugePageType hptype = PETSC_MALLOC_HUGEPAGE_NONE;
+    PetscReal               hpthreshold = 0;
+
+    ierr = PetscOptionsGetEnum(NULL,NULL,"-malloc_hugepage",PetscMallocHugePageTypes,(PetscEnum*)&hptype,&flg1);CHKERRQ(ierr);
+    ierr = PetscOptionsGetReal(NULL,NULL,"-malloc_hugepage_threshold",&hpthreshold,NULL);CHKERRQ(ierr);
+    if (flg1) {ierr = PetscMallocSetHugePage(hptype,(size_t)PetscMax(hpthreshold,0));CHKERRQ(ierr);}
+  }
 
   flg1 = PETSC_FALSE;
   ierr = PetscOptionsGetBool(NULL,NULL,"-malloc_info",&flg1,NULL);CHKERRQ(ierr);
@@ -730,6 +745,10 @@ PETSC_INTERN PetscErrorCode  PetscOptionsCheckInitial_Private(void)
     ierr = (*PetscHelpPrintf)(comm," -malloc_info: prints total memory usage\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_view <optional filename>: keeps log of all memory allocations, displays in PetscFinalize()\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -malloc_debug <true or false>: enables or disables extended checking for memory corruption\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_hugepage <none,thp,hugetlb>: map the large arrays of vectors and matrices with transparent or hugetlb huge pages\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_hugepage_threshold <bytes>: smallest array mapped with -malloc_hugepage (default 2 MB)\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_pool: reuse freed memory kept in free lists of size classes\n");CHKERRQ(ierr);
+    ierr = (*PetscHelpPrintf)(comm," -malloc_pool_max <bytes>: most memory kept in the free lists of -malloc_pool\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_view: dump list of options inputted\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_left: dump list of unused options\n");CHKERRQ(ierr);
     ierr = (*PetscHelpPrintf)(comm," -options_left no: don't dump list of unused options\n");CHKERRQ(ierr);
@@ -688,6 +688,8 @@ PetscInt PetscNumOMPThreads;
 .  -malloc_test - like -malloc_dump -malloc_debug, but only active for debugging builds, ignored in optimized build. May want to set in PETSC_OPTIONS environmental variable
 .  -malloc_view - show a list of all allocated memory during PetscFinalize()
 .  -malloc_view_threshold <t> - only list memory allocations of size greater than t with -malloc_view
+.  -malloc_hugepage <none,thp,hugetlb> - map the large arrays of vectors and matrices with huge pages, see PetscMallocSetHugePage()
+.  -malloc_pool - reuse the memory freed by PetscFree() for later PetscMalloc() of the same size class, see PetscMallocSetPool()
 .  -fp_trap - Stops on floating point exceptions
 .  -no_signal_handler - Indicates not to trap error signals
 .  -shared_tmp - indicates /tmp directory is shared by all processors
@@ -1603,6 +1605,7 @@ PetscErrorCode  PetscFinalize(void)
    memory was not freed.
 
 */
+  ierr = PetscMallocPoolTrim();CHKERRQ(ierr);
   ierr = PetscMallocClear();CHKERRQ(ierr);
 
   PetscInitializeCalled = PETSC_FALSE;
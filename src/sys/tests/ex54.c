@@ -0,0 +1,76 @@
+static char help[] = "Tests the huge page arrays of PetscMallocSetHugePage() with a vector, a matrix and PetscRealloc().\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,n = 300000,col[3];
+  PetscScalar    v[3],*a;
+  PetscReal      norm;
+  Vec            x,y;
+  Mat            A;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* the arrays of the vectors and of the matrix are larger than the threshold */
+  ierr = VecCreateSeq(PETSC_COMM_SELF,n,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,n,n,3,NULL,&A);CHKERRQ(ierr);
+  v[0] = -1.0; v[1] = 2.0; v[2] = -1.0;
+  for (i=0; i<n; i++) {
+    col[0] = i-1; col[1] = i; col[2] = i+1;
+    if (!i) {ierr = MatSetValues(A,1,&i,2,col+1,v+1,INSERT_VALUES);CHKERRQ(ierr);}
+    else if (i == n-1) {ierr = MatSetValues(A,1,&i,2,col,v,INSERT_VALUES);CHKERRQ(ierr);}
+    else {ierr = MatSetValues(A,1,&i,3,col,v,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatMult(A,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_2,&norm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"Norm of A*1: %g\n",(double)norm);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_1,&norm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"Norm of 1: %g\n",(double)norm);CHKERRQ(ierr);
+
+  /* a huge page array grown and shrunk with PetscRealloc() keeps its values */
+  ierr = PetscMallocPushHugePage();CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&a);CHKERRQ(ierr);
+  ierr = PetscMallocPopHugePage();CHKERRQ(ierr);
+  for (i=0; i<n; i++) a[i] = (PetscScalar)i;
+  ierr = PetscRealloc(2*n*sizeof(PetscScalar),&a);CHKERRQ(ierr);
+  for (i=n; i<2*n; i++) a[i] = (PetscScalar)i;
+  ierr = PetscRealloc(10*sizeof(PetscScalar),&a);CHKERRQ(ierr);
+  for (i=0; i<10; i++) if (a[i] != (PetscScalar)i) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Wrong value at %D after PetscRealloc()",i);
+  ierr = PetscFree(a);CHKERRQ(ierr);
+
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex54_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: thp
+         args: -malloc_hugepage thp
+      test:
+         suffix: threshold
+         args: -malloc_hugepage thp -malloc_hugepage_threshold 4096 -malloc_dump
+      test:
+         suffix: hugetlb
+         args: -malloc_hugepage hugetlb
+
+   test:
+      suffix: view
+      args: -malloc_hugepage thp -malloc_view
+      filter: grep "Huge page arrays (" | cut -d: -f1
+
+TEST*/
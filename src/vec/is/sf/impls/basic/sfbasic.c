@@ -5,6 +5,58 @@
 /*===================================================================================*/
 /*              SF public interface implementations                                  */
 /*===================================================================================*/
+/*
+   Finds the remote ranks on this node and tells each of them where in the shared window of this rank (root part first, then
+   leaf part, see PetscSFLinkSetUpShm_Private()) its data is. Only for PETSCSFBASIC, the other types only reuse its setup.
+*/
+static PetscErrorCode PetscSFSetUpShm_Basic(PetscSF sf)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscMPIInt    size;
+  PetscBool      isbasic;
+  MPI_Comm       comm;
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  PetscInt       i,nl = sf->nranks-sf->ndranks,nr = bas->niranks-bas->ndiranks,*sendoffset;
+  PetscMPIInt    tag[2];
+  PetscShmComm   pshmcomm;
+  MPI_Request    *reqs;
+#endif
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)sf,PETSCSFBASIC,&isbasic);CHKERRQ(ierr);
+  if (!bas->useshm || !isbasic || size == 1) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  ierr = PetscShmCommGet(comm,&pshmcomm);CHKERRQ(ierr);
+  ierr = PetscShmCommGetMpiShmComm(pshmcomm,&bas->shmcomm);CHKERRQ(ierr);
+  ierr = PetscMalloc4(nl,&bas->leafshmrank,nl,&bas->leafshmoffset,nr,&bas->rootshmrank,nr,&bas->rootshmoffset);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nl+nr,&sendoffset,2*(nl+nr),&reqs);CHKERRQ(ierr);
+  ierr = PetscObjectGetNewTag((PetscObject)sf,&tag[0]);CHKERRQ(ierr); /* Offsets sent by leaves to roots */
+  ierr = PetscObjectGetNewTag((PetscObject)sf,&tag[1]);CHKERRQ(ierr); /* Offsets sent by roots to leaves */
+  for (i=0; i<2*(nl+nr); i++) reqs[i] = MPI_REQUEST_NULL;
+  for (i=0; i<nl; i++) {
+    ierr = PetscShmCommGlobalToLocal(pshmcomm,sf->ranks[sf->ndranks+i],&bas->leafshmrank[i]);CHKERRQ(ierr);
+    if (bas->leafshmrank[i] == MPI_PROC_NULL) continue;
+    sendoffset[i] = (bas->itotal-bas->ioffset[bas->ndiranks]) + sf->roffset[sf->ndranks+i] - sf->roffset[sf->ndranks];
+    ierr = MPI_Irecv(&bas->leafshmoffset[i],1,MPIU_INT,sf->ranks[sf->ndranks+i],tag[1],comm,&reqs[i]);CHKERRQ(ierr);
+    ierr = MPI_Isend(&sendoffset[i],1,MPIU_INT,sf->ranks[sf->ndranks+i],tag[0],comm,&reqs[nl+nr+i]);CHKERRQ(ierr);
+  }
+  for (i=0; i<nr; i++) {
+    ierr = PetscShmCommGlobalToLocal(pshmcomm,bas->iranks[bas->ndiranks+i],&bas->rootshmrank[i]);CHKERRQ(ierr);
+    if (bas->rootshmrank[i] == MPI_PROC_NULL) continue;
+    sendoffset[nl+i] = bas->ioffset[bas->ndiranks+i] - bas->ioffset[bas->ndiranks];
+    ierr = MPI_Irecv(&bas->rootshmoffset[i],1,MPIU_INT,bas->iranks[bas->ndiranks+i],tag[0],comm,&reqs[nl+i]);CHKERRQ(ierr);
+    ierr = MPI_Isend(&sendoffset[nl+i],1,MPIU_INT,bas->iranks[bas->ndiranks+i],tag[1],comm,&reqs[2*nl+nr+i]);CHKERRQ(ierr);
+  }
+  ierr = MPI_Waitall(2*(nl+nr),reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = PetscFree2(sendoffset,reqs);CHKERRQ(ierr);
+  bas->doshm = PETSC_TRUE;
+#endif
+  PetscFunctionReturn(0);
+}
+
 PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
 {
   PetscErrorCode ierr;
@@ -85,6 +137,7 @@ PETSC_INTERN PetscErrorCode PetscSFSetUp_Basic(PetscSF sf)
 
   /* Setup fields related to packing */
   ierr = PetscSFSetUpPackFields(sf);CHKERRQ(ierr);
+  ierr = PetscSFSetUpShm_Basic(sf);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -105,6 +158,10 @@ PETSC_INTERN PetscErrorCode PetscSFReset_Basic(PetscSF sf)
 #endif
   ierr = PetscSFLinkDestroy(sf,&bas->avail);CHKERRQ(ierr);
   ierr = PetscSFResetPackFields(sf);CHKERRQ(ierr);
+  if (bas->doshm) {
+    ierr = PetscFree4(bas->leafshmrank,bas->leafshmoffset,bas->rootshmrank,bas->rootshmoffset);CHKERRQ(ierr);
+    bas->doshm = PETSC_FALSE;
+  }
   PetscFunctionReturn(0);
 }
 
@@ -118,14 +175,101 @@ PETSC_INTERN PetscErrorCode PetscSFDestroy_Basic(PetscSF sf)
   PetscFunctionReturn(0);
 }
 
-PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
+/* Describe the pattern of the m indices exchanged with one rank and how they are packed, contig and opt being those of the scope of the rank */
+static PetscErrorCode PetscSFGetIndexPatternString_Basic(PetscInt m,const PetscInt *idx,PetscBool contig,PetscSFPackOpt opt,PetscBool derived,char *str,size_t len)
 {
   PetscErrorCode ierr;
-  PetscBool      iascii;
+  PetscInt       start,dx,dy,dz,X,Y;
+  PetscBool      found = PETSC_FALSE;
+  char           pattern[128];
+  const char     *how;
+
+  PetscFunctionBegin;
+  if (m) {ierr = PetscSFAnalyzeIndices(m,idx,&start,&dx,&dy,&dz,&X,&Y,&found);CHKERRQ(ierr);}
+  if (!found)                  {ierr = PetscStrncpy(pattern,"indexed",sizeof(pattern));CHKERRQ(ierr);}
+  else if (dy*dz == 1)         {ierr = PetscSNPrintf(pattern,sizeof(pattern),"contiguous from %D",start);CHKERRQ(ierr);}
+  else if (dx == 1 && dz == 1) {ierr = PetscSNPrintf(pattern,sizeof(pattern),"strided from %D with stride %D",start,X);CHKERRQ(ierr);}
+  else if (dz == 1)            {ierr = PetscSNPrintf(pattern,sizeof(pattern),"2D block %Dx%D from %D with row stride %D",dx,dy,start,X);CHKERRQ(ierr);}
+  else                         {ierr = PetscSNPrintf(pattern,sizeof(pattern),"3D block %Dx%Dx%D from %D with strides %D and %D",dx,dy,dz,start,X,X*Y);CHKERRQ(ierr);}
+  if (contig)       how = "no packing";
+  else if (!opt)    how = "indexed packing";
+  else if (derived) how = "MPI derived datatype";
+  else              how = "block copies";
+  ierr = PetscSNPrintf(str,len,"%D entries, %s, %s",m,pattern,how);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode PetscSFView_Basic(PetscSF sf,PetscViewer viewer)
+{
+  PetscErrorCode    ierr;
+  PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
+  PetscBool         iascii;
+  PetscViewerFormat format;
 
   PetscFunctionBegin;
   ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
-  if (iascii) {ierr = PetscViewerASCIIPrintf(viewer,"  sort=%s\n",sf->rankorder ? "rank-order" : "unordered");CHKERRQ(ierr);}
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  sort=%s\n",sf->rankorder ? "rank-order" : "unordered");CHKERRQ(ierr);
+    if (bas->doshm) {
+      PetscInt    i,nl = sf->nranks-sf->ndranks,nr = bas->niranks-bas->ndiranks,nlshm = 0,nrshm = 0;
+      PetscMPIInt rank;
+
+      for (i=0; i<nl; i++) if (bas->leafshmrank[i] != MPI_PROC_NULL) nlshm++;
+      for (i=0; i<nr; i++) if (bas->rootshmrank[i] != MPI_PROC_NULL) nrshm++;
+      ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)sf),&rank);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIISynchronizedPrintf(viewer,"  [%d] Shared memory with %D of %D root ranks and %D of %D leaf ranks\n",rank,nlshm,nl,nrshm,nr);CHKERRQ(ierr);
+      ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+    }
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO && sf->setupcalled) { /* Per neighbor patterns of the indices and the way they are packed */
+      PetscInt    i,scope;
+      PetscMPIInt rank;
+      char        str[256];
+
+      ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)sf),&rank);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+      for (i=0; i<sf->nranks; i++) {
+        scope = i < sf->ndranks ? PETSCSF_LOCAL : PETSCSF_REMOTE;
+        ierr  = PetscSFGetIndexPatternString_Basic(sf->roffset[i+1]-sf->roffset[i],sf->rmine+sf->roffset[i],sf->leafcontig[scope],sf->leafpackopt[scope],(PetscBool)(scope == PETSCSF_REMOTE && bas->usederived && !bas->doshm),str,sizeof(str));CHKERRQ(ierr);
+        ierr  = PetscViewerASCIISynchronizedPrintf(viewer,"  [%d] Leaves with roots on rank %d: %s\n",rank,sf->ranks[i],str);CHKERRQ(ierr);
+      }
+      for (i=0; i<bas->niranks; i++) {
+        scope = i < bas->ndiranks ? PETSCSF_LOCAL : PETSCSF_REMOTE;
+        ierr  = PetscSFGetIndexPatternString_Basic(bas->ioffset[i+1]-bas->ioffset[i],bas->irootloc+bas->ioffset[i],bas->rootcontig[scope],bas->rootpackopt[scope],(PetscBool)(scope == PETSCSF_REMOTE && bas->usederived && !bas->doshm),str,sizeof(str));CHKERRQ(ierr);
+        ierr  = PetscViewerASCIISynchronizedPrintf(viewer,"  [%d] Roots with leaves on rank %d: %s\n",rank,bas->iranks[i],str);CHKERRQ(ierr);
+      }
+      ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetFromOptions_Basic(PetscOptionItems *PetscOptionsObject,PetscSF sf)
+{
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Basic options");CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-sf_basic_shared_memory","Move data to and from ranks on the same node through MPI shared memory windows","PetscSFSetFromOptions",bas->useshm,&bas->useshm,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-sf_basic_derived_datatypes","Send from and receive into root and leaf data with MPI derived datatypes when the indices of remote ranks form subblocks","PetscSFSetFromOptions",bas->usederived,&bas->usederived,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* With shared memory only the persistent requests of the ranks on other nodes are started */
+PETSC_STATIC_INLINE PetscErrorCode PetscSFStartRequests_Basic(PetscInt n,MPI_Request *reqs,const PetscMPIInt *shmrank)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    if (shmrank[i] == MPI_PROC_NULL) {ierr = MPI_Start(&reqs[i]);CHKERRQ(ierr);}
+  }
   PetscFunctionReturn(0);
 }
 
@@ -142,10 +286,14 @@ static PetscErrorCode PetscSFBcastAndOpBegin_Basic(PetscSF sf,MPI_Datatype unit,
   /* Get MPI requests from the link. We do not need buffers explicitly since we use persistent MPI */
   ierr = PetscSFLinkGetMPIBuffersAndRequests(sf,link,PETSCSF_ROOT2LEAF,NULL,NULL,&rootreqs,&leafreqs);CHKERRQ(ierr);
   /* Post Irecv for remote */
-  ierr = MPI_Startall_irecv(sf->leafbuflen[PETSCSF_REMOTE],unit,sf->nleafreqs,leafreqs);CHKERRQ(ierr);
+  ierr = PetscSFLinkShmPost(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
+  if (link->useshm) {ierr = PetscSFStartRequests_Basic(sf->nleafreqs,leafreqs,bas->leafshmrank);CHKERRQ(ierr);}
+  else {ierr = MPI_Startall_irecv(sf->leafbuflen[PETSCSF_REMOTE],unit,sf->nleafreqs,leafreqs);CHKERRQ(ierr);}
   /* Pack rootdata and do Isend for remote */
   ierr = PetscSFLinkPackRootData(sf,link,PETSCSF_REMOTE,rootdata);CHKERRQ(ierr);
-  ierr = MPI_Startall_isend(bas->rootbuflen[PETSCSF_REMOTE],unit,bas->nrootreqs,rootreqs);CHKERRQ(ierr);
+  ierr = PetscSFLinkShmSignal(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
+  if (link->useshm) {ierr = PetscSFStartRequests_Basic(bas->nrootreqs,rootreqs,bas->rootshmrank);CHKERRQ(ierr);}
+  else {ierr = MPI_Startall_isend(bas->rootbuflen[PETSCSF_REMOTE],unit,bas->nrootreqs,rootreqs);CHKERRQ(ierr);}
   /* Do local BcastAndOp, which overlaps with the irecv/isend above */
   ierr = PetscSFLinkBcastAndOpLocal(sf,link,rootdata,leafdata,op);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -161,8 +309,10 @@ PETSC_INTERN PetscErrorCode PetscSFBcastAndOpEnd_Basic(PetscSF sf,MPI_Datatype u
   ierr = PetscSFLinkGetInUse(sf,unit,rootdata,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
   /* Wait for the completion of mpi */
   ierr = PetscSFLinkMPIWaitall(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
-  /* Unpack leafdata and reclaim the link */
+  ierr = PetscSFLinkShmCopy(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
+  /* Unpack leafdata and reclaim the link once the ranks on the node have copied the roots */
   ierr = PetscSFLinkUnpackLeafData(sf,link,PETSCSF_REMOTE,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFLinkShmWait(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
   ierr = PetscSFLinkReclaim(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -178,9 +328,13 @@ PETSC_STATIC_INLINE PetscErrorCode PetscSFLeafToRootBegin_Basic(PetscSF sf,MPI_D
   PetscFunctionBegin;
   ierr = PetscSFLinkCreate(sf,unit,rootmtype,rootdata,leafmtype,leafdata,op,sfop,&link);CHKERRQ(ierr);
   ierr = PetscSFLinkGetMPIBuffersAndRequests(sf,link,PETSCSF_LEAF2ROOT,NULL,NULL,&rootreqs,&leafreqs);CHKERRQ(ierr);
-  ierr = MPI_Startall_irecv(bas->rootbuflen[PETSCSF_REMOTE],unit,bas->nrootreqs,rootreqs);CHKERRQ(ierr);
+  ierr = PetscSFLinkShmPost(sf,link,PETSCSF_LEAF2ROOT);CHKERRQ(ierr);
+  if (link->useshm) {ierr = PetscSFStartRequests_Basic(bas->nrootreqs,rootreqs,bas->rootshmrank);CHKERRQ(ierr);}
+  else {ierr = MPI_Startall_irecv(bas->rootbuflen[PETSCSF_REMOTE],unit,bas->nrootreqs,rootreqs);CHKERRQ(ierr);}
   ierr = PetscSFLinkPackLeafData(sf,link,PETSCSF_REMOTE,leafdata);CHKERRQ(ierr);
-  ierr = MPI_Startall_isend(sf->leafbuflen[PETSCSF_REMOTE],unit,sf->nleafreqs,leafreqs);CHKERRQ(ierr);
+  ierr = PetscSFLinkShmSignal(sf,link,PETSCSF_LEAF2ROOT);CHKERRQ(ierr);
+  if (link->useshm) {ierr = PetscSFStartRequests_Basic(sf->nleafreqs,leafreqs,bas->leafshmrank);CHKERRQ(ierr);}
+  else {ierr = MPI_Startall_isend(sf->leafbuflen[PETSCSF_REMOTE],unit,sf->nleafreqs,leafreqs);CHKERRQ(ierr);}
   *out = link;
   PetscFunctionReturn(0);
 }
@@ -205,7 +359,9 @@ PETSC_INTERN PetscErrorCode PetscSFReduceEnd_Basic(PetscSF sf,MPI_Datatype unit,
   PetscFunctionBegin;
   ierr = PetscSFLinkGetInUse(sf,unit,rootdata,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
   ierr = PetscSFLinkMPIWaitall(sf,link,PETSCSF_LEAF2ROOT);CHKERRQ(ierr);
+  ierr = PetscSFLinkShmCopy(sf,link,PETSCSF_LEAF2ROOT);CHKERRQ(ierr);
   ierr = PetscSFLinkUnpackRootData(sf,link,PETSCSF_REMOTE,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFLinkShmWait(sf,link,PETSCSF_LEAF2ROOT);CHKERRQ(ierr);
   ierr = PetscSFLinkReclaim(sf,&link);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -247,6 +403,86 @@ static PetscErrorCode PetscSFFetchAndOpEnd_Basic(PetscSF sf,MPI_Datatype unit,vo
   PetscFunctionReturn(0);
 }
 
+/* The link of n arrays started with PetscSFLinkCreateMultiple(), whose keys are the first arrays */
+static PetscErrorCode PetscSFLinkGetInUseMultiple_Basic(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *rootdata,const void *leafdata,PetscSFLink *link)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    nn;
+  MPI_Datatype   munit;
+
+  PetscFunctionBegin;
+  ierr = PetscMPIIntCast(n,&nn);CHKERRQ(ierr);
+  ierr = MPI_Type_contiguous(nn,unit,&munit);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(&munit);CHKERRQ(ierr);
+  ierr = PetscSFLinkGetInUse(sf,munit,rootdata,leafdata,PETSC_OWN_POINTER,link);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&munit);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* root -> leaf of n host arrays, with one message per remote rank holding the entries of all the arrays */
+static PetscErrorCode PetscSFBcastAndOpBeginMultiple_Basic(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const *rootdata,void *const *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    link = NULL;
+  MPI_Request    *rootreqs = NULL,*leafreqs = NULL;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkCreateMultiple(sf,unit,n,rootdata[0],leafdata[0],op,PETSCSF_BCAST,&link);CHKERRQ(ierr);
+  ierr = PetscSFLinkGetMPIBuffersAndRequests(sf,link,PETSCSF_ROOT2LEAF,NULL,NULL,&rootreqs,&leafreqs);CHKERRQ(ierr);
+  ierr = MPI_Startall_irecv(sf->leafbuflen[PETSCSF_REMOTE],link->unit,sf->nleafreqs,leafreqs);CHKERRQ(ierr);
+  ierr = PetscSFLinkPackRootDataMultiple(sf,link,n,rootdata);CHKERRQ(ierr);
+  ierr = MPI_Startall_isend(bas->rootbuflen[PETSCSF_REMOTE],link->unit,bas->nrootreqs,rootreqs);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {ierr = PetscSFLinkBcastAndOpLocal(sf,link->base,rootdata[j],leafdata[j],op);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEndMultiple_Basic(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const *rootdata,void *const *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetInUseMultiple_Basic(sf,unit,n,rootdata[0],leafdata[0],&link);CHKERRQ(ierr);
+  ierr = PetscSFLinkMPIWaitall(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
+  ierr = PetscSFLinkUnpackLeafDataMultiple(sf,link,n,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFLinkReclaim(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* leaf -> root with reduction of n host arrays */
+static PetscErrorCode PetscSFReduceBeginMultiple_Basic(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const *leafdata,void *const *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    link = NULL;
+  MPI_Request    *rootreqs = NULL,*leafreqs = NULL;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkCreateMultiple(sf,unit,n,rootdata[0],leafdata[0],op,PETSCSF_REDUCE,&link);CHKERRQ(ierr);
+  ierr = PetscSFLinkGetMPIBuffersAndRequests(sf,link,PETSCSF_LEAF2ROOT,NULL,NULL,&rootreqs,&leafreqs);CHKERRQ(ierr);
+  ierr = MPI_Startall_irecv(bas->rootbuflen[PETSCSF_REMOTE],link->unit,bas->nrootreqs,rootreqs);CHKERRQ(ierr);
+  ierr = PetscSFLinkPackLeafDataMultiple(sf,link,n,leafdata);CHKERRQ(ierr);
+  ierr = MPI_Startall_isend(sf->leafbuflen[PETSCSF_REMOTE],link->unit,sf->nleafreqs,leafreqs);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {ierr = PetscSFLinkReduceLocal(sf,link->base,leafdata[j],rootdata[j],op);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEndMultiple_Basic(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const *leafdata,void *const *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetInUseMultiple_Basic(sf,unit,n,rootdata[0],leafdata[0],&link);CHKERRQ(ierr);
+  ierr = PetscSFLinkMPIWaitall(sf,link,PETSCSF_LEAF2ROOT);CHKERRQ(ierr);
+  ierr = PetscSFLinkUnpackRootDataMultiple(sf,link,n,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFLinkReclaim(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PETSC_INTERN PetscErrorCode PetscSFGetLeafRanks_Basic(PetscSF sf,PetscInt *niranks,const PetscMPIInt **iranks,const PetscInt **ioffset,const PetscInt **irootloc)
 {
   PetscSF_Basic *bas = (PetscSF_Basic*)sf->data;
@@ -385,12 +621,17 @@ PETSC_EXTERN PetscErrorCode PetscSFCreate_Basic(PetscSF sf)
   sf->ops->Reset                = PetscSFReset_Basic;
   sf->ops->Destroy              = PetscSFDestroy_Basic;
   sf->ops->View                 = PetscSFView_Basic;
+  sf->ops->SetFromOptions       = PetscSFSetFromOptions_Basic;
   sf->ops->BcastAndOpBegin      = PetscSFBcastAndOpBegin_Basic;
   sf->ops->BcastAndOpEnd        = PetscSFBcastAndOpEnd_Basic;
   sf->ops->ReduceBegin          = PetscSFReduceBegin_Basic;
   sf->ops->ReduceEnd            = PetscSFReduceEnd_Basic;
   sf->ops->FetchAndOpBegin      = PetscSFFetchAndOpBegin_Basic;
   sf->ops->FetchAndOpEnd        = PetscSFFetchAndOpEnd_Basic;
+  sf->ops->BcastAndOpBeginMultiple = PetscSFBcastAndOpBeginMultiple_Basic;
+  sf->ops->BcastAndOpEndMultiple   = PetscSFBcastAndOpEndMultiple_Basic;
+  sf->ops->ReduceBeginMultiple     = PetscSFReduceBeginMultiple_Basic;
+  sf->ops->ReduceEndMultiple       = PetscSFReduceEndMultiple_Basic;
   sf->ops->GetLeafRanks         = PetscSFGetLeafRanks_Basic;
   sf->ops->CreateEmbeddedSF     = PetscSFCreateEmbeddedSF_Basic;
 
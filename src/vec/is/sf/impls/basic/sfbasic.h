@@ -20,6 +20,14 @@ typedef struct _n_PetscSFLink* PetscSFLink;
   PetscSFPackOpt   rootpackopt_d[2];/* Copy of rootpackopt[] on device if needed */                                                \
   PetscBool        rootdups[2];     /* Indices of roots in irootloc[local/remote] have dups. Used for data-race test */            \
   PetscInt         nrootreqs;       /* Number of MPI reqests */                                                                    \
+  PetscBool        useshm;          /* Was moving data to and from ranks on the same node through shared memory requested? */       \
+  PetscBool        doshm;           /* ... and is it set up? Then the fields below are valid */                                    \
+  MPI_Comm         shmcomm;         /* Communicator of the ranks on this node, owned by the PetscShmComm of the SF */               \
+  PetscMPIInt      *leafshmrank;    /* [nranks-ndranks] Rank in shmcomm of each remote root rank, MPI_PROC_NULL if on another node */ \
+  PetscInt         *leafshmoffset;  /* [nranks-ndranks] Offset (in unit) of the roots for my leaves in the window of that rank */   \
+  PetscMPIInt      *rootshmrank;    /* [niranks-ndiranks] Rank in shmcomm of each remote leaf rank, MPI_PROC_NULL if on another node */ \
+  PetscInt         *rootshmoffset;  /* [niranks-ndiranks] Offset (in unit) of the leaves for my roots in the window of that rank */ \
+  PetscBool        usederived;      /* Send from and receive into root/leafdata with MPI derived datatypes when the remote indices form subblocks? */ \
   PetscSFLink      avail;           /* One or more entries per MPI Datatype, lazily constructed */                                 \
   PetscSFLink      inuse            /* Buffers being used for transactions that have not yet completed */
 
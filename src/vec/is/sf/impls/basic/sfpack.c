@@ -56,11 +56,19 @@
         u2 = u + opt->start[r]*MBS;                                                                          \
         X  = opt->X[r];                                                                                      \
         Y  = opt->Y[r];                                                                                      \
-        for (k=0; k<opt->dz[r]; k++)                                                                         \
-          for (j=0; j<opt->dy[r]; j++) {                                                                     \
-            ierr = PetscArraycpy(p2,u2+(X*Y*k+X*j)*MBS,opt->dx[r]*MBS);CHKERRQ(ierr);                        \
-            p2  += opt->dx[r]*MBS;                                                                           \
-          }                                                                                                  \
+        if (opt->dx[r] == 1) { /* Strided, copy the entries directly instead of calling memcpy for each */   \
+          for (k=0; k<opt->dz[r]; k++)                                                                       \
+            for (j=0; j<opt->dy[r]; j++) {                                                                   \
+              for (i=0; i<MBS; i++) p2[i] = u2[(X*Y*k+X*j)*MBS+i];                                           \
+              p2 += MBS;                                                                                     \
+            }                                                                                                \
+        } else {                                                                                             \
+          for (k=0; k<opt->dz[r]; k++)                                                                       \
+            for (j=0; j<opt->dy[r]; j++) {                                                                   \
+              ierr = PetscArraycpy(p2,u2+(X*Y*k+X*j)*MBS,opt->dx[r]*MBS);CHKERRQ(ierr);                      \
+              p2  += opt->dx[r]*MBS;                                                                         \
+            }                                                                                                \
+        }                                                                                                    \
       }                                                                                                      \
     } else {                                                                                                 \
       for (i=0; i<count; i++)                                                                                \
@@ -100,11 +108,19 @@
         u2 = u + opt->start[r]*MBS;                                                                          \
         X  = opt->X[r];                                                                                      \
         Y  = opt->Y[r];                                                                                      \
-        for (k=0; k<opt->dz[r]; k++)                                                                         \
-          for (j=0; j<opt->dy[r]; j++) {                                                                     \
-            ierr = PetscArraycpy(u2+(X*Y*k+X*j)*MBS,p,opt->dx[r]*MBS);CHKERRQ(ierr);                         \
-            p   += opt->dx[r]*MBS;                                                                           \
-          }                                                                                                  \
+        if (opt->dx[r] == 1) { /* Strided */                                                                 \
+          for (k=0; k<opt->dz[r]; k++)                                                                       \
+            for (j=0; j<opt->dy[r]; j++) {                                                                   \
+              for (i=0; i<MBS; i++) u2[(X*Y*k+X*j)*MBS+i] = p[i];                                            \
+              p += MBS;                                                                                      \
+            }                                                                                                \
+        } else {                                                                                             \
+          for (k=0; k<opt->dz[r]; k++)                                                                       \
+            for (j=0; j<opt->dy[r]; j++) {                                                                   \
+              ierr = PetscArraycpy(u2+(X*Y*k+X*j)*MBS,p,opt->dx[r]*MBS);CHKERRQ(ierr);                       \
+              p   += opt->dx[r]*MBS;                                                                         \
+            }                                                                                                \
+        }                                                                                                    \
       }                                                                                                      \
     } else {                                                                                                 \
       for (i=0; i<count; i++)                                                                                \
@@ -469,6 +485,145 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
 }
 #endif
 
+/*
+   When the SF moves data between ranks on the same node through shared memory, the host rootbuf and leafbuf of PETSCSF_REMOTE
+   of each link are in a window allocated with MPI_Win_allocate_shared() on the ranks of the node. Data for a rank on the node
+   is packed into the window and copied out of it by that rank, without going through MPI. Zero-byte messages tell the other
+   rank that the data is ready and that it has been copied, so that the window can be packed again. The persistent requests
+   of those ranks are created as usual but only started for PETSCSF_FETCH.
+*/
+static PetscErrorCode PetscSFLinkSetUpShm_Private(PetscSF sf,PetscSFLink link)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       i,nl = sf->nranks-sf->ndranks,nr = bas->niranks-bas->ndiranks;
+  size_t         rootbytes = bas->rootbuflen[PETSCSF_REMOTE]*link->unitbytes,leafbytes = sf->leafbuflen[PETSCSF_REMOTE]*link->unitbytes;
+  char           *base;
+  void           *ptr;
+  MPI_Aint       size;
+  PetscMPIInt    disp_unit;
+  MPI_Info       info;
+
+  PetscFunctionBegin;
+  ierr = MPI_Info_create(&info);CHKERRQ(ierr);
+  ierr = MPI_Info_set(info,"alloc_shared_noncontig","true");CHKERRQ(ierr);
+  ierr = MPI_Win_allocate_shared((MPI_Aint)(rootbytes+leafbytes),1,info,bas->shmcomm,&base,&link->shmwin);CHKERRQ(ierr);
+  ierr = MPI_Info_free(&info);CHKERRQ(ierr);
+  ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK,link->shmwin);CHKERRQ(ierr);
+  if (rootbytes) link->rootbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = base;
+  if (leafbytes) link->leafbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = base + rootbytes;
+
+  ierr = PetscMalloc3(nl,&link->leafshmpeer,nr,&link->rootshmpeer,2*(nl+nr),&link->shmreqs);CHKERRQ(ierr);
+  for (i=0; i<2*(nl+nr); i++) link->shmreqs[i] = MPI_REQUEST_NULL;
+  for (i=0; i<nl; i++) {
+    link->leafshmpeer[i] = NULL;
+    if (bas->leafshmrank[i] == MPI_PROC_NULL) continue;
+    ierr = MPI_Win_shared_query(link->shmwin,bas->leafshmrank[i],&size,&disp_unit,&ptr);CHKERRQ(ierr);
+    link->leafshmpeer[i] = (char*)ptr + bas->leafshmoffset[i]*link->unitbytes;
+  }
+  for (i=0; i<nr; i++) {
+    link->rootshmpeer[i] = NULL;
+    if (bas->rootshmrank[i] == MPI_PROC_NULL) continue;
+    ierr = MPI_Win_shared_query(link->shmwin,bas->rootshmrank[i],&size,&disp_unit,&ptr);CHKERRQ(ierr);
+    link->rootshmpeer[i] = (char*)ptr + bas->rootshmoffset[i]*link->unitbytes;
+  }
+  ierr = PetscCommGetNewTag(PetscObjectComm((PetscObject)sf),&link->shmtag[0]);CHKERRQ(ierr);
+  ierr = PetscCommGetNewTag(PetscObjectComm((PetscObject)sf),&link->shmtag[1]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Post the receives of the zero-byte messages: the receiving side waits for the data, the sending side for the copies */
+PetscErrorCode PetscSFLinkShmPost(PetscSF sf,PetscSFLink link,PetscSFDirection direction)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       i,nl = sf->nranks-sf->ndranks,nr = bas->niranks-bas->ndiranks;
+  MPI_Request    *lrecv = link->shmreqs,*rrecv = link->shmreqs+2*nl;
+  MPI_Comm       comm = PetscObjectComm((PetscObject)sf);
+  PetscMPIInt    ltag = link->shmtag[direction == PETSCSF_ROOT2LEAF ? 0 : 1],rtag = link->shmtag[direction == PETSCSF_ROOT2LEAF ? 1 : 0];
+
+  PetscFunctionBegin;
+  if (!link->useshm) PetscFunctionReturn(0);
+  for (i=0; i<nl; i++) {
+    if (bas->leafshmrank[i] != MPI_PROC_NULL) {ierr = MPI_Irecv(NULL,0,MPI_BYTE,sf->ranks[sf->ndranks+i],ltag,comm,&lrecv[i]);CHKERRQ(ierr);}
+  }
+  for (i=0; i<nr; i++) {
+    if (bas->rootshmrank[i] != MPI_PROC_NULL) {ierr = MPI_Irecv(NULL,0,MPI_BYTE,bas->iranks[bas->ndiranks+i],rtag,comm,&rrecv[i]);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Called by the sending side once the data is packed into the window */
+PetscErrorCode PetscSFLinkShmSignal(PetscSF sf,PetscSFLink link,PetscSFDirection direction)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       i,nl = sf->nranks-sf->ndranks,nr = bas->niranks-bas->ndiranks;
+  MPI_Request    *lsend = link->shmreqs+nl,*rsend = link->shmreqs+2*nl+nr;
+  MPI_Comm       comm = PetscObjectComm((PetscObject)sf);
+
+  PetscFunctionBegin;
+  if (!link->useshm) PetscFunctionReturn(0);
+  ierr = MPI_Win_sync(link->shmwin);CHKERRQ(ierr);
+  if (direction == PETSCSF_ROOT2LEAF) {
+    for (i=0; i<nr; i++) {
+      if (bas->rootshmrank[i] != MPI_PROC_NULL) {ierr = MPI_Isend(NULL,0,MPI_BYTE,bas->iranks[bas->ndiranks+i],link->shmtag[0],comm,&rsend[i]);CHKERRQ(ierr);}
+    }
+  } else {
+    for (i=0; i<nl; i++) {
+      if (bas->leafshmrank[i] != MPI_PROC_NULL) {ierr = MPI_Isend(NULL,0,MPI_BYTE,sf->ranks[sf->ndranks+i],link->shmtag[0],comm,&lsend[i]);CHKERRQ(ierr);}
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Called by the receiving side to copy the data of the ranks on the node from their windows into its buffer of PETSCSF_REMOTE */
+PetscErrorCode PetscSFLinkShmCopy(PetscSF sf,PetscSFLink link,PetscSFDirection direction)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       i,nl = sf->nranks-sf->ndranks,nr = bas->niranks-bas->ndiranks;
+  MPI_Request    *lrecv = link->shmreqs,*lsend = lrecv+nl,*rrecv = lsend+nl,*rsend = rrecv+nr;
+  MPI_Comm       comm = PetscObjectComm((PetscObject)sf);
+  char           *buf;
+
+  PetscFunctionBegin;
+  if (!link->useshm) PetscFunctionReturn(0);
+  if (direction == PETSCSF_ROOT2LEAF) {
+    ierr = MPI_Waitall(nl,lrecv,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    ierr = MPI_Win_sync(link->shmwin);CHKERRQ(ierr);
+    buf  = link->leafbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST];
+    for (i=0; i<nl; i++) {
+      if (bas->leafshmrank[i] == MPI_PROC_NULL) continue;
+      ierr = PetscMemcpy(buf+(sf->roffset[sf->ndranks+i]-sf->roffset[sf->ndranks])*link->unitbytes,link->leafshmpeer[i],(sf->roffset[sf->ndranks+i+1]-sf->roffset[sf->ndranks+i])*link->unitbytes);CHKERRQ(ierr);
+      ierr = MPI_Isend(NULL,0,MPI_BYTE,sf->ranks[sf->ndranks+i],link->shmtag[1],comm,&lsend[i]);CHKERRQ(ierr);
+    }
+  } else {
+    ierr = MPI_Waitall(nr,rrecv,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+    ierr = MPI_Win_sync(link->shmwin);CHKERRQ(ierr);
+    buf  = link->rootbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST];
+    for (i=0; i<nr; i++) {
+      if (bas->rootshmrank[i] == MPI_PROC_NULL) continue;
+      ierr = PetscMemcpy(buf+(bas->ioffset[bas->ndiranks+i]-bas->ioffset[bas->ndiranks])*link->unitbytes,link->rootshmpeer[i],(bas->ioffset[bas->ndiranks+i+1]-bas->ioffset[bas->ndiranks+i])*link->unitbytes);CHKERRQ(ierr);
+      ierr = MPI_Isend(NULL,0,MPI_BYTE,bas->iranks[bas->ndiranks+i],link->shmtag[1],comm,&rsend[i]);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Called by the sending side before the link is reused, waits until the ranks on the node have copied the data */
+PetscErrorCode PetscSFLinkShmWait(PetscSF sf,PetscSFLink link,PetscSFDirection direction)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       nl = sf->nranks-sf->ndranks,nr = bas->niranks-bas->ndiranks;
+
+  PetscFunctionBegin;
+  if (!link->useshm) PetscFunctionReturn(0);
+  ierr = MPI_Waitall(2*(nl+nr),link->shmreqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
    The routine Creates a communication link for the given operation. It first looks up its link cache. If
    there is a free & suitable one, it uses it. Otherwise it creates a new one.
@@ -484,8 +639,10 @@ PETSC_STATIC_INLINE int MPI_Type_dup(MPI_Datatype datatype,MPI_Datatype *newtype
 
    The routine is shared by SFBasic and SFNeighbor based on the fact they all deal with sparse graphs and
    need pack/unpack data.
+
+   With multiple, the link moves several arrays at once (see PetscSFLinkCreateMultiple()), so the data always goes through the buffers.
 */
-PetscErrorCode PetscSFLinkCreate(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,const void *leafdata,MPI_Op op,PetscSFOperation sfop,PetscSFLink *mylink)
+static PetscErrorCode PetscSFLinkCreate_Private(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,const void *leafdata,MPI_Op op,PetscSFOperation sfop,PetscBool multiple,PetscSFLink *mylink)
 {
   PetscErrorCode    ierr;
   PetscSF_Basic     *bas = (PetscSF_Basic*)sf->data;
@@ -493,7 +650,7 @@ PetscErrorCode PetscSFLinkCreate(PetscSF sf,MPI_Datatype unit,PetscMemType rootm
   PetscSFLink       *p,link;
   PetscSFDirection  direction;
   MPI_Request       *reqs = NULL;
-  PetscBool         match,rootdirect[2],leafdirect[2];
+  PetscBool         match,rootdirect[2],leafdirect[2],useshm,rootderived = PETSC_FALSE,leafderived = PETSC_FALSE;
   PetscMemType      rootmtype_mpi,leafmtype_mpi;   /* mtypes seen by MPI */
   PetscInt          rootdirect_mpi,leafdirect_mpi; /* root/leafdirect seen by MPI*/
 
@@ -514,6 +671,31 @@ PetscErrorCode PetscSFLinkCreate(PetscSF sf,MPI_Datatype unit,PetscMemType rootm
     }
   }
 
+  if (multiple) {
+    for (i=PETSCSF_LOCAL; i<=PETSCSF_REMOTE; i++) rootdirect[i] = leafdirect[i] = PETSC_FALSE;
+  }
+
+  /* With shared memory, the remote roots (for bcast) or leaves (for reduce) are packed into the window where the ranks on the node copy them from */
+  useshm = (bas->doshm && !multiple && rootmtype == PETSC_MEMTYPE_HOST && leafmtype == PETSC_MEMTYPE_HOST && sfop != PETSCSF_FETCH) ? PETSC_TRUE : PETSC_FALSE;
+  if (useshm) {
+    if (sfop == PETSCSF_BCAST) rootdirect[PETSCSF_REMOTE] = PETSC_FALSE;
+    else                       leafdirect[PETSCSF_REMOTE] = PETSC_FALSE;
+  }
+
+  /* With derived datatypes, the remote ranks whose indices form subblocks (so all remote ranks when there is a pack optimization plan) send roots (for bcast)
+     or leaves (for reduce) right from root/leafdata. Leaves are unique, so with MPIU_REPLACE bcast also receives right into leafdata.
+   */
+  if (bas->usederived && sf->persistent && !useshm && !multiple && rootmtype == PETSC_MEMTYPE_HOST && leafmtype == PETSC_MEMTYPE_HOST) {
+    if (sfop == PETSCSF_BCAST) {
+      rootderived = bas->rootpackopt[PETSCSF_REMOTE] ? PETSC_TRUE : PETSC_FALSE;
+      leafderived = (sf->leafpackopt[PETSCSF_REMOTE] && op == MPIU_REPLACE) ? PETSC_TRUE : PETSC_FALSE;
+    } else if (sfop == PETSCSF_REDUCE) {
+      leafderived = sf->leafpackopt[PETSCSF_REMOTE] ? PETSC_TRUE : PETSC_FALSE;
+    }
+    if (rootderived) rootdirect[PETSCSF_REMOTE] = PETSC_TRUE;
+    if (leafderived) leafdirect[PETSCSF_REMOTE] = PETSC_TRUE;
+  }
+
   if (sf->use_gpu_aware_mpi) {
     rootmtype_mpi = rootmtype;
     leafmtype_mpi = leafmtype;
@@ -566,6 +748,7 @@ PetscErrorCode PetscSFLinkCreate(PetscSF sf,MPI_Datatype unit,PetscMemType rootm
       }
     }
   }
+  if (bas->doshm) {ierr = PetscSFLinkSetUpShm_Private(sf,link);CHKERRQ(ierr);}
 
 found:
   if ((rootmtype == PETSC_MEMTYPE_DEVICE || leafmtype == PETSC_MEMTYPE_DEVICE) && !link->deviceinited) {ierr = PetscSFLinkSetUp_Device(sf,link,unit);CHKERRQ(ierr);}
@@ -625,6 +808,9 @@ found:
   }
   link->rootdirect_mpi  = rootdirect_mpi;
   link->leafdirect_mpi  = leafdirect_mpi;
+  link->useshm          = useshm;
+  link->rootderived     = rootderived;
+  link->leafderived     = leafderived;
   link->rootmtype       = rootmtype;
   link->leafmtype       = leafmtype;
   link->rootmtype_mpi   = rootmtype_mpi;
@@ -636,6 +822,71 @@ found:
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode PetscSFLinkCreate(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,const void *leafdata,MPI_Op op,PetscSFOperation sfop,PetscSFLink *mylink)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkCreate_Private(sf,unit,rootmtype,rootdata,leafmtype,leafdata,op,sfop,PETSC_FALSE,mylink);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Creates a link moving n host arrays of unit at once. The link is built for the unit MPI_Type_contiguous(n,unit), so each remote rank
+   gets one message holding its entries of all the arrays, one array after the other, see PetscSFLinkPackRootDataMultiple().
+   link->base is a link of unit whose routines pack and unpack each array. The first arrays are the keys of the link in PetscSFLinkGetInUse().
+*/
+PetscErrorCode PetscSFLinkCreateMultiple(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *rootdata,const void *leafdata,MPI_Op op,PetscSFOperation sfop,PetscSFLink *mylink)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    nn;
+  MPI_Datatype   munit;
+  PetscBool      match = PETSC_FALSE;
+  PetscSFLink    link;
+
+  PetscFunctionBegin;
+  ierr = PetscMPIIntCast(n,&nn);CHKERRQ(ierr);
+  ierr = MPI_Type_contiguous(nn,unit,&munit);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(&munit);CHKERRQ(ierr);
+  ierr = PetscSFLinkCreate_Private(sf,munit,PETSC_MEMTYPE_HOST,rootdata,PETSC_MEMTYPE_HOST,leafdata,op,sfop,PETSC_TRUE,&link);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&munit);CHKERRQ(ierr);
+  if (link->base) {ierr = MPIPetsc_Type_compare(unit,link->base->unit,&match);CHKERRQ(ierr);}
+  if (!match) {
+    if (link->base && !link->base->isbuiltin) {ierr = MPI_Type_free(&link->base->unit);CHKERRQ(ierr);}
+    ierr = PetscFree(link->base);CHKERRQ(ierr);
+    ierr = PetscNew(&link->base);CHKERRQ(ierr);
+    ierr = PetscSFLinkSetUp_Host(sf,link->base,unit);CHKERRQ(ierr);
+  }
+  *mylink = link;
+  PetscFunctionReturn(0);
+}
+
+/* Create for each rank of the pack optimization plan a datatype describing its subblock in units of the link, relative to the first entry.
+   The unit is resized to unitbytes so that the entries are laid out as the pack routines see them.
+*/
+static PetscErrorCode PetscSFLinkCreateDerivedTypes_Private(PetscSFLink link,PetscSFPackOpt opt,MPI_Datatype **dtypes)
+{
+  PetscErrorCode ierr;
+  PetscInt       r;
+  PetscMPIInt    dx,dy,dz;
+  MPI_Datatype   unit,plane;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(opt->n,dtypes);CHKERRQ(ierr);
+  ierr = MPI_Type_create_resized(link->unit,0,(MPI_Aint)link->unitbytes,&unit);CHKERRQ(ierr);
+  for (r=0; r<opt->n; r++) {
+    ierr = PetscMPIIntCast(opt->dx[r],&dx);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(opt->dy[r],&dy);CHKERRQ(ierr);
+    ierr = PetscMPIIntCast(opt->dz[r],&dz);CHKERRQ(ierr);
+    ierr = MPI_Type_create_hvector(dy,dx,(MPI_Aint)(opt->X[r]*link->unitbytes),unit,&plane);CHKERRQ(ierr);
+    ierr = MPI_Type_create_hvector(dz,1,(MPI_Aint)(opt->X[r]*opt->Y[r]*link->unitbytes),plane,&(*dtypes)[r]);CHKERRQ(ierr);
+    ierr = MPI_Type_commit(&(*dtypes)[r]);CHKERRQ(ierr);
+    ierr = MPI_Type_free(&plane);CHKERRQ(ierr);
+  }
+  ierr = MPI_Type_free(&unit);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* Return root/leaf buffers and MPI requests attached to the link for MPI communication in the given direction.
    If the sf uses persistent requests and the requests have not been initialized, then initialize them.
 */
@@ -657,7 +908,14 @@ PetscErrorCode PetscSFLinkGetMPIBuffersAndRequests(PetscSF sf,PetscSFLink link,P
   if (sf->persistent) {
     if (rootreqs && bas->rootbuflen[PETSCSF_REMOTE] && !link->rootreqsinited[direction][rootmtype_mpi][rootdirect_mpi]) {
       ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
-      if (direction == PETSCSF_LEAF2ROOT) {
+      if (link->rootderived && rootdirect_mpi) { /* Send the subblocks right from rootdata, only for PETSCSF_ROOT2LEAF */
+        PetscSFPackOpt opt = bas->rootpackopt[PETSCSF_REMOTE];
+
+        if (!link->rootdtypes) {ierr = PetscSFLinkCreateDerivedTypes_Private(link,opt,&link->rootdtypes);CHKERRQ(ierr);}
+        for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
+          ierr = MPI_Send_init((char*)link->rootdata+opt->start[j]*link->unitbytes,1,link->rootdtypes[j],bas->iranks[i],link->tag,comm,link->rootreqs[direction][rootmtype_mpi][rootdirect_mpi]+j);CHKERRQ(ierr);
+        }
+      } else if (direction == PETSCSF_LEAF2ROOT) {
         for (i=ndrootranks,j=0; i<nrootranks; i++,j++) {
           disp = (rootoffset[i] - rootoffset[ndrootranks])*link->unitbytes;
           ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
@@ -675,7 +933,17 @@ PetscErrorCode PetscSFLinkGetMPIBuffersAndRequests(PetscSF sf,PetscSFLink link,P
 
     if (leafreqs && sf->leafbuflen[PETSCSF_REMOTE] && !link->leafreqsinited[direction][leafmtype_mpi][leafdirect_mpi]) {
       ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL,NULL);CHKERRQ(ierr);
-      if (direction == PETSCSF_LEAF2ROOT) {
+      if (link->leafderived && leafdirect_mpi) { /* Send the subblocks right from or receive them right into leafdata */
+        PetscSFPackOpt opt = sf->leafpackopt[PETSCSF_REMOTE];
+        char           *buf;
+
+        if (!link->leafdtypes) {ierr = PetscSFLinkCreateDerivedTypes_Private(link,opt,&link->leafdtypes);CHKERRQ(ierr);}
+        for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
+          buf = (char*)link->leafdata+opt->start[j]*link->unitbytes;
+          if (direction == PETSCSF_LEAF2ROOT) {ierr = MPI_Send_init(buf,1,link->leafdtypes[j],sf->ranks[i],link->tag,comm,link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi]+j);CHKERRQ(ierr);}
+          else {ierr = MPI_Recv_init(buf,1,link->leafdtypes[j],sf->ranks[i],link->tag,comm,link->leafreqs[direction][leafmtype_mpi][leafdirect_mpi]+j);CHKERRQ(ierr);}
+        }
+      } else if (direction == PETSCSF_LEAF2ROOT) {
         for (i=ndleafranks,j=0; i<nleafranks; i++,j++) {
           disp = (leafoffset[i] - leafoffset[ndleafranks])*link->unitbytes;
           ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
@@ -748,7 +1016,20 @@ PetscErrorCode PetscSFLinkDestroy(PetscSF sf,PetscSFLink *avail)
   PetscFunctionBegin;
   for (; link; link=next) {
     next = link->next;
+    if (bas->doshm) { /* The buffers in the window are not freed with PetscFree() */
+      link->rootbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = NULL;
+      link->leafbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = NULL;
+      ierr = MPI_Win_unlock_all(link->shmwin);CHKERRQ(ierr);
+      ierr = MPI_Win_free(&link->shmwin);CHKERRQ(ierr);
+      ierr = PetscFree3(link->leafshmpeer,link->rootshmpeer,link->shmreqs);CHKERRQ(ierr);
+    }
+    for (i=0; link->rootdtypes && i<bas->niranks-bas->ndiranks; i++) {ierr = MPI_Type_free(&link->rootdtypes[i]);CHKERRQ(ierr);}
+    for (i=0; link->leafdtypes && i<sf->nranks-sf->ndranks; i++) {ierr = MPI_Type_free(&link->leafdtypes[i]);CHKERRQ(ierr);}
+    ierr = PetscFree(link->rootdtypes);CHKERRQ(ierr);
+    ierr = PetscFree(link->leafdtypes);CHKERRQ(ierr);
     if (!link->isbuiltin) {ierr = MPI_Type_free(&link->unit);CHKERRQ(ierr);}
+    if (link->base && !link->base->isbuiltin) {ierr = MPI_Type_free(&link->base->unit);CHKERRQ(ierr);}
+    ierr = PetscFree(link->base);CHKERRQ(ierr);
     for (i=0; i<nreqs; i++) { /* Persistent reqs must be freed. */
       if (link->reqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->reqs[i]);CHKERRQ(ierr);}
     }
@@ -1435,6 +1716,118 @@ PetscErrorCode PetscSFLinkFetchRootData(PetscSF sf,PetscSFLink link,PetscSFScope
   PetscFunctionReturn(0);
 }
 
+/* Pack the entries given by (start,idx) of the remote ranks in [d,nranks) from n arrays. The message of each rank holds its entries of data[0], then
+   its entries of data[1] etc., so each array is packed with the routines of the base link and the message is sent in units of the link */
+static PetscErrorCode PetscSFLinkPackMultiple_Private(PetscSFLink link,PetscInt d,PetscInt nranks,const PetscInt *offset,PetscInt start,const PetscInt *idx,PetscInt n,const void *const *data,char *buf)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    base = link->base;
+  PetscInt       i,j,off,m;
+
+  PetscFunctionBegin;
+  for (i=d; i<nranks; i++) {
+    off = offset[i]-offset[d];
+    m   = offset[i+1]-offset[i];
+    for (j=0; j<n; j++) {ierr = (*base->h_Pack)(base,m,start+off,NULL,idx ? idx+off : NULL,data[j],buf+(off*n+j*m)*base->unitbytes);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFLinkUnpackMultiple_Private(PetscSF sf,PetscSFLink link,PetscInt d,PetscInt nranks,const PetscInt *offset,PetscInt start,const PetscInt *idx,PetscBool dups,PetscInt n,void *const *data,const char *buf,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    base = link->base;
+  PetscInt       i,j,off,m;
+  PetscErrorCode (*UnpackAndOp)(PetscSFLink,PetscInt,PetscInt,PetscSFPackOpt,const PetscInt*,void*,const void*) = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetUnpackAndOp(base,PETSC_MEMTYPE_HOST,op,dups,&UnpackAndOp);CHKERRQ(ierr);
+  for (i=d; i<nranks; i++) {
+    off = offset[i]-offset[d];
+    m   = offset[i+1]-offset[i];
+    for (j=0; j<n; j++) {
+      if (UnpackAndOp) {ierr = (*UnpackAndOp)(base,m,start+off,NULL,idx ? idx+off : NULL,data[j],buf+(off*n+j*m)*base->unitbytes);CHKERRQ(ierr);}
+      else {ierr = PetscSFLinkUnpackDataWithMPIReduceLocal(sf,base,m,start+off,idx ? idx+off : NULL,data[j],buf+(off*n+j*m)*base->unitbytes,op);CHKERRQ(ierr);}
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Pack the remote roots of n arrays to the root buffer of a link from PetscSFLinkCreateMultiple() */
+PetscErrorCode PetscSFLinkPackRootDataMultiple(PetscSF sf,PetscSFLink link,PetscInt n,const void *const *rootdata)
+{
+  PetscErrorCode ierr;
+  PetscInt       nrootranks,ndrootranks,count,start;
+  const PetscInt *rootoffset,*rootindices;
+  PetscSFPackOpt opt;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetRootPackOptAndIndices(sf,link,PETSC_MEMTYPE_HOST,PETSCSF_REMOTE,&count,&start,&opt,&rootindices);CHKERRQ(ierr);
+  if (!count) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFLinkPackMultiple_Private(link,ndrootranks,nrootranks,rootoffset,start,rootindices,n,rootdata,link->rootbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Pack the remote leaves of n arrays to the leaf buffer of a link from PetscSFLinkCreateMultiple() */
+PetscErrorCode PetscSFLinkPackLeafDataMultiple(PetscSF sf,PetscSFLink link,PetscInt n,const void *const *leafdata)
+{
+  PetscErrorCode ierr;
+  PetscInt       nleafranks,ndleafranks,count,start;
+  const PetscInt *leafoffset,*leafindices;
+  PetscSFPackOpt opt;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetLeafPackOptAndIndices(sf,link,PETSC_MEMTYPE_HOST,PETSCSF_REMOTE,&count,&start,&opt,&leafindices);CHKERRQ(ierr);
+  if (!count) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscSFLinkPackMultiple_Private(link,ndleafranks,nleafranks,leafoffset,start,leafindices,n,leafdata,link->leafbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(PETSCSF_Pack,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Unpack the root buffer of a link from PetscSFLinkCreateMultiple() to the remote roots of n arrays */
+PetscErrorCode PetscSFLinkUnpackRootDataMultiple(PetscSF sf,PetscSFLink link,PetscInt n,void *const *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSF_Basic  *bas = (PetscSF_Basic*)sf->data;
+  PetscInt       j,nrootranks,ndrootranks,count,start;
+  const PetscInt *rootoffset,*rootindices;
+  PetscSFPackOpt opt;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetRootPackOptAndIndices(sf,link,PETSC_MEMTYPE_HOST,PETSCSF_REMOTE,&count,&start,&opt,&rootindices);CHKERRQ(ierr);
+  if (!count) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,NULL,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFLinkUnpackMultiple_Private(sf,link,ndrootranks,nrootranks,rootoffset,start,rootindices,bas->rootdups[PETSCSF_REMOTE],n,rootdata,link->rootbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST],op);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {ierr = PetscSFLinkLogFlopsAfterUnpackRootData(sf,link->base,PETSCSF_REMOTE,op);CHKERRQ(ierr);}
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Unpack the leaf buffer of a link from PetscSFLinkCreateMultiple() to the remote leaves of n arrays */
+PetscErrorCode PetscSFLinkUnpackLeafDataMultiple(PetscSF sf,PetscSFLink link,PetscInt n,void *const *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscInt       j,nleafranks,ndleafranks,count,start;
+  const PetscInt *leafoffset,*leafindices;
+  PetscSFPackOpt opt;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetLeafPackOptAndIndices(sf,link,PETSC_MEMTYPE_HOST,PETSCSF_REMOTE,&count,&start,&opt,&leafindices);CHKERRQ(ierr);
+  if (!count) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,&leafoffset,NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscSFLinkUnpackMultiple_Private(sf,link,ndleafranks,nleafranks,leafoffset,start,leafindices,sf->leafdups[PETSCSF_REMOTE],n,leafdata,link->leafbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST],op);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {ierr = PetscSFLinkLogFlopsAfterUnpackLeafData(sf,link->base,PETSCSF_REMOTE,op);CHKERRQ(ierr);}
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /* Bcast rootdata to leafdata locally (i.e., only for local communication - PETSCSF_LOCAL) */
 PetscErrorCode PetscSFLinkBcastAndOpLocal(PetscSF sf,PetscSFLink link,const void *rootdata,void *leafdata,MPI_Op op)
 {
@@ -1526,6 +1919,67 @@ PetscErrorCode PetscSFLinkFetchAndOpLocal(PetscSF sf,PetscSFLink link,void *root
   PetscFunctionReturn(0);
 }
 
+/*
+  Find out if the indices of one rank form a 3D subblock start+X*Y*k+X*j+i for i<dx, j<dy, k<dz of an array with row length X and plane size X*Y.
+  Contiguous indices are the subblock with dy=dz=1 and strided ones the subblock with dx=dz=1 and stride X.
+
+   Input Parameters:
+  +  m       - Number of indices, m > 0
+  -  idx     - [m] The indices
+
+   Output Parameters:
+  +  start,dx,dy,dz,X,Y - The subblock, only valid when found
+  -  found   - Do the indices form a subblock?
+*/
+PetscErrorCode PetscSFAnalyzeIndices(PetscInt m,const PetscInt *idx,PetscInt *start,PetscInt *dx,PetscInt *dy,PetscInt *dz,PetscInt *X,PetscInt *Y,PetscBool *found)
+{
+  PetscInt p,i,j,k,s,nx,ny,nz,nynz,lx,ly;
+
+  PetscFunctionBegin;
+  *found = PETSC_FALSE;
+  s      = idx[0]; /* First index */
+  p      = 1;
+
+  /* Search in X dimension */
+  for (nx=1; nx<m; nx++,p++) {
+    if (s+nx != idx[p]) break;
+  }
+
+  nynz = m/nx;
+  lx   = nynz > 1 ? (idx[p]-s) : nx;
+  /* Not a subblock if m is not a multiple of nx, or some unrecognized pattern is found */
+  if (m%nx || lx <= 0) PetscFunctionReturn(0);
+  for (ny=1; ny<nynz; ny++) { /* Search in Y dimension */
+    for (i=0; i<nx; i++,p++) {
+      if (s+lx*ny+i != idx[p]) {
+        if (i) PetscFunctionReturn(0); /* The pattern is violated in the middle of an x-walk */
+        else goto Z_dimension;
+      }
+    }
+  }
+
+Z_dimension:
+  nz = m/(nx*ny);
+  ly = nz > 1 ? (idx[p]-s)/lx : ny;
+  /* Not a subblock if m is not a multiple of nx*ny, or some unrecognized pattern is found */
+  if (m%(nx*ny) || ly <= 0) PetscFunctionReturn(0);
+  for (k=1; k<nz; k++) { /* Go through Z dimension to see if remaining indices follow the pattern */
+    for (j=0; j<ny; j++) {
+      for (i=0; i<nx; i++,p++) {
+        if (s+lx*ly*k+lx*j+i != idx[p]) PetscFunctionReturn(0);
+      }
+    }
+  }
+  *start = s;
+  *dx    = nx;
+  *dy    = ny;
+  *dz    = nz;
+  *X     = lx;
+  *Y     = ly;
+  *found = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
 /*
   Create per-rank pack/unpack optimizations based on indice patterns
 
@@ -1540,7 +1994,7 @@ PetscErrorCode PetscSFLinkFetchAndOpLocal(PetscSF sf,PetscSFLink link,void *root
 PetscErrorCode PetscSFCreatePackOpt(PetscInt n,const PetscInt *offset,const PetscInt *idx,PetscSFPackOpt *out)
 {
   PetscErrorCode ierr;
-  PetscInt       r,p,start,i,j,k,dx,dy,dz,dydz,m,X,Y;
+  PetscInt       r;
   PetscBool      optimizable = PETSC_TRUE;
   PetscSFPackOpt opt;
 
@@ -1556,51 +2010,10 @@ PetscErrorCode PetscSFCreatePackOpt(PetscInt n,const PetscInt *offset,const Pets
   opt->X      = opt->array + 5*n + 2;
   opt->Y      = opt->array + 6*n + 2;
 
-  for (r=0; r<n; r++) { /* For each destination rank */
-    m     = offset[r+1] - offset[r]; /* Total number of indices for this rank. We want to see if m can be factored into dx*dy*dz */
-    p     = offset[r];
-    start = idx[p]; /* First index for this rank */
-    p++;
-
-    /* Search in X dimension */
-    for (dx=1; dx<m; dx++,p++) {
-      if (start+dx != idx[p]) break;
-    }
-
-    dydz = m/dx;
-    X    = dydz > 1 ? (idx[p]-start) : dx;
-    /* Not optimizable if m is not a multiple of dx, or some unrecognized pattern is found */
-    if (m%dx || X <= 0) {optimizable = PETSC_FALSE; goto finish;}
-    for (dy=1; dy<dydz; dy++) { /* Search in Y dimension */
-      for (i=0; i<dx; i++,p++) {
-        if (start+X*dy+i != idx[p]) {
-          if (i) {optimizable = PETSC_FALSE; goto finish;} /* The pattern is violated in the middle of an x-walk */
-          else goto Z_dimension;
-        }
-      }
-    }
-
-Z_dimension:
-    dz = m/(dx*dy);
-    Y  = dz > 1 ? (idx[p]-start)/X : dy;
-    /* Not optimizable if m is not a multiple of dx*dy, or some unrecognized pattern is found */
-    if (m%(dx*dy) || Y <= 0) {optimizable = PETSC_FALSE; goto finish;}
-    for (k=1; k<dz; k++) { /* Go through Z dimension to see if remaining indices follow the pattern */
-      for (j=0; j<dy; j++) {
-        for (i=0; i<dx; i++,p++) {
-          if (start+X*Y*k+X*j+i != idx[p]) {optimizable = PETSC_FALSE; goto finish;}
-        }
-      }
-    }
-    opt->start[r] = start;
-    opt->dx[r]    = dx;
-    opt->dy[r]    = dy;
-    opt->dz[r]    = dz;
-    opt->X[r]     = X;
-    opt->Y[r]     = Y;
+  for (r=0; r<n && optimizable; r++) { /* For each destination rank */
+    ierr = PetscSFAnalyzeIndices(offset[r+1]-offset[r],idx+offset[r],&opt->start[r],&opt->dx[r],&opt->dy[r],&opt->dz[r],&opt->X[r],&opt->Y[r],&optimizable);CHKERRQ(ierr);
   }
 
-finish:
   /* If not optimizable, free arrays to save memory */
   if (!n || !optimizable) {
     ierr = PetscFree(opt->array);CHKERRQ(ierr);
@@ -160,6 +160,19 @@ struct _n_PetscSFLink {
   PetscBool    rootreqsinited[2][2][2];      /* Are root requests initialized? Also in layout of [PETSCSF_DIRECTION][PETSC_MEMTYPE][rootdirect_mpi]*/
   PetscBool    leafreqsinited[2][2][2];      /* Are leaf requests initialized? Also in layout of [PETSCSF_DIRECTION][PETSC_MEMTYPE][leafdirect_mpi]*/
   MPI_Request  *reqs;                        /* An array of length (nrootreqs+nleafreqs)*8. Pointers in rootreqs[][][] and leafreqs[][][] point here */
+  /* For ranks on the same node when the SF moves data through shared memory, see PetscSFLinkSetUpShm_Private() */
+  MPI_Win      shmwin;                       /* Window holding the host rootbuf and leafbuf of PETSCSF_REMOTE on all ranks of the node */
+  PetscBool    useshm;                       /* Does the current operation on the link use the window for ranks on the node? */
+  PetscMPIInt  shmtag[2];                    /* Tags of the zero-byte messages saying that data is ready and that it has been copied */
+  char         **leafshmpeer;                /* [nranks-ndranks] Roots for my leaves in the window of each remote root rank on the node */
+  char         **rootshmpeer;                /* [niranks-ndiranks] Leaves for my roots in the window of each remote leaf rank on the node */
+  MPI_Request  *shmreqs;                     /* [2*(nranks-ndranks)+2*(niranks-ndiranks)] Requests of the zero-byte messages */
+  /* For remote ranks whose indices form subblocks when the SF uses MPI derived datatypes, see PetscSFLinkCreate() */
+  PetscBool    rootderived,leafderived;      /* Do the remote requests of the current operation use root/leafdata with derived datatypes instead of buffers? */
+  MPI_Datatype *rootdtypes;                  /* [niranks-ndiranks] Subblock of the roots of each remote leaf rank, in unit. Lazily created */
+  MPI_Datatype *leafdtypes;                  /* [nranks-ndranks] Subblock of the leaves of each remote root rank, in unit. Lazily created */
+  /* For operations moving several arrays at once, see PetscSFLinkCreateMultiple() */
+  PetscSFLink  base;                         /* Link of the unit of one array, whose routines pack and unpack each array. Lazily created */
   PetscSFLink  next;
 };
 
@@ -167,6 +180,7 @@ PETSC_INTERN PetscErrorCode PetscSFSetErrorOnUnsupportedOverlap(PetscSF,MPI_Data
 
 /* Create/setup/retrieve/destroy a link */
 PETSC_INTERN PetscErrorCode PetscSFLinkCreate(PetscSF,MPI_Datatype,PetscMemType,const void*,PetscMemType,const void*,MPI_Op,PetscSFOperation,PetscSFLink*);
+PETSC_INTERN PetscErrorCode PetscSFLinkCreateMultiple(PetscSF,MPI_Datatype,PetscInt,const void*,const void*,MPI_Op,PetscSFOperation,PetscSFLink*);
 PETSC_INTERN PetscErrorCode PetscSFLinkSetUp_Host(PetscSF,PetscSFLink,MPI_Datatype);
 #if defined(PETSC_HAVE_CUDA)
 PETSC_INTERN PetscErrorCode PetscSFLinkSetUp_Device(PetscSF,PetscSFLink,MPI_Datatype);
@@ -200,10 +214,23 @@ PETSC_INTERN PetscErrorCode PetscSFLinkUnpackRootData(PetscSF,PetscSFLink,PetscS
 PETSC_INTERN PetscErrorCode PetscSFLinkUnpackLeafData(PetscSF,PetscSFLink,PetscSFScope,void*,MPI_Op);
 PETSC_INTERN PetscErrorCode PetscSFLinkFetchRootData (PetscSF,PetscSFLink,PetscSFScope,void*,MPI_Op);
 
+/* Pack/Unpack the remote part of several arrays with a link from PetscSFLinkCreateMultiple() */
+PETSC_INTERN PetscErrorCode PetscSFLinkPackRootDataMultiple  (PetscSF,PetscSFLink,PetscInt,const void*const*);
+PETSC_INTERN PetscErrorCode PetscSFLinkPackLeafDataMultiple  (PetscSF,PetscSFLink,PetscInt,const void*const*);
+PETSC_INTERN PetscErrorCode PetscSFLinkUnpackRootDataMultiple(PetscSF,PetscSFLink,PetscInt,void*const*,MPI_Op);
+PETSC_INTERN PetscErrorCode PetscSFLinkUnpackLeafDataMultiple(PetscSF,PetscSFLink,PetscInt,void*const*,MPI_Op);
+
 PETSC_INTERN PetscErrorCode PetscSFLinkBcastAndOpLocal(PetscSF,PetscSFLink,const void*,void*,MPI_Op);
 PETSC_INTERN PetscErrorCode PetscSFLinkReduceLocal(PetscSF,PetscSFLink,const void*,void*,MPI_Op);
 PETSC_INTERN PetscErrorCode PetscSFLinkFetchAndOpLocal(PetscSF,PetscSFLink,void*,const void*,void*,MPI_Op);
 
+/* Move data between ranks on the same node through the shared window of the link */
+PETSC_INTERN PetscErrorCode PetscSFLinkShmPost(PetscSF,PetscSFLink,PetscSFDirection);
+PETSC_INTERN PetscErrorCode PetscSFLinkShmSignal(PetscSF,PetscSFLink,PetscSFDirection);
+PETSC_INTERN PetscErrorCode PetscSFLinkShmCopy(PetscSF,PetscSFLink,PetscSFDirection);
+PETSC_INTERN PetscErrorCode PetscSFLinkShmWait(PetscSF,PetscSFLink,PetscSFDirection);
+
+PETSC_INTERN PetscErrorCode PetscSFAnalyzeIndices(PetscInt,const PetscInt*,PetscInt*,PetscInt*,PetscInt*,PetscInt*,PetscInt*,PetscInt*,PetscBool*);
 PETSC_INTERN PetscErrorCode PetscSFSetUpPackFields(PetscSF sf);
 PETSC_INTERN PetscErrorCode PetscSFResetPackFields(PetscSF sf);
 
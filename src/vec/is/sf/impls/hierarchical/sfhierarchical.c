@@ -0,0 +1,483 @@
+#include <petsc/private/sfimpl.h> /*I "petscsf.h" I*/
+
+/*
+   PETSCSFHIERARCHICAL moves the data of the edges whose root and leaf are on different nodes through one leader rank per node:
+   the roots are gathered to the leader of their node, the leaders exchange the data of all the edges between two nodes in one
+   message, and the leader of the node of the leaves scatters it to them. The edges within a node are handled by a plain SF.
+
+   Every off-node edge has a slot in the "out" buffer of the leader of the node of its root and a slot in the "in" buffer of
+   the leader of the node of its leaf. The stages are four PETSCSFBASIC (or PETSCSFNEIGHBOR) SFs built at setup:
+
+     direct  - the on-node edges, with the roots and leaves of the user
+     gather  - leaves are the out slots on the leader, roots are the roots of the user on the node
+     inter   - leaves are the out slots, roots are the in slots on the leader of the other node
+     scatter - leaves are the in slots on the leader, roots are the leaf locations of the user on the node
+
+   so a bcast is gather (bcast), inter (reduce with replace), scatter (reduce with the op), and a reduce goes the other way.
+*/
+
+typedef struct _n_PetscSFHierLink *PetscSFHierLink;
+struct _n_PetscSFHierLink {
+  MPI_Datatype     unit;
+  MPI_Aint         extent;
+  PetscSFDirection direction;
+  const void       *rootdata,*leafdata; /* Key of the operation using the link */
+  char             *inbuf,*outbuf;      /* Values of the off-node edges in the in and out slots of a leader */
+  PetscSFHierLink  next;
+};
+
+typedef struct {
+  PetscInt        nodesize;             /* Number of consecutive ranks taken as one node, or 0 for the shared memory nodes of the machine */
+  PetscMPIInt     leader;               /* Rank of the leader of my node */
+  PetscMPIInt     nnoderanks;           /* Number of ranks on my node */
+  PetscInt        nin,nout;             /* Number of in and out slots, zero on ranks that are not leaders */
+  PetscInt        nflatmsgs;            /* Number of messages the ranks of my node would send between nodes without aggregation, on the leader */
+  PetscSF         direct,gather,inter,scatter;
+  PetscSF         flat;                 /* PETSCSFBASIC SF with the graph of the user, built on demand for PetscSFFetchAndOp() and PetscSFGetLeafRanks() */
+  PetscSFHierLink inuse,avail;
+} PetscSF_Hierarchical;
+
+/* Creates an internal SF with the given graph, its options have the prefix of sf followed by the given one */
+static PetscErrorCode PetscSFHierarchicalCreateSF_Private(PetscSF sf,PetscSFType type,const char prefix[],PetscInt nroots,PetscInt nleaves,PetscInt *ilocal,PetscSFNode *iremote,PetscSF *newsf)
+{
+  PetscErrorCode ierr;
+  const char     *sfprefix;
+
+  PetscFunctionBegin;
+  ierr = PetscSFCreate(PetscObjectComm((PetscObject)sf),newsf);CHKERRQ(ierr);
+  ierr = PetscObjectGetOptionsPrefix((PetscObject)sf,&sfprefix);CHKERRQ(ierr);
+  ierr = PetscObjectSetOptionsPrefix((PetscObject)*newsf,sfprefix);CHKERRQ(ierr);
+  ierr = PetscObjectAppendOptionsPrefix((PetscObject)*newsf,prefix);CHKERRQ(ierr);
+  ierr = PetscSFSetType(*newsf,type);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(*newsf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(*newsf,nroots,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(*newsf);CHKERRQ(ierr);
+  ierr = PetscLogObjectParent((PetscObject)sf,(PetscObject)*newsf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFHierarchicalGetFlatSF_Private(PetscSF sf,PetscSF *flat)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+  PetscInt             *ilocal = NULL;
+  PetscSFNode          *iremote;
+
+  PetscFunctionBegin;
+  if (!hsf->flat) {
+    if (sf->mine) {
+      ierr = PetscMalloc1(sf->nleaves,&ilocal);CHKERRQ(ierr);
+      ierr = PetscArraycpy(ilocal,sf->mine,sf->nleaves);CHKERRQ(ierr);
+    }
+    ierr = PetscMalloc1(sf->nleaves,&iremote);CHKERRQ(ierr);
+    ierr = PetscArraycpy(iremote,sf->remote,sf->nleaves);CHKERRQ(ierr);
+    ierr = PetscSFHierarchicalCreateSF_Private(sf,PETSCSFBASIC,"flat_",sf->nroots,sf->nleaves,ilocal,iremote,&hsf->flat);CHKERRQ(ierr);
+  }
+  *flat = hsf->flat;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFHierarchicalGetLink_Private(PetscSF sf,MPI_Datatype unit,PetscSFDirection direction,const void *rootdata,const void *leafdata,PetscSFHierLink *mylink)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+  PetscSFHierLink      link,*p;
+  MPI_Aint             lb,extent;
+
+  PetscFunctionBegin;
+  for (link=hsf->inuse; link; link=link->next) {
+    if (link->unit == unit && link->rootdata == rootdata && link->leafdata == leafdata) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Communication already in progress on this data with PETSCSFHIERARCHICAL, call the End routine first");
+  }
+  ierr = MPI_Type_get_extent(unit,&lb,&extent);CHKERRQ(ierr);
+  for (p=&hsf->avail; (link=*p); p=&link->next) {
+    if (link->extent == extent) {*p = link->next; break;}
+  }
+  if (!link) {
+    ierr = PetscNew(&link);CHKERRQ(ierr);
+    link->extent = extent;
+    /* One slot at least so that the buffers of the concurrent operations have distinct addresses on all the ranks */
+    ierr = PetscMalloc2(PetscMax(hsf->nin,1)*extent,&link->inbuf,PetscMax(hsf->nout,1)*extent,&link->outbuf);CHKERRQ(ierr);
+  }
+  link->unit      = unit;
+  link->direction = direction;
+  link->rootdata  = rootdata;
+  link->leafdata  = leafdata;
+  link->next      = hsf->inuse;
+  hsf->inuse      = link;
+  *mylink         = link;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFHierarchicalFindLink_Private(PetscSF sf,MPI_Datatype unit,PetscSFDirection direction,const void *rootdata,const void *leafdata,PetscSFHierLink *mylink)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscSFHierLink      link,*p;
+
+  PetscFunctionBegin;
+  for (p=&hsf->inuse; (link=*p); p=&link->next) {
+    if (link->unit == unit && link->direction == direction && link->rootdata == rootdata && link->leafdata == leafdata) {
+      *p         = link->next; /* Move the link to the available ones, its buffers are not used once the End routine returns */
+      link->next = hsf->avail;
+      hsf->avail = link;
+      *mylink    = link;
+      PetscFunctionReturn(0);
+    }
+  }
+  SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Could not find the communication in progress on this data with PETSCSFHIERARCHICAL, was the Begin routine called?");
+  PetscFunctionReturn(0);
+}
+
+/* Every rank finds the leader of its node and sends the off-node edges of its leaves to it */
+static PetscErrorCode PetscSFSetUp_Hierarchical(PetscSF sf)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+  MPI_Comm             comm,nodecomm;
+  PetscMPIInt          rank,size,noderank,*leaders,info[2],*ninfo = NULL,*counts = NULL,*displs = NULL,n;
+  PetscInt             i,j,k,ndirect = 0,nedges,nflat = 0,*edges,*nodeedges = NULL,*dilocal,nleafspace;
+  PetscSFNode          *diremote,*sremote,*tremote,*tgsrc,*tidst,*gsrc,*idst;
+  PetscSF              tmp;
+  const PetscInt       *degree;
+  PetscSFType          intertype = PETSCSFBASIC;
+
+  PetscFunctionBegin;
+  ierr = PetscSFSetUpRanks(sf,MPI_GROUP_EMPTY);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+
+  /* The leader of a node is its lowest rank */
+  if (hsf->nodesize > 0) {
+    hsf->leader = (PetscMPIInt)((rank/hsf->nodesize)*hsf->nodesize);
+  } else {
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    PetscShmComm pshmcomm;
+
+    ierr = PetscShmCommGet(comm,&pshmcomm);CHKERRQ(ierr);
+    ierr = PetscShmCommLocalToGlobal(pshmcomm,0,&hsf->leader);CHKERRQ(ierr);
+#else
+    hsf->leader = rank;
+#endif
+  }
+  ierr = PetscMalloc1(size,&leaders);CHKERRQ(ierr);
+  ierr = MPI_Allgather(&hsf->leader,1,MPI_INT,leaders,1,MPI_INT,comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_split(comm,hsf->leader,rank,&nodecomm);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(nodecomm,&noderank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(nodecomm,&hsf->nnoderanks);CHKERRQ(ierr);
+
+  /* Sort my leaves into the on-node edges and the off-node ones as (leaf location, root rank, root index) */
+  nleafspace = sf->nleaves ? sf->maxleaf+1 : 0;
+  for (i=0; i<sf->nleaves; i++) if (leaders[sf->remote[i].rank] == hsf->leader) ndirect++;
+  nedges = sf->nleaves - ndirect;
+  ierr   = PetscMalloc1(ndirect,&dilocal);CHKERRQ(ierr);
+  ierr   = PetscMalloc1(ndirect,&diremote);CHKERRQ(ierr);
+  ierr   = PetscMalloc1(3*nedges,&edges);CHKERRQ(ierr);
+  for (i=0,j=0,k=0; i<sf->nleaves; i++) {
+    PetscInt leaf = sf->mine ? sf->mine[i] : i;
+    if (leaders[sf->remote[i].rank] == hsf->leader) {
+      dilocal[j]    = leaf;
+      diremote[j++] = sf->remote[i];
+    } else {
+      edges[3*k]   = leaf;
+      edges[3*k+1] = sf->remote[i].rank;
+      edges[3*k+2] = sf->remote[i].index;
+      k++;
+    }
+  }
+  for (i=0; i<sf->nranks; i++) if (leaders[sf->ranks[i]] != hsf->leader) nflat++;
+
+  /* Gather the off-node edges of the node to the leader */
+  ierr = PetscMPIIntCast(3*nedges,&info[0]);CHKERRQ(ierr);
+  info[1] = rank;
+  if (!noderank) {ierr = PetscMalloc3(2*hsf->nnoderanks,&ninfo,hsf->nnoderanks,&counts,hsf->nnoderanks+1,&displs);CHKERRQ(ierr);}
+  ierr = MPI_Gather(info,2,MPI_INT,ninfo,2,MPI_INT,0,nodecomm);CHKERRQ(ierr);
+  ierr = MPI_Reduce(&nflat,&hsf->nflatmsgs,1,MPIU_INT,MPI_SUM,0,nodecomm);CHKERRQ(ierr);
+  if (!noderank) {
+    displs[0] = 0;
+    for (n=0; n<hsf->nnoderanks; n++) {
+      counts[n]   = ninfo[2*n];
+      displs[n+1] = displs[n] + counts[n];
+    }
+    hsf->nin = displs[hsf->nnoderanks]/3;
+    ierr     = PetscMalloc1(3*hsf->nin,&nodeedges);CHKERRQ(ierr);
+  } else {
+    hsf->nin       = 0;
+    hsf->nflatmsgs = 0;
+  }
+  ierr = MPI_Gatherv(edges,info[0],MPIU_INT,nodeedges,counts,displs,MPIU_INT,0,nodecomm);CHKERRQ(ierr);
+  ierr = PetscFree(edges);CHKERRQ(ierr);
+
+  /* In slot s of the leader refers to the leaf of the edge in scatter, and to the leader of the node of the root in tmp */
+  ierr = PetscMalloc1(hsf->nin,&sremote);CHKERRQ(ierr);
+  ierr = PetscMalloc3(hsf->nin,&tremote,hsf->nin,&tgsrc,hsf->nin,&tidst);CHKERRQ(ierr);
+  for (n=0,k=0; !noderank && n<hsf->nnoderanks; n++) {
+    for (i=displs[n]/3; i<displs[n+1]/3; i++,k++) {
+      sremote[k].rank  = ninfo[2*n+1];
+      sremote[k].index = nodeedges[3*i];
+      tremote[k].rank  = leaders[nodeedges[3*i+1]];
+      tremote[k].index = 0;
+      tgsrc[k].rank    = nodeedges[3*i+1];
+      tgsrc[k].index   = nodeedges[3*i+2];
+      tidst[k].rank    = rank;
+      tidst[k].index   = k;
+    }
+  }
+  ierr = PetscFree(nodeedges);CHKERRQ(ierr);
+  ierr = PetscFree3(ninfo,counts,displs);CHKERRQ(ierr);
+  ierr = MPI_Comm_free(&nodecomm);CHKERRQ(ierr);
+  ierr = PetscFree(leaders);CHKERRQ(ierr);
+
+  /* The leader of the node of the roots gathers the root and the in slot of the edges referring to its node, one out slot per edge */
+  ierr = PetscSFCreate(comm,&tmp);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(tmp,1,hsf->nin,NULL,PETSC_USE_POINTER,tremote,PETSC_USE_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeBegin(tmp,&degree);CHKERRQ(ierr);
+  ierr = PetscSFComputeDegreeEnd(tmp,&degree);CHKERRQ(ierr);
+  hsf->nout = degree[0];
+  ierr = PetscMalloc1(hsf->nout,&gsrc);CHKERRQ(ierr);
+  ierr = PetscMalloc1(hsf->nout,&idst);CHKERRQ(ierr);
+  ierr = PetscSFGatherBegin(tmp,MPIU_2INT,tgsrc,gsrc);CHKERRQ(ierr);
+  ierr = PetscSFGatherEnd(tmp,MPIU_2INT,tgsrc,gsrc);CHKERRQ(ierr);
+  ierr = PetscSFGatherBegin(tmp,MPIU_2INT,tidst,idst);CHKERRQ(ierr);
+  ierr = PetscSFGatherEnd(tmp,MPIU_2INT,tidst,idst);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&tmp);CHKERRQ(ierr);
+  ierr = PetscFree3(tremote,tgsrc,tidst);CHKERRQ(ierr);
+
+  /* The gather and the scatter stay on the node, the leaders talk to few other leaders */
+#if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
+  intertype = PETSCSFNEIGHBOR;
+#endif
+  ierr = PetscSFHierarchicalCreateSF_Private(sf,PETSCSFBASIC,"direct_",sf->nroots,ndirect,dilocal,diremote,&hsf->direct);CHKERRQ(ierr);
+  ierr = PetscSFHierarchicalCreateSF_Private(sf,PETSCSFBASIC,"node_",sf->nroots,hsf->nout,NULL,gsrc,&hsf->gather);CHKERRQ(ierr);
+  ierr = PetscSFHierarchicalCreateSF_Private(sf,intertype,"inter_",hsf->nin,hsf->nout,NULL,idst,&hsf->inter);CHKERRQ(ierr);
+  ierr = PetscSFHierarchicalCreateSF_Private(sf,PETSCSFBASIC,"node_",nleafspace,hsf->nin,NULL,sremote,&hsf->scatter);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFSetFromOptions_Hierarchical(PetscOptionItems *PetscOptionsObject,PetscSF sf)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Hierarchical options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-sf_hierarchical_node_size","Number of consecutive ranks taken as one node, 0 for the shared memory nodes","PetscSFSetFromOptions",hsf->nodesize,&hsf->nodesize,NULL);CHKERRQ(ierr);
+  if (hsf->nodesize < 0) SETERRQ1(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_OUTOFRANGE,"Node size %D cannot be negative",hsf->nodesize);
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Hierarchical(PetscSF sf)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+  PetscSFHierLink      link,next;
+
+  PetscFunctionBegin;
+  if (hsf->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Communication is still in progress");
+  for (link=hsf->avail; link; link=next) {
+    next = link->next;
+    ierr = PetscFree2(link->inbuf,link->outbuf);CHKERRQ(ierr);
+    ierr = PetscFree(link);CHKERRQ(ierr);
+  }
+  hsf->avail = NULL;
+  ierr = PetscSFDestroy(&hsf->direct);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&hsf->gather);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&hsf->inter);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&hsf->scatter);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&hsf->flat);CHKERRQ(ierr);
+  hsf->nin = hsf->nout = hsf->nflatmsgs = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Hierarchical(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Hierarchical(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFView_Hierarchical(PetscSF sf,PetscViewer viewer)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+  PetscBool            iascii;
+  PetscMPIInt          rank;
+  PetscInt             ninter = 0;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    if (hsf->nodesize) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  nodes of %D consecutive ranks\n",hsf->nodesize);CHKERRQ(ierr);
+    } else {
+      ierr = PetscViewerASCIIPrintf(viewer,"  nodes of the ranks sharing memory\n");CHKERRQ(ierr);
+    }
+    if (sf->setupcalled) {
+      ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)sf),&rank);CHKERRQ(ierr);
+      if (rank == hsf->leader) {ierr = PetscSFGetRootRanks(hsf->inter,&ninter,NULL,NULL,NULL,NULL);CHKERRQ(ierr);}
+      ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+      if (rank == hsf->leader) {
+        ierr = PetscViewerASCIISynchronizedPrintf(viewer,"  [%d] Leader of %d ranks: %D off-node leaves and %D off-node roots, messages to other nodes: %D instead of %D\n",rank,hsf->nnoderanks,hsf->nin,hsf->nout,ninter,hsf->nflatmsgs);CHKERRQ(ierr);
+      }
+      ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+      ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDuplicate_Hierarchical(PetscSF sf,PetscSFDuplicateOption opt,PetscSF newsf)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data,*nhsf = (PetscSF_Hierarchical*)newsf->data;
+
+  PetscFunctionBegin;
+  nhsf->nodesize = hsf->nodesize;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_Hierarchical(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+  PetscSFHierLink      link;
+
+  PetscFunctionBegin;
+  if (rootmtype != PETSC_MEMTYPE_HOST || leafmtype != PETSC_MEMTYPE_HOST) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"PETSCSFHIERARCHICAL only supports data in host memory");
+  ierr = PetscSFHierarchicalGetLink_Private(sf,unit,PETSCSF_ROOT2LEAF,rootdata,leafdata,&link);CHKERRQ(ierr);
+  /* The leaders need the roots of their node before sending them, the on-node edges go meanwhile */
+  ierr = PetscSFBcastBegin(hsf->gather,unit,rootdata,link->outbuf);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(hsf->gather,unit,rootdata,link->outbuf);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(hsf->inter,unit,link->outbuf,link->inbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpBegin(hsf->direct,unit,rootdata,leafdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEnd_Hierarchical(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+  PetscSFHierLink      link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierarchicalFindLink_Private(sf,unit,PETSCSF_ROOT2LEAF,rootdata,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(hsf->inter,unit,link->outbuf,link->inbuf,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpEnd(hsf->direct,unit,rootdata,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(hsf->scatter,unit,link->inbuf,leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(hsf->scatter,unit,link->inbuf,leafdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Hierarchical(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+  PetscSFHierLink      link;
+
+  PetscFunctionBegin;
+  if (rootmtype != PETSC_MEMTYPE_HOST || leafmtype != PETSC_MEMTYPE_HOST) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"PETSCSFHIERARCHICAL only supports data in host memory");
+  ierr = PetscSFHierarchicalGetLink_Private(sf,unit,PETSCSF_LEAF2ROOT,rootdata,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(hsf->scatter,unit,leafdata,link->inbuf);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(hsf->scatter,unit,leafdata,link->inbuf);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(hsf->inter,unit,link->inbuf,link->outbuf);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(hsf->direct,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Hierarchical(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscSF_Hierarchical *hsf = (PetscSF_Hierarchical*)sf->data;
+  PetscErrorCode       ierr;
+  PetscSFHierLink      link;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierarchicalFindLink_Private(sf,unit,PETSCSF_LEAF2ROOT,rootdata,leafdata,&link);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(hsf->inter,unit,link->inbuf,link->outbuf);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(hsf->direct,unit,leafdata,rootdata,op);CHKERRQ(ierr);
+  /* The direct edges are done with the roots, so the leaders can add their part */
+  ierr = PetscSFReduceBegin(hsf->gather,unit,link->outbuf,rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(hsf->gather,unit,link->outbuf,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpBegin_Hierarchical(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,void *rootdata,PetscMemType leafmtype,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSF        flat;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierarchicalGetFlatSF_Private(sf,&flat);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpBegin(flat,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpEnd_Hierarchical(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSF        flat;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierarchicalGetFlatSF_Private(sf,&flat);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpEnd(flat,unit,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFGetLeafRanks_Hierarchical(PetscSF sf,PetscInt *niranks,const PetscMPIInt **iranks,const PetscInt **ioffset,const PetscInt **irootloc)
+{
+  PetscErrorCode ierr;
+  PetscSF        flat;
+
+  PetscFunctionBegin;
+  ierr = PetscSFHierarchicalGetFlatSF_Private(sf,&flat);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafRanks(flat,niranks,iranks,ioffset,irootloc);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   PETSCSFHIERARCHICAL - A PetscSF that aggregates the messages between nodes through one leader rank per node
+
+   The roots referenced from other nodes are gathered to the leader of their node, the leaders send the data of all the edges
+   between two nodes in one message, and the leader of the node of the leaves scatters the data to them. The edges with the
+   root and the leaf on the same node do not go through the leader. This trades copies within the node for fewer and larger
+   messages on the network, which pays off with many ranks per node and scattered communication patterns.
+
+   Options Database Keys:
++  -sf_hierarchical_node_size <n> - Take n consecutive ranks as one node instead of the ranks sharing memory, for instance to try the type on one machine
+.  -node_sf_type <type>          - Type of the SFs moving data between the leaders and the ranks of their node (default basic)
+.  -inter_sf_type <type>         - Type of the SF moving data between the leaders (default neighbor when MPI has neighborhood collectives, basic otherwise)
+-  -direct_sf_type <type>        - Type of the SF for the edges within a node (default basic)
+
+   Notes:
+   The options of the internal SFs are prefixed by the prefix of the SF. Only data in host memory is supported.
+   PetscSFFetchAndOpBegin() and PetscSFGetLeafRanks() use a PETSCSFBASIC SF with the same graph, built when they are first called.
+
+   Level: advanced
+
+.seealso: PetscSFCreate(), PetscSFSetType(), PETSCSFBASIC, PETSCSFNEIGHBOR
+M*/
+PETSC_INTERN PetscErrorCode PetscSFCreate_Hierarchical(PetscSF sf)
+{
+  PetscSF_Hierarchical *hsf;
+  PetscErrorCode       ierr;
+
+  PetscFunctionBegin;
+  sf->ops->SetUp           = PetscSFSetUp_Hierarchical;
+  sf->ops->SetFromOptions  = PetscSFSetFromOptions_Hierarchical;
+  sf->ops->Reset           = PetscSFReset_Hierarchical;
+  sf->ops->Destroy         = PetscSFDestroy_Hierarchical;
+  sf->ops->View            = PetscSFView_Hierarchical;
+  sf->ops->Duplicate       = PetscSFDuplicate_Hierarchical;
+  sf->ops->BcastAndOpBegin = PetscSFBcastAndOpBegin_Hierarchical;
+  sf->ops->BcastAndOpEnd   = PetscSFBcastAndOpEnd_Hierarchical;
+  sf->ops->ReduceBegin     = PetscSFReduceBegin_Hierarchical;
+  sf->ops->ReduceEnd       = PetscSFReduceEnd_Hierarchical;
+  sf->ops->FetchAndOpBegin = PetscSFFetchAndOpBegin_Hierarchical;
+  sf->ops->FetchAndOpEnd   = PetscSFFetchAndOpEnd_Hierarchical;
+  sf->ops->GetLeafRanks    = PetscSFGetLeafRanks_Hierarchical;
+
+  ierr = PetscNewLog(sf,&hsf);CHKERRQ(ierr);
+  sf->data = (void*)hsf;
+  PetscFunctionReturn(0);
+}
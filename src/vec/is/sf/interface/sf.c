@@ -25,9 +25,10 @@ const char *const PetscSFDuplicateOptions[] = {"CONFONLY","RANKS","GRAPH","Petsc
 .  sf - new star forest context
 
    Options Database Keys:
-+  -sf_type basic     -Use MPI persistent Isend/Irecv for communication (Default)
-.  -sf_type window    -Use MPI-3 one-sided window for communication
--  -sf_type neighbor  -Use MPI-3 neighborhood collectives for communication
++  -sf_type basic        -Use MPI persistent Isend/Irecv for communication (Default)
+.  -sf_type window       -Use MPI-3 one-sided window for communication
+.  -sf_type neighbor     -Use MPI-3 neighborhood collectives for communication
+-  -sf_type hierarchical -Aggregate the communication between nodes through one leader rank per node, see PETSCSFHIERARCHICAL
 
    Level: intermediate
 
@@ -120,7 +121,7 @@ PetscErrorCode PetscSFReset(PetscSF sf)
 
    Options Database Key:
 .  -sf_type <type> - Sets the method; use -help for a list
-   of available methods (for instance, window, basic, neighbor)
+   of available methods (for instance, window, basic, neighbor, hierarchical)
 
    Notes:
    See "include/petscsf.h" for available methods (for instance)
@@ -270,8 +271,12 @@ PetscErrorCode PetscSFSetUp(PetscSF sf)
 .  -sf_use_default_stream - Assume callers of SF computed the input root/leafdata with the default cuda stream. SF will also
                             use the default stream to process data. Therefore, no stream synchronization is needed between SF and its caller (default: true).
                             If true, this option only works with -use_cuda_aware_mpi 1.
--  -sf_use_stream_aware_mpi  - Assume the underlying MPI is cuda-stream aware and SF won't sync streams for send/recv buffers passed to MPI (default: false).
+.  -sf_use_stream_aware_mpi  - Assume the underlying MPI is cuda-stream aware and SF won't sync streams for send/recv buffers passed to MPI (default: false).
                                If true, this option only works with -use_cuda_aware_mpi 1.
+.  -sf_basic_shared_memory - With PETSCSFBASIC, move host data to and from ranks on the same node through MPI-3 shared memory windows
+                             instead of MPI messages (default: false)
+-  -sf_basic_derived_datatypes - With PETSCSFBASIC, when the indices of every remote rank form a contiguous, strided or 2D/3D subblock pattern, send host
+                                 data right from the root or leaf arrays with MPI derived datatypes instead of packing it (default: false)
 
    Level: intermediate
 @*/
@@ -1436,6 +1441,187 @@ PetscErrorCode PetscSFReduceEnd(PetscSF sf,MPI_Datatype unit,const void *leafdat
   PetscFunctionReturn(0);
 }
 
+/* Can the multiple-array operation of the implementation be used, i.e., is it provided and are all the arrays on host? */
+static PetscErrorCode PetscSFUseMultiple_Private(PetscErrorCode (*multiple)(PetscSF,MPI_Datatype,PetscInt,const void*const*,void*const*,MPI_Op),PetscInt n,const void *const *a,void *const *b,PetscBool *use)
+{
+  PetscErrorCode ierr;
+  PetscInt       j;
+  PetscMemType   amtype,bmtype;
+
+  PetscFunctionBegin;
+  *use = (multiple && n > 0) ? PETSC_TRUE : PETSC_FALSE;
+  for (j=0; *use && j<n; j++) {
+    ierr = PetscGetMemType(a[j],&amtype);CHKERRQ(ierr);
+    ierr = PetscGetMemType(b[j],&bmtype);CHKERRQ(ierr);
+    if (amtype != PETSC_MEMTYPE_HOST || bmtype != PETSC_MEMTYPE_HOST) *use = PETSC_FALSE;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBcastAndOpBeginMultiple - begin pointwise broadcasts with reduction of several root arrays to the leaf arrays, to be concluded with call to PetscSFBcastAndOpEndMultiple()
+
+   Collective on PetscSF
+
+   Input Arguments:
++  sf - star forest on which to communicate
+.  unit - data type associated with each node
+.  n - number of arrays
+.  rootdata - the n buffers to broadcast
+-  op - operation to use for reduction
+
+   Output Arguments:
+.  leafdata - the n buffers to be reduced with values from each leaf's respective root, leafdata[j] gets the values of rootdata[j]
+
+   Level: advanced
+
+   Notes:
+   This does the same as PetscSFBcastAndOpBegin() on each pair of arrays, but PETSCSFBASIC packs the values of all the arrays for a
+   remote process into one message, so a process sends one message per neighbor instead of n. Other types, and arrays in device memory, do
+   n operations.
+
+.seealso: PetscSFBcastAndOpEndMultiple(), PetscSFBcastAndOpBegin(), PetscSFReduceBeginMultiple()
+@*/
+PetscErrorCode PetscSFBcastAndOpBeginMultiple(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const rootdata[],void *const leafdata[],MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscBool      use;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of arrays %D cannot be negative",n);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscSFUseMultiple_Private(sf->ops->BcastAndOpBeginMultiple,n,rootdata,leafdata,&use);CHKERRQ(ierr);
+  if (use) {
+    ierr = PetscLogEventBegin(PETSCSF_BcastAndOpBegin,sf,0,0,0);CHKERRQ(ierr);
+    ierr = (*sf->ops->BcastAndOpBeginMultiple)(sf,unit,n,rootdata,leafdata,op);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(PETSCSF_BcastAndOpBegin,sf,0,0,0);CHKERRQ(ierr);
+  } else {
+    for (j=0; j<n; j++) {ierr = PetscSFBcastAndOpBegin(sf,unit,rootdata[j],leafdata[j],op);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFBcastAndOpEndMultiple - end the broadcasts with reduction started with PetscSFBcastAndOpBeginMultiple()
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  n - number of arrays
+.  rootdata - the n buffers to broadcast
+-  op - operation to use for reduction
+
+   Output Arguments:
+.  leafdata - the n buffers to be reduced with values from each leaf's respective root
+
+   Level: advanced
+
+.seealso: PetscSFBcastAndOpBeginMultiple(), PetscSFBcastAndOpEnd()
+@*/
+PetscErrorCode PetscSFBcastAndOpEndMultiple(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const rootdata[],void *const leafdata[],MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscBool      use;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  ierr = PetscSFUseMultiple_Private(sf->ops->BcastAndOpEndMultiple,n,rootdata,leafdata,&use);CHKERRQ(ierr);
+  if (use) {
+    ierr = PetscLogEventBegin(PETSCSF_BcastAndOpEnd,sf,0,0,0);CHKERRQ(ierr);
+    ierr = (*sf->ops->BcastAndOpEndMultiple)(sf,unit,n,rootdata,leafdata,op);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(PETSCSF_BcastAndOpEnd,sf,0,0,0);CHKERRQ(ierr);
+  } else {
+    for (j=0; j<n; j++) {ierr = PetscSFBcastAndOpEnd(sf,unit,rootdata[j],leafdata[j],op);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFReduceBeginMultiple - begin reductions of several leaf arrays into the root arrays, to be completed with call to PetscSFReduceEndMultiple()
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  n - number of arrays
+.  leafdata - the n arrays of values to reduce
+-  op - reduction operation
+
+   Output Arguments:
+.  rootdata - the n arrays of results of the reduction, rootdata[j] gets the values of leafdata[j]
+
+   Level: advanced
+
+   Notes:
+   As with PetscSFBcastAndOpBeginMultiple(), PETSCSFBASIC sends one message per neighbor holding the values of all the arrays.
+
+.seealso: PetscSFReduceEndMultiple(), PetscSFReduceBegin(), PetscSFBcastAndOpBeginMultiple()
+@*/
+PetscErrorCode PetscSFReduceBeginMultiple(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const leafdata[],void *const rootdata[],MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscBool      use;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of arrays %D cannot be negative",n);
+  ierr = PetscSFSetUp(sf);CHKERRQ(ierr);
+  ierr = PetscSFUseMultiple_Private(sf->ops->ReduceBeginMultiple,n,leafdata,rootdata,&use);CHKERRQ(ierr);
+  if (use) {
+    ierr = PetscLogEventBegin(PETSCSF_ReduceBegin,sf,0,0,0);CHKERRQ(ierr);
+    ierr = (*sf->ops->ReduceBeginMultiple)(sf,unit,n,leafdata,rootdata,op);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(PETSCSF_ReduceBegin,sf,0,0,0);CHKERRQ(ierr);
+  } else {
+    for (j=0; j<n; j++) {ierr = PetscSFReduceBegin(sf,unit,leafdata[j],rootdata[j],op);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscSFReduceEndMultiple - end the reductions started with PetscSFReduceBeginMultiple()
+
+   Collective
+
+   Input Arguments:
++  sf - star forest
+.  unit - data type
+.  n - number of arrays
+.  leafdata - the n arrays of values to reduce
+-  op - reduction operation
+
+   Output Arguments:
+.  rootdata - the n arrays of results of the reduction
+
+   Level: advanced
+
+.seealso: PetscSFReduceBeginMultiple(), PetscSFReduceEnd()
+@*/
+PetscErrorCode PetscSFReduceEndMultiple(PetscSF sf,MPI_Datatype unit,PetscInt n,const void *const leafdata[],void *const rootdata[],MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscBool      use;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(sf,PETSCSF_CLASSID,1);
+  ierr = PetscSFUseMultiple_Private(sf->ops->ReduceEndMultiple,n,leafdata,rootdata,&use);CHKERRQ(ierr);
+  if (use) {
+    ierr = PetscLogEventBegin(PETSCSF_ReduceEnd,sf,0,0,0);CHKERRQ(ierr);
+    ierr = (*sf->ops->ReduceEndMultiple)(sf,unit,n,leafdata,rootdata,op);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(PETSCSF_ReduceEnd,sf,0,0,0);CHKERRQ(ierr);
+  } else {
+    for (j=0; j<n; j++) {ierr = PetscSFReduceEnd(sf,unit,leafdata[j],rootdata[j],op);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscSFFetchAndOpBegin - begin operation that fetches values from root and updates atomically by applying operation using my leaf value, to be completed with PetscSFFetchAndOpEnd()
 
@@ -0,0 +1,190 @@
+static char help[]= "Tests PetscSF with leaves and roots forming contiguous, strided and 2D/3D subblock patterns, with and without MPI derived datatypes\n\n";
+
+#include <petscsf.h>
+
+/* Builds on each process a graph whose roots are an X x Y x Z array: the leaves at even positions reference a 3D subblock of the next process,
+   the following contiguous leaves reference a strided set of roots of the previous process, and the last ones a 2D subblock of the process itself */
+#define X 6
+#define Y 5
+#define Z 4
+
+static PetscErrorCode CreateSF(const char *prefix,PetscSF *sf)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       i,j,k,n = 0;
+  PetscInt       ilocal[12+10+6];
+  PetscSFNode    iremote[12+10+6];
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  for (k=0; k<2; k++) {
+    for (j=0; j<3; j++) {
+      for (i=0; i<2; i++,n++) {
+        ilocal[n]        = 2*n;
+        iremote[n].rank  = (rank+1)%size;
+        iremote[n].index = (1+k)*X*Y + (1+j)*X + 1+i;
+      }
+    }
+  }
+  for (i=0; i<10; i++,n++) {
+    ilocal[n]        = 30+i;
+    iremote[n].rank  = (rank+size-1)%size;
+    iremote[n].index = 3+7*i;
+  }
+  for (j=0; j<2; j++) {
+    for (i=0; i<3; i++,n++) {
+      ilocal[n]        = 50+3*j+i;
+      iremote[n].rank  = rank;
+      iremote[n].index = 3*X*Y + (2+j)*X + i;
+    }
+  }
+  ierr = PetscSFCreate(PETSC_COMM_WORLD,sf);CHKERRQ(ierr);
+  ierr = PetscObjectSetOptionsPrefix((PetscObject)*sf,prefix);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(*sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(*sf,X*Y*Z,n,ilocal,PETSC_COPY_VALUES,iremote,PETSC_COPY_VALUES);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(*sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Compare(const char *op,PetscInt n,const PetscReal *a,const PetscReal *b)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+  PetscMPIInt    same,allsame;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) if (a[i] != b[i]) break;
+  same = (i == n) ? 1 : 0;
+  ierr = MPIU_Allreduce(&same,&allsame,1,MPI_INT,MPI_LAND,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s\n",op,allsame ? "results agree" : "results differ");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Runs the same operations with sf and sfd, each operation twice with different arrays so that requests on the user arrays are rebuilt */
+static PetscErrorCode TestUnit(PetscSF sf,PetscSF sfd,MPI_Datatype unit,PetscInt bs)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank;
+  PetscInt       i,it,nroots = X*Y*Z*bs,nleaves = 60*bs;
+  PetscReal      *root,*leaf,*rootd[2],*leafd[2];
+  char           name[64];
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = PetscMalloc6(nroots,&root,nleaves,&leaf,nroots,&rootd[0],nleaves,&leafd[0],nroots,&rootd[1],nleaves,&leafd[1]);CHKERRQ(ierr);
+  for (it=0; it<2; it++) {
+    for (i=0; i<nroots; i++) root[i] = rootd[it][i] = 1000*rank + i;
+    for (i=0; i<nleaves; i++) leaf[i] = leafd[it][i] = -i - 0.5*it;
+
+    ierr = PetscSFBcastBegin(sf,unit,root,leaf);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,unit,root,leaf);CHKERRQ(ierr);
+    ierr = PetscSFBcastBegin(sfd,unit,rootd[it],leafd[it]);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sfd,unit,rootd[it],leafd[it]);CHKERRQ(ierr);
+    ierr = PetscSNPrintf(name,sizeof(name),"Bcast with bs %D, pass %D",bs,it);CHKERRQ(ierr);
+    ierr = Compare(name,nleaves,leaf,leafd[it]);CHKERRQ(ierr);
+
+    ierr = PetscSFBcastAndOpBegin(sf,unit,root,leaf,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFBcastAndOpEnd(sf,unit,root,leaf,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFBcastAndOpBegin(sfd,unit,rootd[it],leafd[it],MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFBcastAndOpEnd(sfd,unit,rootd[it],leafd[it],MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSNPrintf(name,sizeof(name),"BcastAndOp with bs %D, pass %D",bs,it);CHKERRQ(ierr);
+    ierr = Compare(name,nleaves,leaf,leafd[it]);CHKERRQ(ierr);
+
+    ierr = PetscSFReduceBegin(sf,unit,leaf,root,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(sf,unit,leaf,root,MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFReduceBegin(sfd,unit,leafd[it],rootd[it],MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSFReduceEnd(sfd,unit,leafd[it],rootd[it],MPIU_SUM);CHKERRQ(ierr);
+    ierr = PetscSNPrintf(name,sizeof(name),"Reduce with bs %D, pass %D",bs,it);CHKERRQ(ierr);
+    ierr = Compare(name,nroots,root,rootd[it]);CHKERRQ(ierr);
+  }
+  ierr = PetscFree6(root,leaf,rootd[0],leafd[0],rootd[1],leafd[1]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* A unit with a hole, which PetscSF moves as an opaque type: only PetscSFBcast() with MPIU_REPLACE is supported, and only the entries of
+   the unit, not the hole, are compared */
+static PetscErrorCode TestVectorUnit(PetscSF sf,PetscSF sfd)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank;
+  PetscInt       i,it,n,nroots = X*Y*Z*3,nleaves = 60*3;
+  PetscReal      *root,*leaf,*leafd,*a,*b;
+  MPI_Datatype   unit;
+  char           name[64];
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Type_vector(2,1,2,MPIU_REAL,&unit);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(&unit);CHKERRQ(ierr);
+  ierr = PetscMalloc5(nroots,&root,nleaves,&leaf,nleaves,&leafd,nleaves,&a,nleaves,&b);CHKERRQ(ierr);
+  for (it=0; it<2; it++) {
+    for (i=0; i<nroots; i++) root[i] = 1000*rank + i;
+    for (i=0; i<nleaves; i++) leaf[i] = leafd[i] = -i - 0.5*it;
+
+    ierr = PetscSFBcastBegin(sf,unit,root,leaf);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sf,unit,root,leaf);CHKERRQ(ierr);
+    ierr = PetscSFBcastBegin(sfd,unit,root,leafd);CHKERRQ(ierr);
+    ierr = PetscSFBcastEnd(sfd,unit,root,leafd);CHKERRQ(ierr);
+    for (i=0,n=0; i<nleaves; i++) {
+      if (i%3 == 1) continue;
+      a[n] = leaf[i]; b[n] = leafd[i]; n++;
+    }
+    /* leaf 50 references the first root of the 2D subblock on this process */
+    if (leafd[3*50] != root[3*(3*X*Y+2*X)] || leafd[3*50+2] != root[3*(3*X*Y+2*X)+2]) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Wrong entries of the strided unit");
+    ierr = PetscSNPrintf(name,sizeof(name),"Bcast with strided unit, pass %D",it);CHKERRQ(ierr);
+    ierr = Compare(name,n,a,b);CHKERRQ(ierr);
+  }
+  ierr = PetscFree5(root,leaf,leafd,a,b);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&unit);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscSF        sf,sfd;
+  MPI_Datatype   unit3;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  /* sfd gets the options with the prefix d_ */
+  ierr = CreateSF(NULL,&sf);CHKERRQ(ierr);
+  ierr = CreateSF("d_",&sfd);CHKERRQ(ierr);
+  ierr = PetscSFViewFromOptions(sfd,NULL,"-view");CHKERRQ(ierr);
+
+  ierr = TestUnit(sf,sfd,MPIU_REAL,1);CHKERRQ(ierr);
+  ierr = MPI_Type_contiguous(3,MPIU_REAL,&unit3);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(&unit3);CHKERRQ(ierr);
+  ierr = TestUnit(sf,sfd,unit3,3);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&unit3);CHKERRQ(ierr);
+  ierr = TestVectorUnit(sf,sfd);CHKERRQ(ierr);
+
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfd);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      args: -d_sf_basic_derived_datatypes
+      output_file: output/ex6_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         nsize: 3
+      test:
+         suffix: 3
+         nsize: 4
+         args: -sf_type neighbor
+
+   test:
+      suffix: view
+      nsize: 3
+      args: -d_sf_basic_derived_datatypes -d_view ::ascii_info
+      filter: grep "with roots\\|with leaves"
+
+TEST*/
@@ -0,0 +1,155 @@
+static char help[]= "Tests PETSCSFHIERARCHICAL against PETSCSFBASIC, with nodes of consecutive ranks\n\n";
+
+#include <petscsf.h>
+
+/* Each process has 4+rank roots and leaves at odd locations referencing roots all over, rank 1 has no leaves */
+static PetscErrorCode CreateSF(PetscSFType type,PetscSF *sf)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       k,q,nleaves,*ilocal;
+  PetscSFNode    *iremote;
+
+  PetscFunctionBegin;
+  ierr    = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr    = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  nleaves = rank == 1 ? 0 : 3*size+1;
+  ierr    = PetscMalloc1(nleaves,&ilocal);CHKERRQ(ierr);
+  ierr    = PetscMalloc1(nleaves,&iremote);CHKERRQ(ierr);
+  for (k=0; k<nleaves; k++) {
+    q                = (rank*k + k*k) % size;
+    ilocal[k]        = 2*k+1;
+    iremote[k].rank  = q;
+    iremote[k].index = (7*k + rank) % (4+q);
+  }
+  ierr = PetscSFCreate(PETSC_COMM_WORLD,sf);CHKERRQ(ierr);
+  ierr = PetscSFSetType(*sf,type);CHKERRQ(ierr);
+  ierr = PetscSFSetFromOptions(*sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(*sf,4+rank,nleaves,ilocal,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(*sf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode Compare(const char *op,PetscInt n,const PetscReal *a,const PetscReal *b)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+  PetscMPIInt    same,allsame;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) if (a[i] != b[i]) break;
+  same = (i == n) ? 1 : 0;
+  ierr = MPIU_Allreduce(&same,&allsame,1,MPI_INT,MPI_LAND,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s\n",op,allsame ? "results agree" : "results differ");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode TestUnit(PetscSF sf,PetscSF sfh,MPI_Datatype unit,PetscInt bs)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       i,nroots,nleaves;
+  PetscReal      *root,*leaf,*rooth,*leafh,*leafh2,*upd,*updh;
+  char           name[64];
+
+  PetscFunctionBegin;
+  ierr    = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr    = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  nroots  = (4+rank)*bs;
+  nleaves = (6*size+2)*bs;
+  ierr    = PetscMalloc7(nroots,&root,nleaves,&leaf,nroots,&rooth,nleaves,&leafh,nleaves,&leafh2,nleaves,&upd,nleaves,&updh);CHKERRQ(ierr);
+  for (i=0; i<nroots; i++) root[i] = rooth[i] = 100*rank + i;
+  for (i=0; i<nleaves; i++) leaf[i] = leafh[i] = leafh2[i] = -i;
+
+  ierr = PetscSFBcastBegin(sf,unit,root,leaf);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sf,unit,root,leaf);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(sfh,unit,rooth,leafh);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sfh,unit,rooth,leafh);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"Bcast with bs %D",bs);CHKERRQ(ierr);
+  ierr = Compare(name,nleaves,leaf,leafh);CHKERRQ(ierr);
+
+  /* two operations in flight on the same SF */
+  ierr = PetscSFBcastAndOpBegin(sf,unit,root,leaf,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpEnd(sf,unit,root,leaf,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpBegin(sfh,unit,rooth,leafh,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(sfh,unit,rooth,leafh2);CHKERRQ(ierr);
+  ierr = PetscSFBcastAndOpEnd(sfh,unit,rooth,leafh,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(sfh,unit,rooth,leafh2);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"BcastAndOp with bs %D",bs);CHKERRQ(ierr);
+  ierr = Compare(name,nleaves,leaf,leafh);CHKERRQ(ierr);
+
+  ierr = PetscSFReduceBegin(sf,unit,leaf,root,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(sf,unit,leaf,root,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(sfh,unit,leafh,rooth,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(sfh,unit,leafh,rooth,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"Reduce with bs %D",bs);CHKERRQ(ierr);
+  ierr = Compare(name,nroots,root,rooth);CHKERRQ(ierr);
+
+  ierr = PetscSFReduceBegin(sf,unit,leaf,root,MPIU_MAX);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(sf,unit,leaf,root,MPIU_MAX);CHKERRQ(ierr);
+  ierr = PetscSFReduceBegin(sfh,unit,leafh,rooth,MPIU_MAX);CHKERRQ(ierr);
+  ierr = PetscSFReduceEnd(sfh,unit,leafh,rooth,MPIU_MAX);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"Reduce max with bs %D",bs);CHKERRQ(ierr);
+  ierr = Compare(name,nroots,root,rooth);CHKERRQ(ierr);
+
+  /* the order of the updates is not deterministic, only the roots are */
+  ierr = PetscSFFetchAndOpBegin(sf,unit,root,leaf,upd,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpEnd(sf,unit,root,leaf,upd,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpBegin(sfh,unit,rooth,leafh,updh,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSFFetchAndOpEnd(sfh,unit,rooth,leafh,updh,MPIU_SUM);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"FetchAndOp with bs %D",bs);CHKERRQ(ierr);
+  ierr = Compare(name,nroots,root,rooth);CHKERRQ(ierr);
+  ierr = PetscFree7(root,leaf,rooth,leafh,leafh2,upd,updh);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscSF        sf,sfh;
+  MPI_Datatype   unit2;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+  ierr = CreateSF(PETSCSFBASIC,&sf);CHKERRQ(ierr);
+  ierr = CreateSF(PETSCSFHIERARCHICAL,&sfh);CHKERRQ(ierr);
+  ierr = PetscSFViewFromOptions(sfh,NULL,"-view");CHKERRQ(ierr);
+
+  ierr = TestUnit(sf,sfh,MPIU_REAL,1);CHKERRQ(ierr);
+  ierr = MPI_Type_contiguous(2,MPIU_REAL,&unit2);CHKERRQ(ierr);
+  ierr = MPI_Type_commit(&unit2);CHKERRQ(ierr);
+  ierr = TestUnit(sf,sfh,unit2,2);CHKERRQ(ierr);
+  ierr = MPI_Type_free(&unit2);CHKERRQ(ierr);
+
+  ierr = PetscSFDestroy(&sf);CHKERRQ(ierr);
+  ierr = PetscSFDestroy(&sfh);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex7_1.out
+      test:
+         suffix: 1
+         nsize: 4
+         args: -sf_hierarchical_node_size 2
+      test:
+         suffix: 2
+         nsize: 5
+         args: -sf_hierarchical_node_size 2 -inter_sf_type basic
+      test:
+         suffix: 3
+         nsize: 3
+      test:
+         suffix: 4
+         nsize: 4
+         args: -sf_hierarchical_node_size 1
+
+   test:
+      suffix: view
+      nsize: 5
+      args: -sf_hierarchical_node_size 3 -view ::ascii_info
+      filter: grep "nodes\\|Leader"
+
+TEST*/
@@ -599,4 +599,20 @@ int main(int argc,char **argv)
       nsize: 4
       args: -sf_type basic -test_all -test_bcastop 0 -test_fetchandop 0
 
+   test:
+      suffix: 10_basic_shm
+      output_file: output/ex1_10_basic.out
+      filter: grep -v "Shared memory"
+      nsize: 4
+      args: -sf_type basic -sf_basic_shared_memory -test_all -test_bcastop 0 -test_fetchandop 0
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 9_char_shm
+      output_file: output/ex1_9_char.out
+      filter: grep -v "Shared memory"
+      nsize: 4
+      args: -sf_type basic -sf_basic_shared_memory -test_bcast -test_reduce -test_op max -test_char
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
 TEST*/
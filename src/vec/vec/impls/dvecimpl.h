@@ -22,6 +22,13 @@ PETSC_INTERN PetscErrorCode VecSet_Seq(Vec,PetscScalar);
 PETSC_INTERN PetscErrorCode VecMAXPY_Seq(Vec,PetscInt,const PetscScalar*,Vec*);
 PETSC_INTERN PetscErrorCode VecAYPX_Seq(Vec,PetscScalar,Vec);
 PETSC_INTERN PetscErrorCode VecWAXPY_Seq(Vec,PetscScalar,Vec,Vec);
+PETSC_INTERN PetscErrorCode VecMAXPYNorm_Seq(Vec,PetscInt,const PetscScalar*,Vec*,PetscReal*);
+PETSC_INTERN PetscErrorCode VecMAXPYMDot_Seq(Vec,PetscInt,const PetscScalar*,Vec*,PetscScalar*);
+PETSC_INTERN PetscErrorCode VecMDot_Seq_GEMV(Vec,PetscInt,const Vec[],PetscScalar*);
+PETSC_INTERN PetscErrorCode VecMAXPY_Seq_GEMV(Vec,PetscInt,const PetscScalar*,Vec*);
+PETSC_INTERN PetscErrorCode VecDuplicateVecs_Seq_GEMV(Vec,PetscInt,Vec*[]);
+PETSC_INTERN PetscErrorCode VecAXPYNorm_Seq(Vec,PetscScalar,Vec,PetscReal*);
+PETSC_INTERN PetscErrorCode VecWAXPYDot_Seq(Vec,PetscScalar,Vec,Vec,Vec,PetscScalar*,PetscReal*);
 PETSC_INTERN PetscErrorCode VecAXPBYPCZ_Seq(Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec);
 PETSC_INTERN PetscErrorCode VecMaxPointwiseDivide_Seq(Vec,Vec,PetscReal*);
 PETSC_INTERN PetscErrorCode VecPlaceArray_Seq(Vec,const PetscScalar*);
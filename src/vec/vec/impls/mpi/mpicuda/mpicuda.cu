@@ -276,6 +276,10 @@ PetscErrorCode VecBindToCPU_MPICUDA(Vec V,PetscBool pin)
     ierr = VecCUDACopyFromGPU(V);CHKERRQ(ierr);
     V->offloadmask = PETSC_OFFLOAD_CPU; /* since the CPU code will likely change values in the vector */
     V->ops->dotnorm2               = NULL;
+    V->ops->axpynorm               = VecAXPYNorm_MPI;
+    V->ops->maxpynorm              = VecMAXPYNorm_MPI;
+    V->ops->maxpymdot              = VecMAXPYMDot_MPI;
+    V->ops->waxpydot               = VecWAXPYDot_MPI;
     V->ops->waxpy                  = VecWAXPY_Seq;
     V->ops->dot                    = VecDot_MPI;
     V->ops->mdot                   = VecMDot_MPI;
@@ -307,6 +311,10 @@ PetscErrorCode VecBindToCPU_MPICUDA(Vec V,PetscBool pin)
     V->ops->getarraywrite          = NULL;
   } else {
     V->ops->dotnorm2               = VecDotNorm2_MPICUDA;
+    V->ops->axpynorm               = NULL;
+    V->ops->maxpynorm              = NULL;
+    V->ops->maxpymdot              = NULL;
+    V->ops->waxpydot               = NULL;
     V->ops->waxpy                  = VecWAXPY_SeqCUDA;
     V->ops->duplicate              = VecDuplicate_MPICUDA;
     V->ops->dot                    = VecDot_MPICUDA;
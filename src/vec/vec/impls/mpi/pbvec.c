@@ -412,6 +412,52 @@ static PetscErrorCode VecSetFromOptions_MPI(PetscOptionItems *PetscOptionsObject
 }
 
 
+/* Same as VecDuplicateVecs_Seq_GEMV(), the vectors are the columns of one array of local rows */
+PetscErrorCode VecDuplicateVecs_MPI_GEMV(Vec w,PetscInt m,Vec *V[])
+{
+  PetscErrorCode ierr;
+  Vec_MPI        *wmpi = (Vec_MPI*)w->data;
+  PetscInt       i,n = w->map->n,lda;
+  PetscScalar    *array;
+  PetscContainer container;
+  PetscBool      ismpi;
+
+  PetscFunctionBegin;
+  if (m <= 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"m must be > 0: m = %D",m);
+  ierr = PetscObjectTypeCompare((PetscObject)w,VECMPI,&ismpi);CHKERRQ(ierr);
+  if (!ismpi || wmpi->nghost || wmpi->localrep) {
+    ierr = VecDuplicateVecs_Default(w,m,V);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  lda  = PetscMax(1,((n*sizeof(PetscScalar)+63)/64)*64/sizeof(PetscScalar));
+  ierr = PetscMallocPushHugePage();CHKERRQ(ierr);
+  ierr = PetscCalloc1(m*lda,&array);CHKERRQ(ierr);
+  ierr = PetscMallocPopHugePage();CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,array);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,PetscContainerUserDestroyDefault);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m,V);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    Vec v;
+
+    ierr = VecCreate(PetscObjectComm((PetscObject)w),&v);CHKERRQ(ierr);
+    ierr = PetscLayoutReference(w->map,&v->map);CHKERRQ(ierr);
+    ierr = VecCreate_MPI_Private(v,PETSC_FALSE,0,array+i*lda);CHKERRQ(ierr);
+    ierr = PetscMemcpy(v->ops,w->ops,sizeof(struct _VecOps));CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject)v,"__Vec_GEMV_array",(PetscObject)container);CHKERRQ(ierr);
+    v->stash.donotstash   = w->stash.donotstash;
+    v->stash.ignorenegidx = w->stash.ignorenegidx;
+    ierr = PetscObjectListDuplicate(((PetscObject)w)->olist,&((PetscObject)v)->olist);CHKERRQ(ierr);
+    ierr = PetscFunctionListDuplicate(((PetscObject)w)->qlist,&((PetscObject)v)->qlist);CHKERRQ(ierr);
+    v->map->bs   = PetscAbs(w->map->bs);
+    v->bstash.bs = w->bstash.bs;
+    (*V)[i]      = v;
+  }
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)(*V)[0],m*lda*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static struct _VecOps DvOps = { VecDuplicate_MPI, /* 1 */
                                 VecDuplicateVecs_Default,
                                 VecDestroyVecs_Default,
@@ -481,7 +527,18 @@ static struct _VecOps DvOps = { VecDuplicate_MPI, /* 1 */
                                 VecStrideSubSetGather_Default,
                                 VecStrideSubSetScatter_Default,
                                 0,
-                                0
+                                0,
+                                0,
+                                0,
+                                0,
+                                0,
+                                0,
+                                0,
+                                0,
+                                VecAXPYNorm_MPI,
+                                VecMAXPYNorm_MPI,
+                                VecMAXPYMDot_MPI,
+                                VecWAXPYDot_MPI
 };
 
 /*
@@ -505,12 +562,17 @@ PetscErrorCode VecCreate_MPI_Private(Vec v,PetscBool alloc,PetscInt nghost,const
   v->petscnative = PETSC_TRUE;
 
   ierr = PetscLayoutSetUp(v->map);CHKERRQ(ierr);
+  if (VecMDotUseGEMV || VecMAXPYUseGEMV) v->ops->duplicatevecs = VecDuplicateVecs_MPI_GEMV;
+  if (VecMDotUseGEMV) v->ops->mdot = VecMDot_MPI_GEMV;
+  if (VecMAXPYUseGEMV) v->ops->maxpy = VecMAXPY_Seq_GEMV;
 
   s->array           = (PetscScalar*)array;
   s->array_allocated = 0;
   if (alloc && !array) {
     PetscInt n = v->map->n+nghost;
+    ierr               = PetscMallocPushHugePage();CHKERRQ(ierr);
     ierr               = PetscCalloc1(n,&s->array);CHKERRQ(ierr);
+    ierr               = PetscMallocPopHugePage();CHKERRQ(ierr);
     ierr               = PetscLogObjectMemory((PetscObject)v,n*sizeof(PetscScalar));CHKERRQ(ierr);
     s->array_allocated = s->array;
   }
@@ -22,6 +22,23 @@ PetscErrorCode VecMDot_MPI(Vec xin,PetscInt nv,const Vec y[],PetscScalar *z)
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode VecMDot_MPI_GEMV(Vec xin,PetscInt nv,const Vec y[],PetscScalar *z)
+{
+  PetscScalar    awork[128],*work = awork;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (nv > 128) {
+    ierr = PetscMalloc1(nv,&work);CHKERRQ(ierr);
+  }
+  ierr = VecMDot_Seq_GEMV(xin,nv,y,work);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(work,z,nv,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)xin));CHKERRQ(ierr);
+  if (nv > 128) {
+    ierr = PetscFree(work);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode VecMTDot_MPI(Vec xin,PetscInt nv,const Vec y[],PetscScalar *z)
 {
   PetscScalar    awork[128],*work = awork;
@@ -39,6 +56,72 @@ PetscErrorCode VecMTDot_MPI(Vec xin,PetscInt nv,const Vec y[],PetscScalar *z)
   PetscFunctionReturn(0);
 }
 
+/*
+   The fused operations combine the local results of the _Seq versions with a single reduction; as for NORM_1_AND_2
+   in VecNorm_MPI() the local 2-norms are squared again before they are summed
+*/
+PetscErrorCode VecMAXPYNorm_MPI(Vec yin,PetscInt nv,const PetscScalar *alpha,Vec *x,PetscReal *norm)
+{
+  PetscReal      work,sum;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr  = VecMAXPYNorm_Seq(yin,nv,alpha,x,&work);CHKERRQ(ierr);
+  work  = work*work;
+  ierr  = MPIU_Allreduce(&work,&sum,1,MPIU_REAL,MPIU_SUM,PetscObjectComm((PetscObject)yin));CHKERRQ(ierr);
+  *norm = PetscSqrtReal(sum);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecMAXPYMDot_MPI(Vec yin,PetscInt nv,const PetscScalar *alpha,Vec *x,PetscScalar *z)
+{
+  PetscScalar    awork[128],*work = awork;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (nv > 128) {
+    ierr = PetscMalloc1(nv,&work);CHKERRQ(ierr);
+  }
+  ierr = VecMAXPYMDot_Seq(yin,nv,alpha,x,work);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(work,z,nv,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)yin));CHKERRQ(ierr);
+  if (nv > 128) {
+    ierr = PetscFree(work);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecAXPYNorm_MPI(Vec yin,PetscScalar alpha,Vec xin,PetscReal *norm)
+{
+  PetscReal      work,sum;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr  = VecAXPYNorm_Seq(yin,alpha,xin,&work);CHKERRQ(ierr);
+  work  = work*work;
+  ierr  = MPIU_Allreduce(&work,&sum,1,MPIU_REAL,MPIU_SUM,PetscObjectComm((PetscObject)yin));CHKERRQ(ierr);
+  *norm = PetscSqrtReal(sum);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecWAXPYDot_MPI(Vec win,PetscScalar alpha,Vec xin,Vec yin,Vec zin,PetscScalar *dot,PetscReal *norm)
+{
+  PetscScalar    work[2],sum[2];
+  PetscReal      nrm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecWAXPYDot_Seq(win,alpha,xin,yin,zin,work,norm ? &nrm : NULL);CHKERRQ(ierr);
+  if (norm) {
+    work[1] = nrm*nrm;
+    ierr    = MPIU_Allreduce(work,sum,2,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)win));CHKERRQ(ierr);
+    *norm   = PetscSqrtReal(PetscRealPart(sum[1]));
+  } else {
+    ierr = MPIU_Allreduce(work,sum,1,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)win));CHKERRQ(ierr);
+  }
+  *dot = sum[0];
+  PetscFunctionReturn(0);
+}
+
 #include <../src/vec/vec/impls/seq/ftn-kernels/fnorm.h>
 PetscErrorCode VecNorm_MPI(Vec xin,NormType type,PetscReal *z)
 {
@@ -752,6 +752,52 @@ PetscErrorCode VecDuplicate_Seq(Vec win,Vec *V)
   PetscFunctionReturn(0);
 }
 
+/*
+   Places the m vectors in the columns of one array with leading dimension a multiple of 64 bytes, so that VecMDot_Seq_GEMV()
+   and VecMAXPY_Seq_GEMV() can apply BLAS gemv to them. No vector owns the array, it is freed with the container composed
+   with all of them when the last one is destroyed.
+*/
+PetscErrorCode VecDuplicateVecs_Seq_GEMV(Vec w,PetscInt m,Vec *V[])
+{
+  PetscErrorCode ierr;
+  PetscInt       i,n = w->map->n,lda;
+  PetscScalar    *array;
+  PetscContainer container;
+  PetscBool      isseq;
+
+  PetscFunctionBegin;
+  if (m <= 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"m must be > 0: m = %D",m);
+  ierr = PetscObjectTypeCompare((PetscObject)w,VECSEQ,&isseq);CHKERRQ(ierr);
+  if (!isseq) {
+    ierr = VecDuplicateVecs_Default(w,m,V);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  lda  = PetscMax(1,((n*sizeof(PetscScalar)+63)/64)*64/sizeof(PetscScalar));
+  ierr = PetscMallocPushHugePage();CHKERRQ(ierr);
+  ierr = PetscCalloc1(m*lda,&array);CHKERRQ(ierr);
+  ierr = PetscMallocPopHugePage();CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,array);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,PetscContainerUserDestroyDefault);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m,V);CHKERRQ(ierr);
+  for (i=0; i<m; i++) {
+    Vec v;
+
+    ierr = VecCreate(PetscObjectComm((PetscObject)w),&v);CHKERRQ(ierr);
+    ierr = PetscLayoutReference(w->map,&v->map);CHKERRQ(ierr);
+    ierr = VecCreate_Seq_Private(v,array+i*lda);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject)v,"__Vec_GEMV_array",(PetscObject)container);CHKERRQ(ierr);
+    ierr = PetscObjectListDuplicate(((PetscObject)w)->olist,&((PetscObject)v)->olist);CHKERRQ(ierr);
+    ierr = PetscFunctionListDuplicate(((PetscObject)w)->qlist,&((PetscObject)v)->qlist);CHKERRQ(ierr);
+    v->ops->view          = w->ops->view;
+    v->stash.ignorenegidx = w->stash.ignorenegidx;
+    (*V)[i]               = v;
+  }
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)(*V)[0],m*lda*sizeof(PetscScalar));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static struct _VecOps DvOps = {VecDuplicate_Seq, /* 1 */
                                VecDuplicateVecs_Default,
                                VecDestroyVecs_Default,
@@ -820,7 +866,18 @@ static struct _VecOps DvOps = {VecDuplicate_Seq, /* 1 */
                                VecStrideSubSetGather_Default,
                                VecStrideSubSetScatter_Default,
                                0,
-                               0
+                               0,
+                               0,
+                               0,
+                               0,
+                               0,
+                               0,
+                               0,
+                               0,
+                               VecAXPYNorm_Seq,
+                               VecMAXPYNorm_Seq,
+                               VecMAXPYMDot_Seq,
+                               VecWAXPYDot_Seq
 };
 
 
@@ -842,6 +899,9 @@ PetscErrorCode VecCreate_Seq_Private(Vec v,const PetscScalar array[])
   s->array_allocated = 0;
 
   ierr = PetscLayoutSetUp(v->map);CHKERRQ(ierr);
+  if (VecMDotUseGEMV || VecMAXPYUseGEMV) v->ops->duplicatevecs = VecDuplicateVecs_Seq_GEMV;
+  if (VecMDotUseGEMV) v->ops->mdot = VecMDot_Seq_GEMV;
+  if (VecMAXPYUseGEMV) v->ops->maxpy = VecMAXPY_Seq_GEMV;
   ierr = PetscObjectChangeTypeName((PetscObject)v,VECSEQ);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MATLAB_ENGINE)
   ierr = PetscObjectComposeFunction((PetscObject)v,"PetscMatlabEnginePut_C",VecMatlabEnginePut_Default);CHKERRQ(ierr);
@@ -32,7 +32,9 @@ PETSC_EXTERN PetscErrorCode VecCreate_Seq(Vec V)
   ierr = MPI_Comm_size(PetscObjectComm((PetscObject)V),&size);CHKERRQ(ierr);
   if (size > 1) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Cannot create VECSEQ on more than one process");
 #if !defined(PETSC_USE_MIXED_PRECISION)
+  ierr = PetscMallocPushHugePage();CHKERRQ(ierr);
   ierr = PetscMalloc1(n,&array);CHKERRQ(ierr);
+  ierr = PetscMallocPopHugePage();CHKERRQ(ierr);
   ierr = PetscLogObjectMemory((PetscObject)V, n*sizeof(PetscScalar));CHKERRQ(ierr);
   ierr = VecCreate_Seq_Private(V,array);CHKERRQ(ierr);
 
@@ -45,7 +47,9 @@ PETSC_EXTERN PetscErrorCode VecCreate_Seq(Vec V)
   case PETSC_PRECISION_SINGLE: {
     float *aarray;
 
+    ierr = PetscMallocPushHugePage();CHKERRQ(ierr);
     ierr = PetscCalloc1(n,&aarray);CHKERRQ(ierr);
+    ierr = PetscMallocPopHugePage();CHKERRQ(ierr);
     ierr = PetscLogObjectMemory((PetscObject)V, n*sizeof(float));CHKERRQ(ierr);
     ierr = VecCreate_Seq_Private(V,aarray);CHKERRQ(ierr);
 
@@ -55,7 +59,9 @@ PETSC_EXTERN PetscErrorCode VecCreate_Seq(Vec V)
   case PETSC_PRECISION_DOUBLE: {
     double *aarray;
 
+    ierr = PetscMallocPushHugePage();CHKERRQ(ierr);
     ierr = PetscCalloc1(n,&aarray);CHKERRQ(ierr);
+    ierr = PetscMallocPopHugePage();CHKERRQ(ierr);
     ierr = PetscLogObjectMemory((PetscObject)V, n*sizeof(double));CHKERRQ(ierr);
     ierr = VecCreate_Seq_Private(V,aarray);CHKERRQ(ierr);
 
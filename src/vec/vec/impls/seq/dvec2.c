@@ -711,6 +711,333 @@ PetscErrorCode VecWAXPY_Seq(Vec win, PetscScalar alpha,Vec xin,Vec yin)
   PetscFunctionReturn(0);
 }
 
+/*
+   The vectors from VecDuplicateVecs_Seq_GEMV() and VecDuplicateVecs_MPI_GEMV() are the columns of one column-major
+   array, so consecutive ones can be passed to BLAS gemv as a matrix. Returns how many of the arrays xx[0], xx[1], ...
+   are lda >= n entries apart, one if xx[0] does not start such a group.
+*/
+static PetscInt VecContiguousGroup_Private(PetscInt n,PetscInt nv,const PetscScalar **xx,PetscInt *lda)
+{
+  PetscInt j,d;
+
+  if (nv < 2 || !n) return 1;
+  d = xx[1] - xx[0];
+  if (d < n) return 1;
+  for (j=2; j<nv && xx[j] - xx[0] == j*d; j++) ;
+  *lda = d;
+  return j;
+}
+
+/* Returns the number of vectors from xx[0] on that are not in a group */
+static PetscInt VecNonContiguousRun_Private(PetscInt n,PetscInt nv,const PetscScalar **xx)
+{
+  PetscInt j,lda;
+
+  for (j=1; j<nv && VecContiguousGroup_Private(n,nv-j,xx+j,&lda) == 1; j++) ;
+  return j;
+}
+
+PetscErrorCode VecMDot_Seq_GEMV(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,j,ng,lda;
+  const PetscScalar *ayy[128],**yy = ayy,*xx;
+  PetscScalar       sone = 1.0,zero = 0.0;
+  PetscBLASInt      bn,bm,blda,one = 1;
+  PetscLogDouble    flops = 0.0;
+
+  PetscFunctionBegin;
+  if (nv > 128) {
+    ierr = PetscMalloc1(nv,&yy);CHKERRQ(ierr);
+  }
+  for (j=0; j<nv; j++) {
+    ierr = VecGetArrayRead(yin[j],&yy[j]);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  for (j=0; j<nv; j+=ng) {
+    ng = VecContiguousGroup_Private(n,nv-j,yy+j,&lda);
+    if (ng > 1) {
+      ierr   = PetscBLASIntCast(ng,&bm);CHKERRQ(ierr);
+      ierr   = PetscBLASIntCast(lda,&blda);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemv",BLASgemv_("C",&bn,&bm,&sone,yy[j],&blda,xx,&one,&zero,z+j,&one));
+      flops += ng*(2.0*n-1);
+    } else {
+      ng   = VecNonContiguousRun_Private(n,nv-j,yy+j);
+      ierr = VecMDot_Seq(xin,ng,yin+j,z+j);CHKERRQ(ierr);
+    }
+  }
+  ierr = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {
+    ierr = VecRestoreArrayRead(yin[j],&yy[j]);CHKERRQ(ierr);
+  }
+  if (nv > 128) {
+    ierr = PetscFree(yy);CHKERRQ(ierr);
+  }
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecMAXPY_Seq_GEMV(Vec xin,PetscInt nv,const PetscScalar *alpha,Vec *y)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,j,ng,lda;
+  const PetscScalar *ayy[128],**yy = ayy;
+  PetscScalar       *xx,sone = 1.0;
+  PetscBLASInt      bn,bm,blda,one = 1;
+  PetscLogDouble    flops = 0.0;
+
+  PetscFunctionBegin;
+  if (nv > 128) {
+    ierr = PetscMalloc1(nv,&yy);CHKERRQ(ierr);
+  }
+  for (j=0; j<nv; j++) {
+    ierr = VecGetArrayRead(y[j],&yy[j]);CHKERRQ(ierr);
+  }
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  for (j=0; j<nv; j+=ng) {
+    ng = VecContiguousGroup_Private(n,nv-j,yy+j,&lda);
+    if (ng > 1) {
+      ierr   = PetscBLASIntCast(ng,&bm);CHKERRQ(ierr);
+      ierr   = PetscBLASIntCast(lda,&blda);CHKERRQ(ierr);
+      ierr   = VecGetArray(xin,&xx);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&bn,&bm,&sone,yy[j],&blda,alpha+j,&one,&sone,xx,&one));
+      ierr   = VecRestoreArray(xin,&xx);CHKERRQ(ierr);
+      flops += ng*2.0*n;
+    } else {
+      ng   = VecNonContiguousRun_Private(n,nv-j,yy+j);
+      ierr = VecMAXPY_Seq(xin,ng,alpha+j,y+j);CHKERRQ(ierr);
+    }
+  }
+  for (j=0; j<nv; j++) {
+    ierr = VecRestoreArrayRead(y[j],&yy[j]);CHKERRQ(ierr);
+  }
+  if (nv > 128) {
+    ierr = PetscFree(yy);CHKERRQ(ierr);
+  }
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The fused operations below compute the reductions from the updated entries while they are still in cache, so each
+   vector is streamed from memory only once. The multi-vector ones work on strips of VEC_FUSED_STRIP entries: the update
+   with all the x vectors is done on a strip before the strip is reduced, and the update of each strip uses the same
+   kernels and grouping of the vectors as the maxpy operation of the vector, VecMAXPY_Seq() or VecMAXPY_Seq_GEMV().
+*/
+#define VEC_FUSED_STRIP 512
+
+static void VecMAXPYStripKernel_Private(PetscScalar *yy,PetscInt nv,const PetscScalar *alpha,const PetscScalar **xx,PetscInt start,PetscInt n)
+{
+  PetscInt          j = nv&0x3,m;
+  PetscScalar       *u,alpha0,alpha1,alpha2,alpha3;
+  const PetscScalar *x0,*x1,*x2,*x3;
+
+  switch (j) {
+  case 3:
+    u = yy+start; m = n; alpha0 = alpha[0]; alpha1 = alpha[1]; alpha2 = alpha[2];
+    x0 = xx[0]+start; x1 = xx[1]+start; x2 = xx[2]+start;
+    PetscKernelAXPY3(u,alpha0,alpha1,alpha2,x0,x1,x2,m);
+    break;
+  case 2:
+    u = yy+start; m = n; alpha0 = alpha[0]; alpha1 = alpha[1];
+    x0 = xx[0]+start; x1 = xx[1]+start;
+    PetscKernelAXPY2(u,alpha0,alpha1,x0,x1,m);
+    break;
+  case 1:
+    u = yy+start; m = n; alpha0 = alpha[0];
+    x0 = xx[0]+start;
+    PetscKernelAXPY(u,alpha0,x0,m);
+    break;
+  }
+  for (; j<nv; j+=4) {
+    u = yy+start; m = n; alpha0 = alpha[j]; alpha1 = alpha[j+1]; alpha2 = alpha[j+2]; alpha3 = alpha[j+3];
+    x0 = xx[j]+start; x1 = xx[j+1]+start; x2 = xx[j+2]+start; x3 = xx[j+3]+start;
+    PetscKernelAXPY4(u,alpha0,alpha1,alpha2,alpha3,x0,x1,x2,x3,m);
+  }
+}
+
+/* Updates entries start to start+bn-1 of yy, with gemv for the groups of contiguous vectors if gemv is set; nloc is the local length */
+static PetscErrorCode VecMAXPYStrip_Private(PetscScalar *yy,PetscInt nv,const PetscScalar *alpha,const PetscScalar **xx,PetscInt nloc,PetscInt start,PetscInt bn,PetscBool gemv)
+{
+  PetscErrorCode ierr;
+  PetscInt       j,ng,lda;
+  PetscScalar    sone = 1.0;
+  PetscBLASInt   bm,bk,blda,one = 1;
+
+  PetscFunctionBegin;
+  if (!gemv) {
+    VecMAXPYStripKernel_Private(yy,nv,alpha,xx,start,bn);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscBLASIntCast(bn,&bm);CHKERRQ(ierr);
+  for (j=0; j<nv; j+=ng) {
+    ng = VecContiguousGroup_Private(nloc,nv-j,xx+j,&lda);
+    if (ng > 1) {
+      ierr = PetscBLASIntCast(ng,&bk);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(lda,&blda);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&bm,&bk,&sone,xx[j]+start,&blda,alpha+j,&one,&sone,yy+start,&one));
+    } else {
+      ng = VecNonContiguousRun_Private(nloc,nv-j,xx+j);
+      VecMAXPYStripKernel_Private(yy,ng,alpha+j,xx+j,start,bn);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Adds the inner products of entries start to start+bn-1 of yy with those of the xx[j] to sum[j] */
+static PetscErrorCode VecMDotStrip_Private(const PetscScalar *yy,PetscInt nv,const PetscScalar **xx,PetscInt nloc,PetscInt start,PetscInt bn,PetscBool gemv,PetscScalar *sum)
+{
+  PetscErrorCode    ierr;
+  PetscInt          i,j,ng = 1,lda;
+  const PetscScalar *xj;
+  PetscScalar       s,sone = 1.0;
+  PetscBLASInt      bm,bk,blda,one = 1;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(bn,&bm);CHKERRQ(ierr);
+  for (j=0; j<nv; j+=ng) {
+    if (gemv) ng = VecContiguousGroup_Private(nloc,nv-j,xx+j,&lda);
+    if (ng > 1) {
+      ierr = PetscBLASIntCast(ng,&bk);CHKERRQ(ierr);
+      ierr = PetscBLASIntCast(lda,&blda);CHKERRQ(ierr);
+      PetscStackCallBLAS("BLASgemv",BLASgemv_("C",&bm,&bk,&sone,xx[j]+start,&blda,yy+start,&one,&sone,sum+j,&one));
+    } else {
+      xj = xx[j];
+      s  = 0.0;
+      for (i=start; i<start+bn; i++) s += yy[i]*PetscConj(xj[i]);
+      sum[j] += s;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecMAXPYNorm_Seq(Vec yin,PetscInt nv,const PetscScalar *alpha,Vec *x,PetscReal *norm)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = yin->map->n,i,j,k,bn;
+  const PetscScalar *axx[128],**xx = axx;
+  PetscScalar       *yy;
+  PetscReal         sum = 0.0;
+  PetscBool         gemv = (PetscBool)(yin->ops->maxpy == VecMAXPY_Seq_GEMV);
+
+  PetscFunctionBegin;
+  if (nv > 128) {
+    ierr = PetscMalloc1(nv,&xx);CHKERRQ(ierr);
+  }
+  for (j=0; j<nv; j++) {
+    ierr = VecGetArrayRead(x[j],&xx[j]);CHKERRQ(ierr);
+  }
+  ierr = VecGetArray(yin,&yy);CHKERRQ(ierr);
+  for (k=0; k<n; k+=VEC_FUSED_STRIP) {
+    bn = PetscMin(VEC_FUSED_STRIP,n-k);
+    ierr = VecMAXPYStrip_Private(yy,nv,alpha,xx,n,k,bn,gemv);CHKERRQ(ierr);
+    for (i=k; i<k+bn; i++) sum += PetscRealPart(yy[i]*PetscConj(yy[i]));
+  }
+  ierr = VecRestoreArray(yin,&yy);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {
+    ierr = VecRestoreArrayRead(x[j],&xx[j]);CHKERRQ(ierr);
+  }
+  if (nv > 128) {
+    ierr = PetscFree(xx);CHKERRQ(ierr);
+  }
+  *norm = PetscSqrtReal(sum);
+  ierr  = PetscLogFlops(nv*2.0*n + 2.0*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecMAXPYMDot_Seq(Vec yin,PetscInt nv,const PetscScalar *alpha,Vec *x,PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = yin->map->n,j,k,bn;
+  const PetscScalar *axx[128],**xx = axx;
+  PetscScalar       asum[128],*sum = asum,*yy;
+  PetscBool         gemv = (PetscBool)(yin->ops->maxpy == VecMAXPY_Seq_GEMV);
+
+  PetscFunctionBegin;
+  if (nv > 128) {
+    ierr = PetscMalloc2(nv,&xx,nv,&sum);CHKERRQ(ierr);
+  }
+  for (j=0; j<nv; j++) {
+    ierr   = VecGetArrayRead(x[j],&xx[j]);CHKERRQ(ierr);
+    sum[j] = 0.0;
+  }
+  ierr = VecGetArray(yin,&yy);CHKERRQ(ierr);
+  for (k=0; k<n; k+=VEC_FUSED_STRIP) {
+    bn = PetscMin(VEC_FUSED_STRIP,n-k);
+    ierr = VecMAXPYStrip_Private(yy,nv,alpha,xx,n,k,bn,gemv);CHKERRQ(ierr);
+    ierr = VecMDotStrip_Private(yy,nv,xx,n,k,bn,gemv,sum);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(yin,&yy);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {
+    ierr = VecRestoreArrayRead(x[j],&xx[j]);CHKERRQ(ierr);
+  }
+  /* alpha and z may be the same array, so the results are only copied once the update is done */
+  ierr = PetscArraycpy(z,sum,nv);CHKERRQ(ierr);
+  if (nv > 128) {
+    ierr = PetscFree2(xx,sum);CHKERRQ(ierr);
+  }
+  ierr = PetscLogFlops(nv*4.0*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecAXPYNorm_Seq(Vec yin,PetscScalar alpha,Vec xin,PetscReal *norm)
+{
+  PetscErrorCode    ierr;
+  PetscInt          i,n = yin->map->n;
+  const PetscScalar *xx;
+  PetscScalar       *yy;
+  PetscReal         sum = 0.0;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr = VecGetArray(yin,&yy);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    yy[i] += alpha*xx[i];
+    sum   += PetscRealPart(yy[i]*PetscConj(yy[i]));
+  }
+  ierr  = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr  = VecRestoreArray(yin,&yy);CHKERRQ(ierr);
+  *norm = PetscSqrtReal(sum);
+  ierr  = PetscLogFlops(4.0*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecWAXPYDot_Seq(Vec win,PetscScalar alpha,Vec xin,Vec yin,Vec zin,PetscScalar *dot,PetscReal *norm)
+{
+  PetscErrorCode    ierr;
+  PetscInt          i,n = win->map->n;
+  const PetscScalar *xx,*yy,*zz;
+  PetscScalar       *ww,d = 0.0;
+  PetscReal         sum = 0.0;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(yin,&yy);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(zin,&zz);CHKERRQ(ierr);
+  ierr = VecGetArray(win,&ww);CHKERRQ(ierr);
+  if (norm) {
+    for (i=0; i<n; i++) {
+      ww[i] = yy[i] + alpha*xx[i];
+      d    += ww[i]*PetscConj(zz[i]);
+      sum  += PetscRealPart(ww[i]*PetscConj(ww[i]));
+    }
+    *norm = PetscSqrtReal(sum);
+  } else {
+    for (i=0; i<n; i++) {
+      ww[i] = yy[i] + alpha*xx[i];
+      d    += ww[i]*PetscConj(zz[i]);
+    }
+  }
+  ierr = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(yin,&yy);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(zin,&zz);CHKERRQ(ierr);
+  ierr = VecRestoreArray(win,&ww);CHKERRQ(ierr);
+  *dot = d;
+  ierr = PetscLogFlops(norm ? 6.0*n : 4.0*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode VecMaxPointwiseDivide_Seq(Vec xin,Vec yin,PetscReal *max)
 {
   PetscErrorCode    ierr;
@@ -137,6 +137,7 @@ PETSC_EXTERN void MPIAPI PetscSplitReduction_Local(void*,void*,PetscMPIInt*,MPI_
 
 const char *const NormTypes[] = {"1","2","FROBENIUS","INFINITY","1_AND_2","NormType","NORM_",0};
 PetscInt          NormIds[7];  /* map from NormType to IDs used to cache Normvalues */
+PetscBool         VecMDotUseGEMV = PETSC_FALSE,VecMAXPYUseGEMV = PETSC_FALSE;
 
 static PetscBool  VecPackageInitialized = PETSC_FALSE;
 
@@ -154,7 +155,7 @@ PetscErrorCode  VecInitializePackage(void)
   char           logList[256];
   PetscBool      opt,pkg;
   PetscErrorCode ierr;
-  PetscInt       i;
+  PetscInt       i,poolmax;
 
   PetscFunctionBegin;
   if (VecPackageInitialized) PetscFunctionReturn(0);
@@ -183,6 +184,10 @@ PetscErrorCode  VecInitializePackage(void)
   ierr = PetscLogEventRegister("VecAXPBYCZ",       VEC_CLASSID,&VEC_AXPBYPCZ);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecWAXPY",         VEC_CLASSID,&VEC_WAXPY);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecMAXPY",         VEC_CLASSID,&VEC_MAXPY);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecAXPYNorm",      VEC_CLASSID,&VEC_AXPYNorm);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecWAXPYDot",      VEC_CLASSID,&VEC_WAXPYDot);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecMAXPYNorm",     VEC_CLASSID,&VEC_MAXPYNorm);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecMAXPYMDot",     VEC_CLASSID,&VEC_MAXPYMDot);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecSwap",          VEC_CLASSID,&VEC_Swap);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecOps",           VEC_CLASSID,&VEC_Ops);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecAssemblyBegin", VEC_CLASSID,&VEC_AssemblyBegin);CHKERRQ(ierr);
@@ -250,6 +255,14 @@ PetscErrorCode  VecInitializePackage(void)
     ierr = PetscObjectComposedDataRegister(NormIds+i);CHKERRQ(ierr);
   }
 
+  /* Keep destroyed vectors for VecDuplicate() */
+  ierr = PetscOptionsGetInt(NULL,NULL,"-vec_pool",&poolmax,&opt);CHKERRQ(ierr);
+  if (opt) {ierr = VecPoolSetMaximum(poolmax);CHKERRQ(ierr);}
+
+  /* Store the vectors of VecDuplicateVecs() in one array for VECSEQ and VECMPI */
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_mdot_use_gemv",&VecMDotUseGEMV,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-vec_maxpy_use_gemv",&VecMAXPYUseGEMV,NULL);CHKERRQ(ierr);
+
   /* Register package finalizer */
   ierr = PetscRegisterFinalize(VecFinalizePackage);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -278,6 +291,8 @@ PetscErrorCode  VecFinalizePackage(void)
   }
   VecPackageInitialized = PETSC_FALSE;
   VecRegisterAllCalled  = PETSC_FALSE;
+  VecMDotUseGEMV        = PETSC_FALSE;
+  VecMAXPYUseGEMV       = PETSC_FALSE;
   PetscFunctionReturn(0);
 }
 
@@ -1217,6 +1217,236 @@ PetscErrorCode  VecMAXPY(Vec y,PetscInt nv,const PetscScalar alpha[],Vec x[])
   PetscFunctionReturn(0);
 }
 
+/*@
+   VecAXPYNorm - Computes y = y + alpha x and the 2-norm of the result with a single pass over the vectors
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  alpha - the scalar
+-  x, y  - the vectors
+
+   Output Parameters:
++  y - the result
+-  norm - the 2-norm of the result
+
+   Level: intermediate
+
+   Notes:
+    x and y MUST be different vectors
+
+    This is equivalent to VecAXPY() followed by VecNorm() with NORM_2, but the vector implementation may compute the
+    norm while the entries of y are updated and uses only one reduction. The norm is cached, so a following VecNorm()
+    or VecNormalize() of y does not communicate.
+
+.seealso: VecAXPY(), VecNorm(), VecMAXPYNorm(), VecWAXPYDot()
+@*/
+PetscErrorCode  VecAXPYNorm(Vec y,PetscScalar alpha,Vec x,PetscReal *norm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(x,VEC_CLASSID,3);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,1);
+  PetscValidRealPointer(norm,4);
+  PetscValidType(x,3);
+  PetscValidType(y,1);
+  PetscCheckSameTypeAndComm(x,3,y,1);
+  VecCheckSameSize(x,1,y,3);
+  if (x == y) SETERRQ(PetscObjectComm((PetscObject)x),PETSC_ERR_ARG_IDN,"x and y cannot be the same vector");
+  PetscValidLogicalCollectiveScalar(y,alpha,2);
+  if (!y->ops->axpynorm) {
+    ierr = VecAXPY(y,alpha,x);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_2,norm);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecSetErrorIfLocked(y,1);CHKERRQ(ierr);
+
+  ierr = VecLockReadPush(x);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(VEC_AXPYNorm,x,y,0,0);CHKERRQ(ierr);
+  ierr = (*y->ops->axpynorm)(y,alpha,x,norm);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_AXPYNorm,x,y,0,0);CHKERRQ(ierr);
+  ierr = VecLockReadPop(x);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
+  ierr = PetscObjectComposedDataSetReal((PetscObject)y,NormIds[NORM_2],*norm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecWAXPYDot - Computes w = alpha x + y together with the inner product (w,z) and optionally the 2-norm of w,
+   with a single pass over the vectors and a single reduction
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  alpha - the scalar
+.  x, y  - the vectors
+-  z - the vector the result is multiplied with
+
+   Output Parameters:
++  w - the result
+.  dot - the inner product (w,z) = z^H w, as computed by VecDot(w,z)
+-  norm - the 2-norm of w, or NULL if it is not needed
+
+   Level: intermediate
+
+   Notes:
+    w cannot be either x or y, but z can be any of the vectors
+
+.seealso: VecWAXPY(), VecDot(), VecAXPYNorm(), VecDotNorm2()
+@*/
+PetscErrorCode  VecWAXPYDot(Vec w,PetscScalar alpha,Vec x,Vec y,Vec z,PetscScalar *dot,PetscReal *norm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(w,VEC_CLASSID,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,3);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,4);
+  PetscValidHeaderSpecific(z,VEC_CLASSID,5);
+  PetscValidScalarPointer(dot,6);
+  PetscValidType(w,1);
+  PetscValidType(x,3);
+  PetscValidType(y,4);
+  PetscValidType(z,5);
+  PetscCheckSameTypeAndComm(x,3,y,4);
+  PetscCheckSameTypeAndComm(y,4,w,1);
+  PetscCheckSameTypeAndComm(w,1,z,5);
+  VecCheckSameSize(x,3,y,4);
+  VecCheckSameSize(x,3,w,1);
+  VecCheckSameSize(w,1,z,5);
+  if (w == y) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Result vector w cannot be same as input vector y");
+  if (w == x) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Result vector w cannot be same as input vector x");
+  PetscValidLogicalCollectiveScalar(y,alpha,2);
+  if (!w->ops->waxpydot) {
+    ierr = VecWAXPY(w,alpha,x,y);CHKERRQ(ierr);
+    ierr = VecDot(w,z,dot);CHKERRQ(ierr);
+    if (norm) {ierr = VecNorm(w,NORM_2,norm);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  ierr = VecSetErrorIfLocked(w,1);CHKERRQ(ierr);
+
+  ierr = PetscLogEventBegin(VEC_WAXPYDot,x,y,w,z);CHKERRQ(ierr);
+  ierr = (*w->ops->waxpydot)(w,alpha,x,y,z,dot,norm);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_WAXPYDot,x,y,w,z);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)w);CHKERRQ(ierr);
+  if (norm) {ierr = PetscObjectComposedDataSetReal((PetscObject)w,NormIds[NORM_2],*norm);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+   Checks the arguments of VecMAXPYNorm() and VecMAXPYMDot(), which are those of VecMAXPY()
+*/
+static PetscErrorCode VecMAXPYCheck_Private(Vec y,PetscInt nv,const PetscScalar alpha[],Vec x[])
+{
+  PetscInt i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(y,VEC_CLASSID,1);
+  PetscValidLogicalCollectiveInt(y,nv,2);
+  if (nv < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors (given %D) must be positive",nv);
+  PetscValidScalarPointer(alpha,3);
+  PetscValidPointer(x,4);
+  PetscValidHeaderSpecific(*x,VEC_CLASSID,4);
+  PetscValidType(y,1);
+  PetscValidType(*x,4);
+  PetscCheckSameTypeAndComm(y,1,*x,4);
+  VecCheckSameSize(y,1,*x,4);
+  for (i=0; i<nv; i++) PetscValidLogicalCollectiveScalar(y,alpha[i],3);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecMAXPYNorm - Computes y = y + sum alpha[i] x[i] and the 2-norm of the result with a single pass over the vectors
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  nv - number of scalars and x-vectors
+.  alpha - array of scalars
+.  y - one vector
+-  x - array of vectors
+
+   Output Parameter:
+.  norm - the 2-norm of the result
+
+   Level: intermediate
+
+   Notes:
+    y cannot be any of the x vectors
+
+    This is equivalent to VecMAXPY() followed by VecNorm() with NORM_2 and is used by the Gram-Schmidt
+    orthogonalization of KSPGMRES. The norm is cached, so a following VecNormalize() of y does not communicate.
+
+.seealso: VecMAXPY(), VecMAXPYMDot(), VecAXPYNorm()
+@*/
+PetscErrorCode  VecMAXPYNorm(Vec y,PetscInt nv,const PetscScalar alpha[],Vec x[],PetscReal *norm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecMAXPYCheck_Private(y,nv,alpha,x);CHKERRQ(ierr);
+  PetscValidRealPointer(norm,5);
+  if (!y->ops->maxpynorm) {
+    ierr = VecMAXPY(y,nv,alpha,x);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_2,norm);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecSetErrorIfLocked(y,1);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(VEC_MAXPYNorm,*x,y,0,0);CHKERRQ(ierr);
+  ierr = (*y->ops->maxpynorm)(y,nv,alpha,x,norm);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_MAXPYNorm,*x,y,0,0);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
+  ierr = PetscObjectComposedDataSetReal((PetscObject)y,NormIds[NORM_2],*norm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecMAXPYMDot - Computes y = y + sum alpha[i] x[i] and then the inner products of the result with the same x[i],
+   with a single pass over the vectors and a single reduction
+
+   Logically Collective on Vec
+
+   Input Parameters:
++  nv - number of scalars and x-vectors
+.  alpha - array of scalars
+.  y - one vector
+-  x - array of vectors
+
+   Output Parameter:
+.  val - array of the inner products (y,x[i]) = x[i]^H y of the updated y, as computed by VecMDot(y,nv,x,val)
+
+   Level: intermediate
+
+   Notes:
+    y cannot be any of the x vectors; alpha and val may be the same array.
+
+    The inner products that give the coefficients of VecMAXPY() need a global reduction before the update can start,
+    so VecMDot() followed by VecMAXPY() cannot share a pass. The reverse order can: this is the update of one
+    Gram-Schmidt pass fused with the inner products of the next one, as in classical Gram-Schmidt with refinement.
+
+.seealso: VecMAXPY(), VecMDot(), VecMAXPYNorm()
+@*/
+PetscErrorCode  VecMAXPYMDot(Vec y,PetscInt nv,const PetscScalar alpha[],Vec x[],PetscScalar val[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecMAXPYCheck_Private(y,nv,alpha,x);CHKERRQ(ierr);
+  PetscValidScalarPointer(val,5);
+  if (!y->ops->maxpymdot) {
+    ierr = VecMAXPY(y,nv,alpha,x);CHKERRQ(ierr);
+    ierr = VecMDot(y,nv,x,val);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecSetErrorIfLocked(y,1);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(VEC_MAXPYMDot,*x,y,0,0);CHKERRQ(ierr);
+  ierr = (*y->ops->maxpymdot)(y,nv,alpha,x,val);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_MAXPYMDot,*x,y,0,0);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    VecGetSubVector - Gets a vector representing part of another vector
 
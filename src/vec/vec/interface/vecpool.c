@@ -0,0 +1,225 @@
+/*
+     Keeps VECSEQ and VECMPI vectors released by VecDestroy() so that a later VecDuplicate() of a vector with the same
+   layout reuses them instead of creating a new vector.
+*/
+#include <petsc/private/vecimpl.h>    /*I  "petscvec.h"   I*/
+#include <../src/vec/vec/impls/mpi/pvecimpl.h>
+
+static PetscInt       VecPoolMax        = 0;
+static PetscInt       VecPoolN          = 0,VecPoolAlloc = 0;
+static Vec            *VecPoolVecs      = NULL;   /* the kept vectors, the most recently destroyed last */
+static PetscContainer VecPoolContainer  = NULL;
+static PetscBool      VecPoolDestroying = PETSC_FALSE;
+static PetscLogDouble VecPoolRequests   = 0,VecPoolHits = 0,VecPoolKept = 0,VecPoolEvicted = 0;
+
+/* destroys a kept vector for real */
+static PetscErrorCode VecPoolDestroyVec_Private(Vec v)
+{
+  PetscErrorCode ierr;
+  PetscBool      destroying = VecPoolDestroying;
+
+  PetscFunctionBegin;
+  ((PetscObject)v)->refct = 1;
+  VecPoolDestroying       = PETSC_TRUE;
+  ierr                    = VecDestroy(&v);CHKERRQ(ierr);
+  VecPoolDestroying       = destroying;
+  PetscFunctionReturn(0);
+}
+
+/* removes the kept vector at position i and destroys it for real */
+static PetscErrorCode VecPoolRemove_Private(PetscInt i)
+{
+  PetscErrorCode ierr;
+  Vec            v = VecPoolVecs[i];
+
+  PetscFunctionBegin;
+  for (i++; i<VecPoolN; i++) VecPoolVecs[i-1] = VecPoolVecs[i];
+  VecPoolN--;
+  ierr = VecPoolDestroyVec_Private(v);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecPoolContainerDestroy_Private(void *ctx)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr             = VecPoolClear();CHKERRQ(ierr);
+  ierr             = PetscFree(VecPoolVecs);CHKERRQ(ierr);
+  VecPoolAlloc     = 0;
+  VecPoolMax       = 0;
+  VecPoolContainer = NULL;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecPoolView_Private(FILE *fp,PetscMPIInt rank)
+{
+  PetscFunctionBegin;
+  if (!VecPoolRequests && !VecPoolKept) PetscFunctionReturn(0);
+  (void) fprintf(fp,"[%d] Vector pool: %.0f VecDuplicate() of VECSEQ and VECMPI vectors, %.0f served from the pool (%.1f%%), %.0f vectors kept by VecDestroy(), %.0f destroyed when the pool was full\n",rank,VecPoolRequests,VecPoolHits,VecPoolRequests ? 100.0*VecPoolHits/VecPoolRequests : 0.0,VecPoolKept,VecPoolEvicted);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecPoolSetMaximum - Sets how many VECSEQ and VECMPI vectors of each layout released by VecDestroy() are kept for reuse by VecDuplicate()
+
+   Not Collective
+
+   Input Parameter:
+.  max - the most vectors kept per layout, 0 turns off the pool
+
+   Options Database Key:
+.  -vec_pool <max> - the most vectors kept per layout
+
+   Level: advanced
+
+   Notes:
+   Codes that create and destroy many short lived work vectors, such as the vectors of line searches or of Krylov methods
+   set up in each nonlinear iteration, spend much time in creating them anew. With the pool a vector whose reference count
+   drops to zero in VecDestroy() is kept instead, with its name, prefix and composed objects removed, and VecDuplicate()
+   of a vector with the same layout (the same PetscLayout, as shared by all the duplicates of a vector) and the same
+   operations returns it, zeroed, instead of creating a new one. When max vectors of the layout are kept the oldest of them
+   is destroyed, and when only the pool still refers to the layout all of them are.
+
+   Only vectors that own their array, have no ghost points and no VecPlaceArray() in effect are kept. The pool is emptied
+   at the start of PetscFinalize(). -malloc_view prints how many VecDuplicate() were served from the pool.
+
+   A new vector takes MPI tags from its communicator and a reused one does not, so the processes of a communicator must
+   destroy and duplicate its vectors in the same order, as is usual for collective objects.
+
+.seealso: VecPoolClear(), VecDuplicate(), VecDestroy(), PetscMallocSetPool()
+@*/
+PetscErrorCode VecPoolSetMaximum(PetscInt max)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (max < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Maximum %D cannot be negative",max);
+  if (max < VecPoolMax) {ierr = VecPoolClear();CHKERRQ(ierr);}
+  if (max && !VecPoolContainer) {
+    /* the container empties the pool in PetscObjectRegisterDestroyAll(), before the objects are counted in PetscFinalize() */
+    ierr = PetscContainerCreate(PETSC_COMM_SELF,&VecPoolContainer);CHKERRQ(ierr);
+    ierr = PetscContainerSetUserDestroy(VecPoolContainer,VecPoolContainerDestroy_Private);CHKERRQ(ierr);
+    ierr = PetscObjectRegisterDestroy((PetscObject)VecPoolContainer);CHKERRQ(ierr);
+    ierr = PetscMallocViewAddFunction_Private(VecPoolView_Private);CHKERRQ(ierr);
+  }
+  VecPoolMax = max;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecPoolClear - Destroys the vectors kept for reuse by VecPoolSetMaximum()
+
+   Not Collective
+
+   Level: advanced
+
+.seealso: VecPoolSetMaximum()
+@*/
+PetscErrorCode VecPoolClear(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  while (VecPoolN) {ierr = VecPoolRemove_Private(VecPoolN-1);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecPoolPush_Private - Keeps a vector whose reference count dropped to zero in VecDestroy(), if it can be reused
+*/
+PetscErrorCode VecPoolPush_Private(Vec v,PetscBool *kept)
+{
+  PetscErrorCode ierr;
+  PetscObject    obj = (PetscObject)v;
+  Vec_Seq        *s = (Vec_Seq*)v->data;
+  PetscBool      isseq,ismpi;
+  PetscInt       i,cnt;
+
+  PetscFunctionBegin;
+  *kept = PETSC_FALSE;
+  if (!VecPoolMax || VecPoolDestroying || v->lock || obj->python_context || !s) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare(obj,VECSEQ,&isseq);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare(obj,VECMPI,&ismpi);CHKERRQ(ierr);
+  if (!isseq && !ismpi) PetscFunctionReturn(0);
+  /* the test must come out the same on all processes, a process that creates a vector while the others reuse theirs
+     would take other MPI tags from the communicator; so a process without entries, whose array is NULL, keeps it too */
+  if ((!s->array_allocated && v->map->n) || s->array != s->array_allocated || s->unplacedarray) PetscFunctionReturn(0);
+  if (ismpi) {
+    Vec_MPI *m = (Vec_MPI*)v->data;
+
+    if (m->localrep || m->assembly_subset) PetscFunctionReturn(0);
+  }
+
+  /* remove what VecDuplicate() sets anew */
+  ierr = PetscObjectDestroyOptionsHandlers(obj);CHKERRQ(ierr);
+  ierr = PetscObjectListDestroy(&obj->olist);CHKERRQ(ierr);
+  ierr = PetscFunctionListDestroy(&obj->qlist);CHKERRQ(ierr);
+  ierr = PetscFree(obj->name);CHKERRQ(ierr);
+  ierr = PetscFree(obj->prefix);CHKERRQ(ierr);
+
+  /* the limit is per layout, so that the same vectors are destroyed on all the processes of its communicator */
+  for (i=0,cnt=0; i<VecPoolN; i++) if (VecPoolVecs[i]->map == v->map) cnt++;
+  if (cnt == VecPoolMax) {
+    for (i=0; VecPoolVecs[i]->map != v->map; i++) ;
+    ierr = VecPoolRemove_Private(i);CHKERRQ(ierr);
+    VecPoolEvicted++;
+    cnt--;
+  }
+  if (VecPoolN == VecPoolAlloc) {
+    VecPoolAlloc = 2*VecPoolAlloc + 16;
+    ierr = PetscRealloc(VecPoolAlloc*sizeof(Vec),&VecPoolVecs);CHKERRQ(ierr);
+  }
+  VecPoolVecs[VecPoolN++] = v;
+  VecPoolKept++;
+  /* when the pool holds all the references to the layout no VecDuplicate() can ask for these vectors any more */
+  if (v->map->refcnt == cnt) {
+    for (i=VecPoolN-1; i>=0; i--) if (VecPoolVecs[i]->map == v->map) {ierr = VecPoolRemove_Private(i);CHKERRQ(ierr);}
+  }
+  *kept = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   VecPoolPop_Private - Gives VecDuplicate() a kept vector with the layout and operations of win, if there is one
+*/
+PetscErrorCode VecPoolPop_Private(Vec win,Vec *v,PetscBool *found)
+{
+  PetscErrorCode ierr;
+  PetscBool      isseq,ismpi;
+  PetscInt       i;
+  Vec            p = NULL;
+
+  PetscFunctionBegin;
+  *found = PETSC_FALSE;
+  if (!VecPoolMax) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)win,VECSEQ,&isseq);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)win,VECMPI,&ismpi);CHKERRQ(ierr);
+  if (!isseq && !ismpi) PetscFunctionReturn(0);
+  VecPoolRequests++;
+  /* the most recently destroyed first, its array is the most likely to be in cache */
+  for (i=VecPoolN-1; i>=0; i--) {
+    PetscBool same = PETSC_FALSE;
+
+    p = VecPoolVecs[i];
+    if (p->map == win->map) {ierr = PetscMemcmp(p->ops,win->ops,sizeof(struct _VecOps),&same);CHKERRQ(ierr);}
+    if (same) break;
+  }
+  if (i < 0) PetscFunctionReturn(0);
+  for (i++; i<VecPoolN; i++) VecPoolVecs[i-1] = VecPoolVecs[i];
+  VecPoolN--;
+  VecPoolHits++;
+
+  ((PetscObject)p)->refct = 1;
+  ierr = PetscObjectListDuplicate(((PetscObject)win)->olist,&((PetscObject)p)->olist);CHKERRQ(ierr);
+  ierr = PetscFunctionListDuplicate(((PetscObject)win)->qlist,&((PetscObject)p)->qlist);CHKERRQ(ierr);
+  p->stash.ignorenegidx = win->stash.ignorenegidx;
+  if (ismpi) {
+    p->stash.donotstash = win->stash.donotstash;
+    p->bstash.bs        = win->bstash.bs;
+  }
+  ierr   = VecSet(p,0.0);CHKERRQ(ierr);
+  *v     = p;
+  *found = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
@@ -12,6 +12,7 @@ PetscLogEvent VEC_MTDot, VEC_MAXPY, VEC_Swap, VEC_AssemblyBegin, VEC_ScatterBegi
 PetscLogEvent VEC_AssemblyEnd, VEC_PointwiseMult, VEC_SetValues, VEC_Load;
 PetscLogEvent VEC_SetRandom, VEC_ReduceArithmetic, VEC_ReduceCommunication,VEC_ReduceBegin,VEC_ReduceEnd,VEC_Ops;
 PetscLogEvent VEC_DotNorm2, VEC_AXPBYPCZ;
+PetscLogEvent VEC_AXPYNorm, VEC_MAXPYNorm, VEC_MAXPYMDot, VEC_WAXPYDot;
 PetscLogEvent VEC_ViennaCLCopyFromGPU, VEC_ViennaCLCopyToGPU;
 PetscLogEvent VEC_CUDACopyFromGPU, VEC_CUDACopyToGPU;
 PetscLogEvent VEC_CUDACopyFromGPUSome, VEC_CUDACopyToGPUSome;
@@ -359,12 +360,14 @@ PetscErrorCode  VecPointwiseDivide(Vec w,Vec x,Vec y)
 PetscErrorCode  VecDuplicate(Vec v,Vec *newv)
 {
   PetscErrorCode ierr;
+  PetscBool      pooled;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(v,VEC_CLASSID,1);
   PetscValidPointer(newv,2);
   PetscValidType(v,1);
-  ierr = (*v->ops->duplicate)(v,newv);CHKERRQ(ierr);
+  ierr = VecPoolPop_Private(v,newv,&pooled);CHKERRQ(ierr);
+  if (!pooled) {ierr = (*v->ops->duplicate)(v,newv);CHKERRQ(ierr);}
   ierr = PetscObjectStateIncrease((PetscObject)*newv);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -384,6 +387,7 @@ PetscErrorCode  VecDuplicate(Vec v,Vec *newv)
 PetscErrorCode  VecDestroy(Vec *v)
 {
   PetscErrorCode ierr;
+  PetscBool      pooled;
 
   PetscFunctionBegin;
   if (!*v) PetscFunctionReturn(0);
@@ -391,6 +395,9 @@ PetscErrorCode  VecDestroy(Vec *v)
   if (--((PetscObject)(*v))->refct > 0) {*v = 0; PetscFunctionReturn(0);}
 
   ierr = PetscObjectSAWsViewOff((PetscObject)*v);CHKERRQ(ierr);
+  /* keep the vector for a later VecDuplicate() if there is a pool */
+  ierr = VecPoolPush_Private(*v,&pooled);CHKERRQ(ierr);
+  if (pooled) {*v = NULL; PetscFunctionReturn(0);}
   /* destroy the internal part */
   if ((*v)->ops->destroy) {
     ierr = (*(*v)->ops->destroy)(*v);CHKERRQ(ierr);
@@ -413,10 +420,18 @@ PetscErrorCode  VecDestroy(Vec *v)
    Output Parameter:
 .  V - location to put pointer to array of vectors
 
+   Options Database Keys:
++  -vec_mdot_use_gemv - for VECSEQ and VECMPI store the vectors in the columns of one array and compute VecMDot() with BLAS gemv
+-  -vec_maxpy_use_gemv - for VECSEQ and VECMPI store the vectors in the columns of one array and compute VecMAXPY() with BLAS gemv
+
    Notes:
    Use VecDestroyVecs() to free the space. Use VecDuplicate() to form a single
    vector.
 
+   With the options above the vectors share one allocation, so the Krylov bases of KSPGMRES, KSPFGMRES, KSPLGMRES and
+   KSPDGMRES, which are obtained with VecDuplicateVecs(), are orthogonalized and combined with one gemv per group of
+   vectors instead of a pass over each vector.
+
    Fortran Note:
    The Fortran interface is slightly different from that given below, it
    requires one to pass in V a Vec (integer) array of size at least m.
@@ -1261,6 +1276,11 @@ static PetscErrorCode VecSetTypeFromOptions_Private(PetscOptionItems *PetscOptio
   Input Parameter:
 . vec - The vector
 
+  Options Database Keys:
++ -vec_type <type> - the vector type, see VecSetType()
+. -vec_mdot_use_gemv - for VECSEQ and VECMPI vectors created from now on, compute VecMDot() with BLAS gemv, see VecDuplicateVecs()
+- -vec_maxpy_use_gemv - for VECSEQ and VECMPI vectors created from now on, compute VecMAXPY() with BLAS gemv
+
   Notes:
     To see all options, run your program with the -help option, or consult the users manual.
           Must be called after VecCreate() but before the vector is used.
@@ -1278,6 +1298,9 @@ PetscErrorCode  VecSetFromOptions(Vec vec)
   PetscValidHeaderSpecific(vec,VEC_CLASSID,1);
 
   ierr = PetscObjectOptionsBegin((PetscObject)vec);CHKERRQ(ierr);
+  /* Handled before the type is set so that the VECSEQ and VECMPI constructors see them */
+  ierr = PetscOptionsBool("-vec_mdot_use_gemv","Compute VecMDot() with BLAS gemv","VecDuplicateVecs",VecMDotUseGEMV,&VecMDotUseGEMV,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-vec_maxpy_use_gemv","Compute VecMAXPY() with BLAS gemv","VecDuplicateVecs",VecMAXPYUseGEMV,&VecMAXPYUseGEMV,NULL);CHKERRQ(ierr);
   /* Handle vector type options */
   ierr = VecSetTypeFromOptions_Private(PetscOptionsObject,vec);CHKERRQ(ierr);
 
@@ -0,0 +1,140 @@
+static char help[] = "Tests the fused operations VecAXPYNorm(), VecWAXPYDot(), VecMAXPYNorm() and VecMAXPYMDot() against the separate ones.\n\n";
+
+#include <petscvec.h>
+
+static PetscErrorCode CheckVec(const char *op,Vec x,Vec y,PetscReal tol)
+{
+  PetscReal      norm,ref;
+  Vec            d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+  if (norm > tol*ref) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: vectors differ by %g\n",op,(double)norm);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckScalars(const char *op,PetscInt n,const PetscScalar a[],const PetscScalar b[],PetscReal tol)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    if (PetscAbsScalar(a[i]-b[i]) > tol*PetscMax(1.0,PetscAbsScalar(b[i]))) break;
+  }
+  if (i < n) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: result %D differs by %g\n",op,i,(double)PetscAbsScalar(a[i]-b[i]));CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results agree\n",op);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Vec            x,y,w,z,yf,wf,*v;
+  PetscInt       n = 1031,nv = 7,j;
+  PetscScalar    alpha = -0.75,dot[2],*coef,*dots,*dotsf;
+  PetscReal      tol = 1000*PETSC_MACHINE_EPSILON,norm[2];
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nv",&nv,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,PETSC_DECIDE,n);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&w);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&yf);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&wf);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(x,nv,&v);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(y,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rand);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {ierr = VecSetRandom(v[j],rand);CHKERRQ(ierr);}
+  ierr = PetscMalloc3(nv,&coef,nv,&dots,nv,&dotsf);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) coef[j] = 1.0/(j+2.0) - 0.3;
+
+  /* y + alpha x */
+  ierr = VecCopy(y,yf);CHKERRQ(ierr);
+  ierr = VecAXPY(y,alpha,x);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_2,&norm[0]);CHKERRQ(ierr);
+  ierr = VecAXPYNorm(yf,alpha,x,&norm[1]);CHKERRQ(ierr);
+  ierr = CheckVec("VecAXPYNorm",y,yf,tol);CHKERRQ(ierr);
+  dot[0] = norm[0]; dot[1] = norm[1];
+  ierr = CheckScalars("VecAXPYNorm",1,dot+1,dot,tol);CHKERRQ(ierr);
+
+  /* w = alpha x + y with (w,z), with and without the norm */
+  ierr = VecWAXPY(w,alpha,x,y);CHKERRQ(ierr);
+  ierr = VecDot(w,z,&dot[0]);CHKERRQ(ierr);
+  ierr = VecNorm(w,NORM_2,&norm[0]);CHKERRQ(ierr);
+  ierr = VecWAXPYDot(wf,alpha,x,y,z,&dot[1],&norm[1]);CHKERRQ(ierr);
+  ierr = CheckVec("VecWAXPYDot",w,wf,tol);CHKERRQ(ierr);
+  ierr = CheckScalars("VecWAXPYDot",1,dot+1,dot,tol);CHKERRQ(ierr);
+  dot[0] = norm[0]; dot[1] = norm[1];
+  ierr = CheckScalars("VecWAXPYDot norm",1,dot+1,dot,tol);CHKERRQ(ierr);
+  ierr = VecSet(wf,0.0);CHKERRQ(ierr);
+  ierr = VecWAXPYDot(wf,alpha,x,y,z,&dot[1],NULL);CHKERRQ(ierr);
+  ierr = CheckVec("VecWAXPYDot without norm",w,wf,tol);CHKERRQ(ierr);
+  ierr = VecDot(w,z,&dot[0]);CHKERRQ(ierr);
+  ierr = CheckScalars("VecWAXPYDot without norm",1,dot+1,dot,tol);CHKERRQ(ierr);
+
+  /* y + sum coef[j] v[j] with the norm or the inner products of the result, coef and the inner products share storage in the second */
+  ierr = VecCopy(y,yf);CHKERRQ(ierr);
+  ierr = VecMAXPY(y,nv,coef,v);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_2,&norm[0]);CHKERRQ(ierr);
+  ierr = VecMAXPYNorm(yf,nv,coef,v,&norm[1]);CHKERRQ(ierr);
+  ierr = CheckVec("VecMAXPYNorm",y,yf,tol);CHKERRQ(ierr);
+  dot[0] = norm[0]; dot[1] = norm[1];
+  ierr = CheckScalars("VecMAXPYNorm",1,dot+1,dot,tol);CHKERRQ(ierr);
+
+  ierr = VecMAXPY(y,nv,coef,v);CHKERRQ(ierr);
+  ierr = VecMDot(y,nv,v,dots);CHKERRQ(ierr);
+  ierr = PetscArraycpy(dotsf,coef,nv);CHKERRQ(ierr);
+  ierr = VecMAXPYMDot(yf,nv,dotsf,v,dotsf);CHKERRQ(ierr);
+  ierr = CheckVec("VecMAXPYMDot",y,yf,tol);CHKERRQ(ierr);
+  ierr = CheckScalars("VecMAXPYMDot",nv,dotsf,dots,tol);CHKERRQ(ierr);
+
+  ierr = PetscFree3(coef,dots,dotsf);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nv,&v);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&yf);CHKERRQ(ierr);
+  ierr = VecDestroy(&wf);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex51_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         nsize: 2
+      test:
+         suffix: 3
+         args: -nv 131 -n 77
+      test:
+         suffix: 4
+         args: -nv 1 -n 3
+
+TEST*/
@@ -0,0 +1,142 @@
+static char help[] = "Tests VecMDot(), VecMAXPY() and the fused multi-vector operations on the contiguous vectors from VecDuplicateVecs().\n\n";
+
+#include <petscvec.h>
+
+static PetscErrorCode CheckVec(const char *op,Vec x,Vec y,PetscReal tol)
+{
+  PetscReal      norm,ref;
+  Vec            d;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(x,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_INFINITY,&norm);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_INFINITY,&ref);CHKERRQ(ierr);
+  if (norm > tol*ref) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: vectors differ by %g\n",op,(double)norm);CHKERRQ(ierr);
+  }
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckScalars(const char *op,PetscInt n,const PetscScalar a[],const PetscScalar b[],PetscReal tol)
+{
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    if (PetscAbsScalar(a[i]-b[i]) > tol*PetscMax(1.0,PetscAbsScalar(b[i]))) break;
+  }
+  if (i < n) {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: result %D differs by %g\n",op,i,(double)PetscAbsScalar(a[i]-b[i]));CHKERRQ(ierr);
+  } else {
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: results agree\n",op);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Vec            x,y,yc,*v,*vc,*vm;
+  PetscInt       n = 1031,nv = 9,j;
+  PetscScalar    *coef,*dots,*dotsc;
+  PetscReal      tol = 1000*PETSC_MACHINE_EPSILON,norm[2];
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nv",&nv,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+
+  /* v are separate vectors, vc hold the same values in one array and vm mixes the two with a swapped pair */
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,PETSC_DECIDE,n);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&yc);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nv,&v,nv,&vm);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {ierr = VecDuplicate(x,&v[j]);CHKERRQ(ierr);}
+  ierr = VecDuplicateVecs(x,nv,&vc);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {
+    ierr  = VecSetRandom(v[j],rand);CHKERRQ(ierr);
+    ierr  = VecCopy(v[j],vc[j]);CHKERRQ(ierr);
+    vm[j] = j % 4 == 3 ? v[j] : vc[j];
+  }
+  if (nv > 2) {vm[1] = vc[2]; vm[2] = vc[1];}
+  ierr = PetscMalloc3(nv,&coef,nv,&dots,nv,&dotsc);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) coef[j] = 1.0/(j+2.0) - 0.3;
+
+  ierr = VecMDot(x,nv,v,dots);CHKERRQ(ierr);
+  ierr = VecMDot(x,nv,vc,dotsc);CHKERRQ(ierr);
+  ierr = CheckScalars("VecMDot",nv,dotsc,dots,tol);CHKERRQ(ierr);
+  ierr = VecMDot(x,nv,vm,dotsc);CHKERRQ(ierr);
+  if (nv > 2) {PetscScalar t = dots[1]; dots[1] = dots[2]; dots[2] = t;}
+  ierr = CheckScalars("VecMDot mixed",nv,dotsc,dots,tol);CHKERRQ(ierr);
+  if (nv > 2) {PetscScalar t = dots[1]; dots[1] = dots[2]; dots[2] = t;}
+
+  ierr = VecCopy(x,y);CHKERRQ(ierr);
+  ierr = VecCopy(x,yc);CHKERRQ(ierr);
+  ierr = VecMAXPY(y,nv,coef,v);CHKERRQ(ierr);
+  ierr = VecMAXPY(yc,nv,coef,vc);CHKERRQ(ierr);
+  ierr = CheckVec("VecMAXPY",y,yc,tol);CHKERRQ(ierr);
+  ierr = VecCopy(x,yc);CHKERRQ(ierr);
+  ierr = VecMAXPY(y,nv,coef,vm);CHKERRQ(ierr);
+  ierr = VecMAXPY(yc,nv,coef,vc);CHKERRQ(ierr);
+  ierr = VecMAXPY(yc,nv,coef,vm);CHKERRQ(ierr);
+  ierr = CheckVec("VecMAXPY mixed",y,yc,tol);CHKERRQ(ierr);
+
+  /* the fused operations with the contiguous vectors against the separate operations */
+  ierr = VecCopy(x,y);CHKERRQ(ierr);
+  ierr = VecCopy(x,yc);CHKERRQ(ierr);
+  ierr = VecMAXPY(y,nv,coef,v);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_2,&norm[0]);CHKERRQ(ierr);
+  ierr = VecMAXPYNorm(yc,nv,coef,vc,&norm[1]);CHKERRQ(ierr);
+  ierr = CheckVec("VecMAXPYNorm",y,yc,tol);CHKERRQ(ierr);
+  dots[0] = norm[0]; dotsc[0] = norm[1];
+  ierr = CheckScalars("VecMAXPYNorm",1,dotsc,dots,tol);CHKERRQ(ierr);
+
+  ierr = VecMAXPY(y,nv,coef,vm);CHKERRQ(ierr);
+  ierr = VecMDot(y,nv,vm,dots);CHKERRQ(ierr);
+  ierr = PetscArraycpy(dotsc,coef,nv);CHKERRQ(ierr);
+  ierr = VecMAXPYMDot(yc,nv,dotsc,vm,dotsc);CHKERRQ(ierr);
+  ierr = CheckVec("VecMAXPYMDot mixed",y,yc,tol);CHKERRQ(ierr);
+  ierr = CheckScalars("VecMAXPYMDot mixed",nv,dotsc,dots,tol);CHKERRQ(ierr);
+
+  ierr = PetscFree3(coef,dots,dotsc);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {ierr = VecDestroy(&v[j]);CHKERRQ(ierr);}
+  ierr = VecDestroyVecs(nv,&vc);CHKERRQ(ierr);
+  ierr = PetscFree2(v,vm);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&yc);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex52_1.out
+      args: -vec_mdot_use_gemv -vec_maxpy_use_gemv
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         nsize: 2
+      test:
+         suffix: 3
+         args: -nv 131 -n 77
+      test:
+         suffix: 4
+         args: -nv 2 -n 3
+      test:
+         suffix: mdot
+         args: -vec_maxpy_use_gemv 0
+
+TEST*/
@@ -0,0 +1,131 @@
+static char help[] = "Tests PetscCommSplitReductionSum/Max/MinBegin() and End() combined with VecNormBegin() and VecDotBegin() in one split reduction.\n\n";
+
+#include <petscvec.h>
+
+static PetscErrorCode Check(const char *op,PetscInt n,const PetscScalar *a,const PetscScalar *b)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) if (PetscAbsScalar(a[i]-b[i]) > 100*PETSC_MACHINE_EPSILON*PetscMax(1.0,PetscAbsScalar(b[i]))) break;
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s\n",op,i == n ? "results agree" : "results differ");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size,p;
+  PetscInt       i,n = 10;
+  Vec            x,y;
+  MPI_Comm       comm,pcomm;
+  PetscBool      done,progress = PETSC_FALSE,pending = PETSC_FALSE,async = PETSC_FALSE;
+  PetscScalar    *a,lsum[3],gsum[3],rsum[3],dot,rdot,vals[3],rvals[3];
+  PetscReal      lmax[2],gmax[2],rmax[2],lmin[2],gmin[2],rmin[2],norm,rnorm;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-progress",&progress,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-check_pending",&pending,NULL);CHKERRQ(ierr);
+  if (pending && size == 1) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_ARG_WRONG,"-check_pending requires at least two processes");
+#if defined(PETSC_HAVE_MPI_IALLREDUCE) || defined(PETSC_HAVE_MPIX_IALLREDUCE)
+  async = PETSC_TRUE;
+#endif
+  ierr = PetscOptionsGetBool(NULL,NULL,"-splitreduction_async",&async,NULL);CHKERRQ(ierr);
+  if (!async) pending = PETSC_FALSE; /* the reduction is completed inside PetscCommSplitReductionBegin() */
+
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,n,PETSC_DETERMINE,&x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecGetArray(x,&a);CHKERRQ(ierr);
+  for (i=0; i<n; i++) a[i] = (PetscScalar)(i - 3*rank);
+  ierr = VecRestoreArray(x,&a);CHKERRQ(ierr);
+  ierr = VecSet(y,2.0);CHKERRQ(ierr);
+  ierr = VecNorm(x,NORM_2,&rnorm);CHKERRQ(ierr);
+  ierr = VecDot(x,y,&rdot);CHKERRQ(ierr);
+  ierr = PetscObjectGetComm((PetscObject)x,&comm);CHKERRQ(ierr);
+
+  for (i=0; i<3; i++) lsum[i] = (PetscScalar)((i+1)*(rank+1));
+  lmax[0] = lmin[0] = (PetscReal)(rank % 3);
+  lmax[1] = lmin[1] = (PetscReal)(-2*rank);
+  ierr = MPIU_Allreduce(lsum,rsum,3,MPIU_SCALAR,MPIU_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(lmax,rmax,2,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(lmin,rmin,2,MPIU_REAL,MPIU_MIN,PETSC_COMM_WORLD);CHKERRQ(ierr);
+
+  /* sums, maxima, minima, a norm and a dot product in one reduction */
+  ierr = VecNormBegin(x,NORM_2,&norm);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionSumBegin(comm,3,lsum);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionMaxBegin(comm,2,lmax);CHKERRQ(ierr);
+  ierr = VecDotBegin(x,y,&dot);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionMinBegin(comm,2,lmin);CHKERRQ(ierr);
+  /* a queue that has not been started is reported as done */
+  ierr = PetscCommSplitReductionProgress(comm,&done);CHKERRQ(ierr);
+  if (!done) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Queue not started with PetscCommSplitReductionBegin() reported as outstanding");
+  if (pending) {
+    /* the other processes only start their part after the first process has polled, so the reduction cannot be done yet */
+    ierr = MPI_Comm_dup(PETSC_COMM_WORLD,&pcomm);CHKERRQ(ierr);
+    if (!rank) {
+      ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+      ierr = PetscCommSplitReductionProgress(comm,&done);CHKERRQ(ierr);
+      if (done) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Outstanding reduction reported as done");
+      for (p=1; p<size; p++) {ierr = MPI_Send(NULL,0,MPI_INT,p,0,pcomm);CHKERRQ(ierr);}
+    } else {
+      ierr = MPI_Recv(NULL,0,MPI_INT,0,0,pcomm,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+      ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+    }
+    ierr = MPI_Comm_free(&pcomm);CHKERRQ(ierr);
+  } else {
+    ierr = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+  }
+  if (progress) {
+    do {
+      ierr = PetscCommSplitReductionProgress(comm,&done);CHKERRQ(ierr);
+    } while (!done);
+  }
+  ierr = VecNormEnd(x,NORM_2,&norm);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionSumEnd(comm,3,gsum);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionMaxEnd(comm,2,gmax);CHKERRQ(ierr);
+  ierr = VecDotEnd(x,y,&dot);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionMinEnd(comm,2,gmin);CHKERRQ(ierr);
+
+  vals[0] = norm;    rvals[0] = rnorm;
+  vals[1] = dot;     rvals[1] = rdot;
+  ierr = Check("VecNorm and VecDot",2,vals,rvals);CHKERRQ(ierr);
+  ierr = Check("Sum",3,gsum,rsum);CHKERRQ(ierr);
+  vals[0] = gmax[0]; vals[1] = gmax[1]; vals[2] = gmin[0];
+  rvals[0] = rmax[0]; rvals[1] = rmax[1]; rvals[2] = rmin[0];
+  ierr = Check("Max and Min",3,vals,rvals);CHKERRQ(ierr);
+
+  /* only sums, completed by the End() without PetscCommSplitReductionBegin() */
+  ierr = PetscCommSplitReductionSumBegin(comm,2,lsum);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionSumBegin(comm,1,lsum+2);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionSumEnd(comm,2,gsum);CHKERRQ(ierr);
+  ierr = PetscCommSplitReductionSumEnd(comm,1,gsum+2);CHKERRQ(ierr);
+  ierr = Check("Sum without Begin",3,gsum,rsum);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex56_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         nsize: 3
+      test:
+         suffix: 3
+         nsize: 4
+         args: -progress -check_pending
+      test:
+         suffix: 4
+         nsize: 3
+         args: -splitreduction_async 0 -progress
+
+TEST*/
@@ -0,0 +1,93 @@
+static char help[] = "Tests VecPoolSetMaximum(): vectors destroyed and duplicated again, alone and with -malloc_pool.\n\n"
+                     "  -set_malloc_pool: pass PetscMallocPool() to PetscMallocSet() before PetscInitialize()\n";
+
+#include <petscvec.h>
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,it,n = 20;
+  Vec            x,w[3],y,z;
+  PetscScalar    *a,*b,*c;
+  PetscReal      norm;
+  const char     *name;
+
+  /* the options database does not exist yet */
+  for (i=1; i<argc; i++) {
+    if (!strcmp(argv[i],"-set_malloc_pool")) {ierr = PetscMallocSet(PetscMallocPool,PetscFreePool,PetscReallocPool);if (ierr) return ierr;}
+  }
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsHasName(NULL,NULL,"-set_malloc_pool",NULL);CHKERRQ(ierr);
+  ierr = VecPoolSetMaximum(3);CHKERRQ(ierr);
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,PETSC_DECIDE,n,&x);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+
+  /* work vectors of an iteration, as a line search or a Krylov method sets up; they come back zeroed and unnamed */
+  for (it=0; it<4; it++) {
+    for (i=0; i<3; i++) {
+      ierr = VecDuplicate(x,&w[i]);CHKERRQ(ierr);
+      ierr = VecNorm(w[i],NORM_1,&norm);CHKERRQ(ierr);
+      if (norm != 0.0) SETERRQ2(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"Duplicate %D of iteration %D is not zero",i,it);
+      ierr = PetscObjectGetName((PetscObject)w[i],&name);CHKERRQ(ierr);
+      if (!strncmp(name,"work",4)) SETERRQ1(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"Duplicate of iteration %D kept its name",it);
+      ierr = VecSet(w[i],(PetscScalar)(it+i));CHKERRQ(ierr);
+      ierr = PetscObjectSetName((PetscObject)w[i],"work");CHKERRQ(ierr);
+    }
+    ierr = VecAXPY(w[0],1.0,w[1]);CHKERRQ(ierr);
+    ierr = VecNorm(w[0],NORM_1,&norm);CHKERRQ(ierr);
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"Iteration %D: norm %g\n",it,(double)norm);CHKERRQ(ierr);
+    for (i=0; i<3; i++) {ierr = VecDestroy(&w[i]);CHKERRQ(ierr);}
+  }
+
+  /* a vector with a placed array is not kept, the array stays with the caller */
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = VecGetArray(z,&b);CHKERRQ(ierr);
+  ierr = VecGetArray(y,&a);CHKERRQ(ierr);
+  ierr = VecRestoreArray(y,&a);CHKERRQ(ierr);
+  ierr = VecPlaceArray(y,b);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecRestoreArray(z,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecGetArray(y,&c);CHKERRQ(ierr);
+  if (c == b) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"A vector with a placed array was reused");
+  ierr = VecRestoreArray(y,&c);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+
+  /* a smaller maximum empties the pool */
+  ierr = VecPoolSetMaximum(1);CHKERRQ(ierr);
+  ierr = VecPoolClear();CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex57_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         nsize: 2
+      test:
+         suffix: malloc_pool
+         nsize: 2
+         args: -malloc_pool -malloc_dump
+      test:
+         suffix: malloc_pool_max
+         args: -malloc_pool -malloc_pool_max 1000 -malloc_debug 0
+      test:
+         suffix: set_malloc_pool
+         args: -set_malloc_pool -malloc_debug 0
+
+   test:
+      suffix: view
+      nsize: 2
+      args: -malloc_pool -malloc_view
+      filter: grep "Vector pool\\|Pooled allocations" | sed -e "s@Pooled allocations:.*@Pooled allocations@"
+
+TEST*/
@@ -13,6 +13,8 @@
              VecDotEnd(Vec,Vec,PetscScalar *);
              VecNormEnd(Vec,NormType,PetscReal *);
 
+       PetscCommSplitReductionSum/Max/MinBegin() and End() add values computed by the caller to the same reduction.
+
        Limitations:
          - The order of the xxxEnd() functions MUST be in the same order
            as the xxxBegin(). There is extensive error checking to try to
@@ -119,7 +121,8 @@ PETSC_EXTERN void MPIAPI PetscSplitReduction_Local(void *in,void *out,PetscMPIIn
    Calling this function is optional when using split-mode reduction. On supporting hardware, calling this after all
    VecXxxBegin() allows the reduction to make asynchronous progress before the result is needed (in VecXxxEnd()).
 
-.seealso: VecNormBegin(), VecNormEnd(), VecDotBegin(), VecDotEnd(), VecTDotBegin(), VecTDotEnd(), VecMDotBegin(), VecMDotEnd(), VecMTDotBegin(), VecMTDotEnd()
+.seealso: VecNormBegin(), VecNormEnd(), VecDotBegin(), VecDotEnd(), VecTDotBegin(), VecTDotEnd(), VecMDotBegin(), VecMDotEnd(), VecMTDotBegin(), VecMTDotEnd(),
+          PetscCommSplitReductionSumBegin(), PetscCommSplitReductionMaxBegin(), PetscCommSplitReductionMinBegin(), PetscCommSplitReductionProgress()
 @*/
 PetscErrorCode PetscCommSplitReductionBegin(MPI_Comm comm)
 {
@@ -579,13 +582,281 @@ PetscErrorCode  VecNormEnd(Vec x,NormType ntype,PetscReal *result)
 }
 
 /*
-   Possibly add
+   PetscSplitReductionQueue_Private - Reserves n slots of the given reduction type at the end of the queued
+   reductions on comm; the caller stores its local values in sr->lvalues + sr->numopsbegin and increments numopsbegin.
+*/
+static PetscErrorCode PetscSplitReductionQueue_Private(MPI_Comm comm,PetscInt n,PetscSRReductionType type,PetscSplitReduction **sr)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  ierr = PetscSplitReductionGet(comm,sr);CHKERRQ(ierr);
+  if ((*sr)->state != STATE_BEGIN) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ORDER,"Called before all VecxxxEnd() called");
+  while ((*sr)->numopsbegin+n > (*sr)->maxops) {
+    ierr = PetscSplitReductionExtend(*sr);CHKERRQ(ierr);
+  }
+  for (i=0; i<n; i++) {
+    (*sr)->reducetype[(*sr)->numopsbegin+i] = type;
+    (*sr)->invecs[(*sr)->numopsbegin+i]     = NULL;
+  }
+  PetscFunctionReturn(0);
+}
 
-     PetscReductionSumBegin/End()
-     PetscReductionMaxBegin/End()
-     PetscReductionMinBegin/End()
-   or have more like MPI with a single function with flag for Op? Like first better
+/*
+   PetscSplitReductionDequeue_Private - Completes the reduction if needed and returns the global values of the next n
+   slots, which must have been queued with PetscSplitReductionQueue_Private() and the same reduction type
 */
+static PetscErrorCode PetscSplitReductionDequeue_Private(MPI_Comm comm,PetscInt n,PetscSRReductionType type,PetscScalar *sresult,PetscReal *rresult)
+{
+  PetscErrorCode      ierr;
+  PetscSplitReduction *sr;
+  PetscInt            i;
+
+  PetscFunctionBegin;
+  ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
+  ierr = PetscSplitReductionEnd(sr);CHKERRQ(ierr);
+  if (sr->numopsend+n > sr->numopsbegin) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called PetscCommSplitReductionXxxEnd() for more values than were started");
+  for (i=0; i<n; i++) {
+    if (sr->invecs[sr->numopsend] || sr->reducetype[sr->numopsend] != type) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Called PetscCommSplitReductionXxxEnd() in a different order or with a different reduction than the Begin()");
+    if (sresult) sresult[i] = sr->gvalues[sr->numopsend++];
+    else         rresult[i] = PetscRealPart(sr->gvalues[sr->numopsend++]);
+  }
+  if (sr->numopsend == sr->numopsbegin) {
+    sr->state       = STATE_BEGIN;
+    sr->numopsend   = 0;
+    sr->numopsbegin = 0;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscCommSplitReductionSumBegin - Starts a split phase sum of scalars over a communicator
+
+   Not Collective
+
+   Input Parameters:
++  comm - the communicator, it must be the communicator of the vectors used in the other split phase reductions
+.  n - number of values
+-  local - the local values, they may be changed or freed after this call
+
+   Level: advanced
+
+   Notes:
+   Each call to PetscCommSplitReductionSumBegin() should be paired with a call to PetscCommSplitReductionSumEnd().
+   The values are reduced in the same MPI_Iallreduce() as the VecDotBegin(), VecNormBegin() etc. started on comm, so
+   quantities computed by the caller, for example a local dot product of a few extra entries, cost no extra message.
+
+.seealso: PetscCommSplitReductionSumEnd(), PetscCommSplitReductionMaxBegin(), PetscCommSplitReductionMinBegin(), PetscCommSplitReductionBegin(),
+          PetscCommSplitReductionProgress(), VecDotBegin(), VecNormBegin()
+@*/
+PetscErrorCode PetscCommSplitReductionSumBegin(MPI_Comm comm,PetscInt n,const PetscScalar local[])
+{
+  PetscErrorCode      ierr;
+  PetscSplitReduction *sr;
+
+  PetscFunctionBegin;
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of values %D cannot be negative",n);
+  if (!n) PetscFunctionReturn(0);
+  PetscValidScalarPointer(local,3);
+  ierr = PetscSplitReductionQueue_Private(comm,n,PETSC_SR_REDUCE_SUM,&sr);CHKERRQ(ierr);
+  ierr = PetscArraycpy(sr->lvalues+sr->numopsbegin,local,n);CHKERRQ(ierr);
+  sr->numopsbegin += n;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscCommSplitReductionSumEnd - Ends a split phase sum of scalars over a communicator
+
+   Collective
+
+   Input Parameters:
++  comm - the communicator
+-  n - number of values, as given to PetscCommSplitReductionSumBegin()
+
+   Output Parameter:
+.  result - the sums over all processes of comm
+
+   Level: advanced
+
+.seealso: PetscCommSplitReductionSumBegin()
+@*/
+PetscErrorCode PetscCommSplitReductionSumEnd(MPI_Comm comm,PetscInt n,PetscScalar result[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  PetscValidScalarPointer(result,3);
+  ierr = PetscSplitReductionDequeue_Private(comm,n,PETSC_SR_REDUCE_SUM,result,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscCommSplitReductionRealBegin_Private(MPI_Comm comm,PetscInt n,const PetscReal local[],PetscSRReductionType type)
+{
+  PetscErrorCode      ierr;
+  PetscSplitReduction *sr;
+  PetscInt            i;
+
+  PetscFunctionBegin;
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of values %D cannot be negative",n);
+  if (!n) PetscFunctionReturn(0);
+  PetscValidRealPointer(local,3);
+  ierr = PetscSplitReductionQueue_Private(comm,n,type,&sr);CHKERRQ(ierr);
+  for (i=0; i<n; i++) sr->lvalues[sr->numopsbegin++] = local[i];
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscCommSplitReductionMaxBegin - Starts a split phase maximum of reals over a communicator
+
+   Not Collective
+
+   Input Parameters:
++  comm - the communicator, it must be the communicator of the vectors used in the other split phase reductions
+.  n - number of values
+-  local - the local values, they may be changed or freed after this call
+
+   Level: advanced
+
+   Notes:
+   Each call to PetscCommSplitReductionMaxBegin() should be paired with a call to PetscCommSplitReductionMaxEnd().
+
+.seealso: PetscCommSplitReductionMaxEnd(), PetscCommSplitReductionSumBegin(), PetscCommSplitReductionMinBegin(), PetscCommSplitReductionBegin()
+@*/
+PetscErrorCode PetscCommSplitReductionMaxBegin(MPI_Comm comm,PetscInt n,const PetscReal local[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscCommSplitReductionRealBegin_Private(comm,n,local,PETSC_SR_REDUCE_MAX);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscCommSplitReductionMaxEnd - Ends a split phase maximum of reals over a communicator
+
+   Collective
+
+   Input Parameters:
++  comm - the communicator
+-  n - number of values, as given to PetscCommSplitReductionMaxBegin()
+
+   Output Parameter:
+.  result - the maxima over all processes of comm
+
+   Level: advanced
+
+.seealso: PetscCommSplitReductionMaxBegin()
+@*/
+PetscErrorCode PetscCommSplitReductionMaxEnd(MPI_Comm comm,PetscInt n,PetscReal result[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  PetscValidRealPointer(result,3);
+  ierr = PetscSplitReductionDequeue_Private(comm,n,PETSC_SR_REDUCE_MAX,NULL,result);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscCommSplitReductionMinBegin - Starts a split phase minimum of reals over a communicator
+
+   Not Collective
+
+   Input Parameters:
++  comm - the communicator, it must be the communicator of the vectors used in the other split phase reductions
+.  n - number of values
+-  local - the local values, they may be changed or freed after this call
+
+   Level: advanced
+
+   Notes:
+   Each call to PetscCommSplitReductionMinBegin() should be paired with a call to PetscCommSplitReductionMinEnd().
+
+.seealso: PetscCommSplitReductionMinEnd(), PetscCommSplitReductionSumBegin(), PetscCommSplitReductionMaxBegin(), PetscCommSplitReductionBegin()
+@*/
+PetscErrorCode PetscCommSplitReductionMinBegin(MPI_Comm comm,PetscInt n,const PetscReal local[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscCommSplitReductionRealBegin_Private(comm,n,local,PETSC_SR_REDUCE_MIN);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscCommSplitReductionMinEnd - Ends a split phase minimum of reals over a communicator
+
+   Collective
+
+   Input Parameters:
++  comm - the communicator
+-  n - number of values, as given to PetscCommSplitReductionMinBegin()
+
+   Output Parameter:
+.  result - the minima over all processes of comm
+
+   Level: advanced
+
+.seealso: PetscCommSplitReductionMinBegin()
+@*/
+PetscErrorCode PetscCommSplitReductionMinEnd(MPI_Comm comm,PetscInt n,PetscReal result[])
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  PetscValidRealPointer(result,3);
+  ierr = PetscSplitReductionDequeue_Private(comm,n,PETSC_SR_REDUCE_MIN,NULL,result);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   PetscCommSplitReductionProgress - Gives the MPI implementation a chance to progress a split reduction started
+   with PetscCommSplitReductionBegin()
+
+   Not Collective
+
+   Input Parameter:
+.  comm - communicator on which the split reduction has been started
+
+   Output Parameter:
+.  done - PETSC_FALSE while a reduction started with PetscCommSplitReductionBegin() is still outstanding, PETSC_TRUE otherwise, may be NULL
+
+   Level: advanced
+
+   Notes:
+   Operations queued with VecNormBegin(), VecDotBegin() etc. without a following PetscCommSplitReductionBegin() have
+   not been started, nothing can progress them and they are completed by the first VecXxxEnd(); for such a queue
+   done is PETSC_TRUE. With -splitreduction_async 0 the reduction is completed inside PetscCommSplitReductionBegin()
+   so done is also PETSC_TRUE.
+
+   Many MPI implementations only advance non-blocking collectives inside MPI calls. Calling this between the pieces
+   of work that are overlapped with the reduction, for example between the preconditioner application and the
+   matrix-vector product of a pipelined Krylov method, lets the reduction complete in the background without an
+   asynchronous progress thread.
+
+.seealso: PetscCommSplitReductionBegin(), VecNormEnd(), VecDotEnd()
+@*/
+PetscErrorCode PetscCommSplitReductionProgress(MPI_Comm comm,PetscBool *done)
+{
+  PetscErrorCode      ierr;
+  PetscSplitReduction *sr;
+  PetscMPIInt         flag = 1;
+
+  PetscFunctionBegin;
+  ierr = PetscSplitReductionGet(comm,&sr);CHKERRQ(ierr);
+  if (sr->state == STATE_PENDING) {
+    if (sr->request != MPI_REQUEST_NULL) {
+      ierr = MPI_Test(&sr->request,&flag,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+    }
+    if (flag) sr->state = STATE_END;
+  }
+  if (done) *done = (sr->state == STATE_PENDING) ? PETSC_FALSE : PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
 
 /*@
    VecMDotBegin - Starts a split phase multiple dot product computation.
@@ -12,6 +12,8 @@ typedef struct {
   PetscSF           lsf;    /* the local part of the scatter, used for SCATTER_LOCAL */
   PetscInt          bs;     /* block size */
   MPI_Datatype      unit;   /* one unit = bs PetscScalars */
+  const PetscScalar **xarrays; /* arrays of the vectors of VecScatterBeginMultiple() */
+  PetscScalar       **yarrays;
 } VecScatter_SF;
 
 static PetscErrorCode VecScatterBegin_SF(VecScatter vscat,Vec x,Vec y,InsertMode addv,ScatterMode mode)
@@ -110,6 +112,86 @@ static PetscErrorCode VecScatterEnd_SF(VecScatter vscat,Vec x,Vec y,InsertMode a
   PetscFunctionReturn(0);
 }
 
+/* The SF and the MPI_Op of a scatter with the given modes */
+static PetscErrorCode VecScatterGetSFAndOp_SF(VecScatter vscat,InsertMode addv,ScatterMode mode,PetscSF *sf,MPI_Op *mop)
+{
+  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
+  PetscMPIInt    size;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MPI_Comm_size(PetscObjectComm((PetscObject)data->sf),&size);CHKERRQ(ierr);
+  if ((mode & SCATTER_LOCAL) && size > 1) {
+    if (!data->lsf) {ierr = PetscSFCreateLocalSF_Private(data->sf,&data->lsf);CHKERRQ(ierr);}
+    *sf = data->lsf;
+  } else *sf = data->sf;
+
+  if (addv == INSERT_VALUES)   *mop = MPIU_REPLACE;
+  else if (addv == ADD_VALUES) *mop = MPIU_SUM;
+  else if (addv == MAX_VALUES) *mop = MPIU_MAX;
+  else if (addv == MIN_VALUES) *mop = MPIU_MIN;
+  else SETERRQ1(PetscObjectComm((PetscObject)vscat),PETSC_ERR_SUP,"Unsupported InsertMode %D in VecScatterBegin/End",addv);
+  PetscFunctionReturn(0);
+}
+
+/* All the vectors go through one PetscSF operation on several arrays, which sends one message per neighbor */
+static PetscErrorCode VecScatterBeginMultiple_SF(VecScatter vscat,PetscInt n,Vec *x,Vec *y,InsertMode addv,ScatterMode mode)
+{
+  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
+  PetscSF        sf;
+  MPI_Op         mop;
+  PetscInt       j;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecScatterGetSFAndOp_SF(vscat,addv,mode,&sf,&mop);CHKERRQ(ierr);
+  ierr = PetscMalloc2(n,&data->xarrays,n,&data->yarrays);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {
+    if (x[j] != y[j]) {
+      ierr = VecLockReadPush(x[j]);CHKERRQ(ierr);
+      ierr = VecGetArrayRead(x[j],&data->xarrays[j]);CHKERRQ(ierr);
+      ierr = VecGetArray(y[j],&data->yarrays[j]);CHKERRQ(ierr);
+    } else {
+      ierr = VecGetArray(y[j],&data->yarrays[j]);CHKERRQ(ierr);
+      data->xarrays[j] = data->yarrays[j];
+    }
+    ierr = VecLockWriteSet_Private(y[j],PETSC_TRUE);CHKERRQ(ierr);
+  }
+  if (mode & SCATTER_REVERSE) {
+    ierr = PetscSFReduceBeginMultiple(sf,data->unit,n,(const void*const*)data->xarrays,(void*const*)data->yarrays,mop);CHKERRQ(ierr);
+  } else {
+    ierr = PetscSFBcastAndOpBeginMultiple(sf,data->unit,n,(const void*const*)data->xarrays,(void*const*)data->yarrays,mop);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode VecScatterEndMultiple_SF(VecScatter vscat,PetscInt n,Vec *x,Vec *y,InsertMode addv,ScatterMode mode)
+{
+  VecScatter_SF  *data=(VecScatter_SF*)vscat->data;
+  PetscSF        sf;
+  MPI_Op         mop;
+  PetscInt       j;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecScatterGetSFAndOp_SF(vscat,addv,mode,&sf,&mop);CHKERRQ(ierr);
+  if (mode & SCATTER_REVERSE) {
+    ierr = PetscSFReduceEndMultiple(sf,data->unit,n,(const void*const*)data->xarrays,(void*const*)data->yarrays,mop);CHKERRQ(ierr);
+  } else {
+    ierr = PetscSFBcastAndOpEndMultiple(sf,data->unit,n,(const void*const*)data->xarrays,(void*const*)data->yarrays,mop);CHKERRQ(ierr);
+  }
+  for (j=0; j<n; j++) {
+    if (x[j] != y[j]) {
+      ierr = VecRestoreArrayRead(x[j],&data->xarrays[j]);CHKERRQ(ierr);
+      ierr = VecLockReadPop(x[j]);CHKERRQ(ierr);
+    }
+    ierr = VecRestoreArray(y[j],&data->yarrays[j]);CHKERRQ(ierr);
+    ierr = VecLockWriteSet_Private(y[j],PETSC_FALSE);CHKERRQ(ierr);
+  }
+  ierr = PetscFree2(data->xarrays,data->yarrays);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode VecScatterCopy_SF(VecScatter vscat,VecScatter ctx)
 {
   VecScatter_SF  *data=(VecScatter_SF*)vscat->data,*out;
@@ -749,6 +831,8 @@ functionend:
   vscat->data                      = (void*)data;
   vscat->ops->begin                = VecScatterBegin_SF;
   vscat->ops->end                  = VecScatterEnd_SF;
+  vscat->ops->beginmultiple        = VecScatterBeginMultiple_SF;
+  vscat->ops->endmultiple          = VecScatterEndMultiple_SF;
   vscat->ops->remap                = VecScatterRemap_SF;
   vscat->ops->copy                 = VecScatterCopy_SF;
   vscat->ops->destroy              = VecScatterDestroy_SF;
@@ -27,6 +27,32 @@ PetscErrorCode  VecScatterGetMerged(VecScatter ctx,PetscBool  *flg)
   PetscFunctionReturn(0);
 }
 
+/*
+   Error checking to make sure these vectors match the vectors used
+   to create the vector scatter context. -1 in the from_n and to_n indicate the
+   vector lengths are unknown (for example with mapped scatters) and thus
+   no error checking is performed.
+*/
+static PetscErrorCode VecScatterCheckSizes_Private(VecScatter ctx,Vec x,Vec y,ScatterMode mode)
+{
+  PetscErrorCode ierr;
+  PetscInt       to_n,from_n;
+
+  PetscFunctionBegin;
+  if (ctx->from_n >= 0 && ctx->to_n >= 0) {
+    ierr = VecGetLocalSize(x,&from_n);CHKERRQ(ierr);
+    ierr = VecGetLocalSize(y,&to_n);CHKERRQ(ierr);
+    if (mode & SCATTER_REVERSE) {
+      if (to_n != ctx->from_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter reverse and vector to != ctx from size)",to_n,ctx->from_n);
+      if (from_n != ctx->to_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter reverse and vector from != ctx to size)",from_n,ctx->to_n);
+    } else {
+      if (to_n != ctx->to_n)     SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter forward and vector to != ctx to size)",to_n,ctx->to_n);
+      if (from_n != ctx->from_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter forward and vector from != ctx from size)",from_n,ctx->from_n);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@
    VecScatterBegin - Begins a generalized scatter from one vector to
    another. Complete the scattering phase with VecScatterEnd().
@@ -74,7 +100,6 @@ PetscErrorCode  VecScatterGetMerged(VecScatter ctx,PetscBool  *flg)
 PetscErrorCode  VecScatterBegin(VecScatter ctx,Vec x,Vec y,InsertMode addv,ScatterMode mode)
 {
   PetscErrorCode ierr;
-  PetscInt       to_n,from_n;
 
   PetscFunctionBegin;
   PetscValidHeaderSpecific(ctx,VEC_SCATTER_CLASSID,1);
@@ -82,25 +107,7 @@ PetscErrorCode  VecScatterBegin(VecScatter ctx,Vec x,Vec y,InsertMode addv,Scatt
   PetscValidHeaderSpecific(y,VEC_CLASSID,3);
   if (ctx->inuse) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE," Scatter ctx already in use");
 
-  if (PetscDefined(USE_DEBUG)) {
-    /*
-     Error checking to make sure these vectors match the vectors used
-     to create the vector scatter context. -1 in the from_n and to_n indicate the
-     vector lengths are unknown (for example with mapped scatters) and thus
-     no error checking is performed.
-     */
-    if (ctx->from_n >= 0 && ctx->to_n >= 0) {
-      ierr = VecGetLocalSize(x,&from_n);CHKERRQ(ierr);
-      ierr = VecGetLocalSize(y,&to_n);CHKERRQ(ierr);
-      if (mode & SCATTER_REVERSE) {
-        if (to_n != ctx->from_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter reverse and vector to != ctx from size)",to_n,ctx->from_n);
-        if (from_n != ctx->to_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter reverse and vector from != ctx to size)",from_n,ctx->to_n);
-      } else {
-        if (to_n != ctx->to_n)     SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter forward and vector to != ctx to size)",to_n,ctx->to_n);
-        if (from_n != ctx->from_n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Vector wrong size %D for scatter %D (scatter forward and vector from != ctx from size)",from_n,ctx->from_n);
-      }
-    }
-  }
+  if (PetscDefined(USE_DEBUG)) {ierr = VecScatterCheckSizes_Private(ctx,x,y,mode);CHKERRQ(ierr);}
 
   ctx->inuse = PETSC_TRUE;
   ierr = PetscLogEventBegin(VEC_ScatterBegin,ctx,x,y,0);CHKERRQ(ierr);
@@ -155,6 +162,102 @@ PetscErrorCode  VecScatterEnd(VecScatter ctx,Vec x,Vec y,InsertMode addv,Scatter
   PetscFunctionReturn(0);
 }
 
+/*@
+   VecScatterBeginMultiple - Begins the same scatter on several pairs of vectors. Complete the scattering phase with VecScatterEndMultiple().
+
+   Neighbor-wise Collective on VecScatter
+
+   Input Parameters:
++  ctx - scatter context generated by VecScatterCreate()
+.  n - the number of pairs of vectors
+.  x - the n vectors from which we scatter
+.  y - the n vectors to which we scatter, y[j] gets the values of x[j]
+.  addv - either ADD_VALUES, MAX_VALUES, MIN_VALUES or INSERT_VALUES
+-  mode - the scattering mode, SCATTER_FORWARD or SCATTER_REVERSE
+
+   Level: intermediate
+
+   Notes:
+   This does the same as VecScatterBegin() and VecScatterEnd() on each pair of vectors, as done by multi-field and block Krylov
+   methods. With the default VecScatter type the values of all the vectors going to a process are packed into one message, see
+   PetscSFBcastAndOpBeginMultiple(), so the scatter costs the latency of one message per neighbor instead of n. Other types
+   scatter the vectors one after the other in this routine.
+
+   The vectors in x and y must all be different, except that x[j] may be y[j].
+
+.seealso: VecScatterEndMultiple(), VecScatterBegin(), VecScatterCreate()
+@*/
+PetscErrorCode VecScatterBeginMultiple(VecScatter ctx,PetscInt n,Vec x[],Vec y[],InsertMode addv,ScatterMode mode)
+{
+  PetscErrorCode ierr;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ctx,VEC_SCATTER_CLASSID,1);
+  if (n < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors %D cannot be negative",n);
+  if (n) {
+    PetscValidPointer(x,3);
+    PetscValidPointer(y,4);
+  }
+  for (j=0; j<n; j++) {
+    PetscValidHeaderSpecific(x[j],VEC_CLASSID,3);
+    PetscValidHeaderSpecific(y[j],VEC_CLASSID,4);
+    if (PetscDefined(USE_DEBUG)) {ierr = VecScatterCheckSizes_Private(ctx,x[j],y[j],mode);CHKERRQ(ierr);}
+  }
+  if (ctx->inuse) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE," Scatter ctx already in use");
+
+  if (!ctx->ops->beginmultiple) {
+    for (j=0; j<n; j++) {
+      ierr = VecScatterBegin(ctx,x[j],y[j],addv,mode);CHKERRQ(ierr);
+      ierr = VecScatterEnd(ctx,x[j],y[j],addv,mode);CHKERRQ(ierr);
+    }
+    PetscFunctionReturn(0);
+  }
+  if (!n) PetscFunctionReturn(0);
+  ctx->inuse = PETSC_TRUE;
+  ierr = PetscLogEventBegin(VEC_ScatterBegin,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  ierr = (*ctx->ops->beginmultiple)(ctx,n,x,y,addv,mode);CHKERRQ(ierr);
+  if (ctx->beginandendtogether) {
+    ctx->inuse = PETSC_FALSE;
+    ierr = (*ctx->ops->endmultiple)(ctx,n,x,y,addv,mode);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(VEC_ScatterBegin,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecScatterEndMultiple - Ends the scatter on several pairs of vectors begun with VecScatterBeginMultiple().
+
+   Neighbor-wise Collective on VecScatter
+
+   Input Parameters:
++  ctx - scatter context generated by VecScatterCreate()
+.  n - the number of pairs of vectors
+.  x - the n vectors from which we scatter
+.  y - the n vectors to which we scatter
+.  addv - one of ADD_VALUES, MAX_VALUES, MIN_VALUES or INSERT_VALUES
+-  mode - the scattering mode, SCATTER_FORWARD or SCATTER_REVERSE
+
+   Level: intermediate
+
+.seealso: VecScatterBeginMultiple(), VecScatterEnd()
+@*/
+PetscErrorCode VecScatterEndMultiple(VecScatter ctx,PetscInt n,Vec x[],Vec y[],InsertMode addv,ScatterMode mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ctx,VEC_SCATTER_CLASSID,1);
+  if (!ctx->ops->beginmultiple || !n) PetscFunctionReturn(0);
+  ctx->inuse = PETSC_FALSE;
+  if (!ctx->beginandendtogether) {
+    ierr = PetscLogEventBegin(VEC_ScatterEnd,ctx,x[0],y[0],0);CHKERRQ(ierr);
+    ierr = (*ctx->ops->endmultiple)(ctx,n,x,y,addv,mode);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(VEC_ScatterEnd,ctx,x[0],y[0],0);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 /*@
    VecScatterDestroy - Destroys a scatter context created by VecScatterCreate()
 
@@ -0,0 +1,129 @@
+static char help[] = "Tests VecScatterBeginMultiple() and VecScatterEndMultiple() against VecScatterBegin() and VecScatterEnd() on each vector.\n\n";
+
+#include <petscvec.h>
+
+static PetscErrorCode CheckVecs(const char *op,PetscInt n,Vec *a,Vec *b)
+{
+  PetscErrorCode ierr;
+  PetscInt       j;
+  PetscBool      flg,same = PETSC_TRUE;
+
+  PetscFunctionBegin;
+  for (j=0; j<n; j++) {
+    ierr = VecEqual(a[j],b[j],&flg);CHKERRQ(ierr);
+    if (!flg) same = PETSC_FALSE;
+  }
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %s\n",op,same ? "results agree" : "results differ");CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Scatters x to y with VecScatterBeginMultiple() and xr to yr with a VecScatterBegin() per vector */
+static PetscErrorCode Scatter(VecScatter vscat,PetscInt n,Vec *x,Vec *y,Vec *xr,Vec *yr,InsertMode addv,ScatterMode mode)
+{
+  PetscErrorCode ierr;
+  PetscInt       j;
+
+  PetscFunctionBegin;
+  ierr = VecScatterBeginMultiple(vscat,n,x,y,addv,mode);CHKERRQ(ierr);
+  ierr = VecScatterEndMultiple(vscat,n,x,y,addv,mode);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {
+    ierr = VecScatterBegin(vscat,xr[j],yr[j],addv,mode);CHKERRQ(ierr);
+    ierr = VecScatterEnd(vscat,xr[j],yr[j],addv,mode);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    rank,size;
+  PetscInt       i,j,n = 3,m = 7,bs = 1,N,*idx;
+  Vec            xt,yt,*x,*y,*xr,*yr;
+  IS             ix,iy;
+  VecScatter     vscat;
+  PetscScalar    *a;
+  char           name[64];
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-bs",&bs,NULL);CHKERRQ(ierr);
+
+  /* x has m blocks per process, y gets 2m blocks of x from all over, some of them twice */
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,m*bs,PETSC_DETERMINE,&xt);CHKERRQ(ierr);
+  ierr = VecSetBlockSize(xt,bs);CHKERRQ(ierr);
+  ierr = VecCreateMPI(PETSC_COMM_WORLD,2*m*bs,PETSC_DETERMINE,&yt);CHKERRQ(ierr);
+  ierr = VecSetBlockSize(yt,bs);CHKERRQ(ierr);
+  N    = m*size;
+  ierr = PetscMalloc1(2*m,&idx);CHKERRQ(ierr);
+  for (i=0; i<2*m; i++) idx[i] = (5*rank + 3*i + (i%4 ? 0 : m)) % N;
+  ierr = ISCreateBlock(PETSC_COMM_SELF,bs,2*m,idx,PETSC_COPY_VALUES,&ix);CHKERRQ(ierr);
+  ierr = ISCreateStride(PETSC_COMM_SELF,2*m*bs,2*m*bs*rank,1,&iy);CHKERRQ(ierr);
+  ierr = VecScatterCreate(xt,ix,yt,iy,&vscat);CHKERRQ(ierr);
+  ierr = PetscFree(idx);CHKERRQ(ierr);
+
+  ierr = VecDuplicateVecs(xt,n,&x);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(xt,n,&xr);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(yt,n,&y);CHKERRQ(ierr);
+  ierr = VecDuplicateVecs(yt,n,&yr);CHKERRQ(ierr);
+  for (j=0; j<n; j++) {
+    ierr = VecGetArray(x[j],&a);CHKERRQ(ierr);
+    for (i=0; i<m*bs; i++) a[i] = 1000*j + 100*rank + i;
+    ierr = VecRestoreArray(x[j],&a);CHKERRQ(ierr);
+    ierr = VecCopy(x[j],xr[j]);CHKERRQ(ierr);
+    ierr = VecSet(y[j],-1.0-j);CHKERRQ(ierr);
+    ierr = VecSet(yr[j],-1.0-j);CHKERRQ(ierr);
+  }
+
+  ierr = Scatter(vscat,n,x,y,xr,yr,INSERT_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"INSERT_VALUES SCATTER_FORWARD with bs %D",bs);CHKERRQ(ierr);
+  ierr = CheckVecs(name,n,y,yr);CHKERRQ(ierr);
+  ierr = Scatter(vscat,n,x,y,xr,yr,ADD_VALUES,SCATTER_FORWARD);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"ADD_VALUES SCATTER_FORWARD with bs %D",bs);CHKERRQ(ierr);
+  ierr = CheckVecs(name,n,y,yr);CHKERRQ(ierr);
+  ierr = Scatter(vscat,n,y,x,yr,xr,ADD_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"ADD_VALUES SCATTER_REVERSE with bs %D",bs);CHKERRQ(ierr);
+  ierr = CheckVecs(name,n,x,xr);CHKERRQ(ierr);
+  ierr = Scatter(vscat,n,y,x,yr,xr,MAX_VALUES,SCATTER_REVERSE);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(name,sizeof(name),"MAX_VALUES SCATTER_REVERSE with bs %D",bs);CHKERRQ(ierr);
+  ierr = CheckVecs(name,n,x,xr);CHKERRQ(ierr);
+
+  ierr = VecDestroyVecs(n,&x);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(n,&xr);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(n,&y);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(n,&yr);CHKERRQ(ierr);
+  ierr = VecScatterDestroy(&vscat);CHKERRQ(ierr);
+  ierr = ISDestroy(&ix);CHKERRQ(ierr);
+  ierr = ISDestroy(&iy);CHKERRQ(ierr);
+  ierr = VecDestroy(&xt);CHKERRQ(ierr);
+  ierr = VecDestroy(&yt);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   testset:
+      output_file: output/ex10_1.out
+      test:
+         suffix: 1
+      test:
+         suffix: 2
+         nsize: 3
+      test:
+         suffix: 3
+         nsize: 4
+         args: -n 5
+      test:
+         suffix: 4
+         nsize: 3
+         args: -n 1 -sf_type neighbor
+
+   test:
+      suffix: bs
+      nsize: 3
+      args: -bs 2
+      output_file: output/ex10_bs.out
+
+TEST*/